@@ -43,14 +43,75 @@ typedef enum {
         PT_OPP = 4,
         PT_KP  = 5,
         PT_NEG = 6,
+        PT_KG  = 7,
+        PT_ADD_PROJ = 8,
+        PT_DBL_PROJ = 9,
+        PT_NORM = 10,
+        FP_ADD = 11,
+        FP_SUB = 12,
+        FP_MUL = 13,
+        FP_INV = 14,
+        FP_SQR = 15,
+        FP_EXP = 16,
+        FP_MTY = 17,
+        FP_NOMTY = 18,
+        PT_DECOMPRESS = 19,
+        PT_DECOMPRESS_ODD = 20,
+        PT_KP2_LOAD = 21,
+        PT_KP2_P1 = 22,
+        PT_KP2_P2 = 23,
+        PT_KP2_P12 = 24,
 } ip_ecc_command;
 
+/* Ways the driver can wait for the completion of a long operation */
+typedef enum {
+	/* Poll the BUSY bit of the IP (default) */
+	HW_DRIVER_COMPLETION_SPIN = 0,
+	/* Sleep until the IP raises its interrupt (only with WITH_EC_HW_UIO) */
+	HW_DRIVER_COMPLETION_IRQ = 1,
+} hw_driver_completion_mode;
+
+/* Maximum number of IPs (instances of the ECC IP in the design) the driver can handle */
+#define HW_DRIVER_MAX_DEVICES	4
+
+/* Select the IP of index 'dev' as the one on which all subsequent calls operate
+ * (IP of index 0 is selected by default) */
+int hw_driver_select_device(uint32_t dev);
+
+/* Get the index of the IP currently selected */
+int hw_driver_get_device(uint32_t *dev);
+
+/* Get the number of IPs available */
+int hw_driver_get_nb_devices(uint32_t *nb);
+
+/* Reserve the IP currently selected for the calling thread (thread-safe mode),
+ * so that a sequence of calls is not interleaved with calls from other threads
+ * (only one IP can be reserved at a time by a thread) */
+int hw_driver_lock_device(void);
+
+/* Release the IP reserved with hw_driver_lock_device() (even if another IP
+ * was selected since) */
+int hw_driver_unlock_device(void);
+
+/* Value of 'curve_id' for hw_driver_schedule() when no curve affinity is wanted */
+#define HW_DRIVER_NO_CURVE	0xffffffff
+
+/* Select the least busy IP (preferring one where curve 'curve_id' is already set),
+ * set curve 'curve_id' in it and return its index in 'dev' */
+int hw_driver_schedule(uint32_t curve_id, uint32_t *dev);
+
 /* Reset the hardware */
 int hw_driver_reset(void);
 
+/* Select how the driver waits for the end of scalar multiplications */
+int hw_driver_set_completion_mode(hw_driver_completion_mode mode);
+
 /* To know if the IP is in 'debug' or 'production' mode */
 int hw_driver_is_debug(uint32_t*);
 
+/* To know if the IP was synthesized with the DMA ring (see hw_driver_mul_batch_dma()) */
+int hw_driver_is_dma_supported(uint32_t*);
+
 /* Get all three version nbs of the IP (major, minor & patch) */
 int hw_driver_get_version_tags(uint32_t*, uint32_t*, uint32_t*);
 
@@ -61,16 +122,38 @@ int hw_driver_trng_post_proc_enable(void);
 /* Enable TRNG post-processing logic */
 int hw_driver_trng_post_proc_disable(void);
 
-/* Set the curve parameters a, b, p and q */
+/* Set the curve parameters a, b, p and q
+ * (no-op if these are the parameters of the curve already set in the hardware) */
 int hw_driver_set_curve(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
 			const uint8_t *p, uint32_t p_sz, const uint8_t *q, uint32_t q_sz);
 
+/* Maximum number of curves that can be registered in the driver at the same time */
+#define HW_DRIVER_MAX_CURVES	8
+
+/* Register the curve parameters a, b, p and q, and get a handle on them in 'id' */
+int hw_driver_register_curve(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
+			     const uint8_t *p, uint32_t p_sz, const uint8_t *q, uint32_t q_sz,
+			     uint32_t *id);
+
+/* Set in the hardware the curve of handle 'id' (no-op if it is already set) */
+int hw_driver_select_curve(uint32_t id);
+
+/* Release the handle 'id' of a registered curve */
+int hw_driver_unregister_curve(uint32_t id);
+
 /* Activate the blinding for scalar multiplication */
 int hw_driver_enable_blinding(uint32_t blinding_size);
 
 /* Disable the blinding for scalar multiplication */
 int hw_driver_disable_blinding(void);
 
+/* Transfer large numbers back-to-back, checking the IP once per number
+ * (default when the hardware supports it) */
+int hw_driver_enable_streaming(void);
+
+/* Transfer large numbers limb by limb, checking the IP after each limb */
+int hw_driver_disable_streaming(void);
+
 /* Activate the shuffling for scalar multiplication */
 int hw_driver_enable_shuffling(void);
 
@@ -185,6 +268,223 @@ int hw_driver_mul(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_
 		  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz,
 			kp_trace_info_t* ktrc);
 
+/* Return out_y such that (x, out_y) is on the curve, out_y being odd if
+ * 'y_odd' is set and even otherwise. Prime p of the curve may be 3 mod 4
+ * (one exponentiation in the IP) or 1 mod 4 (Tonelli-Shanks in the driver,
+ * with many more transfers) */
+int hw_driver_decompress(const uint8_t *x, uint32_t x_sz, int y_odd,
+			 uint8_t *out_y, uint32_t *out_y_sz);
+
+/* Return (out_x, out_y) = scalar * (x, y), the point being given in
+ * compressed form (x, y_odd) and decompressed by the IP itself */
+int hw_driver_mul_compressed(const uint8_t *x, uint32_t x_sz, int y_odd,
+			     const uint8_t *scalar, uint32_t scalar_sz,
+			     uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz);
+
+/* Handle on a scalar multiplication submitted with hw_driver_mul_submit() */
+typedef uint32_t hw_driver_mul_job;
+
+/* Start the computation of scalar * (x, y), without waiting for its result
+ * (one more job can be queued behind the one running, if the IP has point
+ * slots: results are then collected in submission order). Until then, the
+ * other calls to the driver on the IP are rejected (except the ones below,
+ * hw_driver_select_device(), hw_driver_lock_device() and the selection of
+ * the curve already resident) */
+int hw_driver_mul_submit(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+			 const uint8_t *scalar, uint32_t scalar_sz, hw_driver_mul_job *job);
+
+/* Non-blocking check for the end of 'job': if over (*done = 1),
+ * return (out_x, out_y) = scalar * (x, y) (output buffers too small
+ * leave the job in flight, to be collected again) */
+int hw_driver_mul_poll(hw_driver_mul_job job, uint8_t *out_x, uint32_t *out_x_sz,
+		       uint8_t *out_y, uint32_t *out_y_sz, int *done);
+
+/* Wait for the end of 'job' and return (out_x, out_y) = scalar * (x, y) */
+int hw_driver_mul_wait(hw_driver_mul_job job, uint8_t *out_x, uint32_t *out_x_sz,
+		       uint8_t *out_y, uint32_t *out_y_sz);
+
+/* Input of one scalar multiplication of a batch: scalar * (x, y) */
+typedef struct {
+	const uint8_t *x;
+	uint32_t x_sz;
+	const uint8_t *y;
+	uint32_t y_sz;
+	const uint8_t *scalar;
+	uint32_t scalar_sz;
+} hw_driver_mul_input;
+
+/* Output of one scalar multiplication of a batch (x_sz and y_sz give
+ * the sizes of the buffers, and are updated with the sizes of the result) */
+typedef struct {
+	uint8_t *x;
+	uint32_t x_sz;
+	uint8_t *y;
+	uint32_t y_sz;
+} hw_driver_mul_output;
+
+/* Return (out[i].x, out[i].y) = in[i].scalar * (in[i].x, in[i].y) for the 'nb' jobs of a batch */
+int hw_driver_mul_batch(const hw_driver_mul_input *in, hw_driver_mul_output *out, uint32_t nb);
+
+/* Curve handle of a job standing for the curve currently set in the hardware */
+#define HW_DRIVER_CURVE_CURRENT	(0xffffffff)
+
+/* Input of one scalar multiplication of a batch run through the DMA ring:
+ * the multiplication itself & the handle of its curve (as given by
+ * hw_driver_register_curve(), or HW_DRIVER_CURVE_CURRENT) */
+typedef struct {
+	uint32_t curve;
+	hw_driver_mul_input mul;
+} hw_driver_mul_dma_input;
+
+/* Same as hw_driver_mul_batch(), each job being on its own curve and the jobs being
+ * queued in the ring of job descriptors of the IP (DMA) which fetches operands and
+ * writes back results in system memory by itself (only with WITH_EC_HW_UIO, and if
+ * the IP was synthesized with the DMA ring, see hw_driver_is_dma_supported()).
+ * Consecutive jobs on the same curve are run in one go.
+ * Unless the IP was synthesized with parameter 'dmatoken', results are written in
+ * system memory in the clear. */
+int hw_driver_mul_batch_dma(const hw_driver_mul_dma_input *in, hw_driver_mul_output *out, uint32_t nb);
+
+/* Large number pre-converted to the format of the IP: words of the size of
+ * those of the IP, the least significant one first, each word holding its
+ * bytes in native order. Converting once a large number used many times (e.g
+ * a base point or a public key) saves its conversion upon each transfer.
+ *
+ * The word size is the one the driver is compiled for (see
+ * WITH_EC_HW_ACCELERATOR_WORD32/WITH_EC_HW_ACCELERATOR_WORD64), which must
+ * match the one of the IP.
+ */
+#if defined(WITH_EC_HW_ACCELERATOR_WORD64)
+typedef uint64_t ipecc_limb_t;
+#else
+typedef uint32_t ipecc_limb_t;
+#endif
+
+/* Max size (in bytes) of a pre-converted large number */
+#define IPECC_BIGNUM_MAX_SZ	128
+
+typedef struct {
+	ipecc_limb_t w[IPECC_BIGNUM_MAX_SZ / sizeof(ipecc_limb_t)];
+	/* Nb of meaningful words in 'w' */
+	uint32_t nb;
+} ipecc_bignum_t;
+
+/* Affine point with pre-converted coordinates */
+typedef struct {
+	ipecc_bignum_t x;
+	ipecc_bignum_t y;
+} ipecc_point_t;
+
+/* Convert the big number 'a' to the format of the IP */
+int hw_driver_bignum_import(const uint8_t *a, uint32_t a_sz, ipecc_bignum_t *bn);
+
+/* Convert back a pre-converted large number to a big-endian buffer of 'a_sz' bytes */
+int hw_driver_bignum_export(const ipecc_bignum_t *bn, uint8_t *a, uint32_t a_sz);
+
+/* Convert the affine point (x, y) to the format of the IP */
+int hw_driver_point_import(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+			   ipecc_point_t *pt);
+
+/* Same as hw_driver_is_on_curve() with a pre-converted point */
+int hw_driver_is_on_curve_pt(const ipecc_point_t *pt, int *on_curve);
+
+/* Same as hw_driver_add() with pre-converted points */
+int hw_driver_add_pt(const ipecc_point_t *pt1, const ipecc_point_t *pt2,
+		     uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz);
+
+/* Same as hw_driver_mul() with a pre-converted point */
+int hw_driver_mul_pt(const ipecc_point_t *pt, const uint8_t *scalar, uint32_t scalar_sz,
+		     uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz);
+
+/* Set the base point of the current curve (stored in the IP if supported) */
+int hw_driver_set_base_point(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz);
+
+/* Scalar multiplication of the base point set by hw_driver_set_base_point() */
+int hw_driver_mul_base(const uint8_t *scalar, uint32_t scalar_sz,
+		       uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz);
+
+/* Double scalar multiplication k1 * (x1, y1) + k2 * (x2, y2) with public
+ * scalars, e.g for signature verification (one interleaved, not constant
+ * time, pass if the IP supports it: never use it with secret scalars)
+ * (x1 = y1 = NULL stands for the base point set by hw_driver_set_base_point()) */
+int hw_driver_mul2(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
+		   const uint8_t *k1, uint32_t k1_sz,
+		   const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
+		   const uint8_t *k2, uint32_t k2_sz,
+		   uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz);
+
+/* Chain of point operations keeping the accumulated point in projective
+ * form in the IP (only one inversion, at the end of the chain):
+ * start from (x, y), then add affine points to it and/or double it
+ * any number of times, and finally get it back in affine form
+ * (*iszero is set if the accumulated point is null) */
+int hw_driver_proj_start(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz);
+int hw_driver_proj_add(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz);
+int hw_driver_proj_dbl(void);
+int hw_driver_proj_end(uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz,
+		       int *iszero);
+
+/* Points resident in the IP, designated by handles 1 to (*nb) - 1:
+ * upload a point once, then add, double or negate points by handles
+ * (the result staying in the IP) and read a point back when needed
+ * (*iszero is set if it is null) */
+int hw_driver_pt_nb_handles(uint32_t *nb);
+int hw_driver_pt_load(uint32_t h, const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz);
+int hw_driver_pt_add(uint32_t h1, uint32_t h2, uint32_t hout);
+int hw_driver_pt_dbl(uint32_t h, uint32_t hout);
+int hw_driver_pt_neg(uint32_t h, uint32_t hout);
+int hw_driver_pt_store(uint32_t h, uint8_t *out_x, uint32_t *out_x_sz,
+		       uint8_t *out_y, uint32_t *out_y_sz, int *iszero);
+
+/* Arithmetic modulo the order q of the curve currently set
+ * (e.g for the scalar side of ECDSA): out = a * b, a + b, a - b
+ * or a^-1 mod q, with a and b in [0, q[ */
+int hw_driver_fq_mul(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
+		     uint8_t *out, uint32_t *out_sz);
+int hw_driver_fq_add(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
+		     uint8_t *out, uint32_t *out_sz);
+int hw_driver_fq_sub(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
+		     uint8_t *out, uint32_t *out_sz);
+int hw_driver_fq_inv(const uint8_t *a, uint32_t a_sz, uint8_t *out, uint32_t *out_sz);
+
+/* Arithmetic modulo the prime p of the curve currently set: out = a * b,
+ * a^2, a^-1 or a^e mod p, with a and b in [0, p[ (the exponent e must be
+ * public), in normal form or, when enabled, in Montgomery form (the
+ * conversions being done by hw_driver_fp_to/from_montgomery()) */
+int hw_driver_fp_mul(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
+		     uint8_t *out, uint32_t *out_sz);
+int hw_driver_fp_sqr(const uint8_t *a, uint32_t a_sz, uint8_t *out, uint32_t *out_sz);
+int hw_driver_fp_inv(const uint8_t *a, uint32_t a_sz, uint8_t *out, uint32_t *out_sz);
+int hw_driver_fp_exp(const uint8_t *a, uint32_t a_sz, const uint8_t *e, uint32_t e_sz,
+		     uint8_t *out, uint32_t *out_sz);
+int hw_driver_fp_to_montgomery(const uint8_t *a, uint32_t a_sz, uint8_t *out, uint32_t *out_sz);
+int hw_driver_fp_from_montgomery(const uint8_t *a, uint32_t a_sz, uint8_t *out, uint32_t *out_sz);
+int hw_driver_fp_enable_montgomery(void);
+int hw_driver_fp_disable_montgomery(void);
+
+/* Input of one operation of a batch modulo p: a op b
+ * (b is ignored for FP_SQR, FP_INV, FP_MTY and FP_NOMTY) */
+typedef struct {
+	const uint8_t *a;
+	uint32_t a_sz;
+	const uint8_t *b;
+	uint32_t b_sz;
+} hw_driver_fp_input;
+
+/* Output of one operation of a batch modulo p (out_sz gives the size of
+ * the buffer, and is updated with the size of the result) */
+typedef struct {
+	uint8_t *out;
+	uint32_t out_sz;
+} hw_driver_fp_output;
+
+/* Return out[i].out = in[i].a op in[i].b mod p for the 'nb' operations of a
+ * batch, op being one of FP_ADD, FP_SUB, FP_MUL, FP_SQR, FP_INV, FP_EXP,
+ * FP_MTY or FP_NOMTY (an operand shared by consecutive operations is only
+ * transferred once) */
+int hw_driver_fp_batch(ip_ecc_command cmd, const hw_driver_fp_input *in,
+		       hw_driver_fp_output *out, uint32_t nb);
+
 /* Set the small scalar size in the hardware */
 int hw_driver_set_small_scalar_size(uint32_t bit_sz);
 
@@ -42,6 +42,31 @@
 #error "WITH_EC_HW_ACCELERATOR_WORD32 and WITH_EC_HW_ACCELERATOR_WORD64 cannot be both defined!"
 #endif
 
+/***********************************************************/
+/* Thread-safe mode (Linux only).
+ *
+ * When WITH_EC_HW_THREAD_SAFE is defined, the driver API can be called
+ * concurrently from several threads: each IP is protected by a lock
+ * which is held during a whole call to the API (see driver_enter() and
+ * driver_leave()), and the IP a thread operates on is selected per thread
+ * (see hw_driver_select_device()). Queries only reading values the driver
+ * keeps in memory (e.g hw_driver_is_debug()) do not take the lock once the
+ * IP has been set up.
+ */
+#if defined(WITH_EC_HW_THREAD_SAFE)
+#if defined(WITH_EC_HW_STANDALONE)
+#error "WITH_EC_HW_THREAD_SAFE cannot be used with WITH_EC_HW_STANDALONE!"
+#endif
+#include <pthread.h>
+#define IPECC_THREAD_LOCAL		__thread
+#define IPECC_LOAD_ACQUIRE(v)		__atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define IPECC_STORE_RELEASE(v, val)	__atomic_store_n(&(v), (val), __ATOMIC_RELEASE)
+#else
+#define IPECC_THREAD_LOCAL
+#define IPECC_LOAD_ACQUIRE(v)		(v)
+#define IPECC_STORE_RELEASE(v, val)	((v) = (val))
+#endif
+
 #if defined(WITH_EC_HW_ACCELERATOR_WORD32)
 typedef volatile uint32_t ip_ecc_word;
 #define IPECC_WORD_FMT "%08x"
@@ -90,7 +115,11 @@ err:
  * depending on the IP configuration.
  */
 
-#if defined(WITH_EC_HW_ACCELERATOR_WORD64)
+#if defined(WITH_EC_HW_REGMODEL)
+/* Registers of the IP are emulated (see hw_accelerator_driver_regmodel.c) */
+#define IPECC_GET_REG(reg)		(hw_driver_regmodel_get((reg)))
+#define IPECC_SET_REG(reg, val)		(hw_driver_regmodel_set((reg), (uint32_t)(val)))
+#elif defined(WITH_EC_HW_ACCELERATOR_WORD64)
 /* In 64 bits, reverse words endianness */
 #define IPECC_GET_REG(reg)	((*((ip_ecc_word*)((reg)))) & 0xffffffff)
 #define IPECC_SET_REG(reg, val)	\
@@ -108,8 +137,11 @@ err:
  *
  * This is configured by the lower layer that implements platform
  * specific routines.
+ *
+ * When several IPs are driven, this is the base address of the one
+ * currently selected (see ip_ecc_select_device()).
  */
-static volatile uint64_t *ipecc_baddr = NULL;
+static IPECC_THREAD_LOCAL volatile uint64_t *ipecc_baddr = NULL;
 /* Uncomment line below to use the Pseudo TRNG feature
  * (not yet officially released on the IPECC repo).
  */
@@ -132,7 +164,16 @@ static volatile uint64_t *ipecc_baddr = NULL;
 #define IPECC_W_ERR_ACK			(ipecc_baddr + IPECC_ALIGNED(0x050))
 #define IPECC_W_SMALL_SCALAR		(ipecc_baddr + IPECC_ALIGNED(0x058))
 #define IPECC_W_SOFT_RESET  	(ipecc_baddr + IPECC_ALIGNED(0x060))
-/*	-- Reserved                                                           0x068...0x0f8  */
+#define IPECC_W_PT_SLOT  	(ipecc_baddr + IPECC_ALIGNED(0x070))
+#define IPECC_W_CURVE_A  	(ipecc_baddr + IPECC_ALIGNED(0x078))
+#define IPECC_W_PT_DEC  	(ipecc_baddr + IPECC_ALIGNED(0x080))
+#define IPECC_W_DMA_RING  	(ipecc_baddr + IPECC_ALIGNED(0x088))
+#define IPECC_W_DMA_CTRL  	(ipecc_baddr + IPECC_ALIGNED(0x090))
+#define IPECC_W_DMA_TAIL  	(ipecc_baddr + IPECC_ALIGNED(0x098))
+#define IPECC_W_KP2  		(ipecc_baddr + IPECC_ALIGNED(0x0a0))
+#define IPECC_W_JOBQ_CTRL  	(ipecc_baddr + IPECC_ALIGNED(0x0a8))
+#define IPECC_W_MODULUS  	(ipecc_baddr + IPECC_ALIGNED(0x0b0))
+/*	-- Reserved                                                           0x0b8...0x0f8  */
 #define IPECC_W_DBG_HALT    (ipecc_baddr + IPECC_ALIGNED(0x100))
 #define IPECC_W_DBG_BKPT 		(ipecc_baddr + IPECC_ALIGNED(0x108))
 #define IPECC_W_DBG_STEPS 		(ipecc_baddr + IPECC_ALIGNED(0x110))
@@ -158,7 +199,11 @@ static volatile uint64_t *ipecc_baddr = NULL;
 #define IPECC_R_CAPABILITIES  		(ipecc_baddr + IPECC_ALIGNED(0x010))
 #define IPECC_R_HW_VERSION      (ipecc_baddr + IPECC_ALIGNED(0x018))
 #define IPECC_R_PRIME_SIZE  		(ipecc_baddr + IPECC_ALIGNED(0x020))
-/*	-- Reserved                               0x028...0x0f8 */
+#define IPECC_R_DMA_STATUS  		(ipecc_baddr + IPECC_ALIGNED(0x028))
+#define IPECC_R_DMA_HEAD  		(ipecc_baddr + IPECC_ALIGNED(0x030))
+#define IPECC_R_JOBQ_STATUS  		(ipecc_baddr + IPECC_ALIGNED(0x038))
+#define IPECC_R_JOBQ_GAP  		(ipecc_baddr + IPECC_ALIGNED(0x040))
+/*	-- Reserved                               0x048...0x0f8 */
 #define IPECC_R_DBG_CAPABILITIES_0	(ipecc_baddr + IPECC_ALIGNED(0x100))
 #define IPECC_R_DBG_CAPABILITIES_1	(ipecc_baddr + IPECC_ALIGNED(0x108))
 #define IPECC_R_DBG_CAPABILITIES_2	(ipecc_baddr + IPECC_ALIGNED(0x110))
@@ -219,11 +264,18 @@ static volatile uint64_t *ipecc_baddr = NULL;
 #define IPECC_W_CTRL_PT_NEG		(((uint32_t)0x1) << 4)
 #define IPECC_W_CTRL_PT_EQU		(((uint32_t)0x1) << 5)
 #define IPECC_W_CTRL_PT_OPP		(((uint32_t)0x1) << 6)
-/* bits 7-11 reserved */
+#define IPECC_W_CTRL_PT_KG		(((uint32_t)0x1) << 7)
+#define IPECC_W_CTRL_PT_PROJ		(((uint32_t)0x1) << 8)
+#define IPECC_W_CTRL_PT_NORM		(((uint32_t)0x1) << 9)
+#define IPECC_W_CTRL_FP_OP		(((uint32_t)0x1) << 10)
+#define IPECC_W_CTRL_FP_MTY		(((uint32_t)0x1) << 11)
 #define IPECC_W_CTRL_RD_TOKEN   (((uint32_t)0x1) << 12)
+#define IPECC_W_CTRL_FP_OPID_POS	(13)
+#define IPECC_W_CTRL_FP_OPID_MSK	(0x7)
 #define IPECC_W_CTRL_WRITE_NB		(((uint32_t)0x1) << 16)
 #define IPECC_W_CTRL_READ_NB		(((uint32_t)0x1) << 17)
 #define IPECC_W_CTRL_WRITE_K		(((uint32_t)0x1) << 18)
+#define IPECC_W_CTRL_WRITE_BP		(((uint32_t)0x1) << 19)
 #define IPECC_W_CTRL_NBADDR_MSK		(0xfff)
 #define IPECC_W_CTRL_NBADDR_POS		(20)
 
@@ -270,6 +322,80 @@ static volatile uint64_t *ipecc_baddr = NULL;
 /* no field here: action is performed simply by writing to the
    register address, whatever the value written */
 
+/* Fields for W_PT_SLOT */
+/* copy the point of the slot into R1 (or R0 along with R0) */
+#define IPECC_W_PT_SLOT_LOAD    (((uint32_t)0x1) << 0)
+/* copy R1 into the slot */
+#define IPECC_W_PT_SLOT_SAVE    (((uint32_t)0x1) << 1)
+#define IPECC_W_PT_SLOT_R0      (((uint32_t)0x1) << 2)
+/* copy the point of the slot into R1 and start a [k]P on it */
+#define IPECC_W_PT_SLOT_KP      (((uint32_t)0x1) << 3)
+/* slot number (also the slot captured by WRITE_BP writes) */
+#define IPECC_W_PT_SLOT_NB_POS  (8)
+#define IPECC_W_PT_SLOT_NB_MSK  (0x7f)
+
+/* Fields for W_CURVE_A */
+/* curve parameter 'a' is 0 (resp. -3 mod p) */
+#define IPECC_W_CURVE_A_ZERO    (((uint32_t)0x1) << 0)
+#define IPECC_W_CURVE_A_M3      (((uint32_t)0x1) << 1)
+
+/* Fields for W_PT_DEC */
+/* ask for the odd square root (instead of the even one) */
+#define IPECC_W_PT_DEC_ODD      (((uint32_t)0x1) << 0)
+
+/* Fields for W_KP2 */
+/* 0: load P1 = R0 & P2 = R1, 1: compute R1 <- [k1]P1 + [k2]P2 */
+#define IPECC_W_KP2_RUN         (((uint32_t)0x1) << 0)
+/* msb of k1 (resp. k2), only with IPECC_W_KP2_RUN */
+#define IPECC_W_KP2_P1          (((uint32_t)0x1) << 1)
+#define IPECC_W_KP2_P2          (((uint32_t)0x1) << 2)
+
+/* Fields for W_DMA_CTRL (registers W_DMA_* & R_DMA_* only exist if
+ * the IP has the DMA ring, see IPECC_IS_DMA_SUPPORTED()) */
+#define IPECC_W_DMA_CTRL_EN       (((uint32_t)0x1) << 0)
+#define IPECC_W_DMA_CTRL_IRQEN    (((uint32_t)0x1) << 1)
+/* log2 of the nb of descriptors in the ring */
+#define IPECC_W_DMA_CTRL_LGSZ_POS (8)
+#define IPECC_W_DMA_CTRL_LGSZ_MSK (0xf)
+/* nb of words of the large numbers in memory */
+#define IPECC_W_DMA_CTRL_NBW_POS  (16)
+#define IPECC_W_DMA_CTRL_NBW_MSK  (0xff)
+
+/* Fields for W_JOBQ_CTRL (see ip_ecc_jobq_submit() & ip_ecc_jobq_collect()) */
+/* open the entry at the tail of the queue (the IP fills its token) */
+#define IPECC_W_JOBQ_CTRL_OPEN    (((uint32_t)0x1) << 0)
+/* close the open entry, making it a job to be computed */
+#define IPECC_W_JOBQ_CTRL_PUSH    (((uint32_t)0x1) << 1)
+/* release the entry at the head of the queue (its result was read) */
+#define IPECC_W_JOBQ_CTRL_POP     (((uint32_t)0x1) << 2)
+/* bind the reads of R1 to the result of the job at the head */
+#define IPECC_W_JOBQ_CTRL_RES     (((uint32_t)0x1) << 3)
+/* close the open entry, discarding it */
+#define IPECC_W_JOBQ_CTRL_DROP    (((uint32_t)0x1) << 4)
+
+/* Fields for W_MODULUS (see ip_ecc_fq_load() & ip_ecc_fq_unload()) */
+/* 0: the IP works modulo p, 1: modulo q */
+#define IPECC_W_MODULUS_Q         (((uint32_t)0x1) << 0)
+
+/* Job descriptors of the DMA ring: 8 fields of 32 bits, the last one
+ * (STATUS) being written back by the IP at the end of the job with the
+ * value of R_STATUS and bit IPECC_DMA_DESC_DONE set */
+#define IPECC_DMA_DESC_SZ         (32) /* in bytes */
+#define IPECC_DMA_DESC_FLAGS      (0)
+#define IPECC_DMA_DESC_CTRL       (1) /* value written to W_CTRL */
+#define IPECC_DMA_DESC_K          (2)
+#define IPECC_DMA_DESC_X          (3)
+#define IPECC_DMA_DESC_Y          (4)
+#define IPECC_DMA_DESC_RES        (5)
+#define IPECC_DMA_DESC_TOKEN      (6)
+#define IPECC_DMA_DESC_STATUS     (7)
+#define IPECC_DMA_FLAG_TOKEN      (((uint32_t)0x1) << 0)
+#define IPECC_DMA_FLAG_K          (((uint32_t)0x1) << 1)
+#define IPECC_DMA_FLAG_PT         (((uint32_t)0x1) << 2)
+#define IPECC_DMA_FLAG_RES        (((uint32_t)0x1) << 3)
+#define IPECC_DMA_FLAG_IRQ        (((uint32_t)0x1) << 4)
+#define IPECC_DMA_DESC_DONE       (((uint32_t)0x1) << 0)
+
 /* Fields for W_DBG_HALT */
 #define IPECC_W_DBG_HALT_DO_HALT   (((uint32_t)0x1) << 0)
 
@@ -372,6 +498,9 @@ static volatile uint64_t *ipecc_baddr = NULL;
 
 /* Fields for R_STATUS */
 #define IPECC_R_STATUS_BUSY	   (((uint32_t)0x1) << 0)
+#define IPECC_R_STATUS_PROJ	   (((uint32_t)0x1) << 1)
+#define IPECC_R_STATUS_MODQ	   (((uint32_t)0x1) << 2)
+#define IPECC_R_STATUS_QCTX	   (((uint32_t)0x1) << 3)
 #define IPECC_R_STATUS_KP	   (((uint32_t)0x1) << 4)
 #define IPECC_R_STATUS_MTY	   (((uint32_t)0x1) << 5)
 #define IPECC_R_STATUS_POP	   (((uint32_t)0x1) << 6)
@@ -388,11 +517,53 @@ static volatile uint64_t *ipecc_baddr = NULL;
 
 /* Fields for R_CAPABILITIES */
 #define IPECC_R_CAPABILITIES_DBG_N_PROD   (((uint32_t)0x1) << 0)
+#define IPECC_R_CAPABILITIES_QCTX   (((uint32_t)0x1) << 1)
+#define IPECC_R_CAPABILITIES_PROJ   (((uint32_t)0x1) << 2)
+#define IPECC_R_CAPABILITIES_AFAST   (((uint32_t)0x1) << 3)
 #define IPECC_R_CAPABILITIES_SHF   (((uint32_t)0x1) << 4)
+#define IPECC_R_CAPABILITIES_SLOTS_POS	(5)
+#define IPECC_R_CAPABILITIES_SLOTS_MSK	(0x7)
 #define IPECC_R_CAPABILITIES_NNDYN   (((uint32_t)0x1) << 8)
 #define IPECC_R_CAPABILITIES_W64   (((uint32_t)0x1) << 9)
-#define IPECC_R_CAPABILITIES_NNMAX_MSK	(0xfffff)
+#define IPECC_R_CAPABILITIES_STRM   (((uint32_t)0x1) << 10)
+#define IPECC_R_CAPABILITIES_BP   (((uint32_t)0x1) << 11)
+#define IPECC_R_CAPABILITIES_NNMAX_MSK	(0xffff)
 #define IPECC_R_CAPABILITIES_NNMAX_POS	(12)
+#define IPECC_R_CAPABILITIES_DEC   (((uint32_t)0x1) << 28)
+#define IPECC_R_CAPABILITIES_KP2   (((uint32_t)0x1) << 29)
+#define IPECC_R_CAPABILITIES_DMA   (((uint32_t)0x1) << 30)
+#define IPECC_R_CAPABILITIES_FOP   (((uint32_t)0x1) << 31)
+
+/* Fields for R_DMA_STATUS */
+#define IPECC_R_DMA_STATUS_ACTIVE  (((uint32_t)0x1) << 0)
+#define IPECC_R_DMA_STATUS_BERR    (((uint32_t)0x1) << 1)
+
+/* Fields for R_JOBQ_STATUS */
+/* nb of entries of the job queue (0 if the IP has none) */
+#define IPECC_R_JOBQ_STATUS_NB_POS      (0)
+#define IPECC_R_JOBQ_STATUS_NB_MSK      (0xf)
+#define IPECC_R_JOBQ_STATUS_OPEN        (((uint32_t)0x1) << 4)
+/* the IP is filling the token of the open entry, gathering random for
+ * its scalar or ending a transfer: wait before writing W_CTRL/W_JOBQ_CTRL */
+#define IPECC_R_JOBQ_STATUS_FILL        (((uint32_t)0x1) << 5)
+#define IPECC_R_JOBQ_STATUS_FULL        (((uint32_t)0x1) << 6)
+#define IPECC_R_JOBQ_STATUS_RES         (((uint32_t)0x1) << 7)
+/* the job at the head is done (& the flags of its result) */
+#define IPECC_R_JOBQ_STATUS_HEAD_DONE   (((uint32_t)0x1) << 8)
+#define IPECC_R_JOBQ_STATUS_HEAD_NULL   (((uint32_t)0x1) << 9)
+#define IPECC_R_JOBQ_STATUS_HEAD_ERRIN  (((uint32_t)0x1) << 10)
+#define IPECC_R_JOBQ_STATUS_HEAD_ERROUT (((uint32_t)0x1) << 11)
+#define IPECC_R_JOBQ_STATUS_QUEUED_POS  (16)
+#define IPECC_R_JOBQ_STATUS_QUEUED_MSK  (0xf)
+#define IPECC_R_JOBQ_STATUS_DONE_POS    (20)
+#define IPECC_R_JOBQ_STATUS_DONE_MSK    (0xf)
+
+/* Fields for R_JOBQ_GAP */
+/* nb of cycles the IP stayed idle between the end of the last job of the
+ * queue & the start of the one following it back-to-back */
+#define IPECC_R_JOBQ_GAP_CYCLES_POS     (0)
+#define IPECC_R_JOBQ_GAP_CYCLES_MSK     (0xffff)
+#define IPECC_R_JOBQ_GAP_VALID          (((uint32_t)0x1) << 31)
 
 /* Fields for R_HW_VERSION */
 #define IPECC_R_HW_VERSION_MAJOR_POS    (24)
@@ -512,6 +683,34 @@ static volatile uint64_t *ipecc_baddr = NULL;
 #define IPECC_BUSY_WAIT() do { \
 	while(IPECC_GET_REG(IPECC_R_STATUS) & IPECC_R_STATUS_BUSY){}; \
 } while(0)
+
+/* Wait for the end of the transfer of the current word of a large number
+ * (only used while a point is staged during a [k]P computation, the IP
+ * then being busy all along, see ip_ecc_stage_begin()) */
+#define IPECC_R_W_WAIT() do { \
+	while(IPECC_GET_REG(IPECC_R_STATUS) & IPECC_R_STATUS_R_OR_W){}; \
+} while(0)
+
+/* Wait until a point can be staged into a slot: the IP is either not busy,
+ * or only busy computing a [k]P (no large number being transferred) */
+#define IPECC_STAGE_WAIT() do { \
+	uint32_t st; \
+	do { \
+		st = (uint32_t)IPECC_GET_REG(IPECC_R_STATUS); \
+	} while((st & IPECC_R_STATUS_BUSY) \
+		&& (!(st & IPECC_R_STATUS_KP) || (st & IPECC_R_STATUS_R_OR_W))); \
+} while(0)
+
+/* Wait until the job queue is ready for the next step of its filling or of
+ * the read of a result (see ip_ecc_jobq_submit()): the token of the open
+ * entry is generated, the random to mask its scalar is gathered and the
+ * previous large number transfer is over */
+#define IPECC_JOBQ_FILL_WAIT() do { \
+	while(IPECC_GET_REG(IPECC_R_JOBQ_STATUS) & IPECC_R_JOBQ_STATUS_FILL){}; \
+} while(0)
+
+/* Is the IP busy? (this is the bit IPECC_BUSY_WAIT() polls on) */
+#define IPECC_IS_BUSY() 	(!!(IPECC_GET_REG(IPECC_R_STATUS) & IPECC_R_STATUS_BUSY))
 /* The following macros IPECC_IS_BUSY_* are to obtain more info, when the IP is busy,
  * on why it is busy.
  * However one should keep in mind that polling code should restrict to IPECC_BUSY_WAIT
@@ -580,6 +779,32 @@ static volatile uint64_t *ipecc_baddr = NULL;
 #define IPECC_EXEC_PT_EQU() (IPECC_SET_REG(IPECC_W_CTRL, IPECC_W_CTRL_PT_EQU))
 #define IPECC_EXEC_PT_OPP() (IPECC_SET_REG(IPECC_W_CTRL, IPECC_W_CTRL_PT_OPP))
 #define IPECC_EXEC_PT_NEG() (IPECC_SET_REG(IPECC_W_CTRL, IPECC_W_CTRL_PT_NEG))
+#define IPECC_EXEC_PT_KG()  (IPECC_SET_REG(IPECC_W_CTRL, IPECC_W_CTRL_PT_KG))
+/* Projective point addition & doubling (result R1 is left in projective
+ * form in the IP) and conversion of R1 back to affine form */
+#define IPECC_EXEC_PT_ADD_PROJ() (IPECC_SET_REG(IPECC_W_CTRL, \
+			IPECC_W_CTRL_PT_ADD | IPECC_W_CTRL_PT_PROJ))
+#define IPECC_EXEC_PT_DBL_PROJ() (IPECC_SET_REG(IPECC_W_CTRL, \
+			IPECC_W_CTRL_PT_DBL | IPECC_W_CTRL_PT_PROJ))
+#define IPECC_EXEC_PT_NORM() (IPECC_SET_REG(IPECC_W_CTRL, IPECC_W_CTRL_PT_NORM))
+/* Field arithmetic: XR1 <- XR0 op YR0 modulo the value written in
+ * place of 'p' (op ids below are the ones of field FP_OPID of W_CTRL),
+ * with operands and result in Montgomery form if 'mty' is set */
+#define IPECC_FP_OPID_ADD	(0x0)
+#define IPECC_FP_OPID_SUB	(0x1)
+#define IPECC_FP_OPID_MUL	(0x2)
+#define IPECC_FP_OPID_INV	(0x3)
+#define IPECC_FP_OPID_SQR	(0x4)
+#define IPECC_FP_OPID_EXP	(0x5)
+#define IPECC_FP_OPID_MTY	(0x6)
+#define IPECC_FP_OPID_NOMTY	(0x7)
+#define IPECC_EXEC_FP_OP(opid, mty) (IPECC_SET_REG(IPECC_W_CTRL, IPECC_W_CTRL_FP_OP \
+			| (((opid) & IPECC_W_CTRL_FP_OPID_MSK) << IPECC_W_CTRL_FP_OPID_POS) \
+			| ((mty) ? IPECC_W_CTRL_FP_MTY : 0)))
+
+/* Does R1 currently hold a point in projective form? */
+#define IPECC_IS_PROJ() \
+	(!!(IPECC_GET_REG(IPECC_R_STATUS) & IPECC_R_STATUS_PROJ))
 
 /* On curve/equality/opposition flags handling
  */
@@ -624,12 +849,15 @@ static volatile uint64_t *ipecc_baddr = NULL;
 /* Write in register W_CTRL the address of the big number to write
  * and assert the write-command bit.
  *
- * Also assert the specific bit if the number to write is the scalar.
+ * Also assert the specific bit if the number to write is the scalar,
+ * or if it is a coordinate of R1 the IP must also keep as its stored
+ * base point.
  */
-#define IPECC_SET_WRITE_ADDR(addr, scal) do { \
+#define IPECC_SET_WRITE_ADDR(addr, scal, bp) do { \
 	ip_ecc_word val = 0; \
 	val |= IPECC_W_CTRL_WRITE_NB; \
 	val |= ((scal) ? IPECC_W_CTRL_WRITE_K : 0); \
+	val |= ((bp) ? IPECC_W_CTRL_WRITE_BP : 0); \
 	val |= ((addr & IPECC_W_CTRL_NBADDR_MSK) << IPECC_W_CTRL_NBADDR_POS); \
 	IPECC_SET_REG(IPECC_W_CTRL, val); \
 } while(0)
@@ -781,6 +1009,11 @@ static volatile uint64_t *ipecc_baddr = NULL;
 	IPECC_SET_REG(IPECC_W_IRQ, IPECC_W_IRQ_EN); \
 } while (0)
 
+/* Disable interrupt requests */
+#define IPECC_DISABLE_IRQ() do { \
+	IPECC_SET_REG(IPECC_W_IRQ, 0); \
+} while (0)
+
 /*
  * Actions using register R_STATUS & W_ERR_ACK
  * (error detection & acknowlegment)
@@ -899,6 +1132,111 @@ static volatile uint64_t *ipecc_baddr = NULL;
 	(IPECC_SET_REG(IPECC_W_SOFT_RESET, 1)); /* written value actually is indifferent */ \
 } while (0)
 
+/*
+ * Actions using register W_PT_SLOT
+ * ********************************
+ */
+/* Select the point slot that the next writes of R1 with the WRITE_BP bit
+ * are captured into (slot 0 is the base point of [k]G) */
+#define IPECC_PT_SLOT_SELECT(slot) do { \
+	IPECC_SET_REG(IPECC_W_PT_SLOT, \
+		((slot) & IPECC_W_PT_SLOT_NB_MSK) << IPECC_W_PT_SLOT_NB_POS); \
+} while (0)
+
+/* Copy the point held in a slot into R1 (or into R0 if 'r0' is set) */
+#define IPECC_PT_SLOT_LOAD(slot, r0) do { \
+	IPECC_SET_REG(IPECC_W_PT_SLOT, IPECC_W_PT_SLOT_LOAD \
+		| ((r0) ? IPECC_W_PT_SLOT_R0 : 0) \
+		| (((slot) & IPECC_W_PT_SLOT_NB_MSK) << IPECC_W_PT_SLOT_NB_POS)); \
+} while (0)
+
+/* Copy R1 into a slot */
+#define IPECC_PT_SLOT_SAVE(slot) do { \
+	IPECC_SET_REG(IPECC_W_PT_SLOT, IPECC_W_PT_SLOT_SAVE \
+		| (((slot) & IPECC_W_PT_SLOT_NB_MSK) << IPECC_W_PT_SLOT_NB_POS)); \
+} while (0)
+
+/* Copy the point held in a slot into R1 and start a [k]P computation on it */
+#define IPECC_PT_SLOT_KP(slot) do { \
+	IPECC_SET_REG(IPECC_W_PT_SLOT, IPECC_W_PT_SLOT_KP \
+		| (((slot) & IPECC_W_PT_SLOT_NB_MSK) << IPECC_W_PT_SLOT_NB_POS)); \
+} while (0)
+
+/*
+ * Actions using registers W_JOBQ_CTRL & R_JOBQ_STATUS
+ * ***************************************************
+ */
+/* Send a command of the job queue (IPECC_W_JOBQ_CTRL_*) */
+#define IPECC_JOBQ_CMD(cmd) do { \
+	IPECC_SET_REG(IPECC_W_JOBQ_CTRL, (cmd)); \
+} while (0)
+
+/* Status of the job queue */
+#define IPECC_JOBQ_STATUS() \
+	((uint32_t)IPECC_GET_REG(IPECC_R_JOBQ_STATUS))
+
+/* Nb of cycles the IP stayed idle between two jobs of the queue run
+ * back-to-back (-1 if none was) */
+#define IPECC_JOBQ_GAP() \
+	((IPECC_GET_REG(IPECC_R_JOBQ_GAP) & IPECC_R_JOBQ_GAP_VALID) ? \
+	 (int)((IPECC_GET_REG(IPECC_R_JOBQ_GAP) >> IPECC_R_JOBQ_GAP_CYCLES_POS) \
+	  & IPECC_R_JOBQ_GAP_CYCLES_MSK) : -1)
+
+/*
+ * Actions using register W_CURVE_A
+ * ********************************
+ */
+/* Declare the shape of curve parameter 'a' (0, IPECC_W_CURVE_A_ZERO or
+ * IPECC_W_CURVE_A_M3). Must be done after 'p' and 'a' are written, as
+ * writing any of them clears it.
+ */
+#define IPECC_SET_CURVE_A_SHAPE(shape) do { \
+	IPECC_SET_REG(IPECC_W_CURVE_A, (shape)); \
+} while (0)
+
+/*
+ * Actions using register W_MODULUS
+ * ********************************
+ */
+/* Make the IP work modulo q (resp. p). The Montgomery constants of q are
+ * only computed the first time q is written, see IPECC_IS_QCTX_VALID() */
+#define IPECC_SET_MODULUS(q) do { \
+	IPECC_SET_REG(IPECC_W_MODULUS, ((q) ? IPECC_W_MODULUS_Q : 0)); \
+} while (0)
+
+/* Does the IP hold q along with its Montgomery constants? */
+#define IPECC_IS_QCTX_VALID() \
+	(!!(IPECC_GET_REG(IPECC_R_STATUS) & IPECC_R_STATUS_QCTX))
+
+/*
+ * Actions using register W_PT_DEC
+ * *******************************
+ */
+/* Decompress point R1: YR1 <- sqrt(XR1^3 + a.XR1 + b), of parity 'odd'
+ * (only for p = 3 mod 4). Whether XR1 is the x-coordinate of a point on
+ * the curve is then given by IPECC_GET_ONCURVE() */
+#define IPECC_EXEC_PT_DEC(odd) do { \
+	IPECC_SET_REG(IPECC_W_PT_DEC, ((odd) ? IPECC_W_PT_DEC_ODD : 0)); \
+} while (0)
+
+/*
+ * Actions using register W_KP2
+ * ****************************
+ */
+/* Load P1 = R0 & P2 = R1 (affine, non null) for double scalar multiplications */
+#define IPECC_EXEC_KP2_LOAD() do { \
+	IPECC_SET_REG(IPECC_W_KP2, 0); \
+} while (0)
+
+/* R1 <- [k1]P1 + [k2]P2, XR0 & YR0 holding the bits of k1 & k2 below their
+ * common msb position in reverse order (k2 followed by a sentinel bit) and
+ * 'msb1' & 'msb2' being the msb of k1 & k2 (at least one of them is set).
+ * Whether R1 holds the result is then given by IPECC_GET_ONCURVE() */
+#define IPECC_EXEC_KP2_RUN(msb1, msb2) do { \
+	IPECC_SET_REG(IPECC_W_KP2, IPECC_W_KP2_RUN \
+			| ((msb1) ? IPECC_W_KP2_P1 : 0) | ((msb2) ? IPECC_W_KP2_P2 : 0)); \
+} while (0)
+
 /*
  * Actions using register R_CAPABILITIES
  * (Capabilities handling)
@@ -916,6 +1254,67 @@ static volatile uint64_t *ipecc_baddr = NULL;
 	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_SHF)))
 #define IPECC_IS_W64() \
 	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_W64)))
+/* To know if the IP hardware accepts that the limbs of a large number
+ * be written/read back-to-back (without polling R_STATUS inbetween).
+ */
+#define IPECC_IS_STREAMING_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_STRM)))
+/* To know if the IP hardware can store a base point and multiply it
+ * (command [k]G) without software uploading it again.
+ */
+#define IPECC_IS_BASE_POINT_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_BP)))
+/* To know if the IP hardware can leave the result of point additions
+ * and doublings in projective form (bit PT_PROJ of W_CTRL).
+ */
+#define IPECC_IS_PROJ_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_PROJ)))
+/* To know if the IP hardware has the doubling shortcuts for a = 0 and
+ * a = -3 (register W_CURVE_A).
+ */
+#define IPECC_IS_AFAST_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_AFAST)))
+/* To know if the IP hardware has the field arithmetic commands
+ * (bit FP_OP of W_CTRL).
+ */
+#define IPECC_IS_FOP_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_FOP)))
+/* To know if the IP hardware has the point decompression command
+ * (register W_PT_DEC).
+ */
+#define IPECC_IS_DEC_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_DEC)))
+/* To know if the IP hardware has the ring of job descriptors in system
+ * memory (registers W_DMA_* & R_DMA_*).
+ */
+#define IPECC_IS_DMA_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_DMA)))
+/* To know if the IP hardware has the double scalar multiplication
+ * (register W_KP2).
+ */
+#define IPECC_IS_KP2_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_KP2)))
+/* To know if the IP hardware keeps the Montgomery constants of q aside
+ * those of p (register W_MODULUS).
+ */
+#define IPECC_IS_QCTX_SUPPORTED() \
+	(!!((IPECC_GET_REG(IPECC_R_CAPABILITIES) & IPECC_R_CAPABILITIES_QCTX)))
+/* Number of point slots of the IP (register W_PT_SLOT), 0 if the IP
+ * only stores the base point (or nothing at all).
+ */
+#define IPECC_GET_PT_SLOTS() \
+	(((IPECC_GET_REG(IPECC_R_CAPABILITIES) >> IPECC_R_CAPABILITIES_SLOTS_POS) \
+	  & IPECC_R_CAPABILITIES_SLOTS_MSK) ? \
+	 (1 << ((IPECC_GET_REG(IPECC_R_CAPABILITIES) >> IPECC_R_CAPABILITIES_SLOTS_POS) \
+	  & IPECC_R_CAPABILITIES_SLOTS_MSK)) : 0)
+
+/* Number of entries of the job queue of the IP (register W_JOBQ_CTRL), 0 if
+ * the IP has none (the register then reads as 0, or as all ones).
+ */
+#define IPECC_GET_JOBQ_NB() \
+	((IPECC_GET_REG(IPECC_R_JOBQ_STATUS) == 0xffffffff) ? 0 : \
+	 ((IPECC_GET_REG(IPECC_R_JOBQ_STATUS) >> IPECC_R_JOBQ_STATUS_NB_POS) \
+	  & IPECC_R_JOBQ_STATUS_NB_MSK))
 
 /* Returns the maximum (and default) value allowed for 'nn' parameter (if the IP was
  * synthesized with the 'nn modifiable at runtime' option) or simply the static,
@@ -1690,6 +2089,10 @@ typedef enum {
 	EC_HW_REG_R1_Y   = 7,
 	EC_HW_REG_SCALAR = 8,
 	EC_HW_REG_TOKEN  = 9,
+	/* Coordinates of R1, also kept by the IP as its stored base point
+	 * (write only) */
+	EC_HW_REG_BP_X   = 10,
+	EC_HW_REG_BP_Y   = 11,
 } ip_ecc_register;
 
 typedef enum {
@@ -1753,6 +2156,402 @@ static inline void ip_ecc_log(const char *s)
 }
 #endif /* WITH_EC_HW_DEBUG */
 
+/* Software shadow of the IP registers that the driver reads often.
+ *
+ * Register R_CAPABILITIES is constant for a given synthesis of the IP,
+ * so it is read once and for all by driver_setup(). The current value
+ * of 'nn' (register R_PRIME_SIZE) only changes when the driver itself
+ * sets it (ip_ecc_set_nn_bit_size()) or upon a reset of the IP, so it
+ * is tracked in software too and only read back from the IP when it
+ * has been invalidated by one of these two events.
+ *
+ * This spares several uncached AXI reads per big number transfer.
+ */
+typedef struct {
+	/* Snapshot of R_CAPABILITIES, taken in driver_setup() */
+	uint32_t nn_max;
+	uint8_t nn_dynamic;
+	uint8_t shuffling;
+	uint8_t w64;
+	uint8_t debug;
+	uint8_t streaming;
+	uint8_t base_point;
+	uint8_t proj;
+	uint8_t afast;
+	uint8_t fop;
+	uint8_t dec;
+	uint8_t dma;
+	uint8_t kp2;
+	uint8_t qctx;
+	uint32_t pt_slots;
+	uint32_t jobq_nb;
+	/* Version numbers (register R_HW_VERSION) */
+	uint32_t version_major;
+	uint32_t version_minor;
+	uint32_t version_patch;
+	/* Current value of 'nn' (only meaningful if 'nn_valid' is set) */
+	uint32_t nn;
+	uint8_t nn_valid;
+} ip_ecc_shadow_regs;
+
+/* Curve parameters, as registered by software (see hw_driver_register_curve())
+ * or as currently resident in the IP.
+ *
+ * Parameters are kept in the big-endian format they were given in, along with
+ * a digest of their sizes and contents. Two sets of parameters are considered
+ * the same curve only if their digests, sizes and contents all match.
+ */
+#define IPECC_CURVE_MAX_SZ	128 /* in bytes, i.e nn <= 1024 */
+
+typedef struct {
+	uint8_t a[IPECC_CURVE_MAX_SZ];
+	uint8_t b[IPECC_CURVE_MAX_SZ];
+	uint8_t p[IPECC_CURVE_MAX_SZ];
+	uint8_t q[IPECC_CURVE_MAX_SZ];
+	uint32_t a_sz;
+	uint32_t b_sz;
+	uint32_t p_sz;
+	uint32_t q_sz;
+	uint64_t digest;
+	uint8_t valid;
+} ip_ecc_curve;
+
+/* Table of curves registered by software (the id of a curve is its index) */
+static ip_ecc_curve ipecc_curves[HW_DRIVER_MAX_CURVES];
+
+/* The table of curves is shared by all the IPs: in thread-safe mode it
+ * has its own lock (always taken after the one of an IP, if any).
+ */
+#if defined(WITH_EC_HW_THREAD_SAFE)
+static pthread_mutex_t ipecc_curves_lock = PTHREAD_MUTEX_INITIALIZER;
+#define IPECC_CURVES_LOCK()	pthread_mutex_lock(&ipecc_curves_lock)
+#define IPECC_CURVES_UNLOCK()	pthread_mutex_unlock(&ipecc_curves_lock)
+#else
+#define IPECC_CURVES_LOCK()
+#define IPECC_CURVES_UNLOCK()
+#endif
+
+/* 32768 bits are more than enough for any practical
+ * use of elliptic curve cryptography.
+ */
+#define IPECC_TOKEN_MAX_SZ	4096
+
+/* Scalar multiplication in flight (see hw_driver_mul_submit()) */
+typedef struct {
+	uint8_t token[IPECC_TOKEN_MAX_SZ];
+	uint32_t nn_sz;
+	/* Handle of the job returned to software */
+	hw_driver_mul_job id;
+	uint8_t pending;
+	/* Job queued behind it, its point being staged in the IP
+	 * (see ip_ecc_kp_enqueue()) */
+	struct {
+		uint8_t scalar[IPECC_CURVE_MAX_SZ];
+		uint32_t scalar_sz;
+		hw_driver_mul_job id;
+		uint8_t pending;
+	} next;
+#if defined(WITH_EC_HW_THREAD_SAFE)
+	/* Thread which submitted the job */
+	pthread_t owner;
+#endif
+} ip_ecc_kp_job;
+
+/* Maximum number of point slots handled by the driver
+ * (see hw_driver_pt_load()) */
+#define IPECC_PT_SLOTS_MAX	128
+
+/* Maximum number of entries of the job queue used by the driver
+ * (see hw_driver_mul_batch()) */
+#define IPECC_JOBQ_MAX	8
+
+/* Chain of point operations (see hw_driver_proj_start()) */
+typedef enum {
+	/* No chain */
+	IPECC_PROJ_NONE = 0,
+	/* The accumulated point is held by the driver in affine form
+	 * (start of the chain, or after it became null) */
+	IPECC_PROJ_AFF = 1,
+	/* The accumulated point is point R1 of the IP, in projective form */
+	IPECC_PROJ_IN_IP = 2,
+} ip_ecc_proj_state;
+
+typedef struct {
+	ip_ecc_proj_state state;
+	/* Accumulated point (only valid in state IPECC_PROJ_AFF) */
+	ipecc_point_t acc;
+	uint8_t acc_inf;
+} ip_ecc_proj_chain;
+
+/* Memory shared by the driver with the DMA ring of the IP: the ring of
+ * descriptors comes first (4 kB), followed by one area of
+ * IPECC_DMA_AREA_SZ bytes per descriptor of the ring for its buffers.
+ */
+#define IPECC_DMA_RING_SZ	4096
+#define IPECC_DMA_AREA_SZ	1024
+#define IPECC_DMA_LGSZ_MAX	7 /* (2**7 descriptors fill the 4 kB) */
+/* Offsets of the buffers in an area (each of IPECC_CURVE_MAX_SZ bytes,
+ * except RES which holds both coordinates) */
+#define IPECC_DMA_OFF_K		(0 * IPECC_CURVE_MAX_SZ)
+#define IPECC_DMA_OFF_X		(1 * IPECC_CURVE_MAX_SZ)
+#define IPECC_DMA_OFF_Y		(2 * IPECC_CURVE_MAX_SZ)
+#define IPECC_DMA_OFF_RES	(3 * IPECC_CURVE_MAX_SZ)
+#define IPECC_DMA_OFF_TOKEN	(5 * IPECC_CURVE_MAX_SZ)
+
+typedef struct {
+	/* Is the memory mapped? */
+	uint8_t mapped;
+	/* Virtual & physical (bus) addresses of the memory, and its size */
+	uint8_t *virt;
+	uint64_t phys;
+	uint32_t sz;
+	/* log2 of the nb of descriptors of the ring */
+	uint32_t lgsz;
+} ip_ecc_dma;
+
+/* State of one IP driven by the driver.
+ *
+ * Several IPs may be instantiated in the same design, each of them
+ * having its own context. All the functions of the driver operate on
+ * the IP currently selected (see ip_ecc_select_device()) whose context
+ * is pointed to by 'ipecc_dev'.
+ */
+typedef struct {
+	/* Base address of the IP */
+	volatile uint64_t *baddr;
+	/* Has the IP been set up? */
+	volatile uint8_t setup_state;
+	/* Shadow of the IP registers */
+	ip_ecc_shadow_regs shadow;
+	/* Are large numbers currently transferred in streaming mode?
+	 * (see ip_ecc_enable_streaming()) */
+	uint8_t streaming;
+	/* How the driver waits for the completion of scalar multiplications
+	 * (see hw_driver_set_completion_mode()) */
+	volatile hw_driver_completion_mode completion;
+	/* Curve currently resident in the IP (not valid if unknown) */
+	ip_ecc_curve resident_curve;
+	/* Is the order 'q' of the resident curve currently written in
+	 * the IP in place of 'p'? (see ip_ecc_fq_load()) */
+	uint8_t fq_loaded;
+	/* Are operands and results of the field arithmetic modulo 'p'
+	 * in Montgomery form? (see hw_driver_fp_enable_montgomery()) */
+	uint8_t fp_mty;
+	/* Base point of the curve currently set in the IP
+	 * (see hw_driver_set_base_point()), and is it also stored
+	 * in the IP (if supported by hardware)? */
+	ipecc_point_t base_point;
+	uint8_t base_point_valid;
+	uint8_t base_point_in_ip;
+	/* Scalar multiplication in flight */
+	ip_ecc_kp_job kp_job;
+	/* Chain of point operations in progress */
+	ip_ecc_proj_chain proj;
+	/* Which point slots of the IP hold a point (see hw_driver_pt_load()) */
+	uint8_t pt_slot_valid[IPECC_PT_SLOTS_MAX];
+	/* Slot kept by the driver to stage the point of the next [k]P
+	 * (0 if none, see ip_ecc_stage_begin()) */
+	uint32_t stage_slot;
+	/* Is a point currently being staged? */
+	uint8_t staging;
+	/* Are large numbers currently transferred to/from the job queue?
+	 * (see ip_ecc_jobq_submit()) */
+	uint8_t jobq;
+	/* Memory shared with the DMA ring of the IP (see hw_driver_mul_batch_dma()) */
+	ip_ecc_dma dma;
+#if defined(WITH_EC_HW_THREAD_SAFE)
+	/* Held during a whole call to the driver API on the IP */
+	pthread_mutex_t lock;
+	/* Signaled when the IP has no more scalar multiplication in flight */
+	pthread_cond_t kp_idle;
+#endif
+} ip_ecc_device;
+
+static ip_ecc_device ipecc_devices[HW_DRIVER_MAX_DEVICES];
+
+/* Context of the IP currently selected, and its index
+ * (per thread in thread-safe mode) */
+static IPECC_THREAD_LOCAL ip_ecc_device *ipecc_dev = &ipecc_devices[0];
+static IPECC_THREAD_LOCAL uint32_t ipecc_dev_idx = 0;
+
+/* IP reserved by the calling thread with hw_driver_lock_device() (NULL if
+ * none). It is kept apart from 'ipecc_dev', which hw_driver_select_device()
+ * may change in the meantime. */
+static IPECC_THREAD_LOCAL ip_ecc_device *ipecc_locked_dev = NULL;
+
+#if defined(WITH_EC_HW_THREAD_SAFE)
+static pthread_once_t ipecc_locks_once = PTHREAD_ONCE_INIT;
+
+/* Number of times the calling thread holds the lock of each IP */
+static IPECC_THREAD_LOCAL uint32_t ipecc_lock_depth[HW_DRIVER_MAX_DEVICES];
+
+/* The lock of an IP is recursive, so that a thread holding it through
+ * hw_driver_lock_device() can still call the driver API.
+ */
+static void ip_ecc_init_locks(void)
+{
+	pthread_mutexattr_t attr;
+	uint32_t i;
+
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	for(i = 0; i < HW_DRIVER_MAX_DEVICES; i++){
+		pthread_mutex_init(&ipecc_devices[i].lock, &attr);
+		pthread_cond_init(&ipecc_devices[i].kp_idle, NULL);
+	}
+	pthread_mutexattr_destroy(&attr);
+
+	return;
+}
+#endif
+
+/* Take the lock of the IP currently selected (thread-safe mode only).
+ *
+ * If 'wait_kp_idle' is set, also wait for the end of any scalar
+ * multiplication submitted to the IP by another thread (see
+ * hw_driver_mul_submit()) as the IP cannot be used in the meantime.
+ *
+ * Waiting on the condition only releases one level of the (recursive)
+ * lock, so it is not possible if the calling thread already held it
+ * (e.g through hw_driver_lock_device()): the other thread could never
+ * collect its job. An error is returned instead.
+ *
+ * The lock is taken even if an error is returned.
+ */
+static inline int ip_ecc_lock(int wait_kp_idle)
+{
+#if defined(WITH_EC_HW_THREAD_SAFE)
+	pthread_once(&ipecc_locks_once, ip_ecc_init_locks);
+	pthread_mutex_lock(&ipecc_dev->lock);
+	ipecc_lock_depth[ipecc_dev_idx]++;
+	while(wait_kp_idle && ipecc_dev->kp_job.pending
+			&& !pthread_equal(ipecc_dev->kp_job.owner, pthread_self())){
+		if(ipecc_lock_depth[ipecc_dev_idx] > 1){
+			log_print("Error: IP locked by the calling thread, and busy with "
+					"a scalar multiplication of another thread\n\r");
+			return -1;
+		}
+		pthread_cond_wait(&ipecc_dev->kp_idle, &ipecc_dev->lock);
+	}
+#else
+	(void)wait_kp_idle;
+#endif
+	return 0;
+}
+
+/* Release the lock of IP 'd' (thread-safe mode only) */
+static inline void ip_ecc_unlock_device(ip_ecc_device *d)
+{
+#if defined(WITH_EC_HW_THREAD_SAFE)
+	ipecc_lock_depth[d - ipecc_devices]--;
+	pthread_mutex_unlock(&d->lock);
+#else
+	(void)d;
+#endif
+	return;
+}
+
+/* Release the lock of the IP currently selected (thread-safe mode only) */
+static inline void ip_ecc_unlock(void)
+{
+	ip_ecc_unlock_device(ipecc_dev);
+
+	return;
+}
+
+/* The index of the IP on which a scalar multiplication was submitted is
+ * kept in the low bits of its handle, so that hw_driver_mul_poll() and
+ * hw_driver_mul_wait() can find it back.
+ */
+#define IPECC_JOB_DEV_MSK	(0xf)
+#define IPECC_JOB_SEQ_INC	(IPECC_JOB_DEV_MSK + 1)
+#define IPECC_JOB_DEV(job)	((job) & IPECC_JOB_DEV_MSK)
+
+#if (HW_DRIVER_MAX_DEVICES > (IPECC_JOB_DEV_MSK + 1))
+#error "HW_DRIVER_MAX_DEVICES too large"
+#endif
+
+/* Select the IP on which the driver operates */
+static inline int ip_ecc_select_device(uint32_t dev)
+{
+	if((dev >= HW_DRIVER_MAX_DEVICES) || (dev >= hw_driver_nb_devices())){
+		goto err;
+	}
+	ipecc_dev = &ipecc_devices[dev];
+	ipecc_dev_idx = dev;
+	ipecc_baddr = ipecc_dev->baddr;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Take the snapshot of register R_CAPABILITIES (called by driver_setup()) */
+static inline void ip_ecc_shadow_capabilities(void)
+{
+	ipecc_dev->shadow.nn_max = (uint32_t)IPECC_GET_NN_MAX();
+	ipecc_dev->shadow.nn_dynamic = (uint8_t)IPECC_IS_DYNAMIC_NN_SUPPORTED();
+	ipecc_dev->shadow.shuffling = (uint8_t)IPECC_IS_SHUFFLING_SUPPORTED();
+	ipecc_dev->shadow.w64 = (uint8_t)IPECC_IS_W64();
+	ipecc_dev->shadow.debug = (uint8_t)IPECC_IS_DEBUG_OR_PROD();
+	ipecc_dev->shadow.streaming = (uint8_t)IPECC_IS_STREAMING_SUPPORTED();
+	ipecc_dev->shadow.base_point = (uint8_t)IPECC_IS_BASE_POINT_SUPPORTED();
+	ipecc_dev->shadow.proj = (uint8_t)IPECC_IS_PROJ_SUPPORTED();
+	ipecc_dev->shadow.afast = (uint8_t)IPECC_IS_AFAST_SUPPORTED();
+	ipecc_dev->shadow.fop = (uint8_t)IPECC_IS_FOP_SUPPORTED();
+	ipecc_dev->shadow.dec = (uint8_t)IPECC_IS_DEC_SUPPORTED();
+	ipecc_dev->shadow.dma = (uint8_t)IPECC_IS_DMA_SUPPORTED();
+	ipecc_dev->shadow.kp2 = (uint8_t)IPECC_IS_KP2_SUPPORTED();
+	ipecc_dev->shadow.qctx = (uint8_t)IPECC_IS_QCTX_SUPPORTED();
+	ipecc_dev->shadow.pt_slots = (uint32_t)IPECC_GET_PT_SLOTS();
+	if(ipecc_dev->shadow.pt_slots > IPECC_PT_SLOTS_MAX){
+		ipecc_dev->shadow.pt_slots = IPECC_PT_SLOTS_MAX;
+	}
+	/* The last slot is kept by the driver to stage points (it is not
+	 * given as a handle, see hw_driver_pt_nb_handles()) */
+	ipecc_dev->stage_slot = 0;
+	if(ipecc_dev->shadow.pt_slots >= 2){
+		ipecc_dev->shadow.pt_slots--;
+		ipecc_dev->stage_slot = ipecc_dev->shadow.pt_slots;
+	}
+	ipecc_dev->shadow.jobq_nb = (uint32_t)IPECC_GET_JOBQ_NB();
+	if(ipecc_dev->shadow.jobq_nb > IPECC_JOBQ_MAX){
+		ipecc_dev->shadow.jobq_nb = IPECC_JOBQ_MAX;
+	}
+	ipecc_dev->shadow.version_major = (uint32_t)IPECC_GET_MAJOR_VERSION();
+	ipecc_dev->shadow.version_minor = (uint32_t)IPECC_GET_MINOR_VERSION();
+	ipecc_dev->shadow.version_patch = (uint32_t)IPECC_GET_PATCH_VERSION();
+	/* The value of 'nn' will be read on first use */
+	ipecc_dev->shadow.nn_valid = 0;
+
+	return;
+}
+
+/* Forget the shadow value of 'nn' (e.g after a reset of the IP) */
+static inline void ip_ecc_shadow_invalidate_nn(void)
+{
+	ipecc_dev->shadow.nn_valid = 0;
+
+	return;
+}
+
+/* Forget which curve is resident in the IP (upon reset or change of 'nn'),
+ * along with its base point (which the IP itself forgets when 'p' is written).
+ */
+static inline void ip_ecc_curve_invalidate_resident(void)
+{
+	ipecc_dev->resident_curve.valid = 0;
+	ipecc_dev->fq_loaded = 0;
+	ipecc_dev->base_point_valid = 0;
+	ipecc_dev->base_point_in_ip = 0;
+	/* (as well as any chain of point operations) */
+	ipecc_dev->proj.state = IPECC_PROJ_NONE;
+	/* (and the point slots, which the IP also forgets along with 'p') */
+	memset(ipecc_dev->pt_slot_valid, 0, sizeof(ipecc_dev->pt_slot_valid));
+
+	return;
+}
+
 /* Helper function to compute the size, in nb of words, of a big number, given its size in bytes.
  */
 static inline uint32_t ip_ecc_nn_words_from_bytes_sz(uint32_t sz)
@@ -1798,10 +2597,29 @@ static inline int ip_ecc_check_error(ip_ecc_error *out)
 	return ret;
 }
 
+/* Wait until the IP is ready for the next step of a large number transfer.
+ *
+ * While a point is staged during a [k]P computation (see ip_ecc_stage_begin())
+ * or the job queue is filled (see ip_ecc_jobq_submit()) the BUSY bit stays
+ * asserted until the end of the computation(s): only the transfer itself is
+ * then waited for.
+ */
+static inline void ip_ecc_xfer_wait(void)
+{
+	if(ipecc_dev->staging || ipecc_dev->jobq){
+		IPECC_R_W_WAIT();
+	}
+	else{
+		IPECC_BUSY_WAIT();
+	}
+
+	return;
+}
+
 /* Select a register for R/W */
 static inline int ip_ecc_select_reg(ip_ecc_register r, ip_ecc_register_mode rw)
 {
-	uint32_t addr = 0, scal = 0, token = 0;
+	uint32_t addr = 0, scal = 0, token = 0, bp = 0;
 
 	switch(r){
 		case EC_HW_REG_A:{
@@ -1846,21 +2664,39 @@ static inline int ip_ecc_select_reg(ip_ecc_register r, ip_ecc_register_mode rw)
 			token = 1;
 			break;
 		}
+		case EC_HW_REG_BP_X:{
+			addr = IPECC_BNUM_R1_X;
+			bp = 1;
+			break;
+		}
+		case EC_HW_REG_BP_Y:{
+			addr = IPECC_BNUM_R1_Y;
+			bp = 1;
+			break;
+		}
 		default:{
 			goto err;
 		}
 	}
 
 	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
+	ip_ecc_xfer_wait();
+	/* (the previous transfer to/from the job queue must also be over) */
+	if(ipecc_dev->jobq){
+		IPECC_JOBQ_FILL_WAIT();
+	}
 
 	switch(rw){
 		case EC_HW_REG_READ:{
+			if(bp){
+				/* The stored base point can't be read back */
+				goto err;
+			}
 			IPECC_SET_READ_ADDR(addr, token);
 			break;
 		}
 		case EC_HW_REG_WRITE:{
-			IPECC_SET_WRITE_ADDR(addr, scal);
+			IPECC_SET_WRITE_ADDR(addr, scal, bp);
 			break;
 		}
 		default:{
@@ -1869,7 +2705,7 @@ static inline int ip_ecc_select_reg(ip_ecc_register r, ip_ecc_register_mode rw)
 	}
 
 	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
+	ip_ecc_xfer_wait();
 
 	/* Check for error */
 	if(ip_ecc_check_error(NULL)){
@@ -1888,12 +2724,12 @@ static inline int ip_ecc_push_word(const ip_ecc_word *w)
 		goto err;
 	}
 	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
+	ip_ecc_xfer_wait();
 
 	IPECC_WRITE_DATA((*w));
 
 	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
+	ip_ecc_xfer_wait();
 
 	/* Check for error */
 	if(ip_ecc_check_error(NULL)){
@@ -1912,12 +2748,54 @@ static inline int ip_ecc_pop_word(ip_ecc_word *w)
 		goto err;
 	}
 	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
+	ip_ecc_xfer_wait();
 
 	(*w) = IPECC_READ_DATA();
 
 	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
+	ip_ecc_xfer_wait();
+
+	/* Check for error */
+	if(ip_ecc_check_error(NULL)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Push a word to a given register, in streaming mode.
+ *
+ * Contrary to ip_ecc_push_word() neither R_STATUS polling nor error
+ * checking is done here: the IP holds the AXI write until it is able
+ * to absorb the word. Errors must be checked once for all the words
+ * of the large number, with ip_ecc_end_of_stream().
+ */
+static inline void ip_ecc_push_word_stream(ip_ecc_word w)
+{
+	IPECC_WRITE_DATA(w);
+
+	return;
+}
+
+/* Pop a word from a given register, in streaming mode.
+ *
+ * (Same remarks as for ip_ecc_push_word_stream() above, the IP holds
+ * the AXI read until the word is available).
+ */
+static inline void ip_ecc_pop_word_stream(ip_ecc_word *w)
+{
+	(*w) = IPECC_READ_DATA();
+
+	return;
+}
+
+/* End of the transfer of a large number in streaming mode */
+static inline int ip_ecc_end_of_stream(void)
+{
+	/* Wait until the IP is not busy */
+	ip_ecc_xfer_wait();
 
 	/* Check for error */
 	if(ip_ecc_check_error(NULL)){
@@ -1933,7 +2811,7 @@ err:
 static inline int ip_ecc_set_nn_bit_size(uint32_t bit_sz)
 {
 	/* Get the maximum NN size and check the asked size */
-	if(bit_sz > IPECC_GET_NN_MAX()){
+	if(bit_sz > ipecc_dev->shadow.nn_max){
 		/* If we overflow, this is an error */
 		goto err;
 	}
@@ -1944,7 +2822,11 @@ static inline int ip_ecc_set_nn_bit_size(uint32_t bit_sz)
 	/* NOTE: when NN dynamic is not supported we leave
 	 * our inherent maximum size.
 	 */
-	if(IPECC_IS_DYNAMIC_NN_SUPPORTED()){
+	if(ipecc_dev->shadow.nn_dynamic){
+		/* The shadow value of 'nn' is no longer valid, and neither
+		 * are the curve parameters resident in the IP */
+		ip_ecc_shadow_invalidate_nn();
+		ip_ecc_curve_invalidate_resident();
 		/* Set the current dynamic value */
 		IPECC_SET_NN_SIZE(bit_sz);
 		/* Wait until the IP is not busy */
@@ -1954,6 +2836,9 @@ static inline int ip_ecc_set_nn_bit_size(uint32_t bit_sz)
 		if(ip_ecc_check_error(NULL)){
 			goto err;
 		}
+		/* Keep track of the new value */
+		ipecc_dev->shadow.nn = bit_sz;
+		ipecc_dev->shadow.nn_valid = 1;
 	}
 
 	return 0;
@@ -1965,17 +2850,17 @@ err:
 static inline uint32_t ip_ecc_get_nn_bit_size(void)
 {
 	/* Size is in bits */
-	if(IPECC_IS_DYNAMIC_NN_SUPPORTED()){
-		return (uint32_t)IPECC_GET_NN();
+	if(ipecc_dev->shadow.nn_dynamic){
+		if(!ipecc_dev->shadow.nn_valid){
+			/* Read the value from the IP only if we lost track of it */
+			ipecc_dev->shadow.nn = (uint32_t)IPECC_GET_NN();
+			ipecc_dev->shadow.nn_valid = 1;
+		}
+		return ipecc_dev->shadow.nn;
 	}
 	else{
-		return (uint32_t)IPECC_GET_NN_MAX();
+		return ipecc_dev->shadow.nn_max;
 	}
-	/*
-	 * Note: a sole use of IPECC_GET_NN() could also work as this
-	 * macro also returns the NN_MAX size when the 'dynamic nn' feature is
-	 * not supported.
-	 */
 }
 
 /* Set the blinding size for scalar multiplication.
@@ -2041,7 +2926,7 @@ static inline int ip_ecc_enable_shuffling(void)
 	IPECC_BUSY_WAIT();
 
 	/* Enable shuffling but only if it's supported (otherwise reaise an error) */
-	if(IPECC_IS_SHUFFLING_SUPPORTED()){
+	if(ipecc_dev->shadow.shuffling){
 		IPECC_ENABLE_SHUFFLE();
 
 		/* Wait until the IP is not busy */
@@ -2227,35 +3112,85 @@ static inline int ip_ecc_enable_aximsk(void)
 	return 0;
 }
 
-/* Write a big number to the IP
+/* Transfer large numbers in streaming mode, i.e writing (resp. reading)
+ * all their limbs back-to-back, and checking R_STATUS once per number
+ * instead of once per limb.
  *
- *   The input big number is in big-endian format, and it is sent to the IP in the
- *   endianness it expects, meaning: the numbers are little-endian in words (of 32
- *   or 64 bits) and big-endian for the bytes inside words as well as for the bits
- *   inside bytes.
+ * This is the default when the IP supports it (otherwise an error is
+ * raised).
  */
-static inline int ip_ecc_write_bignum(const uint8_t *a, uint32_t a_sz, ip_ecc_register reg)
+static inline int ip_ecc_enable_streaming(void)
 {
-	uint32_t nn_size, curr_word_sz, words_sent, bytes_idx, j;
-	uint8_t end;
+	if(!ipecc_dev->shadow.streaming){
+		log_print("ip_ecc_enable_streaming(): could not enable streaming - "
+				"(feature's not present in hardware)\n\r");
+		goto err;
+	}
+	ipecc_dev->streaming = 1;
 
-	ip_ecc_word w;
+	return 0;
+err:
+	return -1;
+}
 
-	if(a == NULL){
-		/* Nothing to write */
-		return 0;
+/* Go back to the transfer of large numbers limb by limb, polling R_STATUS
+ * and checking for errors after each of them.
+ */
+static inline int ip_ecc_disable_streaming(void)
+{
+	ipecc_dev->streaming = 0;
+
+	return 0;
+}
+
+/* Push one word of a large number to the IP (streaming or not) */
+static inline int ip_ecc_push_limb(ip_ecc_word w)
+{
+	if(ipecc_dev->streaming){
+		ip_ecc_push_word_stream(w);
+	}
+	else if(ip_ecc_push_word(&w)){
+		goto err;
 	}
 
-	/* Get the current nb of words we need to send to the IP */
-	nn_size = ip_ecc_nn_words_from_bytes_sz(ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size()));
-	/* Compute our current word size */
-	curr_word_sz = ip_ecc_nn_words_from_bytes_sz(a_sz);
+	return 0;
+err:
+	return -1;
+}
 
-	if(curr_word_sz > nn_size){
-		/* We overflow, this is an error! */
+/* Pop one word of a large number from the IP (streaming or not) */
+static inline int ip_ecc_pop_limb(ip_ecc_word *w)
+{
+	if(ipecc_dev->streaming){
+		ip_ecc_pop_word_stream(w);
+	}
+	else if(ip_ecc_pop_word(w)){
 		goto err;
 	}
 
+	return 0;
+err:
+	return -1;
+}
+
+/* End of the transfer of a large number (streaming or not) */
+static inline int ip_ecc_end_of_transfer(void)
+{
+	/* In streaming mode, errors are checked once for the whole number */
+	if(ipecc_dev->streaming){
+		if(ip_ecc_end_of_stream()){
+			goto err;
+		}
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Prepare the IP for the write of a large number into register 'reg' */
+static inline int ip_ecc_begin_write(ip_ecc_register reg)
+{
 	/* If the number to write to the IP is the scalar, we must first check
 	 * that bit 'R_STATUS_ENOUGH_RND_WK' is actually asserted in 'R_STATUS'
 	 * register, as this means the IP has gathered enough random to mask
@@ -2275,8 +3210,47 @@ static inline int ip_ecc_write_bignum(const uint8_t *a, uint32_t a_sz, ip_ecc_re
 		goto err;
 	}
 
-	/* Send our words beginning with the last */
-	words_sent = 0;
+	return 0;
+err:
+	return -1;
+}
+
+/* Write a big number to the IP
+ *
+ *   The input big number is in big-endian format, and it is sent to the IP in the
+ *   endianness it expects, meaning: the numbers are little-endian in words (of 32
+ *   or 64 bits) and big-endian for the bytes inside words as well as for the bits
+ *   inside bytes.
+ */
+static inline int ip_ecc_write_bignum(const uint8_t *a, uint32_t a_sz, ip_ecc_register reg)
+{
+	uint32_t nn_size, curr_word_sz, words_sent, bytes_idx, j;
+	uint8_t end;
+
+	ip_ecc_word w;
+
+	if(a == NULL){
+		/* Nothing to write */
+		return 0;
+	}
+
+	/* Get the current nb of words we need to send to the IP */
+	nn_size = ip_ecc_nn_words_from_bytes_sz(ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size()));
+	/* Compute our current word size */
+	curr_word_sz = ip_ecc_nn_words_from_bytes_sz(a_sz);
+
+	if(curr_word_sz > nn_size){
+		/* We overflow, this is an error! */
+		goto err;
+	}
+
+	/* Select the register to write */
+	if(ip_ecc_begin_write(reg)){
+		goto err;
+	}
+
+	/* Send our words beginning with the last */
+	words_sent = 0;
 	bytes_idx = ((a_sz >= 1) ? (a_sz - 1) : 0);
 	end = ((a_sz >= 1) ? 0 : 1);
 	while(words_sent < nn_size){
@@ -2294,12 +3268,16 @@ static inline int ip_ecc_write_bignum(const uint8_t *a, uint32_t a_sz, ip_ecc_re
 			}
 		}
 		/* Push it to the IP */
-		if(ip_ecc_push_word(&w)){
+		if(ip_ecc_push_limb(w)){
 			goto err;
 		}
 		words_sent++;
 	}
 
+	if(ip_ecc_end_of_transfer()){
+		goto err;
+	}
+
 	return 0;
 err:
 	return -1;
@@ -2345,7 +3323,7 @@ static inline int ip_ecc_read_bignum(uint8_t *a, uint32_t a_sz, ip_ecc_register
 	end = ((a_sz >= 1) ? 0 : 1);
 	while(words_received < nn_size){
 		/* Pop the word from the IP */
-		if(ip_ecc_pop_word(&w)){
+		if(ip_ecc_pop_limb(&w)){
 			goto err;
 		}
 		if(!end){
@@ -2362,6 +3340,219 @@ static inline int ip_ecc_read_bignum(uint8_t *a, uint32_t a_sz, ip_ecc_register
 		words_received++;
 	}
 
+	if(ip_ecc_end_of_transfer()){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/*
+ * Large numbers pre-converted to the format of the IP
+ *
+ * These are arrays of words, the least significant one first, each word
+ * holding its bytes in the order the IP expects (see ip_ecc_write_bignum()).
+ * Converting a large number once in this format allows to decouple its
+ * conversion from its transfer to (or from) the IP.
+ *
+ * (This is also the format of the public type ipecc_bignum_t).
+ */
+typedef ipecc_limb_t ip_ecc_limb;
+
+/* Max nb of words of a pre-converted large number */
+#define IPECC_LIMBS_MAX_NB	DIV(IPECC_CURVE_MAX_SZ, sizeof(ip_ecc_limb))
+
+#if (IPECC_BIGNUM_MAX_SZ != IPECC_CURVE_MAX_SZ)
+#error "IPECC_BIGNUM_MAX_SZ and IPECC_CURVE_MAX_SZ must be equal"
+#endif
+
+/* Byte swap of a whole word, to convert it from (resp. to) big-endian
+ * when the CPU is little-endian. Without the help of the compiler, words
+ * are assembled byte by byte.
+ */
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#if defined(WITH_EC_HW_ACCELERATOR_WORD64)
+#define IPECC_LIMB_FROM_BE(l)	__builtin_bswap64(l)
+#else
+#define IPECC_LIMB_FROM_BE(l)	__builtin_bswap32(l)
+#endif
+#elif defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define IPECC_LIMB_FROM_BE(l)	(l)
+#endif
+
+/* Load the word stored in big-endian at address 'a' */
+static inline ip_ecc_limb ip_ecc_limb_load_be(const uint8_t *a)
+{
+	ip_ecc_limb l;
+#if defined(IPECC_LIMB_FROM_BE)
+	memcpy(&l, a, sizeof(l));
+	l = IPECC_LIMB_FROM_BE(l);
+#else
+	uint32_t j;
+
+	l = 0;
+	for(j = 0; j < sizeof(l); j++){
+		l = (l << 8) | a[j];
+	}
+#endif
+	return l;
+}
+
+/* Store word 'l' in big-endian at address 'a' */
+static inline void ip_ecc_limb_store_be(uint8_t *a, ip_ecc_limb l)
+{
+#if defined(IPECC_LIMB_FROM_BE)
+	l = IPECC_LIMB_FROM_BE(l);
+	memcpy(a, &l, sizeof(l));
+#else
+	uint32_t j;
+
+	for(j = 0; j < sizeof(l); j++){
+		a[sizeof(l) - 1 - j] = (l >> (8 * j)) & 0xff;
+	}
+#endif
+	return;
+}
+
+/* Current nb of words of a large number in the IP */
+static inline uint32_t ip_ecc_nn_limbs_nb(void)
+{
+	return ip_ecc_nn_words_from_bytes_sz(ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size()));
+}
+
+/* Convert big-endian big number 'a' into the 'nb' words of 'l' */
+static inline int ip_ecc_bignum_to_limbs(const uint8_t *a, uint32_t a_sz, ip_ecc_limb *l, uint32_t nb)
+{
+	uint32_t i, j, full, rem;
+
+	if((a == NULL) || (ip_ecc_nn_words_from_bytes_sz(a_sz) > nb) || (nb > IPECC_LIMBS_MAX_NB)){
+		goto err;
+	}
+
+	/* Whole words, beginning with the last bytes */
+	full = a_sz / sizeof(ip_ecc_limb);
+	rem = a_sz % sizeof(ip_ecc_limb);
+	for(i = 0; i < full; i++){
+		l[i] = ip_ecc_limb_load_be(a + a_sz - ((i + 1) * sizeof(ip_ecc_limb)));
+	}
+	/* Possible incomplete most significant word */
+	if(rem){
+		l[i] = 0;
+		for(j = 0; j < rem; j++){
+			l[i] = (l[i] << 8) | a[j];
+		}
+		i++;
+	}
+	for(; i < nb; i++){
+		l[i] = 0;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Convert the 'nb' words of 'l' into big-endian big number 'a' */
+static inline int ip_ecc_limbs_to_bignum(const ip_ecc_limb *l, uint32_t nb, uint8_t *a, uint32_t a_sz)
+{
+	uint32_t i, j, full, rem;
+
+	if((a == NULL) || (ip_ecc_nn_words_from_bytes_sz(a_sz) > nb)){
+		goto err;
+	}
+
+	/* Whole words, beginning with the last bytes */
+	full = a_sz / sizeof(ip_ecc_limb);
+	rem = a_sz % sizeof(ip_ecc_limb);
+	for(i = 0; i < full; i++){
+		ip_ecc_limb_store_be(a + a_sz - ((i + 1) * sizeof(ip_ecc_limb)), l[i]);
+	}
+	/* Possible incomplete most significant word */
+	for(j = 0; j < rem; j++){
+		a[rem - 1 - j] = (l[i] >> (8 * j)) & 0xff;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Write the 'nb' pre-converted words of a large number to the IP
+ * (padding it with null words up to the current size of large numbers) */
+static inline int ip_ecc_write_limbs(const ip_ecc_limb *l, uint32_t nb, ip_ecc_register reg)
+{
+	uint32_t i, nn_nb;
+
+	nn_nb = ip_ecc_nn_limbs_nb();
+	if(nb > nn_nb){
+		goto err;
+	}
+
+	/* Select the register to write */
+	if(ip_ecc_begin_write(reg)){
+		goto err;
+	}
+
+	for(i = 0; i < nb; i++){
+		if(ip_ecc_push_limb((ip_ecc_word)l[i])){
+			goto err;
+		}
+	}
+	for(; i < nn_nb; i++){
+		if(ip_ecc_push_limb(0)){
+			goto err;
+		}
+	}
+
+	if(ip_ecc_end_of_transfer()){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Write a pre-converted large number to the IP */
+static inline int ip_ecc_write_bn(const ipecc_bignum_t *bn, ip_ecc_register reg)
+{
+	if((bn == NULL) || (bn->nb > IPECC_LIMBS_MAX_NB)){
+		goto err;
+	}
+
+	return ip_ecc_write_limbs(bn->w, bn->nb, reg);
+err:
+	return -1;
+}
+
+/* Read the 'nb' words of a large number from the IP, without converting them */
+static inline int ip_ecc_read_limbs(ip_ecc_limb *l, uint32_t nb, ip_ecc_register reg)
+{
+	uint32_t i;
+	ip_ecc_word w;
+
+	if(nb != ip_ecc_nn_limbs_nb()){
+		goto err;
+	}
+
+	/* Select the read mode for the current register */
+	if(ip_ecc_select_reg(reg, EC_HW_REG_READ)){
+		goto err;
+	}
+
+	for(i = 0; i < nb; i++){
+		if(ip_ecc_pop_limb(&w)){
+			goto err;
+		}
+		l[i] = (ip_ecc_limb)w;
+	}
+
+	if(ip_ecc_end_of_transfer()){
+		goto err;
+	}
+
 	return 0;
 err:
 	return -1;
@@ -2814,7 +4005,7 @@ uint32_t ip_debug_read_one_limb(uint32_t lgnb, uint32_t limb)
 {
 	uint32_t w, n;
 
-	w = DIV(IPECC_GET_NN_MAX() + 4, IPECC_GET_WW());
+	w = DIV(ipecc_dev->shadow.nn_max + 4, IPECC_GET_WW());
 
 	/* Ignore possible error return case for ge_pow_of_2 here. */
 	ge_pow_of_2(w, &n);
@@ -3214,6 +4405,42 @@ err:
 }
 #endif /* KP_TRACE */
 
+#if defined(WITH_EC_HW_UIO) || defined(WITH_EC_HW_REGMODEL)
+/* Sleep on the interrupt of the IP until it is not busy anymore.
+ *
+ * Once enabled (by writing W_IRQ), the IP raises its interrupt at the end
+ * of any operation ([k]P, other point operations, Montgomery constants),
+ * including the short ones the driver does not sleep on. So an interrupt
+ * may already be counted by UIO when we get here, in which case the read
+ * returns immediately: this is why we loop until the BUSY bit is actually
+ * found deasserted.
+ *
+ * An interrupt raised between the test of the BUSY bit and the re-arming
+ * of the line is not lost, as the line is only masked (not disabled) and
+ * the interrupt is replayed when re-enabling it.
+ */
+static inline int ip_ecc_irq_wait(void)
+{
+	while (IPECC_IS_BUSY()) {
+		/* (Re-)enable the interrupt line in UIO */
+		if (hw_driver_irq_arm(ipecc_dev_idx)) {
+			goto err;
+		}
+		if (!IPECC_IS_BUSY()) {
+			break;
+		}
+		/* Sleep until the IP raises its interrupt */
+		if (hw_driver_irq_wait(ipecc_dev_idx)) {
+			goto err;
+		}
+	}
+
+	return 0;
+err:
+	return -1;
+}
+#endif
+
 /*
  * Commands execution (point operation)
  *
@@ -3222,7 +4449,19 @@ err:
  * by the hardware). When in debug mode setting 'blocking' to 0 allowsa to
  * debug monitor the operation, using e.g breakpoints.
  */
-static inline int ip_ecc_exec_command(ip_ecc_command cmd, int *flag, kp_trace_info_t* ktrc)
+/* Form of the operands of the field arithmetic commands: the Montgomery
+ * form, if software asked for it, only concerns operations modulo 'p'
+ * (operations modulo 'q' are always in normal form).
+ */
+static inline int ip_ecc_fp_mty(void)
+{
+	return ipecc_dev->fp_mty && !ipecc_dev->fq_loaded;
+}
+
+/* Start the execution of a command (without waiting for its completion,
+ * see ip_ecc_end_command() below).
+ */
+static inline int ip_ecc_start_command(ip_ecc_command cmd, kp_trace_info_t* ktrc)
 {
 	/* Wait until the IP is not busy */
 	IPECC_BUSY_WAIT();
@@ -3275,11 +4514,109 @@ static inline int ip_ecc_exec_command(ip_ecc_command cmd, int *flag, kp_trace_in
 			IPECC_EXEC_PT_NEG();
 			break;
 		}
+		case PT_KG:{
+			/* (No debug trace for [k]G) */
+			IPECC_EXEC_PT_KG();
+			break;
+		}
+		case PT_ADD_PROJ:{
+			IPECC_EXEC_PT_ADD_PROJ();
+			break;
+		}
+		case PT_DBL_PROJ:{
+			IPECC_EXEC_PT_DBL_PROJ();
+			break;
+		}
+		case PT_NORM:{
+			IPECC_EXEC_PT_NORM();
+			break;
+		}
+		case FP_ADD:{
+			IPECC_EXEC_FP_OP(IPECC_FP_OPID_ADD, ip_ecc_fp_mty());
+			break;
+		}
+		case FP_SUB:{
+			IPECC_EXEC_FP_OP(IPECC_FP_OPID_SUB, ip_ecc_fp_mty());
+			break;
+		}
+		case FP_MUL:{
+			IPECC_EXEC_FP_OP(IPECC_FP_OPID_MUL, ip_ecc_fp_mty());
+			break;
+		}
+		case FP_INV:{
+			IPECC_EXEC_FP_OP(IPECC_FP_OPID_INV, ip_ecc_fp_mty());
+			break;
+		}
+		case FP_SQR:{
+			IPECC_EXEC_FP_OP(IPECC_FP_OPID_SQR, ip_ecc_fp_mty());
+			break;
+		}
+		case FP_EXP:{
+			IPECC_EXEC_FP_OP(IPECC_FP_OPID_EXP, ip_ecc_fp_mty());
+			break;
+		}
+		case FP_MTY:{
+			IPECC_EXEC_FP_OP(IPECC_FP_OPID_MTY, 0);
+			break;
+		}
+		case FP_NOMTY:{
+			IPECC_EXEC_FP_OP(IPECC_FP_OPID_NOMTY, 0);
+			break;
+		}
+		case PT_DECOMPRESS:{
+			IPECC_EXEC_PT_DEC(0);
+			break;
+		}
+		case PT_DECOMPRESS_ODD:{
+			IPECC_EXEC_PT_DEC(1);
+			break;
+		}
+		case PT_KP2_LOAD:{
+			IPECC_EXEC_KP2_LOAD();
+			break;
+		}
+		case PT_KP2_P1:{
+			IPECC_EXEC_KP2_RUN(1, 0);
+			break;
+		}
+		case PT_KP2_P2:{
+			IPECC_EXEC_KP2_RUN(0, 1);
+			break;
+		}
+		case PT_KP2_P12:{
+			IPECC_EXEC_KP2_RUN(1, 1);
+			break;
+		}
 		default:{
 			goto err;
 		}
 	}
 
+	return 0;
+err:
+	return -1;
+}
+
+/* Is the command started by ip_ecc_start_command() still being executed? */
+static inline int ip_ecc_command_pending(void)
+{
+	return IPECC_IS_BUSY();
+}
+
+/* Wait for the end of a command started by ip_ecc_start_command() */
+static inline int ip_ecc_end_command(ip_ecc_command cmd, int *flag)
+{
+#if defined(WITH_EC_HW_UIO) || defined(WITH_EC_HW_REGMODEL)
+	/* A [k]P computation lasts long enough to rather sleep on the
+	 * interrupt of the IP, if software asked so.
+	 */
+	if (((cmd == PT_KP) || (cmd == PT_KG)) && (ipecc_dev->completion == HW_DRIVER_COMPLETION_IRQ)) {
+		if (ip_ecc_irq_wait()) {
+			goto err;
+		}
+	}
+#endif
+
 	/* Wait until the IP is not busy */
 	IPECC_BUSY_WAIT();
 
@@ -3291,7 +4628,12 @@ static inline int ip_ecc_exec_command(ip_ecc_command cmd, int *flag, kp_trace_in
 	/* Get a flag if necessary */
 	if(flag != NULL){
 		switch(cmd){
-			case PT_CHK:{
+			case PT_CHK:
+			case PT_DECOMPRESS:
+			case PT_DECOMPRESS_ODD:
+			case PT_KP2_P1:
+			case PT_KP2_P2:
+			case PT_KP2_P12:{
 				(*flag) = IPECC_GET_ONCURVE();
 				break;
 			}
@@ -3314,37 +4656,28 @@ err:
 	return -1;
 }
 
-/* Is the IP in 'debug' or 'production' mode? */
-static inline int ip_ecc_is_debug(uint32_t* answer)
+static inline int ip_ecc_exec_command(ip_ecc_command cmd, int *flag, kp_trace_info_t* ktrc)
 {
-	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
-
-	/* Ask the IP register. */
-	*answer = IPECC_IS_DEBUG_OR_PROD();
-
-	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
+	if(ip_ecc_start_command(cmd, ktrc)){
+		goto err;
+	}
+	if(ip_ecc_end_command(cmd, flag)){
+		goto err;
+	}
 
 	return 0;
+err:
+	return -1;
 }
 
-/* Get the major version number of the IP */
-static inline int ip_ecc_get_version_tags(uint32_t* maj, uint32_t* min, uint32_t* ptc)
+/* Is the IP in 'debug' or 'production' mode? */
+static inline int ip_ecc_is_debug(uint32_t* answer)
 {
-	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
+	/* Register R_CAPABILITIES was read once and for all by driver_setup() */
+	*answer = ipecc_dev->shadow.debug;
 
-	/* Get all version numbers from IP register. */
-	*maj = IPECC_GET_MAJOR_VERSION();
-	*min = IPECC_GET_MINOR_VERSION();
-	*ptc = IPECC_GET_PATCH_VERSION();
-
-	/* Wait until the IP is not busy */
-	IPECC_BUSY_WAIT();
-
-	return 0;
-}
+	return 0;
+}
 
 /*
  * *** TRNG debug ***
@@ -3547,170 +4880,133 @@ err:
 }
 #endif
 
-static volatile uint8_t hw_driver_setup_state = 0;
+/*
+ * Curve handling
+ */
 
-static inline int driver_setup(void)
+/* Digest of one curve parameter (64-bit FNV-1a over its size & bytes) */
+static inline uint64_t ip_ecc_curve_digest_update(uint64_t h, const uint8_t *x, uint32_t x_sz)
 {
-	uint32_t debug;
-
-	if(!hw_driver_setup_state){
-		/* Ask the lower layer for a setup */
-		if(hw_driver_setup((volatile uint8_t**)&ipecc_baddr, NULL /*(volatile uint8_t**)&ipecc_pseudotrng_baddr)*/)) {
-			goto err;
-		}
-		/* Reset the IP for a clean state */
-		IPECC_SOFT_RESET();
-
-		/* Enable TRNG post-processing
-		 *
-		 * This is for the case where the IP is in DEBUG mode (not to be done otherwise
-		 * as an error UNKNOWN_REG would be issued).
-		 *
-		 * NOTE:
-		 *   We can make this call even before setting 'hw_driver_setup_state' to 1
-		 *   below, because neither ip_ecc_is_debug() nor ip_ecc_trng_postproc_enable()
-		 *   call driver_setup()
-		 *   (so no risk of recursive deadlock).
-		 */
-		ip_ecc_is_debug(&debug);
-		if (debug) {
-			ip_ecc_trng_postproc_enable();
-		}
-
-#if 0
-		/* Reset the pseudo TRNG device to empty its FIFO of pseudo raw random bytes */
-		IPECC_PSEUDOTRNG_SOFT_RESET();
-#endif
+	uint32_t i;
 
-		/* We are in the initialized state */
-		hw_driver_setup_state = 1;
+	for(i = 0; i < 4; i++){
+		h ^= (uint64_t)((x_sz >> (8 * i)) & 0xff);
+		h *= (uint64_t)0x100000001b3ULL;
+	}
+	for(i = 0; i < x_sz; i++){
+		h ^= (uint64_t)x[i];
+		h *= (uint64_t)0x100000001b3ULL;
 	}
 
-	return 0;
-err:
-	return -1;
+	return h;
 }
 
-/*********************************************
- **  Driver API (top-layer exported functions)
- *********************************************/
-
-/* Reset the hardware */
-int hw_driver_reset(void)
+/* Compute the digest of the parameters of a curve */
+static inline uint64_t ip_ecc_curve_digest(const ip_ecc_curve *c)
 {
-	/* Reset the IP for a clean state */
-        IPECC_SOFT_RESET();
+	uint64_t h = (uint64_t)0xcbf29ce484222325ULL;
 
-	return 0;
-}
+	h = ip_ecc_curve_digest_update(h, c->a, c->a_sz);
+	h = ip_ecc_curve_digest_update(h, c->b, c->b_sz);
+	h = ip_ecc_curve_digest_update(h, c->p, c->p_sz);
+	h = ip_ecc_curve_digest_update(h, c->q, c->q_sz);
 
-/* To know if the IP is in 'debug' or 'production' mode */
-int hw_driver_is_debug(uint32_t* answer)
-{
-	if(driver_setup()){
-		goto err;
-	}
-	if (ip_ecc_is_debug(answer)){
-		goto err;
-	}
-	return 0;
-err:
-	return -1;
+	return h;
 }
 
-/* Get major version of the IP */
-int hw_driver_get_version_tags(uint32_t* maj, uint32_t* min, uint32_t* patch)
+/* Fill a curve structure with a copy of the parameters a, b, p and q */
+static inline int ip_ecc_curve_fill(ip_ecc_curve *c, const uint8_t *a, uint32_t a_sz,
+		const uint8_t *b, uint32_t b_sz, const uint8_t *p, uint32_t p_sz,
+		const uint8_t *q, uint32_t q_sz)
 {
-	if(driver_setup()){
+	if((a == NULL) || (b == NULL) || (p == NULL) || (q == NULL)){
 		goto err;
 	}
-	if (ip_ecc_get_version_tags(maj, min, patch)){
+	if((a_sz > IPECC_CURVE_MAX_SZ) || (b_sz > IPECC_CURVE_MAX_SZ)
+			|| (p_sz > IPECC_CURVE_MAX_SZ) || (q_sz > IPECC_CURVE_MAX_SZ)){
 		goto err;
 	}
-	return 0;
-err:
-	return -1;
-}
+	memcpy(c->a, a, a_sz);
+	c->a_sz = a_sz;
+	memcpy(c->b, b, b_sz);
+	c->b_sz = b_sz;
+	memcpy(c->p, p, p_sz);
+	c->p_sz = p_sz;
+	memcpy(c->q, q, q_sz);
+	c->q_sz = q_sz;
+	c->digest = ip_ecc_curve_digest(c);
+	c->valid = 1;
 
-/* Enable TRNG post-processing logic */
-int hw_driver_trng_post_proc_enable()
-{
-	if(driver_setup()){
-		goto err;
-	}
-	if (ip_ecc_trng_postproc_enable()){
-		goto err;
-	}
 	return 0;
 err:
 	return -1;
 }
 
-/* Disable TRNG post-processing logic */
-int hw_driver_trng_post_proc_disable()
+/* Are two (valid) curve structures holding the same parameters? */
+static inline int ip_ecc_curve_equal(const ip_ecc_curve *c1, const ip_ecc_curve *c2)
 {
-	if(driver_setup()){
-		goto err;
+	if((!c1->valid) || (!c2->valid) || (c1->digest != c2->digest)){
+		return 0;
 	}
-	if (ip_ecc_trng_postproc_disable()){
-		goto err;
+	if((c1->a_sz != c2->a_sz) || (c1->b_sz != c2->b_sz)
+			|| (c1->p_sz != c2->p_sz) || (c1->q_sz != c2->q_sz)){
+		return 0;
 	}
-	return 0;
-err:
-	return -1;
-}
 
-/* Complete bypass the TRNG function (both entropy source,
- * post-processing, and server) */
-int hw_driver_bypass_full_trng_DBG(uint32_t instead_bit)
-{
-	if(driver_setup()){
-		goto err;
-	}
-	if (ip_ecc_bypass_full_trng(instead_bit)){
-		goto err;
-	}
-	return 0;
-err:
-	return -1;
+	return ((memcmp(c1->a, c2->a, c1->a_sz) == 0) && (memcmp(c1->b, c2->b, c1->b_sz) == 0)
+		&& (memcmp(c1->p, c2->p, c1->p_sz) == 0) && (memcmp(c1->q, c2->q, c1->q_sz) == 0));
 }
 
-/* Disable token feature */
-int hw_driver_disable_token_DBG()
+/* Shape of curve parameter 'a' (big numbers in big endian): returns
+ * IPECC_W_CURVE_A_ZERO if a = 0, IPECC_W_CURVE_A_M3 if a = p - 3
+ * and 0 otherwise.
+ */
+static inline uint32_t ip_ecc_curve_a_shape(const uint8_t *a, uint32_t a_sz,
+		const uint8_t *p, uint32_t p_sz)
 {
-	if(driver_setup()){
-		goto err;
-	}
-	if (ip_ecc_disable_token()){
-		goto err;
-	}
-	return 0;
-err:
-	return -1;
-}
+	uint32_t i, sz, carry, s;
+	uint8_t ai, pi;
 
-/* (Re-)enable token feature */
-int hw_driver_enable_token_DBG()
-{
-	if(driver_setup()){
-		goto err;
+	/* a = 0 ? */
+	for(i = 0; i < a_sz; i++){
+		if(a[i]){
+			break;
+		}
 	}
-	if (ip_ecc_enable_token()){
-		goto err;
+	if(i == a_sz){
+		return IPECC_W_CURVE_A_ZERO;
+	}
+	/* a + 3 = p ? (starting from the least significant bytes) */
+	sz = (a_sz > p_sz) ? a_sz : p_sz;
+	carry = 3;
+	for(i = 0; i < sz; i++){
+		ai = (i < a_sz) ? a[a_sz - 1 - i] : 0;
+		pi = (i < p_sz) ? p[p_sz - 1 - i] : 0;
+		s = (uint32_t)ai + carry;
+		if((s & 0xff) != pi){
+			return 0;
+		}
+		carry = s >> 8;
 	}
-	return 0;
-err:
-	return -1;
+	if(carry){
+		return 0;
+	}
+
+	return IPECC_W_CURVE_A_M3;
 }
 
-/* Patching microcode in the IP */
-int hw_driver_patch_microcode_DBG(uint32_t* buf, uint32_t nbops, uint32_t opsz)
+/* Tell the IP if curve parameter 'a' is 0 or -3, so that point
+ * doublings can use the cheaper formulas for these two shapes.
+ */
+static inline int ip_ecc_set_curve_a_shape(uint32_t shape)
 {
-	if(driver_setup()){
-		goto err;
-	}
-	
-	if (ip_ecc_patch_microcode(buf, nbops, opsz)) {
+	/* Wait until the IP is not busy */
+	IPECC_BUSY_WAIT();
+
+	IPECC_SET_CURVE_A_SHAPE(shape);
+
+	/* Check for error */
+	if(ip_ecc_check_error(NULL)){
 		goto err;
 	}
 
@@ -3719,33 +5015,15 @@ err:
 	return -1;
 }
 
-
-/* Set the curve parameters a, b, p and q.
- *
- * All size arguments (*_sz) must be given in bytes.
- *
- * Please read and take into consideration the 'NOTE:' mentionned
- * at the top of the prototype file <hw_accelerator_driver.h>
- * about the formatting and size of large numbers.
- *
- * Note: if software does not intend to later use the blinding
- * countermeasure, then the order 'q' of the curve is not mandatory
- * (using e.g an arbitrary number for argument 'q' and setting 'q_sz'
- * the same as 'p_sz').
- *
- * Note however that the IP could have been synthesized with an
- * active hardware-locked blinding countermeasure, which, if the IP
- * was further synthesized in production (secure) mode, won't be
- * disengageable by software. In this situation, since every scalar
- * multiplication will be run by the IP with active blinding, 'q'
- * and 'q_sz' arguments should be rigorously set.
- */
-int hw_driver_set_curve(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
-       		        const uint8_t *p, uint32_t p_sz, const uint8_t *q, uint32_t q_sz)
+/* Transmit the curve parameters a, b, p and q to the IP */
+static inline int ip_ecc_set_curve(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
+		const uint8_t *p, uint32_t p_sz, const uint8_t *q, uint32_t q_sz)
 {
-	if(driver_setup()){
-		goto err;
-	}
+	/* Whatever happens next, the parameters in the IP will no longer
+	 * be the ones of the resident curve.
+	 */
+	ip_ecc_curve_invalidate_resident();
+
 	/* We set the dynamic NN size value to be the max
 	 * of P and Q size
 	 */
@@ -3774,48 +5052,63 @@ int hw_driver_set_curve(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint3
 		goto err;
 	}
 
+	/* Declare a = 0 or a = -3 (this must come after 'p' and 'a' are
+	 * written, which clear the declaration in the IP)
+	 */
+	if(ipecc_dev->shadow.afast){
+		if(ip_ecc_set_curve_a_shape(ip_ecc_curve_a_shape(a, a_sz, p, p_sz))){
+			goto err;
+		}
+	}
+
 	return 0;
 err:
 	return -1;
 }
 
-/* Activate the blinding for scalar multiplication.
- *
- * Argument 'blinding_size' must be given in bits, and must be
- * strictly less than the value of 'nn' currently set in the
- * hardware (hance 'nn' - 1 is the largest authorized value).
- *
- * Otherwise error 'ERR_BLN' is raised in R_STATUS register.
+/* Make curve 'c' the one resident in the IP.
  *
- * A value of 0 for input argument 'blinding_size' is counter-
- * intuitive and will be held as meaning to disable the blinding
- * countermeasure (consider using instead  explicit function
- * hw_driver_disable_blinding()).
+ * This is a no-op if the same parameters are already resident.
  */
-int hw_driver_enable_blinding(uint32_t blinding_size)
+static inline int ip_ecc_curve_make_resident(const ip_ecc_curve *c)
 {
-	if(driver_setup()){
-		goto err;
+	if(ip_ecc_curve_equal(c, &ipecc_dev->resident_curve)){
+		/* Nothing to do */
+		return 0;
 	}
 
-	if(ip_ecc_enable_blinding_size(blinding_size)){
+	if(ip_ecc_set_curve(c->a, c->a_sz, c->b, c->b_sz, c->p, c->p_sz, c->q, c->q_sz)){
 		goto err;
 	}
 
+	/* Keep track of the new resident curve */
+	memcpy(&ipecc_dev->resident_curve, c, sizeof(ipecc_dev->resident_curve));
+
 	return 0;
 err:
 	return -1;
 }
 
-/* Disable the blinding for scalar multiplication.
+/* Get a copy of the curve of handle 'id' registered by software,
+ * checking its parameters against their digest (so that a corrupted
+ * copy can't be silently used).
  */
-int hw_driver_disable_blinding(void)
+static inline int ip_ecc_curve_get_registered(uint32_t id, ip_ecc_curve *c)
 {
-	if(driver_setup()){
+	if(id >= HW_DRIVER_MAX_CURVES){
 		goto err;
 	}
 
-	if(ip_ecc_disable_blinding()){
+	IPECC_CURVES_LOCK();
+	memcpy(c, &ipecc_curves[id], sizeof(ip_ecc_curve));
+	IPECC_CURVES_UNLOCK();
+
+	if(!c->valid){
+		goto err;
+	}
+	if(ip_ecc_curve_digest(c) != c->digest){
+		log_print("In ip_ecc_curve_get_registered(): parameters of curve %u "
+				"do not match their digest\n\r", id);
 		goto err;
 	}
 
@@ -3824,15 +5117,55 @@ err:
 	return -1;
 }
 
-/* Activate the shuffling for scalar multiplication */
-int hw_driver_enable_shuffling(void)
+/* Setup of the IP currently selected */
+static inline int driver_setup(void)
 {
-	if(driver_setup()){
-		goto err;
-	}
+	uint32_t debug;
 
-	if(ip_ecc_enable_shuffling()){
-		goto err;
+	if(!IPECC_LOAD_ACQUIRE(ipecc_dev->setup_state)){
+		/* Ask the lower layer for a setup */
+		if(hw_driver_setup_dev(ipecc_dev_idx, (volatile uint8_t**)&ipecc_dev->baddr,
+					NULL /*(volatile uint8_t**)&ipecc_pseudotrng_baddr)*/)) {
+			goto err;
+		}
+		ipecc_baddr = ipecc_dev->baddr;
+		/* Reset the IP for a clean state */
+		IPECC_SOFT_RESET();
+
+		/* Wait until the IP is not busy */
+		IPECC_BUSY_WAIT();
+
+		/* Snapshot the capabilities of the IP (they won't change) */
+		ip_ecc_shadow_capabilities();
+
+		/* Stream transfers of large numbers if the IP allows it */
+		if(ipecc_dev->shadow.streaming){
+			ip_ecc_enable_streaming();
+		}
+
+		/* Enable TRNG post-processing
+		 *
+		 * This is for the case where the IP is in DEBUG mode (not to be done otherwise
+		 * as an error UNKNOWN_REG would be issued).
+		 *
+		 * NOTE:
+		 *   We can make this call even before setting 'setup_state' to 1
+		 *   below, because neither ip_ecc_is_debug() nor ip_ecc_trng_postproc_enable()
+		 *   call driver_setup()
+		 *   (so no risk of recursive deadlock).
+		 */
+		ip_ecc_is_debug(&debug);
+		if (debug) {
+			ip_ecc_trng_postproc_enable();
+		}
+
+#if 0
+		/* Reset the pseudo TRNG device to empty its FIFO of pseudo raw random bytes */
+		IPECC_PSEUDOTRNG_SOFT_RESET();
+#endif
+
+		/* We are in the initialized state */
+		IPECC_STORE_RELEASE(ipecc_dev->setup_state, 1);
 	}
 
 	return 0;
@@ -3840,15 +5173,72 @@ err:
 	return -1;
 }
 
-/* Disable the shuffling for scalar multiplication */
-int hw_driver_disable_shuffling(void)
+/* The IP works with one modulus at a time (the one written as 'p', for
+ * which it computes the Montgomery constants by itself). Arithmetic modulo
+ * the order 'q' of the resident curve (see hw_driver_fq_mul()) is done by
+ * writing 'q' in place of 'p': it stays there for subsequent operations
+ * modulo 'q', and the curve is only set back by the next call to the
+ * driver which needs it (see driver_enter()).
+ *
+ * If the IP keeps the Montgomery constants of 'q' aside those of 'p'
+ * (see IPECC_IS_QCTX_SUPPORTED()), switching from one modulus to the
+ * other is a mere copy inside the IP (register W_MODULUS), 'q' only being
+ * written (and its constants computed) the first time, and the curve, its
+ * base point and the point slots all stay in the IP.
+ */
+static inline int ip_ecc_fq_load(void)
 {
-	if(driver_setup()){
+	if(!ipecc_dev->shadow.fop){
+		log_print("In ip_ecc_fq_load(): no field arithmetic in hardware\n\r");
 		goto err;
 	}
-
-	if(ip_ecc_disable_shuffling()){
-		goto err;
+	if(ipecc_dev->fq_loaded){
+		/* Nothing to do */
+		return 0;
+	}
+	/* We need to know the curve to set it back afterwards */
+	if(!ipecc_dev->resident_curve.valid){
+		log_print("In ip_ecc_fq_load(): curve unknown to the driver\n\r");
+		goto err;
+	}
+	if(!ipecc_dev->resident_curve.q_sz){
+		log_print("In ip_ecc_fq_load(): no order set for the curve\n\r");
+		goto err;
+	}
+
+	/* R1 is overwritten by the arithmetic modulo 'q' */
+	ipecc_dev->proj.state = IPECC_PROJ_NONE;
+
+	if(ipecc_dev->shadow.qctx){
+		IPECC_BUSY_WAIT();
+		IPECC_SET_MODULUS(1);
+		/* Wait until the constants of 'q' are copied back (if any) */
+		IPECC_BUSY_WAIT();
+		if(ip_ecc_check_error(NULL)){
+			goto err;
+		}
+		ipecc_dev->fq_loaded = 1;
+		if(!IPECC_IS_QCTX_VALID()){
+			/* First time: the IP computes the constants of 'q' and keeps them */
+			if(ip_ecc_write_bignum(ipecc_dev->resident_curve.q, ipecc_dev->resident_curve.q_sz,
+						EC_HW_REG_P)){
+				goto err;
+			}
+		}
+		return 0;
+	}
+
+	/* Along with 'p', the IP forgets its stored base point and its
+	 * point slots (the driver still has a copy of the base point).
+	 */
+	ipecc_dev->base_point_in_ip = 0;
+	memset(ipecc_dev->pt_slot_valid, 0, sizeof(ipecc_dev->pt_slot_valid));
+
+	/* (from now on the curve is no longer entirely in the IP) */
+	ipecc_dev->fq_loaded = 1;
+	if(ip_ecc_write_bignum(ipecc_dev->resident_curve.q, ipecc_dev->resident_curve.q_sz,
+				EC_HW_REG_P)){
+		goto err;
 	}
 
 	return 0;
@@ -3856,317 +5246,4291 @@ err:
 	return -1;
 }
 
-/* Activate and configure the periodic Z-remasking countermeasure
- * (the 'period' arguement is expressed in number of bits of the scalar */
-int hw_driver_enable_zremask(uint32_t period)
+/* Set back the resident curve (and its base point) if 'q' was
+ * written in place of 'p' by ip_ecc_fq_load().
+ *
+ * If the IP keeps the constants of both moduli, it is only asked to switch
+ * back to 'p' (the context of which it saved when the curve was written:
+ * any change of nn since then has also made the driver forget the curve).
+ *
+ * Otherwise only what the write of 'q' invalidated in the IP is
+ * transmitted again: 'p' (the IP then computes its Montgomery constants
+ * again, it has no room for those of a second modulus), 'a' (kept by the
+ * IP in Montgomery form) and the declaration of its shape, and the base
+ * point. Parameters 'b' and 'q' and the value of nn are left untouched by
+ * the arithmetic modulo 'q', hence they are not sent again.
+ */
+static inline int ip_ecc_fq_unload(void)
 {
-	if(driver_setup()){
-		goto err;
+	const ip_ecc_curve *c = &ipecc_dev->resident_curve;
+
+	if(!ipecc_dev->fq_loaded){
+		/* Nothing to do */
+		return 0;
 	}
 
-	if(ip_ecc_enable_zremask(period)){
+	if(ipecc_dev->shadow.qctx){
+		IPECC_BUSY_WAIT();
+		IPECC_SET_MODULUS(0);
+		/* Wait until the constants of 'p' are copied back */
+		IPECC_BUSY_WAIT();
+		if(ip_ecc_check_error(NULL)){
+			goto err;
+		}
+		ipecc_dev->fq_loaded = 0;
+		return 0;
+	}
+
+	if(ip_ecc_write_bignum(c->p, c->p_sz, EC_HW_REG_P)){
 		goto err;
 	}
+	if(ip_ecc_write_bignum(c->a, c->a_sz, EC_HW_REG_A)){
+		goto err;
+	}
+	/* (see ip_ecc_set_curve()) */
+	if(ipecc_dev->shadow.afast){
+		if(ip_ecc_set_curve_a_shape(ip_ecc_curve_a_shape(c->a, c->a_sz, c->p, c->p_sz))){
+			goto err;
+		}
+	}
+	ipecc_dev->fq_loaded = 0;
+
+	if(ipecc_dev->base_point_valid && ipecc_dev->shadow.base_point){
+		if(ip_ecc_write_bn(&ipecc_dev->base_point.x, EC_HW_REG_BP_X)){
+			goto err;
+		}
+		if(ip_ecc_write_bn(&ipecc_dev->base_point.y, EC_HW_REG_BP_Y)){
+			goto err;
+		}
+		ipecc_dev->base_point_in_ip = 1;
+	}
 
 	return 0;
 err:
+	/* The curve will be transmitted again as a whole */
+	ip_ecc_curve_invalidate_resident();
 	return -1;
 }
 
-/* Disable the periodic Z-remasking countermeasure for scalar multiplication */
-int hw_driver_disable_zremask(void)
+/* Beginning of a call to the driver API on the IP currently selected:
+ * take the lock of the IP (thread-safe mode) and set it up if needed.
+ *
+ * The lock is taken even if the setup fails, hence each call to
+ * driver_enter*() must be balanced by a call to driver_leave().
+ */
+static inline int driver_enter_raw(void)
 {
+	/* The IP selected and its base address are per thread in thread-safe
+	 * mode: a thread which never called hw_driver_select_device() works
+	 * on the first IP, whose base address may have been obtained by the
+	 * setup done in another thread.
+	 */
+	if(ipecc_dev == NULL){
+		ipecc_dev = &ipecc_devices[0];
+		ipecc_dev_idx = 0;
+	}
+	if(ip_ecc_lock(1)){
+		return -1;
+	}
 	if(driver_setup()){
-		goto err;
+		return -1;
 	}
+	ipecc_baddr = ipecc_dev->baddr;
 
-	if(ip_ecc_disable_zremask()){
+	return 0;
+}
+
+/* Forget the job in flight (clearing its token), and the one queued
+ * behind it if any */
+static inline void ip_ecc_kp_job_release(void)
+{
+	ip_ecc_clear_token(ipecc_dev->kp_job.token, ipecc_dev->kp_job.nn_sz);
+	ipecc_dev->kp_job.nn_sz = 0;
+	ipecc_dev->kp_job.pending = 0;
+	memset(ipecc_dev->kp_job.next.scalar, 0, sizeof(ipecc_dev->kp_job.next.scalar));
+	ipecc_dev->kp_job.next.scalar_sz = 0;
+	ipecc_dev->kp_job.next.pending = 0;
+#if defined(WITH_EC_HW_THREAD_SAFE)
+	pthread_cond_broadcast(&ipecc_dev->kp_idle);
+#endif
+
+	return;
+}
+
+/* While a scalar multiplication submitted with hw_driver_mul_submit() is
+ * in flight, the IP is computing on R0/R1 and on the curve registers, and
+ * its result is only read back from R1 when the job is collected: any call
+ * to the driver making the IP do something else would silently corrupt it.
+ * Such calls are rejected here once and for all (see driver_enter()), only
+ * the entry points operating on the job itself or leaving the IP untouched
+ * being let through (see driver_enter_job()).
+ */
+static inline int ip_ecc_check_no_kp_job(void)
+{
+	if(ipecc_dev->kp_job.pending){
+		log_print("Error: a scalar multiplication is in flight, collect it first\n\r");
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Same as driver_enter_raw(), also setting back the curve if 'q' was
+ * left in place of 'p' by a call to hw_driver_fq_*(), for the entry
+ * points which may be called while a scalar multiplication is in flight.
+ *
+ * (A job can't be in flight with 'q' in place of 'p', see driver_enter_fq())
+ */
+static inline int driver_enter_job(void)
+{
+	if(driver_enter_raw()){
+		return -1;
+	}
+
+	return ip_ecc_fq_unload();
+}
+
+/* Same as driver_enter_job(), rejecting the call if a scalar
+ * multiplication is in flight (see ip_ecc_check_no_kp_job())
+ */
+static inline int driver_enter(void)
+{
+	if(driver_enter_raw()){
+		return -1;
+	}
+	if(ip_ecc_check_no_kp_job()){
+		return -1;
+	}
+
+	return ip_ecc_fq_unload();
+}
+
+/* Same as driver_enter(), for arithmetic modulo 'q' */
+static inline int driver_enter_fq(void)
+{
+	if(driver_enter_raw()){
+		return -1;
+	}
+	if(ip_ecc_check_no_kp_job()){
+		return -1;
+	}
+
+	return ip_ecc_fq_load();
+}
+
+/* End of a call to the driver API */
+static inline void driver_leave(void)
+{
+	ip_ecc_unlock();
+
+	return;
+}
+
+/*********************************************
+ **  Driver API (top-layer exported functions)
+ *********************************************/
+
+/* Reset the hardware */
+int hw_driver_reset(void)
+{
+	/* (no need to set back the curve, the reset makes the IP forget it) */
+	if(driver_enter_raw()){
 		goto err;
 	}
 
+	/* Reset the IP for a clean state */
+        IPECC_SOFT_RESET();
+
+	/* The reset aborted the scalar multiplication in flight (if any) */
+	if(ipecc_dev->kp_job.pending){
+		ip_ecc_kp_job_release();
+	}
+
+	/* The reset brought 'nn' back to its default value */
+	ip_ecc_shadow_invalidate_nn();
+	ip_ecc_curve_invalidate_resident();
+
+	driver_leave();
 	return 0;
 err:
+	driver_leave();
 	return -1;
 }
 
-/* Debug feature: disable XY-shuffling  */
-int hw_driver_disable_xyshuf(void)
+/* Select how the driver waits for the end of scalar multiplications.
+ *
+ * In HW_DRIVER_COMPLETION_SPIN mode (the default) the driver polls the
+ * BUSY bit of the IP until the computation is done.
+ *
+ * In HW_DRIVER_COMPLETION_IRQ mode the driver enables the interrupt of
+ * the IP and the calling thread sleeps in the UIO device until the [k]P
+ * computation is done, leaving the CPU to other tasks in the meantime.
+ * Shorter operations (point additions, doublings, transfers of large
+ * numbers, etc) are still polled, as sleeping would only add latency
+ * to them.
+ *
+ * The interrupt mode is only available on Linux with the UIO driver
+ * (WITH_EC_HW_UIO), and requires the interrupt line of the IP to be
+ * declared in the device-tree node of the UIO device (the register
+ * model of the IP, WITH_EC_HW_REGMODEL, also emulates it for tests).
+ */
+int hw_driver_set_completion_mode(hw_driver_completion_mode mode)
 {
-	if(driver_setup()){
+	if(driver_enter()){
 		goto err;
 	}
 
-	if(ip_ecc_disable_xyshuf()){
-		goto err;
+	switch(mode){
+		case HW_DRIVER_COMPLETION_SPIN:{
+			/* Wait until the IP is not busy */
+			IPECC_BUSY_WAIT();
+			IPECC_DISABLE_IRQ();
+			break;
+		}
+		case HW_DRIVER_COMPLETION_IRQ:{
+#if defined(WITH_EC_HW_UIO) || defined(WITH_EC_HW_REGMODEL)
+			/* Wait until the IP is not busy */
+			IPECC_BUSY_WAIT();
+			IPECC_ENABLE_IRQ();
+			break;
+#else
+			log_print("hw_driver_set_completion_mode(): interrupt mode "
+					"is only supported with UIO\n\r");
+			goto err;
+#endif
+		}
+		default:{
+			goto err;
+		}
 	}
+	ipecc_dev->completion = mode;
 
+	driver_leave();
 	return 0;
 err:
+	driver_leave();
 	return -1;
 }
 
-/* Debug feature: re-enable XY-shuffling  */
-int hw_driver_enable_xyshuf(void)
+/* To know if the IP is in 'debug' or 'production' mode */
+int hw_driver_is_debug(uint32_t* answer)
 {
-	if(driver_setup()){
+	/* Once the IP is set up the answer is known to the driver,
+	 * no need to take the lock of the IP */
+	if(!IPECC_LOAD_ACQUIRE(ipecc_dev->setup_state)){
+		if(driver_enter_job()){
+			driver_leave();
+			goto err;
+		}
+		driver_leave();
+	}
+	if (ip_ecc_is_debug(answer)){
 		goto err;
 	}
+	return 0;
+err:
+	return -1;
+}
 
-	if(ip_ecc_enable_xyshuf()){
+/* To know if the IP was synthesized with the DMA ring (parameter 'dma')
+ * and hence if hw_driver_mul_batch_dma() can be used */
+int hw_driver_is_dma_supported(uint32_t* answer)
+{
+	/* Capabilities are read once upon setup of the IP
+	 * (no need to take the lock of the IP afterwards) */
+	if(!IPECC_LOAD_ACQUIRE(ipecc_dev->setup_state)){
+		if(driver_enter_job()){
+			driver_leave();
+			goto err;
+		}
+		driver_leave();
+	}
+	*answer = ipecc_dev->shadow.dma;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Get major version of the IP */
+int hw_driver_get_version_tags(uint32_t* maj, uint32_t* min, uint32_t* patch)
+{
+	/* Version numbers are read once upon setup of the IP
+	 * (no need to take the lock of the IP afterwards) */
+	if(!IPECC_LOAD_ACQUIRE(ipecc_dev->setup_state)){
+		if(driver_enter_job()){
+			driver_leave();
+			goto err;
+		}
+		driver_leave();
+	}
+	if((maj == NULL) || (min == NULL) || (patch == NULL)){
 		goto err;
 	}
+	(*maj) = ipecc_dev->shadow.version_major;
+	(*min) = ipecc_dev->shadow.version_minor;
+	(*patch) = ipecc_dev->shadow.version_patch;
 
 	return 0;
 err:
 	return -1;
 }
 
-/* Check if an affine point (x, y) is on the curve currently defined
- * in the IP (this curve was previously set in the hardware using
- * function hw_driver_set_curve() - c.f above).
- *
- * All size arguments (*_sz) must be given in bytes.
- *
- * Please read and take into consideration the 'NOTE:' mentionned
- * at the top of the prototype file <hw_accelerator_driver.h>
- * about the formatting and size of large numbers.
- */
-int hw_driver_is_on_curve(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
-                     	  int *on_curve)
+/* Enable TRNG post-processing logic */
+int hw_driver_trng_post_proc_enable()
 {
-	int inf_r0, inf_r1;
+	if(driver_enter()){
+		goto err;
+	}
+	if (ip_ecc_trng_postproc_enable()){
+		goto err;
+	}
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
 
-	if(driver_setup()){
+/* Disable TRNG post-processing logic */
+int hw_driver_trng_post_proc_disable()
+{
+	if(driver_enter()){
+		goto err;
+	}
+	if (ip_ecc_trng_postproc_disable()){
 		goto err;
 	}
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
 
-	/* Preserve our inf flags in a constant time fashion */
-	if(ip_ecc_get_r0_inf(&inf_r0)){
+/* Complete bypass the TRNG function (both entropy source,
+ * post-processing, and server) */
+int hw_driver_bypass_full_trng_DBG(uint32_t instead_bit)
+{
+	if(driver_enter()){
 		goto err;
 	}
-	if(ip_ecc_get_r1_inf(&inf_r1)){
+	if (ip_ecc_bypass_full_trng(instead_bit)){
 		goto err;
 	}
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
 
-	/* Write our R0 register */
-	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R0_X)){
+/* Disable token feature */
+int hw_driver_disable_token_DBG()
+{
+	if(driver_enter()){
 		goto err;
 	}
-	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R0_Y)){
+	if (ip_ecc_disable_token()){
 		goto err;
 	}
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
 
-	/* Restore our inf flags in a constant time fashion */
-	if(ip_ecc_set_r0_inf(inf_r0)){
+/* (Re-)enable token feature */
+int hw_driver_enable_token_DBG()
+{
+	if(driver_enter()){
 		goto err;
 	}
-	if(ip_ecc_set_r1_inf(inf_r1)){
+	if (ip_ecc_enable_token()){
 		goto err;
 	}
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
 
-	/* Check if it is on curve */
-	if(ip_ecc_exec_command(PT_CHK, on_curve, NULL)){
+/* Patching microcode in the IP */
+int hw_driver_patch_microcode_DBG(uint32_t* buf, uint32_t nbops, uint32_t opsz)
+{
+	if(driver_enter()){
+		goto err;
+	}
+	
+	if (ip_ecc_patch_microcode(buf, nbops, opsz)) {
 		goto err;
 	}
 
+	driver_leave();
 	return 0;
 err:
+	driver_leave();
 	return -1;
 }
 
-/* Check if affine points (x1, y1) and (x2, y2) are equal.
+
+/* Set the curve parameters a, b, p and q.
  *
  * All size arguments (*_sz) must be given in bytes.
  *
  * Please read and take into consideration the 'NOTE:' mentionned
  * at the top of the prototype file <hw_accelerator_driver.h>
  * about the formatting and size of large numbers.
- */
-int hw_driver_eq(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
-       	    	 const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
-                 int *is_eq)
-{
-	int inf_r0, inf_r1;
-
-	if(driver_setup()){
+ *
+ * Note: if software does not intend to later use the blinding
+ * countermeasure, then the order 'q' of the curve is not mandatory
+ * (using e.g an arbitrary number for argument 'q' and setting 'q_sz'
+ * the same as 'p_sz').
+ *
+ * Note however that the IP could have been synthesized with an
+ * active hardware-locked blinding countermeasure, which, if the IP
+ * was further synthesized in production (secure) mode, won't be
+ * disengageable by software. In this situation, since every scalar
+ * multiplication will be run by the IP with active blinding, 'q'
+ * and 'q_sz' arguments should be rigorously set.
+ */
+int hw_driver_set_curve(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
+       		        const uint8_t *p, uint32_t p_sz, const uint8_t *q, uint32_t q_sz)
+{
+	ip_ecc_curve c;
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	/* If the parameters can be tracked, setting again the curve
+	 * already resident in the IP is a no-op.
+	 */
+	if(ip_ecc_curve_fill(&c, a, a_sz, b, b_sz, p, p_sz, q, q_sz) == 0){
+		if(ip_ecc_curve_make_resident(&c)){
+			goto err;
+		}
+	}
+	else{
+		if(ip_ecc_set_curve(a, a_sz, b, b_sz, p, p_sz, q, q_sz)){
+			goto err;
+		}
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Select the IP of index 'dev' (see ip_ecc_select_device()).
+ *
+ * All subsequent calls to the driver operate on this IP, which is set
+ * up on first use. Each IP has its own context (resident curve, job in
+ * flight, transfer mode...) and several of them may have a scalar
+ * multiplication in flight at the same time.
+ */
+int hw_driver_select_device(uint32_t dev)
+{
+	if(ip_ecc_select_device(dev)){
+		return -1;
+	}
+	if(driver_enter_job()){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Get the index of the IP currently selected */
+int hw_driver_get_device(uint32_t *dev)
+{
+	if(dev == NULL){
+		goto err;
+	}
+	(*dev) = ipecc_dev_idx;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Get the number of IPs the driver can operate on */
+int hw_driver_get_nb_devices(uint32_t *nb)
+{
+	if(nb == NULL){
+		goto err;
+	}
+	(*nb) = hw_driver_nb_devices();
+	if((*nb) > HW_DRIVER_MAX_DEVICES){
+		(*nb) = HW_DRIVER_MAX_DEVICES;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Reserve the IP currently selected for the calling thread, until the call
+ * to hw_driver_unlock_device().
+ *
+ * In thread-safe mode (WITH_EC_HW_THREAD_SAFE) each call to the driver API
+ * is atomic, but a sequence of calls is not: e.g another thread may set a
+ * different curve in the IP between a call to hw_driver_set_curve() and a
+ * call to hw_driver_mul(). Such sequences must then be surrounded by calls to
+ * hw_driver_lock_device() and hw_driver_unlock_device() (which are no-ops
+ * otherwise).
+ *
+ * A thread can reserve only one IP at a time. It may still select and use
+ * other IPs in the meantime: hw_driver_unlock_device() releases the IP
+ * reserved, whichever is then selected.
+ */
+int hw_driver_lock_device(void)
+{
+	if(ipecc_locked_dev != NULL){
+		log_print("In hw_driver_lock_device(): an IP is already locked by this thread\n\r");
+		goto err;
+	}
+	if(driver_enter_job()){
+		driver_leave();
+		goto err;
+	}
+	ipecc_locked_dev = ipecc_dev;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Release the IP reserved by hw_driver_lock_device() */
+int hw_driver_unlock_device(void)
+{
+	if(ipecc_locked_dev == NULL){
+		log_print("In hw_driver_unlock_device(): no IP locked by this thread\n\r");
+		goto err;
+	}
+	ip_ecc_unlock_device(ipecc_locked_dev);
+	ipecc_locked_dev = NULL;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Load of an IP for the scheduler: 2 if a [k]P computation submitted by
+ * the driver is still in flight, 1 if the IP is otherwise busy, 0 if it
+ * is idle.
+ */
+static inline uint32_t ip_ecc_device_load(void)
+{
+	if(ipecc_dev->kp_job.pending){
+		return 2;
+	}
+	if(IPECC_IS_BUSY()){
+		return 1;
+	}
+	return 0;
+}
+
+/* Select the IP the next operation should run on, and return its index in 'dev'.
+ *
+ * The least busy IP is elected. Among IPs equally busy, one where the curve of
+ * handle 'curve_id' (see hw_driver_register_curve()) is already resident is
+ * preferred, in order to avoid the transfer of the curve parameters, then the
+ * one of lowest index. Unless 'curve_id' is HW_DRIVER_NO_CURVE, the curve is
+ * then set in the elected IP.
+ */
+int hw_driver_schedule(uint32_t curve_id, uint32_t *dev)
+{
+	uint32_t i, nb, load, best, best_load, best_affinity, affinity;
+	uint32_t prev = ipecc_dev_idx;
+	ip_ecc_curve c;
+
+	if(dev == NULL){
+		goto err;
+	}
+	if(curve_id != HW_DRIVER_NO_CURVE){
+		if(ip_ecc_curve_get_registered(curve_id, &c)){
+			goto err;
+		}
+	}
+	if(hw_driver_get_nb_devices(&nb)){
+		goto err;
+	}
+
+	best = nb;
+	best_load = best_affinity = 0;
+	for(i = 0; i < nb; i++){
+		if(ip_ecc_select_device(i)){
+			goto err;
+		}
+		/* In thread-safe mode, don't wait for a scalar multiplication
+		 * submitted by another thread: it only makes the IP busier */
+		(void)ip_ecc_lock(0);
+		if(driver_setup()){
+			/* This IP is not available, skip it */
+			ip_ecc_unlock();
+			continue;
+		}
+		load = ip_ecc_device_load();
+		affinity = (curve_id != HW_DRIVER_NO_CURVE) &&
+				ip_ecc_curve_equal(&c, &ipecc_dev->resident_curve);
+		ip_ecc_unlock();
+		if((best == nb) || (load < best_load) ||
+				((load == best_load) && (affinity > best_affinity))){
+			best = i;
+			best_load = load;
+			best_affinity = affinity;
+		}
+	}
+	if(best == nb){
+		log_print("hw_driver_schedule(): no IP available\n\r");
+		goto err;
+	}
+
+	if(hw_driver_select_device(best)){
+		goto err;
+	}
+	if(curve_id != HW_DRIVER_NO_CURVE){
+		if(hw_driver_select_curve(curve_id)){
+			goto err;
+		}
+	}
+	(*dev) = best;
+
+	return 0;
+err:
+	/* Leave the caller on the IP it had selected */
+	(void)ip_ecc_select_device(prev);
+	return -1;
+}
+
+/* Register the curve parameters a, b, p and q in the driver.
+ *
+ * The driver keeps a copy of the parameters, and returns in 'id' a handle
+ * to later select the curve with hw_driver_select_curve(). Registering a
+ * curve that is already registered returns the handle it already has.
+ *
+ * At most HW_DRIVER_MAX_CURVES curves can be registered at the same time,
+ * each parameter being at most 128 bytes long.
+ */
+int hw_driver_register_curve(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
+			     const uint8_t *p, uint32_t p_sz, const uint8_t *q, uint32_t q_sz,
+			     uint32_t *id)
+{
+	ip_ecc_curve c;
+	uint32_t i, free_slot;
+
+	/* The table of curves is not tied to any IP */
+	if(id == NULL){
+		goto err;
+	}
+
+	if(ip_ecc_curve_fill(&c, a, a_sz, b, b_sz, p, p_sz, q, q_sz)){
+		log_print("hw_driver_register_curve(): invalid curve parameters\n\r");
+		goto err;
+	}
+
+	IPECC_CURVES_LOCK();
+	/* Look for the same curve among registered ones, and for a free slot */
+	free_slot = HW_DRIVER_MAX_CURVES;
+	for(i = 0; i < HW_DRIVER_MAX_CURVES; i++){
+		if(ip_ecc_curve_equal(&c, &ipecc_curves[i])){
+			IPECC_CURVES_UNLOCK();
+			(*id) = i;
+			return 0;
+		}
+		if((!ipecc_curves[i].valid) && (free_slot == HW_DRIVER_MAX_CURVES)){
+			free_slot = i;
+		}
+	}
+	if(free_slot == HW_DRIVER_MAX_CURVES){
+		IPECC_CURVES_UNLOCK();
+		log_print("hw_driver_register_curve(): no more room for a new curve\n\r");
+		goto err;
+	}
+
+	memcpy(&ipecc_curves[free_slot], &c, sizeof(ip_ecc_curve));
+	IPECC_CURVES_UNLOCK();
+	(*id) = free_slot;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Select a curve previously registered with hw_driver_register_curve().
+ *
+ * If the curve is already the one resident in the IP this is a no-op,
+ * otherwise its parameters are transmitted to the IP. The parameters of
+ * the curve are checked against their digest, so that a corrupted copy
+ * can't be silently used.
+ */
+int hw_driver_select_curve(uint32_t id)
+{
+	ip_ecc_curve c;
+
+	/* Selecting the curve already resident doesn't touch the IP, hence
+	 * it is allowed with a [k]P in flight (typically right after
+	 * hw_driver_schedule() elected a busy IP): only the transfer of
+	 * another curve is rejected then.
+	 */
+	if(driver_enter_job()){
+		goto err;
+	}
+
+	if(ip_ecc_curve_get_registered(id, &c)){
+		goto err;
+	}
+
+	if(!ip_ecc_curve_equal(&c, &ipecc_dev->resident_curve)){
+		if(ip_ecc_check_no_kp_job()){
+			goto err;
+		}
+		if(ip_ecc_curve_make_resident(&c)){
+			goto err;
+		}
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Forget a curve previously registered with hw_driver_register_curve()
+ * (its handle may then be reused for another curve).
+ */
+int hw_driver_unregister_curve(uint32_t id)
+{
+	if(id >= HW_DRIVER_MAX_CURVES){
+		goto err;
+	}
+
+	IPECC_CURVES_LOCK();
+	if(!ipecc_curves[id].valid){
+		IPECC_CURVES_UNLOCK();
+		goto err;
+	}
+	ipecc_curves[id].valid = 0;
+	IPECC_CURVES_UNLOCK();
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Activate the blinding for scalar multiplication.
+ *
+ * Argument 'blinding_size' must be given in bits, and must be
+ * strictly less than the value of 'nn' currently set in the
+ * hardware (hance 'nn' - 1 is the largest authorized value).
+ *
+ * Otherwise error 'ERR_BLN' is raised in R_STATUS register.
+ *
+ * A value of 0 for input argument 'blinding_size' is counter-
+ * intuitive and will be held as meaning to disable the blinding
+ * countermeasure (consider using instead  explicit function
+ * hw_driver_disable_blinding()).
+ */
+int hw_driver_enable_blinding(uint32_t blinding_size)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(ip_ecc_enable_blinding_size(blinding_size)){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Disable the blinding for scalar multiplication.
+ */
+int hw_driver_disable_blinding(void)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(ip_ecc_disable_blinding()){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Transfer large numbers in streaming mode (default when supported by hardware) */
+int hw_driver_enable_streaming(void)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(ip_ecc_enable_streaming()){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Transfer large numbers limb by limb, polling the IP after each of them */
+int hw_driver_disable_streaming(void)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(ip_ecc_disable_streaming()){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+#if defined(WITH_EC_HW_BENCH)
+/* Time nothing but ip_ecc_write_bignum() or ip_ecc_read_bignum() on
+ * large numbers of the current size (see ecc-bench-linux.c).
+ *
+ * The IP only lets large numbers be read back once a computation was run
+ * since the last one written by software: R0 and R1 are written and
+ * compared once before the reads.
+ */
+int hw_driver_bench_transfer(int write, uint32_t nb, uint32_t *nb_bytes)
+{
+	uint8_t a[IPECC_CURVE_MAX_SZ];
+	uint32_t nn_sz, i;
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(nb_bytes == NULL){
+		goto err;
+	}
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	if(nn_sz > sizeof(a)){
+		goto err;
+	}
+	/* Arbitrary value lower than p */
+	memset(a, 0x5a, nn_sz);
+	a[0] = 0;
+
+	/* The coordinates of R0 and R1 are overwritten */
+	ipecc_dev->proj.state = IPECC_PROJ_NONE;
+	if(!write){
+		if(ip_ecc_write_bignum(a, nn_sz, EC_HW_REG_R0_X)
+		|| ip_ecc_write_bignum(a, nn_sz, EC_HW_REG_R0_Y)
+		|| ip_ecc_write_bignum(a, nn_sz, EC_HW_REG_R1_X)
+		|| ip_ecc_write_bignum(a, nn_sz, EC_HW_REG_R1_Y)){
+			goto err;
+		}
+		if(ip_ecc_set_r0_inf(0) || ip_ecc_set_r1_inf(0)){
+			goto err;
+		}
+		if(ip_ecc_exec_command(PT_EQU, NULL, NULL)){
+			goto err;
+		}
+	}
+	for(i = 0; i < nb; i++){
+		if(write){
+			if(ip_ecc_write_bignum(a, nn_sz, EC_HW_REG_R1_X)){
+				goto err;
+			}
+		}
+		else if(ip_ecc_read_bignum(a, nn_sz, EC_HW_REG_R1_X)){
+			goto err;
+		}
+	}
+	(*nb_bytes) = nb * nn_sz;
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+#endif /* WITH_EC_HW_BENCH */
+
+/* Activate the shuffling for scalar multiplication */
+int hw_driver_enable_shuffling(void)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(ip_ecc_enable_shuffling()){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Disable the shuffling for scalar multiplication */
+int hw_driver_disable_shuffling(void)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(ip_ecc_disable_shuffling()){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Activate and configure the periodic Z-remasking countermeasure
+ * (the 'period' arguement is expressed in number of bits of the scalar */
+int hw_driver_enable_zremask(uint32_t period)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(ip_ecc_enable_zremask(period)){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Disable the periodic Z-remasking countermeasure for scalar multiplication */
+int hw_driver_disable_zremask(void)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(ip_ecc_disable_zremask()){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Debug feature: disable XY-shuffling  */
+int hw_driver_disable_xyshuf(void)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(ip_ecc_disable_xyshuf()){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Debug feature: re-enable XY-shuffling  */
+int hw_driver_enable_xyshuf(void)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(ip_ecc_enable_xyshuf()){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Check if an affine point (x, y) is on the curve currently defined
+ * in the IP (this curve was previously set in the hardware using
+ * function hw_driver_set_curve() - c.f above).
+ *
+ * All size arguments (*_sz) must be given in bytes.
+ *
+ * Please read and take into consideration the 'NOTE:' mentionned
+ * at the top of the prototype file <hw_accelerator_driver.h>
+ * about the formatting and size of large numbers.
+ */
+int hw_driver_is_on_curve(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+                     	  int *on_curve)
+{
+	int inf_r0, inf_r1;
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
+		goto err;
+	}
+
+	/* Write our R0 register */
+	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
+		goto err;
+	}
+
+	/* Check if it is on curve */
+	if(ip_ecc_exec_command(PT_CHK, on_curve, NULL)){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Check if affine points (x1, y1) and (x2, y2) are equal.
+ *
+ * All size arguments (*_sz) must be given in bytes.
+ *
+ * Please read and take into consideration the 'NOTE:' mentionned
+ * at the top of the prototype file <hw_accelerator_driver.h>
+ * about the formatting and size of large numbers.
+ */
+int hw_driver_eq(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
+       	    	 const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
+                 int *is_eq)
+{
+	int inf_r0, inf_r1;
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
+		goto err;
+	}
+
+	/* Write our R0 register */
+	if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+	/* Write our R1 register */
+	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R1_Y)){
+		goto err;
+	}
+
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
+		goto err;
+	}
+
+	/* Check if it the points are equal */
+	if(ip_ecc_exec_command(PT_EQU, is_eq, NULL)){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Check if affine points (x1, y1) and (x2, y2) are opposite.
+ *
+ * All size arguments (*_sz) must be given in bytes.
+ *
+ * Please read and take into consideration the 'NOTE:' mentionned
+ * at the top of the prototype file <hw_accelerator_driver.h>
+ * about the formatting and size of large numbers.
+ */
+int hw_driver_opp(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
+                  const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
+               	  int *is_opp)
+{
+	int inf_r0, inf_r1;
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
+		goto err;
+	}
+
+	/* Write our R0 register */
+	if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+	/* Write our R1 register */
+	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R1_Y)){
+		goto err;
+	}
+
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
+		goto err;
+	}
+
+
+	/* Check if the points are opposite */
+	if(ip_ecc_exec_command(PT_OPP, is_opp, NULL)){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Check if the infinity point flag is set in the hardware for
+ * point at index idx.
+ *
+ * Argument 'index' must be either 0, identifying point R0, or 1,
+ * identifying point R1.
+ */
+int hw_driver_point_iszero(uint8_t idx, int *iszero)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	switch(idx){
+		case 0:{
+			/* Get our R0 register infinity flag */
+			if(ip_ecc_get_r0_inf(iszero)){
+				goto err;
+			}
+			break;
+		}
+		case 1:{
+			/* Get our R1 register infinity flag */
+			if(ip_ecc_get_r1_inf(iszero)){
+				goto err;
+			}
+			break;
+		}
+		default:{
+			/* Index not supported */
+			goto err;
+		}
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Set the infinity point flag in the hardware for point
+ * at index idx. This tells hardware to hold the corresponding
+ * point (R0 or R1) as being the null point (aka point at infinity).
+ *
+ * Any values of the affine coordinates the hardware was currently
+ * holding for that point will become irrelevant, either they were
+ * resulting from a previous computation or transmitted by software.
+ *
+ * Argument 'index' must be either 0, identifying point R0, or 1,
+ * identifying point R1.
+ */
+int hw_driver_point_zero(uint8_t idx)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	switch(idx){
+		case 0:{
+			/* Write our R0 register infinity flag */
+			if(ip_ecc_set_r0_inf(1)){
+				goto err;
+			}
+			break;
+		}
+		case 1:{
+			/* Write our R1 register infinity flag */
+			if(ip_ecc_set_r1_inf(1)){
+				goto err;
+			}
+			break;
+		}
+		default:{
+			/* Index not supported */
+			goto err;
+		}
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Unset the infinity point flag in the hardware for
+ * point at index idx. This tells hardware to hold the corresponding
+ * point (R0 or R1) as NOT being the null point (aka point at infinity).
+ *
+ * The affine coordinates the hardware was currently holding for that
+ * point will then become relevant, either they were resulting from a
+ * previous computation or transmitted by software.
+ *
+ * Further note that transmitting coordinates to the hardware for one
+ * of particular points R0 or R1 (using ip_ecc_write_bignum()) automatically
+ * set that point as being not null, just as hw_driver_point_unzero()
+ * would do.
+ *
+ * Argument 'index' must be either 0, identifying point R0, or 1,
+ * identifying point R1.
+ */
+int hw_driver_point_unzero(uint8_t idx)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	switch(idx){
+		case 0:{
+			/* Write our R0 register infinity flag */
+			if(ip_ecc_set_r0_inf(0)){
+				goto err;
+			}
+			break;
+		}
+		case 1:{
+			/* Write our R1 register infinity flag */
+			if(ip_ecc_set_r1_inf(0)){
+				goto err;
+			}
+			break;
+		}
+		default:{
+			/* Index not supported */
+			goto err;
+		}
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Return (out_x, out_y) = -(x, y) i.e the opposite of the
+ * intput point.
+ *
+ * All size arguments (*_sz) must be given in bytes.
+ *
+ * Please read and take into consideration the 'NOTE:' mentionned
+ * at the top of the prototype file <hw_accelerator_driver.h>
+ * about the formatting and size of large numbers.
+ */
+int hw_driver_neg(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+{
+	int inf_r0, inf_r1;
+	uint32_t nn_sz;
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
+		goto err;
+	}
+
+	/* Write our R0 register */
+	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
+		goto err;
+	}
+
+	/* Execute our NEG command */
+	if(ip_ecc_exec_command(PT_NEG, NULL, NULL)){
+		goto err;
+	}
+
+	/* Get back the result from R1 */
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+		goto err;
+	}
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
+	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Return (out_x, out_y) = 2 * (x, y), i.e the double of the
+ * input point.
+ *
+ * All size arguments (*_sz) must be given in bytes.
+ *
+ * Please read and take into consideration the 'NOTE:' mentionned
+ * at the top of the prototype file <hw_accelerator_driver.h>
+ * about the formatting and size of large numbers.
+ */
+int hw_driver_dbl(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+{
+	int inf_r0, inf_r1;
+	uint32_t nn_sz;
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
+		goto err;
+	}
+
+	/* Write our R0 register */
+	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
+		goto err;
+	}
+
+	/* Execute our DBL command */
+	if(ip_ecc_exec_command(PT_DBL, NULL, NULL)){
+		goto err;
+	}
+
+	/* Get back the result from R1 */
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+		goto err;
+	}
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
+	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+
+/* Return (out_x, out_y) = (x1, y1) + (x2, y2), i.e perform addition
+ * of the two input points.
+ *
+ * All size arguments (*_sz) must be given in bytes.
+ *
+ * Please read and take into consideration the 'NOTE:' mentionned
+ * at the top of the prototype file <hw_accelerator_driver.h>
+ * about the formatting and size of large numbers.
+ */
+int hw_driver_add(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
+                  const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
+                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+{
+	int inf_r0, inf_r1;
+	uint32_t nn_sz;
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
+		goto err;
+	}
+
+	/* Write our R0 register */
+	if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+	/* Write our R1 register */
+	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R1_Y)){
+		goto err;
+	}
+
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
+		goto err;
+	}
+
+	/* Execute our ADD command */
+	if(ip_ecc_exec_command(PT_ADD, NULL, NULL)){
+		goto err;
+	}
+
+	/* Get back the result from R1 */
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+		goto err;
+	}
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
+	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/*
+ * Scalar multiplication jobs
+ *
+ * A [k]P computation is split into its submission (token fetch, upload
+ * of the scalar and the point, start of the PT_KP command) and its
+ * completion (read-back and unmasking of the result), so that software
+ * may do something else while the IP computes (see hw_driver_mul_submit()).
+ *
+ * The IP computes one [k]P at a time, so there is at most one job in
+ * flight. Its one-shot token is kept in the driver until the result is
+ * collected.
+ *
+ * If the IP has point slots, one more job can be queued behind the one in
+ * flight: its point is staged into a slot of the IP while the current
+ * computation runs, and the job is started from the slot as soon as the
+ * result of the current one is read back (only its token and its scalar
+ * remaining to be transferred then, see ip_ecc_kp_enqueue()).
+ */
+
+/* Start the staging of a point: the following writes of R1 with the
+ * WRITE_BP bit (EC_HW_REG_BP_X/Y) only go to the staging slot of the
+ * IP. They are accepted even while a [k]P computation is running, as
+ * they leave R1 untouched.
+ */
+static inline void ip_ecc_stage_begin(void)
+{
+	IPECC_STAGE_WAIT();
+	IPECC_PT_SLOT_SELECT(ipecc_dev->stage_slot);
+	ipecc_dev->staging = 1;
+
+	return;
+}
+
+/* End the staging of a point */
+static inline void ip_ecc_stage_end(void)
+{
+	ipecc_dev->staging = 0;
+	/* Writes of the base point go to slot 0 again */
+	IPECC_STAGE_WAIT();
+	IPECC_PT_SLOT_SELECT(0);
+
+	return;
+}
+
+/* Start a [k]P computation on the point staged in the IP (the token
+ * being read and the scalar being written beforehand as for any [k]P).
+ * The IP copies the point into R1 by itself (2w cycles).
+ */
+static inline void ip_ecc_kp_start_staged(void)
+{
+	/* Wait until the IP is not busy */
+	IPECC_BUSY_WAIT();
+
+	IPECC_PT_SLOT_KP(ipecc_dev->stage_slot);
+
+	return;
+}
+
+/* Queue a [k]P computation behind the one in flight, staging its point
+ * into the IP right away.
+ */
+static inline int ip_ecc_kp_enqueue(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+		const uint8_t *scalar, uint32_t scalar_sz)
+{
+	if((ipecc_dev->stage_slot == 0) || ipecc_dev->kp_job.next.pending){
+		log_print("In ip_ecc_kp_enqueue(): no room to queue a [k]P computation\n\r");
+		goto err;
+	}
+	if((x == NULL) || (y == NULL) || (scalar == NULL)
+			|| (scalar_sz > sizeof(ipecc_dev->kp_job.next.scalar))){
+		goto err;
+	}
+
+	ip_ecc_stage_begin();
+	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_BP_X)){
+		log_print("In ip_ecc_kp_enqueue(): Error in ip_ecc_write_bignum()\n\r");
+		goto err_stage;
+	}
+	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_BP_Y)){
+		log_print("In ip_ecc_kp_enqueue(): Error in ip_ecc_write_bignum()\n\r");
+		goto err_stage;
+	}
+	ip_ecc_stage_end();
+
+	/* The scalar is kept in the driver until the job is started */
+	memcpy(ipecc_dev->kp_job.next.scalar, scalar, scalar_sz);
+	ipecc_dev->kp_job.next.scalar_sz = scalar_sz;
+	ipecc_dev->kp_job.next.id = ((ipecc_dev->kp_job.id + IPECC_JOB_SEQ_INC) & ~(hw_driver_mul_job)IPECC_JOB_DEV_MSK)
+				| ipecc_dev_idx;
+	ipecc_dev->kp_job.next.pending = 1;
+
+	return 0;
+err_stage:
+	ip_ecc_stage_end();
+err:
+	return -1;
+}
+
+/* Start the job queued by ip_ecc_kp_enqueue(), which becomes the one
+ * in flight (called once the result of the previous one is read back).
+ */
+static inline int ip_ecc_kp_start_next(void)
+{
+	ipecc_dev->kp_job.next.pending = 0;
+	ipecc_dev->kp_job.id = ipecc_dev->kp_job.next.id;
+
+	/* Get the random one-shot token of the job ('nn' is unchanged) */
+	if (ip_ecc_get_token(ipecc_dev->kp_job.token, ipecc_dev->kp_job.nn_sz)){
+		log_print("In ip_ecc_kp_start_next(): Error in ip_ecc_get_token()\n\r");
+		goto err;
+	}
+	if(ip_ecc_write_bignum(ipecc_dev->kp_job.next.scalar, ipecc_dev->kp_job.next.scalar_sz,
+				EC_HW_REG_SCALAR)){
+		log_print("In ip_ecc_kp_start_next(): Error in ip_ecc_write_bignum()\n\r");
+		goto err;
+	}
+	memset(ipecc_dev->kp_job.next.scalar, 0, sizeof(ipecc_dev->kp_job.next.scalar));
+	ipecc_dev->kp_job.next.scalar_sz = 0;
+
+	ip_ecc_kp_start_staged();
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Prepare and start a [k]P computation.
+ *
+ * The point is given either as big numbers (x, y), pre-converted ('pt'), or
+ * is the base point set by hw_driver_set_base_point() ('base' set, 'pt' then
+ * pointing to its copy in the driver). With none of them, the point is the
+ * one already in R1 (as left there by ip_ecc_decompress()).
+ */
+static inline int ip_ecc_kp_submit(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+		const ipecc_point_t *pt, uint8_t base, const uint8_t *scalar, uint32_t scalar_sz,
+		kp_trace_info_t* ktrc)
+{
+	ip_ecc_command cmd = PT_KP;
+	int inf_r0, inf_r1;
+	uint32_t nn_sz;
+
+	if(ipecc_dev->kp_job.pending){
+		/* (Not going through the 'err' label, which would release the job in flight) */
+		log_print("In ip_ecc_kp_submit(): a [k]P computation is already in flight\n\r");
+		return -1;
+	}
+
+	/* Nb of bytes corresponding to current value of 'nn' in the IP.
+	 */
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+
+	/* Check that the current value of 'nn' does not exceed the size
+	 * allocated to the token.
+	 */
+	if(nn_sz > IPECC_TOKEN_MAX_SZ){
+		log_print("In ip_ecc_kp_submit(): Error in ip_ecc_nn_bytes_from_bits_sz()\n\r");
+		goto err;
+	}
+
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		log_print("In ip_ecc_kp_submit(): Error in ip_ecc_get_r0_inf()\n\r");
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
+		log_print("In ip_ecc_kp_submit(): Error in ip_ecc_get_r1_inf()\n\r");
+		goto err;
+	}
+
+	/* Get the random one-shot token */
+	ipecc_dev->kp_job.nn_sz = nn_sz;
+	ipecc_dev->kp_job.pending = 1;
+#if defined(WITH_EC_HW_THREAD_SAFE)
+	ipecc_dev->kp_job.owner = pthread_self();
+#endif
+	if (ip_ecc_get_token(ipecc_dev->kp_job.token, nn_sz)){
+		log_print("In ip_ecc_kp_submit(): Error in ip_ecc_get_token()\n\r");
+		goto err;
+	}
+
+	/* Write our scalar register with the scalar k */
+	if(ip_ecc_write_bignum(scalar, scalar_sz, EC_HW_REG_SCALAR)){
+		log_print("In ip_ecc_kp_submit(): Error in ip_ecc_write_bignum()\n\r");
+		goto err;
+	}
+	/* Write our R1 register with the point to be multiplied
+	 * (either given as big numbers or pre-converted in 'pt'), unless it
+	 * is the base point stored in the IP: the [k]G command then has the IP
+	 * copy it into R1 by itself */
+	if(base && ipecc_dev->base_point_in_ip){
+		cmd = PT_KG;
+	}
+	else if(pt != NULL){
+		if(ip_ecc_write_bn(&pt->x, EC_HW_REG_R1_X)){
+			log_print("In ip_ecc_kp_submit(): Error in ip_ecc_write_bn()\n\r");
+			goto err;
+		}
+		if(ip_ecc_write_bn(&pt->y, EC_HW_REG_R1_Y)){
+			log_print("In ip_ecc_kp_submit(): Error in ip_ecc_write_bn()\n\r");
+			goto err;
+		}
+	}
+	else{
+		if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R1_X)){
+			log_print("In ip_ecc_kp_submit(): Error in ip_ecc_write_bignum()\n\r");
+			goto err;
+		}
+		if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R1_Y)){
+			log_print("In ip_ecc_kp_submit(): Error in ip_ecc_write_bignum()\n\r");
+			goto err;
+		}
+	}
+
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		log_print("In ip_ecc_kp_submit(): Error in ip_ecc_set_r0_inf()\n\r");
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
+		log_print("In ip_ecc_kp_submit(): Error in ip_ecc_set_r1_inf()\n\r");
+		goto err;
+	}
+
+	/* Start our [k]P (or [k]G) command */
+	if(ip_ecc_start_command(cmd, ktrc)){
+		log_print("In ip_ecc_kp_submit(): Error in ip_ecc_start_command()\n\r");
+		goto err;
+	}
+	ipecc_dev->kp_job.id = ((ipecc_dev->kp_job.id + IPECC_JOB_SEQ_INC) & ~(hw_driver_mul_job)IPECC_JOB_DEV_MSK)
+				| ipecc_dev_idx;
+
+	return 0;
+err:
+	ip_ecc_kp_job_release();
+	return -1;
+}
+
+/* Wait for the end of the [k]P computation in flight, then read back
+ * and unmask its result.
+ *
+ * If a job is queued behind it, it is started as soon as the result is
+ * read back, the result being unmasked while it runs.
+ */
+static inline int ip_ecc_kp_collect(uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+{
+	uint32_t nn_sz = ipecc_dev->kp_job.nn_sz;
+	uint8_t token[IPECC_TOKEN_MAX_SZ];
+
+	if(!ipecc_dev->kp_job.pending){
+		goto err;
+	}
+
+	/* Check the output buffers before anything else: the job is left
+	 * untouched if they are too small, so that the caller can collect
+	 * it again with larger ones.
+	 * (Not going through the 'err' label, which would release the job) */
+	if((out_x == NULL) || (out_x_sz == NULL) || (out_y == NULL) || (out_y_sz == NULL)){
+		return -1;
+	}
+	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+		log_print("In ip_ecc_kp_collect(): *out_x_sz = %d\n\r", *out_x_sz);
+		log_print("In ip_ecc_kp_collect(): *out_y_sz = %d\n\r", *out_y_sz);
+		log_print("In ip_ecc_kp_collect(): nn_sz = %d\n\r", nn_sz);
+		log_print("In ip_ecc_kp_collect(): Error in sizes' comparison\n\r");
+		return -1;
+	}
+
+	/* Wait for the end of our [k]P command */
+	if(ip_ecc_end_command(PT_KP, NULL)){
+		log_print("In ip_ecc_kp_collect(): Error in ip_ecc_end_command()\n\r");
+		goto err;
+	}
+
+	/* Get back the result from R1 */
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
+	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+		log_print("In ip_ecc_kp_collect(): Error in ip_ecc_read_bignum()\n\r");
+		goto err;
+	}
+	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+		log_print("In ip_ecc_kp_collect(): Error in ip_ecc_read_bignum()\n\r");
+		goto err;
+	}
+
+	/* Keep the token aside, then start the queued job (if any) */
+	memcpy(token, ipecc_dev->kp_job.token, nn_sz);
+	if(ipecc_dev->kp_job.next.pending){
+		if(ip_ecc_kp_start_next()){
+			goto err;
+		}
+	}
+	else{
+		ip_ecc_kp_job_release();
+	}
+
+	/* Unmask the [k]P result coordinates with the one-shot token */
+	if (ip_ecc_unmask_with_token(out_x, (*out_x_sz), token, nn_sz, out_x, out_x_sz)) {
+		log_print("In ip_ecc_kp_collect(): Error in ip_ecc_unmask_with_token()\n\r");
+		goto err_tok;
+	}
+	if (ip_ecc_unmask_with_token(out_y, (*out_y_sz), token, nn_sz, out_y, out_y_sz)) {
+		log_print("In ip_ecc_kp_collect(): Error in ip_ecc_unmask_with_token()\n\r");
+		goto err_tok;
+	};
+
+	/* Clear the token */
+	ip_ecc_clear_token(token, nn_sz);
+
+	return 0;
+err:
+	ip_ecc_kp_job_release();
+err_tok:
+	ip_ecc_clear_token(token, sizeof(token));
+	return -1;
+}
+
+/* Same as ip_ecc_kp_collect(), for the synchronous API: there being no
+ * handle to collect the job again, it is forgotten if its result can't
+ * be read back (the end of the computation being waited for anyway).
+ */
+static inline int ip_ecc_kp_collect_sync(uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+{
+	if(ip_ecc_kp_collect(out_x, out_x_sz, out_y, out_y_sz)){
+		if(ipecc_dev->kp_job.pending){
+			(void)ip_ecc_end_command(PT_KP, NULL);
+			ip_ecc_kp_job_release();
+		}
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Return (out_x, out_y) = scalar * (x, y), i.e perform the scalar 
+ * multiplication of the input point by the input scalar.
+ *
+ * All size arguments (*_sz) must be given in bytes.
+ *
+ * Please read and take into consideration the 'NOTE:' mentionned
+ * at the top of the prototype file <hw_accelerator_driver.h>
+ * about the formatting and size of large numbers.
+ */
+int hw_driver_mul(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+                  const uint8_t *scalar, uint32_t scalar_sz,
+                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz,
+									kp_trace_info_t* ktrc)
+{
+	if(driver_enter()){
+		log_print("In hw_driver_mul(): Error in driver_setup()\n\r");
+		goto err;
+	}
+
+	if(ip_ecc_kp_submit(x, x_sz, y, y_sz, NULL, 0, scalar, scalar_sz, ktrc)){
+		log_print("In hw_driver_mul(): Error in ip_ecc_kp_submit()\n\r");
+		goto err;
+	}
+
+	if(ip_ecc_kp_collect_sync(out_x, out_x_sz, out_y, out_y_sz)){
+		log_print("In hw_driver_mul(): Error in ip_ecc_kp_collect()\n\r");
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/*
+ * Field arithmetic
+ *
+ * The IP computes XR1 <- XR0 op YR0 modulo the number written in place
+ * of 'p', with its Montgomery multipliers. Operands and result are in
+ * normal (non Montgomery) form, unless software asked for the Montgomery
+ * form (see hw_driver_fp_enable_montgomery()). Points R0 and R1 of the
+ * IP are overwritten.
+ */
+
+/* Is 'cmd' a field arithmetic command with two operands? */
+static inline int ip_ecc_fp_is_binary(ip_ecc_command cmd)
+{
+	return (cmd == FP_ADD) || (cmd == FP_SUB) || (cmd == FP_MUL) || (cmd == FP_EXP);
+}
+
+/* Is 'cmd' a field arithmetic command? */
+static inline int ip_ecc_fp_is_command(ip_ecc_command cmd)
+{
+	return ip_ecc_fp_is_binary(cmd) || (cmd == FP_INV) || (cmd == FP_SQR)
+		|| (cmd == FP_MTY) || (cmd == FP_NOMTY);
+}
+
+/* Run field arithmetic command 'cmd' on 'a' (written in XR0) and 'b'
+ * (written in YR0, for commands with two operands) and read back the
+ * result (from XR1). Either operand is not written if NULL (it is then
+ * the one already in the IP).
+ */
+static int ip_ecc_fp_exec(ip_ecc_command cmd, const uint8_t *a, uint32_t a_sz,
+			  const uint8_t *b, uint32_t b_sz, uint8_t *out, uint32_t *out_sz)
+{
+	uint32_t nn_sz;
+
+	if(!ipecc_dev->shadow.fop){
+		log_print("In ip_ecc_fp_exec(): no field arithmetic in hardware\n\r");
+		goto err;
+	}
+	if((out == NULL) || (out_sz == NULL)){
+		goto err;
+	}
+
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	if((*out_sz) < nn_sz){
+		goto err;
+	}
+
+	/* Write our operands in XR0 and YR0 */
+	if(a != NULL){
+		if(ip_ecc_write_bignum(a, a_sz, EC_HW_REG_R0_X)){
+			goto err;
+		}
+	}
+	if((b != NULL) && ip_ecc_fp_is_binary(cmd)){
+		if(ip_ecc_write_bignum(b, b_sz, EC_HW_REG_R0_Y)){
+			goto err;
+		}
+	}
+
+	if(ip_ecc_exec_command(cmd, NULL, NULL)){
+		goto err;
+	}
+
+	/* Get back the result from XR1 */
+	(*out_sz) = nn_sz;
+	if(ip_ecc_read_bignum(out, (*out_sz), EC_HW_REG_R1_X)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Helpers on big numbers of 'n' bytes (big endian) for the square root below */
+static inline int ip_ecc_be_is_one(const uint8_t *a, uint32_t n)
+{
+	uint32_t i;
+	uint8_t acc = 0;
+
+	for(i = 0; i < (n - 1); i++){
+		acc |= a[i];
+	}
+
+	return (acc == 0) && (a[n - 1] == 1);
+}
+
+static inline void ip_ecc_be_srl1(uint8_t *a, uint32_t n)
+{
+	uint32_t i;
+
+	for(i = (n - 1); i > 0; i--){
+		a[i] = (uint8_t)((a[i] >> 1) | (a[i - 1] << 7));
+	}
+	a[0] >>= 1;
+
+	return;
+}
+
+static inline void ip_ecc_be_inc(uint8_t *a, uint32_t n)
+{
+	uint32_t i;
+
+	for(i = n; i > 0; i--){
+		if(++a[i - 1] != 0){
+			break;
+		}
+	}
+
+	return;
+}
+
+/* r <- a^(2^k) mod p (a and r may be the same buffer) */
+static inline int ip_ecc_fp_sqr_k(const uint8_t *a, uint32_t k, uint8_t *r, uint32_t n)
+{
+	uint32_t i, sz;
+
+	if(r != a){
+		memcpy(r, a, n);
+	}
+	for(i = 0; i < k; i++){
+		sz = n;
+		if(ip_ecc_fp_exec(FP_SQR, r, n, NULL, 0, r, &sz)){
+			goto err;
+		}
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Square root of 'a' modulo p = 1 mod 4 (Tonelli-Shanks), with the field
+ * arithmetic of the IP (in normal form). Big numbers are of 'n' bytes,
+ * 'p' included. '*is_square' tells whether 'a' actually is a square (r is
+ * otherwise meaningless).
+ *
+ * The number of operations depends on 'a', which must hence be public
+ * (e.g the x-coordinate of a point to decompress).
+ */
+static int ip_ecc_fp_sqrt_ts(const uint8_t *a, const uint8_t *p, uint8_t *r, uint32_t n,
+		int *is_square)
+{
+	uint8_t e[IPECC_CURVE_MAX_SZ], q[IPECC_CURVE_MAX_SZ], pm1[IPECC_CURVE_MAX_SZ];
+	uint8_t z[IPECC_CURVE_MAX_SZ], c[IPECC_CURVE_MAX_SZ], t[IPECC_CURVE_MAX_SZ];
+	uint8_t b[IPECC_CURVE_MAX_SZ], tt[IPECC_CURVE_MAX_SZ];
+	uint32_t i, m, s, sz;
+
+	(*is_square) = 0;
+
+	/* pm1 <- p - 1 (p is odd), e <- (p - 1) / 2 */
+	memcpy(pm1, p, n);
+	pm1[n - 1] &= 0xfe;
+	memcpy(e, pm1, n);
+	ip_ecc_be_srl1(e, n);
+
+	/* 0 is the square of 0 */
+	memset(z, 0, n);
+	if(memcmp(a, z, n) == 0){
+		memset(r, 0, n);
+		(*is_square) = 1;
+		return 0;
+	}
+	/* Euler's criterion: a^((p - 1) / 2) = 1 iff a is a square */
+	sz = n;
+	if(ip_ecc_fp_exec(FP_EXP, a, n, e, n, t, &sz)){
+		goto err;
+	}
+	if(!ip_ecc_be_is_one(t, n)){
+		return 0;
+	}
+
+	/* p - 1 = q.2^s with q odd */
+	memcpy(q, pm1, n);
+	for(s = 0; !(q[n - 1] & 1); s++){
+		ip_ecc_be_srl1(q, n);
+	}
+
+	/* z <- smallest non-square (z^((p - 1) / 2) = p - 1) */
+	for(i = 2; i < 256; i++){
+		z[n - 1] = (uint8_t)i;
+		sz = n;
+		if(ip_ecc_fp_exec(FP_EXP, z, n, e, n, t, &sz)){
+			goto err;
+		}
+		if(memcmp(t, pm1, n) == 0){
+			break;
+		}
+	}
+	if(i == 256){
+		log_print("In ip_ecc_fp_sqrt_ts(): no small non-square mod p\n\r");
+		goto err;
+	}
+
+	/* c <- z^q, t <- a^q, r <- a^((q + 1) / 2) */
+	sz = n;
+	if(ip_ecc_fp_exec(FP_EXP, z, n, q, n, c, &sz)){
+		goto err;
+	}
+	sz = n;
+	if(ip_ecc_fp_exec(FP_EXP, a, n, q, n, t, &sz)){
+		goto err;
+	}
+	memcpy(e, q, n);
+	ip_ecc_be_srl1(e, n);
+	ip_ecc_be_inc(e, n);
+	sz = n;
+	if(ip_ecc_fp_exec(FP_EXP, a, n, e, n, r, &sz)){
+		goto err;
+	}
+
+	/* Invariants: r^2 = a.t, c^(2^(m - 1)) = -1 and t^(2^(m - 1)) = 1 */
+	m = s;
+	while(!ip_ecc_be_is_one(t, n)){
+		/* Least i such that t^(2^i) = 1 (0 < i < m as a is a square) */
+		memcpy(tt, t, n);
+		for(i = 0; (i < m) && !ip_ecc_be_is_one(tt, n); i++){
+			if(ip_ecc_fp_sqr_k(tt, 1, tt, n)){
+				goto err;
+			}
+		}
+		if(i >= m){
+			goto err;
+		}
+		/* b <- c^(2^(m - i - 1)), m <- i, c <- b^2, t <- t.c, r <- r.b */
+		if(ip_ecc_fp_sqr_k(c, m - i - 1, b, n)){
+			goto err;
+		}
+		m = i;
+		if(ip_ecc_fp_sqr_k(b, 1, c, n)){
+			goto err;
+		}
+		sz = n;
+		if(ip_ecc_fp_exec(FP_MUL, t, n, c, n, t, &sz)){
+			goto err;
+		}
+		sz = n;
+		if(ip_ecc_fp_exec(FP_MUL, r, n, b, n, r, &sz)){
+			goto err;
+		}
+	}
+	(*is_square) = 1;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Decompression for p = 1 mod 4, which the IP can't do by itself: y is
+ * computed by the driver with the field arithmetic of the IP (see
+ * ip_ecc_fp_sqrt_ts()) and the point is then written in R1.
+ */
+static int ip_ecc_decompress_ts(const uint8_t *x, uint32_t x_sz, int y_odd, int *on_curve)
+{
+	const ip_ecc_curve *c = &ipecc_dev->resident_curve;
+	uint8_t p[IPECC_CURVE_MAX_SZ], rhs[IPECC_CURVE_MAX_SZ], t[IPECC_CURVE_MAX_SZ];
+	uint8_t y[IPECC_CURVE_MAX_SZ];
+	uint8_t fp_mty = ipecc_dev->fp_mty;
+	uint32_t n, sz;
+	int inf_r0, is_square;
+
+	n = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	if((n > IPECC_CURVE_MAX_SZ) || (c->p_sz > n)){
+		goto err;
+	}
+	memset(p, 0, n - c->p_sz);
+	memcpy(p + (n - c->p_sz), c->p, c->p_sz);
+
+	/* The field operations overwrite R0 & R1 */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	/* Operands of the field operations below are in normal form */
+	ipecc_dev->fp_mty = 0;
+
+	/* rhs <- x^3 + ax + b mod p */
+	sz = n;
+	if(ip_ecc_fp_exec(FP_SQR, x, x_sz, NULL, 0, t, &sz)){
+		goto err;
+	}
+	sz = n;
+	if(ip_ecc_fp_exec(FP_MUL, t, n, x, x_sz, rhs, &sz)){
+		goto err;
+	}
+	sz = n;
+	if(ip_ecc_fp_exec(FP_MUL, c->a, c->a_sz, x, x_sz, t, &sz)){
+		goto err;
+	}
+	sz = n;
+	if(ip_ecc_fp_exec(FP_ADD, rhs, n, t, n, rhs, &sz)){
+		goto err;
+	}
+	sz = n;
+	if(ip_ecc_fp_exec(FP_ADD, rhs, n, c->b, c->b_sz, rhs, &sz)){
+		goto err;
+	}
+
+	if(ip_ecc_fp_sqrt_ts(rhs, p, y, n, &is_square)){
+		goto err;
+	}
+	(*on_curve) = is_square;
+	if(is_square){
+		/* y <- p - y if its parity is not the one asked for */
+		if((y[n - 1] & 1) != (y_odd ? 1 : 0)){
+			memset(t, 0, n);
+			sz = n;
+			if(ip_ecc_fp_exec(FP_SUB, t, n, y, n, y, &sz)){
+				goto err;
+			}
+		}
+		if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R1_X)){
+			goto err;
+		}
+		if(ip_ecc_write_bignum(y, n, EC_HW_REG_R1_Y)){
+			goto err;
+		}
+	}
+	else{
+		if(ip_ecc_set_r1_inf(1)){
+			goto err;
+		}
+	}
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+
+	ipecc_dev->fp_mty = fp_mty;
+	return 0;
+err:
+	ipecc_dev->fp_mty = fp_mty;
+	return -1;
+}
+
+/* Write x in R1 and have the IP decompress it: R1 <- (x, y) with y the
+ * square root of x^3 + ax + b mod p of parity 'y_odd'. '*on_curve' tells
+ * whether x actually is the x-coordinate of a point on the curve (R1 is
+ * otherwise left null).
+ *
+ * The IP computes the square root as (x^3 + ax + b)^((p + 1) / 4), which
+ * only holds for p = 3 mod 4. For p = 1 mod 4 (e.g P-224), or if the IP
+ * has no decompression command, the driver runs Tonelli-Shanks with the
+ * field arithmetic of the IP instead (see ip_ecc_decompress_ts()), at the
+ * cost of many more transfers.
+ */
+static inline int ip_ecc_decompress(const uint8_t *x, uint32_t x_sz, int y_odd, int *on_curve)
+{
+	const ip_ecc_curve *c = &ipecc_dev->resident_curve;
+	int inf_r0;
+
+	if((!ipecc_dev->shadow.dec) && (!ipecc_dev->shadow.fop)){
+		log_print("In ip_ecc_decompress(): no point decompression in hardware\n\r");
+		goto err;
+	}
+	/* p (big-endian) must be known to the driver */
+	if((!c->valid) || (c->p_sz == 0)){
+		log_print("In ip_ecc_decompress(): p unknown\n\r");
+		goto err;
+	}
+	if((!ipecc_dev->shadow.dec) || ((c->p[c->p_sz - 1] & 0x3) != 0x3)){
+		if(!ipecc_dev->shadow.fop){
+			log_print("In ip_ecc_decompress(): p = 1 mod 4 needs the field arithmetic of the IP\n\r");
+			goto err;
+		}
+		return ip_ecc_decompress_ts(x, x_sz, y_odd, on_curve);
+	}
+
+	/* Preserve our R0 inf flag in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+
+	if(ip_ecc_exec_command(y_odd ? PT_DECOMPRESS_ODD : PT_DECOMPRESS, on_curve, NULL)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Return in out_y the y-coordinate of the point of x-coordinate x whose
+ * parity is 'y_odd' (0 for even, 1 for odd), i.e decompress the point.
+ * An error is returned if x is not the x-coordinate of a point on the
+ * curve.
+ *
+ * All size arguments (*_sz) must be given in bytes.
+ *
+ * Please read and take into consideration the 'NOTE:' mentionned
+ * at the top of the prototype file <hw_accelerator_driver.h>
+ * about the formatting and size of large numbers.
+ */
+int hw_driver_decompress(const uint8_t *x, uint32_t x_sz, int y_odd,
+			 uint8_t *out_y, uint32_t *out_y_sz)
+{
+	int on_curve;
+	uint32_t nn_sz;
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	if((x == NULL) || (out_y == NULL) || (out_y_sz == NULL)){
+		goto err;
+	}
+
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	if((*out_y_sz) < nn_sz){
+		log_print("In hw_driver_decompress(): Error in sizes' comparison\n\r");
+		goto err;
+	}
+
+	if(ip_ecc_decompress(x, x_sz, y_odd, &on_curve)){
+		goto err;
+	}
+	if(!on_curve){
+		log_print("In hw_driver_decompress(): x is not on the curve\n\r");
+		goto err;
+	}
+
+	(*out_y_sz) = nn_sz;
+	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Same as hw_driver_mul() with the point given in compressed form
+ * (x, y_odd) (see hw_driver_decompress()). The point is decompressed
+ * and multiplied by the IP without y being transferred back and forth.
+ */
+int hw_driver_mul_compressed(const uint8_t *x, uint32_t x_sz, int y_odd,
+			     const uint8_t *scalar, uint32_t scalar_sz,
+			     uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+{
+	int on_curve;
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(x == NULL){
+		goto err;
+	}
+
+	if(ip_ecc_decompress(x, x_sz, y_odd, &on_curve)){
+		goto err;
+	}
+	if(!on_curve){
+		log_print("In hw_driver_mul_compressed(): x is not on the curve\n\r");
+		goto err;
+	}
+
+	/* The decompressed point is left in R1 */
+	if(ip_ecc_kp_submit(NULL, 0, NULL, 0, NULL, 0, scalar, scalar_sz, NULL)){
+		goto err;
+	}
+	if(ip_ecc_kp_collect_sync(out_x, out_x_sz, out_y, out_y_sz)){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Convert the big number 'a' (big-endian, 'a_sz' bytes, at most
+ * IPECC_BIGNUM_MAX_SZ) to the format of the IP.
+ *
+ * The conversion does not depend on the curve set in the IP: a number
+ * shorter than the current size of large numbers is padded with null
+ * words when transferred.
+ */
+int hw_driver_bignum_import(const uint8_t *a, uint32_t a_sz, ipecc_bignum_t *bn)
+{
+	if((a == NULL) || (bn == NULL) || (a_sz > IPECC_BIGNUM_MAX_SZ)){
+		goto err;
+	}
+
+	bn->nb = ip_ecc_nn_words_from_bytes_sz(a_sz);
+	if(ip_ecc_bignum_to_limbs(a, a_sz, bn->w, bn->nb)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Convert back the pre-converted large number 'bn' to a big-endian buffer
+ * of 'a_sz' bytes (which must be large enough to hold all of its words).
+ */
+int hw_driver_bignum_export(const ipecc_bignum_t *bn, uint8_t *a, uint32_t a_sz)
+{
+	uint8_t tmp[IPECC_BIGNUM_MAX_SZ];
+	uint32_t i, sz;
+
+	if((bn == NULL) || (a == NULL) || (bn->nb > IPECC_LIMBS_MAX_NB)){
+		goto err;
+	}
+
+	sz = bn->nb * sizeof(ip_ecc_limb);
+	if(ip_ecc_limbs_to_bignum(bn->w, bn->nb, tmp, sz)){
+		goto err;
+	}
+	if(a_sz >= sz){
+		/* Zero padding on the left */
+		memset(a, 0, a_sz - sz);
+		memcpy(a + (a_sz - sz), tmp, sz);
+	}
+	else{
+		/* Only allowed if the bytes that don't fit are null */
+		for(i = 0; i < (sz - a_sz); i++){
+			if(tmp[i]){
+				goto err;
+			}
+		}
+		memcpy(a, tmp + (sz - a_sz), a_sz);
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Convert the affine point (x, y) to the format of the IP */
+int hw_driver_point_import(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+			   ipecc_point_t *pt)
+{
+	if(pt == NULL){
+		goto err;
+	}
+	if(hw_driver_bignum_import(x, x_sz, &pt->x)){
+		goto err;
+	}
+	if(hw_driver_bignum_import(y, y_sz, &pt->y)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Same as hw_driver_is_on_curve() with a point pre-converted by
+ * hw_driver_point_import().
+ */
+int hw_driver_is_on_curve_pt(const ipecc_point_t *pt, int *on_curve)
+{
+	int inf_r0, inf_r1;
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(pt == NULL){
+		goto err;
+	}
+
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
+		goto err;
+	}
+
+	/* Write our R0 register */
+	if(ip_ecc_write_bn(&pt->x, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bn(&pt->y, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
+		goto err;
+	}
+
+	/* Check if it is on curve */
+	if(ip_ecc_exec_command(PT_CHK, on_curve, NULL)){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Same as hw_driver_add() with points pre-converted by hw_driver_point_import() */
+int hw_driver_add_pt(const ipecc_point_t *pt1, const ipecc_point_t *pt2,
+		     uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+{
+	int inf_r0, inf_r1;
+	uint32_t nn_sz;
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	if((pt1 == NULL) || (pt2 == NULL)){
+		goto err;
+	}
+
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
+		goto err;
+	}
+
+	/* Write our R0 & R1 registers */
+	if(ip_ecc_write_bn(&pt1->x, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bn(&pt1->y, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+	if(ip_ecc_write_bn(&pt2->x, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bn(&pt2->y, EC_HW_REG_R1_Y)){
+		goto err;
+	}
+
+	/* Restore our inf flags in a constant time fashion */
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
+		goto err;
+	}
+
+	/* Execute our ADD command */
+	if(ip_ecc_exec_command(PT_ADD, NULL, NULL)){
+		goto err;
+	}
+
+	/* Get back the result from R1 */
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+		goto err;
+	}
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
+	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Same as hw_driver_mul() with a point pre-converted by hw_driver_point_import()
+ * (e.g a base point or a public key used for many scalar multiplications).
+ */
+int hw_driver_mul_pt(const ipecc_point_t *pt, const uint8_t *scalar, uint32_t scalar_sz,
+		     uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(pt == NULL){
+		goto err;
+	}
+
+	if(ip_ecc_kp_submit(NULL, 0, NULL, 0, pt, 0, scalar, scalar_sz, NULL)){
+		log_print("In hw_driver_mul_pt(): Error in ip_ecc_kp_submit()\n\r");
+		goto err;
+	}
+
+	if(ip_ecc_kp_collect_sync(out_x, out_x_sz, out_y, out_y_sz)){
+		log_print("In hw_driver_mul_pt(): Error in ip_ecc_kp_collect()\n\r");
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Set (x, y) as the base point of the curve currently set in the IP,
+ * for subsequent calls to hw_driver_mul_base().
+ *
+ * If the IP supports it, the point is uploaded once and for all into its
+ * stored base point slot (R1 is left untouched). The base point
+ * is forgotten as soon as another curve is set (or upon a reset).
+ */
+int hw_driver_set_base_point(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	ipecc_dev->base_point_valid = 0;
+	ipecc_dev->base_point_in_ip = 0;
+
+	if(hw_driver_point_import(x, x_sz, y, y_sz, &ipecc_dev->base_point)){
+		goto err;
+	}
+
+	if(ipecc_dev->shadow.base_point){
+		if(ip_ecc_write_bn(&ipecc_dev->base_point.x, EC_HW_REG_BP_X)){
+			log_print("In hw_driver_set_base_point(): Error in ip_ecc_write_bn()\n\r");
+			goto err;
+		}
+		if(ip_ecc_write_bn(&ipecc_dev->base_point.y, EC_HW_REG_BP_Y)){
+			log_print("In hw_driver_set_base_point(): Error in ip_ecc_write_bn()\n\r");
+			goto err;
+		}
+		ipecc_dev->base_point_in_ip = 1;
+	}
+	ipecc_dev->base_point_valid = 1;
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Return (out_x, out_y) = scalar * G, G being the base point set by
+ * hw_driver_set_base_point().
+ *
+ * When the IP stores the base point, only the scalar is transferred.
+ */
+int hw_driver_mul_base(const uint8_t *scalar, uint32_t scalar_sz,
+		       uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+{
+	if(driver_enter()){
+		goto err;
+	}
+
+	if(!ipecc_dev->base_point_valid){
+		log_print("In hw_driver_mul_base(): no base point set\n\r");
+		goto err;
+	}
+
+	if(ip_ecc_kp_submit(NULL, 0, NULL, 0, &ipecc_dev->base_point, 1, scalar, scalar_sz, NULL)){
+		log_print("In hw_driver_mul_base(): Error in ip_ecc_kp_submit()\n\r");
+		goto err;
+	}
+
+	if(ip_ecc_kp_collect_sync(out_x, out_x_sz, out_y, out_y_sz)){
+		log_print("In hw_driver_mul_base(): Error in ip_ecc_kp_collect()\n\r");
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Submit the scalar multiplication scalar * (x, y) to the IP, without
+ * waiting for its result.
+ *
+ * On return the inputs have been transmitted to the IP and the computation
+ * is running. The handle returned in 'job' must then be given to either
+ * hw_driver_mul_poll() or hw_driver_mul_wait() to collect the result.
+ *
+ * Only one scalar multiplication can be in flight at a time, and until its
+ * result has been collected the other calls to the driver on the same IP
+ * are rejected (they would override the result in the IP), except for
+ * hw_driver_mul_submit(), hw_driver_mul_poll(), hw_driver_mul_wait(),
+ * hw_driver_select_device(), hw_driver_lock_device() and the selection
+ * of the curve already resident in the IP (hw_driver_select_curve()).
+ *
+ * If the IP has point slots, a second scalar multiplication can however be
+ * submitted while the first one runs: its point is transmitted right away
+ * (while the IP computes) and it is started by the driver as soon as the
+ * result of the first one is collected. Results must then be collected in
+ * the order the jobs were submitted.
+ */
+int hw_driver_mul_submit(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
+			 const uint8_t *scalar, uint32_t scalar_sz, hw_driver_mul_job *job)
+{
+	if(driver_enter_job()){
+		goto err;
+	}
+
+	if(job == NULL){
+		goto err;
+	}
+
+	if(ipecc_dev->kp_job.pending){
+		/* Queue the job behind the one in flight */
+		if(ip_ecc_kp_enqueue(x, x_sz, y, y_sz, scalar, scalar_sz)){
+			goto err;
+		}
+		(*job) = ipecc_dev->kp_job.next.id;
+	}
+	else{
+		if(ip_ecc_kp_submit(x, x_sz, y, y_sz, NULL, 0, scalar, scalar_sz, NULL)){
+			goto err;
+		}
+		(*job) = ipecc_dev->kp_job.id;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Check if the scalar multiplication 'job' is over, without blocking.
+ *
+ * If it is, '*done' is set to 1 and the result is returned in (out_x, out_y)
+ * (the job is then over and its handle is no longer valid). Otherwise '*done'
+ * is set to 0 and the output buffers are left untouched.
+ *
+ * If the output buffers are too small, an error is returned and the job
+ * is left in flight (it can be collected again with larger buffers).
+ */
+int hw_driver_mul_poll(hw_driver_mul_job job, uint8_t *out_x, uint32_t *out_x_sz,
+		       uint8_t *out_y, uint32_t *out_y_sz, int *done)
+{
+	/* Operate on the IP the job was submitted to */
+	if(ip_ecc_select_device(IPECC_JOB_DEV(job))){
+		return -1;
+	}
+	if(driver_enter_job()){
+		goto err;
+	}
+
+	if(done == NULL){
+		goto err;
+	}
+	if((!ipecc_dev->kp_job.pending) || (job != ipecc_dev->kp_job.id)){
+		goto err;
+	}
+
+	if(ip_ecc_command_pending()){
+		(*done) = 0;
+		driver_leave();
+		return 0;
+	}
+
+	if(ip_ecc_kp_collect(out_x, out_x_sz, out_y, out_y_sz)){
+		goto err;
+	}
+	(*done) = 1;
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Wait for the end of the scalar multiplication 'job' and return its result
+ * in (out_x, out_y) (the job is then over and its handle is no longer valid).
+ *
+ * As with hw_driver_mul_poll(), if the output buffers are too small the
+ * job is left in flight.
+ */
+int hw_driver_mul_wait(hw_driver_mul_job job, uint8_t *out_x, uint32_t *out_x_sz,
+		       uint8_t *out_y, uint32_t *out_y_sz)
+{
+	/* Operate on the IP the job was submitted to */
+	if(ip_ecc_select_device(IPECC_JOB_DEV(job))){
+		return -1;
+	}
+	if(driver_enter_job()){
+		goto err;
+	}
+
+	if((!ipecc_dev->kp_job.pending) || (job != ipecc_dev->kp_job.id)){
+		goto err;
+	}
+
+	if(ip_ecc_kp_collect(out_x, out_x_sz, out_y, out_y_sz)){
+		goto err;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Unmask the result of a [k]P computation read by ip_ecc_read_limbs() */
+static inline int ip_ecc_kp_unmask_limbs(const ip_ecc_limb *l, uint32_t nb, uint8_t *tok, uint32_t nn_sz,
+		uint8_t *out, uint32_t *out_sz)
+{
+	if(ip_ecc_limbs_to_bignum(l, nb, out, nn_sz)){
+		goto err;
+	}
+	if(ip_ecc_unmask_with_token(out, nn_sz, tok, nn_sz, out, out_sz)){
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Job queue of the IP (register W_JOBQ_CTRL, if the IP has one, see
+ * IPECC_GET_JOBQ_NB()).
+ *
+ * Each entry of the queue holds the token, the scalar and the point of
+ * a [k]P computation, along with its result. The IP launches the jobs
+ * pushed into the queue one after the other by itself, and saves their
+ * result into their entry: software fills the next entries and reads
+ * the results of the previous ones while a computation runs, the IP
+ * only staying idle between two jobs for the time of copying the next
+ * one into its memory (see register R_JOBQ_GAP).
+ */
+
+/* Open an entry of the job queue, read its token into 'tok', fill it with
+ * the scalar & the point of a [k]P computation and push it. The caller
+ * must make sure the queue is not full.
+ */
+static inline int ip_ecc_jobq_submit(const ip_ecc_limb *k, const ip_ecc_limb *x, const ip_ecc_limb *y,
+		uint32_t nb_limbs, uint8_t *tok, uint32_t nn_sz)
+{
+	ipecc_dev->jobq = 1;
+
+	/* The IP generates the token of the entry right away */
+	IPECC_JOBQ_FILL_WAIT();
+	IPECC_JOBQ_CMD(IPECC_W_JOBQ_CTRL_OPEN);
+	if(ip_ecc_check_error(NULL)){
+		goto err;
+	}
+	if(ip_ecc_read_bignum(tok, nn_sz, EC_HW_REG_TOKEN)){
+		goto err_drop;
+	}
+
+	/* Writes of the scalar & of R1 go to the open entry */
+	if(ip_ecc_write_limbs(k, nb_limbs, EC_HW_REG_SCALAR)){
+		goto err_drop;
+	}
+	if(ip_ecc_write_limbs(x, nb_limbs, EC_HW_REG_R1_X)){
+		goto err_drop;
+	}
+	if(ip_ecc_write_limbs(y, nb_limbs, EC_HW_REG_R1_Y)){
+		goto err_drop;
+	}
+
+	IPECC_JOBQ_FILL_WAIT();
+	IPECC_JOBQ_CMD(IPECC_W_JOBQ_CTRL_PUSH);
+	if(ip_ecc_check_error(NULL)){
+		goto err_drop;
+	}
+
+	ipecc_dev->jobq = 0;
+	return 0;
+err_drop:
+	IPECC_JOBQ_CMD(IPECC_W_JOBQ_CTRL_DROP);
+err:
+	ipecc_dev->jobq = 0;
+	return -1;
+}
+
+/* Wait for the end of the job at the head of the job queue, read its
+ * (still masked) result and release its entry.
+ */
+static inline int ip_ecc_jobq_collect(ip_ecc_limb *rx, ip_ecc_limb *ry, uint32_t nb_limbs)
+{
+	uint32_t st;
+
+	ipecc_dev->jobq = 1;
+
+	do {
+		st = IPECC_JOBQ_STATUS();
+	} while(!(st & IPECC_R_JOBQ_STATUS_HEAD_DONE));
+	if(st & (IPECC_R_JOBQ_STATUS_HEAD_ERRIN | IPECC_R_JOBQ_STATUS_HEAD_ERROUT)){
+		log_print("In ip_ecc_jobq_collect(): point not on curve\n\r");
+		goto err;
+	}
+
+	/* Reads of R1 come from the result of the entry */
+	IPECC_JOBQ_FILL_WAIT();
+	IPECC_JOBQ_CMD(IPECC_W_JOBQ_CTRL_RES);
+	if(ip_ecc_check_error(NULL)){
+		goto err;
+	}
+	if(ip_ecc_read_limbs(rx, nb_limbs, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_read_limbs(ry, nb_limbs, EC_HW_REG_R1_Y)){
+		goto err;
+	}
+
+	IPECC_JOBQ_FILL_WAIT();
+	IPECC_JOBQ_CMD(IPECC_W_JOBQ_CTRL_POP);
+	if(ip_ecc_check_error(NULL)){
+		goto err;
+	}
+
+	ipecc_dev->jobq = 0;
+	return 0;
+err:
+	ipecc_dev->jobq = 0;
+	return -1;
+}
+
+/* Empty the job queue after an error: the open entry (if any) is discarded
+ * and the jobs pushed are waited for and released.
+ */
+static inline void ip_ecc_jobq_flush(void)
+{
+	uint32_t st;
+
+	IPECC_R_W_WAIT();
+	IPECC_JOBQ_CMD(IPECC_W_JOBQ_CTRL_DROP);
+	do {
+		st = IPECC_JOBQ_STATUS();
+		if(st & IPECC_R_JOBQ_STATUS_HEAD_DONE){
+			IPECC_JOBQ_CMD(IPECC_W_JOBQ_CTRL_POP);
+		}
+		/* (commands are refused if a transfer was left unfinished) */
+		if(ip_ecc_check_error(NULL)){
+			break;
+		}
+	} while(((st >> IPECC_R_JOBQ_STATUS_QUEUED_POS) & IPECC_R_JOBQ_STATUS_QUEUED_MSK)
+			|| ((st >> IPECC_R_JOBQ_STATUS_DONE_POS) & IPECC_R_JOBQ_STATUS_DONE_MSK));
+
+	return;
+}
+
+/* Batch of [k]P computations handed over to the job queue of the IP (see
+ * hw_driver_mul_batch()): job i is pushed as soon as the queue has room for
+ * it, the oldest one being collected otherwise, so that all the transfers
+ * but the first ones overlap with the computations.
+ */
+static int ip_ecc_kp_batch_jobq(const hw_driver_mul_input *in, hw_driver_mul_output *out, uint32_t nb,
+		uint32_t nn_sz, uint32_t nb_limbs)
+{
+	uint32_t i, col = 0, qsz = ipecc_dev->shadow.jobq_nb;
+	ip_ecc_limb k_limbs[IPECC_LIMBS_MAX_NB];
+	ip_ecc_limb x_limbs[IPECC_LIMBS_MAX_NB];
+	ip_ecc_limb y_limbs[IPECC_LIMBS_MAX_NB];
+	ip_ecc_limb rx_limbs[IPECC_LIMBS_MAX_NB];
+	ip_ecc_limb ry_limbs[IPECC_LIMBS_MAX_NB];
+	/* Tokens of the jobs in the queue */
+	uint8_t token[IPECC_JOBQ_MAX][IPECC_CURVE_MAX_SZ];
+
+	for(i = 0; i <= nb; i++){
+		/* Convert the inputs of job i (the coordinates of its point only
+		 * if they differ from the ones of job i-1) */
+		if(i < nb){
+			if(ip_ecc_bignum_to_limbs(in[i].scalar, in[i].scalar_sz, k_limbs, nb_limbs)){
+				goto err;
+			}
+			if((i == 0) || (in[i].x != in[i - 1].x) || (in[i].x_sz != in[i - 1].x_sz)){
+				if(ip_ecc_bignum_to_limbs(in[i].x, in[i].x_sz, x_limbs, nb_limbs)){
+					goto err;
+				}
+			}
+			if((i == 0) || (in[i].y != in[i - 1].y) || (in[i].y_sz != in[i - 1].y_sz)){
+				if(ip_ecc_bignum_to_limbs(in[i].y, in[i].y_sz, y_limbs, nb_limbs)){
+					goto err;
+				}
+			}
+		}
+		/* Collect the oldest job if the queue is full (all the remaining
+		 * ones after the last job was pushed) */
+		while((col < i) && (((i - col) == qsz) || (i == nb))){
+			if(ip_ecc_jobq_collect(rx_limbs, ry_limbs, nb_limbs)){
+				goto err;
+			}
+			if(ip_ecc_kp_unmask_limbs(rx_limbs, nb_limbs, token[col % qsz], nn_sz,
+						out[col].x, &out[col].x_sz)){
+				goto err;
+			}
+			if(ip_ecc_kp_unmask_limbs(ry_limbs, nb_limbs, token[col % qsz], nn_sz,
+						out[col].y, &out[col].y_sz)){
+				goto err;
+			}
+			ip_ecc_clear_token(token[col % qsz], nn_sz);
+			col++;
+		}
+		/* Push job i */
+		if(i < nb){
+			if(ip_ecc_jobq_submit(k_limbs, x_limbs, y_limbs, nb_limbs, token[i % qsz], nn_sz)){
+				goto err;
+			}
+		}
+	}
+
+	/* Clear the tokens & the scalar */
+	ip_ecc_clear_token((uint8_t*)token, sizeof(token));
+	memset(k_limbs, 0, sizeof(k_limbs));
+
+	return 0;
+err:
+	ip_ecc_jobq_flush();
+	ip_ecc_clear_token((uint8_t*)token, sizeof(token));
+	memset(k_limbs, 0, sizeof(k_limbs));
+	return -1;
+}
+
+/* Perform a batch of 'nb' scalar multiplications:
+ * (out[i].x, out[i].y) = in[i].scalar * (in[i].x, in[i].y)
+ *
+ * Compared to 'nb' calls to hw_driver_mul(), the driver setup, the save
+ * of the R0/R1 infinity flags and the checks of the current value of 'nn'
+ * are only made once, and the host-side work is overlapped with the
+ * computations of the IP: while the [k]P of job i runs, the inputs of
+ * job i+1 are converted to the format of the IP and the result of job
+ * i-1 is unmasked. The coordinates of a point are only converted once
+ * for consecutive jobs sharing it (i.e when their 'x' and 'y' pointers
+ * are the same). If the IP has point slots, the point of job i+1 is
+ * also transmitted while job i runs (it is staged into a slot, from
+ * which the IP starts job i+1), and only once for consecutive jobs
+ * sharing it. If the IP has a job queue, the jobs are pushed into it
+ * instead (see ip_ecc_kp_batch_jobq()): the IP then starts each job as
+ * soon as the previous one is over, with no software in between.
+ *
+ * Sizes of output buffers are given in out[i].x_sz/y_sz (in bytes) and are
+ * updated as with hw_driver_mul(). If an error occurs, the whole batch is
+ * aborted (results of jobs already computed are then not meaningful).
+ */
+int hw_driver_mul_batch(const hw_driver_mul_input *in, hw_driver_mul_output *out, uint32_t nb)
+{
+	int inf_r0, inf_r1;
+	uint32_t i, nn_sz, nb_limbs;
+	/* Is the point of the current job staged in the IP? */
+	uint8_t staged = 0;
+	ip_ecc_limb k_limbs[IPECC_LIMBS_MAX_NB];
+	ip_ecc_limb x_limbs[IPECC_LIMBS_MAX_NB];
+	ip_ecc_limb y_limbs[IPECC_LIMBS_MAX_NB];
+	ip_ecc_limb rx_limbs[IPECC_LIMBS_MAX_NB];
+	ip_ecc_limb ry_limbs[IPECC_LIMBS_MAX_NB];
+	/* Tokens of the current job and of the previous one */
+	uint8_t token[2][IPECC_CURVE_MAX_SZ];
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	if((in == NULL) || (out == NULL)){
+		goto err;
+	}
+	if(nb == 0){
+		driver_leave();
+		return 0;
+	}
+
+	/* Nb of bytes & of words corresponding to current value of 'nn' in the IP */
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	nb_limbs = ip_ecc_nn_limbs_nb();
+	if((nn_sz > IPECC_CURVE_MAX_SZ) || (nb_limbs > IPECC_LIMBS_MAX_NB)){
+		log_print("In hw_driver_mul_batch(): nn too large for batch mode\n\r");
+		goto err;
+	}
+
+	/* Check all the output buffers before starting anything */
+	for(i = 0; i < nb; i++){
+		if((out[i].x == NULL) || (out[i].y == NULL)
+				|| (out[i].x_sz < nn_sz) || (out[i].y_sz < nn_sz)){
+			log_print("In hw_driver_mul_batch(): Error in sizes' comparison (job %d)\n\r", i);
+			goto err;
+		}
+	}
+
+	/* Preserve our inf flags in a constant time fashion (once for the batch) */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
+		goto err;
+	}
+
+	/* With a job queue in the IP, the jobs are handed over to it */
+	if(ipecc_dev->shadow.jobq_nb){
+		if(ip_ecc_set_r0_inf(inf_r0)){
+			goto err;
+		}
+		if(ip_ecc_set_r1_inf(inf_r1)){
+			goto err;
+		}
+		if(ip_ecc_kp_batch_jobq(in, out, nb, nn_sz, nb_limbs)){
+			goto err;
+		}
+		driver_leave();
+		return 0;
+	}
+
+	/* Convert the inputs of the first job */
+	if(ip_ecc_bignum_to_limbs(in[0].scalar, in[0].scalar_sz, k_limbs, nb_limbs)){
+		goto err;
+	}
+	if(ip_ecc_bignum_to_limbs(in[0].x, in[0].x_sz, x_limbs, nb_limbs)){
+		goto err;
+	}
+	if(ip_ecc_bignum_to_limbs(in[0].y, in[0].y_sz, y_limbs, nb_limbs)){
+		goto err;
+	}
+
+	for(i = 0; i < nb; i++){
+		/* Get the random one-shot token of job i */
+		if(ip_ecc_get_token(token[i % 2], nn_sz)){
+			goto err;
+		}
+
+		/* Transmit the inputs of job i, then start its [k]P */
+		if(ip_ecc_write_limbs(k_limbs, nb_limbs, EC_HW_REG_SCALAR)){
+			goto err;
+		}
+		if(!staged){
+			if(ip_ecc_write_limbs(x_limbs, nb_limbs, EC_HW_REG_R1_X)){
+				goto err;
+			}
+			if(ip_ecc_write_limbs(y_limbs, nb_limbs, EC_HW_REG_R1_Y)){
+				goto err;
+			}
+		}
+		if(ip_ecc_set_r0_inf(inf_r0)){
+			goto err;
+		}
+		if(ip_ecc_set_r1_inf(inf_r1)){
+			goto err;
+		}
+		if(staged){
+			ip_ecc_kp_start_staged();
+		}
+		else if(ip_ecc_start_command(PT_KP, NULL)){
+			goto err;
+		}
+
+		/* While the IP computes, convert the inputs of job i+1 ... */
+		if((i + 1) < nb){
+			if(ip_ecc_bignum_to_limbs(in[i + 1].scalar, in[i + 1].scalar_sz, k_limbs, nb_limbs)){
+				goto err;
+			}
+			if((in[i + 1].x != in[i].x) || (in[i + 1].x_sz != in[i].x_sz)){
+				if(ip_ecc_bignum_to_limbs(in[i + 1].x, in[i + 1].x_sz, x_limbs, nb_limbs)){
+					goto err;
+				}
+			}
+			if((in[i + 1].y != in[i].y) || (in[i + 1].y_sz != in[i].y_sz)){
+				if(ip_ecc_bignum_to_limbs(in[i + 1].y, in[i + 1].y_sz, y_limbs, nb_limbs)){
+					goto err;
+				}
+			}
+		}
+		/* ... stage its point into the IP (unless already there) ... */
+		if(((i + 1) < nb) && ipecc_dev->stage_slot){
+			if(!staged || (in[i + 1].x != in[i].x) || (in[i + 1].x_sz != in[i].x_sz)
+					|| (in[i + 1].y != in[i].y) || (in[i + 1].y_sz != in[i].y_sz)){
+				ip_ecc_stage_begin();
+				if(ip_ecc_write_limbs(x_limbs, nb_limbs, EC_HW_REG_BP_X)){
+					ip_ecc_stage_end();
+					goto err;
+				}
+				if(ip_ecc_write_limbs(y_limbs, nb_limbs, EC_HW_REG_BP_Y)){
+					ip_ecc_stage_end();
+					goto err;
+				}
+				ip_ecc_stage_end();
+			}
+			staged = 1;
+		}
+		else{
+			staged = 0;
+		}
+		/* ... and unmask the result of job i-1 */
+		if(i > 0){
+			if(ip_ecc_kp_unmask_limbs(rx_limbs, nb_limbs, token[(i - 1) % 2], nn_sz,
+						out[i - 1].x, &out[i - 1].x_sz)){
+				goto err;
+			}
+			if(ip_ecc_kp_unmask_limbs(ry_limbs, nb_limbs, token[(i - 1) % 2], nn_sz,
+						out[i - 1].y, &out[i - 1].y_sz)){
+				goto err;
+			}
+			ip_ecc_clear_token(token[(i - 1) % 2], nn_sz);
+		}
+
+		/* Wait for the end of job i and get its (still masked) result */
+		if(ip_ecc_end_command(PT_KP, NULL)){
+			goto err;
+		}
+		if(ip_ecc_read_limbs(rx_limbs, nb_limbs, EC_HW_REG_R1_X)){
+			goto err;
+		}
+		if(ip_ecc_read_limbs(ry_limbs, nb_limbs, EC_HW_REG_R1_Y)){
+			goto err;
+		}
+	}
+
+	/* Unmask the result of the last job */
+	if(ip_ecc_kp_unmask_limbs(rx_limbs, nb_limbs, token[(nb - 1) % 2], nn_sz,
+				out[nb - 1].x, &out[nb - 1].x_sz)){
+		goto err;
+	}
+	if(ip_ecc_kp_unmask_limbs(ry_limbs, nb_limbs, token[(nb - 1) % 2], nn_sz,
+				out[nb - 1].y, &out[nb - 1].y_sz)){
+		goto err;
+	}
+
+	/* Clear the tokens & the scalar */
+	ip_ecc_clear_token(token[0], sizeof(token[0]));
+	ip_ecc_clear_token(token[1], sizeof(token[1]));
+	memset(k_limbs, 0, sizeof(k_limbs));
+
+	driver_leave();
+	return 0;
+err:
+	ip_ecc_clear_token(token[0], sizeof(token[0]));
+	ip_ecc_clear_token(token[1], sizeof(token[1]));
+	memset(k_limbs, 0, sizeof(k_limbs));
+	driver_leave();
+	return -1;
+}
+
+#if defined(WITH_EC_HW_UIO)
+/* Map the memory shared with the DMA ring of the IP (once) and size
+ * the ring after it.
+ */
+static inline int ip_ecc_dma_setup(void)
+{
+	ip_ecc_dma *d = &ipecc_dev->dma;
+	uint32_t lgsz;
+
+	if(d->mapped){
+		/* Nothing to do */
+		return 0;
+	}
+	if(hw_driver_dma_map(ipecc_dev_idx, &d->virt, &d->phys, &d->sz)){
+		goto err;
+	}
+	/* The IP only issues 32-bit addresses, and its bursts must not
+	 * cross a 4 kB boundary */
+	if(((d->phys + d->sz) > 0x100000000ULL) || (d->phys % IPECC_DMA_RING_SZ)){
+		log_print("In ip_ecc_dma_setup(): DMA memory not usable by the IP\n\r");
+		goto err;
+	}
+	for(lgsz = IPECC_DMA_LGSZ_MAX; lgsz >= 1; lgsz--){
+		if((IPECC_DMA_RING_SZ + ((1UL << lgsz) * IPECC_DMA_AREA_SZ)) <= d->sz){
+			break;
+		}
+	}
+	if(lgsz == 0){
+		log_print("In ip_ecc_dma_setup(): DMA memory too small\n\r");
+		goto err;
+	}
+	d->lgsz = lgsz;
+	d->mapped = 1;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Area of the buffers of the descriptor of index 'slot' */
+static inline uint8_t *ip_ecc_dma_area(uint32_t slot)
+{
+	return ipecc_dev->dma.virt + IPECC_DMA_RING_SZ + (slot * IPECC_DMA_AREA_SZ);
+}
+
+/* Fill the descriptor of index 'slot' for a [k]P computation on the
+ * buffers of its area */
+static inline void ip_ecc_dma_set_kp_desc(uint32_t slot, uint32_t flags)
+{
+	ip_ecc_dma *d = &ipecc_dev->dma;
+	volatile uint32_t *desc = (volatile uint32_t*)(d->virt + (slot * IPECC_DMA_DESC_SZ));
+	uint32_t area = (uint32_t)d->phys + IPECC_DMA_RING_SZ + (slot * IPECC_DMA_AREA_SZ);
+
+	desc[IPECC_DMA_DESC_FLAGS] = flags;
+	desc[IPECC_DMA_DESC_CTRL] = IPECC_W_CTRL_PT_KP;
+	desc[IPECC_DMA_DESC_K] = area + IPECC_DMA_OFF_K;
+	desc[IPECC_DMA_DESC_X] = area + IPECC_DMA_OFF_X;
+	desc[IPECC_DMA_DESC_Y] = area + IPECC_DMA_OFF_Y;
+	desc[IPECC_DMA_DESC_RES] = area + IPECC_DMA_OFF_RES;
+	desc[IPECC_DMA_DESC_TOKEN] = area + IPECC_DMA_OFF_TOKEN;
+	desc[IPECC_DMA_DESC_STATUS] = 0;
+
+	return;
+}
+
+/* Wait until the IP has processed all the descriptors of the ring up
+ * to index 'tail' (excluded), sleeping on its interrupt if software
+ * asked so (see hw_driver_set_completion_mode()).
+ */
+static inline int ip_ecc_dma_wait(uint32_t tail)
+{
+	while((IPECC_GET_REG(IPECC_R_DMA_HEAD) & 0xffff) != tail){
+		if(IPECC_GET_REG(IPECC_R_DMA_STATUS) & IPECC_R_DMA_STATUS_BERR){
+			log_print("In ip_ecc_dma_wait(): bus error on the DMA port of the IP\n\r");
+			goto err;
+		}
+		if(ipecc_dev->completion == HW_DRIVER_COMPLETION_IRQ){
+			/* (Re-)enable the interrupt line in UIO */
+			if(hw_driver_irq_arm(ipecc_dev_idx)){
+				goto err;
+			}
+			if((IPECC_GET_REG(IPECC_R_DMA_HEAD) & 0xffff) == tail){
+				break;
+			}
+			/* Sleep until the IP raises its interrupt */
+			if(hw_driver_irq_wait(ipecc_dev_idx)){
+				goto err;
+			}
+		}
+	}
+
+	return 0;
+err:
+	return -1;
+}
+#endif
+
+/* Perform a batch of 'nb' scalar multiplications through the ring of job
+ * descriptors of the IP (DMA):
+ * (out[i].x, out[i].y) = in[i].mul.scalar * (in[i].mul.x, in[i].mul.y)
+ * on the curve of handle in[i].curve.
+ *
+ * The inputs of all the jobs (as many as the ring holds at once) are
+ * converted into memory shared with the IP, one descriptor per job, and
+ * the IP is then given the whole chunk with a single register write: it
+ * fetches the operands, runs the [k]P computations back to back and
+ * writes the results back in memory by itself, raising its
+ * interrupt once at the end of the chunk. The CPU is hence left free
+ * during the whole chunk (in HW_DRIVER_COMPLETION_IRQ mode) instead of
+ * transferring each job through the AXI-lite registers.
+ *
+ * The IP only holds one curve at a time, and its descriptors hence have no
+ * curve field: a chunk is made of consecutive jobs sharing the same curve
+ * handle, the driver making the curve of each chunk resident in the IP
+ * (see hw_driver_select_curve()) before giving it the chunk. Jobs are thus
+ * best sorted by curve. A handle of HW_DRIVER_CURVE_CURRENT stands for the
+ * curve currently set in the IP.
+ *
+ * The points must not be null. Sizes of output buffers are handled as with
+ * hw_driver_mul_batch(), those of each chunk being checked before it is
+ * started (upon error the jobs of the previous chunks have been run).
+ *
+ * NOTE: by default the IP keeps the token of each job to itself and
+ * unmasks the result before writing it back, so results are written in
+ * this memory in the clear (the token slot of each descriptor is left
+ * null by the driver, which makes its own unmasking neutral). Only if
+ * the IP was synthesized with parameter 'dmatoken' does it write the
+ * token in memory, next to the result it masks: the token then gives no
+ * protection against an agent able to read this memory. In both cases
+ * the token and the scalar are cleared from memory as soon as the result
+ * has been copied out.
+ *
+ * Only available on Linux with the UIO driver (WITH_EC_HW_UIO): the
+ * memory is the second map of the UIO device of the IP (see
+ * hw_driver_dma_map()).
+ */
+int hw_driver_mul_batch_dma(const hw_driver_mul_dma_input *in, hw_driver_mul_output *out, uint32_t nb)
+{
+#if defined(WITH_EC_HW_UIO)
+	uint32_t i, j, n, nn_sz, nb_limbs, head, tail, mask, slot, st;
+	uint8_t *area;
+	volatile uint32_t *desc;
+	uint8_t token[IPECC_CURVE_MAX_SZ];
+	ip_ecc_curve c;
+
+	memset(token, 0, sizeof(token));
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	if((in == NULL) || (out == NULL)){
+		goto err;
+	}
+	if(nb == 0){
+		driver_leave();
+		return 0;
+	}
+
+	if(!ipecc_dev->shadow.dma){
+		log_print("In hw_driver_mul_batch_dma(): no DMA ring in hardware\n\r");
+		goto err;
+	}
+	if(ip_ecc_dma_setup()){
+		goto err;
+	}
+
+	/* (Re)configure the ring, which is empty when not used by the driver */
+	IPECC_BUSY_WAIT();
+	mask = (((uint32_t)1) << ipecc_dev->dma.lgsz) - 1;
+	head = (uint32_t)IPECC_GET_REG(IPECC_R_DMA_HEAD) & mask;
+	IPECC_SET_REG(IPECC_W_DMA_RING, (uint32_t)ipecc_dev->dma.phys);
+
+	/* The ring holds at most 'mask' jobs at once, all on the same curve */
+	for(i = 0; i < nb; i += n){
+		for(n = 1; ((i + n) < nb) && (n < mask) && (in[i + n].curve == in[i].curve); n++);
+
+		/* Set the curve of the chunk (the ring is empty) */
+		if(in[i].curve != HW_DRIVER_CURVE_CURRENT){
+			if(ip_ecc_curve_get_registered(in[i].curve, &c)){
+				log_print("In hw_driver_mul_batch_dma(): bad curve handle (job %d)\n\r", i);
+				goto err;
+			}
+			if(ip_ecc_curve_make_resident(&c)){
+				goto err;
+			}
+		}
+
+		/* Nb of bytes & of words corresponding to current value of 'nn' in the IP */
+		nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+		nb_limbs = ip_ecc_nn_limbs_nb();
+		if((nn_sz > IPECC_CURVE_MAX_SZ) || (nb_limbs > IPECC_LIMBS_MAX_NB)){
+			log_print("In hw_driver_mul_batch_dma(): nn too large for batch mode\n\r");
+			goto err;
+		}
+
+		/* Check all the output buffers of the chunk before starting it */
+		for(j = 0; j < n; j++){
+			if((out[i + j].x == NULL) || (out[i + j].y == NULL)
+					|| (out[i + j].x_sz < nn_sz) || (out[i + j].y_sz < nn_sz)){
+				log_print("In hw_driver_mul_batch_dma(): Error in sizes' comparison (job %d)\n\r", i + j);
+				goto err;
+			}
+		}
+
+		/* The size of large numbers in memory follows the curve */
+		IPECC_SET_REG(IPECC_W_DMA_CTRL, IPECC_W_DMA_CTRL_EN
+			| ((ipecc_dev->completion == HW_DRIVER_COMPLETION_IRQ) ? IPECC_W_DMA_CTRL_IRQEN : 0)
+			| ((ipecc_dev->dma.lgsz & IPECC_W_DMA_CTRL_LGSZ_MSK) << IPECC_W_DMA_CTRL_LGSZ_POS)
+			| ((nb_limbs & IPECC_W_DMA_CTRL_NBW_MSK) << IPECC_W_DMA_CTRL_NBW_POS));
+
+		/* Convert the inputs of the chunk into memory & fill its descriptors */
+		tail = head;
+		for(j = 0; j < n; j++){
+			area = ip_ecc_dma_area(tail);
+			if(ip_ecc_bignum_to_limbs(in[i + j].mul.scalar, in[i + j].mul.scalar_sz,
+						(ip_ecc_limb*)(area + IPECC_DMA_OFF_K), nb_limbs)){
+				goto err;
+			}
+			if(ip_ecc_bignum_to_limbs(in[i + j].mul.x, in[i + j].mul.x_sz,
+						(ip_ecc_limb*)(area + IPECC_DMA_OFF_X), nb_limbs)){
+				goto err;
+			}
+			if(ip_ecc_bignum_to_limbs(in[i + j].mul.y, in[i + j].mul.y_sz,
+						(ip_ecc_limb*)(area + IPECC_DMA_OFF_Y), nb_limbs)){
+				goto err;
+			}
+			/* Unless synthesized with parameter 'dmatoken' the IP keeps the
+			 * token to itself and writes the result back unmasked: a null
+			 * token then makes the unmasking below neutral.
+			 */
+			memset(area + IPECC_DMA_OFF_TOKEN, 0, IPECC_CURVE_MAX_SZ);
+			/* Interrupt only at the end of the chunk */
+			ip_ecc_dma_set_kp_desc(tail, IPECC_DMA_FLAG_TOKEN | IPECC_DMA_FLAG_K
+					| IPECC_DMA_FLAG_PT | IPECC_DMA_FLAG_RES
+					| (((j + 1) == n) ? IPECC_DMA_FLAG_IRQ : 0));
+			tail = (tail + 1) & mask;
+		}
+
+		/* Make the memory visible to the IP before giving it the chunk */
+		__sync_synchronize();
+		IPECC_SET_REG(IPECC_W_DMA_TAIL, tail);
+		if(ip_ecc_dma_wait(tail)){
+			goto err;
+		}
+		__sync_synchronize();
+
+		/* Check the status of each job and unmask its result */
+		for(j = 0; j < n; j++){
+			slot = (head + j) & mask;
+			area = ip_ecc_dma_area(slot);
+			desc = (volatile uint32_t*)(ipecc_dev->dma.virt + (slot * IPECC_DMA_DESC_SZ));
+			st = desc[IPECC_DMA_DESC_STATUS];
+			if(!(st & IPECC_DMA_DESC_DONE)
+					|| ((st >> IPECC_R_STATUS_ERRID_POS) & IPECC_R_STATUS_ERRID_MSK)){
+				log_print("In hw_driver_mul_batch_dma(): job %d ended with status 0x%08x\n\r",
+						i + j, st);
+				goto err;
+			}
+			if(ip_ecc_limbs_to_bignum((ip_ecc_limb*)(area + IPECC_DMA_OFF_TOKEN), nb_limbs,
+						token, nn_sz)){
+				goto err;
+			}
+			if(ip_ecc_kp_unmask_limbs((ip_ecc_limb*)(area + IPECC_DMA_OFF_RES), nb_limbs,
+						token, nn_sz, out[i + j].x, &out[i + j].x_sz)){
+				goto err;
+			}
+			if(ip_ecc_kp_unmask_limbs((ip_ecc_limb*)(area + IPECC_DMA_OFF_RES)
+						+ nb_limbs, nb_limbs, token, nn_sz, out[i + j].y, &out[i + j].y_sz)){
+				goto err;
+			}
+			/* Clear the token & the scalar */
+			ip_ecc_clear_token(token, sizeof(token));
+			memset(area + IPECC_DMA_OFF_K, 0, IPECC_CURVE_MAX_SZ);
+			memset(area + IPECC_DMA_OFF_TOKEN, 0, IPECC_CURVE_MAX_SZ);
+		}
+		head = tail;
+	}
+
+	driver_leave();
+	return 0;
+err:
+	ip_ecc_clear_token(token, sizeof(token));
+	driver_leave();
+	return -1;
+#else
+	(void)in;
+	(void)out;
+	(void)nb;
+	log_print("hw_driver_mul_batch_dma(): the DMA ring is only supported with UIO\n\r");
+	return -1;
+#endif
+}
+
+/* Bit 'i' (0 for the lsb) of big-endian number (a, a_sz) */
+static inline uint8_t ip_ecc_bignum_bit(const uint8_t *a, uint32_t a_sz, uint32_t i)
+{
+	if((i / 8) >= a_sz){
+		return 0;
+	}
+	return (a[a_sz - 1 - (i / 8)] >> (i % 8)) & 0x1;
+}
+
+/* Nb of significant bits of big-endian number (a, a_sz) */
+static inline uint32_t ip_ecc_bignum_bit_sz(const uint8_t *a, uint32_t a_sz)
+{
+	uint32_t i, j;
+
+	for(i = 0; i < a_sz; i++){
+		if(a[i] != 0){
+			for(j = 8; !((a[i] >> (j - 1)) & 0x1); j--);
+			return (8 * (a_sz - 1 - i)) + j;
+		}
+	}
+	return 0;
+}
+
+/* Compute k1 * (x1, y1) + k2 * (x2, y2) with the double scalar multiplication
+ * of the IP (register W_KP2, see routines .kp2_*L of the microcode): both
+ * points are loaded once, then one loop runs over the bits of both scalars
+ * (one doubling per bit, and one mixed addition per non-zero bit of each
+ * scalar). This is NOT constant time, scalars are handled as public values.
+ *
+ * '*done' is left to 0 (nothing being output) when the IP cannot handle the
+ * computation: null scalars, a scalar wider than nn, or a sum of two points
+ * with equal x-coordinates met on the way (including a null result). The
+ * caller must then fall back to separate scalar multiplications.
+ */
+static inline int ip_ecc_mul2_kp2(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
+		const uint8_t *k1, uint32_t k1_sz,
+		const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
+		const uint8_t *k2, uint32_t k2_sz,
+		uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz, int *done)
+{
+	uint32_t nn, nn_sz, l, l2, i;
+	int msb1, msb2, ok;
+	ip_ecc_command cmd;
+	/* Bits of k1 & k2 below their common msb position, in reverse order */
+	uint8_t k1r[IPECC_CURVE_MAX_SZ];
+	uint8_t k2r[IPECC_CURVE_MAX_SZ];
+
+	(*done) = 0;
+
+	nn = ip_ecc_get_nn_bit_size();
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(nn);
+
+	l = ip_ecc_bignum_bit_sz(k1, k1_sz);
+	l2 = ip_ecc_bignum_bit_sz(k2, k2_sz);
+	if(l2 > l){
+		l = l2;
+	}
+	if((l == 0) || (l > nn)){
+		return 0;
+	}
+	msb1 = ip_ecc_bignum_bit(k1, k1_sz, l - 1);
+	msb2 = ip_ecc_bignum_bit(k2, k2_sz, l - 1);
+	memset(k1r, 0, sizeof(k1r));
+	memset(k2r, 0, sizeof(k2r));
+	for(i = 0; (i + 1) < l; i++){
+		k1r[nn_sz - 1 - (i / 8)] |= (uint8_t)(ip_ecc_bignum_bit(k1, k1_sz, l - 2 - i) << (i % 8));
+		k2r[nn_sz - 1 - (i / 8)] |= (uint8_t)(ip_ecc_bignum_bit(k2, k2_sz, l - 2 - i) << (i % 8));
+	}
+	/* Sentinel bit which ends the loop of the IP */
+	k2r[nn_sz - 1 - ((l - 1) / 8)] |= (uint8_t)(1 << ((l - 1) % 8));
+
+	/* Both points must lie on the curve, as the [k]P command checks it for
+	 * its input point: (x2, y2) is checked in R0 and then moved to R1 */
+	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+	if(ip_ecc_set_r0_inf(0)){
+		goto err;
+	}
+	if(ip_ecc_exec_command(PT_CHK, &ok, NULL)){
+		goto err;
+	}
+	if(!ok){
+		log_print("In hw_driver_mul2(): point not on curve\n\r");
+		goto err;
+	}
+	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R1_Y)){
+		goto err;
+	}
+	if(x1 == NULL){
+		if(ip_ecc_write_bn(&ipecc_dev->base_point.x, EC_HW_REG_R0_X)){
+			goto err;
+		}
+		if(ip_ecc_write_bn(&ipecc_dev->base_point.y, EC_HW_REG_R0_Y)){
+			goto err;
+		}
+	}
+	else{
+		if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R0_X)){
+			goto err;
+		}
+		if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R0_Y)){
+			goto err;
+		}
+	}
+	if(ip_ecc_set_r0_inf(0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(0)){
+		goto err;
+	}
+	if(x1 != NULL){
+		if(ip_ecc_exec_command(PT_CHK, &ok, NULL)){
+			goto err;
+		}
+		if(!ok){
+			log_print("In hw_driver_mul2(): point not on curve\n\r");
+			goto err;
+		}
+	}
+	if(ip_ecc_exec_command(PT_KP2_LOAD, NULL, NULL)){
+		goto err;
+	}
+
+	/* Run the loop */
+	if(ip_ecc_write_bignum(k1r, nn_sz, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(k2r, nn_sz, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+	cmd = msb1 ? (msb2 ? PT_KP2_P12 : PT_KP2_P1) : PT_KP2_P2;
+	if(ip_ecc_exec_command(cmd, &ok, NULL)){
+		goto err;
+	}
+	if(!ok){
+		return 0;
+	}
+
+	/* Get back the result from R1 */
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
+	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+		goto err;
+	}
+	(*done) = 1;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Return (out_x, out_y) = k1 * (x1, y1) + k2 * (x2, y2), e.g the
+ * u1 * G + u2 * Q computation of an ECDSA or Schnorr verification.
+ *
+ * Passing x1 = y1 = NULL stands for the base point set by
+ * hw_driver_set_base_point() (then multiplied with the [k]G command
+ * if the IP stores it).
+ *
+ * Both scalars are handled as public values (verification): if the IP has
+ * the double scalar multiplication (register W_KP2) the result is computed
+ * in one pass, which is not constant time (see ip_ecc_mul2_kp2()).
+ *
+ * Otherwise, and in the cases this pass does not handle, both scalar
+ * multiplications are run back to back without leaving the driver: the
+ * inputs of the second one are converted while the first one runs, the
+ * first (masked) result is unmasked while the second one runs, and both
+ * are then summed by a PT_ADD command. As with hw_driver_add(), the
+ * infinity flag of R1 tells if the sum is the null point.
+ *
+ * All size arguments (*_sz) must be given in bytes.
+ */
+int hw_driver_mul2(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
+		   const uint8_t *k1, uint32_t k1_sz,
+		   const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
+		   const uint8_t *k2, uint32_t k2_sz,
+		   uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+{
+	int inf_r0, inf_r1, inf_kp1, inf_kp2;
+	uint32_t nn_sz, nb_limbs, sz;
+	ip_ecc_command cmd = PT_KP;
+	ip_ecc_limb k_limbs[IPECC_LIMBS_MAX_NB];
+	ip_ecc_limb x_limbs[IPECC_LIMBS_MAX_NB];
+	ip_ecc_limb y_limbs[IPECC_LIMBS_MAX_NB];
+	ip_ecc_limb rx_limbs[IPECC_LIMBS_MAX_NB];
+	ip_ecc_limb ry_limbs[IPECC_LIMBS_MAX_NB];
+	/* Unmasked result of the first scalar multiplication */
+	uint8_t rx[IPECC_CURVE_MAX_SZ];
+	uint8_t ry[IPECC_CURVE_MAX_SZ];
+	/* Tokens of the two scalar multiplications */
+	uint8_t token[2][IPECC_CURVE_MAX_SZ];
+	int done;
+
+	memset(token, 0, sizeof(token));
+
+	if(driver_enter()){
+		goto err;
+	}
+
+	if((x1 == NULL) != (y1 == NULL)){
+		goto err;
+	}
+	if((x1 == NULL) && (!ipecc_dev->base_point_valid)){
+		log_print("In hw_driver_mul2(): no base point set\n\r");
+		goto err;
+	}
+
+	/* Nb of bytes & of words corresponding to current value of 'nn' in the IP */
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	nb_limbs = ip_ecc_nn_limbs_nb();
+	if((nn_sz > IPECC_CURVE_MAX_SZ) || (nb_limbs > IPECC_LIMBS_MAX_NB)){
+		log_print("In hw_driver_mul2(): nn too large\n\r");
+		goto err;
+	}
+	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+		log_print("In hw_driver_mul2(): Error in sizes' comparison\n\r");
+		goto err;
+	}
+
+	/* Preserve our inf flags in a constant time fashion */
+	if(ip_ecc_get_r0_inf(&inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_r1)){
+		goto err;
+	}
+
+	if(ipecc_dev->shadow.kp2){
+		if(ip_ecc_mul2_kp2(x1, x1_sz, y1, y1_sz, k1, k1_sz, x2, x2_sz, y2, y2_sz,
+					k2, k2_sz, out_x, out_x_sz, out_y, out_y_sz, &done)){
+			goto err;
+		}
+		if(done){
+			driver_leave();
+			return 0;
+		}
+	}
+
+	/* First scalar multiplication: k1 * (x1, y1) */
+	if(ip_ecc_get_token(token[0], nn_sz)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(k1, k1_sz, EC_HW_REG_SCALAR)){
+		goto err;
+	}
+	if(x1 == NULL){
+		if(ipecc_dev->base_point_in_ip){
+			cmd = PT_KG;
+		}
+		else{
+			if(ip_ecc_write_bn(&ipecc_dev->base_point.x, EC_HW_REG_R1_X)){
+				goto err;
+			}
+			if(ip_ecc_write_bn(&ipecc_dev->base_point.y, EC_HW_REG_R1_Y)){
+				goto err;
+			}
+		}
+	}
+	else{
+		if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R1_X)){
+			goto err;
+		}
+		if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R1_Y)){
+			goto err;
+		}
+	}
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
+		goto err;
+	}
+	if(ip_ecc_start_command(cmd, NULL)){
+		goto err;
+	}
+
+	/* While the IP computes, convert the inputs of the second one */
+	if(ip_ecc_bignum_to_limbs(k2, k2_sz, k_limbs, nb_limbs)){
+		goto err;
+	}
+	if(ip_ecc_bignum_to_limbs(x2, x2_sz, x_limbs, nb_limbs)){
+		goto err;
+	}
+	if(ip_ecc_bignum_to_limbs(y2, y2_sz, y_limbs, nb_limbs)){
+		goto err;
+	}
+
+	/* Wait for the end of the first one and get its (still masked) result */
+	if(ip_ecc_end_command(PT_KP, NULL)){
+		goto err;
+	}
+	if(ip_ecc_read_limbs(rx_limbs, nb_limbs, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_read_limbs(ry_limbs, nb_limbs, EC_HW_REG_R1_Y)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_kp1)){
+		goto err;
+	}
+
+	/* Second scalar multiplication: k2 * (x2, y2) */
+	if(ip_ecc_get_token(token[1], nn_sz)){
+		goto err;
+	}
+	if(ip_ecc_write_limbs(k_limbs, nb_limbs, EC_HW_REG_SCALAR)){
+		goto err;
+	}
+	if(ip_ecc_write_limbs(x_limbs, nb_limbs, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_write_limbs(y_limbs, nb_limbs, EC_HW_REG_R1_Y)){
+		goto err;
+	}
+	if(ip_ecc_set_r0_inf(inf_r0)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_r1)){
+		goto err;
+	}
+	if(ip_ecc_start_command(PT_KP, NULL)){
+		goto err;
+	}
+
+	/* While the IP computes, unmask the result of the first one */
+	sz = sizeof(rx);
+	if(ip_ecc_kp_unmask_limbs(rx_limbs, nb_limbs, token[0], nn_sz, rx, &sz)){
+		goto err;
+	}
+	sz = sizeof(ry);
+	if(ip_ecc_kp_unmask_limbs(ry_limbs, nb_limbs, token[0], nn_sz, ry, &sz)){
+		goto err;
+	}
+
+	/* Wait for the end of the second one and unmask its result */
+	if(ip_ecc_end_command(PT_KP, NULL)){
+		goto err;
+	}
+	if(ip_ecc_read_limbs(rx_limbs, nb_limbs, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_read_limbs(ry_limbs, nb_limbs, EC_HW_REG_R1_Y)){
+		goto err;
+	}
+	if(ip_ecc_get_r1_inf(&inf_kp2)){
+		goto err;
+	}
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
+	if(ip_ecc_kp_unmask_limbs(rx_limbs, nb_limbs, token[1], nn_sz, out_x, out_x_sz)){
 		goto err;
 	}
+	if(ip_ecc_kp_unmask_limbs(ry_limbs, nb_limbs, token[1], nn_sz, out_y, out_y_sz)){
+		goto err;
+	}
+
+	/* Sum both results: R0 <- k1 * (x1, y1), R1 <- k2 * (x2, y2) */
+	if(ip_ecc_write_bignum(rx, nn_sz, EC_HW_REG_R0_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(ry, nn_sz, EC_HW_REG_R0_Y)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(out_x, nn_sz, EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_write_bignum(out_y, nn_sz, EC_HW_REG_R1_Y)){
+		goto err;
+	}
+	if(ip_ecc_set_r0_inf(inf_kp1)){
+		goto err;
+	}
+	if(ip_ecc_set_r1_inf(inf_kp2)){
+		goto err;
+	}
+	if(ip_ecc_exec_command(PT_ADD, NULL, NULL)){
+		goto err;
+	}
+
+	/* Get back the result from R1 */
+	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+		goto err;
+	}
+	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+		goto err;
+	}
+
+	/* Clear the tokens & the scalar */
+	ip_ecc_clear_token(token[0], sizeof(token[0]));
+	ip_ecc_clear_token(token[1], sizeof(token[1]));
+	memset(k_limbs, 0, sizeof(k_limbs));
+
+	driver_leave();
+	return 0;
+err:
+	ip_ecc_clear_token(token[0], sizeof(token[0]));
+	ip_ecc_clear_token(token[1], sizeof(token[1]));
+	memset(k_limbs, 0, sizeof(k_limbs));
+	driver_leave();
+	return -1;
+}
+
+/*
+ * Chains of point operations
+ *
+ * Each call to hw_driver_add() or hw_driver_dbl() leaves the Montgomery
+ * domain and inverts Z to return an affine result. When several point
+ * operations are chained (e.g to add up a list of points) the result
+ * of each one can instead be left in projective form in the IP (point
+ * R1, Co-Z Jacobian coordinates in Montgomery domain) and be used as
+ * is by the next one, so that only one inversion is performed, by
+ * hw_driver_proj_end().
+ *
+ * A chain starts with hw_driver_proj_start() and the accumulated point
+ * is then updated by hw_driver_proj_add() and hw_driver_proj_dbl().
+ * Any other call to the driver which uses point R1 of the IP (or changes
+ * the curve) in the middle of a chain breaks it (the next call to the
+ * chain then fails).
+ *
+ * The null point (which has no projective form in the IP) is handled
+ * by the driver, keeping the accumulated point in affine form. If the
+ * IP does not support projective point operations, the chain is computed
+ * with plain affine ones.
+ */
+
+/* Run PT_ADD_PROJ (or PT_DBL_PROJ) on point R1 of the IP, after it
+ * has been written with the accumulated point in affine form if
+ * needed. R0 must have been written beforehand (for an addition).
+ */
+static int ip_ecc_proj_exec(ip_ecc_command cmd)
+{
+	ip_ecc_proj_chain *ch = &ipecc_dev->proj;
+	int inf_r1;
+
+	if(ch->state == IPECC_PROJ_AFF){
+		/* Start the projective part of the chain from the affine point */
+		if(ip_ecc_write_bn(&ch->acc.x, EC_HW_REG_R1_X)){
+			goto err;
+		}
+		if(ip_ecc_write_bn(&ch->acc.y, EC_HW_REG_R1_Y)){
+			goto err;
+		}
+		if(ip_ecc_set_r1_inf(0)){
+			goto err;
+		}
+	}
+
+	if(ipecc_dev->shadow.proj){
+		if(ip_ecc_exec_command(cmd, NULL, NULL)){
+			goto err;
+		}
+		ch->state = IPECC_PROJ_IN_IP;
+	}
+	else if(cmd == PT_ADD_PROJ){
+		/* Plain affine addition, the result is read back below */
+		if(ip_ecc_exec_command(PT_ADD, NULL, NULL)){
+			goto err;
+		}
+	}
+	else{
+		/* Plain affine doubling (of R0), the result is read back below */
+		if(ip_ecc_write_bn(&ch->acc.x, EC_HW_REG_R0_X)){
+			goto err;
+		}
+		if(ip_ecc_write_bn(&ch->acc.y, EC_HW_REG_R0_Y)){
+			goto err;
+		}
+		if(ip_ecc_exec_command(PT_DBL, NULL, NULL)){
+			goto err;
+		}
+	}
 
-	/* Preserve our inf flags in a constant time fashion */
-	if(ip_ecc_get_r0_inf(&inf_r0)){
-		goto err;
-	}
+	/* Did the accumulated point become null? */
 	if(ip_ecc_get_r1_inf(&inf_r1)){
 		goto err;
 	}
-
-	/* Write our R0 register */
-	if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R0_X)){
-		goto err;
+	if(inf_r1){
+		ch->state = IPECC_PROJ_AFF;
+		ch->acc_inf = 1;
 	}
-	if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R0_Y)){
-		goto err;
+	else if(!ipecc_dev->shadow.proj){
+		ch->acc.x.nb = ch->acc.y.nb = ip_ecc_nn_limbs_nb();
+		if(ip_ecc_read_limbs(ch->acc.x.w, ch->acc.x.nb, EC_HW_REG_R1_X)){
+			goto err;
+		}
+		if(ip_ecc_read_limbs(ch->acc.y.w, ch->acc.y.nb, EC_HW_REG_R1_Y)){
+			goto err;
+		}
+		ch->state = IPECC_PROJ_AFF;
+		ch->acc_inf = 0;
 	}
-	/* Write our R1 register */
-	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R1_X)){
+
+	return 0;
+err:
+	ch->state = IPECC_PROJ_NONE;
+	return -1;
+}
+
+/* Is the accumulated point still resident in the IP? */
+static inline int ip_ecc_proj_check(void)
+{
+	if(ipecc_dev->proj.state == IPECC_PROJ_NONE){
 		goto err;
 	}
-	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R1_Y)){
-		goto err;
+	if(ipecc_dev->proj.state == IPECC_PROJ_IN_IP){
+		/* Wait until the IP is not busy */
+		IPECC_BUSY_WAIT();
+		if(!IPECC_IS_PROJ()){
+			/* R1 was overwritten in the middle of the chain */
+			goto err;
+		}
 	}
 
-	/* Restore our inf flags in a constant time fashion */
-	if(ip_ecc_set_r0_inf(inf_r0)){
-		goto err;
-	}
-	if(ip_ecc_set_r1_inf(inf_r1)){
+	return 0;
+err:
+	ipecc_dev->proj.state = IPECC_PROJ_NONE;
+	return -1;
+}
+
+/* Start a chain of point operations from the affine point (x, y) */
+int hw_driver_proj_start(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz)
+{
+	if(driver_enter()){
 		goto err;
 	}
 
-	/* Check if it the points are equal */
-	if(ip_ecc_exec_command(PT_EQU, is_eq, NULL)){
+	if(hw_driver_point_import(x, x_sz, y, y_sz, &ipecc_dev->proj.acc)){
 		goto err;
 	}
+	ipecc_dev->proj.acc_inf = 0;
+	ipecc_dev->proj.state = IPECC_PROJ_AFF;
 
+	driver_leave();
 	return 0;
 err:
+	ipecc_dev->proj.state = IPECC_PROJ_NONE;
+	driver_leave();
 	return -1;
 }
 
-/* Check if affine points (x1, y1) and (x2, y2) are opposite.
- *
- * All size arguments (*_sz) must be given in bytes.
- *
- * Please read and take into consideration the 'NOTE:' mentionned
- * at the top of the prototype file <hw_accelerator_driver.h>
- * about the formatting and size of large numbers.
- */
-int hw_driver_opp(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
-                  const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
-               	  int *is_opp)
+/* Add the affine point (x, y) to the accumulated point of the chain */
+int hw_driver_proj_add(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz)
 {
-	int inf_r0, inf_r1;
+	ip_ecc_proj_chain *ch;
 
-	if(driver_setup()){
+	if(driver_enter()){
 		goto err;
 	}
+	ch = &ipecc_dev->proj;
 
-	/* Preserve our inf flags in a constant time fashion */
-	if(ip_ecc_get_r0_inf(&inf_r0)){
-		goto err;
-	}
-	if(ip_ecc_get_r1_inf(&inf_r1)){
+	if(ip_ecc_proj_check()){
 		goto err;
 	}
 
-	/* Write our R0 register */
-	if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R0_X)){
-		goto err;
+	if((ch->state == IPECC_PROJ_AFF) && ch->acc_inf){
+		/* 0 + (x, y) = (x, y) */
+		if(hw_driver_point_import(x, x_sz, y, y_sz, &ch->acc)){
+			goto err;
+		}
+		ch->acc_inf = 0;
+		goto out;
 	}
-	if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R0_Y)){
+
+	/* Write our R0 register (this makes R0 not null) */
+	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R0_X)){
 		goto err;
 	}
-	/* Write our R1 register */
-	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R1_X)){
+	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R0_Y)){
 		goto err;
 	}
-	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R1_Y)){
+
+	if(ip_ecc_proj_exec(PT_ADD_PROJ)){
 		goto err;
 	}
 
-	/* Restore our inf flags in a constant time fashion */
-	if(ip_ecc_set_r0_inf(inf_r0)){
+out:
+	driver_leave();
+	return 0;
+err:
+	ipecc_dev->proj.state = IPECC_PROJ_NONE;
+	driver_leave();
+	return -1;
+}
+
+/* Double the accumulated point of the chain */
+int hw_driver_proj_dbl(void)
+{
+	ip_ecc_proj_chain *ch;
+
+	if(driver_enter()){
 		goto err;
 	}
-	if(ip_ecc_set_r1_inf(inf_r1)){
+	ch = &ipecc_dev->proj;
+
+	if(ip_ecc_proj_check()){
 		goto err;
 	}
 
+	if((ch->state == IPECC_PROJ_AFF) && ch->acc_inf){
+		/* [2]0 = 0 */
+		goto out;
+	}
 
-	/* Check if the points are opposite */
-	if(ip_ecc_exec_command(PT_OPP, is_opp, NULL)){
+	if(ip_ecc_proj_exec(PT_DBL_PROJ)){
 		goto err;
 	}
 
+out:
+	driver_leave();
 	return 0;
 err:
+	ipecc_dev->proj.state = IPECC_PROJ_NONE;
+	driver_leave();
 	return -1;
 }
 
-/* Check if the infinity point flag is set in the hardware for
- * point at index idx.
+/* End the chain of point operations: get back the accumulated point
+ * in affine form (the only inversion of the chain is performed here).
  *
- * Argument 'index' must be either 0, identifying point R0, or 1,
- * identifying point R1.
+ * If the accumulated point is null, *iszero is set to 1 and the content
+ * of out_x & out_y is meaningless.
  */
-int hw_driver_point_iszero(uint8_t idx, int *iszero)
+int hw_driver_proj_end(uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz,
+		       int *iszero)
 {
-	if(driver_setup()){
+	ip_ecc_proj_chain *ch;
+	uint32_t nn_sz;
+
+	if(driver_enter()){
 		goto err;
 	}
+	ch = &ipecc_dev->proj;
 
-	switch(idx){
-		case 0:{
-			/* Get our R0 register infinity flag */
-			if(ip_ecc_get_r0_inf(iszero)){
+	if(iszero == NULL){
+		goto err;
+	}
+	if(ip_ecc_proj_check()){
+		goto err;
+	}
+
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+		goto err;
+	}
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
+
+	if(ch->state == IPECC_PROJ_AFF){
+		(*iszero) = ch->acc_inf;
+		if(ch->acc_inf){
+			memset(out_x, 0, nn_sz);
+			memset(out_y, 0, nn_sz);
+		}
+		else{
+			if(hw_driver_bignum_export(&ch->acc.x, out_x, nn_sz)){
 				goto err;
 			}
-			break;
-		}
-		case 1:{
-			/* Get our R1 register infinity flag */
-			if(ip_ecc_get_r1_inf(iszero)){
+			if(hw_driver_bignum_export(&ch->acc.y, out_y, nn_sz)){
 				goto err;
 			}
-			break;
 		}
-		default:{
-			/* Index not supported */
+	}
+	else{
+		/* Convert R1 back to affine form and read it */
+		if(ip_ecc_exec_command(PT_NORM, NULL, NULL)){
+			goto err;
+		}
+		(*iszero) = 0;
+		if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+			goto err;
+		}
+		if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
 			goto err;
 		}
 	}
+	ch->state = IPECC_PROJ_NONE;
 
+	driver_leave();
 	return 0;
 err:
+	ipecc_dev->proj.state = IPECC_PROJ_NONE;
+	driver_leave();
 	return -1;
 }
 
-/* Set the infinity point flag in the hardware for point
- * at index idx. This tells hardware to hold the corresponding
- * point (R0 or R1) as being the null point (aka point at infinity).
+/*
+ * Resident points
  *
- * Any values of the affine coordinates the hardware was currently
- * holding for that point will become irrelevant, either they were
- * resulting from a previous computation or transmitted by software.
+ * Points used over and over (e.g the precomputed multiples of a
+ * public key, or the partial sums of a multi-point addition) can be
+ * kept in the IP, in its point slots, instead of being uploaded for
+ * each point operation and read back after it. A point is designated
+ * by a handle (the index of its slot). It is uploaded once by
+ * hw_driver_pt_load(), then the point operations on handles only
+ * involve copies between the slots and R0/R1 (performed by hardware,
+ * 2w cycles each) and the result is only read back when needed, by
+ * hw_driver_pt_store().
  *
- * Argument 'index' must be either 0, identifying point R0, or 1,
- * identifying point R1.
+ * Slot 0 holds the base point of the curve (see hw_driver_set_base_point())
+ * so valid handles are 1 to hw_driver_pt_nb_handles() - 1. The points are
+ * forgotten as soon as another curve is set (or upon a reset). Point
+ * operations on handles overwrite both R0 and R1 (hence break a chain
+ * of projective point operations, see hw_driver_proj_start()).
  */
-int hw_driver_point_zero(uint8_t idx)
+
+/* Is 'h' the handle of a point resident in the IP? */
+static inline int ip_ecc_pt_check(uint32_t h)
 {
-	if(driver_setup()){
+	if((h == 0) || (h >= ipecc_dev->shadow.pt_slots)){
 		goto err;
 	}
-
-	switch(idx){
-		case 0:{
-			/* Write our R0 register infinity flag */
-			if(ip_ecc_set_r0_inf(1)){
-				goto err;
-			}
-			break;
-		}
-		case 1:{
-			/* Write our R1 register infinity flag */
-			if(ip_ecc_set_r1_inf(1)){
-				goto err;
-			}
-			break;
-		}
-		default:{
-			/* Index not supported */
-			goto err;
-		}
+	if(!ipecc_dev->pt_slot_valid[h]){
+		goto err;
 	}
 
 	return 0;
@@ -4174,47 +9538,20 @@ err:
 	return -1;
 }
 
-/* Unset the infinity point flag in the hardware for
- * point at index idx. This tells hardware to hold the corresponding
- * point (R0 or R1) as NOT being the null point (aka point at infinity).
- *
- * The affine coordinates the hardware was currently holding for that
- * point will then become relevant, either they were resulting from a
- * previous computation or transmitted by software.
- *
- * Further note that transmitting coordinates to the hardware for one
- * of particular points R0 or R1 (using ip_ecc_write_bignum()) automatically
- * set that point as being not null, just as hw_driver_point_unzero()
- * would do.
- *
- * Argument 'index' must be either 0, identifying point R0, or 1,
- * identifying point R1.
- */
-int hw_driver_point_unzero(uint8_t idx)
+/* Copy the point of handle 'h' into R0 (if 'r0' is set) or into R1 */
+static inline int ip_ecc_pt_slot_load(uint32_t h, int r0)
 {
-	if(driver_setup()){
-		goto err;
-	}
+	/* Wait until the IP is not busy */
+	IPECC_BUSY_WAIT();
 
-	switch(idx){
-		case 0:{
-			/* Write our R0 register infinity flag */
-			if(ip_ecc_set_r0_inf(0)){
-				goto err;
-			}
-			break;
-		}
-		case 1:{
-			/* Write our R1 register infinity flag */
-			if(ip_ecc_set_r1_inf(0)){
-				goto err;
-			}
-			break;
-		}
-		default:{
-			/* Index not supported */
-			goto err;
-		}
+	IPECC_PT_SLOT_LOAD(h, r0);
+
+	/* Wait until the copy is over */
+	IPECC_BUSY_WAIT();
+
+	/* Check for error */
+	if(ip_ecc_check_error(NULL)){
+		goto err;
 	}
 
 	return 0;
@@ -4222,64 +9559,55 @@ err:
 	return -1;
 }
 
-/* Return (out_x, out_y) = -(x, y) i.e the opposite of the
- * intput point.
- *
- * All size arguments (*_sz) must be given in bytes.
- *
- * Please read and take into consideration the 'NOTE:' mentionned
- * at the top of the prototype file <hw_accelerator_driver.h>
- * about the formatting and size of large numbers.
- */
-int hw_driver_neg(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
-                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+/* Copy R1 into the slot of handle 'h' */
+static inline int ip_ecc_pt_slot_save(uint32_t h)
 {
-	int inf_r0, inf_r1;
-	uint32_t nn_sz;
+	ipecc_dev->pt_slot_valid[h] = 0;
 
-	if(driver_setup()){
-		goto err;
-	}
+	/* Wait until the IP is not busy */
+	IPECC_BUSY_WAIT();
 
-	/* Preserve our inf flags in a constant time fashion */
-	if(ip_ecc_get_r0_inf(&inf_r0)){
-		goto err;
-	}
-	if(ip_ecc_get_r1_inf(&inf_r1)){
-		goto err;
-	}
+	IPECC_PT_SLOT_SAVE(h);
 
-	/* Write our R0 register */
-	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R0_X)){
-		goto err;
-	}
-	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R0_Y)){
+	/* Wait until the copy is over */
+	IPECC_BUSY_WAIT();
+
+	/* Check for error */
+	if(ip_ecc_check_error(NULL)){
 		goto err;
 	}
+	ipecc_dev->pt_slot_valid[h] = 1;
 
-	/* Restore our inf flags in a constant time fashion */
-	if(ip_ecc_set_r0_inf(inf_r0)){
+	return 0;
+err:
+	return -1;
+}
+
+/* Run a point operation on handle 'h1' (R0) and possibly 'h2' (R1),
+ * with the result (R1) left in the slot of handle 'hout'
+ */
+static int ip_ecc_pt_exec(ip_ecc_command cmd, uint32_t h1, uint32_t h2, uint32_t hout)
+{
+	if(ip_ecc_pt_check(h1)){
 		goto err;
 	}
-	if(ip_ecc_set_r1_inf(inf_r1)){
+	if((cmd == PT_ADD) && ip_ecc_pt_check(h2)){
 		goto err;
 	}
-
-	/* Execute our NEG command */
-	if(ip_ecc_exec_command(PT_NEG, NULL, NULL)){
+	if((hout == 0) || (hout >= ipecc_dev->shadow.pt_slots)){
 		goto err;
 	}
-
-	/* Get back the result from R1 */
-	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
-	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+
+	if(ip_ecc_pt_slot_load(h1, 1)){
 		goto err;
 	}
-	(*out_x_sz) = (*out_y_sz) = nn_sz;
-	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+	if((cmd == PT_ADD) && ip_ecc_pt_slot_load(h2, 0)){
 		goto err;
 	}
-	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+	if(ip_ecc_exec_command(cmd, NULL, NULL)){
+		goto err;
+	}
+	if(ip_ecc_pt_slot_save(hout)){
 		goto err;
 	}
 
@@ -4288,266 +9616,425 @@ err:
 	return -1;
 }
 
-/* Return (out_x, out_y) = 2 * (x, y), i.e the double of the
- * input point.
- *
- * All size arguments (*_sz) must be given in bytes.
- *
- * Please read and take into consideration the 'NOTE:' mentionned
- * at the top of the prototype file <hw_accelerator_driver.h>
- * about the formatting and size of large numbers.
+/* Get the number of point handles the IP supports (0 if none, otherwise
+ * valid handles are 1 to (*nb) - 1)
  */
-int hw_driver_dbl(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
-                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+int hw_driver_pt_nb_handles(uint32_t *nb)
 {
-	int inf_r0, inf_r1;
-	uint32_t nn_sz;
-
-	if(driver_setup()){
+	if(driver_enter()){
 		goto err;
 	}
 
-	/* Preserve our inf flags in a constant time fashion */
-	if(ip_ecc_get_r0_inf(&inf_r0)){
+	if(nb == NULL){
 		goto err;
 	}
-	if(ip_ecc_get_r1_inf(&inf_r1)){
+	(*nb) = ipecc_dev->shadow.pt_slots;
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Upload the affine point (x, y) into the IP as the point of handle 'h'
+ * (R1 is left untouched)
+ */
+int hw_driver_pt_load(uint32_t h, const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz)
+{
+	if(driver_enter()){
 		goto err;
 	}
 
-	/* Write our R0 register */
-	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R0_X)){
+	if((h == 0) || (h >= ipecc_dev->shadow.pt_slots)){
 		goto err;
 	}
-	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R0_Y)){
-		goto err;
+	ipecc_dev->pt_slot_valid[h] = 0;
+
+	/* Wait until the IP is not busy */
+	IPECC_BUSY_WAIT();
+	IPECC_PT_SLOT_SELECT(h);
+	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_BP_X)){
+		goto err_sel;
 	}
+	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_BP_Y)){
+		goto err_sel;
+	}
+	/* Writes of the base point go to slot 0 again */
+	IPECC_BUSY_WAIT();
+	IPECC_PT_SLOT_SELECT(0);
+	ipecc_dev->pt_slot_valid[h] = 1;
 
-	/* Restore our inf flags in a constant time fashion */
-	if(ip_ecc_set_r0_inf(inf_r0)){
+	driver_leave();
+	return 0;
+err_sel:
+	IPECC_BUSY_WAIT();
+	IPECC_PT_SLOT_SELECT(0);
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Point of handle 'hout' = point of handle 'h1' + point of handle 'h2'
+ * ('hout' may be the same as 'h1' and/or 'h2')
+ */
+int hw_driver_pt_add(uint32_t h1, uint32_t h2, uint32_t hout)
+{
+	if(driver_enter()){
 		goto err;
 	}
-	if(ip_ecc_set_r1_inf(inf_r1)){
+
+	if(ip_ecc_pt_exec(PT_ADD, h1, h2, hout)){
 		goto err;
 	}
 
-	/* Execute our DBL command */
-	if(ip_ecc_exec_command(PT_DBL, NULL, NULL)){
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Point of handle 'hout' = 2 * point of handle 'h' */
+int hw_driver_pt_dbl(uint32_t h, uint32_t hout)
+{
+	if(driver_enter()){
 		goto err;
 	}
 
-	/* Get back the result from R1 */
-	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
-	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+	if(ip_ecc_pt_exec(PT_DBL, h, 0, hout)){
 		goto err;
 	}
-	(*out_x_sz) = (*out_y_sz) = nn_sz;
-	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Point of handle 'hout' = - point of handle 'h' */
+int hw_driver_pt_neg(uint32_t h, uint32_t hout)
+{
+	if(driver_enter()){
 		goto err;
 	}
-	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+
+	if(ip_ecc_pt_exec(PT_NEG, h, 0, hout)){
 		goto err;
 	}
 
+	driver_leave();
 	return 0;
 err:
+	driver_leave();
 	return -1;
 }
 
-
-/* Return (out_x, out_y) = (x1, y1) + (x2, y2), i.e perform addition
- * of the two input points.
- *
- * All size arguments (*_sz) must be given in bytes.
+/* Read back the point of handle 'h' in affine form.
  *
- * Please read and take into consideration the 'NOTE:' mentionned
- * at the top of the prototype file <hw_accelerator_driver.h>
- * about the formatting and size of large numbers.
+ * If the point is null, *iszero is set to 1 and the content
+ * of out_x & out_y is meaningless.
  */
-int hw_driver_add(const uint8_t *x1, uint32_t x1_sz, const uint8_t *y1, uint32_t y1_sz,
-                  const uint8_t *x2, uint32_t x2_sz, const uint8_t *y2, uint32_t y2_sz,
-                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz)
+int hw_driver_pt_store(uint32_t h, uint8_t *out_x, uint32_t *out_x_sz,
+		       uint8_t *out_y, uint32_t *out_y_sz, int *iszero)
 {
-	int inf_r0, inf_r1;
 	uint32_t nn_sz;
+	int inf_r1;
 
-	if(driver_setup()){
+	if(driver_enter()){
 		goto err;
 	}
 
-	/* Preserve our inf flags in a constant time fashion */
-	if(ip_ecc_get_r0_inf(&inf_r0)){
+	if(iszero == NULL){
 		goto err;
 	}
-	if(ip_ecc_get_r1_inf(&inf_r1)){
+	if(ip_ecc_pt_check(h)){
 		goto err;
 	}
 
-	/* Write our R0 register */
-	if(ip_ecc_write_bignum(x1, x1_sz, EC_HW_REG_R0_X)){
-		goto err;
-	}
-	if(ip_ecc_write_bignum(y1, y1_sz, EC_HW_REG_R0_Y)){
-		goto err;
-	}
-	/* Write our R1 register */
-	if(ip_ecc_write_bignum(x2, x2_sz, EC_HW_REG_R1_X)){
-		goto err;
-	}
-	if(ip_ecc_write_bignum(y2, y2_sz, EC_HW_REG_R1_Y)){
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
 		goto err;
 	}
+	(*out_x_sz) = (*out_y_sz) = nn_sz;
 
-	/* Restore our inf flags in a constant time fashion */
-	if(ip_ecc_set_r0_inf(inf_r0)){
+	if(ip_ecc_pt_slot_load(h, 1)){
 		goto err;
 	}
-	if(ip_ecc_set_r1_inf(inf_r1)){
+	if(ip_ecc_pt_slot_load(h, 0)){
 		goto err;
 	}
-
-	/* Execute our ADD command */
-	if(ip_ecc_exec_command(PT_ADD, NULL, NULL)){
+	/* The IP only lets large numbers be read back once a computation
+	 * was run since the last one written by software (which may be a
+	 * point loaded just before): run a harmless comparison to be sure.
+	 */
+	if(ip_ecc_exec_command(PT_EQU, NULL, NULL)){
 		goto err;
 	}
-
-	/* Get back the result from R1 */
-	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
-	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
+	if(ip_ecc_get_r1_inf(&inf_r1)){
 		goto err;
 	}
-	(*out_x_sz) = (*out_y_sz) = nn_sz;
-	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
-		goto err;
+	(*iszero) = inf_r1;
+	if(inf_r1){
+		memset(out_x, 0, nn_sz);
+		memset(out_y, 0, nn_sz);
 	}
-	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
-		goto err;
+	else{
+		if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
+			goto err;
+		}
+		if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
+			goto err;
+		}
 	}
 
+	driver_leave();
 	return 0;
 err:
+	driver_leave();
 	return -1;
 }
 
-/* Return (out_x, out_y) = scalar * (x, y), i.e perform the scalar 
- * multiplication of the input point by the input scalar.
+/*
+ * Arithmetic modulo the order 'q' of the curve
  *
- * All size arguments (*_sz) must be given in bytes.
+ * For these operations the driver writes 'q' of the resident curve in
+ * place of 'p' (the IP then computes the Montgomery constants of 'q' by
+ * itself) and leaves it there, so that a sequence of operations modulo
+ * 'q' (e.g the scalar side of an ECDSA signature) pays for it only once.
+ * The next call to the driver using the curve sets it back (see
+ * driver_enter()).
  *
- * Please read and take into consideration the 'NOTE:' mentionned
- * at the top of the prototype file <hw_accelerator_driver.h>
- * about the formatting and size of large numbers.
+ * The curve must have been set with its order, and its parameters
+ * be known to the driver (see ip_ecc_curve_fill()). Operands and result
+ * are always in normal form.
  */
-int hw_driver_mul(const uint8_t *x, uint32_t x_sz, const uint8_t *y, uint32_t y_sz,
-                  const uint8_t *scalar, uint32_t scalar_sz,
-                  uint8_t *out_x, uint32_t *out_x_sz, uint8_t *out_y, uint32_t *out_y_sz,
-									kp_trace_info_t* ktrc)
+static int ip_ecc_fq_exec(ip_ecc_command cmd, const uint8_t *a, uint32_t a_sz,
+			  const uint8_t *b, uint32_t b_sz, uint8_t *out, uint32_t *out_sz)
 {
-	int inf_r0, inf_r1;
-	uint32_t nn_sz;
-
-	/* 32768 bits are more than enough for any practical
-	 * use of elliptic curve cryptography.
-	 */
-	uint8_t token[4096] = {0, }; /* Heck, a whole page? Yes indeed. */
-
-	if(driver_setup()){
-		log_print("In hw_driver_mul(): Error in driver_setup()\n\r");
+	if(driver_enter_fq()){
 		goto err;
 	}
 
-	/* Nb of bytes corresponding to current value of 'nn' in the IP.
-	 */
-	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
-
-	/* Check that the current value of 'nn' does not exceed the size
-	 * allocated to the token on the stack.
-	 */
-	if(ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size()) > 4096){
-		log_print("In hw_driver_mul(): Error in ip_ecc_nn_bytes_from_bits_sz()\n\r");
+	if(ip_ecc_fp_exec(cmd, a, a_sz, b, b_sz, out, out_sz)){
 		goto err;
 	}
 
-	/* Preserve our inf flags in a constant time fashion */
-	if(ip_ecc_get_r0_inf(&inf_r0)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_get_r0_inf()\n\r");
-		goto err;
-	}
-	if(ip_ecc_get_r1_inf(&inf_r1)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_get_r1_inf()\n\r");
-		goto err;
-	}
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
 
-	/* Get the random one-shot token */
-	if (ip_ecc_get_token(token, nn_sz)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_get_token()\n\r");
-		goto err;
-	}
+/* out = a * b mod q */
+int hw_driver_fq_mul(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
+		     uint8_t *out, uint32_t *out_sz)
+{
+	return ip_ecc_fq_exec(FP_MUL, a, a_sz, b, b_sz, out, out_sz);
+}
 
-	/* Write our scalar register with the scalar k */
-	if(ip_ecc_write_bignum(scalar, scalar_sz, EC_HW_REG_SCALAR)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_write_bignum()\n\r");
+/* out = a + b mod q */
+int hw_driver_fq_add(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
+		     uint8_t *out, uint32_t *out_sz)
+{
+	return ip_ecc_fq_exec(FP_ADD, a, a_sz, b, b_sz, out, out_sz);
+}
+
+/* out = a - b mod q */
+int hw_driver_fq_sub(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
+		     uint8_t *out, uint32_t *out_sz)
+{
+	return ip_ecc_fq_exec(FP_SUB, a, a_sz, b, b_sz, out, out_sz);
+}
+
+/* out = a^-1 mod q (a must not be 0) */
+int hw_driver_fq_inv(const uint8_t *a, uint32_t a_sz, uint8_t *out, uint32_t *out_sz)
+{
+	return ip_ecc_fq_exec(FP_INV, a, a_sz, NULL, 0, out, out_sz);
+}
+
+/*
+ * Arithmetic modulo the prime 'p' of the curve
+ *
+ * By default operands and result are in normal form. Software chaining
+ * many operations can instead have them in Montgomery form (i.e x.R mod p
+ * for x, R being a power of 2 only known to the IP): the conversions are
+ * then only made once, at both ends of the chain (see
+ * hw_driver_fp_to_montgomery() and hw_driver_fp_from_montgomery()).
+ * Additions and subtractions are the same in both forms, and the exponent
+ * of hw_driver_fp_exp() is always in normal form.
+ */
+static int ip_ecc_fp_op(ip_ecc_command cmd, const uint8_t *a, uint32_t a_sz,
+			const uint8_t *b, uint32_t b_sz, uint8_t *out, uint32_t *out_sz)
+{
+	if(driver_enter()){
 		goto err;
 	}
-	/* Write our R1 register with the point to be multiplied */
-	if(ip_ecc_write_bignum(x, x_sz, EC_HW_REG_R1_X)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_write_bignum()\n\r");
+
+	if(a == NULL){
 		goto err;
 	}
-	if(ip_ecc_write_bignum(y, y_sz, EC_HW_REG_R1_Y)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_write_bignum()\n\r");
+	if(ip_ecc_fp_is_binary(cmd) && (b == NULL)){
 		goto err;
 	}
 
-	/* Restore our inf flags in a constant time fashion */
-	if(ip_ecc_set_r0_inf(inf_r0)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_set_r0_inf()\n\r");
+	if(ip_ecc_fp_exec(cmd, a, a_sz, b, b_sz, out, out_sz)){
 		goto err;
 	}
-	if(ip_ecc_set_r1_inf(inf_r1)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_set_r1_inf()\n\r");
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* out = a * b mod p */
+int hw_driver_fp_mul(const uint8_t *a, uint32_t a_sz, const uint8_t *b, uint32_t b_sz,
+		     uint8_t *out, uint32_t *out_sz)
+{
+	return ip_ecc_fp_op(FP_MUL, a, a_sz, b, b_sz, out, out_sz);
+}
+
+/* out = a^2 mod p */
+int hw_driver_fp_sqr(const uint8_t *a, uint32_t a_sz, uint8_t *out, uint32_t *out_sz)
+{
+	return ip_ecc_fp_op(FP_SQR, a, a_sz, NULL, 0, out, out_sz);
+}
+
+/* out = a^-1 mod p (0 if a = 0) */
+int hw_driver_fp_inv(const uint8_t *a, uint32_t a_sz, uint8_t *out, uint32_t *out_sz)
+{
+	return ip_ecc_fp_op(FP_INV, a, a_sz, NULL, 0, out, out_sz);
+}
+
+/* out = a^e mod p
+ *
+ * The computation time depends on the exponent, which must hence
+ * be public (e.g (p - 1) / 2 for a Legendre symbol, or (p + 1) / 4
+ * for a square root).
+ */
+int hw_driver_fp_exp(const uint8_t *a, uint32_t a_sz, const uint8_t *e, uint32_t e_sz,
+		     uint8_t *out, uint32_t *out_sz)
+{
+	return ip_ecc_fp_op(FP_EXP, a, a_sz, e, e_sz, out, out_sz);
+}
+
+/* out = a.R mod p (conversion to Montgomery form) */
+int hw_driver_fp_to_montgomery(const uint8_t *a, uint32_t a_sz, uint8_t *out, uint32_t *out_sz)
+{
+	return ip_ecc_fp_op(FP_MTY, a, a_sz, NULL, 0, out, out_sz);
+}
+
+/* out = a / R mod p (conversion from Montgomery form) */
+int hw_driver_fp_from_montgomery(const uint8_t *a, uint32_t a_sz, uint8_t *out, uint32_t *out_sz)
+{
+	return ip_ecc_fp_op(FP_NOMTY, a, a_sz, NULL, 0, out, out_sz);
+}
+
+/* Have the operands and results of the arithmetic modulo 'p'
+ * in Montgomery form */
+int hw_driver_fp_enable_montgomery(void)
+{
+	if(driver_enter()){
 		goto err;
 	}
 
-	/* Execute our [k]P command */
-	if(ip_ecc_exec_command(PT_KP, NULL, ktrc)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_exec_command()\n\r");
+	ipecc_dev->fp_mty = 1;
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Have the operands and results of the arithmetic modulo 'p'
+ * in normal form (the default) */
+int hw_driver_fp_disable_montgomery(void)
+{
+	if(driver_enter()){
 		goto err;
 	}
 
-	/* Get back the result from R1 */
-	if(((*out_x_sz) < nn_sz) || ((*out_y_sz) < nn_sz)){
-		log_print("In hw_driver_mul(): *out_x_sz = %d\n\r", *out_x_sz);
-		log_print("In hw_driver_mul(): *out_y_sz = %d\n\r", *out_y_sz);
-		log_print("In hw_driver_mul(): nn_sz = %d\n\r", nn_sz);
-		log_print("In hw_driver_mul(): Error in sizes' comparison\n\r");
+	ipecc_dev->fp_mty = 0;
+
+	driver_leave();
+	return 0;
+err:
+	driver_leave();
+	return -1;
+}
+
+/* Perform a batch of 'nb' operations 'cmd' modulo p (one of FP_ADD, FP_SUB,
+ * FP_MUL, FP_SQR, FP_INV, FP_EXP, FP_MTY or FP_NOMTY):
+ * out[i].out = in[i].a op in[i].b
+ *
+ * Compared to 'nb' calls to the corresponding hw_driver_fp_*() function,
+ * the driver setup and the checks of the current value of 'nn' are only
+ * made once, and an operand is only transferred to the IP if it differs
+ * from the one of the previous operation: consecutive operations sharing
+ * an operand (i.e the same pointer and size, which must not be the output
+ * of the previous operation), e.g the multiplications of a vector by the
+ * same number, or exponentiations with the same exponent, find it already
+ * in the memory of the IP.
+ *
+ * Sizes of output buffers are given in out[i].out_sz (in bytes) and are
+ * updated as with hw_driver_fp_mul(). If an error occurs, the whole batch
+ * is aborted (results of operations already computed are then valid).
+ */
+int hw_driver_fp_batch(ip_ecc_command cmd, const hw_driver_fp_input *in,
+		       hw_driver_fp_output *out, uint32_t nb)
+{
+	uint32_t i, nn_sz;
+	const uint8_t *a, *b;
+
+	if(driver_enter()){
 		goto err;
 	}
-	(*out_x_sz) = (*out_y_sz) = nn_sz;
-	if(ip_ecc_read_bignum(out_x, (*out_x_sz), EC_HW_REG_R1_X)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_read_bignum()\n\r");
+
+	if((in == NULL) || (out == NULL)){
 		goto err;
 	}
-	if(ip_ecc_read_bignum(out_y, (*out_y_sz), EC_HW_REG_R1_Y)){
-		log_print("In hw_driver_mul(): Error in ip_ecc_read_bignum()\n\r");
+	if(!ip_ecc_fp_is_command(cmd)){
 		goto err;
 	}
 
-	/* Unmask the [k]P result coordinates with the one-shot token */
-	if (ip_ecc_unmask_with_token(out_x, (*out_x_sz), token, nn_sz, out_x, out_x_sz)) {
-		log_print("In hw_driver_mul(): Error in ip_ecc_unmask_with_token()\n\r");
-		goto err;
+	/* Check all the inputs & output buffers before starting anything */
+	nn_sz = ip_ecc_nn_bytes_from_bits_sz(ip_ecc_get_nn_bit_size());
+	for(i = 0; i < nb; i++){
+		if((in[i].a == NULL) || (ip_ecc_fp_is_binary(cmd) && (in[i].b == NULL))
+				|| (out[i].out == NULL) || (out[i].out_sz < nn_sz)){
+			log_print("In hw_driver_fp_batch(): Error in sizes' comparison (op %d)\n\r", i);
+			goto err;
+		}
 	}
-	if (ip_ecc_unmask_with_token(out_y, (*out_y_sz), token, nn_sz, out_y, out_y_sz)) {
-		log_print("In hw_driver_mul(): Error in ip_ecc_unmask_with_token()\n\r");
-		goto err;
-	};
 
-	/* Clear the token */
-	ip_ecc_clear_token(token, nn_sz);
+	for(i = 0; i < nb; i++){
+		/* Operands already in the IP are not transferred again */
+		a = in[i].a;
+		b = in[i].b;
+		if(i > 0){
+			if((a == in[i - 1].a) && (in[i].a_sz == in[i - 1].a_sz)
+					&& (a != out[i - 1].out)){
+				a = NULL;
+			}
+			if((b == in[i - 1].b) && (in[i].b_sz == in[i - 1].b_sz)
+					&& (b != out[i - 1].out)){
+				b = NULL;
+			}
+		}
+		if(ip_ecc_fp_exec(cmd, a, in[i].a_sz, b, in[i].b_sz, out[i].out, &out[i].out_sz)){
+			goto err;
+		}
+	}
 
+	driver_leave();
 	return 0;
 err:
+	driver_leave();
 	return -1;
 }
 
@@ -4568,7 +10055,7 @@ err:
  * */
 int hw_driver_set_small_scalar_size(uint32_t bit_sz)
 {
-	if(driver_setup()){
+	if(driver_enter()){
 		goto err;
 	}
 
@@ -4577,8 +10064,10 @@ int hw_driver_set_small_scalar_size(uint32_t bit_sz)
 	 * so on). So no need to sanity check anything here. */
 	IPECC_SET_SMALL_SCALAR_SIZE(bit_sz);
 
+	driver_leave();
 	return 0;
 err:
+	driver_leave();
 	return -1;
 }
 
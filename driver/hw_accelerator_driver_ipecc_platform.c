@@ -17,7 +17,7 @@
 
 #include <stdint.h>
 
-#if defined(WITH_EC_HW_ACCELERATOR) && !defined(WITH_EC_HW_SOCKET_EMUL)
+#if defined(WITH_EC_HW_ACCELERATOR) && !defined(WITH_EC_HW_SOCKET_EMUL) && !defined(WITH_EC_HW_REGMODEL)
 
 /* The IP "physical" address in RAM.
  *
@@ -41,7 +41,48 @@
 
 #define IPECC_DEV_UIO_IPECC             "/dev/uio0"
 #define IPECC_DEV_UIO_PSEUDOTRNG        "/dev/uio1"
-/* Setup the driver depending on the environment.
+
+/* When several ECC IPs are instantiated in the design, the lists below
+ * give the physical address (standalone & /dev/mem modes) and the UIO
+ * device (UIO mode) of each of them, the first one being the IP of
+ * index 0 for the driver. Their definition can be overriden at compile
+ * time (e.g '-DIPECC_PHYS_BADDR_LIST="{ 0x40000000, 0x40010000 }"').
+ *
+ * By default only one IP is declared.
+ */
+#ifndef IPECC_PHYS_BADDR_LIST
+#define IPECC_PHYS_BADDR_LIST           { IPECC_PHYS_BADDR }
+#endif
+#ifndef IPECC_DEV_UIO_IPECC_LIST
+#define IPECC_DEV_UIO_IPECC_LIST        { IPECC_DEV_UIO_IPECC }
+#endif
+
+#if defined(WITH_EC_HW_STANDALONE) || defined(WITH_EC_HW_DEVMEM)
+static const uintptr_t ipecc_phys_baddr[] = IPECC_PHYS_BADDR_LIST;
+#define IPECC_NB_DEVICES    (sizeof(ipecc_phys_baddr) / sizeof(ipecc_phys_baddr[0]))
+#elif defined(WITH_EC_HW_UIO)
+static const char *ipecc_dev_uio[] = IPECC_DEV_UIO_IPECC_LIST;
+#define IPECC_NB_DEVICES    (sizeof(ipecc_dev_uio) / sizeof(ipecc_dev_uio[0]))
+#endif
+
+#if defined(WITH_EC_HW_UIO)
+/* File descriptors of the UIO devices of the ECC IPs.
+ *
+ * They are kept open after the setup so that the driver can use them
+ * to wait for the interrupt raised by the IPs (see hw_driver_irq_arm()
+ * and hw_driver_irq_wait() below).
+ */
+static int ipecc_uio_fd[IPECC_NB_DEVICES];
+static uint8_t ipecc_uio_fd_valid[IPECC_NB_DEVICES];
+#endif
+
+/* Number of ECC IPs declared on the platform */
+uint32_t hw_driver_nb_devices(void)
+{
+	return (uint32_t)IPECC_NB_DEVICES;
+}
+
+/* Setup the driver depending on the environment, for the ECC IP of index 'dev'.
  *
  * If 'pseudotrng_base_addr_p' is not NULL then the setup will also try
  * to open a device for the pseudo TRNG function, and return the mapped
@@ -55,8 +96,10 @@
  * TRNG function naturally does NOT exist and, in case the value passed for
  * parameter 'pseudotrng_base_addr_p' is not NULL, then *pseudotrng_base_addr_p
  * will be set with value NULL.
+ *
+ * (The pseudo TRNG function is only handled along with the IP of index 0).
  */
-int hw_driver_setup(volatile uint8_t **base_addr_p, volatile uint8_t **pseudotrng_base_addr_p)
+int hw_driver_setup_dev(uint32_t dev, volatile uint8_t **base_addr_p, volatile uint8_t **pseudotrng_base_addr_p)
 {
 	int ret = -1;
 
@@ -64,13 +107,20 @@ int hw_driver_setup(volatile uint8_t **base_addr_p, volatile uint8_t **pseudotrn
 		ret = -1;
 		goto err;
 	}
+	if (dev >= IPECC_NB_DEVICES) {
+		ret = -1;
+		goto err;
+	}
+	if (dev != 0) {
+		pseudotrng_base_addr_p = NULL;
+	}
 #if defined(WITH_EC_HW_STANDALONE)
 	{
 		log_print("hw_driver_setup in standalone mode\n\r");
 		/* In standalone mode, the base address
 		 * is the physical one.
 		 */
-		(*base_addr_p)	     = (volatile uint8_t*)IPECC_PHYS_BADDR;
+		(*base_addr_p)	     = (volatile uint8_t*)ipecc_phys_baddr[dev];
 		if (pseudotrng_base_addr_p != NULL) {
 			(*pseudotrng_base_addr_p) = (volatile uint8_t*)IPECC_PHYS_PSEUDO_TRNG_BADDR;
 		}
@@ -86,9 +136,9 @@ int hw_driver_setup(volatile uint8_t **base_addr_p, volatile uint8_t **pseudotrn
 		/* Open our UIO device
 		 * NOTE: O_SYNC here to avoid caching
 		 */
-		uio_fd0 = open(IPECC_DEV_UIO_IPECC, O_RDWR | O_SYNC);
+		uio_fd0 = open(ipecc_dev_uio[dev], O_RDWR | O_SYNC);
 		if(uio_fd0 == -1){
-			printf("Error when opening %s\n\r", IPECC_DEV_UIO_IPECC);
+			printf("Error when opening %s\n\r", ipecc_dev_uio[dev]);
 			perror("open uio");
 			ret = -1;
 			goto err;
@@ -102,6 +152,8 @@ int hw_driver_setup(volatile uint8_t **base_addr_p, volatile uint8_t **pseudotrn
 			goto err;
 		}
 		(*base_addr_p) = base_address;
+		ipecc_uio_fd[dev] = uio_fd0;
+		ipecc_uio_fd_valid[dev] = 1;
 
 		if (pseudotrng_base_addr_p != NULL) {
 
@@ -150,7 +202,7 @@ int hw_driver_setup(volatile uint8_t **base_addr_p, volatile uint8_t **pseudotrn
 		}
 		devmem_size = IPECC_PHYS_SZ;
 		/* Map the main ECC IP */
-		base_address = mmap(NULL, devmem_size, PROT_READ | PROT_WRITE, MAP_SHARED, devmem_fd, IPECC_PHYS_BADDR);
+		base_address = mmap(NULL, devmem_size, PROT_READ | PROT_WRITE, MAP_SHARED, devmem_fd, ipecc_phys_baddr[dev]);
 		if(base_address == MAP_FAILED){
 			printf("Error during ECC IP mmap!\n\r");
 			perror("mmap devmem ECC IP");
@@ -194,6 +246,133 @@ err:
 	return ret;
 }
 
+/* Setup the driver for the (first) ECC IP */
+int hw_driver_setup(volatile uint8_t **base_addr_p, volatile uint8_t **pseudotrng_base_addr_p)
+{
+	return hw_driver_setup_dev(0, base_addr_p, pseudotrng_base_addr_p);
+}
+
+#if defined(WITH_EC_HW_UIO)
+/* (Re-)enable the interrupt line of the IP of index 'dev' in the UIO framework.
+ *
+ * The UIO generic IRQ handler masks the interrupt line each time
+ * it fires, so this must be called before each wait on the
+ * interrupt (see hw_driver_irq_wait() below). This is done by
+ * writing a 32-bit value of 1 to the UIO device.
+ */
+int hw_driver_irq_arm(uint32_t dev)
+{
+	uint32_t one = 1;
+
+	if ((dev >= IPECC_NB_DEVICES) || (!ipecc_uio_fd_valid[dev])) {
+		goto err;
+	}
+	if (write(ipecc_uio_fd[dev], &one, sizeof(one)) != (ssize_t)sizeof(one)) {
+		perror("write uio");
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Block until the interrupt of the IP of index 'dev' has been received.
+ *
+ * A read on the UIO device sleeps until the interrupt count of the
+ * device has changed since the last read, and then returns the new
+ * count (which we do not need here).
+ */
+int hw_driver_irq_wait(uint32_t dev)
+{
+	uint32_t count;
+
+	if ((dev >= IPECC_NB_DEVICES) || (!ipecc_uio_fd_valid[dev])) {
+		goto err;
+	}
+	if (read(ipecc_uio_fd[dev], &count, sizeof(count)) != (ssize_t)sizeof(count)) {
+		perror("read uio");
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Read one value (in hexadecimal) from a sysfs attribute of a UIO map */
+static int hw_driver_uio_map_attr(const char *uio, const char *attr, unsigned long long *val)
+{
+	char path[128];
+	FILE *f;
+	int ret = -1;
+
+	snprintf(path, sizeof(path), "/sys/class/uio/%s/maps/map1/%s", uio, attr);
+	f = fopen(path, "r");
+	if (f == NULL) {
+		printf("Error when opening %s\n\r", path);
+		goto err;
+	}
+	if (fscanf(f, "%llx", val) != 1) {
+		printf("Error when reading %s\n\r", path);
+		goto err;
+	}
+
+	ret = 0;
+err:
+	if (f != NULL) {
+		fclose(f);
+	}
+	return ret;
+}
+
+/* Map the memory shared with the DMA ring of the IP of index 'dev'.
+ *
+ * This memory must be physically contiguous and reachable by the AXI4
+ * master port of the IP. It is expected to be the second memory region
+ * (map1) of the UIO device of the IP, e.g a reserved-memory region given
+ * as a second 'reg' entry in its device-tree node: its physical address
+ * and its size are read from sysfs, and it is mapped through the UIO
+ * device (at offset 1 * page size, as UIO requires).
+ */
+int hw_driver_dma_map(uint32_t dev, uint8_t **virt_p, uint64_t *phys_p, uint32_t *sz_p)
+{
+	const char *uio;
+	unsigned long long addr, sz;
+	void *virt;
+
+	if ((dev >= IPECC_NB_DEVICES) || (!ipecc_uio_fd_valid[dev])) {
+		goto err;
+	}
+	uio = strrchr(ipecc_dev_uio[dev], '/');
+	uio = (uio == NULL) ? ipecc_dev_uio[dev] : (uio + 1);
+	if (hw_driver_uio_map_attr(uio, "addr", &addr)) {
+		goto err;
+	}
+	if (hw_driver_uio_map_attr(uio, "size", &sz)) {
+		goto err;
+	}
+	if ((sz == 0) || (sz > 0xffffffffULL)) {
+		goto err;
+	}
+	virt = mmap(NULL, (size_t)sz, PROT_READ | PROT_WRITE, MAP_SHARED, ipecc_uio_fd[dev],
+			1 * getpagesize());
+	if (virt == MAP_FAILED) {
+		printf("Error during mmap of DMA memory!\n\r");
+		perror("mmap uio");
+		goto err;
+	}
+	(*virt_p) = virt;
+	(*phys_p) = (uint64_t)addr;
+	(*sz_p) = (uint32_t)sz;
+	log_print("OK, mapped DMA memory @%p (phys 0x%llx, %llu bytes)\n\r", virt, addr, sz);
+
+	return 0;
+err:
+	return -1;
+}
+#endif /* WITH_EC_HW_UIO */
+
 #else
 /*
  * Dummy definition to avoid the empty translation unit ISO C warning
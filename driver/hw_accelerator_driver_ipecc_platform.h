@@ -27,17 +27,17 @@
  * UIO, etc.) this may change. Anyhow, the relative mapping of the registers should
  * remain fixed once this base address is known.
  */
-#if defined(WITH_EC_HW_STANDALONE) && (defined(WITH_EC_HW_UIO) || defined(WITH_EC_HW_DEVMEM))
-#error "WITH_EC_HW_STANDALONE, WITH_EC_HW_UIO and WITH_EC_HW_DEVMEM are mutually exclusive!"
+#if defined(WITH_EC_HW_STANDALONE) && (defined(WITH_EC_HW_UIO) || defined(WITH_EC_HW_DEVMEM) || defined(WITH_EC_HW_REGMODEL))
+#error "WITH_EC_HW_STANDALONE, WITH_EC_HW_UIO, WITH_EC_HW_DEVMEM and WITH_EC_HW_REGMODEL are mutually exclusive!"
 #endif
-#if defined(WITH_EC_HW_UIO) && (defined(WITH_EC_HW_STANDALONE) || defined(WITH_EC_HW_DEVMEM))
-#error "WITH_EC_HW_STANDALONE, WITH_EC_HW_UIO and WITH_EC_HW_DEVMEM are mutually exclusive!"
+#if defined(WITH_EC_HW_UIO) && (defined(WITH_EC_HW_STANDALONE) || defined(WITH_EC_HW_DEVMEM) || defined(WITH_EC_HW_REGMODEL))
+#error "WITH_EC_HW_STANDALONE, WITH_EC_HW_UIO, WITH_EC_HW_DEVMEM and WITH_EC_HW_REGMODEL are mutually exclusive!"
 #endif
-#if defined(WITH_EC_HW_DEVMEM) && (defined(WITH_EC_HW_UIO) || defined(WITH_EC_HW_STANDALONE))
-#error "WITH_EC_HW_STANDALONE, WITH_EC_HW_UIO and WITH_EC_HW_DEVMEM are mutually exclusive!"
+#if defined(WITH_EC_HW_DEVMEM) && (defined(WITH_EC_HW_UIO) || defined(WITH_EC_HW_STANDALONE) || defined(WITH_EC_HW_REGMODEL))
+#error "WITH_EC_HW_STANDALONE, WITH_EC_HW_UIO, WITH_EC_HW_DEVMEM and WITH_EC_HW_REGMODEL are mutually exclusive!"
 #endif
-#if !defined(WITH_EC_HW_STANDALONE) && !defined(WITH_EC_HW_UIO) && !defined(WITH_EC_HW_DEVMEM)
-#error "One of WITH_EC_HW_STANDALONE, WITH_EC_HW_UIO or WITH_EC_HW_DEVMEM must be set for the driver!"
+#if !defined(WITH_EC_HW_STANDALONE) && !defined(WITH_EC_HW_UIO) && !defined(WITH_EC_HW_DEVMEM) && !defined(WITH_EC_HW_REGMODEL)
+#error "One of WITH_EC_HW_STANDALONE, WITH_EC_HW_UIO, WITH_EC_HW_DEVMEM or WITH_EC_HW_REGMODEL must be set for the driver!"
 #endif
 
 #if defined(WITH_EC_HW_UIO) || defined(WITH_EC_HW_DEVMEM)    
@@ -46,10 +46,11 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 #endif
 
-#if defined(WITH_EC_HW_STANDALONE)
+#if defined(WITH_EC_HW_STANDALONE) || defined(WITH_EC_HW_REGMODEL)
 #include <stddef.h>
 #endif
 
@@ -73,6 +74,54 @@
  */
 int hw_driver_setup(volatile uint8_t **base_addr_p, volatile uint8_t **pseudotrng_base_addr_p);
 
+/* Same as hw_driver_setup(), for the ECC IP of index 'dev'
+ * (when several IPs are instantiated in the design).
+ */
+int hw_driver_setup_dev(uint32_t dev, volatile uint8_t **base_addr_p, volatile uint8_t **pseudotrng_base_addr_p);
+
+/* Number of ECC IPs declared on the platform */
+uint32_t hw_driver_nb_devices(void);
+
+#if defined(WITH_EC_HW_UIO) || defined(WITH_EC_HW_REGMODEL)
+/* Interrupt handling on the platform (only available with UIO,
+ * which allows to sleep on the interrupt line of the IP, and emulated
+ * by the register model of the IP).
+ */
+/* (Re-)enable the interrupt line of the IP of index 'dev' */
+int hw_driver_irq_arm(uint32_t dev);
+
+/* Block until the IP of index 'dev' raises its interrupt */
+int hw_driver_irq_wait(uint32_t dev);
+#endif
+
+#if defined(WITH_EC_HW_UIO)
+
+/* Map the memory shared with the DMA ring of the IP of index 'dev' */
+int hw_driver_dma_map(uint32_t dev, uint8_t **virt_p, uint64_t *phys_p, uint32_t *sz_p);
+#endif
+
+#if defined(WITH_EC_HW_REGMODEL)
+/* Register model of the IP (see hw_accelerator_driver_regmodel.c), to run
+ * the driver on a host without any hardware: the driver accesses the
+ * registers of the emulated IPs through the two functions below.
+ */
+uint32_t hw_driver_regmodel_get(volatile void *reg);
+void hw_driver_regmodel_set(volatile void *reg, uint32_t val);
+
+/* Hooks for tests: force the BUSY bit of the IP of index 'dev' (1) or let it
+ * follow the model (0), report error 'err' (bits of field ERRID of R_STATUS)
+ * until called again with 0, and get the nb of [k]P computations started.
+ * Make the next 'nb' sleeps on the interrupt of the IP return while it is
+ * still busy (spurious wake-ups), and get the nb of times the CPU was woken
+ * up by the interrupt.
+ */
+void hw_driver_regmodel_force_busy(uint32_t dev, uint32_t busy);
+void hw_driver_regmodel_force_error(uint32_t dev, uint32_t err);
+uint32_t hw_driver_regmodel_nb_kp(uint32_t dev);
+void hw_driver_regmodel_spurious_irq(uint32_t dev, uint32_t nb);
+uint32_t hw_driver_regmodel_nb_irq_wakes(uint32_t dev);
+#endif
+
 #endif /* WITH_EC_HW_ACCELERATOR */
 
 #endif /* __HW_ACCELERATOR_DRIVER_PLATFORM_H__ */
@@ -0,0 +1,328 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+#include "hw_accelerator_driver_ipecc_platform.h"
+
+#include <stdint.h>
+
+#if defined(WITH_EC_HW_ACCELERATOR) && !defined(WITH_EC_HW_SOCKET_EMUL) && defined(WITH_EC_HW_REGMODEL)
+/**************************************************************************/
+/********************** REGISTER MODEL ************************************/
+/**************************************************************************/
+
+/* Register model of the IP, selected at build time with WITH_EC_HW_REGMODEL
+ * (in place of WITH_EC_HW_STANDALONE, WITH_EC_HW_UIO or WITH_EC_HW_DEVMEM).
+ *
+ * It emulates IPECC_REGMODEL_NB_DEVICES instances of the IP at the level of
+ * their registers only: no computation is done (large numbers read back are
+ * all 0), but the BUSY bit, the status of a [k]P computation and the error
+ * field of R_STATUS behave like those of the hardware. This is enough to run
+ * on a host the parts of the driver that don't depend on actual results
+ * (e.g the scheduling of jobs on several IPs, see hw_driver_schedule()).
+ *
+ * The interrupt line of each IP is emulated as UIO exposes it (see
+ * hw_driver_irq_arm() & hw_driver_irq_wait()), so that the interrupt mode
+ * of the driver (HW_DRIVER_COMPLETION_IRQ) can be run as well.
+ */
+#ifndef IPECC_REGMODEL_NB_DEVICES
+#define IPECC_REGMODEL_NB_DEVICES	4
+#endif
+
+/* Value of 'nn' reported in R_CAPABILITIES */
+#ifndef IPECC_REGMODEL_NN_MAX
+#define IPECC_REGMODEL_NN_MAX		528
+#endif
+
+/* Nb of reads of R_STATUS a [k]P computation lasts (unless the CPU sleeps
+ * on the interrupt of the IP, the end of the computation being then
+ * signaled by the interrupt, see hw_driver_irq_wait()) */
+#define IPECC_REGMODEL_KP_READS		4
+#define IPECC_REGMODEL_KP_READS_IRQ	64
+
+/* Size of the register window of one IP (in bytes) */
+#define IPECC_REGMODEL_WINDOW		0x200
+
+/* Register offsets & fields used by the model (see the driver) */
+#define REGMODEL_W_CTRL			0x000
+#define REGMODEL_W_PRIME_SIZE		0x020
+#define REGMODEL_W_IRQ			0x048
+#define REGMODEL_W_ERR_ACK		0x050
+#define REGMODEL_W_SOFT_RESET		0x060
+#define REGMODEL_R_STATUS		0x000
+#define REGMODEL_R_CAPABILITIES		0x010
+#define REGMODEL_R_HW_VERSION		0x018
+#define REGMODEL_R_PRIME_SIZE		0x020
+
+#define REGMODEL_CTRL_PT_KP		(((uint32_t)0x1) << 0)
+#define REGMODEL_IRQ_EN			(((uint32_t)0x1) << 0)
+#define REGMODEL_STATUS_BUSY		(((uint32_t)0x1) << 0)
+#define REGMODEL_STATUS_KP		(((uint32_t)0x1) << 4)
+#define REGMODEL_STATUS_ERRID_POS	(16)
+#define REGMODEL_CAP_NNMAX_POS		(12)
+
+typedef struct {
+	/* Register window (only its address is used) */
+	uint64_t win[IPECC_REGMODEL_WINDOW / sizeof(uint64_t)];
+	uint32_t nn;
+	uint32_t err;
+	/* Nb of reads of R_STATUS until the end of the [k]P in progress */
+	uint32_t kp_left;
+	uint32_t nb_kp;
+	/* Interrupt: enabled in the IP (W_IRQ), line armed (UIO) & nb of
+	 * times the CPU was woken up by it */
+	uint32_t irq_en;
+	uint32_t irq_armed;
+	uint32_t nb_irq_wakes;
+	/* Hooks for tests */
+	uint32_t force_busy;
+	uint32_t force_err;
+	uint32_t spurious_wakes;
+} regmodel_ip;
+
+static regmodel_ip regmodel[IPECC_REGMODEL_NB_DEVICES];
+
+/* Find the IP & the offset of register 'reg' */
+static regmodel_ip *regmodel_decode(volatile void *reg, uint32_t *off)
+{
+	uint32_t i;
+	uintptr_t a = (uintptr_t)reg;
+
+	for(i = 0; i < IPECC_REGMODEL_NB_DEVICES; i++){
+		if((a >= (uintptr_t)regmodel[i].win) &&
+				(a < ((uintptr_t)regmodel[i].win + IPECC_REGMODEL_WINDOW))){
+			(*off) = (uint32_t)(a - (uintptr_t)regmodel[i].win);
+			return &regmodel[i];
+		}
+	}
+	log_print("In regmodel_decode(): access out of any IP (%p)\n\r", (volatile void*)reg);
+
+	return NULL;
+}
+
+uint32_t hw_driver_regmodel_get(volatile void *reg)
+{
+	regmodel_ip *ip;
+	uint32_t off, val = 0;
+
+	ip = regmodel_decode(reg, &off);
+	if(ip == NULL){
+		return 0;
+	}
+	switch(off){
+		case REGMODEL_R_STATUS:{
+			if(ip->kp_left){
+				ip->kp_left--;
+				val |= REGMODEL_STATUS_BUSY | REGMODEL_STATUS_KP;
+			}
+			if(ip->force_busy){
+				val |= REGMODEL_STATUS_BUSY;
+			}
+			val |= (ip->err | ip->force_err) << REGMODEL_STATUS_ERRID_POS;
+			break;
+		}
+		case REGMODEL_R_CAPABILITIES:{
+			val = ((uint32_t)IPECC_REGMODEL_NN_MAX) << REGMODEL_CAP_NNMAX_POS;
+			break;
+		}
+		case REGMODEL_R_HW_VERSION:{
+			val = 0x01000000;
+			break;
+		}
+		case REGMODEL_R_PRIME_SIZE:{
+			val = ip->nn;
+			break;
+		}
+		default:{
+			/* Large numbers & other registers read as 0 */
+			break;
+		}
+	}
+
+	return val;
+}
+
+void hw_driver_regmodel_set(volatile void *reg, uint32_t val)
+{
+	regmodel_ip *ip;
+	uint32_t off;
+
+	ip = regmodel_decode(reg, &off);
+	if(ip == NULL){
+		return;
+	}
+	switch(off){
+		case REGMODEL_W_CTRL:{
+			if(val & REGMODEL_CTRL_PT_KP){
+				ip->kp_left = ip->irq_en ? IPECC_REGMODEL_KP_READS_IRQ : IPECC_REGMODEL_KP_READS;
+				ip->nb_kp++;
+			}
+			break;
+		}
+		case REGMODEL_W_IRQ:{
+			ip->irq_en = val & REGMODEL_IRQ_EN;
+			break;
+		}
+		case REGMODEL_W_PRIME_SIZE:{
+			ip->nn = val;
+			break;
+		}
+		case REGMODEL_W_ERR_ACK:{
+			ip->err &= ~val;
+			break;
+		}
+		case REGMODEL_W_SOFT_RESET:{
+			ip->nn = IPECC_REGMODEL_NN_MAX;
+			ip->err = 0;
+			ip->kp_left = 0;
+			ip->irq_en = 0;
+			break;
+		}
+		default:{
+			/* Other writes are absorbed */
+			break;
+		}
+	}
+
+	return;
+}
+
+void hw_driver_regmodel_force_busy(uint32_t dev, uint32_t busy)
+{
+	if(dev < IPECC_REGMODEL_NB_DEVICES){
+		regmodel[dev].force_busy = busy;
+	}
+
+	return;
+}
+
+void hw_driver_regmodel_force_error(uint32_t dev, uint32_t err)
+{
+	if(dev < IPECC_REGMODEL_NB_DEVICES){
+		regmodel[dev].force_err = err;
+	}
+
+	return;
+}
+
+uint32_t hw_driver_regmodel_nb_kp(uint32_t dev)
+{
+	if(dev < IPECC_REGMODEL_NB_DEVICES){
+		return regmodel[dev].nb_kp;
+	}
+
+	return 0;
+}
+
+void hw_driver_regmodel_spurious_irq(uint32_t dev, uint32_t nb)
+{
+	if(dev < IPECC_REGMODEL_NB_DEVICES){
+		regmodel[dev].spurious_wakes = nb;
+	}
+
+	return;
+}
+
+uint32_t hw_driver_regmodel_nb_irq_wakes(uint32_t dev)
+{
+	if(dev < IPECC_REGMODEL_NB_DEVICES){
+		return regmodel[dev].nb_irq_wakes;
+	}
+
+	return 0;
+}
+
+/* (Re-)enable the interrupt line of the emulated IP of index 'dev' */
+int hw_driver_irq_arm(uint32_t dev)
+{
+	if(dev >= IPECC_REGMODEL_NB_DEVICES){
+		goto err;
+	}
+	regmodel[dev].irq_armed = 1;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Sleep on the interrupt line of the emulated IP of index 'dev'.
+ *
+ * The line must have been armed and the interrupt enabled in the IP,
+ * otherwise the CPU would sleep forever. The [k]P in progress ends while
+ * the CPU sleeps, and its end wakes it up, unless a spurious wake-up was
+ * asked for by hw_driver_regmodel_spurious_irq(): the CPU is then woken
+ * up with the IP still busy (as by an interrupt of an earlier operation
+ * already counted by UIO).
+ */
+int hw_driver_irq_wait(uint32_t dev)
+{
+	regmodel_ip *ip;
+
+	if(dev >= IPECC_REGMODEL_NB_DEVICES){
+		goto err;
+	}
+	ip = &regmodel[dev];
+	if(!ip->irq_armed || !ip->irq_en){
+		log_print("In hw_driver_irq_wait(): interrupt %s, would sleep forever\n\r",
+				ip->irq_armed ? "not enabled in the IP" : "line not armed");
+		goto err;
+	}
+	ip->irq_armed = 0;
+	ip->nb_irq_wakes++;
+	if(ip->spurious_wakes){
+		ip->spurious_wakes--;
+	}
+	else{
+		ip->kp_left = 0;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Number of ECC IPs emulated */
+uint32_t hw_driver_nb_devices(void)
+{
+	return (uint32_t)IPECC_REGMODEL_NB_DEVICES;
+}
+
+/* Setup of the emulated IP of index 'dev' (no pseudo TRNG) */
+int hw_driver_setup_dev(uint32_t dev, volatile uint8_t **base_addr_p, volatile uint8_t **pseudotrng_base_addr_p)
+{
+	if((base_addr_p == NULL) || (dev >= IPECC_REGMODEL_NB_DEVICES)){
+		goto err;
+	}
+	(*base_addr_p) = (volatile uint8_t*)regmodel[dev].win;
+	regmodel[dev].nn = IPECC_REGMODEL_NN_MAX;
+	if(pseudotrng_base_addr_p != NULL){
+		(*pseudotrng_base_addr_p) = NULL;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+int hw_driver_setup(volatile uint8_t **base_addr_p, volatile uint8_t **pseudotrng_base_addr_p)
+{
+	return hw_driver_setup_dev(0, base_addr_p, pseudotrng_base_addr_p);
+}
+
+#else
+/*
+ * Dummy definition to avoid the empty translation unit ISO C warning
+ */
+typedef int dummy;
+#endif /* WITH_EC_HW_ACCELERATOR && WITH_EC_HW_REGMODEL */
@@ -0,0 +1,545 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Small benchmark of the driver.
+ *
+ * Measures the throughput (in bytes/s) of the transfer of large numbers
+ * between the CPU and the IP, with the limb-by-limb transfer mode and
+ * with the streaming one (if the IP supports it).
+ *
+ * Only the transfers are timed (hw_driver_bench_transfer(), a loop of
+ * writes, then of reads, of 256-bit large numbers, the size of curve
+ * P-256), no computation of the IP being included in the measure.
+ *
+ * Then measures the throughput (in jobs/s) of scalar multiplications
+ * on the same base point, with a loop of hw_driver_mul() calls, with
+ * hw_driver_mul_batch(), with hw_driver_mul_batch_dma() (if the IP has
+ * the DMA ring), with a loop of hw_driver_mul_base() calls
+ * (the base point being set once by hw_driver_set_base_point()), and
+ * of double scalar multiplications [k1]G + [k2]P with hw_driver_mul2().
+ *
+ * Finally measures the time to add up the points so obtained, with a
+ * loop of hw_driver_add() calls (one inversion per addition) and with
+ * a chain of projective operations (hw_driver_proj_*(), one inversion
+ * in all) and with points resident in the IP (hw_driver_pt_*(), the
+ * partial sum never being read back).
+ */
+
+#include "../hw_accelerator_driver.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+/* Benchmark of the transfer of large numbers alone: 'nb' writes (if 'write'
+ * is set) or reads of a large number of the current size nn into/from point
+ * R1 of the IP, in the transfer mode in use (the content of R0 and R1 is
+ * lost). The nb of bytes transferred is returned in 'nb_bytes'.
+ *
+ * Not part of the API of the driver (hw_accelerator_driver.h): it is only
+ * compiled in hw_accelerator_driver_ipecc.c with WITH_EC_HW_BENCH defined.
+ */
+int hw_driver_bench_transfer(int write, uint32_t nb, uint32_t *nb_bytes);
+
+#define BENCH_NB_ITER    10000
+#define BENCH_NB_JOBS    64
+
+/* Curve P-256 (FIPS 186-4) */
+static const uint8_t p256_p[] = {
+	0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+static const uint8_t p256_a[] = {
+	0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfc,
+};
+static const uint8_t p256_b[] = {
+	0x5a, 0xc6, 0x35, 0xd8, 0xaa, 0x3a, 0x93, 0xe7, 0xb3, 0xeb, 0xbd, 0x55, 0x76, 0x98, 0x86, 0xbc,
+	0x65, 0x1d, 0x06, 0xb0, 0xcc, 0x53, 0xb0, 0xf6, 0x3b, 0xce, 0x3c, 0x3e, 0x27, 0xd2, 0x60, 0x4b,
+};
+static const uint8_t p256_q[] = {
+	0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xbc, 0xe6, 0xfa, 0xad, 0xa7, 0x17, 0x9e, 0x84, 0xf3, 0xb9, 0xca, 0xc2, 0xfc, 0x63, 0x25, 0x51,
+};
+static const uint8_t p256_gx[] = {
+	0x6b, 0x17, 0xd1, 0xf2, 0xe1, 0x2c, 0x42, 0x47, 0xf8, 0xbc, 0xe6, 0xe5, 0x63, 0xa4, 0x40, 0xf2,
+	0x77, 0x03, 0x7d, 0x81, 0x2d, 0xeb, 0x33, 0xa0, 0xf4, 0xa1, 0x39, 0x45, 0xd8, 0x98, 0xc2, 0x96,
+};
+static const uint8_t p256_gy[] = {
+	0x4f, 0xe3, 0x42, 0xe2, 0xfe, 0x1a, 0x7f, 0x9b, 0x8e, 0xe7, 0xeb, 0x4a, 0x7c, 0x0f, 0x9e, 0x16,
+	0x2b, 0xce, 0x33, 0x57, 0x6b, 0x31, 0x5e, 0xce, 0xcb, 0xb6, 0x40, 0x68, 0x37, 0xbf, 0x51, 0xf5,
+};
+
+static double bench_elapsed(const struct timespec *start, const struct timespec *stop)
+{
+	return (double)(stop->tv_sec - start->tv_sec)
+		+ ((double)(stop->tv_nsec - start->tv_nsec) / 1e9);
+}
+
+/* Time BENCH_NB_ITER writes (if 'write' is set) or reads of a large
+ * number of the current size nn and print the throughput of the transfer.
+ */
+static int bench_transfer(const char *mode, int write)
+{
+	struct timespec start, stop;
+	uint32_t nb_bytes;
+	double t;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &start)) {
+		goto err;
+	}
+	if (hw_driver_bench_transfer(write, BENCH_NB_ITER, &nb_bytes)) {
+		printf("%sError: hw_driver_bench_transfer() triggered an error.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	if (clock_gettime(CLOCK_MONOTONIC, &stop)) {
+		goto err;
+	}
+	t = bench_elapsed(&start, &stop);
+	printf("%-12s: %u %s in %.3f s, %.0f bytes/s (%.2f us/number)\n\r", mode, BENCH_NB_ITER,
+			write ? "writes" : "reads", t, (double)nb_bytes / t,
+			(t * 1e6) / (double)BENCH_NB_ITER);
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Throughput of writes and reads of large numbers in the transfer mode set */
+static int bench_transfers(const char *mode)
+{
+	if (bench_transfer(mode, 1)) {
+		goto err;
+	}
+	if (bench_transfer(mode, 0)) {
+		goto err;
+	}
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Scalars, points and results of the scalar multiplications */
+static uint8_t bench_k[BENCH_NB_JOBS][32];
+static uint8_t bench_rx[BENCH_NB_JOBS][32];
+static uint8_t bench_ry[BENCH_NB_JOBS][32];
+static hw_driver_mul_input bench_in[BENCH_NB_JOBS];
+static hw_driver_mul_dma_input bench_dma_in[BENCH_NB_JOBS];
+static hw_driver_mul_output bench_out[BENCH_NB_JOBS];
+
+static void bench_mul_init(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < BENCH_NB_JOBS; i++) {
+		/* Arbitrary (non null & lower than q) scalars */
+		memset(bench_k[i], 0x5a, sizeof(bench_k[i]));
+		bench_k[i][0] = 0x11;
+		bench_k[i][31] = (uint8_t)(i + 1);
+		bench_in[i].x = p256_gx;
+		bench_in[i].x_sz = sizeof(p256_gx);
+		bench_in[i].y = p256_gy;
+		bench_in[i].y_sz = sizeof(p256_gy);
+		bench_in[i].scalar = bench_k[i];
+		bench_in[i].scalar_sz = sizeof(bench_k[i]);
+		/* Same jobs through the DMA ring, on the curve set by main() */
+		bench_dma_in[i].curve = HW_DRIVER_CURVE_CURRENT;
+		bench_dma_in[i].mul = bench_in[i];
+	}
+}
+
+static void bench_mul_reset_outputs(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < BENCH_NB_JOBS; i++) {
+		bench_out[i].x = bench_rx[i];
+		bench_out[i].x_sz = sizeof(bench_rx[i]);
+		bench_out[i].y = bench_ry[i];
+		bench_out[i].y_sz = sizeof(bench_ry[i]);
+	}
+}
+
+/* Time BENCH_NB_JOBS scalar multiplications, either with a loop of
+ * hw_driver_mul() calls (batch = 0), with one call to hw_driver_mul_batch()
+ * (batch = 1) or with one call to hw_driver_mul_batch_dma() (batch = 2).
+ */
+static int bench_mul(int batch)
+{
+	struct timespec start, stop;
+	uint32_t i, dma;
+	double t;
+
+	if (batch == 2) {
+		if (hw_driver_is_dma_supported(&dma)) {
+			printf("%sError: hw_driver_is_dma_supported() triggered an error.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+		if (!dma) {
+			printf("%-12s: DMA ring not supported by hardware\n\r", "batch dma");
+			return 0;
+		}
+	}
+	bench_mul_reset_outputs();
+	if (clock_gettime(CLOCK_MONOTONIC, &start)) {
+		goto err;
+	}
+	if (batch == 2) {
+		if (hw_driver_mul_batch_dma(bench_dma_in, bench_out, BENCH_NB_JOBS)) {
+			printf("%sError: hw_driver_mul_batch_dma() triggered an error.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+	} else if (batch) {
+		if (hw_driver_mul_batch(bench_in, bench_out, BENCH_NB_JOBS)) {
+			printf("%sError: hw_driver_mul_batch() triggered an error.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+	} else {
+		for (i = 0; i < BENCH_NB_JOBS; i++) {
+			if (hw_driver_mul(bench_in[i].x, bench_in[i].x_sz, bench_in[i].y, bench_in[i].y_sz,
+						bench_in[i].scalar, bench_in[i].scalar_sz,
+						bench_out[i].x, &bench_out[i].x_sz, bench_out[i].y, &bench_out[i].y_sz, NULL)) {
+				printf("%sError: hw_driver_mul() triggered an error.%s\n\r", KERR, KNRM);
+				goto err;
+			}
+		}
+	}
+	if (clock_gettime(CLOCK_MONOTONIC, &stop)) {
+		goto err;
+	}
+	t = bench_elapsed(&start, &stop);
+	printf("%-12s: %u [k]P in %.3f s, %.1f jobs/s\n\r",
+			(batch == 2) ? "batch dma" : (batch ? "batch" : "loop"),
+			BENCH_NB_JOBS, t, (double)BENCH_NB_JOBS / t);
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Time BENCH_NB_JOBS scalar multiplications of the base point set by
+ * hw_driver_set_base_point().
+ */
+static int bench_mul_base(void)
+{
+	struct timespec start, stop;
+	uint32_t i;
+	double t;
+
+	bench_mul_reset_outputs();
+	if (hw_driver_set_base_point(p256_gx, sizeof(p256_gx), p256_gy, sizeof(p256_gy))) {
+		printf("%sError: hw_driver_set_base_point() triggered an error.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	if (clock_gettime(CLOCK_MONOTONIC, &start)) {
+		goto err;
+	}
+	for (i = 0; i < BENCH_NB_JOBS; i++) {
+		if (hw_driver_mul_base(bench_in[i].scalar, bench_in[i].scalar_sz,
+					bench_out[i].x, &bench_out[i].x_sz, bench_out[i].y, &bench_out[i].y_sz)) {
+			printf("%sError: hw_driver_mul_base() triggered an error.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+	}
+	if (clock_gettime(CLOCK_MONOTONIC, &stop)) {
+		goto err;
+	}
+	t = bench_elapsed(&start, &stop);
+	printf("%-12s: %u [k]G in %.3f s, %.1f jobs/s\n\r", "base point",
+			BENCH_NB_JOBS, t, (double)BENCH_NB_JOBS / t);
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Time BENCH_NB_JOBS double scalar multiplications (as in an ECDSA
+ * verification), the first point being the base point set by
+ * hw_driver_set_base_point().
+ */
+static int bench_mul2(void)
+{
+	struct timespec start, stop;
+	uint32_t i;
+	double t;
+
+	bench_mul_reset_outputs();
+	if (clock_gettime(CLOCK_MONOTONIC, &start)) {
+		goto err;
+	}
+	for (i = 0; i < BENCH_NB_JOBS; i++) {
+		if (hw_driver_mul2(NULL, 0, NULL, 0, bench_in[i].scalar, bench_in[i].scalar_sz,
+					bench_in[i].x, bench_in[i].x_sz, bench_in[i].y, bench_in[i].y_sz,
+					bench_in[(i + 1) % BENCH_NB_JOBS].scalar, bench_in[(i + 1) % BENCH_NB_JOBS].scalar_sz,
+					bench_out[i].x, &bench_out[i].x_sz, bench_out[i].y, &bench_out[i].y_sz)) {
+			printf("%sError: hw_driver_mul2() triggered an error.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+	}
+	if (clock_gettime(CLOCK_MONOTONIC, &stop)) {
+		goto err;
+	}
+	t = bench_elapsed(&start, &stop);
+	printf("%-12s: %u [k1]G+[k2]P in %.3f s, %.1f jobs/s\n\r", "double",
+			BENCH_NB_JOBS, t, (double)BENCH_NB_JOBS / t);
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Time the sum of the BENCH_NB_JOBS points left in bench_out[], either
+ * with hw_driver_add() or with a chain of projective point additions.
+ */
+static int bench_sum(int proj, uint8_t sx[32], uint8_t sy[32])
+{
+	struct timespec start, stop;
+	uint32_t i, sx_sz, sy_sz;
+	int iszero = 0;
+	double t;
+
+	memcpy(sx, bench_out[0].x, 32);
+	memcpy(sy, bench_out[0].y, 32);
+	if (clock_gettime(CLOCK_MONOTONIC, &start)) {
+		goto err;
+	}
+	if (proj) {
+		if (hw_driver_proj_start(sx, 32, sy, 32)) {
+			printf("%sError: hw_driver_proj_start() triggered an error.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+	}
+	for (i = 1; i < BENCH_NB_JOBS; i++) {
+		sx_sz = sy_sz = 32;
+		if (proj) {
+			if (hw_driver_proj_add(bench_out[i].x, bench_out[i].x_sz,
+						bench_out[i].y, bench_out[i].y_sz)) {
+				printf("%sError: hw_driver_proj_add() triggered an error.%s\n\r", KERR, KNRM);
+				goto err;
+			}
+		} else if (hw_driver_add(bench_out[i].x, bench_out[i].x_sz, bench_out[i].y, bench_out[i].y_sz,
+					sx, 32, sy, 32, sx, &sx_sz, sy, &sy_sz)) {
+			printf("%sError: hw_driver_add() triggered an error.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+	}
+	if (proj) {
+		sx_sz = sy_sz = 32;
+		if (hw_driver_proj_end(sx, &sx_sz, sy, &sy_sz, &iszero)) {
+			printf("%sError: hw_driver_proj_end() triggered an error.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+	}
+	if (clock_gettime(CLOCK_MONOTONIC, &stop)) {
+		goto err;
+	}
+	t = bench_elapsed(&start, &stop);
+	printf("%-12s: sum of %u points in %.3f s, %.1f adds/s\n\r", proj ? "sum (proj)" : "sum (affine)",
+			BENCH_NB_JOBS, t, (double)(BENCH_NB_JOBS - 1) / t);
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Time the sum of the BENCH_NB_JOBS points left in bench_out[], the
+ * partial sum staying resident in the IP (handle 1), each point being
+ * loaded in turn (handle 2). Returns 1 if not supported by hardware.
+ */
+static int bench_sum_resident(uint8_t sx[32], uint8_t sy[32])
+{
+	struct timespec start, stop;
+	uint32_t i, nb, sx_sz, sy_sz;
+	int iszero = 0;
+	double t;
+
+	if (hw_driver_pt_nb_handles(&nb) || (nb < 3)) {
+		printf("Resident points not supported by hardware\n\r");
+		return 1;
+	}
+	if (clock_gettime(CLOCK_MONOTONIC, &start)) {
+		goto err;
+	}
+	if (hw_driver_pt_load(1, bench_out[0].x, bench_out[0].x_sz, bench_out[0].y, bench_out[0].y_sz)) {
+		printf("%sError: hw_driver_pt_load() triggered an error.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	for (i = 1; i < BENCH_NB_JOBS; i++) {
+		if (hw_driver_pt_load(2, bench_out[i].x, bench_out[i].x_sz, bench_out[i].y, bench_out[i].y_sz)) {
+			printf("%sError: hw_driver_pt_load() triggered an error.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+		if (hw_driver_pt_add(1, 2, 1)) {
+			printf("%sError: hw_driver_pt_add() triggered an error.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+	}
+	sx_sz = sy_sz = 32;
+	if (hw_driver_pt_store(1, sx, &sx_sz, sy, &sy_sz, &iszero)) {
+		printf("%sError: hw_driver_pt_store() triggered an error.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	if (clock_gettime(CLOCK_MONOTONIC, &stop)) {
+		goto err;
+	}
+	t = bench_elapsed(&start, &stop);
+	printf("%-12s: sum of %u points in %.3f s, %.1f adds/s\n\r", "sum (handles)",
+			BENCH_NB_JOBS, t, (double)(BENCH_NB_JOBS - 1) / t);
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Time the multiplications modulo p of the x-coordinates of the points
+ * left in bench_out[] by Gx, either one call at a time or in one batch
+ * (where Gx is only transferred once) */
+static uint8_t bench_fp_r[BENCH_NB_JOBS][32];
+
+static int bench_fp_mul(int batch)
+{
+	struct timespec start, stop;
+	hw_driver_fp_input in[BENCH_NB_JOBS];
+	hw_driver_fp_output out[BENCH_NB_JOBS];
+	uint32_t i;
+	double t;
+
+	for (i = 0; i < BENCH_NB_JOBS; i++) {
+		in[i].a = bench_out[i].x;
+		in[i].a_sz = bench_out[i].x_sz;
+		in[i].b = p256_gx;
+		in[i].b_sz = sizeof(p256_gx);
+		out[i].out = batch ? bench_fp_r[i] : bench_rx[i];
+		out[i].out_sz = 32;
+	}
+	if (clock_gettime(CLOCK_MONOTONIC, &start)) {
+		goto err;
+	}
+	if (batch) {
+		if (hw_driver_fp_batch(FP_MUL, in, out, BENCH_NB_JOBS)) {
+			printf("%sError: hw_driver_fp_batch() triggered an error.%s\n\r", KERR, KNRM);
+			goto err;
+		}
+	} else {
+		for (i = 0; i < BENCH_NB_JOBS; i++) {
+			if (hw_driver_fp_mul(in[i].a, in[i].a_sz, in[i].b, in[i].b_sz,
+						out[i].out, &out[i].out_sz)) {
+				printf("%sError: hw_driver_fp_mul() triggered an error.%s\n\r", KERR, KNRM);
+				goto err;
+			}
+		}
+	}
+	if (clock_gettime(CLOCK_MONOTONIC, &stop)) {
+		goto err;
+	}
+	t = bench_elapsed(&start, &stop);
+	printf("%-12s: %u mults mod p in %.3f s, %.1f mults/s\n\r", batch ? "fp (batch)" : "fp",
+			BENCH_NB_JOBS, t, (double)BENCH_NB_JOBS / t);
+
+	return 0;
+err:
+	return -1;
+}
+
+int main(int argc, char *argv[])
+{
+	uint8_t sum_x[3][32], sum_y[3][32];
+	uint32_t i;
+	int ret;
+
+	(void)argc;
+	(void)argv;
+
+	if (hw_driver_set_curve(p256_a, sizeof(p256_a), p256_b, sizeof(p256_b),
+				p256_p, sizeof(p256_p), p256_q, sizeof(p256_q)))
+	{
+		printf("%sError: transmitting curve parameters to the hardware triggered an error.%s\n\r", KERR, KNRM);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Transfers limb by limb */
+	if (hw_driver_disable_streaming()) {
+		printf("%sError: hw_driver_disable_streaming() triggered an error.%s\n\r", KERR, KNRM);
+		exit(EXIT_FAILURE);
+	}
+	if (bench_transfers("limb by limb")) {
+		exit(EXIT_FAILURE);
+	}
+
+	/* Streamed transfers */
+	if (hw_driver_enable_streaming()) {
+		printf("Streaming mode not supported by hardware\n\r");
+	} else if (bench_transfers("streaming")) {
+		exit(EXIT_FAILURE);
+	}
+
+	/* Scalar multiplications */
+	bench_mul_init();
+	if (bench_mul(0)) {
+		exit(EXIT_FAILURE);
+	}
+	if (bench_mul(1)) {
+		exit(EXIT_FAILURE);
+	}
+	if (bench_mul(2)) {
+		exit(EXIT_FAILURE);
+	}
+	if (bench_mul_base()) {
+		exit(EXIT_FAILURE);
+	}
+	if (bench_mul2()) {
+		exit(EXIT_FAILURE);
+	}
+
+	/* Sum of points (one inversion per addition, or only one in all) */
+	if (bench_sum(0, sum_x[0], sum_y[0])) {
+		exit(EXIT_FAILURE);
+	}
+	if (bench_sum(1, sum_x[1], sum_y[1])) {
+		exit(EXIT_FAILURE);
+	}
+	if (memcmp(sum_x[0], sum_x[1], 32) || memcmp(sum_y[0], sum_y[1], 32)) {
+		printf("%sError: the two sums of points differ.%s\n\r", KERR, KNRM);
+		exit(EXIT_FAILURE);
+	}
+	ret = bench_sum_resident(sum_x[2], sum_y[2]);
+	if (ret < 0) {
+		exit(EXIT_FAILURE);
+	}
+	if ((ret == 0) && (memcmp(sum_x[0], sum_x[2], 32) || memcmp(sum_y[0], sum_y[2], 32))) {
+		printf("%sError: the sum of resident points differs.%s\n\r", KERR, KNRM);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Multiplications modulo p (the run without batch overwrites
+	 * the x-coordinates with its results) */
+	if (bench_fp_mul(1)) {
+		exit(EXIT_FAILURE);
+	}
+	if (bench_fp_mul(0)) {
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < BENCH_NB_JOBS; i++) {
+		if (memcmp(bench_fp_r[i], bench_rx[i], 32)) {
+			printf("%sError: the batched multiplications mod p differ.%s\n\r", KERR, KNRM);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
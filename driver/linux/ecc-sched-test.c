@@ -0,0 +1,310 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Test of the scheduling of jobs on several IPs (hw_driver_schedule()) and
+ * of the interrupt mode of the driver (hw_driver_set_completion_mode()).
+ *
+ * Runs on a host against the register model of the IP (the driver must be
+ * compiled with WITH_EC_HW_REGMODEL, see hw_accelerator_driver_regmodel.c),
+ * which emulates several instances of the IP. Checks that:
+ *
+ *   - jobs are spread over idle IPs before any IP gets a second one,
+ *   - a job in flight rejects the calls touching its IP, and survives an
+ *     attempt to collect it with output buffers too small,
+ *   - among IPs equally busy, the one where the curve is resident is elected,
+ *   - an idle IP is preferred to a busy one where the curve is resident,
+ *   - the selected IP is left unchanged when hw_driver_schedule() fails,
+ *   - hw_driver_unlock_device() releases the IP locked, even after another
+ *     IP was selected (the driver is compiled in thread-safe mode),
+ *   - threads which never call hw_driver_select_device() reach the first IP
+ *     (the IP selected and its base address are per thread),
+ *   - in HW_DRIVER_COMPLETION_IRQ mode a [k]P sleeps on the interrupt of the
+ *     IP, and goes back to sleep when woken up while the IP is still busy
+ *     (spurious wake-up), while in HW_DRIVER_COMPLETION_SPIN mode it never
+ *     sleeps.
+ *
+ * Usage: ecc-sched-test (returns 0 if all checks pass)
+ */
+
+#include "../hw_accelerator_driver.h"
+#include "../hw_accelerator_driver_ipecc_platform.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#if !defined(WITH_EC_HW_REGMODEL)
+#error "ecc-sched-test requires the driver to be compiled with WITH_EC_HW_REGMODEL"
+#endif
+
+#define SCHED_NBMAXSZ	128 /* in bytes, i.e nn <= 1024 */
+
+/* NIST P-256 */
+static const uint8_t p256_p[] = {
+	0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+static const uint8_t p256_a[] = {
+	0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfc,
+};
+static const uint8_t p256_b[] = {
+	0x5a, 0xc6, 0x35, 0xd8, 0xaa, 0x3a, 0x93, 0xe7, 0xb3, 0xeb, 0xbd, 0x55, 0x76, 0x98, 0x86, 0xbc,
+	0x65, 0x1d, 0x06, 0xb0, 0xcc, 0x53, 0xb0, 0xf6, 0x3b, 0xce, 0x3c, 0x3e, 0x27, 0xd2, 0x60, 0x4b,
+};
+static const uint8_t p256_q[] = {
+	0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xbc, 0xe6, 0xfa, 0xad, 0xa7, 0x17, 0x9e, 0x84, 0xf3, 0xb9, 0xca, 0xc2, 0xfc, 0x63, 0x25, 0x51,
+};
+
+/* secp256k1 */
+static const uint8_t k256_p[] = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfc, 0x2f,
+};
+static const uint8_t k256_a[] = { 0x00 };
+static const uint8_t k256_b[] = { 0x07 };
+static const uint8_t k256_q[] = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
+	0xba, 0xae, 0xdc, 0xe6, 0xaf, 0x48, 0xa0, 0x3b, 0xbf, 0xd2, 0x5e, 0x8c, 0xd0, 0x36, 0x41, 0x41,
+};
+
+/* Curve only registered (never set before the test of the error path) */
+static const uint8_t other_b[] = { 0x03 };
+
+/* Operands of the [k]P jobs (their value does not matter to the model) */
+static const uint8_t job_x[] = { 0x01 };
+static const uint8_t job_y[] = { 0x02 };
+static const uint8_t job_k[] = { 0x03 };
+
+static uint32_t nb_checks = 0;
+static uint32_t nb_fails = 0;
+
+static void sched_check(int cond, const char *what)
+{
+	nb_checks++;
+	if(!cond){
+		nb_fails++;
+	}
+	printf("[%s] %s\n", cond ? " OK " : "FAIL", what);
+
+	return;
+}
+
+/* Elect an IP for a job on curve 'id' and check it is 'expected' */
+static void sched_expect(uint32_t id, uint32_t expected, const char *what)
+{
+	uint32_t dev = 0xffffffff;
+
+	if(hw_driver_schedule(id, &dev)){
+		sched_check(0, what);
+		return;
+	}
+	sched_check(dev == expected, what);
+
+	return;
+}
+
+/* Lock and release IP 0 from another thread (blocks if the main thread
+ * still holds it) */
+static void *sched_lock_ip0(void *arg)
+{
+	int *ok = (int*)arg;
+
+	(*ok) = (hw_driver_select_device(0) == 0) && (hw_driver_lock_device() == 0)
+			&& (hw_driver_unlock_device() == 0);
+
+	return NULL;
+}
+
+/* Reset the IP and run a [k]P on it without selecting any IP first */
+static void *sched_no_select(void *arg)
+{
+	int *ok = (int*)arg;
+	hw_driver_mul_job job;
+	uint8_t out_x[SCHED_NBMAXSZ], out_y[SCHED_NBMAXSZ];
+	uint32_t out_x_sz = sizeof(out_x), out_y_sz = sizeof(out_y);
+
+	(*ok) = (hw_driver_reset() == 0)
+			&& (hw_driver_mul_submit(job_x, sizeof(job_x), job_y, sizeof(job_y),
+					job_k, sizeof(job_k), &job) == 0)
+			&& (hw_driver_mul_wait(job, out_x, &out_x_sz, out_y, &out_y_sz) == 0);
+
+	return NULL;
+}
+
+int main(void)
+{
+	uint32_t i, nb, dev, id_p256, id_k256, id_other, wakes;
+	hw_driver_mul_job jobs[HW_DRIVER_MAX_DEVICES];
+	uint8_t out_x[SCHED_NBMAXSZ], out_y[SCHED_NBMAXSZ];
+	uint32_t out_x_sz, out_y_sz;
+	pthread_t thread, threads[2];
+	int ok = 0, oks[2] = { 0, 0 };
+
+	if(hw_driver_get_nb_devices(&nb) || (nb < 3)){
+		printf("Error: at least 3 emulated IPs are needed\n");
+		return 1;
+	}
+	if(hw_driver_register_curve(p256_a, sizeof(p256_a), p256_b, sizeof(p256_b),
+				p256_p, sizeof(p256_p), p256_q, sizeof(p256_q), &id_p256)
+	 || hw_driver_register_curve(k256_a, sizeof(k256_a), k256_b, sizeof(k256_b),
+				k256_p, sizeof(k256_p), k256_q, sizeof(k256_q), &id_k256)
+	 || hw_driver_register_curve(k256_a, sizeof(k256_a), other_b, sizeof(other_b),
+				k256_p, sizeof(k256_p), k256_q, sizeof(k256_q), &id_other)){
+		printf("Error: can't register the curves\n");
+		return 1;
+	}
+
+	/* 1. Spreading: each new job goes to an IP without a job in flight,
+	 * even though the curve is already resident in the busy ones.
+	 */
+	for(i = 0; i < nb; i++){
+		if(hw_driver_schedule(id_p256, &dev)){
+			sched_check(0, "spreading: schedule");
+			return 1;
+		}
+		sched_check(dev == i, "spreading: job goes to the next idle IP");
+		if(hw_driver_mul_submit(job_x, sizeof(job_x), job_y, sizeof(job_y),
+					job_k, sizeof(job_k), &jobs[i])){
+			sched_check(0, "spreading: submit");
+			return 1;
+		}
+	}
+	for(i = 0; i < nb; i++){
+		sched_check(hw_driver_regmodel_nb_kp(i) == 1, "spreading: one [k]P started per IP");
+	}
+	/* All IPs equally busy: the one of lowest index */
+	sched_expect(id_p256, 0, "spreading: all IPs busy, lowest index elected");
+	/* With a job in flight, a call that would touch the IP is rejected,
+	 * and output buffers too small leave the job to be collected again.
+	 */
+	sched_check(hw_driver_select_curve(id_k256) != 0,
+			"in flight: transfer of another curve rejected");
+	out_x_sz = out_y_sz = 1;
+	sched_check(hw_driver_mul_wait(jobs[0], out_x, &out_x_sz, out_y, &out_y_sz) != 0,
+			"in flight: collect with buffers too small fails");
+	for(i = 0; i < nb; i++){
+		out_x_sz = out_y_sz = sizeof(out_x);
+		if(hw_driver_mul_wait(jobs[i], out_x, &out_x_sz, out_y, &out_y_sz)){
+			sched_check(0, "spreading: wait");
+			return 1;
+		}
+	}
+
+	/* 2. Affinity: among idle IPs, the one where the curve is resident */
+	if(hw_driver_select_device(2) || hw_driver_select_curve(id_k256)){
+		sched_check(0, "affinity: set curve in IP 2");
+		return 1;
+	}
+	sched_expect(id_k256, 2, "affinity: IP where the curve is resident elected");
+	sched_expect(id_p256, 0, "affinity: other curve goes to the lowest index");
+
+	/* 3. Load first: a busy IP is not elected, even with the curve resident */
+	hw_driver_regmodel_force_busy(2, 1);
+	sched_expect(id_k256, 0, "load: idle IP preferred to busy IP with the curve");
+	hw_driver_regmodel_force_busy(2, 0);
+	sched_expect(id_k256, 0, "load: curve now resident in IP 0 too, lowest index");
+
+	/* 4. Error path: setting the curve fails in the elected IP, the caller
+	 * is left on the IP it had selected.
+	 */
+	if(hw_driver_select_device(nb - 1)){
+		sched_check(0, "error: select last IP");
+		return 1;
+	}
+	for(i = 0; i < nb; i++){
+		hw_driver_regmodel_force_error(i, 0x1);
+	}
+	sched_check(hw_driver_schedule(id_other, &dev) != 0, "error: schedule fails");
+	for(i = 0; i < nb; i++){
+		hw_driver_regmodel_force_error(i, 0);
+	}
+	sched_check((hw_driver_get_device(&dev) == 0) && (dev == (nb - 1)),
+			"error: selected IP left unchanged");
+
+	/* 5. Locking: the IP locked is the one released, whichever IP is
+	 * selected in between.
+	 */
+	if(hw_driver_select_device(0) || hw_driver_lock_device()){
+		sched_check(0, "lock: lock IP 0");
+		return 1;
+	}
+	sched_check(hw_driver_lock_device() != 0, "lock: only one IP locked at a time");
+	if(hw_driver_select_device(1)){
+		sched_check(0, "lock: select IP 1");
+		return 1;
+	}
+	sched_check(hw_driver_unlock_device() == 0, "lock: unlock with IP 1 selected");
+	sched_check(hw_driver_unlock_device() != 0, "lock: nothing left to unlock");
+	if(pthread_create(&thread, NULL, sched_lock_ip0, &ok) || pthread_join(thread, NULL)){
+		sched_check(0, "lock: thread");
+		return 1;
+	}
+	sched_check(ok, "lock: IP 0 released, locked by another thread");
+
+	/* 6. Threads without hw_driver_select_device(): both work on IP 0 */
+	nb = hw_driver_regmodel_nb_kp(0);
+	for(i = 0; i < 2; i++){
+		if(pthread_create(&threads[i], NULL, sched_no_select, &oks[i])){
+			sched_check(0, "no select: threads");
+			return 1;
+		}
+	}
+	for(i = 0; i < 2; i++){
+		if(pthread_join(threads[i], NULL)){
+			sched_check(0, "no select: threads");
+			return 1;
+		}
+		sched_check(oks[i], "no select: reset and [k]P from a new thread");
+	}
+	sched_check(hw_driver_regmodel_nb_kp(0) == (nb + 2),
+			"no select: both [k]P started on IP 0");
+
+	/* 7. Interrupt mode: the [k]P ends while the thread sleeps on the
+	 * interrupt of the IP, and a wake-up with the IP still busy sends the
+	 * thread back to sleep.
+	 */
+	if(hw_driver_select_device(0) || hw_driver_set_completion_mode(HW_DRIVER_COMPLETION_IRQ)){
+		sched_check(0, "irq: set interrupt mode");
+		return 1;
+	}
+	wakes = hw_driver_regmodel_nb_irq_wakes(0);
+	out_x_sz = out_y_sz = sizeof(out_x);
+	sched_check(hw_driver_mul(job_x, sizeof(job_x), job_y, sizeof(job_y), job_k, sizeof(job_k),
+				out_x, &out_x_sz, out_y, &out_y_sz, NULL) == 0, "irq: [k]P done");
+	sched_check(hw_driver_regmodel_nb_irq_wakes(0) == (wakes + 1),
+			"irq: woken up once, by the end of the [k]P");
+	hw_driver_regmodel_spurious_irq(0, 2);
+	out_x_sz = out_y_sz = sizeof(out_x);
+	sched_check(hw_driver_mul(job_x, sizeof(job_x), job_y, sizeof(job_y), job_k, sizeof(job_k),
+				out_x, &out_x_sz, out_y, &out_y_sz, NULL) == 0,
+			"irq: [k]P done despite spurious wake-ups");
+	sched_check(hw_driver_regmodel_nb_irq_wakes(0) == (wakes + 4),
+			"irq: back to sleep after each spurious wake-up");
+	if(hw_driver_set_completion_mode(HW_DRIVER_COMPLETION_SPIN)){
+		sched_check(0, "irq: set polling mode");
+		return 1;
+	}
+	out_x_sz = out_y_sz = sizeof(out_x);
+	sched_check(hw_driver_mul(job_x, sizeof(job_x), job_y, sizeof(job_y), job_k, sizeof(job_k),
+				out_x, &out_x_sz, out_y, &out_y_sz, NULL) == 0, "spin: [k]P done");
+	sched_check(hw_driver_regmodel_nb_irq_wakes(0) == (wakes + 4),
+			"spin: no sleep on the interrupt");
+
+	printf("%u/%u checks passed\n", nb_checks - nb_fails, nb_checks);
+
+	return (nb_fails != 0);
+}
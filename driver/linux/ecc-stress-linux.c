@@ -0,0 +1,377 @@
+/*
+ *  Copyright (C) 2023 - This file is part of IPECC project
+ *
+ *  Authors:
+ *      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+ *      Ryad BENADJILA <ryadbenadjila@gmail.com>
+ *
+ *  Contributors:
+ *      Adrian THILLARD
+ *      Emmanuel PROUFF
+ *
+ *  This software is licensed under GPL v2 license.
+ *  See LICENSE file at the root folder of the project.
+ */
+
+/*
+ * Multi-threaded stress test & benchmark of the driver.
+ *
+ * Reads test-vectors from standard-input (same text format as for
+ * ecc-test-linux, only the [k]P tests are kept) then has them computed
+ * by hardware from several threads concurrently, each thread running
+ * through all the tests, starting at a different one. Results are
+ * checked against the expected ones and the overall throughput (in
+ * [k]P/s) is printed.
+ *
+ * The driver must be compiled in thread-safe mode (WITH_EC_HW_THREAD_SAFE).
+ * When several IPs are available, each test is run on the one elected by
+ * hw_driver_schedule().
+ *
+ * Usage: ecc-stress-linux [nb of threads] [nb of passes] < test-vectors
+ */
+
+#include "../hw_accelerator_driver.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#if !defined(WITH_EC_HW_THREAD_SAFE)
+#error "ecc-stress-linux requires the driver to be compiled with WITH_EC_HW_THREAD_SAFE"
+#endif
+
+#define STRESS_NB_THREADS_DEFAULT	8
+#define STRESS_NB_THREADS_MAX		64
+#define STRESS_NB_PASSES_DEFAULT	1
+
+#define STRESS_NBMAXSZ		128 /* in bytes, i.e nn <= 1024 */
+
+typedef struct {
+	uint8_t val[STRESS_NBMAXSZ];
+	uint32_t sz;
+} stress_num_t;
+
+typedef struct {
+	uint32_t nn;
+	stress_num_t p, a, b, q;
+	/* Handle of the curve in the driver (HW_DRIVER_NO_CURVE if it could not be registered) */
+	uint32_t id;
+} stress_curve_t;
+
+typedef struct {
+	uint32_t curve;
+	stress_num_t px, py, k, kpx, kpy;
+	int kp_is_null;
+} stress_kp_t;
+
+static stress_curve_t *curves = NULL;
+static uint32_t nb_curves = 0;
+static stress_kp_t *tests = NULL;
+static uint32_t nb_tests = 0;
+
+static uint32_t nb_passes = STRESS_NB_PASSES_DEFAULT;
+
+typedef struct {
+	pthread_t tid;
+	uint32_t idx;
+	uint32_t ok;
+	uint32_t nok;
+	uint32_t errors;
+} stress_thread_t;
+
+static stress_thread_t threads[STRESS_NB_THREADS_MAX];
+
+/* Convert the hexadecimal string 's' (without the 0x) into a big-endian
+ * number of NN_SZ(nn) bytes.
+ */
+static int stress_hex_to_num(const char *s, uint32_t nn, stress_num_t *n)
+{
+	uint32_t i, len, sz;
+	uint8_t d;
+	char c;
+
+	sz = (nn + 7) / 8;
+	if ((sz == 0) || (sz > STRESS_NBMAXSZ)) {
+		goto err;
+	}
+	for (len = 0; (s[len] != '\0') && (s[len] != '\n') && (s[len] != '\r'); len++);
+	if ((len == 0) || (((len + 1) / 2) > sz)) {
+		goto err;
+	}
+	memset(n->val, 0, sz);
+	for (i = 0; i < len; i++) {
+		c = s[len - 1 - i];
+		if ((c >= '0') && (c <= '9')) {
+			d = c - '0';
+		} else if ((c >= 'a') && (c <= 'f')) {
+			d = c - 'a' + 10;
+		} else if ((c >= 'A') && (c <= 'F')) {
+			d = c - 'A' + 10;
+		} else {
+			goto err;
+		}
+		n->val[sz - 1 - (i / 2)] |= (i % 2) ? (d << 4) : d;
+	}
+	n->sz = sz;
+
+	return 0;
+err:
+	return -1;
+}
+
+/* Parse the test-vectors from standard input, keeping only curves and [k]P tests */
+static int stress_parse_input(void)
+{
+	char *line = NULL;
+	size_t len = 0;
+	stress_curve_t *crv = NULL;
+	stress_kp_t *tst = NULL;
+	void *tmp;
+	unsigned long linenum = 0;
+	int skip = 1;
+
+	while (getline(&line, &len, stdin) != -1) {
+		linenum++;
+		if ((line[0] == '#') || (line[0] == '\n') || (line[0] == '\r') || (line[0] == '\0')) {
+			continue;
+		}
+		if (strncmp(line, "== NEW CURVE #", strlen("== NEW CURVE #")) == 0) {
+			tmp = realloc(curves, (nb_curves + 1) * sizeof(stress_curve_t));
+			if (tmp == NULL) {
+				goto err;
+			}
+			curves = tmp;
+			crv = &curves[nb_curves++];
+			memset(crv, 0, sizeof(stress_curve_t));
+			tst = NULL;
+			skip = 0;
+		} else if (strncmp(line, "== TEST [k]P #", strlen("== TEST [k]P #")) == 0) {
+			if (crv == NULL) {
+				goto err_line;
+			}
+			tmp = realloc(tests, (nb_tests + 1) * sizeof(stress_kp_t));
+			if (tmp == NULL) {
+				goto err;
+			}
+			tests = tmp;
+			tst = &tests[nb_tests++];
+			memset(tst, 0, sizeof(stress_kp_t));
+			tst->curve = nb_curves - 1;
+			skip = 0;
+		} else if (strncmp(line, "==", strlen("==")) == 0) {
+			/* Other kind of test: skip it */
+			tst = NULL;
+			skip = 1;
+		} else if (skip) {
+			continue;
+		} else if (tst == NULL) {
+			/* Curve parameters */
+			if (strncmp(line, "nn=", strlen("nn=")) == 0) {
+				crv->nn = (uint32_t)strtoul(line + strlen("nn="), NULL, 10);
+			} else if (strncmp(line, "p=0x", strlen("p=0x")) == 0) {
+				if (stress_hex_to_num(line + strlen("p=0x"), crv->nn, &crv->p)) {
+					goto err_line;
+				}
+			} else if (strncmp(line, "a=0x", strlen("a=0x")) == 0) {
+				if (stress_hex_to_num(line + strlen("a=0x"), crv->nn, &crv->a)) {
+					goto err_line;
+				}
+			} else if (strncmp(line, "b=0x", strlen("b=0x")) == 0) {
+				if (stress_hex_to_num(line + strlen("b=0x"), crv->nn, &crv->b)) {
+					goto err_line;
+				}
+			} else if (strncmp(line, "q=0x", strlen("q=0x")) == 0) {
+				if (stress_hex_to_num(line + strlen("q=0x"), crv->nn, &crv->q)) {
+					goto err_line;
+				}
+			}
+		} else {
+			/* [k]P test */
+			if (strncmp(line, "Px=0x", strlen("Px=0x")) == 0) {
+				if (stress_hex_to_num(line + strlen("Px=0x"), crv->nn, &tst->px)) {
+					goto err_line;
+				}
+			} else if (strncmp(line, "Py=0x", strlen("Py=0x")) == 0) {
+				if (stress_hex_to_num(line + strlen("Py=0x"), crv->nn, &tst->py)) {
+					goto err_line;
+				}
+			} else if (strncmp(line, "P=0", strlen("P=0")) == 0) {
+				/* Null input point: not kept */
+				nb_tests--;
+				tst = NULL;
+				skip = 1;
+			} else if (strncmp(line, "k=0x", strlen("k=0x")) == 0) {
+				if (stress_hex_to_num(line + strlen("k=0x"), crv->nn, &tst->k)) {
+					goto err_line;
+				}
+			} else if (strncmp(line, "kPx=0x", strlen("kPx=0x")) == 0) {
+				if (stress_hex_to_num(line + strlen("kPx=0x"), crv->nn, &tst->kpx)) {
+					goto err_line;
+				}
+			} else if (strncmp(line, "kPy=0x", strlen("kPy=0x")) == 0) {
+				if (stress_hex_to_num(line + strlen("kPy=0x"), crv->nn, &tst->kpy)) {
+					goto err_line;
+				}
+			} else if (strncmp(line, "kP=0", strlen("kP=0")) == 0) {
+				tst->kp_is_null = 1;
+			}
+			/* (blinding 'nbbld=' lines are ignored) */
+		}
+	}
+	free(line);
+
+	return 0;
+err_line:
+	printf("%sError: can't parse line %lu of input.%s\n\r", KERR, linenum, KNRM);
+err:
+	free(line);
+	return -1;
+}
+
+/* Register the curves in the driver (the ones which can't be registered
+ * will be set with hw_driver_set_curve() each time they are used).
+ */
+static void stress_register_curves(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < nb_curves; i++) {
+		if (hw_driver_register_curve(curves[i].a.val, curves[i].a.sz, curves[i].b.val, curves[i].b.sz,
+					curves[i].p.val, curves[i].p.sz, curves[i].q.val, curves[i].q.sz, &curves[i].id)) {
+			curves[i].id = HW_DRIVER_NO_CURVE;
+		}
+	}
+}
+
+/* Run test 't' on the IP elected by the scheduler and check its result */
+static int stress_run_kp(const stress_kp_t *t, int *ok)
+{
+	const stress_curve_t *crv = &curves[t->curve];
+	uint8_t kpx[STRESS_NBMAXSZ], kpy[STRESS_NBMAXSZ];
+	uint32_t kpx_sz = sizeof(kpx), kpy_sz = sizeof(kpy);
+	uint32_t dev;
+	int is_null;
+
+	if (hw_driver_schedule(crv->id, &dev)) {
+		goto err;
+	}
+	/* Curve, point and result must not be changed by other threads in between */
+	if (hw_driver_lock_device()) {
+		goto err;
+	}
+	if (hw_driver_set_curve(crv->a.val, crv->a.sz, crv->b.val, crv->b.sz,
+				crv->p.val, crv->p.sz, crv->q.val, crv->q.sz)) {
+		goto err_unlock;
+	}
+	if (hw_driver_point_unzero(1)) {
+		goto err_unlock;
+	}
+	if (hw_driver_mul(t->px.val, t->px.sz, t->py.val, t->py.sz, t->k.val, t->k.sz,
+				kpx, &kpx_sz, kpy, &kpy_sz, NULL)) {
+		goto err_unlock;
+	}
+	if (hw_driver_point_iszero(1, &is_null)) {
+		goto err_unlock;
+	}
+	hw_driver_unlock_device();
+
+	if (t->kp_is_null || is_null) {
+		(*ok) = (t->kp_is_null && is_null);
+	} else {
+		(*ok) = (kpx_sz == t->kpx.sz) && (kpy_sz == t->kpy.sz)
+			&& (memcmp(kpx, t->kpx.val, kpx_sz) == 0) && (memcmp(kpy, t->kpy.val, kpy_sz) == 0);
+	}
+
+	return 0;
+err_unlock:
+	hw_driver_unlock_device();
+err:
+	return -1;
+}
+
+static void *stress_thread(void *arg)
+{
+	stress_thread_t *th = (stress_thread_t*)arg;
+	uint32_t i, pass;
+	int ok;
+
+	for (pass = 0; pass < nb_passes; pass++) {
+		for (i = 0; i < nb_tests; i++) {
+			/* Each thread starts at a different test, so that several
+			 * curves are in use at the same time */
+			if (stress_run_kp(&tests[(th->idx + i) % nb_tests], &ok)) {
+				th->errors++;
+			} else if (ok) {
+				th->ok++;
+			} else {
+				th->nok++;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+	struct timespec start, stop;
+	uint32_t i, nb_threads = STRESS_NB_THREADS_DEFAULT, nb_devices;
+	uint32_t ok = 0, nok = 0, errors = 0;
+	double t;
+
+	if (argc > 1) {
+		nb_threads = (uint32_t)strtoul(argv[1], NULL, 10);
+	}
+	if (argc > 2) {
+		nb_passes = (uint32_t)strtoul(argv[2], NULL, 10);
+	}
+	if ((nb_threads == 0) || (nb_threads > STRESS_NB_THREADS_MAX)) {
+		printf("%sError: nb of threads must be between 1 and %d.%s\n\r", KERR, STRESS_NB_THREADS_MAX, KNRM);
+		exit(EXIT_FAILURE);
+	}
+
+	if (stress_parse_input()) {
+		exit(EXIT_FAILURE);
+	}
+	if (nb_tests == 0) {
+		printf("%sError: no [k]P test found in input.%s\n\r", KERR, KNRM);
+		exit(EXIT_FAILURE);
+	}
+	stress_register_curves();
+	if (hw_driver_get_nb_devices(&nb_devices)) {
+		exit(EXIT_FAILURE);
+	}
+	printf("%u curve(s), %u [k]P test(s), %u thread(s), %u pass(es), %u IP(s)\n\r",
+			nb_curves, nb_tests, nb_threads, nb_passes, nb_devices);
+
+	if (clock_gettime(CLOCK_MONOTONIC, &start)) {
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < nb_threads; i++) {
+		threads[i].idx = i;
+		if (pthread_create(&threads[i].tid, NULL, stress_thread, &threads[i])) {
+			printf("%sError: can't create thread %u.%s\n\r", KERR, i, KNRM);
+			exit(EXIT_FAILURE);
+		}
+	}
+	for (i = 0; i < nb_threads; i++) {
+		pthread_join(threads[i].tid, NULL);
+		ok += threads[i].ok;
+		nok += threads[i].nok;
+		errors += threads[i].errors;
+	}
+	if (clock_gettime(CLOCK_MONOTONIC, &stop)) {
+		exit(EXIT_FAILURE);
+	}
+	t = (double)(stop.tv_sec - start.tv_sec) + ((double)(stop.tv_nsec - start.tv_nsec) / 1e9);
+
+	printf("%u [k]P in %.3f s, %.1f [k]P/s\n\r", ok + nok + errors, t, (double)(ok + nok + errors) / t);
+	printf("%sOK: %u%s  %sNOK: %u%s  %sErrors: %u%s\n\r", KGRN, ok, KNRM, KERR, nok, KNRM, KERR, errors, KNRM);
+
+	free(tests);
+	free(curves);
+
+	return ((nok == 0) && (errors == 0)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -120,6 +120,9 @@ extern int check_ptadd_result(ipecc_test_t*, bool*);
 /*   [2]P */
 extern int ip_set_pt_and_run_ptdbl(ipecc_test_t*);
 extern int check_ptdbl_result(ipecc_test_t*, bool*);
+/*   [k1]P + [k2]Q */
+extern int ip_set_pts_and_run_kp2(ipecc_test_t*);
+extern int check_kp2_result(ipecc_test_t*, bool*);
 /*   (-P) */
 extern int ip_set_pt_and_run_ptneg(ipecc_test_t*);
 extern int check_ptneg_result(ipecc_test_t*, bool*);
@@ -181,6 +184,7 @@ static ipecc_test_t test = {
 	.ptp = INIT_POINT(),
 	.ptq = INIT_POINT(),
 	.k = INIT_LARGE_NUMBER(),
+	.k2 = INIT_LARGE_NUMBER(),
 	.pt_sw_res = INIT_POINT(),
 	.pt_hw_res = INIT_POINT(),
 	.blinding = 0,
@@ -205,6 +209,7 @@ static all_stats_t stats = {
 	.test_equ = { .ok = 0, .nok = 0, .total = 0 },
 	.test_opp = { .ok = 0, .nok = 0, .total = 0 },
 	.test_crv = { .ok = 0, .nok = 0, .total = 0 },
+	.kp2 = { .ok = 0, .nok = 0, .total = 0 },
 	.all = { .ok = 0, .nok = 0, .total = 0 },
 	.nn_min = 0xffffffffUL,
 	.nn_max = 0,
@@ -263,24 +268,25 @@ static void print_stats_regularly(all_stats_t* st, bool force)
 		}
 		/* Label line */
 		printf("%s         %s[k]P     P+Q    [2]P      -P"
-				"    P==Q    P==-Q   PonC   %sTotal%s%s\n", KBOLD, KWHT, KCYN, KNRM, KNOBOLD);
+				"    P==Q    P==-Q   PonC  kP+kQ   %sTotal%s%s\n", KBOLD, KWHT, KCYN, KNRM, KNOBOLD);
 		/* OK line */
-		printf("%s%s   ok: %*d  %*d  %*d  %*d  %*d  %*d  %*d  %s%*d%s%s\n",
+		printf("%s%s   ok: %*d  %*d  %*d  %*d  %*d  %*d  %*d  %*d  %s%*d%s%s\n",
 				KBOLD,
 				KGRN, 6, st->kp.ok, 6, st->ptadd.ok, 6, st->ptdbl.ok, 6, st->ptneg.ok,
-				6, st->test_equ.ok, 6, st->test_opp.ok, 6, st->test_crv.ok, KCYN, 6, st->all.ok,
+				6, st->test_equ.ok, 6, st->test_opp.ok, 6, st->test_crv.ok, 6, st->kp2.ok,
+				KCYN, 6, st->all.ok,
 				KNRM, KNOBOLD);
 		/* NOK line */
-		printf("%s%s  nok: %*d  %*d  %*d  %*d  %*d  %*d  %*d  %s%*d%s%s\n",
+		printf("%s%s  nok: %*d  %*d  %*d  %*d  %*d  %*d  %*d  %*d  %s%*d%s%s\n",
 				KBOLD, KRED,
 				6, st->kp.nok, 6, st->ptadd.nok, 6, st->ptdbl.nok, 6, st->ptneg.nok,
-				6, st->test_equ.nok, 6, st->test_opp.nok, 6, st->test_crv.nok, KCYN,
+				6, st->test_equ.nok, 6, st->test_opp.nok, 6, st->test_crv.nok, 6, st->kp2.nok, KCYN,
 				6, st->all.nok, KNRM, KNOBOLD);
 		/* Total line */
-		printf("%stotal: %*d  %*d  %*d  %*d  %*d  %*d  %*d  %s%*d%s%s\n",
+		printf("%stotal: %*d  %*d  %*d  %*d  %*d  %*d  %*d  %*d  %s%*d%s%s\n",
 				KBOLD,
 				6, st->kp.total, 6, st->ptadd.total, 6, st->ptdbl.total, 6, st->ptneg.total,
-				6, st->test_equ.total, 6, st->test_opp.total, 6, st->test_crv.total, KCYN,
+				6, st->test_equ.total, 6, st->test_opp.total, 6, st->test_crv.total, 6, st->kp2.total, KCYN,
 				6, st->all.total, KNRM, KNOBOLD);
 	}
 }
@@ -711,6 +717,26 @@ int main(int argc, char *argv[])
 					test.sw_answer.valid = false;
 					test.hw_answer.valid = false;
 					line_type_expected = EXPECT_PX;
+				} else if ( (strncmp(line, "== TEST [k1]P+[k2]Q #", strlen("== TEST [k1]P+[k2]Q #"))) == 0 ) {
+					/*
+					 * Extract the computation nb, after '#' character.
+					 */
+					/* Determine position of the dot in the line. */
+					for (i=0; ; i++) {
+						if (*(line + strlen("== TEST [k1]P+[k2]Q #") + i) == '.') {
+							*(line + strlen("== TEST [k1]P+[k2]Q #") + i) = '\0';
+							break;
+						}
+					}
+					strtol_with_err(line + strlen("== TEST [k1]P+[k2]Q #") + i + 1, &test.id);
+					test.op = OP_KP2;
+					test.ptp.valid = false;
+					test.ptq.valid = false;
+					test.k.valid = false;
+					test.k2.valid = false;
+					test.pt_sw_res.valid = false;
+					test.pt_hw_res.valid = false;
+					line_type_expected = EXPECT_PX;
 				} else {
 					printf("%sError: Could not find any of the expected commands from "
 							"input file/stream.\n\r", KERR);
@@ -889,7 +915,7 @@ int main(int argc, char *argv[])
 					test.ptp.valid = true;
 					if (test.op == OP_KP) {
 						line_type_expected = EXPECT_K;
-					} else if (test.op == OP_PTADD) {
+					} else if ((test.op == OP_PTADD) || (test.op == OP_KP2)) {
 						line_type_expected = EXPECT_QX;
 					} else if (test.op == OP_PTDBL) {
 						line_type_expected = EXPECT_TWOP_X;
@@ -930,7 +956,7 @@ int main(int argc, char *argv[])
 					test.ptp.valid = true;
 					if (test.op == OP_KP) {
 						line_type_expected = EXPECT_K;
-					} else if (test.op == OP_PTADD) {
+					} else if ((test.op == OP_PTADD) || (test.op == OP_KP2)) {
 						line_type_expected = EXPECT_QX;
 					} else if (test.op == OP_PTDBL) {
 						line_type_expected = EXPECT_TWOP_X;
@@ -982,6 +1008,8 @@ int main(int argc, char *argv[])
 					test.ptq.valid = true;
 					if (test.op == OP_PTADD) {
 						line_type_expected = EXPECT_P_PLUS_QX;
+					} else if (test.op == OP_KP2) {
+						line_type_expected = EXPECT_K1;
 					} else if (test.op == OP_TST_EQU) {
 						line_type_expected = EXPECT_TRUE_OR_FALSE;
 					} else if (test.op == OP_TST_OPP) {
@@ -1019,6 +1047,8 @@ int main(int argc, char *argv[])
 					test.ptq.valid = true;
 					if (test.op == OP_PTADD) {
 						line_type_expected = EXPECT_P_PLUS_QX;
+					} else if (test.op == OP_KP2) {
+						line_type_expected = EXPECT_K1;
 					} else if (test.op == OP_TST_EQU) {
 						line_type_expected = EXPECT_TRUE_OR_FALSE;
 					} else if (test.op == OP_TST_OPP) {
@@ -1816,6 +1846,185 @@ int main(int argc, char *argv[])
 				break;
 			}
 
+			case EXPECT_K1:{
+				/*
+				 * Parse line to extract value of k1.
+				 */
+				if ( (strncmp(line, "k1=0x", strlen("k1=0x"))) == 0 ) {
+					PRINTF("%sk1=0x%s%s", KINF, line + strlen("k1=0x"), KNRM);
+					/*
+					 * Process the hexadecimal value of k1 (stored in test.k).
+					 */
+					if (hex_to_large_num(
+							line + strlen("k1=0x"), test.k.val, test.curve->nn, nread - strlen("k1=0x")))
+					{
+						printf("%sError: Value of scalar number 'k1' could not be extracted "
+								"from input file/stream.%s\n\r", KERR, KNRM);
+						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_K1')", __LINE__);
+					}
+					test.k.sz = DIV(test.curve->nn, 8);
+					test.k.valid = true;
+					line_type_expected = EXPECT_K2;
+				} else {
+					printf("%sError: Could not find the expected token \"k1=0x\" "
+							"from input file/stream.%s\n\r", KERR, KNRM);
+					print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_K1')", __LINE__);
+				}
+				break;
+			}
+
+			case EXPECT_K2:{
+				/*
+				 * Parse line to extract value of k2.
+				 */
+				if ( (strncmp(line, "k2=0x", strlen("k2=0x"))) == 0 ) {
+					PRINTF("%sk2=0x%s%s", KINF, line + strlen("k2=0x"), KNRM);
+					/*
+					 * Process the hexadecimal value of k2.
+					 */
+					if (hex_to_large_num(
+							line + strlen("k2=0x"), test.k2.val, test.curve->nn, nread - strlen("k2=0x")))
+					{
+						printf("%sError: Value of scalar number 'k2' could not be extracted "
+								"from input file/stream.%s\n\r", KERR, KNRM);
+						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_K2')", __LINE__);
+					}
+					test.k2.sz = DIV(test.curve->nn, 8);
+					test.k2.valid = true;
+					line_type_expected = EXPECT_K1P_PLUS_K2QX;
+				} else {
+					printf("%sError: Could not find the expected token \"k2=0x\" "
+							"from input file/stream.%s\n\r", KERR, KNRM);
+					print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_K2')", __LINE__);
+				}
+				break;
+			}
+
+			case EXPECT_K1P_PLUS_K2QX:{
+				/*
+				 * Parse line to extract value of ([k1]P + [k2]Q).x
+				 */
+				if ( (strncmp(line, "k1Pplusk2Qx=0x", strlen("k1Pplusk2Qx=0x"))) == 0 ) {
+					PRINTF("%s([k1]P+[k2]Q)x=0x%s%s", KINF, line + strlen("k1Pplusk2Qx=0x"), KNRM);
+					/*
+					 * Process the hexadecimal value of ([k1]P + [k2]Q).x for comparison with HW
+					 */
+					if (hex_to_large_num(
+							line + strlen("k1Pplusk2Qx=0x"), test.pt_sw_res.x.val, test.curve->nn,
+							nread - strlen("k1Pplusk2Qx=0x")))
+					{
+						printf("%sError: Value of point coordinate '([k1]P+[k2]Q).x' could not be extracted "
+								"from input file/stream.%s\n\r", KERR, KNRM);
+						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_K1P_PLUS_K2QX')", __LINE__);
+					}
+					test.pt_sw_res.x.sz = DIV(test.curve->nn, 8);
+					test.pt_sw_res.is_null = false;
+					line_type_expected = EXPECT_K1P_PLUS_K2QY;
+				} else if ( (strncmp(line, "k1Pplusk2Q=0", strlen("k1Pplusk2Q=0"))) == 0 ) {
+					PRINTF("%s([k1]P+[k2]Q)=0%s", KINF, KNRM);
+					test.pt_sw_res.is_null = true;
+					test.pt_sw_res.valid = true;
+					/*
+					 * Set and execute a [k1]P + [k2]Q computation test on hardware.
+					 */
+					if (ip_set_pts_and_run_kp2(&test))
+					{
+						stats.kp2.nok++;
+						stats.kp2.total++;
+						stats.all.nok++;
+						stats.all.total++;
+						printf("%sError: Computation of [k1]P + [k2]Q on hardware triggered an error.%s\n\r", KERR, KNRM);
+						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_K1P_PLUS_K2QX')", __LINE__);
+					}
+					/*
+					 * Check IP result against the expected one.
+					 */
+					if (check_kp2_result(&test, &result_pts_are_equal))
+					{
+						stats.kp2.nok++;
+						stats.kp2.total++;
+						stats.all.nok++;
+						stats.all.total++;
+						printf("%sError: Couldn't compare [k1]P + [k2]Q hardware result w/ the expected one.%s\n\r", KERR, KNRM);
+						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_K1P_PLUS_K2QX')", __LINE__);
+					}
+					/*
+					 * Stats
+					 */
+					stats.kp2.ok++;
+					stats.kp2.total++;
+					stats.all.ok++;
+					stats.all.total++;
+					line_type_expected = EXPECT_NONE;
+					print_stats_regularly(&stats, false);
+				} else {
+					printf("%sError: Could not find one of the expected tokens \"k1Pplusk2Qx=0x\" "
+							"or \"k1Pplusk2Q=0\" in input file/stream.%s\n\r", KERR, KNRM);
+					print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_K1P_PLUS_K2QX')", __LINE__);
+				}
+				break;
+			}
+
+			case EXPECT_K1P_PLUS_K2QY:{
+				/*
+				 * Parse line to extract value of ([k1]P + [k2]Q).y
+				 */
+				if ( (strncmp(line, "k1Pplusk2Qy=0x", strlen("k1Pplusk2Qy=0x"))) == 0 ) {
+					PRINTF("%s([k1]P+[k2]Q)y=0x%s%s", KINF, line + strlen("k1Pplusk2Qy=0x"), KNRM);
+					/*
+					 * Process the hexadecimal value of ([k1]P + [k2]Q).y for comparison with HW
+					 */
+					if (hex_to_large_num(
+							line + strlen("k1Pplusk2Qy=0x"), test.pt_sw_res.y.val, test.curve->nn,
+							nread - strlen("k1Pplusk2Qy=0x")))
+					{
+						printf("%sError: Value of point coordinate '([k1]P+[k2]Q).y' could not be extracted "
+								"from input file/stream.%s\n\r", KERR, KNRM);
+						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_K1P_PLUS_K2QY')", __LINE__);
+					}
+					test.pt_sw_res.y.sz = DIV(test.curve->nn, 8);
+					test.pt_sw_res.valid = true;
+					/*
+					 * Set and execute a [k1]P + [k2]Q computation test on hardware.
+					 */
+					if (ip_set_pts_and_run_kp2(&test))
+					{
+						stats.kp2.nok++;
+						stats.kp2.total++;
+						stats.all.nok++;
+						stats.all.total++;
+						printf("%sError: Computation of [k1]P + [k2]Q on hardware triggered an error.%s\n\r", KERR, KNRM);
+						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_K1P_PLUS_K2QY')", __LINE__);
+					}
+					/*
+					 * Check IP result against the expected one.
+					 */
+					if (check_kp2_result(&test, &result_pts_are_equal))
+					{
+						stats.kp2.nok++;
+						stats.kp2.total++;
+						stats.all.nok++;
+						stats.all.total++;
+						printf("%sError: Couldn't compare [k1]P + [k2]Q hardware result w/ the expected one.%s\n\r", KERR, KNRM);
+						print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_K1P_PLUS_K2QY')", __LINE__);
+					}
+					/*
+					 * Stats
+					 */
+					stats.kp2.ok++;
+					stats.kp2.total++;
+					stats.all.ok++;
+					stats.all.total++;
+					line_type_expected = EXPECT_NONE;
+					print_stats_regularly(&stats, false);
+				} else {
+					printf("%sError: Could not find the expected token \"k1Pplusk2Qy=0x\" "
+							"in input file/stream.%s\n\r", KERR, KNRM);
+					print_stats_and_exit(&test, &stats, "(debug info: in state 'EXPECT_K1P_PLUS_K2QY')", __LINE__);
+				}
+				break;
+			}
+
 			default:{
 				break;
 			}
@@ -1832,6 +2041,7 @@ int main(int argc, char *argv[])
 			test.sw_answer.valid = false;
 			test.hw_answer.valid = false;
 			test.k.valid = false;
+			test.k2.valid = false;
 			test.blinding = 0;
 			test.op = OP_NONE;
 			test.is_an_exception = false;
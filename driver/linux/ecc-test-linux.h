@@ -59,7 +59,11 @@ typedef enum {
 	EXPECT_TWOP_Y = 17,
 	EXPECT_NEGP_X = 18,
 	EXPECT_NEGP_Y = 19,
-	EXPECT_TRUE_OR_FALSE = 20
+	EXPECT_TRUE_OR_FALSE = 20,
+	EXPECT_K1 = 21,
+	EXPECT_K2 = 22,
+	EXPECT_K1P_PLUS_K2QX = 23,
+	EXPECT_K1P_PLUS_K2QY = 24
 } line_t;
 
 /*
@@ -74,6 +78,7 @@ typedef enum {
 	OP_TST_CHK = 5,
 	OP_TST_EQU = 6,
 	OP_TST_OPP = 7,
+	OP_KP2 = 8,
 } operation_t;
 
 #define NBMAXSZ   1024
@@ -136,6 +141,7 @@ typedef struct {
 	stats_t test_equ;
 	stats_t test_opp;
 	stats_t test_crv;
+	stats_t kp2;
 	stats_t all;
 	uint32_t nn_min;
 	uint32_t nn_max;
@@ -151,6 +157,8 @@ typedef struct {
 	point_t ptp;
 	point_t ptq;
 	large_number_t k;
+	/* second scalar, only for [k1]P + [k2]Q (k then holds k1) */
+	large_number_t k2;
 	/* sw_res & hw_res are overloaded for the different
 	 * types of driver/IP operations. */
 	point_t pt_sw_res;
@@ -511,3 +511,132 @@ int check_ptneg_result(ipecc_test_t* t, /* stats_t* st, */ bool* res)
 err:
 	return -1;
 }
+
+int ip_set_pts_and_run_kp2(ipecc_test_t* t)
+{
+	int is_null;
+	/*
+	 * Sanity check.
+	 * Verify that curve is set.
+	 * Verify that points P and Q are both set (and not null, which
+	 * hw_driver_mul2() does not support).
+	 * Verify that scalars k1 and k2 are both set.
+	 * Verify that all large numbers do not exceed curve parameter 'nn' in size.
+	 * Verify that expected result of test is set.
+	 * Verify that operation type is valid.
+	 */
+	if (t->curve->set_in_hw == false) {
+		printf("%sError: Can't program IP for [k1]P + [k2]Q computation, assoc. curve not set in hardware.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	if ((t->ptp.valid == false) || (t->ptp.is_null == true)) {
+		printf("%sError: Can't program IP for [k1]P + [k2]Q computation, input point P not set (or null).%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	if ((t->ptq.valid == false) || (t->ptq.is_null == true)) {
+		printf("%sError: Can't program IP for [k1]P + [k2]Q computation, input point Q not set (or null).%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	if ((t->k.valid == false) || (t->k2.valid == false)) {
+		printf("%sError: Can't program IP for [k1]P + [k2]Q computation, scalars not set.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	if (((t->ptp.x.sz) > (NN_SZ(t->curve->nn))) || ((t->ptp.y.sz) > (NN_SZ(t->curve->nn)))) {
+		printf("%sError: Can't program IP for [k1]P + [k2]Q computation, coord. of point P larger than current curve size set in hardware.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	if (((t->ptq.x.sz) > (NN_SZ(t->curve->nn))) || ((t->ptq.y.sz) > (NN_SZ(t->curve->nn)))) {
+		printf("%sError: Can't program IP for [k1]P + [k2]Q computation, coord. of point Q larger than current curve size set in hardware.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	if (((t->k.sz) > (NN_SZ(t->curve->nn))) || ((t->k2.sz) > (NN_SZ(t->curve->nn)))) {
+		printf("%sError: Can't program IP for [k1]P + [k2]Q computation, scalar larger than current curve size set in hardware.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	if (t->pt_sw_res.valid == false) {
+		printf("%sError: Can't program IP for [k1]P + [k2]Q computation, missing expected result of test.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	if (t->op != OP_KP2) {
+		printf("%sError: Can't program IP for [k1]P + [k2]Q computation, operation type mismatch.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+
+	/* Run [k1]P + [k2]Q command */
+	t->pt_hw_res.x.sz = t->pt_hw_res.y.sz = NBMAXSZ;
+	if (hw_driver_mul2(t->ptp.x.val, t->ptp.x.sz, t->ptp.y.val, t->ptp.y.sz, t->k.val, t->k.sz,
+				t->ptq.x.val, t->ptq.x.sz, t->ptq.y.val, t->ptq.y.sz, t->k2.val, t->k2.sz,
+				t->pt_hw_res.x.val, &(t->pt_hw_res.x.sz), t->pt_hw_res.y.val, &(t->pt_hw_res.y.sz)))
+	{
+		printf("%sError: [k1]P + [k2]Q computation by hardware triggered an error.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+
+	/*
+	 * Is the result the null point? (aka point at infinity)
+	 */
+	if (hw_driver_point_iszero(1, &is_null)) { /* result point assumed to be R1 */
+		printf("%sError: Getting status of [k1]P + [k2]Q result point (at infinity or not) from hardware triggered an error.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+	t->pt_hw_res.is_null = INT_TO_BOOLEAN(is_null);
+	t->pt_hw_res.valid = true;
+
+	return 0;
+err:
+	return -1;
+}
+
+int check_kp2_result(ipecc_test_t* t, /* stats_t* st, */ bool* res)
+{
+	/*
+	 * Sanity check.
+	 * Verify that computation was actually done on hardware.
+	 */
+	if (t->pt_hw_res.valid == false)
+	{
+		printf("%sError: Can't check result of [k1]P + [k2]Q against expected one, computation didn't happen on hardware.%s\n\r", KERR, KNRM);
+		goto err;
+	}
+
+	if (t->pt_sw_res.is_null == true) {
+		/*
+		 * Expected result is that [k1]P + [k2]Q = 0 (aka point at infinity).
+		 */
+		if (t->pt_hw_res.is_null == true) {
+			PRINTF("[k1]P + [k2]Q = 0 as expected\n\r");
+			*res = true;
+		} else {
+			printf("%sError: [k1]P + [k2]Q mismatch between hardware result and expected one.\n\r"
+						 "         [k1]P + [k2]Q is not 0 however it should be.%s\n\r", KERR, KNRM);
+			*res = false;
+			goto err;
+		}
+	} else {
+		if (t->pt_hw_res.is_null == true) {
+			printf("%sError: [k1]P + [k2]Q mismatch between hardware result and expected one.\n\r"
+						 "         [k1]P + [k2]Q is 0 however it should not be.%s\n\r", KERR, KNRM);
+			*res = false;
+			goto err;
+		} else {
+			/*
+			 * Neither [k1]P + [k2]Q hardware result nor the expected one are null.
+			 * Compare their coordinates.
+			 */
+			if (cmp_two_pts_coords(&(t->pt_sw_res), &(t->pt_hw_res), res))
+			{
+				printf("%sError when comparing coordinates of hardware [k1]P + [k2]Q result with the expected ones.%s\n\r", KERR, KNRM);
+				goto err;
+			}
+			if (*res == true) {
+				PRINTF("[k1]P + [k2]Q results match\n\r");
+			} else {
+				printf("%sError: [k1]P + [k2]Q mismatch between hardware coordinates and those of the expected result.%s\n\r", KERR, KNRM);
+				goto err;
+			}
+		}
+	}
+	return 0;
+err:
+	return -1;
+}
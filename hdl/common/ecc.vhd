@@ -34,7 +34,11 @@ entity ecc is
 		-- width of AXI data bus
 		constant C_S_AXI_DATA_WIDTH : integer := axi32or64; -- in ecc_customize
 		-- width of AXI address bus
-		constant C_S_AXI_ADDR_WIDTH : integer := AXIAW -- in ecc_pkg
+		constant C_S_AXI_ADDR_WIDTH : integer := AXIAW; -- in ecc_pkg
+		-- if TRUE, entropy is received from the TRNG shared between the
+		-- engines of top-level ecc_multi (ports trng*) instead of being
+		-- produced by a TRNG of our own
+		constant C_SHARED_TRNG : boolean := FALSE
 	);
 	port(
 		-- AXI clock
@@ -65,12 +69,50 @@ entity ecc is
 		s_axi_rresp : out std_logic_vector(1 downto 0);
 		s_axi_rvalid : out std_logic;
 		s_axi_rready : in std_logic;
+		-- AXI4 master interface to system memory (only used if parameter
+		-- 'dma' is set in ecc_customize, otherwise outputs are driven low
+		-- and inputs, which default to low, can be left unconnected)
+		m_axi_awaddr : out std_logic_vector(31 downto 0);
+		m_axi_awlen : out std_logic_vector(7 downto 0);
+		m_axi_awsize : out std_logic_vector(2 downto 0);
+		m_axi_awburst : out std_logic_vector(1 downto 0);
+		m_axi_awcache : out std_logic_vector(3 downto 0);
+		m_axi_awprot : out std_logic_vector(2 downto 0);
+		m_axi_awvalid : out std_logic;
+		m_axi_awready : in std_logic := '0';
+		m_axi_wdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		m_axi_wstrb : out std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+		m_axi_wlast : out std_logic;
+		m_axi_wvalid : out std_logic;
+		m_axi_wready : in std_logic := '0';
+		m_axi_bresp : in std_logic_vector(1 downto 0)
+			:= (others => '0');
+		m_axi_bvalid : in std_logic := '0';
+		m_axi_bready : out std_logic;
+		m_axi_araddr : out std_logic_vector(31 downto 0);
+		m_axi_arlen : out std_logic_vector(7 downto 0);
+		m_axi_arsize : out std_logic_vector(2 downto 0);
+		m_axi_arburst : out std_logic_vector(1 downto 0);
+		m_axi_arcache : out std_logic_vector(3 downto 0);
+		m_axi_arprot : out std_logic_vector(2 downto 0);
+		m_axi_arvalid : out std_logic;
+		m_axi_arready : in std_logic := '0';
+		m_axi_rdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0)
+			:= (others => '0');
+		m_axi_rresp : in std_logic_vector(1 downto 0)
+			:= (others => '0');
+		m_axi_rlast : in std_logic := '0';
+		m_axi_rvalid : in std_logic := '0';
+		m_axi_rready : out std_logic;
 		-- clock for Montgomery multipliers in the async case
 		clkmm : in std_logic;
 		-- interrupt
 		irq : out std_logic;
 		-- busy signal for [k]P computation
 		busy : out std_logic;
+		-- [k]P computation requested or running (used by the dispatcher of
+		-- top-level ecc_multi)
+		kpjob : out std_logic;
 		-- debug features
 		--   off-chip trigger
 		dbgtrigger : out std_logic;
@@ -78,7 +120,13 @@ entity ecc is
 		--   pseudo-trng port
 		dbgptdata : in std_logic_vector(7 downto 0);
 		dbgptvalid : in std_logic;
-		dbgptrdy : out std_logic
+		dbgptrdy : out std_logic;
+		-- post-processed entropy from the shared TRNG (only used if generic
+		-- C_SHARED_TRNG is TRUE)
+		trngdata : in std_logic_vector(pp_irn_width - 1 downto 0)
+			:= (others => '0');
+		trngvalid : in std_logic := '0';
+		trngrdy : out std_logic
 	);
 end entity ecc;
 
@@ -166,6 +214,14 @@ architecture struct of ecc is
 			--   other point-based computations
 			dopop : out std_logic;
 			popid : out std_logic_vector(2 downto 0); -- id defined in ecc_pkg
+			popproj : out std_logic;
+			popprojin : out std_logic;
+			popfp : out std_logic;
+			fpopid : out std_logic_vector(2 downto 0);
+			fpmty : out std_logic;
+			decodd : out std_logic;
+			popkp2 : out std_logic;
+			kp2op : out std_logic_vector(1 downto 0);
 			popdone : in std_logic;
 			yes : in std_logic;
 			yesen : in std_logic;
@@ -192,6 +248,8 @@ architecture struct of ecc is
 			--   debug only/
 			-- interface with ecc_curve
 			masklsb : out std_logic;
+			azero : out std_logic;
+			am3 : out std_logic;
 			-- interface with ecc_fp (access to ecc_fp_dram)
 			xwe : out std_logic;
 			xaddr : out std_logic_vector(FP_ADDR - 1 downto 0);
@@ -210,6 +268,7 @@ architecture struct of ecc is
 			trngshfirncount : in std_logic_vector(log2(irn_fifo_size_sh)-1 downto 0);
 			-- broadcast interface to Montgomery multipliers
 			pen : out std_logic;
+			mbank : out std_logic;
 			nndyn_mask : out std_logic_vector(ww - 1 downto 0);
 			nndyn_shrcnt : out unsigned(log2(ww) - 1 downto 0);
 			nndyn_shlcnt : out unsigned(log2(ww) - 1 downto 0);
@@ -225,6 +284,8 @@ architecture struct of ecc is
 			nndyn_nnm3 : out unsigned(log2(nn) - 1 downto 0);
 			-- busy signal for [k]P computation
 			kppending : out std_logic;
+			-- [k]P computation requested or running
+			kpjob : out std_logic;
 			-- software reset (to other components of the IP)
 			swrst : out std_logic;
 			-- debug features (interface with ecc_scalar shared w/ ecc_curve)
@@ -280,6 +341,78 @@ architecture struct of ecc is
 		);
 	end component ecc_axi;
 
+	component ecc_dma is
+		generic(
+			C_S_AXI_DATA_WIDTH : integer := 32;
+			C_S_AXI_ADDR_WIDTH : integer := 8);
+		port(
+			clk : in std_logic;
+			rstn : in std_logic;
+			-- AXI-lite slave interface (from the system)
+			s_axi_awaddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+			s_axi_awvalid : in std_logic;
+			s_axi_awready : out std_logic;
+			s_axi_wdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axi_wvalid : in std_logic;
+			s_axi_wready : out std_logic;
+			s_axi_bvalid : out std_logic;
+			s_axi_bready : in std_logic;
+			s_axi_araddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+			s_axi_arvalid : in std_logic;
+			s_axi_arready : out std_logic;
+			s_axi_rdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axi_rvalid : out std_logic;
+			s_axi_rready : in std_logic;
+			-- AXI-lite master interface (to ecc_axi)
+			e_axi_awaddr : out std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+			e_axi_awvalid : out std_logic;
+			e_axi_awready : in std_logic;
+			e_axi_wdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			e_axi_wvalid : out std_logic;
+			e_axi_wready : in std_logic;
+			e_axi_bvalid : in std_logic;
+			e_axi_bready : out std_logic;
+			e_axi_araddr : out std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+			e_axi_arvalid : out std_logic;
+			e_axi_arready : in std_logic;
+			e_axi_rdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			e_axi_rvalid : in std_logic;
+			e_axi_rready : out std_logic;
+			-- AXI4 master interface (to system memory)
+			m_axi_awaddr : out std_logic_vector(31 downto 0);
+			m_axi_awlen : out std_logic_vector(7 downto 0);
+			m_axi_awsize : out std_logic_vector(2 downto 0);
+			m_axi_awburst : out std_logic_vector(1 downto 0);
+			m_axi_awcache : out std_logic_vector(3 downto 0);
+			m_axi_awprot : out std_logic_vector(2 downto 0);
+			m_axi_awvalid : out std_logic;
+			m_axi_awready : in std_logic;
+			m_axi_wdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			m_axi_wstrb : out std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+			m_axi_wlast : out std_logic;
+			m_axi_wvalid : out std_logic;
+			m_axi_wready : in std_logic;
+			m_axi_bresp : in std_logic_vector(1 downto 0);
+			m_axi_bvalid : in std_logic;
+			m_axi_bready : out std_logic;
+			m_axi_araddr : out std_logic_vector(31 downto 0);
+			m_axi_arlen : out std_logic_vector(7 downto 0);
+			m_axi_arsize : out std_logic_vector(2 downto 0);
+			m_axi_arburst : out std_logic_vector(1 downto 0);
+			m_axi_arcache : out std_logic_vector(3 downto 0);
+			m_axi_arprot : out std_logic_vector(2 downto 0);
+			m_axi_arvalid : out std_logic;
+			m_axi_arready : in std_logic;
+			m_axi_rdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			m_axi_rresp : in std_logic_vector(1 downto 0);
+			m_axi_rlast : in std_logic;
+			m_axi_rvalid : in std_logic;
+			m_axi_rready : out std_logic;
+			-- interrupt
+			irq : out std_logic
+		);
+	end component ecc_dma;
+
 	-- unit handling control of overall [k]P computation
 	component ecc_scalar is
 		port (
@@ -325,6 +458,14 @@ architecture struct of ecc is
 			--   other point-based computations
 			dopop : in std_logic;
 			popid : in std_logic_vector(2 downto 0); -- id defined in ecc_pkg
+			popproj : in std_logic;
+			popprojin : in std_logic;
+			popfp : in std_logic;
+			fpopid : in std_logic_vector(2 downto 0);
+			fpmty : in std_logic;
+			decodd : in std_logic;
+			popkp2 : in std_logic;
+			kp2op : in std_logic_vector(1 downto 0);
 			popdone : out std_logic;
 			yes : out std_logic;
 			yesen : out std_logic;
@@ -393,6 +534,8 @@ architecture struct of ecc is
 			-- interface with ecc_axi
 			masklsb : in std_logic;
 			doblinding : in std_logic;
+			azero : in std_logic;
+			am3 : in std_logic;
 			-- interface with ecc_scalar
 			frdy  : out std_logic;
 			fgo   : in  std_logic;
@@ -472,7 +615,7 @@ architecture struct of ecc is
 		);
 	end component ecc_curve;
 
-	-- double-clock simple dual-port RAM formated as 512 words (opcodes)
+	-- double-clock simple dual-port RAM formated as nbopcodes words (opcodes)
 	-- of 32-bit each, accessed in read-only mode by 'ecc_curve'
 	-- width of both address & data buses is independent of nn 
 	component ecc_curve_iram is
@@ -631,6 +774,45 @@ architecture struct of ecc is
 		);
 	end component ecc_trng;
 
+	-- Server of internal random numbers alone (used instead of ecc_trng
+	-- when entropy comes from the TRNG shared between engines of ecc_multi)
+	component ecc_trng_srv is
+		port(
+			clk : in std_logic;
+			rstn : in std_logic;
+			swrst : in std_logic;
+			-- interface with ecc_scalar
+			irn_reset : in std_logic;
+			-- interface with ecc_trng_pp
+			data_s : in std_logic_vector(pp_irn_width - 1 downto 0);
+			valid_s : in std_logic;
+			rdy_s : out std_logic;
+			-- interface with entropy client ecc_axi
+			rdy0 : in std_logic;
+			valid0 : out std_logic;
+			data0 : out std_logic_vector(ww - 1 downto 0);
+			irncount0 : out std_logic_vector(log2(irn_fifo_size_axi) - 1 downto 0);
+			-- interface with entropy client ecc_fp
+			rdy1 : in std_logic;
+			valid1 : out std_logic;
+			data1 : out std_logic_vector(ww - 1 downto 0);
+			irncount1 : out std_logic_vector(log2(irn_fifo_size_fp) - 1 downto 0);
+			-- interface with entropy client ecc_curve
+			rdy2 : in std_logic;
+			valid2 : out std_logic;
+			data2 : out std_logic_vector(1 downto 0);
+			irncount2 : out std_logic_vector(log2(irn_fifo_size_curve) - 1 downto 0);
+			-- interface with entropy client ecc_fp_dram_sh
+			rdy3 : in std_logic;
+			valid3 : out std_logic;
+			data3 : out std_logic_vector(irn_width_sh - 1 downto 0);
+			irncount3 : out std_logic_vector(log2(irn_fifo_size_sh) - 1 downto 0);
+			-- interface with ecc_axi (only usable in debug mode)
+			dbgtrngcompletebypass : in std_logic;
+			dbgtrngcompletebypassbit : in std_logic
+		);
+	end component ecc_trng_srv;
+
 	-- synchronous simple-dual RAM formated as 512 words of 17-bit each
 	-- functionally divided into 64 contiguous segments of 16 words each
 	-- (each of these segments representing a number of the finite field
@@ -771,9 +953,11 @@ architecture struct of ecc is
 			xyin : in std_logic_vector(ww - 1 downto 0);
 			xen : in std_logic;
 			yen : in std_logic;
+			sq : in std_logic;
 			fpwdata : in std_logic_vector(ww - 1 downto 0);
 			fpwe : in std_logic;
 			pen : in std_logic;
+			mbank : in std_logic;
 			-- signals used only when nn_dynamic = TRUE
 			nndyn_mask : in std_logic_vector(ww - 1 downto 0);
 			nndyn_shrcnt : in unsigned(log2(ww) - 1 downto 0);
@@ -824,6 +1008,14 @@ architecture struct of ecc is
 	signal nndyn_nnm3 : unsigned(log2(nn) - 1 downto 0);
 	signal dopop : std_logic;
 	signal popid : std_logic_vector(2 downto 0);
+	signal popproj : std_logic;
+	signal popprojin : std_logic;
+	signal popfp : std_logic;
+	signal fpopid : std_logic_vector(2 downto 0);
+	signal fpmty : std_logic;
+	signal decodd : std_logic;
+	signal popkp2 : std_logic;
+	signal kp2op : std_logic_vector(1 downto 0);
 	signal popdone : std_logic;
 	signal yes, yesen : std_logic;
 	signal gentoken : std_logic;
@@ -835,8 +1027,11 @@ architecture struct of ecc is
 	signal ar1zo : std_logic;
 	-- signals between ecc_axi & ecc_curve
 	signal masklsb : std_logic;
+	signal azero : std_logic;
+	signal am3 : std_logic;
 	-- signals between ecc_axi & mm_ndsp(s)
 	signal pen : std_logic;
+	signal mbank : std_logic;
 	signal nndyn_mask : std_logic_vector(ww - 1 downto 0);
 	signal nndyn_shrcnt : unsigned(log2(ww) - 1 downto 0);
 	signal nndyn_shlcnt : unsigned(log2(ww) - 1 downto 0);
@@ -1005,6 +1200,18 @@ architecture struct of ecc is
 	-- software reset (to other components of the IP)
 	signal swrst : std_logic;
 
+	-- AXI-lite interface of ecc_axi (driven by ecc_dma if 'dma' is set)
+	signal ea_awaddr : std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+	signal ea_awvalid, ea_awready : std_logic;
+	signal ea_wdata : std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+	signal ea_wvalid, ea_wready : std_logic;
+	signal ea_bvalid, ea_bready : std_logic;
+	signal ea_araddr : std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+	signal ea_arvalid, ea_arready : std_logic;
+	signal ea_rdata : std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+	signal ea_rvalid, ea_rready : std_logic;
+	signal irq_axi, irq_dma : std_logic;
+
 begin
 
 	assert (axi32or64 = 32 or axi32or64 = 64)
@@ -1034,6 +1241,120 @@ begin
 		end if;
 	end process;
 
+	-- ring of job descriptors in system memory (DMA), between the
+	-- AXI-lite interface of the IP & ecc_axi
+	dm0: if dma generate
+		d0: ecc_dma
+			generic map(
+				C_S_AXI_DATA_WIDTH => C_S_AXI_DATA_WIDTH,
+				C_S_AXI_ADDR_WIDTH => C_S_AXI_ADDR_WIDTH)
+			port map(
+				clk => s_axi_aclk,
+				rstn => s_axi_aresetn_resync,
+				-- AXI-lite slave interface (from the system)
+				s_axi_awaddr => s_axi_awaddr,
+				s_axi_awvalid => s_axi_awvalid,
+				s_axi_awready => s_axi_awready,
+				s_axi_wdata => s_axi_wdata,
+				s_axi_wvalid => s_axi_wvalid,
+				s_axi_wready => s_axi_wready,
+				s_axi_bvalid => s_axi_bvalid,
+				s_axi_bready => s_axi_bready,
+				s_axi_araddr => s_axi_araddr,
+				s_axi_arvalid => s_axi_arvalid,
+				s_axi_arready => s_axi_arready,
+				s_axi_rdata => s_axi_rdata,
+				s_axi_rvalid => s_axi_rvalid,
+				s_axi_rready => s_axi_rready,
+				-- AXI-lite master interface (to ecc_axi)
+				e_axi_awaddr => ea_awaddr,
+				e_axi_awvalid => ea_awvalid,
+				e_axi_awready => ea_awready,
+				e_axi_wdata => ea_wdata,
+				e_axi_wvalid => ea_wvalid,
+				e_axi_wready => ea_wready,
+				e_axi_bvalid => ea_bvalid,
+				e_axi_bready => ea_bready,
+				e_axi_araddr => ea_araddr,
+				e_axi_arvalid => ea_arvalid,
+				e_axi_arready => ea_arready,
+				e_axi_rdata => ea_rdata,
+				e_axi_rvalid => ea_rvalid,
+				e_axi_rready => ea_rready,
+				-- AXI4 master interface (to system memory)
+				m_axi_awaddr => m_axi_awaddr,
+				m_axi_awlen => m_axi_awlen,
+				m_axi_awsize => m_axi_awsize,
+				m_axi_awburst => m_axi_awburst,
+				m_axi_awcache => m_axi_awcache,
+				m_axi_awprot => m_axi_awprot,
+				m_axi_awvalid => m_axi_awvalid,
+				m_axi_awready => m_axi_awready,
+				m_axi_wdata => m_axi_wdata,
+				m_axi_wstrb => m_axi_wstrb,
+				m_axi_wlast => m_axi_wlast,
+				m_axi_wvalid => m_axi_wvalid,
+				m_axi_wready => m_axi_wready,
+				m_axi_bresp => m_axi_bresp,
+				m_axi_bvalid => m_axi_bvalid,
+				m_axi_bready => m_axi_bready,
+				m_axi_araddr => m_axi_araddr,
+				m_axi_arlen => m_axi_arlen,
+				m_axi_arsize => m_axi_arsize,
+				m_axi_arburst => m_axi_arburst,
+				m_axi_arcache => m_axi_arcache,
+				m_axi_arprot => m_axi_arprot,
+				m_axi_arvalid => m_axi_arvalid,
+				m_axi_arready => m_axi_arready,
+				m_axi_rdata => m_axi_rdata,
+				m_axi_rresp => m_axi_rresp,
+				m_axi_rlast => m_axi_rlast,
+				m_axi_rvalid => m_axi_rvalid,
+				m_axi_rready => m_axi_rready,
+				-- interrupt
+				irq => irq_dma);
+	end generate;
+
+	ndm0: if not dma generate
+		ea_awaddr <= s_axi_awaddr;
+		ea_awvalid <= s_axi_awvalid;
+		s_axi_awready <= ea_awready;
+		ea_wdata <= s_axi_wdata;
+		ea_wvalid <= s_axi_wvalid;
+		s_axi_wready <= ea_wready;
+		s_axi_bvalid <= ea_bvalid;
+		ea_bready <= s_axi_bready;
+		ea_araddr <= s_axi_araddr;
+		ea_arvalid <= s_axi_arvalid;
+		s_axi_arready <= ea_arready;
+		s_axi_rdata <= ea_rdata;
+		s_axi_rvalid <= ea_rvalid;
+		ea_rready <= s_axi_rready;
+		m_axi_awaddr <= (others => '0');
+		m_axi_awlen <= (others => '0');
+		m_axi_awsize <= (others => '0');
+		m_axi_awburst <= (others => '0');
+		m_axi_awcache <= (others => '0');
+		m_axi_awprot <= (others => '0');
+		m_axi_awvalid <= '0';
+		m_axi_wdata <= (others => '0');
+		m_axi_wstrb <= (others => '0');
+		m_axi_wlast <= '0';
+		m_axi_wvalid <= '0';
+		m_axi_bready <= '0';
+		m_axi_araddr <= (others => '0');
+		m_axi_arlen <= (others => '0');
+		m_axi_arsize <= (others => '0');
+		m_axi_arburst <= (others => '0');
+		m_axi_arcache <= (others => '0');
+		m_axi_arprot <= (others => '0');
+		m_axi_arvalid <= '0';
+		m_axi_rready <= '0';
+		irq_dma <= '0';
+	end generate;
+
+	irq <= irq_axi or irq_dma;
+
 	-- AXI-lite interface
 	a0: ecc_axi
 		generic map(
@@ -1044,31 +1365,31 @@ begin
 			s_axi_aclk => s_axi_aclk,
 			s_axi_aresetn => s_axi_aresetn_resync,
 			-- AXI write-address channel
-			s_axi_awaddr => s_axi_awaddr,
+			s_axi_awaddr => ea_awaddr,
 			s_axi_awprot => s_axi_awprot,
-			s_axi_awvalid => s_axi_awvalid,
-			s_axi_awready => s_axi_awready,
+			s_axi_awvalid => ea_awvalid,
+			s_axi_awready => ea_awready,
 			-- AXI write-data channel
-			s_axi_wdata => s_axi_wdata,
+			s_axi_wdata => ea_wdata,
 			s_axi_wstrb => s_axi_wstrb,
-			s_axi_wvalid => s_axi_wvalid,
-			s_axi_wready => s_axi_wready,
+			s_axi_wvalid => ea_wvalid,
+			s_axi_wready => ea_wready,
 			-- AXI write-response channel
 			s_axi_bresp => s_axi_bresp,
-			s_axi_bvalid => s_axi_bvalid,
-			s_axi_bready => s_axi_bready,
+			s_axi_bvalid => ea_bvalid,
+			s_axi_bready => ea_bready,
 			-- AXI read-address channel
-			s_axi_araddr => s_axi_araddr,
+			s_axi_araddr => ea_araddr,
 			s_axi_arprot => s_axi_arprot,
-			s_axi_arvalid => s_axi_arvalid,
-			s_axi_arready => s_axi_arready,
+			s_axi_arvalid => ea_arvalid,
+			s_axi_arready => ea_arready,
 			-- AXI read-data channel
-			s_axi_rdata => s_axi_rdata,
+			s_axi_rdata => ea_rdata,
 			s_axi_rresp => s_axi_rresp,
-			s_axi_rvalid => s_axi_rvalid,
-			s_axi_rready => s_axi_rready,
+			s_axi_rvalid => ea_rvalid,
+			s_axi_rready => ea_rready,
 			-- interrupt
-			irq => irq,
+			irq => irq_axi,
 			-- interface with ecc_scalar
 			--   general
 			initdone => initdone,
@@ -1106,6 +1427,14 @@ begin
 			--   other point-based computations
 			dopop => dopop,
 			popid => popid,
+			popproj => popproj,
+			popprojin => popprojin,
+			popfp => popfp,
+			fpopid => fpopid,
+			fpmty => fpmty,
+			decodd => decodd,
+			popkp2 => popkp2,
+			kp2op => kp2op,
 			popdone => popdone,
 			yes => yes,
 			yesen => yesen,
@@ -1132,6 +1461,8 @@ begin
 			--   debug only/
 			-- interface with ecc_curve
 			masklsb => masklsb,
+			azero => azero,
+			am3 => am3,
 			-- interface with ecc_fp (access to ecc_fp_dram)
 			xwe => xwe,
 			xaddr => xaddr,
@@ -1150,6 +1481,7 @@ begin
 			trngshfirncount => trngshfirncount,
 			-- broadcast interface to Montgomery multipliers
 			pen => pen,
+			mbank => mbank,
 			nndyn_mask => nndyn_mask,
 			nndyn_shrcnt => nndyn_shrcnt,
 			nndyn_shlcnt => nndyn_shlcnt,
@@ -1165,6 +1497,7 @@ begin
 			nndyn_nnm3 => nndyn_nnm3,
 			-- general busy signal
 			kppending => busy,
+			kpjob => kpjob,
 			-- software reset (to other components of the IP)
 			swrst => swrst,
 			-- debug features (interface with ecc_scalar)
@@ -1263,6 +1596,14 @@ begin
 			--   other point-based computations
 			dopop => dopop,
 			popid => popid,
+			popproj => popproj,
+			popprojin => popprojin,
+			popfp => popfp,
+			fpopid => fpopid,
+			fpmty => fpmty,
+			decodd => decodd,
+			popkp2 => popkp2,
+			kp2op => kp2op,
 			popdone => popdone,
 			yes => yes,
 			yesen => yesen,
@@ -1330,6 +1671,8 @@ begin
 			-- interface with ecc_axi
 			masklsb => masklsb,
 			doblinding => doblinding,
+			azero => azero,
+			am3 => am3,
 			-- interface with ecc_scalar
 			frdy => frdy,
 			fgo => fgo,
@@ -1510,53 +1853,100 @@ begin
 		); -- ecc_fp
 
 	-- TRNG
-	t0: ecc_trng
-		port map(
-			clk => s_axi_aclk,
-			rstn => s_axi_aresetn_resync,
-			swrst => swrst,
-			-- interface with ecc_scalar
-			irn_reset => dbgtrngirnreset,
-			-- interface with entropy client ecc_axi
-			rdy0 => trng_rdy_axi,
-			valid0 => trng_valid_axi,
-			data0 => trng_data_axi,
-			irncount0 => trngaxiirncount,
-			-- interface with entropy client ecc_fp
-			rdy1 => trng_rdy_fp,
-			valid1 => trng_valid_fp,
-			data1 => trng_data_fp,
-			irncount1 => trngefpirncount,
-			-- interface with entropy client ecc_curve
-			rdy2 => trng_rdy_curve,
-			valid2 => trng_valid_curve,
-			data2 => trng_data_curve,
-			irncount2 => trngcurirncount,
-			-- interface with entropy client ecc_fp_dram_sh
-			rdy3 => trng_rdy_sh,
-			valid3 => trng_valid_sh,
-			data3 => trng_data_sh,
-			irncount3 => trngshfirncount,
-			-- interface with ecc_axi (only usable in debug mode)
-			dbgtrngta => dbgtrngta,
-			dbgtrngrawreset => dbgtrngrawreset,
-			dbgtrngrawfull => dbgtrngrawfull,
-			dbgtrngrawwaddr => dbgtrngrawwaddr,
-			dbgtrngrawraddr => dbgtrngrawraddr,
-			dbgtrngrawdata => dbgtrngrawdata,
-			dbgtrngrawfiforeaddis => dbgtrngrawfiforeaddis,
-			dbgtrngcompletebypass => dbgtrngcompletebypass,
-			dbgtrngcompletebypassbit => dbgtrngcompletebypassbit,
-			dbgtrngrawduration => dbgtrngrawduration,
-			dbgtrngvonneuman => dbgtrngvonneuman,
-			dbgtrngidletime => dbgtrngidletime,
-			dbgtrngusepseudosource => dbgtrngusepseudosource,
-			dbgtrngrawpullppdis => dbgtrngrawpullppdis,
-			-- interface with the external pseudo TRNG component
-			dbgpseudotrngdata => dbgptdata,
-			dbgpseudotrngvalid => dbgptvalid,
-			dbgpseudotrngrdy => dbgptrdy
-		); -- ecc_trng
+	t0: if not C_SHARED_TRNG generate
+		t0: ecc_trng
+			port map(
+				clk => s_axi_aclk,
+				rstn => s_axi_aresetn_resync,
+				swrst => swrst,
+				-- interface with ecc_scalar
+				irn_reset => dbgtrngirnreset,
+				-- interface with entropy client ecc_axi
+				rdy0 => trng_rdy_axi,
+				valid0 => trng_valid_axi,
+				data0 => trng_data_axi,
+				irncount0 => trngaxiirncount,
+				-- interface with entropy client ecc_fp
+				rdy1 => trng_rdy_fp,
+				valid1 => trng_valid_fp,
+				data1 => trng_data_fp,
+				irncount1 => trngefpirncount,
+				-- interface with entropy client ecc_curve
+				rdy2 => trng_rdy_curve,
+				valid2 => trng_valid_curve,
+				data2 => trng_data_curve,
+				irncount2 => trngcurirncount,
+				-- interface with entropy client ecc_fp_dram_sh
+				rdy3 => trng_rdy_sh,
+				valid3 => trng_valid_sh,
+				data3 => trng_data_sh,
+				irncount3 => trngshfirncount,
+				-- interface with ecc_axi (only usable in debug mode)
+				dbgtrngta => dbgtrngta,
+				dbgtrngrawreset => dbgtrngrawreset,
+				dbgtrngrawfull => dbgtrngrawfull,
+				dbgtrngrawwaddr => dbgtrngrawwaddr,
+				dbgtrngrawraddr => dbgtrngrawraddr,
+				dbgtrngrawdata => dbgtrngrawdata,
+				dbgtrngrawfiforeaddis => dbgtrngrawfiforeaddis,
+				dbgtrngcompletebypass => dbgtrngcompletebypass,
+				dbgtrngcompletebypassbit => dbgtrngcompletebypassbit,
+				dbgtrngrawduration => dbgtrngrawduration,
+				dbgtrngvonneuman => dbgtrngvonneuman,
+				dbgtrngidletime => dbgtrngidletime,
+				dbgtrngusepseudosource => dbgtrngusepseudosource,
+				dbgtrngrawpullppdis => dbgtrngrawpullppdis,
+				-- interface with the external pseudo TRNG component
+				dbgpseudotrngdata => dbgptdata,
+				dbgpseudotrngvalid => dbgptvalid,
+				dbgpseudotrngrdy => dbgptrdy
+			); -- ecc_trng
+		trngrdy <= '0';
+	end generate;
+
+	-- server of internal random numbers fed by the shared TRNG of ecc_multi
+	-- (the raw entropy source & its debug features being then outside)
+	ts0: if C_SHARED_TRNG generate
+		ts0: ecc_trng_srv
+			port map(
+				clk => s_axi_aclk,
+				rstn => s_axi_aresetn_resync,
+				swrst => swrst,
+				irn_reset => dbgtrngirnreset,
+				-- interface with the shared ecc_trng_pp
+				data_s => trngdata,
+				valid_s => trngvalid,
+				rdy_s => trngrdy,
+				-- interface with entropy client ecc_axi
+				rdy0 => trng_rdy_axi,
+				valid0 => trng_valid_axi,
+				data0 => trng_data_axi,
+				irncount0 => trngaxiirncount,
+				-- interface with entropy client ecc_fp
+				rdy1 => trng_rdy_fp,
+				valid1 => trng_valid_fp,
+				data1 => trng_data_fp,
+				irncount1 => trngefpirncount,
+				-- interface with entropy client ecc_curve
+				rdy2 => trng_rdy_curve,
+				valid2 => trng_valid_curve,
+				data2 => trng_data_curve,
+				irncount2 => trngcurirncount,
+				-- interface with entropy client ecc_fp_dram_sh
+				rdy3 => trng_rdy_sh,
+				valid3 => trng_valid_sh,
+				data3 => trng_data_sh,
+				irncount3 => trngshfirncount,
+				-- interface with ecc_axi (only usable in debug mode)
+				dbgtrngcompletebypass => dbgtrngcompletebypass,
+				dbgtrngcompletebypassbit => dbgtrngcompletebypassbit
+			);
+		dbgtrngrawfull <= '0';
+		dbgtrngrawwaddr <= (others => '0');
+		dbgtrngrawdata <= '0';
+		dbgtrngrawduration <= (others => '0');
+		dbgptrdy <= '0';
+	end generate;
 
 	-- static-memory storing temporary variables read-&-written
 	-- by instructions of programs executed by ecc_curve
@@ -1705,9 +2095,11 @@ begin
 				xyin => mmi(i).xy,
 				xen => mmi(i).xen,
 				yen => mmi(i).yen,
+				sq => mmi(i).sq,
 				fpwdata => fpwdata,
 				fpwe => fpwe,
 				pen => pen,
+				mbank => mbank,
 				nndyn_mask => nndyn_mask,
 				nndyn_shrcnt => nndyn_shrcnt,
 				nndyn_shlcnt => nndyn_shlcnt,
@@ -1777,6 +2169,9 @@ begin
 		else
 			echo(", no shuffle avail");
 		end if;
+		if dma then
+			echo(", dma ring");
+		end if;
 		echo(", debug ");
 		if debug then
 			echo("ON");
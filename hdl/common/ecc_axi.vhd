@@ -102,6 +102,14 @@ entity ecc_axi is
 		--   other point-based computations
 		dopop : out std_logic;
 		popid : out std_logic_vector(2 downto 0); -- id defined in ecc_pkg
+		popproj : out std_logic;
+		popprojin : out std_logic;
+		popfp : out std_logic; -- field arithmetic operation
+		fpopid : out std_logic_vector(2 downto 0); -- id defined in ecc_pkg
+		fpmty : out std_logic; -- operands & result in Montgomery form
+		decodd : out std_logic; -- point decompression: odd square root
+		popkp2 : out std_logic; -- double scalar multiplication (popid ignored)
+		kp2op : out std_logic_vector(1 downto 0); -- id defined in ecc_pkg
 		popdone : in std_logic;
 		yes : in std_logic;
 		yesen : in std_logic;
@@ -128,6 +136,8 @@ entity ecc_axi is
 		--   end of debug only/
 		-- interface with ecc_curve
 		masklsb : out std_logic;
+		azero : out std_logic;
+		am3 : out std_logic;
 		-- interface with ecc_fp (access to ecc_fp_dram)
 		xwe : out std_logic;
 		xaddr : out std_logic_vector(FP_ADDR - 1 downto 0);
@@ -146,6 +156,7 @@ entity ecc_axi is
 		trngshfirncount : in std_logic_vector(log2(irn_fifo_size_sh) - 1 downto 0);
 		-- broadcast interface to Montgomery multipliers
 		pen : out std_logic;
+		mbank : out std_logic;
 		nndyn_mask : out std_logic_vector(ww - 1 downto 0);
 		nndyn_shrcnt : out unsigned(log2(ww) - 1 downto 0);
 		nndyn_shlcnt : out unsigned(log2(ww) - 1 downto 0);
@@ -161,6 +172,9 @@ entity ecc_axi is
 		nndyn_nnm3 : out unsigned(log2(nn) - 1 downto 0);
 		-- busy signal for [k]P computation
 		kppending : out std_logic;
+		-- [k]P computation requested (including the copy of the point that
+		-- precedes it for [k]G & slots) or running
+		kpjob : out std_logic;
 		-- software reset (to other components of the IP)
 		swrst : out std_logic;
 		-- debug features (interface with ecc_scalar)
@@ -285,6 +299,8 @@ architecture rtl of ecc_axi is
 		rnd : reg_rnd_write_type;
 		active : std_logic;
 		busy : std_logic;
+		stage, fpwestg : std_logic;
+		jobq, fpwejq : std_logic;
 	end record;
 
 	type reg_read_type is record
@@ -305,6 +321,7 @@ architecture rtl of ecc_axi is
 		busy : std_logic;
 		trngreading : std_logic;
 		token : std_logic;
+		jobq, jobqres : std_logic;
 	end record;
 
 	constant BLNDSHSZ : natural := 4;
@@ -347,6 +364,16 @@ architecture rtl of ecc_axi is
 		doshuffle : std_logic;
 		dopop : std_logic;
 		popid : std_logic_vector(2 downto 0); -- id defined in ecc_pkg
+		popproj : std_logic;
+		popprojin : std_logic;
+		popfp : std_logic;
+		fpopid : std_logic_vector(2 downto 0);
+		fpmty : std_logic;
+		decodd : std_logic;
+		popkp2 : std_logic;
+		kp2op : std_logic_vector(1 downto 0);
+		kp2ld : std_logic; -- P1 & P2 loaded for [k1]P1 + [k2]P2
+		proj : std_logic; -- R1 holds a point in projective form
 		poppending : std_logic;
 		popdone_d : std_logic;
 		yes : std_logic;
@@ -356,6 +383,8 @@ architecture rtl of ecc_axi is
 		p_set_and_mty : std_logic;
 		a_set : std_logic;
 		a_set_and_mty : std_logic;
+		azero : std_logic; -- software declared a = 0
+		am3 : std_logic; -- software declared a = -3
 		b_set : std_logic;
 		q_set : std_logic;
 		k_set : std_logic;
@@ -508,6 +537,113 @@ architecture rtl of ecc_axi is
 		-- pragma translate_on
 	end record;
 
+	-- resident point memory (stored base point & point slots, see (s266)
+	-- and (s278))
+	subtype ptslot_type is std_logic_vector(PT_SLOT_SZ - 1 downto 0);
+	subtype ptslots_type is std_logic_vector(2**PT_SLOT_SZ - 1 downto 0);
+	type reg_bp_type is record
+		-- capture of XR1/YR1 writes into slot .wslot
+		capture : std_logic;
+		wslot : ptslot_type;
+		xvalid : ptslots_type;
+		yvalid : ptslots_type;
+		isnull : ptslots_type;
+		-- copy-in (slot .rslot -> R0 or R1)
+		copy : std_logic;
+		kg : std_logic;
+		dst : std_logic; -- '0': R0, '1': R1
+		rslot : ptslot_type;
+		raddr : std_logic_vector(FP_ADDR_LSB downto 0);
+		rvalid : std_logic;
+		rfpaddr : std_logic_vector(FP_ADDR - 1 downto 0);
+		gosh : std_logic_vector(1 downto 0);
+		-- copy-out (R1 -> slot .sslot)
+		save : std_logic;
+		sslot : ptslot_type;
+		saddr : std_logic_vector(FP_ADDR_LSB downto 0);
+		sre : std_logic;
+		ssh : std_logic_vector(readlat downto 0);
+		swaddr : std_logic_vector(FP_ADDR_LSB downto 0);
+	end record;
+
+	-- job queue (shadow scalar, masks, token & point of the next [k]P jobs
+	-- and results of the last ones, see (s292))
+	-- pointers have one more bit than the index of an entry so as to tell
+	-- a full queue from an empty one
+	subtype jobq_ptr_type is unsigned(JOBQ_SZ downto 0);
+	subtype jobq_flags_type is std_logic_vector(2**JOBQ_SZ - 1 downto 0);
+	type reg_jobq_type is record
+		head : jobq_ptr_type; -- oldest job not popped yet
+		done : jobq_ptr_type; -- oldest job not computed yet
+		run : jobq_ptr_type; -- oldest job not launched yet
+		tail : jobq_ptr_type; -- next entry to open
+		-- filling of entry .tail by software
+		isopen : std_logic;
+		tokgen : std_logic;
+		taddr : unsigned(FP_ADDR_LSB - 1 downto 0);
+		twe : std_logic;
+		twaddr : std_logic_vector(FP_ADDR_LSB - 1 downto 0);
+		twdata : std_logic_vector(ww - 1 downto 0);
+		wknull : std_logic;
+		-- description of each entry
+		arith : jobq_flags_type; -- scalar masked arithmetically (blinding)
+		knull : jobq_flags_type;
+		masklsb : jobq_flags_type;
+		kset : jobq_flags_type;
+		xset : jobq_flags_type;
+		yset : jobq_flags_type;
+		tokread : jobq_flags_type;
+		rnull : jobq_flags_type;
+		errin : jobq_flags_type;
+		errout : jobq_flags_type;
+		-- R_READ_DATA is bound to the result of entry .head
+		res : std_logic;
+		rdata : std_logic_vector(ww - 1 downto 0);
+		-- copy-in (entry .run -> ecc_fp_dram)
+		copy : std_logic;
+		page : std_logic_vector(2 downto 0);
+		raddr : std_logic_vector(FP_ADDR_LSB - 1 downto 0);
+		rvalid : std_logic;
+		rfpaddr : std_logic_vector(FP_ADDR - 1 downto 0);
+		fpwe : std_logic;
+		xaddr : std_logic_vector(FP_ADDR - 1 downto 0);
+		fpwdata : std_logic_vector(ww - 1 downto 0);
+		gosh : std_logic_vector(1 downto 0);
+		kp : std_logic; -- a job of the queue is being computed
+		-- copy-out (R1 -> result of entry .done)
+		save : std_logic;
+		saddr : std_logic_vector(FP_ADDR_LSB downto 0);
+		sre : std_logic;
+		ssh : std_logic_vector(readlat downto 0);
+		swaddr : std_logic_vector(FP_ADDR_LSB downto 0);
+		-- nb of cycles between two jobs run back-to-back
+		gapon : std_logic;
+		gapcnt : unsigned(JOBQ_GAP_MSB - JOBQ_GAP_LSB downto 0);
+		gap : unsigned(JOBQ_GAP_MSB - JOBQ_GAP_LSB downto 0);
+		gapvalid : std_logic;
+	end record;
+
+	-- contexts of the two moduli p & q (see (s308)): each one is made of
+	-- the modulus itself and of its constants R2modp, twop & Rmodp
+	type reg_mc_type is record
+		modq : std_logic; -- '1': the modulus in use is q
+		pvalid : std_logic; -- context of p saved
+		qvalid : std_logic; -- context of q saved
+		savepending : std_logic;
+		-- copy-out (ecc_fp_dram -> context .modq)
+		save : std_logic;
+		saddr : std_logic_vector(FP_ADDR_LSB + 1 downto 0); -- number & limb
+		sre : std_logic;
+		ssh : std_logic_vector(readlat downto 0);
+		swaddr : std_logic_vector(FP_ADDR_LSB + 1 downto 0);
+		-- copy-in (context .modq -> ecc_fp_dram)
+		copy : std_logic;
+		raddr : std_logic_vector(FP_ADDR_LSB + 1 downto 0);
+		rvalid : std_logic;
+		rfpaddr : std_logic_vector(FP_ADDR - 1 downto 0);
+		gosh : std_logic_vector(1 downto 0);
+	end record;
+
 	-- all registers
 	type reg_type is record
 		axi : reg_axi_type;
@@ -518,9 +654,28 @@ architecture rtl of ecc_axi is
 		ctrl : ctrl_reg_type;
 		nndyn : nndyn_reg_type;
 		debug : debug_reg_type;
+		bp : reg_bp_type;
+		jobq : reg_jobq_type;
+		mc : reg_mc_type;
 	end record;
 
 	signal r, rin : reg_type;
+	signal bp_we : std_logic;
+	signal bp_waddr : std_logic_vector(PT_SLOT_SZ + FP_ADDR_LSB downto 0);
+	signal bp_wdata : std_logic_vector(ww - 1 downto 0);
+	signal bp_rdata : std_logic_vector(ww - 1 downto 0);
+	signal qb_we : std_logic;
+	signal qb_waddr : std_logic_vector(JOBQ_SZ + 2 + FP_ADDR_LSB downto 0);
+	signal qb_wdata : std_logic_vector(ww - 1 downto 0);
+	signal qb_raddr : std_logic_vector(JOBQ_SZ + 2 + FP_ADDR_LSB downto 0);
+	signal qb_rdata : std_logic_vector(ww - 1 downto 0);
+	signal rs_we : std_logic;
+	signal rs_waddr : std_logic_vector(JOBQ_SZ + FP_ADDR_LSB downto 0);
+	signal rs_raddr : std_logic_vector(JOBQ_SZ + FP_ADDR_LSB downto 0);
+	signal rs_rdata : std_logic_vector(ww - 1 downto 0);
+	signal mc_we : std_logic;
+	signal mc_waddr : std_logic_vector(FP_ADDR_LSB + 2 downto 0);
+	signal mc_rdata : std_logic_vector(ww - 1 downto 0);
 	signal nndyn_mask_s : std_logic_vector(ww - 1 downto 0);
 	signal nndyn_mask_is_zero_s : std_logic;
 	signal nndyn_mask_is_all1_but_msb_s : std_logic;
@@ -532,9 +687,95 @@ architecture rtl of ecc_axi is
 	signal nndyn_mask_wm2_s : std_logic;
 	signal nndyn_wmin_s : unsigned(log2(2*w - 1) - 1 downto 0);
 	signal nndyn_nnrnd_zerowm1_s : std_logic;
+	signal nndyn_nnrnd_mask_s : std_logic_vector(ww - 1 downto 0);
 	signal nndyn_nnp1_s : unsigned(log2(nn + 1) - 1 downto 0);
 	signal nndyn_nnm3_s : unsigned(log2(nn) - 1 downto 0);
 
+	-- pages of an entry of the job queue memory (see (s292)): the scalar
+	-- (two pages when blinding is active), its masks (idem), the token and
+	-- the two coordinates of the input point
+	constant JOBQ_PG_K0 : std_logic_vector(2 downto 0) := "000";
+	constant JOBQ_PG_K1 : std_logic_vector(2 downto 0) := "001";
+	constant JOBQ_PG_M0 : std_logic_vector(2 downto 0) := "010";
+	constant JOBQ_PG_M1 : std_logic_vector(2 downto 0) := "011";
+	constant JOBQ_PG_X : std_logic_vector(2 downto 0) := "100";
+	constant JOBQ_PG_Y : std_logic_vector(2 downto 0) := "101";
+	constant JOBQ_PG_TOK : std_logic_vector(2 downto 0) := "110";
+
+	-- page of the job queue memory which a large number of ecc_fp_dram
+	-- is captured into
+	function jobq_page(fppg : std_logic_vector(FP_ADDR_MSB - 1 downto 0))
+		return std_logic_vector is
+		variable pg : std_logic_vector(2 downto 0);
+	begin
+		if fppg = CST_ADDR_K then
+			pg := JOBQ_PG_K0;
+		elsif unsigned(fppg) = LARGE_NB_K_ADDR + 1 then
+			pg := JOBQ_PG_K1;
+		elsif unsigned(fppg) = CST_ARITH_MASK_0
+			or unsigned(fppg) = CST_LOGIC_MASK_0
+		then
+			pg := JOBQ_PG_M0;
+		elsif unsigned(fppg) = CST_ARITH_MASK_1
+			or unsigned(fppg) = CST_LOGIC_MASK_1
+		then
+			pg := JOBQ_PG_M1;
+		elsif fppg = CST_ADDR_XR1 then
+			pg := JOBQ_PG_X;
+		elsif fppg = CST_ADDR_YR1 then
+			pg := JOBQ_PG_Y;
+		else
+			pg := JOBQ_PG_TOK;
+		end if;
+		return pg;
+	end function jobq_page;
+
+	-- large number of ecc_fp_dram which a page of the job queue memory is
+	-- copied into (the masks of the scalar depend on the kind of masking)
+	function jobq_fppage(pg : std_logic_vector(2 downto 0); arith : std_logic)
+		return std_logic_vector is
+		variable fppg : std_logic_vector(FP_ADDR_MSB - 1 downto 0);
+	begin
+		if pg = JOBQ_PG_K0 then
+			fppg := CST_ADDR_K;
+		elsif pg = JOBQ_PG_K1 then
+			fppg := std_nat(LARGE_NB_K_ADDR + 1, FP_ADDR_MSB);
+		elsif pg = JOBQ_PG_M0 and arith = '1' then
+			fppg := std_nat(CST_ARITH_MASK_0, FP_ADDR_MSB);
+		elsif pg = JOBQ_PG_M0 then
+			fppg := std_nat(CST_LOGIC_MASK_0, FP_ADDR_MSB);
+		elsif pg = JOBQ_PG_M1 and arith = '1' then
+			fppg := std_nat(CST_ARITH_MASK_1, FP_ADDR_MSB);
+		elsif pg = JOBQ_PG_M1 then
+			fppg := std_nat(CST_LOGIC_MASK_1, FP_ADDR_MSB);
+		elsif pg = JOBQ_PG_X then
+			fppg := CST_ADDR_XR1;
+		elsif pg = JOBQ_PG_Y then
+			fppg := CST_ADDR_YR1;
+		else
+			fppg := CST_ADDR_TOKEN;
+		end if;
+		return fppg;
+	end function jobq_fppage;
+
+	-- large number of ecc_fp_dram which a number of a modulus context is
+	-- saved from & restored into (see (s308))
+	function mc_fppage(nb : std_logic_vector(1 downto 0))
+		return std_logic_vector is
+		variable fppg : std_logic_vector(FP_ADDR_MSB - 1 downto 0);
+	begin
+		if nb = "00" then
+			fppg := CST_ADDR_P;
+		elsif nb = "01" then
+			fppg := std_nat(LARGE_NB_R2MODP_ADDR, FP_ADDR_MSB);
+		elsif nb = "10" then
+			fppg := CST_ADDR_TWOP;
+		else
+			fppg := std_nat(LARGE_NB_RMODP_ADDR, FP_ADDR_MSB);
+		end if;
+		return fppg;
+	end function mc_fppage;
+
 	-- pragma translate_off
 	signal r_ctrl_wk : std_logic;
 	constant xnn : positive := C_S_AXI_DATA_WIDTH*div(2*nn, C_S_AXI_DATA_WIDTH);
@@ -587,6 +828,25 @@ begin
 				 & "register R_DBG_STATUS wouldn't be correct)."
 			severity FAILURE;
 
+	-- (s284) bits CAP_DEC, CAP_KP2, CAP_DMA & CAP_FOP sit above field
+	-- CAP_NNMAX in R_CAPABILITIES (see also set_cap_nnmax_width in ecc_pkg)
+	assert (CAP_NNMAX_MSB < CAP_DEC)
+		report "Value of parameter nn too large to be compatible w/ layout "
+		     & "of register R_CAPABILITIES."
+			severity FAILURE;
+
+	-- (s307) counts of entries in R_JOBQ_STATUS are on 4 bits, see (s305)
+	assert (JOBQ_SZ <= 3)
+		report "Value of parameter JOBQ_SZ too large to be compatible w/ layout "
+		     & "of register R_JOBQ_STATUS."
+			severity FAILURE;
+
+	-- (s309) the context of q needs the 2nd bank of P & P' pages in the IRAM
+	-- memory of mm_ndsp, which only exists if async = TRUE (see (s308))
+	assert ((not qcontext) or async)
+		report "Parameter qcontext requires parameter async to be set."
+			severity FAILURE;
+
 	-- (s195), see (s194)
 	assert (axi32or64 = 32 or axi32or64 = 64)
 		report "Wrong value of parameter axi32or64 in ecc_customize.vhd "
@@ -610,6 +870,13 @@ begin
 		     & integer'image(32 - DBG_CAP_SPLIT) & "."
 			severity FAILURE;
 
+	-- (s271), see (s270)
+	assert ((LARGE_NB_XR1_ADDR mod 2) = 0
+	        and LARGE_NB_YR1_ADDR = LARGE_NB_XR1_ADDR + 1)
+		report "Addresses of XR1 & YR1 must only differ by their LSbit (copy "
+		     & "of the stored base point relies on it)."
+			severity FAILURE;
+
 	-- (s150), see (s151)
 	assert (log2(raw_ram_size) <= DBG_CAP_SPLIT)
 		report "In debug mode bit-width of parameter raw_ram_size must not "
@@ -675,6 +942,7 @@ begin
 	              , nndyn_wm2_s, nndyn_wm1_s, nndyn_2wm1_s,
 	              nndyn_mask_is_zero_s, nndyn_mask_is_all1_but_msb_s,
 	              nndyn_mask_wm2_s, nndyn_wmin_s, nndyn_nnrnd_zerowm1_s,
+	              nndyn_nnrnd_mask_s, qb_rdata, rs_rdata, mc_rdata,
 	              nndyn_nnm3_s, nndyn_nnp1_s,
 	              small_k_sz_en_ack, small_k_sz_kpdone,
 	              dbgtrngaxirdy, dbgtrngaxivalid, dbgtrngfprdy, dbgtrngfpvalid,
@@ -702,7 +970,8 @@ begin
 		variable vtmp4 : unsigned(log2(w) + 1 downto 0);
 		variable vtmp5 : unsigned(log2(w) + 1 downto 0);
 		variable dw : std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
-		variable v_pop_possible, v_kp_possible : boolean;
+		variable v_pop_possible, v_kp_possible, v_fop_possible : boolean;
+		variable v_stage_possible : boolean;
 		variable v_busy, v_wlock : boolean;
 		variable vtmp6 : unsigned(BLD_BITS_MSB - BLD_BITS_LSB + 1 downto 0);
 		variable vtmp7 : unsigned(BLD_BITS_MSB - BLD_BITS_LSB + 1 downto 0);
@@ -715,6 +984,11 @@ begin
 		variable v_axi_wdatax_msb : std_logic_vector(FP_ADDR_MSB - 1 downto 0);
 		variable v_fpaddr0_msb : std_logic_vector(FP_ADDR_MSB - 1 downto 0);
 		variable v_read_no_error : boolean;
+		variable v_jobq_busy, v_jobq_launch, v_jobq_wr, v_jobq_rd : boolean;
+		variable v_jobq_irq : boolean;
+		variable v_mc_save : boolean;
+		variable v_jobq_t, v_jobq_h, v_jobq_d, v_jobq_r :
+			natural range 0 to 2**JOBQ_SZ - 1;
 		variable vtmp19, vtmp20, vtmp21 : unsigned(log2(nn - 1) downto 0);
 	begin
 		v := r;
@@ -867,14 +1141,20 @@ begin
 		--                         -> r.ctrl.ierrid
 		--   The max number of cycles for the constraint should match the minimum
 		--   nb of cycles to be expected between 2 AXI transactions
+		-- (point-based operations are refused while q is the modulus in use,
+		-- see (s308))
 		if (r.ctrl.p_set and r.ctrl.p_set_and_mty and r.ctrl.a_set and
-			r.ctrl.a_set_and_mty and r.ctrl.b_set) = '1'
+			r.ctrl.a_set_and_mty and r.ctrl.b_set) = '1' and r.mc.modq = '0'
 		then
 			v_pop_possible := TRUE;
 		else
 			v_pop_possible := FALSE;
 		end if;
 
+		-- (s282) field arithmetic operations only need the modulus (held in
+		-- the place of 'p') and its Montgomery constants, see (s283)
+		v_fop_possible := (r.ctrl.p_set and r.ctrl.p_set_and_mty) = '1';
+
 		-- (s231)
 		-- v_kp_possible must be always defined to avoid spurious latch inference
 		-- TODO: multicycle constraints are possible on the following paths (which
@@ -894,6 +1174,59 @@ begin
 			and ( (debug and (r.ctrl.token_act = '0' or r.ctrl.tokwasread = '1' ))
 			     or ((not debug) and r.ctrl.tokwasread = '1') );
 
+		-- (s286) a point can be written into a slot of the resident point memory
+		-- (see (s266)) whenever a large number could be, but also while a [k]P
+		-- computation is running, provided that no other transfer nor slot copy
+		-- is in progress (the point of the next [k]P can then be staged in the
+		-- background, see (s287), this only if 'ptslots' is set, see
+		-- ecc_customize)
+		v_stage_possible := (not v_wlock) or (ptslots and r.ctrl.kppending = '1'
+			and r.ctrl.agokp = '0' and r.ctrl.lockaxi = '0'
+			and r.ctrl.state = idle and r.write.active = '0'
+			and r.read.active = '0' and r.bp.copy = '0' and r.bp.save = '0');
+
+		-- (s292) job queue: software fills the entry at the tail of the queue
+		-- (token, scalar & point, see (s293)) while the jobs pushed before it
+		-- are computed one after the other (see (s295)), so that the next [k]P
+		-- can start as soon as the previous one is over & its result saved
+		-- (see (s296)) instead of waiting for software to transfer all of its
+		-- operands. Results are read back from the head of the queue (see
+		-- (s294)) whenever software sees fit.
+		v_jobq_t := to_integer(r.jobq.tail(JOBQ_SZ - 1 downto 0));
+		v_jobq_h := to_integer(r.jobq.head(JOBQ_SZ - 1 downto 0));
+		v_jobq_d := to_integer(r.jobq.done(JOBQ_SZ - 1 downto 0));
+		v_jobq_r := to_integer(r.jobq.run(JOBQ_SZ - 1 downto 0));
+		-- (none of the v_jobq_* booleans below can be true if the job queue
+		-- was not asked for in ecc_customize, see 'jobqueue')
+		v_jobq_busy := jobqueue -- statically resolved by synthesizer
+			and (r.jobq.run /= r.jobq.tail or r.jobq.copy = '1'
+			     or r.jobq.gosh /= "00" or r.jobq.kp = '1' or r.jobq.save = '1');
+		-- (s293) while an entry is open, the writes of the scalar & of XR1/YR1
+		-- as well as the read of the token are redirected to it (even though
+		-- a [k]P computation may be running), as long as no other transfer is
+		-- in progress
+		v_axi_wdatax_msb := r.axi.wdatax(
+			CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB);
+		v_jobq_wr := jobqueue and r.jobq.isopen = '1' and r.jobq.tokgen = '0'
+			and r.ctrl.state = idle and r.write.active = '0'
+			and r.read.active = '0'
+			and r.axi.wdatax(CTRL_WRITE_NB) = '1'
+			and r.axi.wdatax(CTRL_WRITE_BP) = '0'
+			and ( (v_axi_wdatax_msb = CST_ADDR_K
+			       and r.axi.wdatax(CTRL_WRITE_K) = '1')
+			     or v_axi_wdatax_msb = CST_ADDR_XR1
+			     or v_axi_wdatax_msb = CST_ADDR_YR1);
+		-- (s294) once bound to the result of the job at the head of the queue
+		-- (see JOBQ_RES in W_JOBQ_CTRL register) the reads of XR1/YR1 are
+		-- redirected to it
+		v_jobq_rd := jobqueue and r.ctrl.state = idle and r.write.active = '0'
+			and r.read.active = '0'
+			and r.axi.wdatax(CTRL_WRITE_NB) = '0'
+			and r.axi.wdatax(CTRL_READ_NB) = '1'
+			and ( (r.jobq.isopen = '1' and r.jobq.tokgen = '0'
+			       and r.axi.wdatax(CTRL_RD_TOKEN) = '1')
+			     or (r.jobq.res = '1' and r.axi.wdatax(CTRL_RD_TOKEN) = '0'));
+
 		-- (s30) v_busy determines the value of the BUSY bit in R_STATUS register,
 		--       see (s160)
 		-- Simply put, if:
@@ -905,6 +1238,8 @@ begin
 		--        to a new value of nn (prime size, nn_dynamic = TRUE)
 		--   or - we are reading TRNG data (debug = TRUE only)
 		--   or - we are in the process of generating the software token
+		--   or - jobs of the job queue remain to be computed, or the token of
+		--        its open entry is being generated (see (s292))
 		--   or - AXI interface is briefly "locked" to avoid race condition
 		-- then the BUSY bit in R_STATUS register is set and software is not
 		-- supposed to perform any action other than polling the BUSY bit
@@ -928,7 +1263,16 @@ begin
 		         or (nn_dynamic and r.nndyn.active = '1')
 		         or r.read.trngreading = '1'
 		         or r.ctrl.tokpending = '1' or r.ctrl.gentoken = '1'
-		         or r.ctrl.lockaxi = '1';
+		         or r.ctrl.lockaxi = '1'
+		         or v_jobq_busy or r.jobq.tokgen = '1';
+		-- (s311) the context of the modulus in use is saved, see (s310), as
+		-- soon as the IP is idle after its Montgomery constants have been
+		-- computed (the IP is signaled busy meanwhile)
+		v_mc_save := qcontext and r.mc.savepending = '1' and (not v_busy)
+			and r.ctrl.state = idle and r.ctrl.agokp = '0' and r.ctrl.dopop = '0'
+			and r.write.active = '0' and r.read.active = '0'
+			and r.bp.copy = '0' and r.bp.gosh = "00" and r.bp.save = '0';
+		v_busy := v_busy or r.mc.savepending = '1';
 		-- (s161) - Compared to v_busy, v_wlock adds the condition that the last
 		-- prime size set by software did not incur an error - thus preventing
 		-- software from performing undesirable actions when nn is not set properly
@@ -936,6 +1280,24 @@ begin
 		-- W_BLINDING, W_IRQ & W_SMALL_SCALAR, see (s162) & (s164)-(s168)).
 		v_wlock := v_busy or (nn_dynamic and r.nndyn.valwerr = '1');
 
+		-- (s295) the next job of the queue is launched as soon as nothing else
+		-- than the transfers redirected to the queue, see (s293) & (s294), is
+		-- in progress
+		v_jobq_launch := jobqueue
+			and r.jobq.run /= r.jobq.tail and r.jobq.copy = '0'
+			and r.jobq.gosh = "00" and r.jobq.kp = '0' and r.jobq.save = '0'
+			and initdone = '1' and r.ctrl.kppending = '0' and r.ctrl.agokp = '0'
+			and r.ctrl.mtypending = '0' and r.ctrl.agocstmty = '0'
+			and r.ctrl.amtypending = '0' and r.ctrl.agomtya = '0'
+			and r.ctrl.poppending = '0' and r.ctrl.dopop = '0'
+			and r.ctrl.tokpending = '0' and r.ctrl.gentoken = '0'
+			and r.ctrl.lockaxi = '0' and r.bp.copy = '0' and r.bp.gosh = "00"
+			and r.bp.save = '0' and r.mc.savepending = '0' and r.mc.modq = '0'
+			and ((not nn_dynamic) or r.nndyn.active = '0')
+			and r.read.trngreading = '0'
+			and (r.write.active = '0' or r.write.jobq = '1')
+			and (r.read.active = '0' or r.read.jobq = '1');
+
 		-- pragma translate_off
 		if v_wlock then v.ctrl.wlock := '1'; else v.ctrl.wlock := '0'; end if;
 		if v_busy then v.ctrl.busy := '1'; else v.ctrl.busy := '0'; end if;
@@ -1230,6 +1592,22 @@ begin
 		v.write.new32 := '0';
 		v.write.fpwe0 := '0'; -- (s24)
 		v.write.fpwe := r.write.fpwe0;
+		-- (s288) limbs of a staged point only go to the resident point memory,
+		-- see (s287). r.write.stage is only released once the last limb has
+		-- left the pipeline (it is still in r.write.fpwe0 when (s117) happens)
+		v.write.fpwestg := r.write.fpwe0 and r.write.stage;
+		if r.write.stage = '1' and r.write.active = '0' and r.write.fpwe0 = '0'
+		then
+			v.write.stage := '0';
+		end if;
+		-- (s297) same for the limbs redirected to the job queue, see (s293)
+		-- (the last limb of the scalar may still be waiting for its mask)
+		v.write.fpwejq := r.write.fpwe0 and r.write.jobq;
+		if r.write.jobq = '1' and r.write.active = '0' and r.write.fpwe0 = '0'
+			and r.write.rnd.wait4rnd = '0' and r.write.rnd.write_mask_sh = "00"
+		then
+			v.write.jobq := '0';
+		end if;
 		v.read.fpre0 := '0'; -- (s49)
 		v.read.fpre := r.read.fpre0;
 		v.nndyn.testnn := '0'; -- (s169)
@@ -1249,6 +1627,10 @@ begin
 		if ar01zien = '1' then
 			v.ctrl.r0_is_null := ar0zi;
 			v.ctrl.r1_is_null := ar1zi;
+			-- a null point has no projective form, see (s277)
+			if ar1zi = '1' then
+				v.ctrl.proj := '0';
+			end if;
 		end if;
 
 		if r.ctrl.wk = '1' then
@@ -1263,6 +1645,360 @@ begin
 
 		v.fpaddr := r.fpaddr0;
 
+		-- ------------------------------------------------------
+		-- resident point memory (stored base point & point slots)
+		-- ------------------------------------------------------
+		-- (s267) each limb of XR1 or YR1 written while r.bp.capture is set
+		-- is written into the resident point memory in slot r.bp.wslot (at
+		-- the same limb offset, see bp_we below) instead of ecc_fp_dram.
+		-- All copies (s270) & (s279) transfer the w limbs of each coordinate,
+		-- which is exactly what the write of a large number spans in ecc_fp_dram
+		-- (writing 'p' or a new value of nn invalidates all slots, see (s41))
+
+		-- (s270) copy of slot r.bp.rslot into X & Y of R1 (or R0) in ecc_fp_dram,
+		-- one limb per cycle, all limbs of x first then all limbs of y (see
+		-- (s269) & (s278)). Each limb is read from the resident point memory
+		-- (1 cycle of latency) and then pushed into ecc_fp_dram through the same
+		-- write port as the large numbers written by software (bypass of the
+		-- 3 default assignments just above)
+		v.bp.rvalid := '0';
+		v.bp.gosh := r.bp.gosh(0) & '0';
+		if r.bp.copy = '1' then
+			v.bp.rvalid := '1';
+			if r.bp.dst = '1' then
+				v.bp.rfpaddr := CST_ADDR_XR1(FP_ADDR_MSB - 1 downto 1) & r.bp.raddr;
+			else
+				v.bp.rfpaddr := CST_ADDR_XR0(FP_ADDR_MSB - 1 downto 1) & r.bp.raddr;
+			end if;
+			if unsigned(r.bp.raddr(FP_ADDR_LSB - 1 downto 0))
+				= resize(nndyn_wm1_s, FP_ADDR_LSB)
+			then
+				if r.bp.raddr(FP_ADDR_LSB) = '0' then
+					-- done with x, now y
+					v.bp.raddr := '1' & (FP_ADDR_LSB - 1 downto 0 => '0');
+				else
+					v.bp.copy := '0';
+					v.bp.gosh(0) := '1';
+				end if;
+			else
+				v.bp.raddr := std_logic_vector(unsigned(r.bp.raddr) + 1);
+			end if;
+		end if;
+		if r.bp.rvalid = '1' then
+			v.write.fpwe := '1';
+			v.write.fpwestg := '0';
+			v.write.fpwejq := '0';
+			v.write.fpwdata := bp_rdata;
+			v.fpaddr := r.bp.rfpaddr;
+		end if;
+		-- the [k]P request to ecc_scalar is only issued once the last limb of y
+		-- has actually been written into ecc_fp_dram (r.ctrl.lockaxi is still
+		-- high from (s269) and will be deasserted by (s69))
+		if r.bp.gosh(1) = '1' then
+			if r.bp.kg = '1' then
+				v.ctrl.agokp := '1';
+				v.ctrl.x_set := '1';
+				v.ctrl.y_set := '1';
+				v.ctrl.r1_is_null := '0';
+			else
+				-- end of a slot load (s278), the point loaded is null if the point
+				-- saved into the slot was
+				if r.bp.dst = '1' then
+					v.ctrl.x_set := '1';
+					v.ctrl.y_set := '1';
+					v.ctrl.r1_is_null :=
+						r.bp.isnull(to_integer(unsigned(r.bp.rslot)));
+				else
+					v.ctrl.r0_is_null :=
+						r.bp.isnull(to_integer(unsigned(r.bp.rslot)));
+				end if;
+				v.ctrl.lockaxi := '0';
+			end if;
+		end if;
+
+		-- (s279) copy of R1 (X then Y) from ecc_fp_dram into slot r.bp.sslot,
+		-- one limb per cycle. Reads are issued through the same read port
+		-- as the large numbers read by software (bypass of the default
+		-- assignment of r.fpaddr above and of xre, see (s280)) and each limb
+		-- read back readlat + 1 cycles later (same latency as r.read.resh) is
+		-- written into the resident point memory
+		v.bp.sre := '0';
+		if r.bp.save = '1' then
+			v.bp.sre := '1';
+			v.fpaddr := CST_ADDR_XR1(FP_ADDR_MSB - 1 downto 1) & r.bp.saddr;
+			if unsigned(r.bp.saddr(FP_ADDR_LSB - 1 downto 0))
+				= resize(nndyn_wm1_s, FP_ADDR_LSB)
+			then
+				if r.bp.saddr(FP_ADDR_LSB) = '0' then
+					v.bp.saddr := '1' & (FP_ADDR_LSB - 1 downto 0 => '0');
+				else
+					v.bp.save := '0';
+				end if;
+			else
+				v.bp.saddr := std_logic_vector(unsigned(r.bp.saddr) + 1);
+			end if;
+		end if;
+		v.bp.ssh := r.bp.sre & r.bp.ssh(readlat downto 1);
+		if r.bp.ssh(0) = '1' then -- xrdata is written by bp_we, see (s267)
+			v.bp.swaddr := std_logic_vector(unsigned(r.bp.swaddr) + 1);
+			if unsigned(r.bp.swaddr(FP_ADDR_LSB - 1 downto 0))
+				= resize(nndyn_wm1_s, FP_ADDR_LSB)
+			then
+				if r.bp.swaddr(FP_ADDR_LSB) = '0' then
+					v.bp.swaddr := '1' & (FP_ADDR_LSB - 1 downto 0 => '0');
+				else
+					-- last limb of y written, the slot is now valid
+					v.bp.xvalid(to_integer(unsigned(r.bp.sslot))) := '1';
+					v.bp.yvalid(to_integer(unsigned(r.bp.sslot))) := '1';
+					v.bp.isnull(to_integer(unsigned(r.bp.sslot))) :=
+						r.ctrl.r1_is_null;
+					v.ctrl.lockaxi := '0';
+				end if;
+			end if;
+		end if;
+
+		-- ------------------------------------------------------
+		-- contexts of the moduli p & q (see (s308))
+		-- ------------------------------------------------------
+		-- (s310) copy of the context of the modulus in use from ecc_fp_dram
+		-- into the context memory (the modulus first, then R2modp, twop &
+		-- Rmodp, see mc_fppage()) one limb per cycle, the same way as (s279)
+		if v_mc_save then
+			v.mc.savepending := '0';
+			v.mc.save := '1';
+			v.mc.saddr := (others => '0');
+			v.mc.swaddr := (others => '0');
+			v.ctrl.lockaxi := '1'; -- deasserted once the last limb is saved
+		end if;
+		v.mc.sre := '0';
+		if r.mc.save = '1' then
+			v.mc.sre := '1';
+			v.fpaddr := mc_fppage(r.mc.saddr(FP_ADDR_LSB + 1 downto FP_ADDR_LSB))
+				& r.mc.saddr(FP_ADDR_LSB - 1 downto 0);
+			if unsigned(r.mc.saddr(FP_ADDR_LSB - 1 downto 0))
+				= resize(nndyn_wm1_s, FP_ADDR_LSB)
+			then
+				if r.mc.saddr(FP_ADDR_LSB + 1 downto FP_ADDR_LSB) = "11" then
+					v.mc.save := '0';
+				else
+					v.mc.saddr := std_logic_vector(unsigned(
+						r.mc.saddr(FP_ADDR_LSB + 1 downto FP_ADDR_LSB)) + 1)
+						& (FP_ADDR_LSB - 1 downto 0 => '0');
+				end if;
+			else
+				v.mc.saddr := std_logic_vector(unsigned(r.mc.saddr) + 1);
+			end if;
+		end if;
+		v.mc.ssh := r.mc.sre & r.mc.ssh(readlat downto 1);
+		if r.mc.ssh(0) = '1' then -- xrdata is written by mc_we
+			v.mc.swaddr := std_logic_vector(unsigned(r.mc.swaddr) + 1);
+			if unsigned(r.mc.swaddr(FP_ADDR_LSB - 1 downto 0))
+				= resize(nndyn_wm1_s, FP_ADDR_LSB)
+			then
+				if r.mc.swaddr(FP_ADDR_LSB + 1 downto FP_ADDR_LSB) /= "11" then
+					v.mc.swaddr := std_logic_vector(unsigned(
+						r.mc.swaddr(FP_ADDR_LSB + 1 downto FP_ADDR_LSB)) + 1)
+						& (FP_ADDR_LSB - 1 downto 0 => '0');
+				else
+					-- last limb of Rmodp saved, the context is now valid
+					if r.mc.modq = '1' then
+						v.mc.qvalid := '1';
+					else
+						v.mc.pvalid := '1';
+					end if;
+					v.ctrl.lockaxi := '0';
+				end if;
+			end if;
+		end if;
+
+		-- (s312) copy of the context of the modulus switched to (see (s308))
+		-- from the context memory into ecc_fp_dram, the same way as (s270)
+		v.mc.rvalid := '0';
+		v.mc.gosh := r.mc.gosh(0) & '0';
+		if r.mc.copy = '1' then
+			v.mc.rvalid := '1';
+			v.mc.rfpaddr :=
+				mc_fppage(r.mc.raddr(FP_ADDR_LSB + 1 downto FP_ADDR_LSB))
+				& r.mc.raddr(FP_ADDR_LSB - 1 downto 0);
+			if unsigned(r.mc.raddr(FP_ADDR_LSB - 1 downto 0))
+				= resize(nndyn_wm1_s, FP_ADDR_LSB)
+			then
+				if r.mc.raddr(FP_ADDR_LSB + 1 downto FP_ADDR_LSB) = "11" then
+					v.mc.copy := '0';
+					v.mc.gosh(0) := '1';
+				else
+					v.mc.raddr := std_logic_vector(unsigned(
+						r.mc.raddr(FP_ADDR_LSB + 1 downto FP_ADDR_LSB)) + 1)
+						& (FP_ADDR_LSB - 1 downto 0 => '0');
+				end if;
+			else
+				v.mc.raddr := std_logic_vector(unsigned(r.mc.raddr) + 1);
+			end if;
+		end if;
+		if r.mc.rvalid = '1' then
+			v.write.fpwe := '1';
+			v.write.fpwestg := '0';
+			v.write.fpwejq := '0';
+			v.write.fpwdata := mc_rdata;
+			v.fpaddr := r.mc.rfpaddr;
+		end if;
+		-- the modulus & its constants are all back in ecc_fp_dram once the
+		-- last limb of Rmodp has actually been written
+		if r.mc.gosh(1) = '1' then
+			v.ctrl.p_set := '1';
+			v.ctrl.p_set_and_mty := '1';
+			v.ctrl.lockaxi := '0';
+		end if;
+
+		-- ------------------------------------------------------
+		-- job queue (see (s292))
+		-- ------------------------------------------------------
+		-- (s298) token of the open entry: its w limbs are drawn from the same
+		-- TRNG channel as the masks of the scalar, see (s299), the most sig-
+		-- nificant one(s) being masked exactly as the ones of a token generated
+		-- by ecc_scalar (see NNRNDm in ecc_fp.vhd), as ecc_scalar is most likely
+		-- busy with the current job
+		v.jobq.twe := '0';
+		if r.jobq.tokgen = '1' and trngvalid = '1' then
+			v.jobq.twe := '1';
+			v.jobq.twaddr := std_logic_vector(r.jobq.taddr);
+			v.jobq.twdata := trngdata;
+			if r.jobq.taddr = resize(nndyn_wm1_s, FP_ADDR_LSB) then
+				if nndyn_nnrnd_zerowm1_s = '1' then
+					v.jobq.twdata := (others => '0');
+				else
+					v.jobq.twdata := trngdata and nndyn_nnrnd_mask_s;
+				end if;
+				v.jobq.tokgen := '0';
+			elsif r.jobq.taddr = resize(nndyn_wm2_s, FP_ADDR_LSB)
+				and nndyn_nnrnd_zerowm1_s = '1'
+			then
+				v.jobq.twdata := trngdata and nndyn_nnrnd_mask_s;
+			end if;
+			v.jobq.taddr := r.jobq.taddr + 1;
+		end if;
+
+		-- (s295) launch of the next job of the queue: entry .run is copied into
+		-- ecc_fp_dram one limb per cycle (scalar & masks, token, then x & y)
+		-- the same way a point slot is, see (s270), except that the copy has
+		-- its own path to ecc_fp_dram (see xwe & xaddr below) as software may
+		-- keep on filling the next entry meanwhile. The memory read port is
+		-- lent to software in the cycles it reads the token of the open entry
+		-- (see qb_raddr below), the copy being stalled
+		if v_jobq_launch then
+			v.jobq.copy := '1';
+			v.jobq.page := JOBQ_PG_K0;
+			v.jobq.raddr := (others => '0');
+			v.ctrl.proj := '0'; -- R1 is overwritten, see (s276)
+			v.ctrl.k_is_null := r.jobq.knull(v_jobq_r);
+			v.write.rnd.masklsb := r.jobq.masklsb(v_jobq_r);
+		end if;
+		v.jobq.rvalid := '0';
+		v.jobq.fpwe := '0';
+		v.jobq.gosh := r.jobq.gosh(0) & '0';
+		if r.jobq.copy = '1' and not (r.read.fpre = '1' and r.read.jobq = '1'
+			and r.read.jobqres = '0')
+		then
+			v.jobq.rvalid := '1';
+			v.jobq.rfpaddr := jobq_fppage(r.jobq.page, r.jobq.arith(v_jobq_r))
+				& r.jobq.raddr;
+			if unsigned(r.jobq.raddr) = resize(nndyn_wm1_s, FP_ADDR_LSB) then
+				v.jobq.raddr := (others => '0');
+				-- (2nd pages of the scalar & of its masks only with blinding)
+				if r.jobq.page = JOBQ_PG_K0 and r.jobq.arith(v_jobq_r) = '1' then
+					v.jobq.page := JOBQ_PG_K1;
+				elsif r.jobq.page = JOBQ_PG_K0 or r.jobq.page = JOBQ_PG_K1 then
+					v.jobq.page := JOBQ_PG_M0;
+				elsif r.jobq.page = JOBQ_PG_M0 and r.jobq.arith(v_jobq_r) = '1' then
+					v.jobq.page := JOBQ_PG_M1;
+				elsif r.jobq.page = JOBQ_PG_M0 or r.jobq.page = JOBQ_PG_M1 then
+					v.jobq.page := JOBQ_PG_TOK;
+				elsif r.jobq.page = JOBQ_PG_TOK then
+					v.jobq.page := JOBQ_PG_X;
+				elsif r.jobq.page = JOBQ_PG_X then
+					v.jobq.page := JOBQ_PG_Y;
+				else
+					v.jobq.copy := '0';
+					v.jobq.gosh(0) := '1';
+				end if;
+			else
+				v.jobq.raddr := std_logic_vector(unsigned(r.jobq.raddr) + 1);
+			end if;
+		end if;
+		if r.jobq.rvalid = '1' then
+			v.jobq.fpwe := '1';
+			v.jobq.xaddr := r.jobq.rfpaddr;
+			v.jobq.fpwdata := qb_rdata;
+		end if;
+		-- the [k]P request to ecc_scalar is issued once the last limb of y has
+		-- actually been written into ecc_fp_dram, as for (s269)
+		if r.jobq.gosh(1) = '1' then
+			v.ctrl.agokp := '1';
+			v.ctrl.k_set := '1';
+			v.ctrl.x_set := '1';
+			v.ctrl.y_set := '1';
+			v.ctrl.r1_is_null := '0';
+			v.jobq.kp := '1';
+			v.jobq.run := r.jobq.run + 1;
+		end if;
+
+		-- (s296) copy of R1 (X then Y) from ecc_fp_dram into the result of
+		-- entry .done at the end of its [k]P computation (started by (s300)),
+		-- the same way as (s279) into a point slot. The entry is only considered
+		-- done (and the IRQ, if enabled, is only raised) once the last limb of
+		-- y is saved, along with the flags describing the result
+		v.jobq.sre := '0';
+		v_jobq_irq := FALSE;
+		if r.jobq.save = '1' then
+			v.jobq.sre := '1';
+			v.jobq.xaddr := CST_ADDR_XR1(FP_ADDR_MSB - 1 downto 1) & r.jobq.saddr;
+			if unsigned(r.jobq.saddr(FP_ADDR_LSB - 1 downto 0))
+				= resize(nndyn_wm1_s, FP_ADDR_LSB)
+			then
+				if r.jobq.saddr(FP_ADDR_LSB) = '0' then
+					v.jobq.saddr := '1' & (FP_ADDR_LSB - 1 downto 0 => '0');
+				else
+					v.jobq.save := '0';
+				end if;
+			else
+				v.jobq.saddr := std_logic_vector(unsigned(r.jobq.saddr) + 1);
+			end if;
+		end if;
+		v.jobq.ssh := r.jobq.sre & r.jobq.ssh(readlat downto 1);
+		if r.jobq.ssh(0) = '1' then -- xrdata is written by rs_we
+			v.jobq.swaddr := std_logic_vector(unsigned(r.jobq.swaddr) + 1);
+			if unsigned(r.jobq.swaddr(FP_ADDR_LSB - 1 downto 0))
+				= resize(nndyn_wm1_s, FP_ADDR_LSB)
+			then
+				if r.jobq.swaddr(FP_ADDR_LSB) = '0' then
+					v.jobq.swaddr := '1' & (FP_ADDR_LSB - 1 downto 0 => '0');
+				else
+					-- last limb of y saved, the job is done (errors of ecc_scalar
+					-- are acknowledged so they are not accounted to the next job)
+					v.jobq.rnull(v_jobq_d) := r.ctrl.r1_is_null;
+					v.jobq.errin(v_jobq_d) := aerr_inpt_not_on_curve;
+					v.jobq.errout(v_jobq_d) := aerr_outpt_not_on_curve;
+					v.ctrl.aerr_inpt_ack := aerr_inpt_not_on_curve;
+					v.ctrl.aerr_outpt_ack := aerr_outpt_not_on_curve;
+					v.jobq.done := r.jobq.done + 1;
+					v_jobq_irq := TRUE; -- see (s302)
+					-- the gap is only measured between jobs run back-to-back
+					if r.jobq.run = r.jobq.tail then
+						v.jobq.gapon := '0';
+					end if;
+				end if;
+			end if;
+		end if;
+
+		-- (s301) nb of cycles from the end of a job of the queue to the start
+		-- of the next one (read in R_JOBQ_GAP register). It only depends on
+		-- the copies of (s295) & (s296), not on the scalar, which is why the
+		-- register is not restricted to debug mode
+		if r.jobq.gapon = '1' and r.jobq.gapcnt /= (r.jobq.gapcnt'range => '1')
+		then
+			v.jobq.gapcnt := r.jobq.gapcnt + 1;
+		end if;
+
 		-- ----------------------------------------------------------
 		--                   A X I   W r i t e s
 		-- ----------------------------------------------------------
@@ -1329,24 +2065,87 @@ begin
 				v.axi.arready := '1';
 				-- drive write-response to initiator
 				v.axi.bvalid := '1';
-				if (not v_wlock) or debug then -- (s162), see (s161)
+				if (v_stage_possible or debug) and r.axi.wdatax(CTRL_WRITE_NB) = '1'
+					and r.axi.wdatax(CTRL_WRITE_BP) = '1'
+					and (r.axi.wdatax(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1
+						downto CTRL_NBADDR_LSB) = CST_ADDR_XR1 or
+					     r.axi.wdatax(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1
+						downto CTRL_NBADDR_LSB) = CST_ADDR_YR1)
+				then
+					-- ----------------------------------------------------------
+					--    start of a large number write into a POINT SLOT
+					-- ----------------------------------------------------------
+					-- (s266) When CTRL_WRITE_BP is set along with the address of
+					-- XR1 or YR1, the large number follows the same path as any
+					-- other write (AXI backpressure, BUSY & R_OR_W bits behave the
+					-- same) but each ww-bit limb is only captured into the resident
+					-- point memory, see (s267), and never reaches ecc_fp_dram, see
+					-- (s288). The slot written is the one last selected in W_PT_SLOT
+					-- register (slot 0, i.e the base point of [k]G, by default).
+					-- The corresponding coordinate will only be considered valid
+					-- once the whole large number is transferred, see (s268).
+					-- (s287) As R1 is left untouched (none of the flags describing
+					-- it are modified either, see (s178)) such a write is also
+					-- accepted while a [k]P computation is running, see (s286): this
+					-- allows software to stage the point of the next [k]P while the
+					-- current one is running, and to start it right after from the
+					-- slot (see PTSLOT_KP in W_PT_SLOT register).
+					v.fpaddr0 := std_logic_vector(to_unsigned(0, FP_ADDR_MSB - 3))
+						& r.axi.wdatax(CTRL_NBADDR_LSB + 2 downto CTRL_NBADDR_LSB)
+						& std_logic_vector(to_unsigned(0, log2(n - 1)));
+					v.write.stage := '1';
+					v.ctrl.wk := '0';
+					v.bp.capture := '1';
+					if r.axi.wdatax(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1
+						downto CTRL_NBADDR_LSB) = CST_ADDR_XR1
+					then
+						v.bp.xvalid(to_integer(unsigned(r.bp.wslot))) := '0';
+					else
+						v.bp.yvalid(to_integer(unsigned(r.bp.wslot))) := '0';
+					end if;
+					v.bp.isnull(to_integer(unsigned(r.bp.wslot))) := '0';
+					-- same as (s116) & following
+					v.write.active := '1';
+					v.write.bitsww := to_unsigned(ww - 1, log2(ww - 1));
+					v.write.bitsaxi := to_unsigned(C_S_AXI_DATA_WIDTH - 1, axiw);
+					if nn_dynamic then
+						v.write.bitstotal := r.nndyn.valnnm1;
+					else
+						v.write.bitstotal := to_unsigned(nn - 1, log2(nn));
+					end if;
+					v.write.trailingzeros := "00";
+					v.ctrl.state := writeln;
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0';
+				elsif (not v_wlock) or debug or v_jobq_wr or v_jobq_rd then -- (s162)
+					-- (see (s161), the transfers redirected to the job queue are
+					-- accepted even though the IP is busy, see (s293) & (s294))
 					-- in debug mode we always grant write access to W_CTRL register
 					-- (so use with care)
 					-- Decode content of W_CTRL register. Since sevaral actions can
 					-- be triggered by software here, we need to prioritize them,
-					-- which is done below (action 1 has the highest priority, action 4
+					-- which is done below (action 1 has the highest priority, action 5
 					-- has the lowest)
 					--   1. software wants to write a large number, see (s186)
 					--   2. software wants to read a large number, see (s187)
 					--   3. software wants to start a [k]P computation, see (s188)
-					--   4. software asks for a point-based operation (other than [k]P),
+					--   4. software wants to start a [k]G computation on the stored
+					--      base point, see (s269)
+					--   5. software asks for a point-based operation (other than [k]P),
 					--      see (s189)
 					-- In any other case, error flag STATUS_ERR_I_WREG_FBD is raised in
 					-- R_STATUS register. Note that no error flag is raised in case
 					-- several actions are asked for in the same W_CTRL write, instead
 					-- priorities described above simply are applied.
 					-- (TODO: multicycle constraints are possible on a few paths below)
-					if r.axi.wdatax(CTRL_WRITE_NB) = '1' then
+					if r.axi.wdatax(CTRL_WRITE_NB) = '1' and r.mc.modq = '1'
+						and (not v_jobq_wr) and r.axi.wdatax(CTRL_NBADDR_LSB
+							+ FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB) = CST_ADDR_A
+					then
+						-- (s314) 'a' can't be written while q is the modulus in use
+						-- (see (s308)), it would be switched into the Montgomery
+						-- representation of q
+						v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+					elsif r.axi.wdatax(CTRL_WRITE_NB) = '1' then
 						-- ----------------------------------------------------------
 						--         start of a new large number WRITE sequence
 						-- ----------------------------------------------------------
@@ -1366,81 +2165,125 @@ begin
 								& r.axi.wdatax(CTRL_NBADDR_LSB + 2 downto CTRL_NBADDR_LSB)
 								& std_logic_vector(to_unsigned(0, log2(n - 1)));
 						end if;
-						-- by default the large number to write is not 'a', but see bypass
-						-- (s121) below
-						v.ctrl.newa := '0'; -- (s120)
-						-- (s177)
-						-- set some flags according to the address of the large nb software
-						-- says he's about to modify, so that ecc_axi knows what curve
-						-- parameters have been written and which have not been
-						--   - when SW starts a large nb write sequence by writing its
-						--     address in the W_CTRL register (point where we are now)
-						--     the corresponding flag is deasserted
-						--   - once the transfer of the large nb is over, only then is the
-						--     flag asserted, see (s178)
-						-- TODO: multicycle constraints are possible here on a few paths:
-						--         r.axi.wdatax(addr) -> r.ctrl.[pabqxy]_set
-						--         r.axi.wdatax(addr) -> r.ctrl.a_set_and_mty
-						v_axi_wdatax_msb := r.axi.wdatax(
-								CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB);
-						if v_axi_wdatax_msb = CST_ADDR_P then
-							v.ctrl.p_set := '0'; -- see (s112)
-							v.ctrl.p_set_and_mty := '0'; -- (s179), see (s110)
-							-- writing a new value of 'p' immediately invalidates
-							-- the current value of curve parameter 'a'
-							v.ctrl.a_set := '0';
-							v.ctrl.a_set_and_mty := '0';
-						elsif v_axi_wdatax_msb = CST_ADDR_A then
-							v.ctrl.a_set := '0'; -- (s181), see (s113)
-							v.ctrl.a_set_and_mty := '0'; -- (s182), see (s111)
-							v.ctrl.newa := '1'; -- (s121), bypass of (s120)
-						elsif v_axi_wdatax_msb = CST_ADDR_B then
-							v.ctrl.b_set := '0';
-						elsif v_axi_wdatax_msb = CST_ADDR_Q then
-							v.ctrl.q_set := '0';
-						elsif v_axi_wdatax_msb = CST_ADDR_XR1 then
-							v.ctrl.x_set := '0';
-							v.ctrl.r1_is_null := '0';
-						elsif v_axi_wdatax_msb = CST_ADDR_YR1 then
-							v.ctrl.y_set := '0';
-							v.ctrl.r1_is_null := '0';
-						elsif (v_axi_wdatax_msb = CST_ADDR_XR0) or
-							(v_axi_wdatax_msb = CST_ADDR_YR0)
-						then
-							v.ctrl.r0_is_null := '0';
-						end if;
-						if not debug then -- statically resolved by synthesizer
-							v.ctrl.read_forbidden := '1';
-						end if;
-						if r.axi.wdatax(
-								CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB)
-							= CST_ADDR_P
-						then
-							-- --------------------------------------
-							-- user wants to write the prime number p
-							-- --------------------------------------
-							-- assert r.ctrl.newp so that we can trigger the computation
-							-- (by ecc_scalar) of the 2 new Montgomery constants associated
-							-- with the new value of p as soon as (see (s11) below) the
-							-- whole large number value of p has been written through AXI-
-							-- fabric.
-							-- r.ctrl.newp will be deasserted either by (s8) (when ecc_scalar
-							-- acknowledges the order to recompute the Montgomery constants)
-							-- or by (s10) (when the next large number write sequence is
-							-- programmed for a number other than p)
-							v.ctrl.newp := '1';
-							-- assert r.ctrl.pen (directly drives output 'pen', see (s9))
-							-- so that the Montgomery mult. components are aware they should
-							-- sample the 'w' x 'ww'-bit words of p at the same time they
-							-- are being written into ecc_fp_dram
-							v.ctrl.penupsh(1) := '1'; -- (s184), see (s185)
-							-- writing p means all current curve parameters become obsolete
-							v.ctrl.p_set := '0'; -- see (s112)
-							v.ctrl.p_set_and_mty := '0'; -- (s180), see (s110)
-							v.ctrl.a_set_and_mty := '0'; -- (s183), see (s111)
+						v.write.stage := '0'; -- see (s288)
+						if v_jobq_wr then
+							-- (s293) the large number goes to the open entry of the job
+							-- queue (see (s297)), whose flags are updated instead of the
+							-- ones describing ecc_fp_dram content
+							v.write.jobq := '1';
+							v.bp.capture := '0'; -- see (s267)
+							if v_axi_wdatax_msb = CST_ADDR_XR1 then
+								v.jobq.xset(v_jobq_t) := '0';
+							elsif v_axi_wdatax_msb = CST_ADDR_YR1 then
+								v.jobq.yset(v_jobq_t) := '0';
+							end if;
 						else
-							v.ctrl.newp := '0'; -- (s10)
-						end if; -- prime p
+							v.write.jobq := '0';
+							-- by default the large number to write is not 'a', but see bypass
+							-- (s121) below
+							v.ctrl.newa := '0'; -- (s120)
+							-- (s177)
+							-- set some flags according to the address of the large nb software
+							-- says he's about to modify, so that ecc_axi knows what curve
+							-- parameters have been written and which have not been
+							--   - when SW starts a large nb write sequence by writing its
+							--     address in the W_CTRL register (point where we are now)
+							--     the corresponding flag is deasserted
+							--   - once the transfer of the large nb is over, only then is the
+							--     flag asserted, see (s178)
+							-- TODO: multicycle constraints are possible here on a few paths:
+							--         r.axi.wdatax(addr) -> r.ctrl.[pabqxy]_set
+							--         r.axi.wdatax(addr) -> r.ctrl.a_set_and_mty
+							v_axi_wdatax_msb := r.axi.wdatax(
+									CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB);
+							if v_axi_wdatax_msb = CST_ADDR_P and r.mc.modq = '1' then
+								-- (s313) q written in place of p while q is the modulus
+								-- in use (see (s308)): only its own context gets obsolete,
+								-- the curve is left untouched
+								v.ctrl.p_set := '0'; -- see (s112)
+								v.ctrl.p_set_and_mty := '0'; -- (s179), see (s110)
+								v.mc.qvalid := '0';
+							elsif v_axi_wdatax_msb = CST_ADDR_P then
+								v.ctrl.p_set := '0'; -- see (s112)
+								v.ctrl.p_set_and_mty := '0'; -- (s179), see (s110)
+								-- a new curve makes the contexts of both moduli obsolete,
+								-- see (s308)
+								v.mc.pvalid := '0';
+								v.mc.qvalid := '0';
+								-- writing a new value of 'p' immediately invalidates
+								-- the current value of curve parameter 'a'
+								v.ctrl.a_set := '0';
+								v.ctrl.a_set_and_mty := '0';
+								v.ctrl.azero := '0'; -- see (s281)
+								v.ctrl.am3 := '0';
+								-- as well as all the point slots (new curve)
+								v.bp.xvalid := (others => '0');
+								v.bp.yvalid := (others => '0');
+								v.ctrl.proj := '0'; -- see (s276)
+							elsif v_axi_wdatax_msb = CST_ADDR_A then
+								v.ctrl.a_set := '0'; -- (s181), see (s113)
+								v.ctrl.a_set_and_mty := '0'; -- (s182), see (s111)
+								v.ctrl.azero := '0'; -- see (s281)
+								v.ctrl.am3 := '0';
+								v.ctrl.newa := '1'; -- (s121), bypass of (s120)
+								v.ctrl.proj := '0'; -- see (s276)
+							elsif v_axi_wdatax_msb = CST_ADDR_B then
+								v.ctrl.b_set := '0';
+							elsif v_axi_wdatax_msb = CST_ADDR_Q then
+								v.ctrl.q_set := '0';
+							elsif v_axi_wdatax_msb = CST_ADDR_XR1 then
+								v.ctrl.x_set := '0';
+								v.ctrl.r1_is_null := '0';
+								-- a new affine point R1 replaces the projective one
+								v.ctrl.proj := '0'; -- see (s276)
+							elsif v_axi_wdatax_msb = CST_ADDR_YR1 then
+								v.ctrl.y_set := '0';
+								v.ctrl.r1_is_null := '0';
+								v.ctrl.proj := '0'; -- see (s276)
+							elsif (v_axi_wdatax_msb = CST_ADDR_XR0) or
+								(v_axi_wdatax_msb = CST_ADDR_YR0)
+							then
+								v.ctrl.r0_is_null := '0';
+							end if;
+							-- (writes into point slots are handled by (s266))
+							v.bp.capture := '0';
+							if not debug then -- statically resolved by synthesizer
+								v.ctrl.read_forbidden := '1';
+							end if;
+							if r.axi.wdatax(
+									CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB)
+								= CST_ADDR_P
+							then
+								-- --------------------------------------
+								-- user wants to write the prime number p
+								-- --------------------------------------
+								-- assert r.ctrl.newp so that we can trigger the computation
+								-- (by ecc_scalar) of the 2 new Montgomery constants associated
+								-- with the new value of p as soon as (see (s11) below) the
+								-- whole large number value of p has been written through AXI-
+								-- fabric.
+								-- r.ctrl.newp will be deasserted either by (s8) (when ecc_scalar
+								-- acknowledges the order to recompute the Montgomery constants)
+								-- or by (s10) (when the next large number write sequence is
+								-- programmed for a number other than p)
+								v.ctrl.newp := '1';
+								-- assert r.ctrl.pen (directly drives output 'pen', see (s9))
+								-- so that the Montgomery mult. components are aware they should
+								-- sample the 'w' x 'ww'-bit words of p at the same time they
+								-- are being written into ecc_fp_dram
+								v.ctrl.penupsh(1) := '1'; -- (s184), see (s185)
+								-- writing p means all current curve parameters become obsolete
+								v.ctrl.p_set := '0'; -- see (s112)
+								v.ctrl.p_set_and_mty := '0'; -- (s180), see (s110)
+								if r.mc.modq = '0' then -- see (s313)
+									v.ctrl.a_set_and_mty := '0'; -- (s183), see (s111)
+									v.ctrl.azero := '0'; -- see (s281)
+									v.ctrl.am3 := '0';
+								end if;
+							else
+								v.ctrl.newp := '0'; -- (s10)
+							end if; -- prime p
+						end if; -- not redirected to the job queue
 						if r.axi.wdatax(
 							CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB)
 								= CST_ADDR_K
@@ -1449,13 +2292,22 @@ begin
 							-- --------------------------------
 							-- user wants to write the scalar k
 							-- --------------------------------
-							v.ctrl.k_set := '0';
-							v.ctrl.k_is_being_set := '1'; -- (s122), see (s123)
+							if v_jobq_wr then
+								v.jobq.kset(v_jobq_t) := '0';
+								v.jobq.arith(v_jobq_t) := r.ctrl.doblinding;
+							else
+								v.ctrl.k_set := '0';
+								v.ctrl.k_is_being_set := '1'; -- (s122), see (s123)
+							end if;
 							if r.write.rnd.enough_random = '1'
 								or (debug and r.debug.noaxirnd = '1')
 							then
 								v.ctrl.wk := '1';
-								v.ctrl.k_is_null := '1';
+								if v_jobq_wr then
+									v.jobq.wknull := '1';
+								else
+									v.ctrl.k_is_null := '1';
+								end if;
 								-- (s72) init of wecnt, used only when blinding is active,
 								-- see (s73)
 								if nn_dynamic then
@@ -1555,8 +2407,10 @@ begin
 						--   XR1 and YR1 locations from ecc_fp_dram)
 						if (not debug) and -- statically resolved by synthesizer
 							-- when r.ctrl.read_forbidden is asserted, the only large number
-							-- that software is allowed to read is the random token
+							-- that software is allowed to read is the random token (or
+							-- a result of the job queue, see (s294))
 							(r.ctrl.read_forbidden = '1' and r.axi.wdatax(CTRL_RD_TOKEN)='0')
+							and not v_jobq_rd
 						then
 							v.ctrl.ierrid(STATUS_ERR_I_RDNB_FBD) := '1';
 						else
@@ -1581,7 +2435,15 @@ begin
 							-- bypass the previous write to v.fpaddr0 when software wishes
 							-- to read the random token (bit CTRL_RD_TOKEN is set in W_CTRL)
 							v_read_no_error := TRUE;
-							if r.axi.wdatax(CTRL_RD_TOKEN) = '1' then
+							if v_jobq_rd then
+								-- (s294) the token of the open entry of the job queue or the
+								-- result of the job at its head (see qb_raddr & rs_raddr
+								-- below) is read instead of ecc_fp_dram, see (s303)
+								if r.axi.wdatax(CTRL_RD_TOKEN) = '1' then
+									v.fpaddr0 := CST_ADDR_TOKEN
+										& std_logic_vector(to_unsigned(0, log2(n - 1)));
+								end if;
+							elsif r.axi.wdatax(CTRL_RD_TOKEN) = '1' then
 								-- In debug mode the operation is subject to the token feature
 								-- being activated through the W_DBG_CFG_TOKEN register
 								-- (see (s224)), while in production mode, the feature is always
@@ -1605,6 +2467,12 @@ begin
 								end if;
 							end if;
 							if v_read_no_error then
+								if v_jobq_rd then
+									v.read.jobq := '1';
+									v.read.jobqres := not r.axi.wdatax(CTRL_RD_TOKEN);
+								else
+									v.read.jobq := '0';
+								end if;
 								v.read.fpre0 := '1';
 								v.read.rdataxcanbefilled := '1';
 								v.read.shdatawwcanbeemptied := '0';
@@ -1628,7 +2496,8 @@ begin
 						--              start of a new [k]P computation
 						-- ----------------------------------------------------------
 						-- (s188)
-						if v_kp_possible then -- (s115)
+						-- (R1 must be in affine form, see (s276))
+						if v_kp_possible and r.ctrl.proj = '0' then -- (s115)
 							v.ctrl.agokp := '1'; -- (s174)
 							v.ctrl.lockaxi := '1'; -- (s68), will be deasserted by (s69)
 							v.ctrl.ierrid(STATUS_ERR_I_KP_FBD) := '0'; -- (s175)
@@ -1636,15 +2505,67 @@ begin
 							-- SW settings are not enough to perform a point-computation
 							v.ctrl.ierrid(STATUS_ERR_I_KP_FBD) := '1'; -- (s176)
 						end if;
+					elsif r.axi.wdatax(CTRL_KG) = '1' then
+						-- ----------------------------------------------------------
+						--     start of a new [k]G computation (stored base point)
+						-- ----------------------------------------------------------
+						-- (s269)
+						-- Same as [k]P except that both coordinates of R1 are first
+						-- copied from the stored base point memory into ecc_fp_dram
+						-- (see (s270)) instead of being written by software. The
+						-- request to ecc_scalar is only issued once the copy is over.
+						-- The command is only available if 'basepoint' is set (see
+						-- ecc_customize), otherwise it is simply refused.
+						if basepoint and v_kp_possible and r.bp.xvalid(0) = '1'
+							and r.bp.yvalid(0) = '1' and r.bp.isnull(0) = '0'
+						then
+							v.bp.copy := '1';
+							v.bp.kg := '1';
+							v.bp.dst := '1';
+							v.bp.rslot := (others => '0');
+							v.ctrl.proj := '0'; -- R1 is overwritten, see (s276)
+							v.bp.raddr := (others => '0');
+							v.bp.capture := '0'; -- see (s267)
+							v.ctrl.lockaxi := '1'; -- deasserted by (s69) as for [k]P
+							v.ctrl.ierrid(STATUS_ERR_I_KP_FBD) := '0';
+						else
+							-- either SW settings are not enough to perform a point-
+							-- computation, or no base point was stored, or the [k]G
+							-- command is not available
+							v.ctrl.ierrid(STATUS_ERR_I_KP_FBD) := '1';
+						end if;
 					-- ----------------------------------------------------------
 					--               other point-based operations
 					-- ----------------------------------------------------------
 					-- (s189)
+					-- (s276) Projective point operations: when CTRL_PT_PROJ is set
+					-- along with CTRL_PT_ADD (resp. CTRL_PT_DBL) the result R1 <-
+					-- R0 + R1 (resp. R1 <- [2]R1) is left in projective form (Co-Z
+					-- Jacobian coordinates, in Montgomery domain) in ecc_fp_dram,
+					-- and r.ctrl.proj gets asserted (see (s277)) so that the next
+					-- projective operation takes R1 as is, without any inversion
+					-- in-between. R0 is always given (and left) in affine form.
+					-- CTRL_PT_NORM converts R1 back to affine form (the only inver-
+					-- sion of the chain). Neither R0 nor R1 can be null here (soft-
+					-- ware handles these trivial cases). While r.ctrl.proj is set,
+					-- any other point-based operation is forbidden (software must
+					-- first issue CTRL_PT_NORM or write a new affine point R1).
 					elsif r.axi.wdatax(CTRL_PT_ADD) = '1' then
 						-- SW is asking for a point addition
-						if v_pop_possible then
+						-- (the projective form is only available if 'projective'
+						-- is set (see ecc_customize), otherwise it is refused)
+						if v_pop_possible and (projective or
+							r.axi.wdatax(CTRL_PT_PROJ) = '0') and
+							(r.axi.wdatax(CTRL_PT_PROJ) = '1' or
+							r.ctrl.proj = '0') and (r.axi.wdatax(CTRL_PT_PROJ) = '0' or
+							(r.ctrl.r0_is_null = '0' and r.ctrl.r1_is_null = '0'))
+						then
 							v.ctrl.dopop := '1';
 							v.ctrl.popid := ECC_AXI_POINT_ADD;
+							v.ctrl.popproj := r.axi.wdatax(CTRL_PT_PROJ);
+							v.ctrl.popprojin := r.ctrl.proj;
+							v.ctrl.popfp := '0';
+							v.ctrl.popkp2 := '0';
 							v.ctrl.lockaxi := '1'; -- (s89), will be deasserted by (s90)
 							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '0';
 						else
@@ -1653,20 +2574,51 @@ begin
 						end if;
 					elsif r.axi.wdatax(CTRL_PT_DBL) = '1' then
 						-- SW is asking for a point doubling
-						if v_pop_possible then
+						-- (same restriction as for addition above)
+						if v_pop_possible and (projective or
+							r.axi.wdatax(CTRL_PT_PROJ) = '0') and
+							(r.axi.wdatax(CTRL_PT_PROJ) = '1' or
+							r.ctrl.proj = '0') and (r.axi.wdatax(CTRL_PT_PROJ) = '0' or
+							r.ctrl.r1_is_null = '0')
+						then
 							v.ctrl.dopop := '1';
 							v.ctrl.popid := ECC_AXI_POINT_DBL;
+							v.ctrl.popproj := r.axi.wdatax(CTRL_PT_PROJ);
+							v.ctrl.popprojin := r.ctrl.proj;
+							v.ctrl.popfp := '0';
+							v.ctrl.popkp2 := '0';
 							v.ctrl.lockaxi := '1'; -- (s89), will be deasserted by (s90)
 							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '0';
 						else
 							-- SW settings are not enough to perform a point-computation
 							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '1';
 						end if;
+					elsif r.axi.wdatax(CTRL_PT_NORM) = '1' then
+						-- SW wants to convert projective point R1 back to affine form
+						-- (r.ctrl.proj can't be set if 'projective' is not set,
+						-- the test below only makes it explicit)
+						if projective and v_pop_possible and r.ctrl.proj = '1' then
+							v.ctrl.dopop := '1';
+							v.ctrl.popid := ECC_AXI_POINT_NRM;
+							v.ctrl.popproj := '0';
+							v.ctrl.popprojin := '1';
+							v.ctrl.popfp := '0';
+							v.ctrl.popkp2 := '0';
+							v.ctrl.lockaxi := '1'; -- (s89), will be deasserted by (s90)
+							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '0';
+						else
+							-- there is no projective point to normalize
+							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '1';
+						end if;
 					elsif r.axi.wdatax(CTRL_PT_CHK) = '1' then
 						-- SW is asking to check if a point is on curve
-						if v_pop_possible then
+						if v_pop_possible and r.ctrl.proj = '0' then
 							v.ctrl.dopop := '1';
 							v.ctrl.popid := ECC_AXI_POINT_CHK;
+							v.ctrl.popproj := '0';
+							v.ctrl.popprojin := '0';
+							v.ctrl.popfp := '0';
+							v.ctrl.popkp2 := '0';
 							v.ctrl.lockaxi := '1'; -- (s89), will be deasserted by (s90)
 							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '0';
 						else
@@ -1675,9 +2627,13 @@ begin
 						end if;
 					elsif r.axi.wdatax(CTRL_PT_NEG) = '1' then
 						-- SW wants to compute the opposite of a given point
-						if v_pop_possible then
+						if v_pop_possible and r.ctrl.proj = '0' then
 							v.ctrl.dopop := '1';
 							v.ctrl.popid := ECC_AXI_POINT_NEG;
+							v.ctrl.popproj := '0';
+							v.ctrl.popprojin := '0';
+							v.ctrl.popfp := '0';
+							v.ctrl.popkp2 := '0';
 							v.ctrl.lockaxi := '1'; -- (s89), will be deasserted by (s90)
 							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '0';
 						else
@@ -1686,9 +2642,13 @@ begin
 						end if;
 					elsif r.axi.wdatax(CTRL_PT_EQU) = '1' then
 						-- SW wants to compute the opposite of a given point
-						if v_pop_possible then
+						if v_pop_possible and r.ctrl.proj = '0' then
 							v.ctrl.dopop := '1';
 							v.ctrl.popid := ECC_AXI_POINT_EQU;
+							v.ctrl.popproj := '0';
+							v.ctrl.popprojin := '0';
+							v.ctrl.popfp := '0';
+							v.ctrl.popkp2 := '0';
 							v.ctrl.lockaxi := '1'; -- (s89), will be deasserted by (s90)
 							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '0';
 						else
@@ -1697,15 +2657,55 @@ begin
 						end if;
 					elsif r.axi.wdatax(CTRL_PT_OPP) = '1' then
 						-- SW wants to compute the opposite of a given point
-						if v_pop_possible then
+						if v_pop_possible and r.ctrl.proj = '0' then
 							v.ctrl.dopop := '1';
 							v.ctrl.popid := ECC_AXI_POINT_OPP;
+							v.ctrl.popproj := '0';
+							v.ctrl.popprojin := '0';
+							v.ctrl.popfp := '0';
+							v.ctrl.popkp2 := '0';
 							v.ctrl.lockaxi := '1'; -- (s89), will be deasserted by (s90)
 							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '0';
 						else
 							-- SW settings are not enough to perform a point-computation
 							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '1';
 						end if;
+					-- ----------------------------------------------------------
+					--               field arithmetic operations
+					-- ----------------------------------------------------------
+					-- (s283) XR1 <- XR0 op YR0 mod p (XR1 <- XR0^-1 mod p for the
+					-- inversion, XR1 <- XR0^YR0 mod p for the exponentiation),
+					-- operands and result in [0, p[ and in normal (non Montgomery)
+					-- form, unless CTRL_FP_MTY is set, in which case XR0 and XR1
+					-- are in Montgomery form (YR0 too, except for the exponentia-
+					-- tion where it remains a plain exponent). ECC_AXI_FP_MTY &
+					-- ECC_AXI_FP_NOMTY convert XR0 to & from Montgomery form.
+					-- 'p' here is whatever modulus software wrote at the address
+					-- of 'p' (e.g the order q of the curve). The 3-bit field
+					-- CTRL_FP_OPID directly uses the ECC_AXI_FP_* encoding (see
+					-- ecc_pkg.vhd), all 8 values of which are valid. As R1 gets
+					-- overwritten, software will have to write a point again
+					-- before [k]P.
+					-- The command is only available if 'fieldops' is set (see
+					-- ecc_customize), otherwise it is simply refused.
+					elsif r.axi.wdatax(CTRL_FP_OP) = '1' then
+						if fieldops and v_fop_possible and r.ctrl.proj = '0' then
+							v.ctrl.dopop := '1';
+							v.ctrl.popproj := '0';
+							v.ctrl.popprojin := '0';
+							v.ctrl.popfp := '1';
+							v.ctrl.popkp2 := '0';
+							v.ctrl.fpopid :=
+								r.axi.wdatax(CTRL_FP_OPID_MSB downto CTRL_FP_OPID_LSB);
+							v.ctrl.fpmty := r.axi.wdatax(CTRL_FP_MTY);
+							v.ctrl.x_set := '0';
+							v.ctrl.y_set := '0';
+							v.ctrl.lockaxi := '1'; -- (s89), will be deasserted by (s90)
+							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '0';
+						else
+							-- no modulus (or R1 in projective form)
+							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '1';
+						end if;
 					end if; -- decoding content of W_CTRL register
 					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0'; -- clr possible past error
 				else
@@ -1782,6 +2782,7 @@ begin
 				v.axi.bvalid := '1';
 				if (not v_wlock) or debug then -- (s164), see (s161)
 					v.ctrl.r1_is_null := r.axi.wdatax(WR1_IS_NULL);
+					v.ctrl.proj := '0'; -- see (s276)
 					-- clear possible past error
 					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0';
 				else
@@ -1812,6 +2813,17 @@ begin
 						v.ctrl.state := newnn;
 						v.nndyn.active := '1';
 						v.nndyn.testnn := '1'; -- asserted only 1 cycle, see (s169)
+						-- a new value of nn invalidates all the point slots (their
+						-- coordinates have the size of the previous nn) as well
+						-- as any chain of projective point operations
+						v.bp.xvalid := (others => '0');
+						v.bp.yvalid := (others => '0');
+						v.ctrl.proj := '0'; -- see (s276)
+						-- and the contexts of both moduli (the next 'p' written
+						-- is the one of a new curve), see (s308)
+						v.mc.modq := '0';
+						v.mc.pvalid := '0';
+						v.mc.qvalid := '0';
 						-- clear possible past error
 						v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0';
 					else
@@ -2036,6 +3048,379 @@ begin
 					v.axi.wready := '1'; -- (s159), see (s157)
 				end if;
 			-- ------------------------------------------------
+			-- decoding write to W_PT_SLOT register
+			-- ------------------------------------------------
+			elsif r.axi.waddr = W_PT_SLOT
+			then
+				v.axi.wready := '1';
+				v.axi.awready := '1';
+				v.axi.arready := '1';
+				v.axi.bvalid := '1';
+				-- The register is only available if 'ptslots' is set (see
+				-- ecc_customize), otherwise its writes are simply refused (the
+				-- writes of XR1/YR1 with CTRL_WRITE_BP then always go to slot 0,
+				-- i.e the base point of [k]G).
+				if ptslots and not v_wlock then
+					-- (s278) The slot field selects the slot that the next writes
+					-- of XR1/YR1 with CTRL_WRITE_BP will be captured into, see (s266)
+					-- (the capture of a large number possibly still in progress is
+					-- aborted and the corresponding coordinate stays invalid).
+					-- Along with PTSLOT_LOAD, the point held in the slot is copied
+					-- into R1 (or into R0 if PTSLOT_R0 is set), see (s270).
+					-- Along with PTSLOT_SAVE, R1 is copied into the slot, see (s279).
+					-- Both copies are performed by hardware in the background
+					-- (2w cycles) during which the IP is signaled as busy.
+					-- Along with PTSLOT_KP, the point held in the slot is copied
+					-- into R1 and a [k]P computation is started on it, exactly
+					-- as for CTRL_KG with slot 0 (see (s269)), so that a point
+					-- staged during the previous [k]P (see (s287)) can be used
+					-- without any further transfer.
+					v.bp.wslot := r.axi.wdatax(PTSLOT_NB_MSB downto PTSLOT_NB_LSB);
+					v.bp.capture := '0';
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0';
+					if r.axi.wdatax(PTSLOT_LOAD) = '1' then
+						if r.bp.xvalid(to_integer(unsigned(r.axi.wdatax(
+								PTSLOT_NB_MSB downto PTSLOT_NB_LSB)))) = '1'
+							and r.bp.yvalid(to_integer(unsigned(r.axi.wdatax(
+								PTSLOT_NB_MSB downto PTSLOT_NB_LSB)))) = '1'
+						then
+							v.bp.copy := '1';
+							v.bp.kg := '0';
+							v.bp.dst := not r.axi.wdatax(PTSLOT_R0);
+							v.bp.rslot := r.axi.wdatax(PTSLOT_NB_MSB downto PTSLOT_NB_LSB);
+							v.bp.raddr := (others => '0');
+							if r.axi.wdatax(PTSLOT_R0) = '0' then
+								v.ctrl.proj := '0'; -- R1 is overwritten, see (s276)
+							end if;
+							v.ctrl.lockaxi := '1'; -- deasserted at the end of (s270)
+							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '0';
+						else
+							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '1';
+						end if;
+					elsif r.axi.wdatax(PTSLOT_SAVE) = '1' then
+						-- R1 can't be saved in projective form (see (s276)) nor while
+						-- software is not allowed to read it back
+						if r.ctrl.proj = '0' and r.ctrl.read_forbidden = '0' then
+							v.bp.save := '1';
+							v.bp.sslot := r.axi.wdatax(PTSLOT_NB_MSB downto PTSLOT_NB_LSB);
+							v.bp.saddr := (others => '0');
+							v.bp.swaddr := (others => '0');
+							v.bp.xvalid(to_integer(unsigned(r.axi.wdatax(
+								PTSLOT_NB_MSB downto PTSLOT_NB_LSB)))) := '0';
+							v.bp.yvalid(to_integer(unsigned(r.axi.wdatax(
+								PTSLOT_NB_MSB downto PTSLOT_NB_LSB)))) := '0';
+							v.ctrl.lockaxi := '1'; -- deasserted at the end of (s279)
+							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '0';
+						else
+							v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '1';
+						end if;
+					elsif r.axi.wdatax(PTSLOT_KP) = '1' then
+						if v_kp_possible and r.bp.xvalid(to_integer(unsigned(
+								r.axi.wdatax(PTSLOT_NB_MSB downto PTSLOT_NB_LSB)))) = '1'
+							and r.bp.yvalid(to_integer(unsigned(r.axi.wdatax(
+								PTSLOT_NB_MSB downto PTSLOT_NB_LSB)))) = '1'
+							and r.bp.isnull(to_integer(unsigned(r.axi.wdatax(
+								PTSLOT_NB_MSB downto PTSLOT_NB_LSB)))) = '0'
+						then
+							v.bp.copy := '1';
+							v.bp.kg := '1';
+							v.bp.dst := '1';
+							v.bp.rslot := r.axi.wdatax(PTSLOT_NB_MSB downto PTSLOT_NB_LSB);
+							v.ctrl.proj := '0'; -- R1 is overwritten, see (s276)
+							v.bp.raddr := (others => '0');
+							v.bp.capture := '0'; -- see (s267)
+							v.ctrl.lockaxi := '1'; -- deasserted by (s69) as for [k]P
+							v.ctrl.ierrid(STATUS_ERR_I_KP_FBD) := '0';
+						else
+							v.ctrl.ierrid(STATUS_ERR_I_KP_FBD) := '1';
+						end if;
+					end if;
+				elsif ptslots and v_stage_possible
+					and r.axi.wdatax(PTSLOT_LOAD) = '0'
+					and r.axi.wdatax(PTSLOT_SAVE) = '0'
+					and r.axi.wdatax(PTSLOT_KP) = '0'
+				then
+					-- while a [k]P is running, software can only select the slot
+					-- into which the next point will be staged, see (s287)
+					v.bp.wslot := r.axi.wdatax(PTSLOT_NB_MSB downto PTSLOT_NB_LSB);
+					v.bp.capture := '0';
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0';
+				else
+					-- raise error flag (illicite register write)
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+				end if;
+			-- ------------------------------------------------
+			-- decoding write to W_CURVE_A register
+			-- ------------------------------------------------
+			elsif r.axi.waddr = W_CURVE_A
+			then
+				v.axi.wready := '1';
+				v.axi.awready := '1';
+				v.axi.arready := '1';
+				v.axi.bvalid := '1';
+				-- The register is only available if 'ashape' is set (see
+				-- ecc_customize), otherwise its writes are simply refused
+				-- (microcode then has no shortcut to take and both flags stay
+				-- cleared).
+				if ashape and not v_wlock then
+					-- (s281) Software declares the shape of curve parameter 'a'
+					-- (a = 0 or a = -3 mod p) so that microcode can take the
+					-- corresponding shortcut (see OPCODE_BRA_BAS in
+					-- ecc_pkg.vhd). 'a' being public, hardware does not check
+					-- the claim: it is software's responsability to write this
+					-- register consistently with the values of 'p' and 'a'.
+					-- Any new write of 'p' or 'a' (or of the prime size)
+					-- clears both flags.
+					v.ctrl.azero := r.axi.wdatax(CURVE_A_ZERO)
+						and not r.axi.wdatax(CURVE_A_M3);
+					v.ctrl.am3 := r.axi.wdatax(CURVE_A_M3)
+						and not r.axi.wdatax(CURVE_A_ZERO);
+					-- clear possible past error
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0';
+				else
+					-- raise error flag (illicite register write)
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+				end if;
+			-- ------------------------------------------------
+			-- decoding write to W_PT_DEC register
+			-- ------------------------------------------------
+			elsif r.axi.waddr = W_PT_DEC
+			then
+				v.axi.wready := '1';
+				v.axi.awready := '1';
+				v.axi.arready := '1';
+				v.axi.bvalid := '1';
+				if not v_wlock then
+					-- (s285) Software asks for the decompression of the point R1
+					-- of which only the x-coordinate XR1 was written: YR1 is
+					-- computed as the square root of XR1^3 + a.XR1 + b whose
+					-- parity is given by PTDEC_ODD (see .decompress_evenL &
+					-- .decompress_oddL - only valid for p = 3 mod 4, which is
+					-- up to software to ensure). The answer as to whether XR1
+					-- is actually the x-coordinate of a point on the curve is
+					-- given in R_STATUS as for a CTRL_PT_CHK test. On success
+					-- R1 is no longer null, hence can be directly used as the
+					-- input point of a [k]P computation.
+					-- The command is only available if 'decompress' is set (see
+					-- ecc_customize), otherwise it is simply refused.
+					if decompress and v_pop_possible and r.ctrl.proj = '0' then
+						v.ctrl.dopop := '1';
+						v.ctrl.popid := ECC_AXI_POINT_DEC;
+						v.ctrl.popproj := '0';
+						v.ctrl.popprojin := '0';
+						v.ctrl.popfp := '0';
+						v.ctrl.popkp2 := '0';
+						v.ctrl.decodd := r.axi.wdatax(PTDEC_ODD);
+						v.ctrl.lockaxi := '1'; -- (s89), will be deasserted by (s90)
+						v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '0';
+					else
+						v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '1';
+					end if;
+					-- clear possible past error
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0';
+				else
+					-- raise error flag (illicite register write)
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+				end if;
+			-- ------------------------------------------------
+			-- decoding write to W_KP2 register
+			-- ------------------------------------------------
+			elsif r.axi.waddr = W_KP2
+			then
+				v.axi.wready := '1';
+				v.axi.awready := '1';
+				v.axi.arready := '1';
+				v.axi.bvalid := '1';
+				if not v_wlock then
+					-- (s290) Double scalar multiplication R1 <- [k1]P1 + [k2]P2
+					-- (Shamir's trick, see .kp2_*L routines - not constant time,
+					-- for public scalars only), in two steps:
+					--   - KP2_RUN = 0: P1 = R0 & P2 = R1 (both affine & non null)
+					--     are loaded (in Montgomery form) into variables of their
+					--     own, which asserts r.ctrl.kp2ld, see (s291)
+					--   - KP2_RUN = 1: XR0 & YR0 hold the bits of k1 & k2 below
+					--     their common msb position, in reverse order (k2 followed
+					--     by a sentinel bit) & KP2_P1/KP2_P2 give the msb of k1/k2.
+					--     R1 gets the (affine) result on success, which is answered
+					--     in R_STATUS as for a CTRL_PT_CHK test. R1 is marked null
+					--     otherwise (an intermediate sum of two points with equal
+					--     x-coordinates, or a null result, which is up to software
+					--     to handle). The same P1 & P2 can be used by several runs
+					-- The command is only available if 'dualkp' is set (see
+					-- ecc_customize), otherwise it is simply refused.
+					if dualkp and v_pop_possible and r.ctrl.proj = '0' and (
+						(r.axi.wdatax(KP2_RUN) = '0' and r.ctrl.r0_is_null = '0'
+							and r.ctrl.r1_is_null = '0') or
+						(r.axi.wdatax(KP2_RUN) = '1' and r.ctrl.kp2ld = '1'
+							and (r.axi.wdatax(KP2_P1) = '1' or r.axi.wdatax(KP2_P2) = '1')))
+					then
+						v.ctrl.dopop := '1';
+						v.ctrl.popproj := '0';
+						v.ctrl.popprojin := '0';
+						v.ctrl.popfp := '0';
+						v.ctrl.popkp2 := '1';
+						if r.axi.wdatax(KP2_RUN) = '0' then
+							v.ctrl.kp2op := ECC_AXI_KP2_LOAD;
+						else
+							v.ctrl.kp2op := r.axi.wdatax(KP2_P2) & r.axi.wdatax(KP2_P1);
+						end if;
+						v.ctrl.lockaxi := '1'; -- (s89), will be deasserted by (s90)
+						v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '0';
+					else
+						v.ctrl.ierrid(STATUS_ERR_I_POP_FBD) := '1';
+					end if;
+					-- clear possible past error
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0';
+				else
+					-- raise error flag (illicite register write)
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+				end if;
+			-- ------------------------------------------------
+			-- decoding write to W_MODULUS register
+			-- ------------------------------------------------
+			elsif r.axi.waddr = W_MODULUS
+			then
+				v.axi.wready := '1';
+				v.axi.awready := '1';
+				v.axi.arready := '1';
+				v.axi.bvalid := '1';
+				-- The register is only available if 'qcontext' is set (see
+				-- ecc_customize), otherwise its writes are simply refused.
+				if qcontext and not v_wlock
+					and r.write.active = '0' and r.read.active = '0'
+				then
+					-- (s308) Software selects the modulus that the IP works with:
+					-- p (the prime of the curve) or q (its order, only used for
+					-- the field arithmetic operations, see (s283)). Both moduli
+					-- are written at the address of p, and the Montgomery
+					-- constants of each one are computed once (see (s11)) and
+					-- then saved along with it in a context of its own, see
+					-- (s310), while the multipliers keep p & p' (resp. q & q')
+					-- in a bank of their own (output 'mbank'). Switching to a
+					-- modulus the context of which is valid (bits STATUS_QCTX of
+					-- R_STATUS for q) only takes to copy this context back into
+					-- ecc_fp_dram, see (s312). Otherwise, software must write
+					-- the modulus (q, or the whole curve for p) once again.
+					-- While q is the modulus in use, curve parameter 'a' can't be
+					-- written, see (s314), nor can any point-based operation be
+					-- started (see v_pop_possible), the curve, the stored base
+					-- point & the point slots being left untouched.
+					if r.axi.wdatax(MOD_Q) /= r.mc.modq then
+						v.mc.modq := r.axi.wdatax(MOD_Q);
+						v.ctrl.p_set := '0';
+						v.ctrl.p_set_and_mty := '0';
+						if (r.axi.wdatax(MOD_Q) = '1' and r.mc.qvalid = '1')
+							or (r.axi.wdatax(MOD_Q) = '0' and r.mc.pvalid = '1')
+						then
+							v.mc.copy := '1';
+							v.mc.raddr := (others => '0');
+							v.ctrl.proj := '0'; -- ZR01 is not part of the context
+							v.bp.capture := '0'; -- see (s267)
+							v.ctrl.lockaxi := '1'; -- deasserted at the end of (s312)
+						elsif r.axi.wdatax(MOD_Q) = '0' then
+							-- no context for p (e.g after a change of nn): the
+							-- whole curve must be written again
+							v.ctrl.a_set := '0';
+							v.ctrl.a_set_and_mty := '0';
+							v.ctrl.azero := '0'; -- see (s281)
+							v.ctrl.am3 := '0';
+						end if;
+					end if;
+					-- clear possible past error
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0';
+				else
+					-- raise error flag (illicite register write)
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+				end if;
+			-- ------------------------------------------------
+			-- decoding write to W_JOBQ_CTRL register
+			-- ------------------------------------------------
+			-- (without the job queue, see 'jobqueue' in ecc_customize, the
+			-- register is handled as an unknown one)
+			elsif jobqueue -- statically resolved by synthesizer
+			  and r.axi.waddr = W_JOBQ_CTRL
+			then
+				v.axi.wready := '1';
+				v.axi.awready := '1';
+				v.axi.arready := '1';
+				v.axi.bvalid := '1';
+				-- (s304) commands of the job queue, see (s292) (only one of them is
+				-- considered, with the priorities below). None of them is accepted
+				-- while a large number is being transferred.
+				--   - JOBQ_PUSH closes the open entry, making it a job which will be
+				--     launched by (s295) as soon as the IP is free. As for CTRL_KP,
+				--     the token must have been read & the curve parameters set, and
+				--     the blinding config must not have changed since the scalar
+				--     was written.
+				--   - JOBQ_DROP closes the open entry, discarding it.
+				--   - JOBQ_OPEN opens the entry at the tail of the queue, provided
+				--     it is not full & the IP is either idle or only busy with the
+				--     jobs of the queue, and starts the generation of its token,
+				--     see (s298) (bit JOBQ_STATUS_FILL in R_JOBQ_STATUS).
+				--   - JOBQ_POP releases the job at the head of the queue once done.
+				--   - JOBQ_RES binds the reads of XR1/YR1 to the result of the job
+				--     at the head of the queue once done, see (s294) (until the
+				--     next JOBQ_POP).
+				if r.ctrl.state = idle and r.write.active = '0' and r.write.jobq = '0'
+					and r.read.active = '0'
+				then
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '0';
+					if r.axi.wdatax(JOBQ_PUSH) = '1' then
+						if r.jobq.isopen = '1' and r.jobq.tokgen = '0'
+							and r.jobq.kset(v_jobq_t) = '1' and r.jobq.xset(v_jobq_t) = '1'
+							and r.jobq.yset(v_jobq_t) = '1'
+							and (r.jobq.tokread(v_jobq_t) = '1'
+							     or (debug and r.ctrl.token_act = '0'))
+							and v_pop_possible
+							and ((not nn_dynamic) or r.nndyn.valwerr = '0')
+							and (r.jobq.arith(v_jobq_t) = '0' or r.ctrl.q_set = '1')
+							and r.jobq.arith(v_jobq_t) = r.ctrl.doblinding
+						then
+							v.jobq.isopen := '0';
+							v.jobq.tail := r.jobq.tail + 1;
+							v.ctrl.ierrid(STATUS_ERR_I_KP_FBD) := '0';
+						else
+							v.ctrl.ierrid(STATUS_ERR_I_KP_FBD) := '1';
+						end if;
+					elsif r.axi.wdatax(JOBQ_DROP) = '1' then
+						v.jobq.isopen := '0';
+						v.jobq.tokgen := '0';
+					elsif r.axi.wdatax(JOBQ_OPEN) = '1' then
+						if r.jobq.isopen = '0' and initdone = '1'
+							and (r.jobq.tail(JOBQ_SZ - 1 downto 0)
+							       /= r.jobq.head(JOBQ_SZ - 1 downto 0)
+							     or r.jobq.tail = r.jobq.head)
+							and ((not v_wlock) or v_jobq_busy)
+						then
+							v.jobq.isopen := '1';
+							v.jobq.tokgen := '1';
+							v.jobq.taddr := (others => '0');
+							v.jobq.kset(v_jobq_t) := '0';
+							v.jobq.xset(v_jobq_t) := '0';
+							v.jobq.yset(v_jobq_t) := '0';
+							v.jobq.tokread(v_jobq_t) := '0';
+						else
+							v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+						end if;
+					elsif r.axi.wdatax(JOBQ_POP) = '1' then
+						if r.jobq.done /= r.jobq.head then
+							v.jobq.head := r.jobq.head + 1;
+							v.jobq.res := '0';
+						else
+							v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+						end if;
+					elsif r.axi.wdatax(JOBQ_RES) = '1' then
+						if r.jobq.done /= r.jobq.head then
+							v.jobq.res := '1';
+						else
+							v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+						end if;
+					end if;
+				else
+					-- raise error flag (illicite register write)
+					v.ctrl.ierrid(STATUS_ERR_I_WREG_FBD) := '1';
+				end if;
+			-- ------------------------------------------------
 			-- decoding write to W_SOFT_RESET register
 			-- ------------------------------------------------
 			elsif r.axi.waddr = W_SOFT_RESET
@@ -2069,6 +3454,9 @@ begin
 					and r.ctrl.gentoken = '0' -- no sense if command already issued
 					and r.ctrl.tokpending = '0' -- no sense if action still pending
 					and r.ctrl.tokavail4read = '0' -- no sense if token avail. & not read
+					-- the token of the jobs of the queue would be overwritten
+					-- (they bring their own, see (s298))
+					and not v_jobq_busy
 				then
 					v.ctrl.gentoken := '1';
 					v.ctrl.lockaxi := '1'; -- (s224), will be deasserted by (s225)
@@ -2280,6 +3668,7 @@ begin
 			-- -------------------------------------------------------------
 			elsif debug and r.axi.waddr = W_DBG_FP_WADDR then
 				v.fpaddr0 := r.axi.wdatax(FP_ADDR - 1 downto 0);
+				v.bp.capture := '0'; -- see (s267)
 				-- assert both AWREADY & WREADY signals to allow a new AXI data-beat
 				-- to happen again
 				v.axi.awready := '1';
@@ -2408,7 +3797,10 @@ begin
 		-- r.write.rnd.irn to be resumed thx to (s67)
 		
 		-- handshake with ecc_trng
-		if r.write.rnd.trngrdy = '1' and trngvalid = '1' then
+		-- (s299) the random drawn while the token of the job queue is being
+		-- generated goes to the token, see (s298)
+		if r.write.rnd.trngrdy = '1' and trngvalid = '1' and r.jobq.tokgen = '0'
+		then
 			v.write.rnd.trngrdy := '0';
 			v.write.rnd.irn := trngdata;
 			v.write.rnd.irnempty := '0';
@@ -2500,7 +3892,11 @@ begin
 			-- detecting if the current LSbit is non-null
 			if r.ctrl.wk = '1' then
 				if r.axi.wdatax(0) = '1' then
-					v.ctrl.k_is_null := '0';
+					if r.write.jobq = '1' then
+						v.jobq.wknull := '0'; -- see (s293)
+					else
+						v.ctrl.k_is_null := '0';
+					end if;
 				end if;
 			end if;
 			-- decrement counters
@@ -2585,7 +3981,19 @@ begin
 					-- (s178), see (s177)
 					v_fpaddr0_msb :=
 						r.fpaddr0(log2(n - 1) + FP_ADDR_MSB - 1 downto log2(n - 1));
-					if v_fpaddr0_msb = CST_ADDR_P then
+					if r.write.jobq = '1' then
+						-- large number written into the open entry of the job queue,
+						-- see (s293) (r.fpaddr0 may hold the address of the mask of
+						-- the scalar, hence the test on r.ctrl.wk as in (s123))
+						if r.ctrl.wk = '1' then
+							v.jobq.kset(v_jobq_t) := '1';
+							v.jobq.knull(v_jobq_t) := r.jobq.wknull;
+						elsif v_fpaddr0_msb = CST_ADDR_XR1 then
+							v.jobq.xset(v_jobq_t) := '1';
+						elsif v_fpaddr0_msb = CST_ADDR_YR1 then
+							v.jobq.yset(v_jobq_t) := '1';
+						end if;
+					elsif v_fpaddr0_msb = CST_ADDR_P then
 						v.ctrl.p_set := '1'; -- (s112)
 					elsif v_fpaddr0_msb = CST_ADDR_A then
 						v.ctrl.a_set := '1'; -- (s113), see (s181)
@@ -2608,11 +4016,23 @@ begin
 						v.ctrl.q_set := '1';
 					--elsif v_fpaddr0_msb = CST_ADDR_K then
 					--	v.ctrl.k_set := '1'; -- error, see (s123) below
-					elsif v_fpaddr0_msb = CST_ADDR_XR1 then
+					elsif v_fpaddr0_msb = CST_ADDR_XR1 and r.write.stage = '0' then
 						v.ctrl.x_set := '1';
-					elsif v_fpaddr0_msb = CST_ADDR_YR1 then
+					elsif v_fpaddr0_msb = CST_ADDR_YR1 and r.write.stage = '0' then
 						v.ctrl.y_set := '1';
 					end if;
+					-- (s268), see (s266)
+					-- Note that r.bp.capture is not deasserted here, as the write of
+					-- the last limb into the resident point memory (see (s267)) is
+					-- still in the pipeline. It is deasserted by the next large
+					-- number write.
+					if r.bp.capture = '1' then
+						if v_fpaddr0_msb = CST_ADDR_XR1 then
+							v.bp.xvalid(to_integer(unsigned(r.bp.wslot))) := '1';
+						elsif v_fpaddr0_msb = CST_ADDR_YR1 then
+							v.bp.yvalid(to_integer(unsigned(r.bp.wslot))) := '1';
+						end if;
+					end if;
 					-- (s123) We can't use r.fpaddr0 to detect that scalar k is the large
 					-- nb currently written (because in that case r.fpaddr0 might as well
 					-- contain the address of the mask for k), so we use a special flag
@@ -2757,7 +4177,13 @@ begin
 			v.write.fpwe0 := '1';
 			if r.write.rnd.firstwwmask = '1' then
 				v.write.rnd.firstwwmask := '0';
-				v.write.rnd.masklsb := r.write.rnd.kmask(0);
+				if r.write.jobq = '1' then
+					-- (ecc_curve may be using .masklsb for the current job, the one
+					-- of the entry is applied when it is launched, see (s295))
+					v.jobq.masklsb(v_jobq_t) := r.write.rnd.kmask(0);
+				else
+					v.write.rnd.masklsb := r.write.rnd.kmask(0);
+				end if;
 			end if;
 		end if;
 
@@ -2841,7 +4267,9 @@ begin
 			-- we test if curve parameter 'a' has already been set by software,
 			-- and if so we make ecc_scalar execute routine .aMontyL to switch
 			-- 'a' in Montgomery domain
-			if r.ctrl.a_set = '1' then
+			-- (not if the constants are the ones of q, which is not the modulus
+			-- 'a' is defined by, see (s313))
+			if r.ctrl.a_set = '1' and r.mc.modq = '0' then
 				v.ctrl.agomtya := '1'; -- (s104), will be reset by (s105)
 				v.ctrl.mtyirq_postponed := '1'; -- (s106)
 				-- we keep .mtypending asserted to maintain (s30) coherent
@@ -2856,6 +4284,10 @@ begin
 				end if;
 			end if;
 			v.ctrl.p_set_and_mty := '1'; -- (s110), see (s179) & (s180)
+			-- the new constants will be saved along with the modulus, see (s311)
+			if qcontext then -- statically resolved by synthesizer
+				v.mc.savepending := '1';
+			end if;
 		end if;
 
 		-- {deassertion of r.ctrl.agocstmty}/{assertion of r.ctrl.mtypending}
@@ -2864,6 +4296,7 @@ begin
 			v.ctrl.agocstmty := '0'; -- (s1)
 			v.ctrl.mtypending := '1';
 			v.ctrl.newp := '0'; -- (s8)
+			v.ctrl.kp2ld := '0'; -- (s291)
 		end if;
 
 		-- deassertion of r.ctrl.amtypending once ecc_scalar has asserted amtydone
@@ -2887,6 +4320,7 @@ begin
 			v.ctrl.agomtya := '0'; -- (s105), see (s103) & (s104)
 			v.ctrl.amtypending := '1';
 			v.ctrl.newa := '0';
+			v.ctrl.kp2ld := '0'; -- (s291)
 			-- if routine .aMontyL has been executed as part of a .constMTYL
 			-- routine post-processing, then (s106) has asserted .mtyirq_postponed
 			-- to tell us to generate possible IRQ afterwards
@@ -2903,9 +4337,20 @@ begin
 		v.ctrl.kpdone_d := kpdone;
 		if kpdone = '1' and r.ctrl.kpdone_d = '0' then
 			v.ctrl.kppending := '0';
-			v.ctrl.irqsh(3) := '1';
-			if r.ctrl.irqen = '1' then
-				v.ctrl.irq := '1';
+			if r.jobq.kp = '0' then
+				v.ctrl.irqsh(3) := '1';
+				if r.ctrl.irqen = '1' then
+					v.ctrl.irq := '1';
+				end if;
+			else
+				-- (s300) end of a job of the queue: its result is saved by (s296)
+				-- which also raises the irq, see (s302)
+				v.jobq.kp := '0';
+				v.jobq.save := '1';
+				v.jobq.saddr := (others => '0');
+				v.jobq.swaddr := (others => '0');
+				v.jobq.gapon := '1'; -- see (s301)
+				v.jobq.gapcnt := (others => '0');
 			end if;
 			-- r.ctrl.[kxy]_set are considered stale at the end of a [k]P computation
 			v.ctrl.k_set := '0'; -- see (s114) & (s115)
@@ -2914,6 +4359,9 @@ begin
 			-- authorize SW to read the result
 			v.ctrl.read_forbidden := '0';
 			v.ctrl.tokwasread := '0'; -- (s233), reset of (s232)
+				v.ctrl.doshuffle := r.ctrl.pubsaveshuffle;
+				v.ctrl.zremaskact := r.ctrl.pubsavezremask;
+			end if;
 		end if;
 
 		-- -------------------------
@@ -2925,10 +4373,25 @@ begin
 			v.ctrl.agokp := '0';
 			v.ctrl.kppending := '1';
 			v.ctrl.lockaxi := '0'; -- (s69) deassertion of (s68)
+			v.ctrl.kp2ld := '0'; -- (s291)
 			if debug then -- statically resolved by synthesizer
 				v.debug.trigger := '0';
 				v.debug.counter := (others => '0');
 			end if;
+			-- see (s301)
+			if r.jobq.gapon = '1' then
+				v.jobq.gapon := '0';
+				v.jobq.gap := r.jobq.gapcnt;
+				v.jobq.gapvalid := '1';
+			end if;
+		end if;
+
+		-- (s302) irq generation at the end of a job of the queue, see (s296)
+		if v_jobq_irq then
+			v.ctrl.irqsh(3) := '1';
+			if r.ctrl.irqen = '1' then
+				v.ctrl.irq := '1';
+			end if;
 		end if;
 
 		if debug then -- statically resolved by synthesizer
@@ -2962,6 +4425,10 @@ begin
 			end if;
 			-- authorize SW to read the result
 			v.ctrl.read_forbidden := '0';
+			-- (s277) R1 is left in projective form by a projective point
+			-- operation (unless it turned out null), and is back in affine
+			-- form after any other one (including CTRL_PT_NORM), see (s276)
+			v.ctrl.proj := r.ctrl.popproj and not v.ctrl.r1_is_null;
 		end if;
 		
 		-- --------------------------------------------
@@ -2996,6 +4463,16 @@ begin
 			v.ctrl.dopop := '0';
 			v.ctrl.poppending := '1';
 			v.ctrl.lockaxi := '0'; -- (s90) deassertion of (s89)
+			-- (s291) P1 & P2 stay loaded for a double scalar multiplication
+			-- (see (s290)) as long as no other computation nor any change of
+			-- p or a (see (s8) & (s105)) has been started in-between
+			if r.ctrl.popkp2 = '1' then
+				if r.ctrl.kp2op = ECC_AXI_KP2_LOAD then
+					v.ctrl.kp2ld := '1';
+				end if;
+			else
+				v.ctrl.kp2ld := '0';
+			end if;
 			if debug then -- statically resolved by synthesizer
 				v.debug.trigger := '0';
 				v.debug.counter := (others => '0');
@@ -3056,6 +4533,9 @@ begin
 				dw(STATUS_R0_IS_NULL) := r.ctrl.r0_is_null;
 				dw(STATUS_R1_IS_NULL) := r.ctrl.r1_is_null;
 				dw(STATUS_TOKEN_GEN) := r.ctrl.tokpending or r.ctrl.gentoken;
+				dw(STATUS_PROJ) := r.ctrl.proj;
+				dw(STATUS_MODQ) := r.mc.modq;
+				dw(STATUS_QCTX) := r.mc.qvalid;
 				-- Error bits
 				dw(STATUS_ERR_IN_PT_NOT_ON_CURVE) := aerr_inpt_not_on_curve;
 				dw(STATUS_ERR_OUT_PT_NOT_ON_CURVE) := aerr_outpt_not_on_curve;
@@ -3121,6 +4601,72 @@ begin
 				else
 					dw(CAP_NNDYN) := '0';
 				end if;
+				-- can large numbers be streamed (s265)
+				-- Software is allowed to write (resp. read) all the limbs of a
+				-- large number back-to-back in W_WRITE_DATA (resp. R_READ_DATA)
+				-- without polling the BUSY bit inbetween: each new limb is simply
+				-- held on the AXI bus by the deassertion of WREADY (see (s0),
+				-- (s2), (s172)) or the delayed assertion of RVALID (see (s7))
+				-- until the IP can absorb (resp. produce) it. Errors remain sticky
+				-- in R_STATUS so that software can check them once per number.
+				dw(CAP_STRM) := '1';
+				-- stored base point & [k]G command (s272), see (s266) & (s269)
+				if basepoint then -- statically resolved by synthesizer
+					dw(CAP_BP) := '1';
+				else
+					dw(CAP_BP) := '0';
+				end if;
+				-- projective point operations (s276)
+				if projective then -- statically resolved by synthesizer
+					dw(CAP_PROJ) := '1';
+				else
+					dw(CAP_PROJ) := '0';
+				end if;
+				-- shortcuts for a = 0 & a = -3 (s281)
+				if ashape then -- statically resolved by synthesizer
+					dw(CAP_AFAST) := '1';
+				else
+					dw(CAP_AFAST) := '0';
+				end if;
+				-- field arithmetic operations (s283)
+				if fieldops then -- statically resolved by synthesizer
+					dw(CAP_FOP) := '1';
+				else
+					dw(CAP_FOP) := '0';
+				end if;
+				-- point decompression (s285)
+				if decompress then -- statically resolved by synthesizer
+					dw(CAP_DEC) := '1';
+				else
+					dw(CAP_DEC) := '0';
+				end if;
+				-- contexts of the moduli p & q (s308)
+				if qcontext then -- statically resolved by synthesizer
+					dw(CAP_QCTX) := '1';
+				else
+					dw(CAP_QCTX) := '0';
+				end if;
+				-- double scalar multiplication (s290)
+				if dualkp then -- statically resolved by synthesizer
+					dw(CAP_KP2) := '1';
+				else
+					dw(CAP_KP2) := '0';
+				end if;
+				-- ring of job descriptors in system memory (s289)
+				-- (registers W_DMA_* & R_DMA_* are handled by ecc_dma, they never
+				-- reach ecc_axi)
+				if dma then -- statically resolved by synthesizer
+					dw(CAP_DMA) := '1';
+				else
+					dw(CAP_DMA) := '0';
+				end if;
+				-- resident point slots (s278)
+				if ptslots then -- statically resolved by synthesizer
+					dw(CAP_SLOTS_MSB downto CAP_SLOTS_LSB) := std_logic_vector(
+						to_unsigned(PT_SLOT_SZ, CAP_SLOTS_MSB - CAP_SLOTS_LSB + 1));
+				else
+					dw(CAP_SLOTS_MSB downto CAP_SLOTS_LSB) := (others => '0');
+				end if;
 				-- maximal (or static) value of prime size
 				dw(CAP_NNMAX_MSB downto CAP_NNMAX_LSB) := std_logic_vector(
 					to_unsigned(nn, log2(nn))); -- (s171)
@@ -3157,6 +4703,59 @@ begin
 					resize(r.nndyn.valnn, C_S_AXI_DATA_WIDTH));
 				v.axi.rdatax := dw;
 				v.axi.rvalid := '1'; -- (s5)
+			-- ---------------------------------------
+			-- decoding read of R_JOBQ_STATUS register
+			-- ---------------------------------------
+			elsif s_axi_araddr(ADB + 2 downto 3) = R_JOBQ_STATUS
+			then
+				-- (s305), see (s292) & (s304)
+				-- (without the job queue, see 'jobqueue' in ecc_customize, the
+				-- register reads as 0, field NB telling software there is none)
+				dw := (others => '0');
+				if jobqueue then -- statically resolved by synthesizer
+					dw(JOBQ_STATUS_NB_MSB downto JOBQ_STATUS_NB_LSB) := std_logic_vector(
+						to_unsigned(2**JOBQ_SZ, JOBQ_STATUS_NB_MSB - JOBQ_STATUS_NB_LSB + 1));
+					dw(JOBQ_STATUS_OPEN) := r.jobq.isopen;
+					-- (the scalar of the open entry can only be written once enough
+					-- random is available to mask it, see (s55), the generation of
+					-- the token having just drawn some of it)
+					dw(JOBQ_STATUS_FILL) := r.jobq.tokgen or r.write.jobq or r.read.jobq
+						or (r.jobq.isopen and not r.jobq.kset(v_jobq_t)
+						    and not r.write.rnd.enough_random);
+					if r.jobq.tail(JOBQ_SZ - 1 downto 0) = r.jobq.head(JOBQ_SZ - 1 downto 0)
+						and r.jobq.tail /= r.jobq.head
+					then
+						dw(JOBQ_STATUS_FULL) := '1';
+					end if;
+					dw(JOBQ_STATUS_RES) := r.jobq.res;
+					if r.jobq.done /= r.jobq.head then
+						dw(JOBQ_STATUS_HEAD_DONE) := '1';
+						dw(JOBQ_STATUS_HEAD_NULL) := r.jobq.rnull(v_jobq_h);
+						dw(JOBQ_STATUS_HEAD_ERRIN) := r.jobq.errin(v_jobq_h);
+						dw(JOBQ_STATUS_HEAD_ERROUT) := r.jobq.errout(v_jobq_h);
+					end if;
+					dw(JOBQ_STATUS_QUEUED_MSB downto JOBQ_STATUS_QUEUED_LSB) :=
+						std_logic_vector(resize(r.jobq.tail - r.jobq.done,
+						JOBQ_STATUS_QUEUED_MSB - JOBQ_STATUS_QUEUED_LSB + 1));
+					dw(JOBQ_STATUS_DONE_MSB downto JOBQ_STATUS_DONE_LSB) :=
+						std_logic_vector(resize(r.jobq.done - r.jobq.head,
+						JOBQ_STATUS_DONE_MSB - JOBQ_STATUS_DONE_LSB + 1));
+				end if;
+				v.axi.rdatax := dw;
+				v.axi.rvalid := '1'; -- (s5)
+			-- ------------------------------------
+			-- decoding read of R_JOBQ_GAP register
+			-- ------------------------------------
+			elsif s_axi_araddr(ADB + 2 downto 3) = R_JOBQ_GAP
+			then
+				-- (s306), see (s301)
+				dw := (others => '0');
+				if jobqueue then -- statically resolved by synthesizer
+					dw(JOBQ_GAP_MSB downto JOBQ_GAP_LSB) := std_logic_vector(r.jobq.gap);
+					dw(JOBQ_GAP_VALID) := r.jobq.gapvalid;
+				end if;
+				v.axi.rdatax := dw;
+				v.axi.rvalid := '1'; -- (s5)
 			-- ------------------------------
 			-- below are DEBUG only registers
 			-- ------------------------------
@@ -3506,6 +5105,11 @@ begin
 						v.ctrl.tokwasread := '1'; -- (s232)
 						v.read.token := '0';
 					end if;
+					-- same for the token of the open entry of the job queue
+					if r.read.jobq = '1' and r.read.jobqres = '0' then
+						v.jobq.tokread(v_jobq_t) := '1';
+					end if;
+					v.read.jobq := '0';
 				end if;
 			end if;
 			-- pragma translate_off
@@ -3533,8 +5137,21 @@ begin
 		-- sample of data read back from ecc_fp_dram into r.read.shdataww
 		-- & assertion of r.read.shdatawwcanbeemptied
 		v.read.resh := r.read.fpre & r.read.resh(readlat downto 1);
+		-- (s303) limbs read from the job queue memories (1 cycle of latency)
+		-- are held until they would have been read from ecc_fp_dram
+		if r.read.resh(readlat) = '1' then
+			if r.read.jobqres = '1' then
+				v.jobq.rdata := rs_rdata;
+			else
+				v.jobq.rdata := qb_rdata;
+			end if;
+		end if;
 		if r.read.resh(0) = '1' then
-			v.read.shdataww := xrdata;
+			if r.read.jobq = '1' then
+				v.read.shdataww := r.jobq.rdata;
+			else
+				v.read.shdataww := xrdata;
+			end if;
 			v.read.shdatawwcanbeemptied := '1';
 		end if;
 
@@ -3691,6 +5308,8 @@ begin
 					v.ctrl.p_set_and_mty := '0';
 					v.ctrl.a_set := '0';
 					v.ctrl.a_set_and_mty := '0';
+					v.ctrl.azero := '0'; -- see (s281)
+					v.ctrl.am3 := '0';
 				end if;
 			end if;
 
@@ -4122,6 +5741,8 @@ begin
 			v.read.busy := '0';
 			v.read.trngreading := '0';
 			v.read.token := '0';
+			v.read.jobq := '0';
+			v.read.jobqres := '0';
 			v.ctrl.newp := '0';
 			v.ctrl.newa := '0';
 			v.ctrl.wk := '0';
@@ -4148,6 +5769,14 @@ begin
 			v.ctrl.mtydone_d := '0';
 			v.ctrl.amtydone_d := '0';
 			v.ctrl.dopop := '0';
+			v.ctrl.popproj := '0';
+			v.ctrl.popprojin := '0';
+			v.ctrl.popfp := '0';
+			v.ctrl.decodd := '0';
+			v.ctrl.popkp2 := '0';
+			v.ctrl.kp2op := ECC_AXI_KP2_LOAD;
+			v.ctrl.kp2ld := '0';
+			v.ctrl.proj := '0';
 			v.ctrl.poppending := '0';
 			v.ctrl.ierrid := (others => '0');
 			-- (s240) - blinding config upon reset
@@ -4190,6 +5819,8 @@ begin
 			v.ctrl.p_set_and_mty := '0';
 			v.ctrl.a_set := '0';
 			v.ctrl.a_set_and_mty := '0';
+			v.ctrl.azero := '0';
+			v.ctrl.am3 := '0';
 			v.ctrl.b_set := '0';
 			v.ctrl.q_set := '0';
 			v.ctrl.k_set := '0';
@@ -4246,7 +5877,63 @@ begin
 			v.write.rnd.realign := '0';
 			v.write.active := '0';
 			v.write.busy := '0';
+			v.write.stage := '0';
+			v.write.fpwestg := '0';
 			-- no need to reset r.write.rnd.masklsb nor .firstwwmask
+			-- resident point memory
+			v.bp.capture := '0';
+			v.bp.wslot := (others => '0');
+			v.bp.xvalid := (others => '0');
+			v.bp.yvalid := (others => '0');
+			v.bp.isnull := (others => '0');
+			v.bp.copy := '0';
+			v.bp.kg := '0';
+			v.bp.rvalid := '0';
+			v.bp.gosh := "00";
+			v.bp.save := '0';
+			v.bp.sre := '0';
+			v.bp.ssh := (others => '0');
+			-- no need to reset r.bp.raddr, .rfpaddr, .rslot, .dst, .sslot,
+			-- .saddr nor .swaddr
+			-- job queue
+			v.write.jobq := '0';
+			v.write.fpwejq := '0';
+			v.jobq.head := (others => '0');
+			v.jobq.done := (others => '0');
+			v.jobq.run := (others => '0');
+			v.jobq.tail := (others => '0');
+			v.jobq.isopen := '0';
+			v.jobq.tokgen := '0';
+			v.jobq.twe := '0';
+			v.jobq.kset := (others => '0');
+			v.jobq.xset := (others => '0');
+			v.jobq.yset := (others => '0');
+			v.jobq.tokread := (others => '0');
+			v.jobq.res := '0';
+			v.jobq.copy := '0';
+			v.jobq.rvalid := '0';
+			v.jobq.fpwe := '0';
+			v.jobq.gosh := "00";
+			v.jobq.kp := '0';
+			v.jobq.save := '0';
+			v.jobq.sre := '0';
+			v.jobq.ssh := (others => '0');
+			v.jobq.gapon := '0';
+			v.jobq.gapvalid := '0';
+			-- no need to reset the other fields of r.jobq, they are all
+			-- written before being used
+			-- contexts of the moduli
+			v.mc.modq := '0';
+			v.mc.pvalid := '0';
+			v.mc.qvalid := '0';
+			v.mc.savepending := '0';
+			v.mc.save := '0';
+			v.mc.sre := '0';
+			v.mc.ssh := (others => '0');
+			v.mc.copy := '0';
+			v.mc.rvalid := '0';
+			v.mc.gosh := "00";
+			-- no need to reset r.mc.saddr, .swaddr, .raddr nor .rfpaddr
 			-- dynamic prime size feature
 			if nn_dynamic then
 				-- the idea here is that when nn_dynamic = TRUE, all r.nndyn.xxx
@@ -4390,6 +6077,14 @@ begin
 	k_is_null <= r.ctrl.k_is_null;
 	dopop <= r.ctrl.dopop;
 	popid <= r.ctrl.popid;
+	popproj <= r.ctrl.popproj;
+	popprojin <= r.ctrl.popprojin;
+	popfp <= r.ctrl.popfp;
+	fpopid <= r.ctrl.fpopid;
+	fpmty <= r.ctrl.fpmty;
+	decodd <= r.ctrl.decodd;
+	popkp2 <= r.ctrl.popkp2;
+	kp2op <= r.ctrl.kp2op;
 	ar0zo <= r.ctrl.r0_is_null;
 	ar1zo <= r.ctrl.r1_is_null;
 	aerr_inpt_ack <= r.ctrl.aerr_inpt_ack;
@@ -4404,18 +6099,25 @@ begin
 
 	-- to ecc_curve
 	masklsb <= r.write.rnd.masklsb;
+	azero <= r.ctrl.azero;
+	am3 <= r.ctrl.am3;
 
 	-- to ecc_fp
-	xwe <= r.write.fpwe;
-	xaddr <= r.fpaddr;
+	xwe <= (r.write.fpwe and not r.write.fpwestg and not r.write.fpwejq) -- (s288)
+	       or r.jobq.fpwe; -- (s297)
+	xaddr <= r.jobq.xaddr when (r.jobq.fpwe or r.jobq.sre) = '1' else r.fpaddr;
 	-- if writing into ecc_fp_dram using the debug interface was not
 	-- a debug feature, we could set a multicycle constraint on
 	-- path dbghalted -> xwdata (but it is a debug feature so perf
 	-- is not really an issue)
 	xwdata <= r.debug.fpwdata when (debug and dbghalted = '1' and
 						                      r.debug.shwon(0) = '1')
+	          else r.jobq.fpwdata when r.jobq.fpwe = '1'
 	          else r.write.fpwdata;
-	xre <= r.read.fpre;
+	xre <= (r.read.fpre and not r.read.jobq) -- (s303)
+	       or r.bp.sre -- (s280), see (s279)
+	       or r.mc.sre -- see (s310)
+	       or r.jobq.sre; -- (s296)
 
 	-- to external AXI interface
 	s_axi_awready <= r.axi.awready;
@@ -4432,6 +6134,135 @@ begin
 
 	-- to mm_ndsp's
 	pen <= r.ctrl.pen; -- (s9)
+	mbank <= r.mc.modq; -- (s308)
+
+	-- -----------------------------------------------------------
+	-- resident point memory (2**PT_SLOT_SZ slots of 2 x n limbs: x followed
+	-- by y, slot 0 being the base point of [k]G commands)
+	-- -----------------------------------------------------------
+	-- (s267) absorbs the writes into XR1 & YR1 made with CTRL_WRITE_BP, see
+	-- (s266), or the limbs of R1 read back by a slot save, see (s279)
+	bp_we <= (r.write.fpwe and r.bp.capture) or r.bp.ssh(0);
+	bp_waddr <= r.bp.sslot & r.bp.swaddr when r.bp.ssh(0) = '1'
+	            else r.bp.wslot & r.fpaddr(FP_ADDR_LSB downto 0);
+	bp_wdata <= xrdata when r.bp.ssh(0) = '1' else r.write.fpwdata;
+
+	bp0: syncram_sdp
+		generic map(
+			rdlat => 1, datawidth => ww,
+			datadepth => 2**(PT_SLOT_SZ + FP_ADDR_LSB + 1))
+		port map(
+			clk => s_axi_aclk,
+			-- port A (W only)
+			addra => bp_waddr,
+			wea => bp_we,
+			dia => bp_wdata,
+			-- port B (R only)
+			addrb => r.bp.rslot & r.bp.raddr,
+			reb => r.bp.copy,
+			dob => bp_rdata -- pushed into ecc_fp_dram by (s270)
+		);
+
+	-- -----------------------------------------------------------
+	-- job queue memories (2**JOBQ_SZ entries, see (s292))
+	-- -----------------------------------------------------------
+	-- (the memories are only inferred if the job queue was asked for in
+	-- ecc_customize, see 'jobqueue')
+	jq0: if jobqueue generate -- statically resolved by synthesizer
+		-- Bank of the inputs: 8 pages of n limbs per entry (scalar & its
+		-- mask(s), x & y, token), see jobq_page(). Absorbs the writes redirec-
+		-- ted to the open entry by (s293), the token generated by (s298), and
+		-- is read by the token reads of (s294) & by the copy of (s295)
+		qb_we <= (r.write.fpwe and r.write.fpwejq) or r.jobq.twe;
+		qb_waddr <= std_logic_vector(r.jobq.tail(JOBQ_SZ - 1 downto 0))
+		              & JOBQ_PG_TOK & std_logic_vector(r.jobq.twaddr)
+		            when r.jobq.twe = '1'
+		            else std_logic_vector(r.jobq.tail(JOBQ_SZ - 1 downto 0))
+		              & jobq_page(r.fpaddr(FP_ADDR - 1 downto FP_ADDR_LSB))
+		              & r.fpaddr(FP_ADDR_LSB - 1 downto 0);
+		qb_wdata <= r.jobq.twdata when r.jobq.twe = '1' else r.write.fpwdata;
+		qb_raddr <= std_logic_vector(r.jobq.tail(JOBQ_SZ - 1 downto 0))
+		              & JOBQ_PG_TOK & r.fpaddr(FP_ADDR_LSB - 1 downto 0)
+		            when (r.read.fpre and r.read.jobq and not r.read.jobqres) = '1'
+		            else std_logic_vector(r.jobq.run(JOBQ_SZ - 1 downto 0))
+		              & r.jobq.page & std_logic_vector(r.jobq.raddr);
+
+		jobq0: syncram_sdp
+			generic map(
+				rdlat => 1, datawidth => ww,
+				datadepth => 2**(JOBQ_SZ + 3 + FP_ADDR_LSB))
+			port map(
+				clk => s_axi_aclk,
+				-- port A (W only)
+				addra => qb_waddr,
+				wea => qb_we,
+				dia => qb_wdata,
+				-- port B (R only)
+				addrb => qb_raddr,
+				reb => '1',
+				dob => qb_rdata
+			);
+
+		-- Bank of the results: 2 x n limbs per entry (x followed by y), saved
+		-- from XR1 & YR1 by (s296) & read back by (s294)
+		rs_we <= r.jobq.ssh(0);
+		rs_waddr <= std_logic_vector(r.jobq.done(JOBQ_SZ - 1 downto 0))
+		              & std_logic_vector(r.jobq.swaddr);
+		rs_raddr <= std_logic_vector(r.jobq.head(JOBQ_SZ - 1 downto 0))
+		              & r.fpaddr(FP_ADDR_LSB downto 0);
+
+		jobq1: syncram_sdp
+			generic map(
+				rdlat => 1, datawidth => ww,
+				datadepth => 2**(JOBQ_SZ + FP_ADDR_LSB + 1))
+			port map(
+				clk => s_axi_aclk,
+				-- port A (W only)
+				addra => rs_waddr,
+				wea => rs_we,
+				dia => xrdata,
+				-- port B (R only)
+				addrb => rs_raddr,
+				reb => '1',
+				dob => rs_rdata
+			);
+	end generate;
+
+	jq1: if not jobqueue generate -- statically resolved by synthesizer
+		qb_rdata <= (others => '0');
+		rs_rdata <= (others => '0');
+	end generate;
+
+	-- -----------------------------------------------------------
+	-- memory of the contexts of the moduli (2 contexts of 4 x n limbs:
+	-- the modulus, R2modp, twop & Rmodp, see (s308))
+	-- -----------------------------------------------------------
+	-- (only inferred if 'qcontext' is set in ecc_customize)
+	mc0: if qcontext generate -- statically resolved by synthesizer
+		-- absorbs the limbs read back by (s310), read by (s312)
+		mc_we <= r.mc.ssh(0);
+		mc_waddr <= r.mc.modq & r.mc.swaddr;
+
+		mc1: syncram_sdp
+			generic map(
+				rdlat => 1, datawidth => ww,
+				datadepth => 2**(FP_ADDR_LSB + 3))
+			port map(
+				clk => s_axi_aclk,
+				-- port A (W only)
+				addra => mc_waddr,
+				wea => mc_we,
+				dia => xrdata,
+				-- port B (R only)
+				addrb => r.mc.modq & r.mc.raddr,
+				reb => r.mc.copy,
+				dob => mc_rdata -- pushed into ecc_fp_dram by (s312)
+			);
+	end generate;
+
+	mc2: if not qcontext generate -- statically resolved by synthesizer
+		mc_rdata <= (others => '0');
+	end generate;
 
 	n0: if nn_dynamic generate -- statically resolved by synthesizer
 		nndyn_mask <= r.nndyn.mask;
@@ -4461,7 +6292,8 @@ begin
 		nndyn_wmin <= nndyn_wmin_s;
 		nndyn_wmin_excp_val <= resize(r.nndyn.brlwmin, log2(2*w - 1));
 		nndyn_wmin_excp <= r.nndyn.exception;
-		nndyn_nnrnd_mask <= r.nndyn.nnrnd_mask;
+		nndyn_nnrnd_mask_s <= r.nndyn.nnrnd_mask;
+		nndyn_nnrnd_mask <= nndyn_nnrnd_mask_s;
 		nndyn_nnrnd_zerowm1_s <=
 			'1' when r.nndyn.valw /= r.nndyn.valw3
 			else '0';
@@ -4507,11 +6339,13 @@ begin
 		nndyn_wmin_excp <= '1'
 			when ( (div(w, ndsp) - 1) * ndsp ) > ( (nn + 2) / ww )
 			else '0';
-		nndyn_nnrnd_mask <= std_logic_vector (
+		nndyn_nnrnd_mask_s <= std_logic_vector (
 			resize(unsigned(to_signed(-1, nn mod ww)), ww) );
-		nndyn_nnrnd_zerowm1 <=
+		nndyn_nnrnd_mask <= nndyn_nnrnd_mask_s;
+		nndyn_nnrnd_zerowm1_s <=
 			'1' when ((nn + 4) mod ww) /= (nn mod ww)
 			else '0';
+		nndyn_nnrnd_zerowm1 <= nndyn_nnrnd_zerowm1_s;
 		nndyn_nnp1_s <= to_unsigned(nn + 1, log2(nn + 1));
 		nndyn_nnp1 <= nndyn_nnp1_s;
 		nndyn_nnm3_s <= to_unsigned(nn - 3, log2(nn));
@@ -4520,9 +6354,12 @@ begin
 
 	-- general busy signal
 	kppending <= r.ctrl.kppending;
+	kpjob <= r.ctrl.agokp or r.ctrl.kppending
+		or (r.bp.kg and (r.bp.copy or r.bp.gosh(0) or r.bp.gosh(1)))
+		or r.jobq.copy or r.jobq.gosh(0) or r.jobq.gosh(1); -- (s295)
 
 	-- interface with ecc_trng
-	trngrdy <= r.write.rnd.trngrdy;
+	trngrdy <= r.write.rnd.trngrdy or r.jobq.tokgen; -- (s299)
 
 	-- debug features (to ecc_curve_iram)
 	dbgiwaddr <= r.debug.iwaddr;
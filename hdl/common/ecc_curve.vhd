@@ -34,6 +34,8 @@ entity ecc_curve is
 		-- interface with ecc_axi
 		masklsb : in std_logic;
 		doblinding : in std_logic;
+		azero : in std_logic;
+		am3 : in std_logic;
 		-- interface with ecc_scalar
 		frdy  : out std_logic;
 		fgo   : in  std_logic;
@@ -200,6 +202,7 @@ architecture rtl of ecc_curve is
 		rndsh : std_logic;
 		rndshf : std_logic;
 		ssrl_sh : std_logic;
+		fpm : std_logic;
 	end record;
 
 	type decode_branch_reg_type is record
@@ -210,6 +213,7 @@ architecture rtl of ecc_curve is
 		call : std_logic;
 		callsn : std_logic;
 		ret : std_logic;
+		ash : std_logic;
 		imma : std_logic_vector(IRAM_ADDR_SZ - 1 downto 0);
 	end record;
 
@@ -408,8 +412,8 @@ begin
 	comb : process(r, rstn, masklsb, initkp, laststep, fgo, faddr, irdata,
 	               trng_data, trng_valid,
 	               iterate_shuffle_valid, iterate_shuffle_force, dbghalt,
-	               doblinding, opo, dbgbreakpoints, dbgpgmstate, dbgnbbits,
-	               dbgnbopcodes, dbgdosomeopcodes, dbgresume, dbgnoxyshuf,
+	               doblinding, azero, am3, opo, dbgbreakpoints, dbgpgmstate,
+	               dbgnbbits, dbgnbopcodes, dbgdosomeopcodes, dbgresume, dbgnoxyshuf,
 	               swrst, zu, zc, r0z, r1z, ptadd,
 	               pts_are_equal, pts_are_oppos, first3pz, firstzaddu, firstzdbl)
 		variable v : reg_type;
@@ -744,6 +748,7 @@ begin
 				v.decode.b.b := '0'; v.decode.b.z := '0'; v.decode.b.sn := '0';
 				v.decode.b.odd := '0'; v.decode.b.ret := '0';
 				v.decode.b.call := '0'; v.decode.b.callsn :='0';
+				v.decode.b.ash := '0';
 				v.decode.a.add := '0'; v.decode.a.sub := '0';
 				v.decode.a.ssrl := '0'; v.decode.a.ssrl_sh := '0';
 				v.decode.a.ssll := '0'; v.decode.a.xxor := '0';
@@ -751,6 +756,7 @@ begin
 				v.decode.a.tpar := '0'; v.decode.a.tparsh := '0';
 				v.decode.a.rnd := '0'; v.decode.a.rndm := '0';
 				v.decode.a.rndsh := '0'; v.decode.a.rndshf := '0';
+				v.decode.a.fpm := '0';
 				-- decode the type of operation
 				if r.decode.c.optype = OPCODE_NOP then
 					-- ----------------------
@@ -796,7 +802,7 @@ begin
 					v.decode.a.ssrl := '0'; v.decode.a.ssll := '0';
 					v.decode.a.xxor := '0'; v.decode.a.rnd := '0';
 					v.decode.a.redc := '0'; v.decode.a.tpar := '0';
-					v.decode.a.div2 := '0';
+					v.decode.a.div2 := '0'; v.decode.a.fpm := '0';
 
 					if r.decode.c.opcode = OPCODE_ARITH_ADD then
 						v.decode.a.add := '1';
@@ -832,13 +838,28 @@ begin
 						v.decode.a.rnd := '1';
 						v.decode.a.rndsh := '1';
 						v.decode.a.rndshf := '1';
+					elsif fpaddsub and r.decode.c.opcode = OPCODE_ARITH_FPM then
+						-- (s119) FPADD (X bit set) or FPSUB (X bit clear): the
+						-- opcode is handed to ecc_fp as a plain addition (resp.
+						-- subtraction) with the 'fpm' flag set, ecc_fp then chains
+						-- the modular correction by itself. The X bit was only used
+						-- to tell FPADD from FPSUB so it must not reach ecc_fp
+						-- (the opcode is only decoded if 'fpaddsub' is set, see
+						-- ecc_customize, otherwise the assembler does not use it)
+						v.decode.a.fpm := '1';
+						if r.decode.c.extended = '1' then
+							v.decode.a.add := '1';
+						else
+							v.decode.a.sub := '1';
+						end if;
+						v.decode.c.extended := '0';
 					else
 						v.err_flags(ERR_INVALID_OPCODE) := '1';
 						v.decode.state := errorr; -- 'error' is a VHDL reserved word
 					end if;
 					-- (note: no need to decode the 'extended' bit (bit 24 of the
 					-- opcode) as it directly drives the 'extended' output (see
-					-- (s1) below))
+					-- (s1) below), except for FPADD/FPSUB, see (s119))
 
 					-- is there a patch needed?
 					v.decode.patch.p := '0';
@@ -2343,6 +2364,7 @@ begin
 					v.decode.b.b := '0'; v.decode.b.z := '0'; v.decode.b.sn := '0';
 					v.decode.b.odd := '0'; v.decode.b.ret := '0';
 					v.decode.b.call := '0'; v.decode.b.callsn :='0';
+					v.decode.b.ash := '0';
 					if r.decode.c.opcode = OPCODE_BRA_B then v.decode.b.b := '1';
 					elsif r.decode.c.opcode = OPCODE_BRA_BZ then v.decode.b.z := '1';
 					elsif r.decode.c.opcode = OPCODE_BRA_BSN then v.decode.b.sn := '1';
@@ -2350,6 +2372,7 @@ begin
 					elsif r.decode.c.opcode = OPCODE_BRA_CALL then v.decode.b.call := '1';
 					elsif r.decode.c.opcode = OPCODE_BRA_CALLSN then v.decode.b.callsn := '1';
 					elsif r.decode.c.opcode = OPCODE_BRA_RET then v.decode.b.ret := '1';
+					elsif r.decode.c.opcode = OPCODE_BRA_BAS then v.decode.b.ash := '1';
 					else
 						v.err_flags(ERR_INVALID_OPCODE) := '1';
 						v.decode.state := errorr;
@@ -2670,6 +2693,11 @@ begin
 					v.ctrl.ret := std_logic_vector(unsigned(r.decode.pc) + 1);
 				elsif r.decode.b.ret = '1' then
 					vdobranch := TRUE;
+				-- (s120) branch on the shape of curve parameter 'a' (static for
+				-- a given curve, hence no need for a flag computed by a previous
+				-- opcode), the target address being set by (s10) below
+				elsif r.decode.b.ash = '1' and (azero = '1' or am3 = '1') then
+					vdobranch := TRUE;
 				end if;
 				if vdobranch then
 					v.fetch.ramresh :=
@@ -2685,6 +2713,9 @@ begin
 					v.fetch.valid := '0'; -- (s16) bypass of (s14)
 					if r.decode.b.ret = '1' then
 						v.fetch.pc := r.ctrl.ret; -- (s28)
+					elsif r.decode.b.ash = '1' and am3 = '1' then
+						-- a = -3 lands one opcode after the a = 0 target, see (s120)
+						v.fetch.pc := std_logic_vector(unsigned(r.decode.b.imma) + 1);
 					else
 						v.fetch.pc := r.decode.b.imma; -- (s10)
 					end if;
@@ -3220,6 +3251,7 @@ begin
 	opi.sh <= r.decode.a.rndsh;
 	opi.shf <= r.decode.a.rndshf;
 	opi.ssrl_sh <= r.decode.a.ssrl_sh;
+	opi.fpm <= r.decode.a.fpm;
 	opi.valid <= r.decode.valid; -- (s3)
 	--   to mm_ndsp(s)
 	ppen <= r.decode.a.redcm;
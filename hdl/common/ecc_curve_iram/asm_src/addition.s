@@ -76,3 +76,54 @@
 	NNMOV	XR1bk		XR0
 	NNMOV	YR1bk		YR0
 	STOP
+
+#####################################################################
+#          P R O J E C T I V E   P O I N T   A D D I T I O N
+#####################################################################
+# (only assembled if parameter 'projective' is set in ecc_customize)
+.if projective
+.addition_proj_affL:
+.addition_proj_affL_export:
+# ******************************************************************
+# same as .addition_projL below, except that R1 is first given in
+# affine form, hence needs to be entered in Montgomery domain with
+# ZR01 = 1 (this starts a new chain of projective operations)
+# ******************************************************************
+	JL	.proj_enterL
+.addition_projL:
+.addition_projL_export:
+# ******************************************************************
+# compute R1 <- R0 + R1
+# R0 IS GIVEN IN AFFINE FORM, R1 IS GIVEN IN PROJECTIVE FORM (Co-Z
+# Jacobian coordinates XR1, YR1 & ZR01, in Montgomery domain), e.g as
+# left by a previous projective point addition or doubling
+# result is available in R1, also in projective form (no inversion)
+# ******************************************************************
+	BARRIER
+# back-up R0 coordinates
+	NNMOV	XR0		XR0bk
+	NNMOV	YR0		YR0bk
+# enter XR0 & YR0 in Montgomery domain and bring R0 to the same Z
+# as R1: XR0 <- XR0.ZR01^2, YR0 <- YR0.ZR01^3 (invsq & invcu are
+# only used here as temporaries)
+	FPREDC	XR0bk	R2modp	XR0
+	FPREDC	YR0bk	R2modp	YR0
+	FPREDC	ZR01	ZR01	invsq
+	BARRIER
+	FPREDC	XR0	invsq	XR0
+	FPREDC	invsq	ZR01	invcu
+	BARRIER
+	FPREDC	YR0	invcu	YR0
+	BARRIER
+# this call won't return
+	J	.pre_zadduL
+
+.addition_proj_endL:
+.addition_proj_endL_export:
+# back from .zadduL (or .zdbl_swL) routine, XR1, YR1 & ZR01 are left
+# untouched (no inversion), just restore R0
+	BARRIER
+	NNMOV	XR0bk		XR0
+	NNMOV	YR0bk		YR0
+	STOP
+.endif
@@ -13,36 +13,66 @@
 #    C O N S T A N T   T I M E   M O D U L A R   I N V E R S I O N
 #               U S I N G   x ^ - 1 = x ^ (p - 2)
 #         ( J O Y E   D O U B L E - A N D - A D D   L O O P )
+#
+# Right-to-left: the squaring r1 <- r1 * r1 of each bit and the product
+# r0 <- r0 * r1 run on the two Montgomery multipliers at the same time,
+# so the critical path is one multiplication per bit of p - 2. With
+# nbmult = 2 this beats a left-to-right window chain, whose squarings &
+# products all depend on each other (timing model of ipecc_assembler.py
+# -c, cycles for p - 2 of P-256 / P-521):
+#
+#                             nbmult = 2           nbmult = 1
+#    this loop             111240 / 568561     155340 / 1044085
+#    4-bit window chain    119630 / 664309     119630 /  664309
+#
+# (the window chain being counted without any loop overhead). With a
+# single multiplier though, the window chain would be faster.
+#
+# Note: this is still the plain square-and-multiply loop, with only its
+# loop control rescheduled. Neither a window exponentiation nor a
+# safegcd (divstep) inversion is implemented, and the figures above come
+# from the model, not from a simulation.
 #####################################################################
 .modinvL:
 .modinvL_export:
 	BARRIER
 	NNADD	one	one	two
 	NNSUB	p	two	pmtwo
-	NNMOV	one		r0
-# shift r0 (= 1) into Montgomery domain
-	FPREDC	r0	R2modp	r0
-	BARRIER
 # dx is assumed to be in the Montgomery domain already!
-	NNMOV	dx		r1
+# p - 2 is odd, so the first iteration of the loop boils down to
+# r0 <- dx & r1 <- dx * dx (this saves from having to shift 1 into
+# the Montgomery domain)
+	NNSRL	pmtwo		pmtwo
+	NNMOV	dx		r0
+	FPREDC	dx	dx	r1
+# In the loop below, the bit of p - 2 that is to be processed and the
+# shift of pmtwo are handled while the Montgomery multiplications of
+# the previous iteration are still running: the barrier is only set
+# on the first opcode that needs their result (the branch which is
+# followed by the multiplications of the current iteration)
 .loopbeginL:
 	TESTPAR	pmtwo		%par
+	NNSRL	pmtwo		pmtwo
+	BARRIER
 	Jodd	.pm2bitis1L
-	J	.pm2bitis0L
-.pm2bitis1L:
 # *****************************************************************
-# compute r0 <- r0 * r1
+# bit is 0 (can't be the last one as the MSbit of p - 2 is set):
+# only compute r1 <- r1 * r1
 # *****************************************************************
-	FPREDC	r0	r1	r0
-.pm2bitis0L:
+	FPREDC	r1	r1	r1
+	J	.loopbeginL
+.pm2bitis1L:
 # *****************************************************************
-# always compute r1 <- r1 * r1
+# bit is 1: compute r0 <- r0 * r1 and, unless it is the last bit
+# (in which case pmtwo is now 0 & the Z flag, which was set by the
+# NNSRL above, is still valid as FPREDC does not update it), compute
+# r1 <- r1 * r1
 # *****************************************************************
-	FPREDC	r1	r1	r1
-	BARRIER
-	NNSRL	pmtwo		pmtwo
+	FPREDC	r0	r1	r0
 	Jz	.modinvendL
+	FPREDC	r1	r1	r1
 	J	.loopbeginL
 .modinvendL:
+	BARRIER
 	NNMOV	r0		inverse
 	RET
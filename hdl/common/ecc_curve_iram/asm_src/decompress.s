@@ -0,0 +1,96 @@
+#
+# Copyright (C) 2023 - This file is part of IPECC project
+#
+# Authors:
+#     Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+#     Ryad BENADJILA <ryadbenadjila@gmail.com>
+#
+# Contributors:
+#     Adrian THILLARD
+#     Emmanuel PROUFF
+
+#####################################################################
+#             P O I N T   D E C O M P R E S S I O N
+#####################################################################
+
+# ******************************************************************
+# compute YR1 <- sqrt(XR1^3 + a.XR1 + b) mod p, the square root being
+# chosen even (.decompress_evenL) or odd (.decompress_oddL)
+# XR1 & YR1 are in natural form, YR1 in [0, p[.
+# The square root is obtained as y = rhs ^ ((p + 1) / 4) which only
+# holds for p = 3 mod 4 (software is in charge of not calling these
+# routines otherwise). The result is then squared back and compared
+# with rhs: the routines end with the Z flag set iff rhs actually is
+# a square mod p (i.e iff (XR1, YR1) is a point on the curve).
+# The parity asked for is kept in ypar, as .dodecompressL can't be
+# called with JL (it calls .fp_powL itself, and there is only one
+# return address).
+# (only assembled if parameter 'decompress' is set in ecc_customize)
+# ******************************************************************
+.if decompress
+.decompress_evenL:
+.decompress_evenL_export:
+	BARRIER
+	NNCLR	ypar
+	J	.dodecompressL
+
+.decompress_oddL:
+.decompress_oddL_export:
+	BARRIER
+	NNMOV	one		ypar
+	J	.dodecompressL
+
+.decompress_parL:
+# back from .dodecompressL, YR1 has the wrong parity iff the lsb of
+# YR1 xor ypar is set
+	NNXOR	YR1	ypar	red
+	TESTPAR	red		%par
+	BARRIER
+	Jodd	.decompress_negL
+	J	.decompress_chkL
+
+.decompress_negL:
+# YR1 <- p - YR1 (brought back to 0 if YR1 was 0)
+	NNSUB	p	YR1	YR1
+	NNSUB	YR1	p	red
+	NNADD,p4	red	patchme	YR1
+.decompress_chkL:
+	NNSUB	XX	right	mustbezero
+	BARRIER
+	NOP
+	STOP
+
+.dodecompressL:
+# right <- (XR1^3 + a.XR1 + b).R mod p (a is stored in Montgomery form)
+	FPREDC	XR1	R2modp	dx
+	BARRIER
+	FPREDC	dx	dx	XX
+	FPREDC	a	dx	aX
+	FPREDC	b	R2modp	left
+	BARRIER
+	FPREDC	XX	dx	XXX
+	NNADD	aX	left	right
+	NNSUB	right	twop	red
+	NNADD,p5	red	patchme	right
+	BARRIER
+	NNADD	right	XXX	right
+	NNSUB	right	twop	red
+	NNADD,p5	red	patchme	right
+# r0 <- right ^ ((p + 1) / 4) = y.R
+	NNMOV	right		r1
+	NNADD	p	one	pmtwo
+	NNSRL	pmtwo		pmtwo
+	NNSRL	pmtwo		pmtwo
+	JL	.fp_powL
+	BARRIER
+	FPREDC	r0	r0	XX
+	FPREDC	r0	one	YR1
+	BARRIER
+	NNSUB	XX	p	red
+	NNADD,p4	red	patchme	XX
+	NNSUB	right	p	red
+	NNADD,p4	red	patchme	right
+	NNSUB	YR1	p	red
+	NNADD,p4	red	patchme	YR1
+	J	.decompress_parL
+.endif
@@ -53,3 +53,44 @@
 	NNMOV	XR0bk		XR0
 	NNMOV	YR0bk		YR0
 	STOP
+
+#####################################################################
+#          P R O J E C T I V E   P O I N T   D O U B L I N G
+#####################################################################
+# (only assembled if parameter 'projective' is set in ecc_customize)
+.if projective
+.double_proj_affL:
+.double_proj_affL_export:
+# ******************************************************************
+# same as .double_projL below, except that R1 is first given in
+# affine form, hence needs to be entered in Montgomery domain with
+# ZR01 = 1 (this starts a new chain of projective operations)
+# ******************************************************************
+	JL	.proj_enterL
+.double_projL:
+.double_projL_export:
+# ******************************************************************
+# compute R1 <- [2]R1
+# R1 IS GIVEN IN PROJECTIVE FORM (Jacobian coordinates XR1, YR1 & ZR01,
+# in Montgomery domain) and the result is left in the same form
+# (as opposed to .doubleL, the point doubled here is R1, not R0)
+# ******************************************************************
+	BARRIER
+# back-up R0 coordinates, then copy R1 into R0 so that .dozdblL finds
+# the point to double in both R0 & R1 (as it does from .doubleL)
+	NNMOV	XR0		XR0bk
+	NNMOV	YR0		YR0bk
+	BARRIER
+	NNMOV	XR1		XR0
+	NNMOV	YR1		YR0
+	BARRIER
+	JL	.dozdblL
+# back from .dozdblL routine, [2]R1 is in R0 and shares ZR01 with R1
+	BARRIER
+	NNMOV	XR0		XR1
+	NNMOV	YR0		YR1
+# restore R0 coordinates
+	NNMOV	XR0bk		XR0
+	NNMOV	YR0bk		YR0
+	STOP
+.endif
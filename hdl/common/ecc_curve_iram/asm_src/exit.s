@@ -93,3 +93,32 @@
 	NNSUB	YR1	p	red
 	NNADD,p4	red	patchme	YR1
 	RET
+# (only assembled if parameter 'projective' is set in ecc_customize)
+.if projective
+.proj_enterL:
+# ****************************************************************
+# enter affine point R1 in Montgomery domain, with ZR01 = 1
+# (used by the projective point operations)
+# ****************************************************************
+	BARRIER
+	FPREDC	XR1	R2modp	XR1
+	FPREDC	YR1	R2modp	YR1
+	FPREDC	one	R2modp	ZR01
+	BARRIER
+	RET
+.proj_normL:
+.proj_normL_export:
+# ****************************************************************
+# convert point R1, left in projective form (Jacobian coordinates,
+# Montgomery domain) by a chain of projective point operations,
+# back to affine form - this is the only inversion of the chain
+# ****************************************************************
+	BARRIER
+	NNMOV	ZR01		dx
+	JL	.modinvL
+	BARRIER
+	JL	.normalizeL
+	BARRIER
+	JL	.exitMontyL
+	STOP
+.endif
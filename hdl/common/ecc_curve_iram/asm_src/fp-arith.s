@@ -0,0 +1,170 @@
+#
+# Copyright (C) 2023 - This file is part of IPECC project
+#
+# Authors:
+#     Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+#     Ryad BENADJILA <ryadbenadjila@gmail.com>
+#
+# Contributors:
+#     Adrian THILLARD
+#     Emmanuel PROUFF
+
+#####################################################################
+#         F I E L D   A R I T H M E T I C   O P E R A T I O N S
+#####################################################################
+# ******************************************************************
+# compute XR1 <- XR0 op YR0 mod p (or XR1 <- 1 / XR0 mod p, XR1 <-
+# XR0 ^ YR0 mod p, etc)
+# Operands are given in natural (non Montgomery) form and in [0, p[,
+# result is also in natural form and in [0, p[. Routines with a name
+# ending in 'm' (.fp_mulmL, etc) instead take XR0 & YR0 and return XR1
+# in Montgomery form (except the exponent YR0 of .fp_expmL), which
+# spares the conversions when software chains several operations.
+# Additions & subtractions are the same in both forms.
+# Here 'p' is whatever modulus software wrote in place of the prime
+# of the curve (e.g the order q of the curve), along with which the
+# Montgomery constants (R2modp, twop) were computed.
+# (only assembled if parameter 'fieldops' is set in ecc_customize)
+# ******************************************************************
+.if fieldops
+.fp_addL:
+.fp_addL_export:
+	BARRIER
+	FPADD	XR0	YR0	XR1
+	J	.fp_reduceL
+
+.fp_subL:
+.fp_subL_export:
+	BARRIER
+	FPSUB	XR0	YR0	XR1
+	J	.fp_reduceL
+
+.fp_mulL:
+.fp_mulL_export:
+	BARRIER
+# XR1 <- XR0 * YR0 / R, then multiplying by R^2 / R brings it back
+# into natural form
+	FPREDC	XR0	YR0	XR1
+	BARRIER
+	FPREDC	XR1	R2modp	XR1
+	J	.fp_reduceL
+
+.fp_invL:
+.fp_invL_export:
+	BARRIER
+# .modinvL expects its input in the Montgomery domain
+	FPREDC	XR0	R2modp	dx
+	BARRIER
+	JL	.modinvL
+# leave Montgomery domain
+	BARRIER
+	FPREDC	inverse	one	XR1
+	J	.fp_reduceL
+
+.fp_invmL:
+.fp_invmL_export:
+	BARRIER
+	NNMOV	XR0		dx
+	JL	.modinvL
+	BARRIER
+	NNMOV	inverse		XR1
+	J	.fp_reduceL
+
+.fp_mulmL:
+.fp_mulmL_export:
+	BARRIER
+	FPREDC	XR0	YR0	XR1
+	J	.fp_reduceL
+
+.fp_sqrL:
+.fp_sqrL_export:
+	BARRIER
+	FPREDC	XR0	XR0	XR1
+	BARRIER
+	FPREDC	XR1	R2modp	XR1
+	J	.fp_reduceL
+
+.fp_sqrmL:
+.fp_sqrmL_export:
+	BARRIER
+	FPREDC	XR0	XR0	XR1
+	J	.fp_reduceL
+
+# XR1 <- XR0 . R mod p (enter Montgomery form)
+.fp_mtyL:
+.fp_mtyL_export:
+	BARRIER
+	FPREDC	XR0	R2modp	XR1
+	J	.fp_reduceL
+
+# XR1 <- XR0 / R mod p (leave Montgomery form)
+.fp_nomtyL:
+.fp_nomtyL_export:
+	BARRIER
+	FPREDC	XR0	one	XR1
+	J	.fp_reduceL
+
+.fp_expL:
+.fp_expL_export:
+	BARRIER
+	FPREDC	XR0	R2modp	r1
+	NNMOV	YR0		pmtwo
+	JL	.fp_powL
+	BARRIER
+	FPREDC	r0	one	XR1
+	J	.fp_reduceL
+
+.fp_expmL:
+.fp_expmL_export:
+	BARRIER
+	NNMOV	XR0		r1
+	NNMOV	YR0		pmtwo
+	JL	.fp_powL
+	BARRIER
+	NNMOV	r0		XR1
+	J	.fp_reduceL
+.endif
+
+# ******************************************************************
+# r0 <- r1 ^ pmtwo mod p (r0 & r1 in Montgomery form)
+# Right-to-left square-and-multiply, processing the bits of the
+# exponent the same way .modinvL does (pmtwo is consumed). It is NOT
+# constant time with respect to the exponent, which is hence assumed
+# public.
+# (only assembled if parameter 'fieldops' or 'decompress' is set in
+# ecc_customize)
+# ******************************************************************
+.if fieldops decompress
+.fp_powL:
+	FPREDC	one	R2modp	r0
+.fp_powloopL:
+	TESTPAR	pmtwo		%par
+	NNSRL	pmtwo		pmtwo
+	BARRIER
+	Jodd	.fp_powbitis1L
+# *****************************************************************
+# bit is 0: stop if it was the last one (pmtwo is now 0 & the Z flag
+# set by the NNSRL above is still valid as Jodd does not update it),
+# otherwise compute r1 <- r1 * r1
+# *****************************************************************
+	Jz	.fp_powendL
+	FPREDC	r1	r1	r1
+	J	.fp_powloopL
+.fp_powbitis1L:
+	FPREDC	r0	r1	r0
+	Jz	.fp_powendL
+	FPREDC	r1	r1	r1
+	J	.fp_powloopL
+.fp_powendL:
+	BARRIER
+	RET
+.endif
+
+.if fieldops
+.fp_reduceL:
+# result is in [0, 2p[, bring it in [0, p[
+	BARRIER
+	NNSUB	XR1	p	red
+	NNADD,p4	red	patchme	XR1
+	STOP
+.endif
@@ -0,0 +1,252 @@
+#
+# Copyright (C) 2023 - This file is part of IPECC project
+#
+# Authors:
+#     Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+#     Ryad BENADJILA <ryadbenadjila@gmail.com>
+#
+# Contributors:
+#     Adrian THILLARD
+#     Emmanuel PROUFF
+
+#####################################################################
+#        D O U B L E   S C A L A R   M U L T I P L I C A T I O N
+#                 [k1]P1 + [k2]P2   ( S H A M I R )
+#####################################################################
+
+# ******************************************************************
+# Both scalars are public (e.g signature verification): the loop
+# below is NOT constant time and none of the countermeasures of the
+# [k]P ladder is applied.
+#
+# .kp2_loadL stores P1 = R0 & P2 = R1 (affine, natural form) in the
+# Montgomery domain, in XP1, YP1, XP2 & YP2, which no other routine of
+# the double scalar multiplication clobbers (several [k1]P1 + [k2]P2
+# can hence be computed on the same pair of points).
+#
+# .kp2_p1L, .kp2_p2L & .kp2_p12L then compute R1 <- [k1]P1 + [k2]P2
+# (affine, natural form), the accumulator being initialized with
+# respectively P1, P2 or P1 + P2 according to the most significant
+# bits of k1 & k2 (software passes them through register W_KP2). The
+# remaining bits are given by software in XR0 & YR0, in reverse order
+# (the next bit to process is the lsb) and k2 ends with a sentinel bit
+# set above the last one. The accumulator is kept in Jacobian coordi-
+# nates (XR1, YR1, ZR01) and each bit costs a doubling plus, for each
+# scalar whose bit is set, a mixed addition of P1 or P2.
+#
+# The sum of two points the X-coordinates of which are equal (the
+# accumulator being equal to P1/P2 or to its opposite) as well as a
+# null intermediate result are not handled: the routines then end
+# with the Z flag clear, otherwise they end with the Z flag set (R1
+# then holds the result). Software is in charge of falling back to
+# separate [k]P computations in the former case.
+#
+# (only assembled if parameter 'dualkp' is set in ecc_customize)
+# ******************************************************************
+.if dualkp
+.kp2_loadL:
+.kp2_loadL_export:
+	BARRIER
+	FPREDC	XR0	R2modp	XP1
+	FPREDC	YR0	R2modp	YP1
+	FPREDC	XR1	R2modp	XP2
+	FPREDC	YR1	R2modp	YP2
+	BARRIER
+	NNMOV	zero		kp2t
+	STOP
+
+.kp2_p1L:
+.kp2_p1L_export:
+	BARRIER
+	NNMOV	XP1		XR1
+	NNMOV	YP1		YR1
+	FPREDC	one	R2modp	ZR01
+	J	.kp2_loopL
+
+.kp2_p2L:
+.kp2_p2L_export:
+	BARRIER
+	NNMOV	XP2		XR1
+	NNMOV	YP2		YR1
+	FPREDC	one	R2modp	ZR01
+	J	.kp2_loopL
+
+.kp2_p12L:
+.kp2_p12L_export:
+	BARRIER
+	NNMOV	XP1		XR1
+	NNMOV	YP1		YR1
+	FPREDC	one	R2modp	ZR01
+	NNMOV	XP2		XA
+	NNMOV	YP2		YA
+	JL	.kp2_maddL
+
+.kp2_loopL:
+# stop when only the sentinel bit is left in k2
+	NNSUB	k2r	one	kp2t
+	BARRIER
+	Jz	.kp2_endL
+	JL	.kp2_dblL
+	TESTPAR	k1r		%par
+	NNSRL	k1r		k1r
+	BARRIER
+	Jodd	.kp2_add1L
+.kp2_bit2L:
+	TESTPAR	k2r		%par
+	NNSRL	k2r		k2r
+	BARRIER
+	Jodd	.kp2_add2L
+	J	.kp2_loopL
+.kp2_add1L:
+	NNMOV	XP1		XA
+	NNMOV	YP1		YA
+	JL	.kp2_maddL
+	J	.kp2_bit2L
+.kp2_add2L:
+	NNMOV	XP2		XA
+	NNMOV	YP2		YA
+	JL	.kp2_maddL
+	J	.kp2_loopL
+
+.kp2_endL:
+# a null ZR01 means that an intermediate result was null
+	NNSUB	ZR01	p	red
+	NNADD,p4	red	patchme	kp2t
+	BARRIER
+	Jz	.kp2_exceptL
+	NNMOV	ZR01		dx
+	JL	.modinvL
+	BARRIER
+	JL	.normalizeL
+	BARRIER
+	JL	.exitMontyL
+	NNMOV	zero		kp2t
+	STOP
+
+.kp2_exceptL:
+	BARRIER
+	NNMOV	one		kp2t
+	STOP
+
+# ******************************************************************
+# (XR1, YR1, ZR01) <- [2](XR1, YR1, ZR01)
+#   M = 3X² + aZ⁴, X' = M² - 8XY², Y' = M(4XY² - X') - 8Y⁴, Z' = 2YZ
+# a = 0 and a = -3 (see W_CURVE_A register) have their own shortcut
+# to M, as in .dozdblL (if parameter 'ashape' is set in ecc_customize).
+# Each shape issues M² and Y⁴ last and ends in .kp2_dblXL
+# ******************************************************************
+.kp2_dblL:
+	BARRIER
+.if ashape
+	JAS	.kp2_dbl_ashapeL
+.endif
+	FPREDC	ZR01	ZR01	dlt	# dlt <- Z²
+	FPREDC	YR1	YR1	gam	# gam <- Y²
+	FPREDC	XR1	XR1	XXd	# XXd <- X²
+	FPREDC	YR1	ZR01	YZd	# YZd <- YZ
+	BARRIER
+	FPREDC	dlt	dlt	Z4	# Z4 <- Z⁴
+	FPREDC	XR1	gam	bet	# bet <- XY²
+	FPADD	XXd	XXd	Mk	# Mk <- 2X²
+	FPADD	Mk	XXd	Mk	# Mk <- 3X²
+	FPADD	YZd	YZd	ZR01	# ZR01 <- 2YZ
+	BARRIER
+	FPREDC	a	Z4	Z4	# Z4 <- aZ⁴
+	FPREDC	gam	gam	gsq	# gsq <- Y⁴
+	FPADD	bet	bet	bet	# bet <- 2XY²
+	FPADD	bet	bet	bet	# bet <- 4XY²
+	BARRIER
+	FPADD	Mk	Z4	Mk	# Mk <- M = 3X² + aZ⁴
+	FPREDC	Mk	Mk	Msqk	# Msqk <- M²
+.kp2_dblXL:
+	BARRIER
+	FPADD	bet	bet	bet8	# bet8 <- 8XY²
+	FPSUB	Msqk	bet8	XR1	# XR1 <- M² - 8XY²
+	FPSUB	bet	XR1	bet	# bet <- 4XY² - X'
+	FPREDC	Mk	bet	bet	# bet <- M(4XY² - X')
+	FPADD	gsq	gsq	gsq	# gsq <- 2Y⁴
+	FPADD	gsq	gsq	gsq	# gsq <- 4Y⁴
+	FPADD	gsq	gsq	gsq	# gsq <- 8Y⁴
+	BARRIER
+	FPSUB	bet	gsq	YR1	# YR1 <- M(4XY² - X') - 8Y⁴
+	RET
+
+.if ashape
+# a = 0 or a = -3: JAS lands on the first opcode below if a = 0 and on
+# the second one if a = -3. M is 3X² (resp. (X - Z²).3(X + Z²), with
+# 3X & 3Z² computed while the first products run), which saves the
+# products Z⁴ & aZ⁴ (resp. X² too)
+.kp2_dbl_ashapeL:
+	J	.kp2_dbl_a0L
+	FPREDC	ZR01	ZR01	dlt	# dlt <- Z²
+	FPREDC	YR1	YR1	gam	# gam <- Y²
+	FPADD	ZR01	ZR01	Z3m	# Z3m <- 2Z
+	FPADD	Z3m	ZR01	Z3m	# Z3m <- 3Z
+	FPREDC	ZR01	Z3m	dlt3	# dlt3 <- 3Z²
+	FPREDC	YR1	ZR01	YZd	# YZd <- YZ
+	FPADD	XR1	XR1	X3m	# X3m <- 2X
+	FPADD	X3m	XR1	X3m	# X3m <- 3X
+	BARRIER
+	FPSUB	XR1	dlt	XmD	# XmD <- X - Z²
+	FPADD	X3m	dlt3	XpD	# XpD <- 3(X + Z²)
+	FPREDC	XmD	XpD	Mk	# Mk <- M = 3(X - Z²)(X + Z²)
+	FPREDC	XR1	gam	bet	# bet <- XY²
+	FPADD	YZd	YZd	ZR01	# ZR01 <- 2YZ
+	BARRIER
+	J	.kp2_dbl_aSL
+
+.kp2_dbl_a0L:
+	FPREDC	YR1	YR1	gam	# gam <- Y²
+	FPREDC	XR1	XR1	XXd	# XXd <- X²
+	BARRIER
+	FPREDC	XR1	gam	bet	# bet <- XY²
+	FPREDC	YR1	ZR01	YZd	# YZd <- YZ
+	FPADD	XXd	XXd	Mk	# Mk <- 2X²
+	FPADD	Mk	XXd	Mk	# Mk <- M = 3X²
+	BARRIER
+	FPADD	YZd	YZd	ZR01	# ZR01 <- 2YZ
+.kp2_dbl_aSL:
+	FPREDC	Mk	Mk	Msqk	# Msqk <- M²
+	FPREDC	gam	gam	gsq	# gsq <- Y⁴
+	FPADD	bet	bet	bet	# bet <- 2XY²
+	FPADD	bet	bet	bet	# bet <- 4XY²
+	J	.kp2_dblXL
+.endif
+
+# ******************************************************************
+# (XR1, YR1, ZR01) <- (XR1, YR1, ZR01) + (XA, YA), mixed Jacobian-
+# affine addition
+#   H = XA.Z² - X, R = YA.Z³ - Y
+#   X' = R² - H³ - 2XH², Y' = R(XH² - X') - YH³, Z' = ZH
+# H = 0 (X-coordinates equal) jumps to .kp2_exceptL
+# ******************************************************************
+.kp2_maddL:
+	BARRIER
+	FPREDC	ZR01	ZR01	Zsq	# Zsq <- Z²
+	BARRIER
+	FPREDC	ZR01	Zsq	Zcu	# Zcu <- Z³
+	FPREDC	XA	Zsq	U2	# U2 <- XA.Z²
+	BARRIER
+	FPREDC	YA	Zcu	S2	# S2 <- YA.Z³
+	FPSUB	U2	XR1	Hm	# Hm <- H = XA.Z² - X
+	NNSUB	Hm	p	red
+	NNADD,p4	red	patchme	Hm	# (sets Z flag iff H = 0 mod p)
+	FPREDC	Hm	Hm	Hsq	# Hsq <- H²
+	FPREDC	ZR01	Hm	ZR01	# ZR01 <- ZH
+	BARRIER
+	Jz	.kp2_exceptL
+	FPSUB	S2	YR1	Rm	# Rm <- R = YA.Z³ - Y
+	FPREDC	Hm	Hsq	Hcu	# Hcu <- H³
+	FPREDC	XR1	Hsq	Vm	# Vm <- XH²
+	FPREDC	Rm	Rm	Rmsq	# Rmsq <- R²
+	BARRIER
+	FPREDC	YR1	Hcu	YH	# YH <- YH³
+	FPSUB	Rmsq	Hcu	tm	# tm <- R² - H³
+	FPADD	Vm	Vm	twoV	# twoV <- 2XH²
+	FPSUB	tm	twoV	XR1	# XR1 <- R² - H³ - 2XH²
+	FPSUB	Vm	XR1	VmXa	# VmXa <- XH² - X'
+	FPREDC	Rm	VmXa	Rv	# Rv <- R(XH² - X')
+	BARRIER
+	FPSUB	Rv	YH	YR1	# YR1 <- R(XH² - X') - YH³
+	RET
+.endif
@@ -28,13 +28,11 @@
 .pre_zadduL:
 .pre_zadduL_export:
 	BARRIER
-	NNSUB,p7	XR0	XR1	XmXU
-	NNADD,p5	XmXU	patchme	XmXU
+	FPSUB,p7	XR0	XR1	XmXU
 # we need to test if XR0 == XR1 (i.e XmXU == 0) so reduce XmXU in [0, p-1[
 	NNSUB	XmXU	p	red
 	NNADD,p48	red	patchme	XmXU
-	NNSUB,p8	YR0	YR1	YmY
-	NNADD,p5	YmY	patchme	YmY
+	FPSUB,p8	YR0	YR1	YmY
 # we need to test if YR0 == YR1 (i.e YmY == 0) so reduce YmY in [0, p-1[
 	NNSUB	YmY	p	red
 	NNADD,p49	red	patchme	YmY
@@ -61,15 +59,12 @@
 	NNMOV,p35	YR1		Ytmp
 	FPREDC,p11	Xtmp	AZ	XR1
 	BARRIER
-	NNSUB,p37	D	XR1	DmB
-	NNADD,p5	DmB	patchme	DmB
+	FPSUB,p37	D	XR1	DmB
 	NNSUB,p24	DmB	C	XR0
 	NNADD,p38	XR0	patchme	XR0
-	NNSUB,p25	C	XR1	CmB
-	NNADD,p5	CmB	patchme	CmB
+	FPSUB,p25	C	XR1	CmB
 	FPREDC,p12	Ytmp	CmB	YR1
-	NNSUB,p26	XR1	XR0	BmX
-	NNADD,p5	BmX	patchme	BmX
+	FPSUB,p26	XR1	XR0	BmX
 	FPREDC,p27	YmY	BmX	YR0
 	BARRIER
 	NNSUB,p28	YR0	YR1	YR0
@@ -48,71 +48,53 @@
   FPREDC     ZR01    ZR01     N        # N(8) <- Z²
   FPREDC     YR1     YR1      E        # E(9) <- Y²
   BARRIER
+  # shortcuts for a = 0 and a = -3 (see W_CURVE_A register), a generic
+  # 'a' falls through (only assembled if parameter 'ashape' is set in
+  # ecc_customize)
+.if ashape
+  JAS        .zdbl_ashapeL
+.endif
   FPREDC     N       N        Nsq0     # Nsq0(23) <- N²
   FPREDC     E       E        L        # L(16) <- E²
   NNADD      E       N        EpN      # EpN(25) <- E + N
   BARRIER
   NNMOV      Nsq0             Nsq      # Nsq(8) <- Nsq0(23)
   FPREDC     XR1     XR1      BZd      # BZd(23) <- X² (clobbers Nsq0)
-  NNADD      XR1     E        XpE      # XpE(20) <- X + E
-  NNSUB      XpE     twop     red
-  NNADD,p5   red     patchme  XpE
+  FPADD      XR1     E        XpE      # XpE(20) <- X + E
   BARRIER
-  NNADD      BZd     L        BpL      # BpL(17) <- BZd + L
-  NNSUB      BpL     twop     red
-  NNADD,p5   red     patchme  BpL
+  FPADD      BZd     L        BpL      # BpL(17) <- BZd + L
   FPREDC     XpE     XpE      XpE      # XpE(20) <- (X + E)² (clobbers previous X + E)
-  NNADD      BZd     BZd      twoB     # twoB(21) <- 2BZd
-  NNSUB      twoB    twop     red
-  NNADD,p5   red     patchme  twoB
-  NNADD      twoB    BZd      threeB   # threeB(23) <- 3BZd
-  NNSUB      threeB  twop     red
-  NNADD,p5   red     patchme  threeB
+  FPADD      BZd     BZd      twoB     # twoB(21) <- 2BZd
+  FPADD      twoB    BZd      threeB   # threeB(23) <- 3BZd
   NNSUB      EpN     twop     red
   NNADD,p5   red     patchme  EpN
-  NNADD      YR1     ZR01     YpZ      # YpZ(21) <- Y + Z  (clobbers twoB)
-  NNSUB      YpZ     twop     red
-  NNADD,p5   red     patchme  YpZ
+  FPADD      YR1     ZR01     YpZ      # YpZ(21) <- Y + Z  (clobbers twoB)
   FPREDC     YpZ     YpZ      YpZsq    # YpZsq(21) <- (Y + Z)²
   BARRIER
   FPREDC     a       Nsq      Nsq      # Nsq(8) <- aN²  (clobbers previous N²)
-  NNADD      L       L        L        # L(16) <- 2E² (clobbers previous E²)
-  NNSUB      L       twop     red
-  NNADD,p5   red     patchme  L
-  NNADD      L       L        L        # L(16) <- 4E² (clobbers previous 2E²)
-  NNSUB      L       twop     red
-  NNADD,p5   red     patchme  L
-  NNADD,p22  L       L        YR1      # YR1(7) <- 8E² (clobbers previous Y!)    __Y_OF_UPDATE__
-  NNSUB      YR1     twop     red
-  NNADD,p5   red     patchme  YR1
+  FPADD      L       L        L        # L(16) <- 2E² (clobbers previous E²)
+  FPADD      L       L        L        # L(16) <- 4E² (clobbers previous 2E²)
+  FPADD,p22  L       L        YR1      # YR1(7) <- 8E² (clobbers previous Y!)    __Y_OF_UPDATE__
   BARRIER
-  NNSUB      XpE     BpL      XpE      # XpE(20) <- (X + E)² - BZd - L (clobbers previous (X + E)²)
-  NNADD,p5   XpE     patchme  XpE
-  NNADD      XpE     XpE      S        # S(17) <- 2((X + E)² - BZd - L) (clobbers previous BZd + L)
-  NNSUB      S       twop     red
-  NNADD,p5   red     patchme  S
+  FPSUB      XpE     BpL      XpE      # XpE(20) <- (X + E)² - BZd - L (clobbers previous (X + E)²)
+  FPADD      XpE     XpE      S        # S(17) <- 2((X + E)² - BZd - L) (clobbers previous BZd + L)
   NNMOV,p23  S                XR1      # XR1 <- S = 2((X + E)² - BZd - L)          __X_OF_UPDATE__
   BARRIER
-  NNSUB      YpZsq   EpN      Ztmp     # Ztmp(25) <- (Y + Z)² - E - N
-  NNADD,p5   Ztmp    patchme  Ztmp
+  FPSUB      YpZsq   EpN      Ztmp     # Ztmp(25) <- (Y + Z)² - E - N
   NNMOV,p61  Ztmp             ZR01     # ZR01(26) <- (Y + Z)² - E - N si pt pas de 2-torsion
-  NNADD      BZd     Nsq      MD       # M(8) <- 3BZd + aN² (clobbers N=Z²)
-  NNSUB      MD      twop     red
-  NNADD,p5   red     patchme  MD
+  FPADD      BZd     Nsq      MD       # M(8) <- 3BZd + aN² (clobbers N=Z²)
+.zdbl_ML:
   FPREDC     MD      MD       Msq      # Msq(21) <- (3BZd + aN²)² (clobbers YpZsq = (Y + Z)²)
-  NNADD      S       S        twoS     # twoS(18) <- 2S (clobbers Nsq = aN²)
-  NNSUB      twoS    twop     red
-  NNADD,p5   red     patchme  twoS
+  FPADD      S       S        twoS     # twoS(18) <- 2S (clobbers Nsq = aN²)
   BARRIER
-  NNSUB,p51  Msq     twoS     XR0      # XR0(4) <- = M² - 2S = (3BZd + aN²)² - 2S  __X_OF_DOUBLE__
-  NNADD,p5   XR0     patchme  XR0      # detection = 0 par ,p55 supprimé : seul compte Y = 0 pour détecter DBL=0
+  FPSUB,p51  Msq     twoS     XR0      # XR0(4) <- = M² - 2S = (3BZd + aN²)² - 2S  __X_OF_DOUBLE__
+  # detection = 0 par ,p55 supprimé : seul compte Y = 0 pour détecter DBL=0
   BARRIER
-  NNSUB      S       XR0      S        # S(17) <- S - XR0 (clobbers previous 2((X + E)² - BZd - L))
-  NNADD,p5   S       patchme  S
+  FPSUB      S       XR0      S        # S(17) <- S - XR0 (clobbers previous 2((X + E)² - BZd - L))
   FPREDC     S       MD       S        # S(17) <- M(S - XR0) (clobbers previous S - XR0)
   BARRIER
-  NNSUB,p52  S       YR1      YR0      # YR0(5) <- M(S - XR0) - 8E²              __Y_OF_DOUBLE__
-  NNADD,p5   YR0     patchme  YR0      # ,p56 supprimé ici : detection of a null double done above
+  FPSUB,p52  S       YR1      YR0      # YR0(5) <- M(S - XR0) - 8E²              __Y_OF_DOUBLE__
+  # ,p56 supprimé ici : detection of a null double done above
   # postamble ******************************************************
   #   R0 = double
   # & R1 = update (of what was doubled)
@@ -127,3 +109,42 @@
   NNMOV,p59  XR0tmp           XR0
   NNMOV,p60  YR0tmp           YR0
   RET
+
+.if ashape
+# a = 0 or a = -3: JAS lands on the first opcode below if a = 0 and on
+# the second one if a = -3, with N & E ready. S = 2((X + E)² - X² - E²)
+# is obtained as 4XE and M = 3X² + aN² as 3X² (resp. 3(X - N)(X + N)),
+# which saves the products N², aN² & (X + E)² (resp. and X² too)
+.zdbl_ashapeL:
+  J          .zdbl_a0L
+  FPREDC     E       E        L        # L(16) <- E²
+  FPREDC     XR1     E        S        # S(17) <- XE
+  NNADD      E       N        EpN      # EpN(25) <- E + N
+  FPSUB      XR1     N        XmN      # XmN(20) <- X - N
+  FPADD      XR1     N        XpN      # XpN(23) <- X + N
+  FPREDC     XmN     XpN      MD       # MD(8) <- (X - N)(X + N) (clobbers N=Z²)
+.zdbl_aSL:
+  FPADD      YR1     ZR01     YpZ      # YpZ(21) <- Y + Z
+  FPREDC     YpZ     YpZ      YpZsq    # YpZsq(21) <- (Y + Z)²
+  NNSUB      EpN     twop     red
+  NNADD,p5   red     patchme  EpN
+  BARRIER
+  FPADD      L       L        L        # L(16) <- 2E² (clobbers previous E²)
+  FPADD      L       L        L        # L(16) <- 4E² (clobbers previous 2E²)
+  FPADD,p22  L       L        YR1      # YR1(7) <- 8E² (clobbers previous Y!)    __Y_OF_UPDATE__
+  FPADD      S       S        S        # S(17) <- 2XE
+  FPADD      S       S        S        # S(17) <- 4XE
+  NNMOV,p23  S                XR1      # XR1 <- S = 4XE                          __X_OF_UPDATE__
+  FPSUB      YpZsq   EpN      Ztmp     # Ztmp(25) <- (Y + Z)² - E - N
+  NNMOV,p61  Ztmp             ZR01     # ZR01(26) <- (Y + Z)² - E - N si pt pas de 2-torsion
+  FPADD      MD      MD       twoMD    # twoMD(20) <- 2MD
+  FPADD      twoMD   MD       MD       # M(8) <- 3X² (resp. 3(X - N)(X + N))
+  J          .zdbl_ML
+
+.zdbl_a0L:
+  FPREDC     E       E        L        # L(16) <- E²
+  FPREDC     XR1     E        S        # S(17) <- XE
+  NNADD      E       N        EpN      # EpN(25) <- E + N
+  FPREDC     XR1     XR1      MD       # MD(8) <- X² (clobbers N=Z²)
+  J          .zdbl_aSL
+.endif
@@ -22,8 +22,7 @@
 	NNMOV,p9	patchme		Xkeep
 # take the opposite of the Y coordinate of the point we need to take
 # the opposite of, and set it to the new coordinate of destination point
-	NNSUB	p	Ykeep	Yopp
-	NNADD,p5	Yopp	patchme	Yopp
+	FPSUB	p	Ykeep	Yopp
 # now transfer coordinates to the new destination
 	NNMOV,p18	Yopp		patchme
 	NNMOV,p19	Ykeep		patchme
@@ -66,6 +66,10 @@ class IPECCExecutionContext(object):
             "%par"  : 0,      
             "%kapP" : 0,      
             "%kap"  : 0,
+            # Shape of curve parameter a (a = 0, a = -3), as declared by
+            # software (static for a given curve)
+            "%az"   : 0,
+            "%am3"  : 0,
             # Arithmetic carry flag
             "%Carith"   : 0,
             # Shift carry flag
@@ -120,6 +124,9 @@ class IPECCExecutionContext(object):
             a += "\t==> %s\n" % self.executed_line
         return a
 
+# Set by option -c (see emulate_file)
+emulate_ignore_patches = False
+
 def apply_patch(execution_context, opa, opb, opc, options):
     for o in options:
         patch_num = None
@@ -130,6 +137,23 @@ def apply_patch(execution_context, opa, opb, opc, options):
         if patch_num is None:
             # Nothing to do, return
             return (execution_context, opa, opb, opc)
+        elif patch_num == 4:
+            # ",p4": opb is p if the previous result was negative, 0 otherwise
+            # (the modular correction ending a reduction in [0, p[)
+            if execution_context.flags['%SN'] == 1:
+                opb = binstring_to_int(ipecc_operands_dict["p"])
+            else:
+                opb = binstring_to_int(ipecc_operands_dict["zero"])
+        elif patch_num == 5:
+            # ",p5": same with 2p in place of p
+            if execution_context.flags['%SN'] == 1:
+                opb = binstring_to_int(ipecc_operands_dict["twop"])
+            else:
+                opb = binstring_to_int(ipecc_operands_dict["zero"])
+        elif emulate_ignore_patches is True:
+            # Timing mode (-c): the operands a patch selects do not change
+            # the duration of the opcode, so keep the unpatched ones
+            pass
         else:
             print_error("Error: ", "%s: " % execution_context.executed_line, " patch %d is asked, patches are NOT implemented yet!" % patch_num)
             sys.exit(-1)
@@ -158,8 +182,8 @@ def nnadd_emulate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get the operands
-    opa = abstract_operands[0][2]
-    opb = abstract_operands[1][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
     opc = abstract_operands[2][2]
     # Apply the possible patches
     execution_context, opa, opb, opc = apply_patch(execution_context, opa, opb, opc, options)
@@ -188,8 +212,8 @@ def nnsub_emulate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get the operands
-    opa = abstract_operands[0][2]
-    opb = abstract_operands[1][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
     opc = abstract_operands[2][2]
     # Apply the possible patches
     execution_context, opa, opb, opc = apply_patch(execution_context, opa, opb, opc, options)
@@ -216,8 +240,8 @@ def nnsrl_emulate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get the operands
-    opa = abstract_operands[0][2]
-    opb = abstract_operands[1][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
     opc = abstract_operands[2][2]
     # Apply the possible patches
     execution_context, opa, opb, opc = apply_patch(execution_context, opa, opb, opc, options)
@@ -242,8 +266,8 @@ def nnsll_emulate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get the operands
-    opa = abstract_operands[0][2]
-    opb = abstract_operands[1][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
     opc = abstract_operands[2][2]
     # Apply the possible patches
     execution_context, opa, opb, opc = apply_patch(execution_context, opa, opb, opc, options)
@@ -269,8 +293,8 @@ def nnrnd_emulate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get the operands
-    opa = abstract_operands[0][2]
-    opb = abstract_operands[1][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
     opc = abstract_operands[2][2]
     # Apply the possible patches
     execution_context, opa, opb, opc = apply_patch(execution_context, opa, opb, opc, options)
@@ -286,8 +310,8 @@ def testpars_emulate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get operands
-    opa = abstract_operands[0][2]
-    opb = abstract_operands[1][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
     opc = abstract_operands[2][2]
     opc_name = abstract_operands[2][1]
     # Apply the possible patches
@@ -303,8 +327,8 @@ def nnxor_emulate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get the operands
-    opa = abstract_operands[0][2]
-    opb = abstract_operands[1][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
     opc = abstract_operands[2][2]
     # Apply the possible patches
     execution_context, opa, opb, opc = apply_patch(execution_context, opa, opb, opc, options)
@@ -323,8 +347,8 @@ def fpredc_emulate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get the operands
-    opa = abstract_operands[0][2]
-    opb = abstract_operands[1][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
     opc = abstract_operands[2][2]
     # Apply the possible patches
     execution_context, opa, opb, opc = apply_patch(execution_context, opa, opb, opc, options)
@@ -347,7 +371,8 @@ def testpar_emulate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get the operands
-    opa = abstract_operands[0][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = None
     opc = abstract_operands[2][2]
     opc_name = abstract_operands[2][1]
     # Apply the possible patches
@@ -364,8 +389,8 @@ def nnrndm_emulate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get the operand
-    opa = abstract_operands[0][2]
-    opb = abstract_operands[1][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
     opc = abstract_operands[2][2]
     # Apply the possible patches
     execution_context, opa, opb, opc = apply_patch(execution_context, opa, opb, opc, options)
@@ -383,8 +408,8 @@ def nndiv2_emulate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get the operands
-    opa = abstract_operands[0][2]
-    opb = abstract_operands[1][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
     opc = abstract_operands[2][2]
     # Apply the possible patches
     execution_context, opa, opb, opc = apply_patch(execution_context, opa, opb, opc, options)
@@ -404,8 +429,8 @@ def nnrnds_emulate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get the operands
-    opa = abstract_operands[0][2]
-    opb = abstract_operands[1][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
     opc = abstract_operands[2][2]
     # Apply the possible patches
     execution_context, opa, opb, opc = apply_patch(execution_context, opa, opb, opc, options)
@@ -425,8 +450,8 @@ def nnrndf_emumate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get the operands
-    opa = abstract_operands[0][2]
-    opb = abstract_operands[1][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
     opc = abstract_operands[2][2]
     # Apply the possible patches
     execution_context, opa, opb, opc = apply_patch(execution_context, opa, opb, opc, options)
@@ -444,8 +469,8 @@ def nnsrls_emulate(ins, execution_context):
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Get the operands
-    opa = abstract_operands[0][2]
-    opb = abstract_operands[1][2]
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
     opc = abstract_operands[2][2]
     # Apply the possible patches
     execution_context, opa, opb, opc = apply_patch(execution_context, opa, opb, opc, options)
@@ -472,12 +497,53 @@ def nnsrls_emulate(ins, execution_context):
     execution_context.ip += 1
     return execution_context
 
+def fpm_emulate(ins, execution_context, is_add):
+    # Unpack values
+    addr, instruction, options, abstract_operands, l = ins
+    execution_context.executed_line = l
+    # Get the operands
+    opa = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    opb = (abstract_operands[1][2] if abstract_operands[1] is not None else None)
+    opc = abstract_operands[2][2]
+    # Apply the possible patches
+    execution_context, opa, opb, opc = apply_patch(execution_context, opa, opb, opc, options)
+    twop = binstring_to_int(ipecc_operands_dict["twop"])
+    red = binstring_to_int(ipecc_operands_dict["red"])
+    TWOP = execution_context.r[twop]
+    A = execution_context.r[opa]
+    B = execution_context.r[opb]
+    if is_add is True:
+        # Same as NNADD a b c, NNSUB c twop red, NNADD,p5 red patchme c
+        C = (A + B) % (2**BIGNUM_BITS_SIZE)
+        execution_context.r[opc] = C
+        C = (C - TWOP) % (2**BIGNUM_BITS_SIZE)
+        execution_context.r[red] = C
+    else:
+        # Same as NNSUB a b c, NNADD,p5 c patchme c
+        C = (A - B) % (2**BIGNUM_BITS_SIZE)
+    # Modular correction: add 2p if negative
+    if (C >> (BIGNUM_BITS_SIZE - 1)) & 1:
+        C = (C + TWOP) % (2**BIGNUM_BITS_SIZE)
+    # Update the arithmetic flags
+    execution_context = update_arith_flags(C, execution_context, Z=True, SN=True)
+    # Result
+    execution_context.r[opc] = C
+    # Increment IP
+    execution_context.ip += 1
+    return execution_context
+
+def fpadd_emulate(ins, execution_context):
+    return fpm_emulate(ins, execution_context, True)
+
+def fpsub_emulate(ins, execution_context):
+    return fpm_emulate(ins, execution_context, False)
+
 def j_emulate(ins, execution_context):
     # Unpack values
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Jump to our target
-    imm = abstract_operands[0][2]
+    imm = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
     execution_context.ip = imm
     return execution_context
 
@@ -487,7 +553,7 @@ def jz_emulate(ins, execution_context):
     execution_context.executed_line = l
     # Jump to our target only if '%Z' is set
     if execution_context.flags['%Z'] == 1:
-        imm = abstract_operands[0][2]
+        imm = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
         execution_context.ip = imm
     else:
         execution_context.ip += 1
@@ -499,7 +565,7 @@ def jsn_emulate(ins, execution_context):
     execution_context.executed_line = l
     # Jump to our target only if '%SN' is set
     if execution_context.flags['%SN'] == 1:
-        imm = abstract_operands[0][2]
+        imm = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
         execution_context.ip = imm
     else:
         execution_context.ip += 1
@@ -511,7 +577,7 @@ def jodd_emulate(ins, execution_context):
     execution_context.executed_line = l
     # Jump to our target only if '%par' is set
     if execution_context.flags['%par'] == 1:
-        imm = abstract_operands[0][2]
+        imm = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
         execution_context.ip = imm
     else:
         execution_context.ip += 1
@@ -523,18 +589,33 @@ def jkap_emulate(ins, execution_context):
     execution_context.executed_line = l
     # Jump to our target only if '%kap' is set
     if execution_context.flags['%kap'] == 1:
-        imm = abstract_operands[0][2]
+        imm = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
         execution_context.ip = imm
     else:
         execution_context.ip += 1
     return execution_context
 
+def jas_emulate(ins, execution_context):
+    # Unpack values
+    addr, instruction, options, abstract_operands, l = ins
+    execution_context.executed_line = l
+    # Jump to our target if '%az' is set, to the opcode following
+    # our target if '%am3' is set
+    imm = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
+    if execution_context.flags['%az'] == 1:
+        execution_context.ip = imm
+    elif execution_context.flags['%am3'] == 1:
+        execution_context.ip = imm + 1
+    else:
+        execution_context.ip += 1
+    return execution_context
+
 def jl_emulate(ins, execution_context):
     # Unpack values
     addr, instruction, options, abstract_operands, l = ins
     execution_context.executed_line = l
     # Jump with link
-    imm = abstract_operands[0][2]
+    imm = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
     execution_context.lrip = execution_context.ip + 1
     execution_context.ip = imm
     return execution_context
@@ -545,7 +626,7 @@ def jlsn_emulate(ins, execution_context):
     execution_context.executed_line = l
     # Jump with link to our target only if 'SN' is set
     if execution_context.flags['%SN'] == 1:
-        imm = abstract_operands[0][2]
+        imm = (abstract_operands[0][2] if abstract_operands[0] is not None else None)
         execution_context.lrip = execution_context.ip + 1
         execution_context.ip = imm
     else:
@@ -577,6 +658,207 @@ def stop_emulate(ins, execution_context):
     return execution_context
 
 
+### Timing model (option -c)
+#
+# Counts the clock cycles a sequence of opcodes takes, as scheduled by
+# ecc_curve (fetch/decode stages), ecc_fp (arithmetic, one operation at a
+# time) and the 'nbmult' Montgomery multipliers (mm_ndsp) FPREDC opcodes
+# are posted to. Durations are those of the counters & shift-registers of
+# the RTL (references between parenthesis are the (sXX) tags found in the
+# comments of ecc_curve.vhd, ecc_fp.vhd and mm_ndsp.vhd). This is a model:
+# it does not replace a simulation of the design, e.g it assumes a single
+# clock (clk = clkmm) and a TRNG that never starves.
+ipecc_hw_config = {
+    "nn" : None,
+    "ww" : 16,
+    "nbmult" : 2,
+    "nbdsp" : 6,
+    "sramlat" : 1,
+    "async" : 1,
+    "shuffle" : 1,
+    "redc" : None,
+    "fpaddsub" : 0,
+    "fpprefetch" : 0,
+    "fpsqr" : 0,
+}
+
+# Boolean parameters of ecc_customize.vhd (all of them, filled by
+# parse_vhdl) which the .if directives of the microcode can test
+ipecc_hw_features = {}
+
+def ceil_div(a, b):
+    return (a + b - 1) // b
+
+class IPECCTimingModel(object):
+    def __init__(self, config):
+        nn = config["nn"] if config["nn"] is not None else BIGNUM_BITS_SIZE
+        self.ww = config["ww"]
+        self.w = ceil_div(nn + 4, self.ww)
+        self.ndsp = min(config["nbdsp"], self.w)
+        self.sramlat = config["sramlat"]
+        self.nbmult = config["nbmult"]
+        self.asyn = (config["async"] != 0)
+        self.prefetch = self.asyn and (config["fpprefetch"] != 0)
+        self.fpsqr = (config["fpsqr"] != 0)
+        # see function set_readlat in ecc_utils.vhd (permute_lgnb shuffle)
+        self.readlat = self.sramlat + (2 if config["shuffle"] != 0 else 0)
+        self.redc_override = config["redc"]
+        # ecc_fp
+        #   one ww-bit word of A and B read every other cycle (2w reads),
+        #   result written readlat + 3 cycles after the last read (s73)
+        self.t_addsub = 2 * self.w + self.readlat + 6
+        #   FPADD/FPSUB chained passes (s143) skip the acknowledge cycle
+        self.t_pass = self.t_addsub - 1
+        self.t_shift = self.w + self.readlat + 6
+        self.t_test = self.readlat + 4
+        self.t_rnd = self.w + self.readlat + 6
+        # FPREDC: transfer of X (& of Y unless a squaring (s144)) to the
+        # Montgomery multiplier, then 'go' (s95)-(s97) & one trypull (s128)
+        self.t_push_mul = 2 * self.w + self.readlat + 5
+        self.t_push_sqr = self.w + self.readlat + 5
+        # pulling a REDC result back into ecc_fp_dram (s121) & (s8)
+        self.t_pull = self.w + self.sramlat + 3
+        # ecc_curve: decode + presentation to ecc_fp (s114)-(s26), one more
+        # cycle for the 'patch' state (s24), back to idle from 'waitarith'
+        self.t_decode = 2
+        self.t_branch = 2
+        # a taken branch re-arms the fetch (s13), opcode is valid sramlat + 1
+        # cycles later (s14)
+        self.t_refetch = self.sramlat + 2
+        self.t_redc_mul = self.redc_cycles(False)
+        self.t_redc_sqr = self.redc_cycles(True)
+        self.reset()
+
+    def redc_cycles(self, sq):
+        # Duration of one REDC in mm_ndsp: 3 cycles of multiply-&-acc (xy, sp
+        # & ap), each made of ceil(w/ndsp) bursts. A burst reads its (up to)
+        # ndsp x_i terms, then streams the w y_j terms (s9), then waits
+        # 'nextslkcnt' slack cycles. The last burst of a cycle also waits for
+        # the first accumulated term to be written back (NBRA). In the xy
+        # cycle of a squaring, burst b only streams the y_j terms from
+        # j = b * ndsp (s130)-(s132).
+        if self.redc_override is not None:
+            return self.redc_override
+        ndsp = self.ndsp
+        slack = (ndsp - 1) if ndsp > 2 else 2
+        nbrp = self.sramlat + 2 * ndsp + 6
+        nbra = nbrp + self.sramlat + 5
+        t = 0
+        for phase in range(3):
+            for b in range(ceil_div(self.w, ndsp)):
+                nx = min(ndsp, self.w - b * ndsp)
+                ny = self.w - (b * ndsp if (sq and phase == 0) else 0)
+                t += self.sramlat + 1 + nx + ny + slack
+            t += nbra
+        # result terms written into ZRAM
+        return t + self.w
+
+    def reset(self):
+        self.t = 0
+        self.fp_free = 0
+        # per multiplier: time by which its current multiplication (resp.
+        # the one queued behind it (s147)) is over, None if there is none
+        self.mm_done = [None] * self.nbmult
+        self.mm_queued = [None] * self.nbmult
+        self.nb_ops = 0
+        self.nb_redc = 0
+        self.stats = {}
+
+    def pull_one(self, before):
+        # pull the result of the first multiplier done by cycle 'before'
+        # (any if 'before' is None), return False if there is none
+        cand = [(self.mm_done[i], i) for i in range(self.nbmult)
+                if self.mm_done[i] is not None
+                and (before is None or self.mm_done[i] <= before)]
+        if len(cand) == 0:
+            return False
+        (done, i) = min(cand)
+        self.fp_free = max(self.fp_free, done) + self.t_pull
+        self.mm_done[i] = None
+        if self.mm_queued[i] is not None:
+            # the queued multiplication only starts now (s128)-(s129)
+            self.mm_done[i] = self.fp_free + self.mm_queued[i]
+            self.mm_queued[i] = None
+        return True
+
+    def drain(self, until):
+        # results available while ecc_fp is idle are pulled first (s124)
+        while self.pull_one(max(until, self.fp_free)):
+            pass
+
+    def barrier(self):
+        while self.pull_one(None):
+            pass
+        self.t = max(self.t, self.fp_free)
+
+    def push_redc(self, start, sq):
+        # find a multiplier (s0), or one to queue the multiplication on
+        # (s147), pulling results first if none can accept it (s127)
+        while True:
+            idle = [i for i in range(self.nbmult) if self.mm_done[i] is None]
+            if len(idle) > 0:
+                i = idle[0]
+                break
+            if self.prefetch:
+                q = [i for i in range(self.nbmult) if self.mm_queued[i] is None]
+                if len(q) > 0:
+                    i = min(q, key=lambda j: self.mm_done[j])
+                    break
+            self.pull_one(None)
+        start = max(start, self.fp_free)
+        end = start + (self.t_push_sqr if sq else self.t_push_mul)
+        duration = self.t_redc_sqr if sq else self.t_redc_mul
+        if self.mm_done[i] is None:
+            self.mm_done[i] = end + duration
+        else:
+            self.mm_queued[i] = duration
+        self.fp_free = end
+        return end
+
+    def issue(self, instruction, options, operands, barrier, taken):
+        self.nb_ops += 1
+        self.stats[instruction] = self.stats.get(instruction, 0) + 1
+        kind = ipecc_instructions_dict[instruction][1]
+        if barrier is True:
+            self.barrier()
+        if kind == "BRANCH":
+            self.t += self.t_branch + (self.t_refetch if taken else 0)
+            return
+        if kind == "NOP":
+            self.t += self.t_decode
+            return
+        patched = len([o for o in options if re.search(r"p[0-9]+", o)]) > 0
+        start = self.t + self.t_decode + (1 if patched else 0)
+        self.drain(start)
+        start = max(start, self.fp_free)
+        if instruction == "FPREDC":
+            self.nb_redc += 1
+            sq = self.fpsqr and (operands[0] is not None) and (operands[0] == operands[1])
+            end = self.push_redc(start, sq)
+        else:
+            if instruction in ["NNADD", "NNSUB", "NNXOR"]:
+                d = self.t_addsub
+            elif instruction == "FPSUB":
+                d = self.t_addsub + self.t_pass
+            elif instruction == "FPADD":
+                d = self.t_addsub + 2 * self.t_pass
+            elif instruction in ["NNSRL", "NNSLL", "NNDIV2", "NNSRLS"]:
+                d = self.t_shift
+            elif instruction in ["TESTPAR", "TESTPARS"]:
+                d = self.t_test
+            else:
+                d = self.t_rnd
+            end = start + d
+            self.fp_free = end
+        self.t = end + 1
+
+    def report(self):
+        self.barrier()
+        print("    -> Timing model: w = %d, ndsp = %d, nbmult = %d, sramlat = %d, readlat = %d, async = %s, fpprefetch = %s, fpsqr = %s" % (self.w, self.ndsp, self.nbmult, self.sramlat, self.readlat, self.asyn, self.prefetch, self.fpsqr))
+        print("       REDC (multiplier alone): %d cycles (product), %d cycles (square)" % (self.t_redc_mul, self.t_redc_sqr))
+        print("       opcodes: %s" % ", ".join(["%s %d" % (k, self.stats[k]) for k in sorted(self.stats.keys())]))
+        print("       %d opcodes (%d FPREDC), %d cycles" % (self.nb_ops, self.nb_redc, self.t))
+
 ## VHDL files creation headers and footers
 ##########################################################
 ecc_curve_iram_begin =r"""
@@ -947,9 +1229,52 @@ ipecc_operands_dict = {
     "Xup": "01000",
     "Yup": "01001",
     "Ztmp": "11001",
+    "XmN": "10100",
+    "XpN": "10111",
+    "twoMD": "10100",
     "Yopp": "10101",
     "Ykeep": "10000",
     "Xkeep": "10100",
+    "ypar": "01000",
+    "k1r": "00100",
+    "k2r": "00101",
+    "kp2t": "01000",
+    "XA": "01010",
+    "YA": "01011",
+    "XP1": "01100",
+    "YP1": "01101",
+    "XP2": "01110",
+    "YP2": "01111",
+    "dlt": "01000",
+    "gam": "01001",
+    "XXd": "10000",
+    "XmD": "10000",
+    "YZd": "10001",
+    "bet": "10100",
+    "Mk": "10101",
+    "Z4": "10111",
+    "XpD": "10111",
+    "gsq": "11001",
+    "dlt3": "11001",
+    "Msqk": "11011",
+    "X3m": "11011",
+    "bet8": "11100",
+    "Z3m": "11100",
+    "Zsq": "01000",
+    "YH": "01000",
+    "Zcu": "01001",
+    "tm": "01001",
+    "U2": "10000",
+    "twoV": "10000",
+    "S2": "10001",
+    "VmXa": "10001",
+    "Hm": "10100",
+    "Rv": "10100",
+    "Hsq": "10101",
+    "Rm": "10111",
+    "Hcu": "11001",
+    "Vm": "11011",
+    "Rmsq": "11100",
     # "Patch" operand, dummy value
     "patchme": "10101",
     ### Disassembly registers for
@@ -1009,6 +1334,9 @@ ipecc_internal_flags_dict = {
     "%Z"   : None,
     # Strictly negative flag
     "%SN"  : None,
+    # Shape of curve parameter a (a = 0, a = -3)
+    "%az"  : None,
+    "%am3" : None,
 }
 
 # Operands
@@ -1062,6 +1390,10 @@ ipecc_instructions_dict = {
 	"NNRNDS" : ([None, ipecc_const(), ipecc_operand()], "ARITH", "1100", "RNH", nnrnds_emulate),
 	"NNRNDF" : ([None, ipecc_const(), ipecc_operand()], "ARITH", "1101", "RNF", nnrndf_emumate),
 	"NNSRLS" : ([ipecc_operand(), ipecc_const(), ipecc_operand()], "ARITH", "1110", "SRH", nnsrls_emulate),
+	#   FPADD & FPSUB share the same opcode, they differ by their implicit
+	#   X bit (see ipecc_implicit_options_dict below)
+	"FPADD" : ([ipecc_operand(), ipecc_operand(), ipecc_operand()], "ARITH", "1111", "FPM", fpadd_emulate),
+	"FPSUB" : ([ipecc_operand(), ipecc_operand(), ipecc_operand()], "ARITH", "1111", "FPM", fpsub_emulate),
 	# branch instructions, the None is to be updated with a
     # proper label after the fitst pass
 	"J"    : ([None], "BRANCH", "0001", "B", j_emulate),
@@ -1072,6 +1404,7 @@ ipecc_instructions_dict = {
 	"JL"   : ([None], "BRANCH", "0110", "CALL", jl_emulate),
 	"JLSN" : ([None], "BRANCH", "0111", "CALLSN", jlsn_emulate),
 	"RET"  : ([], "BRANCH", "1000", "RET", ret_emulate),
+	"JAS"  : ([None], "BRANCH", "1001", "BAS", jas_emulate),
     # "Pseudo" instructions, None encoding means nothing
     # to encode
     "BARRIER" : ([], "PSEUDO", None, None, barrier_emulate),
@@ -1084,10 +1417,18 @@ ipecc_instructions_dict = {
     "BSN"    : ([None], "ALIAS", "JSN", ['OPERAND0'], None),
     "BODD"   : ([None], "ALIAS", "JODD", ['OPERAND0'], None),
     "BKAP"   : ([None], "ALIAS", "JKAP", ['OPERAND0'], None),
+    "BAS"    : ([None], "ALIAS", "JAS", ['OPERAND0'], None),
     "CALL"   : ([None], "ALIAS", "JL", ['OPERAND0'], None),
     "CALLSN" : ([None], "ALIAS", "JLSN", ['OPERAND0'], None),
 }
 
+# Options which are implicitly set by some instructions (and which
+# therefore cannot be given explicitly for them)
+ipecc_implicit_options_dict = {
+    "FPADD" : ['X'],
+    "FPSUB" : [],
+}
+
 def ipecc_instruction():
     return key_words_regexp(ipecc_instructions_dict.keys())
 
@@ -1203,6 +1544,79 @@ def resolve_labels(asm):
         if ipecc_instructions_dict[k][0] == [None]:
             ipecc_instructions_dict[k][0][0] = ipecc_label_
 
+##########################################################
+# Unless the hardware decodes them (parameter 'fpaddsub'
+# of ecc_customize.vhd) replace the FPADD & FPSUB opcodes
+# by the sequences they stand for. The options (and the
+# comment) of the line are kept on the first opcode
+def expand_fpm(asm):
+    if ipecc_hw_config["fpaddsub"]:
+        return asm
+    output = []
+    for l in asm.splitlines():
+        inst = re.search(r"^(\s*)(FPADD|FPSUB)((,[^\s]+)?)\s+([^\s#]+)\s+([^\s#]+)\s+([^\s#]+)(\s*#.*)?$", l, flags=re.IGNORECASE)
+        if inst is None:
+            output.append(l)
+            continue
+        (indent, ins, opts, _, a, b, c, comment) = inst.groups()
+        if comment is None:
+            comment = ""
+        if ins.upper() == "FPSUB":
+            output.append("%sNNSUB%s\t%s\t%s\t%s%s" % (indent, opts, a, b, c, comment))
+            output.append("%sNNADD,p5\t%s\tpatchme\t%s" % (indent, c, c))
+        else:
+            output.append("%sNNADD%s\t%s\t%s\t%s%s" % (indent, opts, a, b, c, comment))
+            output.append("%sNNSUB\t%s\ttwop\tred" % (indent, c))
+            output.append("%sNNADD,p5\tred\tpatchme\t%s" % (indent, c))
+    return "\n".join(output)
+
+##########################################################
+# Conditional assembly: the lines between a '.if <param> [<param> ...]'
+# directive and its '.endif' are only kept if one at least of the
+# boolean parameters of ecc_customize.vhd it names is TRUE, so that the
+# routines of an optional feature don't take room in the microcode
+# memory when the feature is not synthesized (directives can be nested).
+# The labels to be exported that are dropped this way are still exported
+# (see assemble_file) so that the RTL referencing them still compiles.
+ipecc_dropped_exports = []
+
+def select_features(asm):
+    output = []
+    stack = []
+    line_num = 1
+    for l in asm.splitlines():
+        directive = re.search(r"^\s*\.(if|endif)((\s+[a-zA-Z0-9_]+)*)\s*(#.*)?$", l)
+        if directive is not None:
+            if directive.group(1) == "if":
+                names = directive.group(2).split()
+                if len(names) == 0:
+                    print_error("Syntax error line %d: " % line_num, l, ", .if without any parameter")
+                    sys.exit(-1)
+                for n in names:
+                    if n not in ipecc_hw_features.keys():
+                        print_error("Syntax error line %d: " % line_num, l, ", %s is not a boolean parameter of ecc_customize" % n)
+                        sys.exit(-1)
+                stack.append(any(ipecc_hw_features[n] for n in names))
+            else:
+                if (len(stack) == 0) or (directive.group(2) != ""):
+                    print_error("Syntax error line %d: " % line_num, l, ", unexpected .endif")
+                    sys.exit(-1)
+                stack.pop()
+            # (keep the line count of the source)
+            output.append("")
+        elif all(stack):
+            output.append(l)
+        else:
+            label = re.search(r"^\s*(\.[a-zA-Z0-9_]+L_export:)\s*(#.*)*$", l)
+            if label is not None:
+                ipecc_dropped_exports.append(label.group(1))
+            output.append("")
+        line_num += 1
+    if len(stack) != 0:
+        print_error("Syntax error: ", "", "%d .if without .endif" % len(stack))
+        sys.exit(-1)
+    return "\n".join(output)
+
 # Encode the opcodes
 def encode_opcodes(asm):
     lines = asm.splitlines()
@@ -1258,6 +1672,12 @@ def encode_opcodes(asm):
             if len(OPTIONS) > (check + 1):
                 print_error("Syntax error line %d: " % line_num, l, ", too many extensions or patches for instruction")
                 sys.exit(-1)
+            # Add the implicit options
+            if instruction in ipecc_implicit_options_dict.keys():
+                if check != 0:
+                    print_error("Syntax error line %d: " % line_num, l, ", no extension allowed for instruction")
+                    sys.exit(-1)
+                OPTIONS += ipecc_implicit_options_dict[instruction]
             #################################
             # Try to get the operands
             # Get the instruction semantic
@@ -1452,7 +1872,7 @@ def encode_opcodes(asm):
 
 def assemble_file(infile):
     with open(infile, "r") as f:
-        asm = f.read()
+        asm = expand_fpm(select_features(f.read()))
         # First pass to resolve the labels
         resolve_labels(asm)
         print("    -> First pass for labels resolution done")
@@ -1462,6 +1882,11 @@ def assemble_file(infile):
         # Now format our assembly output
         output = ""
         lines = encoding.splitlines()
+        # The program must fit in the microcode memory (parameter nbopcodes)
+        if len(lines) > 2**IMMEDIATE_BITS_SIZE:
+            print_error("Error: ", "", "program is %d opcodes, larger than nbopcodes = %d" % (len(lines), 2**IMMEDIATE_BITS_SIZE))
+            sys.exit(-1)
+        print("    -> Program is %d opcodes (nbopcodes = %d)" % (len(lines), 2**IMMEDIATE_BITS_SIZE))
         line_num = 1
         address = 0
         addr_digits_10 = str(len(str(len(lines))))
@@ -1493,6 +1918,13 @@ def assemble_file(infile):
                 output += "\tconstant ECC_IRAM_"+k_.upper()+"_ADDR : std_logic_vector(IRAM_ADDR_SZ - 1 downto 0) := "
                 output += ("\""+ipecc_labels_dict[k][0]+"\"; -- %s\n") % ipecc_labels_dict[k][1]
                 output_h += ("#define ECC_IRAM_"+k_.upper()+"_ADDR        %s\n") % ipecc_labels_dict[k][1]
+        for k in ipecc_dropped_exports:
+            # Not assembled (see select_features), the RTL never branches
+            # there as it refuses the commands of the feature
+            k_ = k.replace(r"L_export:", "")[1:]
+            output += "\tconstant ECC_IRAM_"+k_.upper()+"_ADDR : std_logic_vector(IRAM_ADDR_SZ - 1 downto 0) := "
+            output += ("\""+int_to_binstring(0, IMMEDIATE_BITS_SIZE)+"\"; -- not assembled\n")
+            output_h += ("#define ECC_IRAM_"+k_.upper()+"_ADDR        0x0 /* not assembled */\n")
         output = ecc_addr_begin + output + ecc_addr_end
         output_h += ecc_addr_h_middle
         for k in ipecc_labels_dict.keys():
@@ -1523,13 +1955,16 @@ def get_dec_hexa_bin_value(inval):
             val = int(inval, 2)
     return val
     
-def emulate_file(infile, initial_state):
+def emulate_file(infile, initial_state, timing=False):
+    global emulate_ignore_patches
     # First, interpret our initial state
     initial_state = initial_state.splitlines()
     line_num = 1
     ip = lrip = breakip = verbosity = None
     flags = []
     registers = []
+    # ip, lrip & breakip can also be given as labels, resolved below
+    ip_labels = {}
     print("    -> Parsing stding for options")
     for l in initial_state:
         # Skip empty lines and comments
@@ -1538,7 +1973,13 @@ def emulate_file(infile, initial_state):
         if (comment is not None) or (empty_line is not None):
             line_num += 1
             continue
-        check = re.search(r"^\s*("+ipecc_operand()+"|"+ipecc_flag()+"|"+ipecc_internal_flag()+"|mem\[([0-9]+|0x[0-9a-fA-F]+|0b[0-1]+)\]|ip|lrip|breakip|verbose)\s*=\s*([0-9]+|0x[0-9a-fA-F]+|0b[0-1]+)\s*(#.*)*$", l)
+        check = re.search(r"^\s*("+ipecc_operand()+"|"+ipecc_flag()+"|"+ipecc_internal_flag()+"|mem\[([0-9]+|0x[0-9a-fA-F]+|0b[0-1]+)\]|ip|lrip|breakip|verbose|"+key_words_regexp(ipecc_hw_config.keys())+")\s*=\s*([0-9]+|0x[0-9a-fA-F]+|0b[0-1]+)\s*(#.*)*$", l)
+        if check is None:
+            check = re.search(r"^\s*(ip|lrip|breakip)\s*=\s*(\.[a-zA-Z0-9_]+)\s*(#.*)*$", l)
+            if check is not None:
+                ip_labels[check.group(1)] = check.group(2)
+                line_num += 1
+                continue
         if check is None:
             print_error("Error line %d: " % line_num, "%s syntax error" % l, " unknown token")
             sys.exit(-1)
@@ -1580,16 +2021,32 @@ def emulate_file(infile, initial_state):
         check = re.search(r"^\s*(verbose)\s*=\s*([0-9]+|0x[0-9a-fA-F]+|0b[0-1]+)\s*(#.*)*$", l)
         if check is not None:
             verbosity = get_dec_hexa_bin_value(check.group(2))
+        ## Getting parameters of the timing model
+        check = re.search(r"^\s*("+key_words_regexp(ipecc_hw_config.keys())+")\s*=\s*([0-9]+|0x[0-9a-fA-F]+|0b[0-1]+)\s*(#.*)*$", l)
+        if check is not None:
+            ipecc_hw_config[check.group(1)] = get_dec_hexa_bin_value(check.group(2))
+        line_num += 1
     ## Initialize our context with proper values
     context = IPECCExecutionContext(registers, flags, ip, lrip)
     with open(infile, "r") as f:
-        asm = f.read()
+        asm = expand_fpm(select_features(f.read()))
         # First pass to resolve the labels
         resolve_labels(asm)
         print("    -> First pass for labels resolution done")
         # Second pass for encoding opcodes
         (encoding, abstract_asm) = encode_opcodes(asm)
         print("    -> Second pass for opcode encoding done")
+        for k in ip_labels.keys():
+            if (ip_labels[k] + ":") not in ipecc_labels_dict.keys():
+                print_error("Error: ", "%s = %s" % (k, ip_labels[k]), " unknown label")
+                sys.exit(-1)
+            val = int(ipecc_labels_dict[ip_labels[k] + ":"][1], 16)
+            if k == "ip":
+                ip = val
+            elif k == "lrip":
+                lrip = val
+            else:
+                breakip = val
         # First, check if the asked address for ip and rip and breakip are indeed in our
         # range and classify our opcodes in an address base dictionnary
         abstract_asm_dict = {}
@@ -1618,14 +2075,33 @@ def emulate_file(infile, initial_state):
             context.breakip = breakip
         # Our execution loop
         stop = False
+        if timing is True:
+            emulate_ignore_patches = True
+            model = IPECCTimingModel(ipecc_hw_config)
+            barrier = False
+        # Address of the last opcode executed (a STOP is the S bit of
+        # the opcode preceding it, so it only counts if we got to it by
+        # falling through from that opcode, not by a jump or on start)
+        last_addr = None
         while True:
             # Execute in a loop
             all_ins_at_ip = abstract_asm_dict[context.ip]
             for ins in all_ins_at_ip:
                 (current_addr, instruction, OPTIONS, ABSTRACT_OPERANDS, l) = ins
+                if (instruction == "STOP") and (last_addr != (current_addr - 1)):
+                    continue
+                if ipecc_instructions_dict[instruction][1] != "PSEUDO":
+                    last_addr = current_addr
                 # Get the routine to execute
                 emulation_routine = ipecc_instructions_dict[instruction][4]
                 context = emulation_routine(ins, context)
+                if timing is True:
+                    if instruction == "BARRIER":
+                        barrier = True
+                    elif ipecc_instructions_dict[instruction][1] != "PSEUDO":
+                        ops = [(o[2] if o is not None else None) for o in ABSTRACT_OPERANDS]
+                        model.issue(instruction, OPTIONS, ops, barrier, context.ip != (current_addr + 1))
+                        barrier = False
                 if verbosity is not None:
                     print(context)
                 # Do we have to stop ?
@@ -1639,7 +2115,10 @@ def emulate_file(infile, initial_state):
                     break
             if stop is True:
                 break
-        print(context)
+        if timing is True:
+            model.report()
+        else:
+            print(context)
     return
 
 ##########################################################
@@ -1691,11 +2170,19 @@ def disassemble(binary):
             tt = ipecc_instructions_types_dict[t]
             e = ipecc_instructions_dict[ins][2]
             if (tt == instruction_type) and (e == instruction_opcode):
+                # Instructions sharing the same opcode differ by their
+                # implicit options
+                if ins in ipecc_implicit_options_dict.keys():
+                    if ('X' in ipecc_implicit_options_dict[ins]) != (X == "1"):
+                        continue
                 found_ins = ins
                 break
         if found_ins is None:
             print_error("Error line %d: %s: " % (line_num, l), "", "impossible to disassemble type %s / ins %s (unknown instruction)" % (instruction_type, instruction_opcode))
             sys.exit(-1)
+        # Implicit options are not to be printed
+        if found_ins in ipecc_implicit_options_dict.keys():
+            X = "0"
         # Get our semantics
         sem = ipecc_instructions_dict[found_ins][0]
         # Format our operands
@@ -1889,6 +2376,17 @@ def parse_vhdl(vhdl, vhdl_conf):
         check = re.search(r"constant\s+nbopcodes\s*:\s*positive\s*:=\s*([0-9]+)", l)
         if check is not None:
             nbopcodes = int(check.group(1))
+        ## Parameters of the timing model
+        check = re.search(r"constant\s+(nbmult|nbdsp|sramlat)\s*:\s*positive.*:=\s*([0-9]+)", l)
+        if check is not None:
+            ipecc_hw_config[check.group(1)] = int(check.group(2))
+        check = re.search(r"constant\s+(async|shuffle|fpaddsub|fpprefetch|fpsqr)\s*:\s*boolean\s*:=\s*(TRUE|FALSE)", l)
+        if check is not None:
+            ipecc_hw_config[check.group(1)] = int(check.group(2) == "TRUE")
+        ## Boolean parameters (for the .if directives of the microcode)
+        check = re.search(r"constant\s+([a-zA-Z0-9_]+)\s*:\s*boolean\s*:=\s*(TRUE|FALSE)", l)
+        if check is not None:
+            ipecc_hw_features[check.group(1)] = (check.group(2) == "TRUE")
         ## Bignum size
         check = re.search(r"constant\s+nn\s*:\s*positive\s*:=\s*([0-9]+)", l)
         if check is not None:
@@ -1963,7 +2461,7 @@ if len(sys.argv) > 3:
         parse_csv(csv)
 
 if len(sys.argv) < 3:
-    print_error("Error: ", "", "expecting -a (assemble) or -d (disassemble) or -e (execute) with at least the file")
+    print_error("Error: ", "", "expecting -a (assemble) or -d (disassemble) or -e (execute) or -c (count cycles) with at least the file")
     sys.exit(-1)
 
 if sys.argv[1] == "-a":
@@ -1981,6 +2479,12 @@ elif sys.argv[1] == "-e":
     initial_state = sys.stdin.read()
     print("  -> Emulation of file %s" % sys.argv[2])
     emulate_file(sys.argv[2], initial_state)
+elif sys.argv[1] == "-c":
+    ## Emulation with the timing model (cycle count)
+    print("  -> Reading initial state from stdin ...")
+    initial_state = sys.stdin.read()
+    print("  -> Cycle count of file %s" % sys.argv[2])
+    emulate_file(sys.argv[2], initial_state, timing=True)
 else:
-    print_error("Error: ", "", "unknown option '%s' (-a, -d or -e expected)" % sys.argv[1])
+    print_error("Error: ", "", "unknown option '%s' (-a, -d, -e or -c expected)" % sys.argv[1])
     sys.exit(-1)
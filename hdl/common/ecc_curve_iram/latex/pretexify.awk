@@ -10,6 +10,10 @@ BEGIN {
 		printf "\t%s\t%s\t%s\t%s\n", $1, $2, $3, $4
 	} else if ($1 ~ /NNSUB/){
 		printf "\t%s\t%s\t%s\t%s\n", $1, $2, $3, $4
+	} else if ($1 ~ /FPADD/){
+		printf "\t%s\t%s\t%s\t%s\n", $1, $2, $3, $4
+	} else if ($1 ~ /FPSUB/){
+		printf "\t%s\t%s\t%s\t%s\n", $1, $2, $3, $4
 	} else if ($1 ~ /FPREDC/){
 		printf "\t%s\t%s\t%s\t%s\n", $1, $2, $3, $4
 	} else if ($1 ~ /NNXOR/){
@@ -59,11 +59,29 @@ package ecc_customize is
 	constant trng_ramsz_fpr : positive := 4; -- in kB
 	constant trng_ramsz_crv : positive := 4; -- in kB
 	constant trng_ramsz_shf : positive := 16; -- in kB
+	-- ---------------------------------------------------
+	-- Optional features (not yet validated in simulation)
+	-- ---------------------------------------------------
+	constant fpaddsub : boolean := FALSE; -- fused FPADD/FPSUB opcodes
+	constant basepoint : boolean := FALSE; -- stored base point & [k]G command
+	constant dualkp : boolean := FALSE; -- [k1]P1 + [k2]P2 command (W_KP2)
+	constant projective : boolean := FALSE; -- CTRL_PT_PROJ & CTRL_PT_NORM
+	constant ptslots : boolean := FALSE; -- W_PT_SLOT & point staging
+	constant ashape : boolean := FALSE; -- a = 0 & a = -3 doublings (W_CURVE_A)
+	constant fieldops : boolean := FALSE; -- modular arithmetic (CTRL_FP_OP)
+	constant decompress : boolean := FALSE; -- point decompression (W_PT_DEC)
+	constant qcontext : boolean := FALSE; -- constants of q kept (W_MODULUS)
+	constant fpprefetch : boolean := FALSE; -- (only used if async = TRUE)
+	constant fpsqr : boolean := FALSE; -- dedicated REDC squarings
+	constant jobqueue : boolean := FALSE; -- 2**JOBQ_SZ entries (ecc_pkg)
+	constant dma : boolean := FALSE; -- AXI4 master port & ring of jobs
+	constant dmatoken : boolean := FALSE; -- DMA writes token in memory
+	constant nbengines : positive := 1; -- > 1: use top ecc_multi (not ecc)
 	-- -------------
 	-- Miscellaneous
 	-- -------------
 	constant axi32or64 : natural := 32; -- 32 or 64 only allowed values
-	constant nblargenb : positive := 32;  -- Change these two parameters only if
+	constant nblargenb : positive := 32;   -- Change these two parameters only if
 	constant nbopcodes : positive := 512; -- |you really know what you're doing.
 	-- --------------------------
 	-- Simulation-only parameters
@@ -455,6 +473,11 @@ end package ecc_customize;
 --           lity of single dual port (asynchronous) memories in your technolo-
 --           gical library.
 --
+--       Another benefit of 'async' = TRUE is that the input operands of the
+--       Montgomery multipliers then have their own memory, which parameter
+--       'fpprefetch' can double (see below) to overlap the transfer of the
+--       operands of an FPREDC with the previous multiplication.
+--
 --       Note having solely one clock-domain may be penalizing in FPGAs if the
 --       SoC and interconnect (the IP is connected to) imposes you to run at a
 --       low frequency. Values such as 100 or 150 MHz are typically found in
@@ -1218,6 +1241,521 @@ end package ecc_customize;
 --
 -- ============================================================================
 -- NAME
+--       'fpaddsub'
+--
+-- DEFINITION
+--       Option to have the modular additions & subtractions of the microcode
+--       executed as single opcodes (FPADD/FPSUB).
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       When set to TRUE, ecc_curve decodes the FPADD & FPSUB opcodes and
+--       ecc_fp chains by itself the correction (by 2p) that ends a modular
+--       addition or subtraction, sparing the round-trip through the fetch,
+--       decode & patch stages of ecc_curve between the two passes.
+--
+--       When set to FALSE (the default) the assembler (ecc_curve_iram/) ex-
+--       pands each FPADD (resp. FPSUB) of the microcode into the NNADD, NNSUB
+--       & NNADD,p5 (resp. NNSUB & NNADD,p5) sequence it stands for, which the
+--       IP executes as it always did, and ecc_curve rejects the FPADD/FPSUB
+--       opcode (error INVALID_OPCODE).
+--
+--       The gain is an estimate from the cycle model of the assembler
+--       (option -c of ecc_curve_iram/ipecc_assembler.py): for nn = 256 and
+--       nbmult = 2, about 90 cycles per bit of the [k]P ladder, i.e 1.5%,
+--       the routines being bound by the latency of FPREDC. No VHDL simula-
+--       tor was available when the option was written: the RTL of the fused
+--       opcodes was neither analyzed nor simulated and the [k]P duration
+--       that sim/ecc_tb.vhd prints was never measured with or without it.
+--       Mind to rebuild the microcode (make in ecc_curve_iram/) after any
+--       change of this parameter.
+--
+-- ============================================================================
+-- NAME
+--       'basepoint'
+--
+-- DEFINITION
+--       Option to have the IP multiply its stored base point (the [k]G com-
+--       mand) without software uploading the point again before each [k]P.
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       When set to TRUE, the KG bit of W_CTRL register copies the point
+--       stored in slot 0 of the resident point memory into R1 then starts a
+--       [k]P computation, and bit BP of R_CAPABILITIES register is set.
+--
+--       When set to FALSE (the default) bit BP reads 0 and a write of W_CTRL
+--       with bit KG set only raises error KP_FORBIDDEN. The driver then falls
+--       back on a plain [k]P with a point it converted once (see function
+--       hw_driver_mul_base()). Writes into the slots of the resident point
+--       memory (bit WRITE_BP of W_CTRL) are not affected by this parameter.
+--
+--       sim/ecc_tb.vhd covers the [k]G command (parameter TEST_KG, which
+--       follows this one): each [k]P of the test is followed by a [k]G with
+--       the same scalar and the results are compared (target
+--       'ecc_tb-basepoint' of sim/Makefile). This test was never run, as no
+--       VHDL simulator was available when the command was written.
+--
+-- ============================================================================
+-- NAME
+--       'dualkp'
+--
+-- DEFINITION
+--       Option to have the IP compute double scalar multiplications
+--       [k1]P1 + [k2]P2 with public scalars (command W_KP2).
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       When set to TRUE, the routines of ecc_curve_iram/asm_src/kp2.s are
+--       assembled into the microcode (Shamir's trick: one doubling per bit
+--       and one mixed addition per bit set in either scalar, not constant
+--       time) and bit KP2 of R_CAPABILITIES register is set.
+--
+--       When set to FALSE (the default) kp2.s is left out of the microcode
+--       (849 -> 675 opcodes with all other options set), bit KP2 reads 0 and
+--       writes of W_KP2 only raise error POP_FORBIDDEN. Function
+--       hw_driver_mul2() of the driver then computes [k1]P1 & [k2]P2 as two
+--       regular [k]P and adds them.
+--
+--       Neither the kp2.s routines nor the W_KP2 path of ecc_axi have been
+--       simulated yet, and sim/ecc_tb.vhd has no test of the W_KP2 command:
+--       target 'ecc_tb-dualkp' of sim/Makefile re-assembles the microcode with
+--       the option set and runs the other tests on it. Mind to rebuild the
+--       microcode (make in ecc_curve_iram/) after any change of this parameter.
+--
+--       Setting this parameter also requires 'nbopcodes' to be raised to
+--       1024 (see below).
+--
+-- ============================================================================
+-- NAME
+--       'projective'
+--
+-- DEFINITION
+--       Option to have the IP chain point additions and doublings in pro-
+--       jective form (bits CTRL_PT_PROJ & CTRL_PT_NORM of W_CTRL register).
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       When set to TRUE, a point addition or doubling issued with bit
+--       CTRL_PT_PROJ set leaves its result R1 in Co-Z Jacobian coordinates
+--       (Montgomery domain) and the next one takes it as is, so that a
+--       chain of operations only costs one inversion, that of the final
+--       CTRL_PT_NORM command. The routines of the chain (.addition_projL,
+--       .double_projL, .proj_normL & the ones they call) are assembled into
+--       the microcode and bit PROJ of R_CAPABILITIES register is set.
+--
+--       When set to FALSE (the default) these routines are left out of the
+--       microcode, bit PROJ reads 0 and a point addition or doubling with
+--       CTRL_PT_PROJ set, as well as CTRL_PT_NORM, only raises error
+--       POP_FORBIDDEN (the affine form of these operations is unaffected).
+--       The driver then runs each operation in affine form.
+--
+--       The projective routines and their handling in ecc_axi & ecc_scalar
+--       have not been simulated yet and sim/ecc_tb.vhd does not issue any
+--       projective operation: target 'ecc_tb-projective' of sim/Makefile
+--       only runs the other tests with the option set. Mind to rebuild the
+--       microcode (make in ecc_curve_iram/) after any change of this parameter.
+--
+--       Setting this parameter also requires 'nbopcodes' to be raised to
+--       1024 (see below).
+--
+-- ============================================================================
+-- NAME
+--       'ptslots'
+--
+-- DEFINITION
+--       Option to have software select, load & save the slots of the resident
+--       point memory, and stage points into them (W_PT_SLOT register).
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       The resident point memory holds 2**PT_SLOT_SZ affine points (see
+--       ecc_pkg), slot 0 being the base point of the [k]G command (see
+--       parameter 'basepoint').
+--
+--       When set to TRUE, writes of W_PT_SLOT register select the slot that
+--       the next writes of XR1/YR1 with CTRL_WRITE_BP go to, copy a slot
+--       into R0/R1 (PTSLOT_LOAD), copy R1 into a slot (PTSLOT_SAVE) or start
+--       a [k]P computation on a slot (PTSLOT_KP). A point can also be written
+--       into a slot while a [k]P is running, so that the next [k]P can start
+--       right after, without any transfer. Field SLOTS of R_CAPABILITIES
+--       register gives log2 of the number of slots.
+--
+--       When set to FALSE (the default) writes of W_PT_SLOT are refused
+--       (error WREG_FBD), CTRL_WRITE_BP writes are only accepted while the
+--       IP is idle and always go to slot 0, and field SLOTS reads 0. The
+--       driver then neither stages points nor offers point slots. This
+--       parameter has no effect on the microcode.
+--
+--       Only the staging path is exercised by sim/ecc_tb.vhd (parameter
+--       TEST_STAGE, which follows this one) and it has not been run yet:
+--       target 'ecc_tb-ptslots' of sim/Makefile runs it.
+--
+-- ============================================================================
+-- NAME
+--       'ashape'
+--
+-- DEFINITION
+--       Option to have the point doublings of the microcode take a shortcut
+--       when curve parameter 'a' is 0 or -3 (register W_CURVE_A).
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       When set to TRUE, software can declare in W_CURVE_A register that
+--       'a' is 0 (e.g secp256k1) or -3 (e.g the NIST curves). The doubling of
+--       the [k]P ladder (.dozdblL) and, if 'dualkp' is set, the one of the
+--       double scalar multiplication then branch (opcode JAS) to a variant
+--       that computes M = 3X^2 + a.Z^4 without the products by 'a' (and for
+--       a = 0, without Z^4). Bit AFAST of R_CAPABILITIES register is set.
+--
+--       When set to FALSE (the default) the JAS opcodes and the variants are
+--       left out of the microcode, writes of W_CURVE_A are refused (error
+--       WREG_FBD) and bit AFAST reads 0: all curves take the generic path,
+--       and the driver doesn't write W_CURVE_A.
+--
+--       The variants have not been simulated yet. sim/ecc_tb.vhd does not
+--       write W_CURVE_A either, so target 'ecc_tb-ashape' of sim/Makefile
+--       runs the tests on the generic path, with the option set. Mind to
+--       rebuild the microcode (make in ecc_curve_iram/) after any change of
+--       this parameter.
+--
+--       Setting this parameter also requires 'nbopcodes' to be raised to
+--       1024 (see below).
+--
+-- ============================================================================
+-- NAME
+--       'fieldops'
+--
+-- DEFINITION
+--       Option to have the IP perform single modular operations for software
+--       (bit CTRL_FP_OP of W_CTRL register).
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       When set to TRUE, XR1 <- XR0 op YR0 mod p can be computed for any of
+--       the 8 operations of field CTRL_FP_OPID (addition, subtraction,
+--       multiplication, inversion, exponentiation, conversions to & from
+--       Montgomery form...), 'p' being whatever modulus software wrote in
+--       place of the prime of the curve - the driver uses it modulo the
+--       order q of the curve. The routines of ecc_curve_iram/asm_src/fp-
+--       arith.s are assembled into the microcode and bit FOP of R_CAPABI-
+--       LITIES register is set.
+--
+--       When set to FALSE (the default) these routines are left out of the
+--       microcode, CTRL_FP_OP commands only raise error POP_FORBIDDEN and bit
+--       FOP reads 0: the hw_driver_fq_*() functions of the driver then
+--       return an error, leaving the arithmetic modulo q to the caller.
+--
+--       The routines have not been simulated yet and sim/ecc_tb.vhd issues no
+--       CTRL_FP_OP command: target 'ecc_tb-fieldops' of sim/Makefile only runs
+--       the other tests with the option set. Mind to rebuild the microcode
+--       (make in ecc_curve_iram/) after any change of this parameter.
+--
+--       Setting this parameter also requires 'nbopcodes' to be raised to
+--       1024 (see below).
+--
+-- ============================================================================
+-- NAME
+--       'decompress'
+--
+-- DEFINITION
+--       Option to have the IP compute the y-coordinate of a point from its
+--       x-coordinate and the parity of y (register W_PT_DEC).
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       When set to TRUE, the routines of ecc_curve_iram/asm_src/decompress.s
+--       are assembled into the microcode: YR1 is computed as (XR1^3 + a.XR1
+--       + b)^((p + 1) / 4), which only holds for p = 3 mod 4, and is squared
+--       back to tell whether XR1 is on the curve. Bit DEC of R_CAPABILITIES
+--       register is set.
+--
+--       When set to FALSE (the default) these routines are left out of the
+--       microcode, writes of W_PT_DEC only raise error POP_FORBIDDEN and bit
+--       DEC reads 0. The driver then decompresses points with the field
+--       arithmetic of the IP (Tonelli-Shanks, as it always does for p = 1
+--       mod 4) if parameter 'fieldops' is set, and fails otherwise.
+--
+--       The routines have not been simulated yet and sim/ecc_tb.vhd does not
+--       write W_PT_DEC: target 'ecc_tb-decompress' of sim/Makefile only runs
+--       the other tests with the option set. Mind to rebuild the microcode
+--       (make in ecc_curve_iram/) after any change of this parameter.
+--
+--       Setting this parameter also requires 'nbopcodes' to be raised to
+--       1024 (see below).
+--
+-- ============================================================================
+-- NAME
+--       'qcontext'
+--
+-- DEFINITION
+--       Option to have the IP keep the Montgomery constants of a second
+--       modulus, the order q of the curve, aside those of the prime p
+--       (register W_MODULUS).
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       When set to TRUE, each time the IP is done computing the Montgomery
+--       constants of the modulus it was given (p, or q in its place) it
+--       saves them, along with the modulus, in a context memory of its own
+--       (2 x 4 large numbers). Software selects the modulus in use with
+--       W_MODULUS: if the context of the modulus selected is valid (bit QCTX
+--       of R_STATUS register for q) it is copied back into the IP without
+--       any new computation, so that switching between arithmetic modulo p
+--       and modulo q (as an ECDSA signature does) no longer costs the two
+--       computations of R^2 mod p it otherwise does. 'a', 'b', the base
+--       point and the point slots are left untouched while q is in use, but
+--       point operations are refused until p is selected back. Bit QCTX of
+--       R_CAPABILITIES register is set.
+--
+--       The option also doubles the depth of the memory of each multiplier
+--       (the page holding the modulus and the one holding its Montgomery
+--       constant p' get one bank per modulus) and adds the context memory:
+--       it only has a use along with parameter 'fieldops' and it requires
+--       parameter 'async' to be set.
+--
+--       When set to FALSE (the default) writes of W_MODULUS only raise error
+--       WREG_FBD and bit QCTX reads 0: the driver then writes q in place of
+--       p, and p back again afterwards, as without the option.
+--
+--       The logic of this option has not been simulated (no VHDL simulator
+--       was at hand when it was written) and sim/ecc_tb.vhd does not write
+--       W_MODULUS: target 'ecc_tb-qcontext' of sim/Makefile only runs the
+--       other tests with the option set.
+--
+-- ============================================================================
+-- NAME
+--       'fpprefetch'
+--
+-- DEFINITION
+--       Option to transfer the operands of the next FPREDC to a Montgomery
+--       multiplier while it is still busy with the previous one.
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       Only used if 'async' = TRUE (it has no effect otherwise).
+--
+--       When set to TRUE, the memory of input operands of each Montgomery
+--       multiplier (IRAM, see mm_ndsp.vhd) gets twice as deep to hold two
+--       banks of X & Y operands, and ecc_fp queues one more FPREDC on a
+--       multiplier that is already computing: its operands are written in
+--       the other bank and the multiplication starts once the result of the
+--       current one has been read back.
+--
+--       When set to FALSE (the default) IRAM keeps its original size and an
+--       FPREDC waits for one multiplier to be idle, as it always did.
+--
+--       The gain depends on 'nbmult': with 2 multipliers the microcode seldom
+--       has more than 2 FPREDC in flight between two barriers, so it is below
+--       1% of the time of a Co-Z addition or doubling, while with 1 multiplier
+--       it is 2 to 4%. These figures are estimates from the timing model of
+--       the assembler (option -c of ecc_curve_iram/ipecc_assembler.py). The
+--       occupancy of the multipliers was never measured: no VHDL simulator
+--       was available when the option was written, and the bank switching it
+--       adds to mm_ndsp & ecc_fp has been neither analyzed nor simulated.
+--       Target 'ecc_tb-fpprefetch' of sim/Makefile runs the [k]P tests of
+--       sim/ecc_tb.vhd with the option set, but no test measures the
+--       occupancy itself.
+--
+-- SEE ALSO
+--       'async', 'nbmult'
+--
+-- ============================================================================
+-- NAME
+--       'fpsqr'
+--
+-- DEFINITION
+--       Option to have the FPREDC instructions the two operands of which are
+--       the same (squarings) executed as such by the Montgomery multipliers.
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       When set to TRUE, ecc_fp only transfers operand X of a squaring to the
+--       Montgomery multiplier (asserting its input 'sq') and mm_ndsp computes
+--       each cross-product x_i.x_j only once (see (s130) in mm_ndsp.vhd). With
+--       nbdsp = 6 & nn = 256 this brings a REDC from 359 down to 341 cycles in
+--       the multiplier, according to the timing model of the assembler (op-
+--       tion -c of ecc_curve_iram/ipecc_assembler.py).
+--
+--       When set to FALSE (the default) squarings are computed as any other
+--       product and input 'sq' of mm_ndsp is ignored.
+--
+--       The squaring path changes the arithmetic core of the multiplier, so
+--       it is checked bit for bit: testbench sim/mm_ndsp_tb.vhd compares the
+--       squarings of random operands (and of 0, 1, p - 1 & 2p - 1) modulo
+--       random primes with the products of the same operands computed the
+--       usual way, and with a reference model of REDC, then reports the
+--       cycle counts of both. Target 'mm_ndsp_tb' of sim/Makefile runs it for
+--       nn = 255, 256, 508 & 521 (most of them not a multiple of ww) and for
+--       the nn of this file. No VHDL simulator was available when the option
+--       was written: this testbench was never run, and the 341 cycles above
+--       are a figure of the model, not a measurement.
+--
+-- ============================================================================
+-- NAME
+--       'jobqueue'
+--
+-- DEFINITION
+--       Option to synthesize the job queue of ecc_axi (registers W_JOBQ_CTRL,
+--       R_JOBQ_STATUS & R_JOBQ_GAP), see (s292) in ecc_axi.vhd.
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       When set to TRUE, the IP holds 2**JOBQ_SZ entries (constant JOBQ_SZ
+--       in ecc_pkg.vhd) each made of the scalar, point & token of a [k]P job
+--       along with its result, and launches the jobs pushed by software one
+--       after the other, by itself.
+--
+--       When set to FALSE (the default) the two memories of the queue are not
+--       inferred, writes to W_JOBQ_CTRL are treated as writes to an unknown
+--       register, and both R_JOBQ_STATUS & R_JOBQ_GAP read as 0 (field NB of
+--       R_JOBQ_STATUS being 0, the driver does not use the queue, see
+--       hw_driver_mul_batch()).
+--
+--       What the queue is expected to save is the idle time of the IP while
+--       software reads back the result of a job & uploads the operands of
+--       the next one (R_JOBQ_GAP gives the number of cycles between the end
+--       of a job and the launch of the next one).
+--
+--       Testbench sim/ecc_tb.vhd (see TEST_JOBQ) pushes back-to-back jobs in
+--       the queue, checks their results & tokens against the ones of the same
+--       [k]P run with CTRL_KP and prints R_JOBQ_GAP (target 'ecc_tb-jobqueue'
+--       of sim/Makefile). No VHDL simulator was available when the queue was
+--       written: neither this test nor even the analysis of ecc_axi.vhd with
+--       the option set was ever run, so the gain above is not measured.
+--
+-- ============================================================================
+-- NAME
+--       'dma'
+--
+-- DEFINITION
+--       Option to add an AXI4 master port to the IP, through which it
+--       fetches by itself jobs described in a ring of descriptors in system
+--       memory.
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       When set to TRUE, component ecc_dma is inserted between the AXI-lite
+--       interface of the IP and ecc_axi. Software writes in system memory
+--       descriptors of jobs (e.g [k]P computations) pointing to their operands
+--       and result buffers, then simply gives the index of the last one to the
+--       IP (register W_DMA_TAIL). The IP then reads the operands, runs the
+--       jobs and writes back their results & status by itself, using its AXI4
+--       master port (the m_axi_* signals of entity 'ecc') and raising an
+--       interrupt at the end of each batch of jobs. The format of descriptors
+--       is described in ecc_dma.vhd.
+--
+--       This frees the CPU from the transfers of large numbers over the AXI-
+--       lite interface, which matters when many scalar multiplications are
+--       issued in a row. Descriptors have no field to select a curve: all
+--       jobs of the ring use the curve the IP holds when they run.
+--
+--       When set to FALSE (the default) the m_axi_* signals are left unused
+--       (output signals are driven low) and can be left unconnected.
+--
+--       Mind that the result of each [k]P computation is then written in
+--       system memory in the clear (see parameter 'dmatoken').
+--
+--       Testbench sim/ecc_tb.vhd emulates system memory behind the AXI4
+--       master port. It runs each [k]P test once more as a job of the ring
+--       (see TEST_DMA) and tests the ring itself after the first one (see
+--       TEST_DMA_RING): jobs queued across the end of the ring, ring disabled
+--       while a job runs, and a descriptor pointing beyond the emulated memory
+--       the error response of which must stop the ring (targets 'ecc_tb-dma'
+--       & 'ecc_tb-dmatoken' of sim/Makefile). These tests were written
+--       without a VHDL simulator at hand and were never run: ecc_dma.vhd has
+--       not even been analyzed, and no throughput was measured against the
+--       AXI-lite path.
+--
+-- ============================================================================
+-- NAME
+--       'dmatoken'
+--
+-- DEFINITION
+--       Option for the ring of jobs (parameter 'dma') to write the one-shot
+--       token of each job in system memory.
+--
+-- TYPE/VALUE
+--       Boolean (true or false). Default is FALSE.
+--
+-- DESCRIPTION
+--       When set to FALSE (the default) the token of a job of the ring is
+--       kept inside the IP, which unmasks the result with it before writing
+--       it back: results then travel over the AXI4 master port and sit in
+--       system memory in the clear, but the token never leaves the IP.
+--
+--       When set to TRUE the token is written in system memory (in the buffer
+--       pointed to by the job descriptor) and the result is written back
+--       masked by it, to be unmasked by software. As both lie side by side in
+--       the same memory, the token then no longer protects the result from an
+--       agent able to read that memory.
+--
+--       This parameter is ignored when parameter 'dma' is FALSE.
+--
+-- ============================================================================
+-- NAME
+--       'nbengines'
+--
+-- DEFINITION
+--       Number of complete [k]P engines instanciated in top-level ecc_multi.
+--
+-- TYPE/VALUE
+--       Integer, from 1 to 16. Default is 1.
+--
+-- DESCRIPTION
+--       Top-level 'ecc' instanciates exactly one engine (i.e one set of
+--       ecc_axi, ecc_scalar, ecc_curve, ecc_fp & mm_ndsp components) and this
+--       parameter is ignored by it. To get several engines working in parallel,
+--       use top-level 'ecc_multi' instead, which instanciates 'nbengines' of
+--       them behind one AXI-lite interface, along with one TRNG shared by
+--       all (see ecc_multi.vhd for the address map, which is made of one
+--       window of registers per engine, and for the hardware dispatcher that
+--       hands the jobs submitted by software to idle engines).
+--
+--       Throughput of [k]P computations is then expected to scale with the
+--       number of engines, as long as software keeps all of them busy and the
+--       shared TRNG provides enough entropy (its rate is unchanged). This
+--       scaling has not been measured.
+--
+--       Parameter 'dma' must be FALSE when using ecc_multi.
+--
+--       Testbench sim/ecc_tb.vhd runs each [k]P test once more on all engines
+--       of ecc_multi at once (see TEST_MULTI): it displays the ratio of the
+--       throughput to the one of a single job, and checks each result against
+--       the job it is handed back for, jobs of odd rank computing [k](-P).
+--       Target 'ecc_tb-multi1' of sim/Makefile elaborates ecc_multi with one
+--       engine, target 'ecc_tb-multi2' runs the test with two. ecc_multi.vhd
+--       was written without a VHDL simulator at hand: it has never been
+--       analyzed nor elaborated, and neither target was ever run.
+--
+-- ============================================================================
+-- NAME
 --       'axi32or64'
 --
 -- DEFINITION
@@ -1354,8 +1892,9 @@ end package ecc_customize;
 --       opcodes.
 --
 -- TYPE/VALUE
---       Integer. Default is 512. Same as 'nblargenb' above: obviously keep it
---       a power of 2.
+--       Integer. Default is 512. Same as 'nblargenb' above: obviously keep
+--       it a power of 2 (and no smaller than the number of opcodes of the
+--       microcode, see below).
 --
 -- DESCRIPTION
 --       Note that this is not a memory size in bytes or bits or whatever
@@ -1364,6 +1903,18 @@ end package ecc_customize;
 --       physical size of the microcode memory will be given by 512 x 32 bit
 --       = 16 Kbit (assuming the default of 512 for parameter 'nbopcodes').
 --
+--       The size of the microcode depends on the configuration: the
+--       assembler (see ecc_curve_iram/) prints the number of opcodes of the
+--       program it generates, and stops with an error if it is larger than
+--       'nbopcodes'. With the default configuration the program is 506
+--       opcodes long (460 with 'fpaddsub'). Each of the options 'dualkp',
+--       'projective', 'ashape', 'fieldops' & 'decompress' adds its own
+--       routines (from 30 to 174 opcodes), and any of them is enough for the
+--       program to exceed 512 opcodes (849 with all of them): set 'nbopcodes'
+--       to 1024 along with them. This doubles the microcode memory (on
+--       Xilinx 7-series one RAMB36 instead of one RAMB18, and twice the size
+--       of the memory macro on an ASIC).
+--
 --       Please refer to the discussion above for parameter 'nblargenb',
 --       as it also widely applies to 'nbopcodes'.
 --
@@ -0,0 +1,1024 @@
+--
+--  Copyright (C) 2023 - This file is part of IPECC project
+--
+--  Authors:
+--      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+--      Ryad BENADJILA <ryadbenadjila@gmail.com>
+--
+--  Contributors:
+--      Adrian THILLARD
+--      Emmanuel PROUFF
+--
+--  This software is licensed under GPL v2 license.
+--  See LICENSE file at the root folder of the project.
+--
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+use work.ecc_customize.all;
+use work.ecc_utils.all;
+use work.ecc_pkg.all;
+use work.ecc_software.all;
+
+-- Ring of job descriptors in system memory (only instanciated when parameter
+-- 'dma' is set in ecc_customize).
+--
+-- ecc_dma sits between the AXI-lite interface of the IP and ecc_axi. It
+-- forwards to ecc_axi all register accesses from software, except those
+-- targeting its own registers (W_DMA_RING, W_DMA_CTRL, W_DMA_TAIL, R_DMA_STATUS
+-- & R_DMA_HEAD) which it handles by itself. Once enabled, it processes jobs
+-- described in a ring of descriptors in system memory: operands are fetched
+-- and results are written back through the AXI4 master port, and in between
+-- ecc_axi is driven with the very same sequence of register accesses as the
+-- one the software driver would issue (so that ecc_axi is not modified).
+--
+-- A descriptor is made of 8 fields of 32 bits (DMA_DESC_* in ecc_software):
+--
+--   0  FLAGS   bit DMA_FLAG_TOKEN: get a token (see below)
+--              bit DMA_FLAG_K: write the scalar from buffer K
+--              bit DMA_FLAG_PT: write R1 from buffers X & Y (R1 set not null)
+--              bit DMA_FLAG_RES: read R1 back into buffer RES (X then Y)
+--              bit DMA_FLAG_IRQ: raise the interrupt once the job is done
+--   1  CTRL    value written to W_CTRL to start the operation (none if 0)
+--   2  K       address of buffer K
+--   3  X       address of buffer X
+--   4  Y       address of buffer Y
+--   5  RES     address of buffer RES
+--   6  TOKEN   address of buffer TOKEN
+--   7  STATUS  written back by the IP at the end of the job: value of R_STATUS
+--              with bit DMA_DESC_DONE (= STATUS_BUSY, low at that time) set
+--
+-- Steps are done in the order of the flags above (e.g a [k]P computation is
+-- described with all flags set and CTRL = W_CTRL.KP). Buffers hold large
+-- numbers in the format of registers W_WRITE_DATA/R_READ_DATA: 'nbw' words
+-- (field DMA_NBW of W_DMA_CTRL, 0 standing for the max) of the size of the
+-- AXI data bus, the least significant one first. Neither the ring nor a buffer may cross a 4 kB
+-- boundary (bursts are not split).
+--
+-- Unless parameter 'dmatoken' is set in ecc_customize, the token fetched
+-- with DMA_FLAG_TOKEN is kept inside ecc_dma and never written to system
+-- memory: the result is unmasked with it before being written back in buffer
+-- RES, hence it then travels & sits in memory in the clear (buffer TOKEN is
+-- left untouched). With 'dmatoken' set, the token is written in buffer TOKEN
+-- and the result is written back masked, as ecc_axi hands it over.
+--
+-- The ring holds 2**lgsz descriptors (field DMA_LGSZ of W_DMA_CTRL) from
+-- address W_DMA_RING (aligned on 32 bytes). Software writes in W_DMA_TAIL the
+-- index that follows the last descriptor it queued and the IP processes all
+-- descriptors from index R_DMA_HEAD up to this one (excluded). The ring is
+-- empty when both indexes are equal, hence it holds at most 2**lgsz - 1 jobs.
+--
+-- Errors raised by ecc_axi during a job are reported in its STATUS field and
+-- acknowledged, so that the next job starts clean. An error response on the
+-- AXI4 master port sets bit BERR of R_DMA_STATUS (and raises the interrupt):
+-- no other descriptor is fetched until software writes W_DMA_CTRL again.
+--
+-- Register accesses from software are served in between those of the ring
+-- jobs, which are not atomic: software should leave the IP alone (apart from
+-- the registers of ecc_dma and R_STATUS) while the ring is not empty.
+
+entity ecc_dma is
+	generic(
+		-- width of AXI data buses (AXI-lite & AXI4)
+		C_S_AXI_DATA_WIDTH : integer := axi32or64; -- in ecc_customize
+		-- width of AXI-lite address bus
+		C_S_AXI_ADDR_WIDTH : integer := AXIAW); -- in ecc_pkg
+	port(
+		-- AXI clock & reset
+		clk : in std_logic;
+		rstn : in std_logic;
+		-- AXI-lite slave interface (from the system)
+		s_axi_awaddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+		s_axi_awvalid : in std_logic;
+		s_axi_awready : out std_logic;
+		s_axi_wdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		s_axi_wvalid : in std_logic;
+		s_axi_wready : out std_logic;
+		s_axi_bvalid : out std_logic;
+		s_axi_bready : in std_logic;
+		s_axi_araddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+		s_axi_arvalid : in std_logic;
+		s_axi_arready : out std_logic;
+		s_axi_rdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		s_axi_rvalid : out std_logic;
+		s_axi_rready : in std_logic;
+		-- AXI-lite master interface (to ecc_axi)
+		e_axi_awaddr : out std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+		e_axi_awvalid : out std_logic;
+		e_axi_awready : in std_logic;
+		e_axi_wdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		e_axi_wvalid : out std_logic;
+		e_axi_wready : in std_logic;
+		e_axi_bvalid : in std_logic;
+		e_axi_bready : out std_logic;
+		e_axi_araddr : out std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+		e_axi_arvalid : out std_logic;
+		e_axi_arready : in std_logic;
+		e_axi_rdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		e_axi_rvalid : in std_logic;
+		e_axi_rready : out std_logic;
+		-- AXI4 master interface (to system memory)
+		m_axi_awaddr : out std_logic_vector(31 downto 0);
+		m_axi_awlen : out std_logic_vector(7 downto 0);
+		m_axi_awsize : out std_logic_vector(2 downto 0);
+		m_axi_awburst : out std_logic_vector(1 downto 0);
+		m_axi_awcache : out std_logic_vector(3 downto 0);
+		m_axi_awprot : out std_logic_vector(2 downto 0);
+		m_axi_awvalid : out std_logic;
+		m_axi_awready : in std_logic;
+		m_axi_wdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		m_axi_wstrb : out std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+		m_axi_wlast : out std_logic;
+		m_axi_wvalid : out std_logic;
+		m_axi_wready : in std_logic;
+		m_axi_bresp : in std_logic_vector(1 downto 0);
+		m_axi_bvalid : in std_logic;
+		m_axi_bready : out std_logic;
+		m_axi_araddr : out std_logic_vector(31 downto 0);
+		m_axi_arlen : out std_logic_vector(7 downto 0);
+		m_axi_arsize : out std_logic_vector(2 downto 0);
+		m_axi_arburst : out std_logic_vector(1 downto 0);
+		m_axi_arcache : out std_logic_vector(3 downto 0);
+		m_axi_arprot : out std_logic_vector(2 downto 0);
+		m_axi_arvalid : out std_logic;
+		m_axi_arready : in std_logic;
+		m_axi_rdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		m_axi_rresp : in std_logic_vector(1 downto 0);
+		m_axi_rlast : in std_logic;
+		m_axi_rvalid : in std_logic;
+		m_axi_rready : out std_logic;
+		-- interrupt (pulse, at the end of each job flagged DMA_FLAG_IRQ)
+		irq : out std_logic
+	);
+end entity ecc_dma;
+
+architecture rtl of ecc_dma is
+
+	constant DW : positive := C_S_AXI_DATA_WIDTH;
+	-- nb of 32-bit fields of a descriptor per AXI data word
+	constant FPW : positive := DW / 32;
+	-- nb of AXI data words of a descriptor
+	constant DESC_BEATS : positive := (DMA_DESC_SZ * 8) / DW;
+	-- max nb of words of a large number
+	constant NBW_MAX : positive := div(nn, DW);
+	constant NBUF : positive := max(NBW_MAX, DESC_BEATS);
+	-- lane of field DMA_DESC_STATUS in its AXI data word
+	constant STFLD : natural := DMA_DESC_STATUS mod FPW;
+
+	type buf_type is array(0 to NBUF - 1) of
+		std_logic_vector(DW - 1 downto 0);
+
+	-- W_CTRL value for the selection of a large number
+	function ctrl_nb(b0, b1 : natural; addr : stdop)
+		return std_logic_vector is
+		variable w : std_logic_vector(31 downto 0);
+	begin
+		w := (others => '0');
+		w(b0) := '1';
+		w(b1) := '1';
+		w(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB) := addr;
+		return w;
+	end function ctrl_nb;
+
+	constant CTRL_RD_TOK : std_logic_vector(31 downto 0) :=
+		ctrl_nb(CTRL_READ_NB, CTRL_RD_TOKEN, std_nat(0, FP_ADDR_MSB));
+	constant CTRL_WR_K : std_logic_vector(31 downto 0) :=
+		ctrl_nb(CTRL_WRITE_NB, CTRL_WRITE_K, CST_ADDR_K);
+	constant CTRL_WR_XR1 : std_logic_vector(31 downto 0) :=
+		ctrl_nb(CTRL_WRITE_NB, CTRL_WRITE_NB, CST_ADDR_XR1);
+	constant CTRL_WR_YR1 : std_logic_vector(31 downto 0) :=
+		ctrl_nb(CTRL_WRITE_NB, CTRL_WRITE_NB, CST_ADDR_YR1);
+	constant CTRL_RD_XR1 : std_logic_vector(31 downto 0) :=
+		ctrl_nb(CTRL_READ_NB, CTRL_READ_NB, CST_ADDR_XR1);
+	constant CTRL_RD_YR1 : std_logic_vector(31 downto 0) :=
+		ctrl_nb(CTRL_READ_NB, CTRL_READ_NB, CST_ADDR_YR1);
+
+	-- value of AxSIZE for full-width beats
+	function set_axsize return std_logic_vector is
+	begin
+		if DW = 64 then
+			return "011";
+		else
+			return "010";
+		end if;
+	end function set_axsize;
+
+	type state_type is
+		(idle, parse,
+		 -- steps of a job
+		 tok0, tok1, tok2, tok3, k0, k1, k2, x0, x1, x2, y0, y1, y2, y3,
+		 go0, go1, rx0, rx1, rx2, ry0, ry1, ry2, st0, st1, st2, st3,
+		 -- (leaf) subroutines, returning to state r.ret:
+		 --   poll R_STATUS until BUSY is low, then write one register
+		 --   (unless r.lw.wr is low)
+		 lwpoll, lwpchk, lwwrite, lwwait,
+		 --   write r.nbw words of the buffer into W_WRITE_DATA
+		 push, pushwait,
+		 --   read r.nbw words from R_READ_DATA into the buffer
+		 pull, pullwait,
+		 --   wait for the end of the memory burst in progress
+		 memwait);
+
+	-- AXI-lite slave side
+	type reg_s_type is record
+		awready : std_logic;
+		wready : std_logic;
+		bvalid : std_logic;
+		arready : std_logic;
+		rvalid : std_logic;
+		awpending : std_logic;
+		dwpending : std_logic;
+		arpending : std_logic;
+		waddr : rat;
+		wdata : std_logic_vector(DW - 1 downto 0);
+		raddr : rat;
+		rdata : std_logic_vector(DW - 1 downto 0);
+		fwdw : std_logic; -- write to be forwarded to ecc_axi
+		fwdr : std_logic; -- read to be forwarded to ecc_axi
+	end record;
+
+	-- AXI-lite master side (one transaction at a time, shared between
+	-- forwarded accesses of software and those of the ring jobs)
+	type reg_lite_type is record
+		busy : std_logic;
+		rw : std_logic; -- 1 = write
+		ext : std_logic; -- 1 = forwarded access of software
+		addr : rat;
+		wdata : std_logic_vector(DW - 1 downto 0);
+		awvalid : std_logic;
+		wvalid : std_logic;
+		arvalid : std_logic;
+		rdata : std_logic_vector(DW - 1 downto 0);
+		done : std_logic; -- end of a transaction of the ring jobs (strobe)
+	end record;
+
+	-- AXI4 master side (one burst at a time)
+	type reg_mem_type is record
+		busy : std_logic;
+		addr : unsigned(31 downto 0);
+		len : natural range 0 to NBUF - 1;
+		cnt : natural range 0 to NBUF - 1;
+		arvalid : std_logic;
+		rready : std_logic;
+		awvalid : std_logic;
+		wvalid : std_logic;
+		wlast : std_logic;
+		wdata : std_logic_vector(DW - 1 downto 0);
+		wstrb : std_logic_vector((DW/8) - 1 downto 0);
+	end record;
+
+	-- register access of subroutine lw*
+	type reg_lw_type is record
+		wr : std_logic;
+		addr : rat;
+		data : std_logic_vector(31 downto 0);
+	end record;
+
+	-- current descriptor
+	type reg_desc_type is record
+		addr : unsigned(31 downto 0);
+		flags : std_logic_vector(31 downto 0);
+		ctrl : std_logic_vector(31 downto 0);
+		k, x, y, res, token : unsigned(31 downto 0);
+	end record;
+
+	type reg_type is record
+		s : reg_s_type;
+		lite : reg_lite_type;
+		mem : reg_mem_type;
+		lw : reg_lw_type;
+		desc : reg_desc_type;
+		state : state_type;
+		ret : state_type;
+		buf : buf_type;
+		cnt : natural range 0 to NBUF - 1;
+		-- token of the current job, kept inside (dmatoken = FALSE)
+		tok : buf_type;
+		tokin : std_logic; -- tok holds the token of the current job
+		unmask : std_logic; -- subroutine pull unmasks words with tok
+		status : std_logic_vector(31 downto 0); -- last value of R_STATUS
+		-- software registers
+		en : std_logic;
+		irqen : std_logic;
+		lgsz : unsigned(DMA_LGSZ_MSB - DMA_LGSZ_LSB downto 0);
+		nbw : natural range 1 to NBW_MAX;
+		ring : unsigned(31 downto 0);
+		head : unsigned(15 downto 0);
+		tail : unsigned(15 downto 0);
+		berr : std_logic;
+		active : std_logic;
+		-- interrupt
+		irq : std_logic;
+		irqsh : std_logic_vector(3 downto 0);
+	end record;
+
+	signal r, rin : reg_type;
+
+begin
+
+	-- pragma translate_off
+	assert (DW = 32 or DW = 64)
+		report "ecc_dma: AXI data width must be 32 or 64"
+			severity FAILURE;
+	assert (NBW_MAX < 256)
+		report "ecc_dma: large numbers do not fit in one AXI4 burst"
+			severity FAILURE;
+	-- pragma translate_on
+
+	comb: process(r, rstn,
+	              s_axi_awaddr, s_axi_awvalid, s_axi_wdata, s_axi_wvalid,
+	              s_axi_bready, s_axi_araddr, s_axi_arvalid, s_axi_rready,
+	              e_axi_awready, e_axi_wready, e_axi_bvalid, e_axi_arready,
+	              e_axi_rdata, e_axi_rvalid,
+	              m_axi_awready, m_axi_wready, m_axi_bresp, m_axi_bvalid,
+	              m_axi_arready, m_axi_rdata, m_axi_rresp, m_axi_rlast,
+	              m_axi_rvalid)
+		variable v : reg_type;
+		variable v_mask : unsigned(15 downto 0);
+		variable v_lite_free : boolean;
+	begin
+		v := r;
+
+		-- mask of ring indexes
+		v_mask := (others => '0');
+		for i in 0 to 15 loop
+			if i < to_integer(r.lgsz) then
+				v_mask(i) := '1';
+			end if;
+		end loop;
+
+		-- interrupt pulse (same duration as the one of ecc_axi)
+		v.irqsh := '0' & r.irqsh(3 downto 1);
+		if r.irqsh(0) = '1' then
+			v.irq := '0';
+		end if;
+
+		-- ------------------------------------------------------------
+		--             A X I - l i t e   m a s t e r   s i d e
+		-- ------------------------------------------------------------
+		v.lite.done := '0';
+		if r.lite.awvalid = '1' and e_axi_awready = '1' then
+			v.lite.awvalid := '0';
+		end if;
+		if r.lite.wvalid = '1' and e_axi_wready = '1' then
+			v.lite.wvalid := '0';
+		end if;
+		if r.lite.arvalid = '1' and e_axi_arready = '1' then
+			v.lite.arvalid := '0';
+		end if;
+		-- (BREADY & RREADY are always high)
+		if r.lite.busy = '1' and ((r.lite.rw = '1' and e_axi_bvalid = '1')
+		                       or (r.lite.rw = '0' and e_axi_rvalid = '1'))
+		then
+			v.lite.busy := '0';
+			v.lite.rdata := e_axi_rdata;
+			if r.lite.ext = '1' then
+				-- response to software
+				if r.lite.rw = '1' then
+					v.s.bvalid := '1';
+				else
+					v.s.rdata := e_axi_rdata;
+					v.s.rvalid := '1';
+				end if;
+			else
+				v.lite.done := '1';
+			end if;
+		end if;
+
+		-- ------------------------------------------------------------
+		--              A X I - l i t e   s l a v e   s i d e
+		-- ------------------------------------------------------------
+		if s_axi_awvalid = '1' and r.s.awready = '1' then
+			v.s.awpending := '1';
+			v.s.waddr := s_axi_awaddr(C_S_AXI_ADDR_WIDTH - 1 downto 3);
+			v.s.awready := '0';
+		end if;
+		if s_axi_wvalid = '1' and r.s.wready = '1' then
+			v.s.dwpending := '1';
+			v.s.wdata := s_axi_wdata;
+			v.s.wready := '0';
+		end if;
+		if r.s.bvalid = '1' and s_axi_bready = '1' then
+			v.s.bvalid := '0';
+			v.s.awready := '1';
+			v.s.wready := '1';
+		end if;
+		if s_axi_arvalid = '1' and r.s.arready = '1' then
+			v.s.arpending := '1';
+			v.s.raddr := s_axi_araddr(C_S_AXI_ADDR_WIDTH - 1 downto 3);
+			v.s.arready := '0';
+		end if;
+		if r.s.rvalid = '1' and s_axi_rready = '1' then
+			v.s.rvalid := '0';
+			v.s.arready := '1';
+		end if;
+
+		-- writes: registers of ecc_dma are handled here, all others are
+		-- forwarded to ecc_axi
+		if r.s.awpending = '1' and r.s.dwpending = '1' then
+			v.s.awpending := '0';
+			v.s.dwpending := '0';
+			if r.s.waddr = W_DMA_RING then
+				v.ring := unsigned(r.s.wdata(31 downto 5)) & "00000";
+				v.s.bvalid := '1';
+			elsif r.s.waddr = W_DMA_CTRL then
+				v.en := r.s.wdata(DMA_EN);
+				v.irqen := r.s.wdata(DMA_IRQEN);
+				v.lgsz := unsigned(r.s.wdata(DMA_LGSZ_MSB downto DMA_LGSZ_LSB));
+				if to_integer(unsigned(r.s.wdata(DMA_NBW_MSB downto DMA_NBW_LSB)))
+					> NBW_MAX or r.s.wdata(DMA_NBW_MSB downto DMA_NBW_LSB) =
+					std_nat(0, DMA_NBW_MSB - DMA_NBW_LSB + 1)
+				then
+					v.nbw := NBW_MAX;
+				else
+					v.nbw :=
+						to_integer(unsigned(r.s.wdata(DMA_NBW_MSB downto DMA_NBW_LSB)));
+				end if;
+				v.berr := '0';
+				v.s.bvalid := '1';
+			elsif r.s.waddr = W_DMA_TAIL then
+				v.tail := unsigned(r.s.wdata(15 downto 0)) and v_mask;
+				v.s.bvalid := '1';
+			else
+				v.s.fwdw := '1';
+			end if;
+		end if;
+
+		-- reads: same
+		if r.s.arpending = '1' then
+			v.s.arpending := '0';
+			if r.s.raddr = R_DMA_STATUS then
+				v.s.rdata := (others => '0');
+				v.s.rdata(DMA_STATUS_ACTIVE) := r.active;
+				v.s.rdata(DMA_STATUS_BERR) := r.berr;
+				v.s.rvalid := '1';
+			elsif r.s.raddr = R_DMA_HEAD then
+				v.s.rdata := (others => '0');
+				v.s.rdata(15 downto 0) := std_logic_vector(r.head);
+				v.s.rvalid := '1';
+			else
+				v.s.fwdr := '1';
+			end if;
+		end if;
+
+		-- forwarded accesses have priority over those of the ring jobs
+		if v.lite.busy = '0' then
+			if v.s.fwdw = '1' then
+				v.s.fwdw := '0';
+				v.lite.busy := '1';
+				v.lite.rw := '1';
+				v.lite.ext := '1';
+				v.lite.addr := r.s.waddr;
+				v.lite.wdata := r.s.wdata;
+				v.lite.awvalid := '1';
+				v.lite.wvalid := '1';
+			elsif v.s.fwdr = '1' then
+				v.s.fwdr := '0';
+				v.lite.busy := '1';
+				v.lite.rw := '0';
+				v.lite.ext := '1';
+				v.lite.addr := r.s.raddr;
+				v.lite.arvalid := '1';
+			end if;
+		end if;
+		v_lite_free := (v.lite.busy = '0');
+
+		-- ------------------------------------------------------------
+		--                 A X I 4   m a s t e r   s i d e
+		-- ------------------------------------------------------------
+		-- read burst
+		if r.mem.arvalid = '1' and m_axi_arready = '1' then
+			v.mem.arvalid := '0';
+		end if;
+		if r.mem.rready = '1' and m_axi_rvalid = '1' then
+			v.buf(r.mem.cnt) := m_axi_rdata;
+			if r.mem.cnt < NBUF - 1 then
+				v.mem.cnt := r.mem.cnt + 1;
+			end if;
+			if m_axi_rresp(1) = '1' then
+				v.berr := '1';
+			end if;
+			if m_axi_rlast = '1' then
+				v.mem.rready := '0';
+				v.mem.busy := '0';
+			end if;
+		end if;
+		-- write burst
+		if r.mem.awvalid = '1' and m_axi_awready = '1' then
+			v.mem.awvalid := '0';
+		end if;
+		if r.mem.wvalid = '1' and m_axi_wready = '1' then
+			if r.mem.wlast = '1' then
+				v.mem.wvalid := '0';
+				v.mem.wlast := '0';
+			else
+				v.mem.cnt := r.mem.cnt + 1;
+				v.mem.wdata := r.buf(r.mem.cnt + 1);
+				if r.mem.cnt + 1 = r.mem.len then
+					v.mem.wlast := '1';
+				end if;
+			end if;
+		end if;
+		-- (BREADY is always high)
+		if r.mem.busy = '1' and r.mem.rready = '0' and r.mem.arvalid = '0'
+			and r.mem.wvalid = '0' and m_axi_bvalid = '1'
+		then
+			if m_axi_bresp(1) = '1' then
+				v.berr := '1';
+			end if;
+			v.mem.busy := '0';
+		end if;
+
+		-- ------------------------------------------------------------
+		--                       R i n g   j o b s
+		-- ------------------------------------------------------------
+		case r.state is
+
+			when idle =>
+				v.active := '0';
+				if r.en = '1' and r.berr = '0' and r.head /= r.tail then
+					v.active := '1';
+					-- fetch the descriptor
+					v.desc.addr := r.ring + shift_left(resize(r.head, 32), 5);
+					v.mem.addr := r.ring + shift_left(resize(r.head, 32), 5);
+					v.mem.len := DESC_BEATS - 1;
+					v.mem.cnt := 0;
+					v.mem.busy := '1';
+					v.mem.arvalid := '1';
+					v.mem.rready := '1';
+					v.state := memwait;
+					v.ret := parse;
+				end if;
+
+			when parse =>
+				v.desc.flags := r.buf(DMA_DESC_FLAGS / FPW)(
+					((DMA_DESC_FLAGS mod FPW) * 32) + 31 downto
+					(DMA_DESC_FLAGS mod FPW) * 32);
+				v.desc.ctrl := r.buf(DMA_DESC_CTRL / FPW)(
+					((DMA_DESC_CTRL mod FPW) * 32) + 31 downto
+					(DMA_DESC_CTRL mod FPW) * 32);
+				v.desc.k := unsigned(r.buf(DMA_DESC_K / FPW)(
+					((DMA_DESC_K mod FPW) * 32) + 31 downto
+					(DMA_DESC_K mod FPW) * 32));
+				v.desc.x := unsigned(r.buf(DMA_DESC_X / FPW)(
+					((DMA_DESC_X mod FPW) * 32) + 31 downto
+					(DMA_DESC_X mod FPW) * 32));
+				v.desc.y := unsigned(r.buf(DMA_DESC_Y / FPW)(
+					((DMA_DESC_Y mod FPW) * 32) + 31 downto
+					(DMA_DESC_Y mod FPW) * 32));
+				v.desc.res := unsigned(r.buf(DMA_DESC_RES / FPW)(
+					((DMA_DESC_RES mod FPW) * 32) + 31 downto
+					(DMA_DESC_RES mod FPW) * 32));
+				v.desc.token := unsigned(r.buf(DMA_DESC_TOKEN / FPW)(
+					((DMA_DESC_TOKEN mod FPW) * 32) + 31 downto
+					(DMA_DESC_TOKEN mod FPW) * 32));
+				v.tokin := '0';
+				v.state := tok0;
+
+			-- token
+			when tok0 =>
+				if r.desc.flags(DMA_FLAG_TOKEN) = '1' then
+					v.lw.wr := '1';
+					v.lw.addr := W_TOKEN;
+					v.lw.data := (others => '0');
+					v.state := lwpoll;
+					v.ret := tok1;
+				else
+					v.state := k0;
+				end if;
+			when tok1 =>
+				v.lw.wr := '1';
+				v.lw.addr := W_CTRL;
+				v.lw.data := CTRL_RD_TOK;
+				v.state := lwpoll;
+				v.ret := tok2;
+			when tok2 =>
+				v.cnt := 0;
+				v.unmask := '0';
+				v.state := pull;
+				v.ret := tok3;
+			when tok3 =>
+				if dmatoken then -- statically resolved by synthesizer
+					v.mem.addr := r.desc.token;
+					v.mem.len := r.nbw - 1;
+					v.mem.cnt := 0;
+					v.mem.busy := '1';
+					v.mem.awvalid := '1';
+					v.mem.wvalid := '1';
+					v.mem.wdata := r.buf(0);
+					v.mem.wstrb := (others => '1');
+					if r.nbw = 1 then
+						v.mem.wlast := '1';
+					end if;
+					v.state := memwait;
+					v.ret := k0;
+				else
+					-- keep the token to unmask the result (steps rx* & ry*)
+					v.tok := r.buf;
+					v.tokin := '1';
+					v.state := k0;
+				end if;
+
+			-- scalar
+			when k0 =>
+				if r.desc.flags(DMA_FLAG_K) = '1' then
+					v.mem.addr := r.desc.k;
+					v.mem.len := r.nbw - 1;
+					v.mem.cnt := 0;
+					v.mem.busy := '1';
+					v.mem.arvalid := '1';
+					v.mem.rready := '1';
+					v.state := memwait;
+					v.ret := k1;
+				else
+					v.state := x0;
+				end if;
+			when k1 =>
+				v.lw.wr := '1';
+				v.lw.addr := W_CTRL;
+				v.lw.data := CTRL_WR_K;
+				v.state := lwpoll;
+				v.ret := k2;
+			when k2 =>
+				v.cnt := 0;
+				v.state := push;
+				v.ret := x0;
+
+			-- point
+			when x0 =>
+				if r.desc.flags(DMA_FLAG_PT) = '1' then
+					v.mem.addr := r.desc.x;
+					v.mem.len := r.nbw - 1;
+					v.mem.cnt := 0;
+					v.mem.busy := '1';
+					v.mem.arvalid := '1';
+					v.mem.rready := '1';
+					v.state := memwait;
+					v.ret := x1;
+				else
+					v.state := go0;
+				end if;
+			when x1 =>
+				v.lw.wr := '1';
+				v.lw.addr := W_CTRL;
+				v.lw.data := CTRL_WR_XR1;
+				v.state := lwpoll;
+				v.ret := x2;
+			when x2 =>
+				v.cnt := 0;
+				v.state := push;
+				v.ret := y0;
+			when y0 =>
+				v.mem.addr := r.desc.y;
+				v.mem.len := r.nbw - 1;
+				v.mem.cnt := 0;
+				v.mem.busy := '1';
+				v.mem.arvalid := '1';
+				v.mem.rready := '1';
+				v.state := memwait;
+				v.ret := y1;
+			when y1 =>
+				v.lw.wr := '1';
+				v.lw.addr := W_CTRL;
+				v.lw.data := CTRL_WR_YR1;
+				v.state := lwpoll;
+				v.ret := y2;
+			when y2 =>
+				v.cnt := 0;
+				v.state := push;
+				v.ret := y3;
+			when y3 =>
+				v.lw.wr := '1';
+				v.lw.addr := W_R1_NULL;
+				v.lw.data := (others => '0');
+				v.state := lwpoll;
+				v.ret := go0;
+
+			-- operation
+			when go0 =>
+				if r.desc.ctrl /= x"00000000" then
+					v.lw.wr := '1';
+					v.lw.addr := W_CTRL;
+					v.lw.data := r.desc.ctrl;
+					v.state := lwpoll;
+					v.ret := go1;
+				else
+					v.state := rx0;
+				end if;
+			when go1 =>
+				-- wait for the end of the operation
+				v.lw.wr := '0';
+				v.state := lwpoll;
+				v.ret := rx0;
+
+			-- result
+			when rx0 =>
+				if r.desc.flags(DMA_FLAG_RES) = '1' then
+					v.lw.wr := '1';
+					v.lw.addr := W_CTRL;
+					v.lw.data := CTRL_RD_XR1;
+					v.state := lwpoll;
+					v.ret := rx1;
+				else
+					v.state := st0;
+				end if;
+			when rx1 =>
+				v.cnt := 0;
+				v.unmask := r.tokin;
+				v.state := pull;
+				v.ret := rx2;
+			when rx2 =>
+				v.mem.addr := r.desc.res;
+				v.mem.len := r.nbw - 1;
+				v.mem.cnt := 0;
+				v.mem.busy := '1';
+				v.mem.awvalid := '1';
+				v.mem.wvalid := '1';
+				v.mem.wdata := r.buf(0);
+				v.mem.wstrb := (others => '1');
+				if r.nbw = 1 then
+					v.mem.wlast := '1';
+				end if;
+				v.state := memwait;
+				v.ret := ry0;
+			when ry0 =>
+				v.lw.wr := '1';
+				v.lw.addr := W_CTRL;
+				v.lw.data := CTRL_RD_YR1;
+				v.state := lwpoll;
+				v.ret := ry1;
+			when ry1 =>
+				v.cnt := 0;
+				v.unmask := r.tokin;
+				v.state := pull;
+				v.ret := ry2;
+			when ry2 =>
+				-- Y right after X in buffer RES
+				v.mem.addr := r.desc.res + to_unsigned(r.nbw * (DW / 8), 32);
+				v.mem.len := r.nbw - 1;
+				v.mem.cnt := 0;
+				v.mem.busy := '1';
+				v.mem.awvalid := '1';
+				v.mem.wvalid := '1';
+				v.mem.wdata := r.buf(0);
+				v.mem.wstrb := (others => '1');
+				if r.nbw = 1 then
+					v.mem.wlast := '1';
+				end if;
+				v.state := memwait;
+				v.ret := st0;
+
+			-- status
+			when st0 =>
+				v.lw.wr := '0';
+				v.state := lwpoll;
+				v.ret := st1;
+			when st1 =>
+				if r.status(STATUS_ERR_MSB downto STATUS_ERR_LSB) /=
+					std_nat(0, STATUS_ERR_MSB - STATUS_ERR_LSB + 1)
+				then
+					-- acknowledge errors for the next job
+					v.lw.wr := '1';
+					v.lw.addr := W_ERR_ACK;
+					v.lw.data := (others => '0');
+					v.lw.data(STATUS_ERR_MSB downto STATUS_ERR_LSB) :=
+						r.status(STATUS_ERR_MSB downto STATUS_ERR_LSB);
+					v.state := lwpoll;
+					v.ret := st2;
+				else
+					v.state := st2;
+				end if;
+			when st2 =>
+				-- write back field STATUS of the descriptor (one beat, only
+				-- the byte lanes of the field being enabled)
+				v.mem.addr := r.desc.addr + to_unsigned(
+					(DMA_DESC_STATUS / FPW) * (DW / 8), 32);
+				v.mem.len := 0;
+				v.mem.cnt := 0;
+				v.mem.busy := '1';
+				v.mem.awvalid := '1';
+				v.mem.wvalid := '1';
+				v.mem.wlast := '1';
+				v.mem.wdata := (others => '0');
+				v.mem.wdata((STFLD * 32) + 31 downto STFLD * 32) := r.status;
+				v.mem.wdata((STFLD * 32) + DMA_DESC_DONE) := '1';
+				v.mem.wstrb := (others => '0');
+				v.mem.wstrb((STFLD * 4) + 3 downto STFLD * 4) := "1111";
+				v.state := memwait;
+				v.ret := st3;
+			when st3 =>
+				-- the token of the job is of no use anymore
+				v.tok := (others => (others => '0'));
+				v.tokin := '0';
+				v.head := (r.head + 1) and v_mask;
+				if r.desc.flags(DMA_FLAG_IRQ) = '1' then
+					v.irqsh(3) := '1';
+					if r.irqen = '1' then
+						v.irq := '1';
+					end if;
+				end if;
+				v.state := idle;
+
+			-- subroutine lw*
+			when lwpoll =>
+				if v_lite_free then
+					v.lite.busy := '1';
+					v.lite.rw := '0';
+					v.lite.ext := '0';
+					v.lite.addr := R_STATUS;
+					v.lite.arvalid := '1';
+					v.state := lwpchk;
+				end if;
+			when lwpchk =>
+				if r.lite.done = '1' then
+					v.status := r.lite.rdata(31 downto 0);
+					if r.lite.rdata(STATUS_BUSY) = '1' then
+						v.state := lwpoll;
+					elsif r.lw.wr = '1' then
+						v.state := lwwrite;
+					else
+						v.state := r.ret;
+					end if;
+				end if;
+			when lwwrite =>
+				if v_lite_free then
+					v.lite.busy := '1';
+					v.lite.rw := '1';
+					v.lite.ext := '0';
+					v.lite.addr := r.lw.addr;
+					v.lite.wdata := (others => '0');
+					v.lite.wdata(31 downto 0) := r.lw.data;
+					v.lite.awvalid := '1';
+					v.lite.wvalid := '1';
+					v.state := lwwait;
+				end if;
+			when lwwait =>
+				if r.lite.done = '1' then
+					v.state := r.ret;
+				end if;
+
+			-- subroutine push
+			-- (W_WRITE_DATA is written in streaming mode, ecc_axi holding
+			-- WREADY low until it can absorb each new word, see (s265))
+			when push =>
+				if v_lite_free then
+					v.lite.busy := '1';
+					v.lite.rw := '1';
+					v.lite.ext := '0';
+					v.lite.addr := W_WRITE_DATA;
+					v.lite.wdata := r.buf(r.cnt);
+					v.lite.awvalid := '1';
+					v.lite.wvalid := '1';
+					v.state := pushwait;
+				end if;
+			when pushwait =>
+				if r.lite.done = '1' then
+					if r.cnt = r.nbw - 1 then
+						v.state := r.ret;
+					else
+						v.cnt := r.cnt + 1;
+						v.state := push;
+					end if;
+				end if;
+
+			-- subroutine pull (same remark for R_READ_DATA & RVALID)
+			when pull =>
+				if v_lite_free then
+					v.lite.busy := '1';
+					v.lite.rw := '0';
+					v.lite.ext := '0';
+					v.lite.addr := R_READ_DATA;
+					v.lite.arvalid := '1';
+					v.state := pullwait;
+				end if;
+			when pullwait =>
+				if r.lite.done = '1' then
+					if r.unmask = '1' then
+						v.buf(r.cnt) := r.lite.rdata xor r.tok(r.cnt);
+					else
+						v.buf(r.cnt) := r.lite.rdata;
+					end if;
+					if r.cnt = r.nbw - 1 then
+						v.state := r.ret;
+					else
+						v.cnt := r.cnt + 1;
+						v.state := pull;
+					end if;
+				end if;
+
+			-- subroutine memwait
+			when memwait =>
+				if r.mem.busy = '0' then
+					v.state := r.ret;
+				end if;
+
+		end case;
+
+		-- raise the interrupt upon an error on the AXI4 master port
+		if r.berr = '0' and v.berr = '1' then
+			v.irqsh(3) := '1';
+			if r.irqen = '1' then
+				v.irq := '1';
+			end if;
+		end if;
+
+		-- synchronous (active low) reset
+		if rstn = '0' then
+			v.s.awready := '1';
+			v.s.wready := '1';
+			v.s.bvalid := '0';
+			v.s.arready := '1';
+			v.s.rvalid := '0';
+			v.s.awpending := '0';
+			v.s.dwpending := '0';
+			v.s.arpending := '0';
+			v.s.fwdw := '0';
+			v.s.fwdr := '0';
+			v.lite.busy := '0';
+			v.lite.awvalid := '0';
+			v.lite.wvalid := '0';
+			v.lite.arvalid := '0';
+			v.lite.done := '0';
+			v.mem.busy := '0';
+			v.mem.arvalid := '0';
+			v.mem.rready := '0';
+			v.mem.awvalid := '0';
+			v.mem.wvalid := '0';
+			v.mem.wlast := '0';
+			v.state := idle;
+			v.en := '0';
+			v.irqen := '0';
+			v.lgsz := (others => '0');
+			v.nbw := NBW_MAX;
+			v.ring := (others => '0');
+			v.head := (others => '0');
+			v.tail := (others => '0');
+			v.berr := '0';
+			v.active := '0';
+			v.irq := '0';
+			v.irqsh := (others => '0');
+			v.tok := (others => (others => '0'));
+			v.tokin := '0';
+			v.unmask := '0';
+		end if;
+
+		rin <= v;
+	end process comb;
+
+	-- registers, clocked by clk
+	regs : process(clk)
+	begin
+		if clk'event and clk = '1' then
+			r <= rin;
+		end if;
+	end process regs;
+
+	-- --------------------
+	-- drive output signals
+	-- --------------------
+
+	-- to external AXI-lite interface
+	s_axi_awready <= r.s.awready;
+	s_axi_wready <= r.s.wready;
+	s_axi_bvalid <= r.s.bvalid;
+	s_axi_arready <= r.s.arready;
+	s_axi_rdata <= r.s.rdata;
+	s_axi_rvalid <= r.s.rvalid;
+
+	-- to ecc_axi
+	e_axi_awaddr <= r.lite.addr & "000";
+	e_axi_awvalid <= r.lite.awvalid;
+	e_axi_wdata <= r.lite.wdata;
+	e_axi_wvalid <= r.lite.wvalid;
+	e_axi_bready <= '1';
+	e_axi_araddr <= r.lite.addr & "000";
+	e_axi_arvalid <= r.lite.arvalid;
+	e_axi_rready <= '1';
+
+	-- to system memory
+	m_axi_awaddr <= std_logic_vector(r.mem.addr);
+	m_axi_awlen <= std_logic_vector(to_unsigned(r.mem.len, 8));
+	m_axi_awsize <= set_axsize;
+	m_axi_awburst <= "01"; -- INCR
+	m_axi_awcache <= "0011"; -- normal non-cacheable bufferable
+	m_axi_awprot <= "000";
+	m_axi_awvalid <= r.mem.awvalid;
+	m_axi_wdata <= r.mem.wdata;
+	m_axi_wstrb <= r.mem.wstrb;
+	m_axi_wlast <= r.mem.wlast;
+	m_axi_wvalid <= r.mem.wvalid;
+	m_axi_bready <= '1';
+	m_axi_araddr <= std_logic_vector(r.mem.addr);
+	m_axi_arlen <= std_logic_vector(to_unsigned(r.mem.len, 8));
+	m_axi_arsize <= set_axsize;
+	m_axi_arburst <= "01"; -- INCR
+	m_axi_arcache <= "0011";
+	m_axi_arprot <= "000";
+	m_axi_arvalid <= r.mem.arvalid;
+	m_axi_rready <= r.mem.rready;
+
+	irq <= r.irq;
+
+end architecture rtl;
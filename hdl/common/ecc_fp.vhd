@@ -136,10 +136,12 @@ architecture rtl of ecc_fp is
 		rd : std_logic;
 		rdcnt : unsigned(log2(w - 1) - 1 downto 0);
 		opaorb : std_logic;
+		sq : std_logic;
 		-- for 'gosh' some bits will be trimmed by synthesizer depending on shuffle
 		gosh : std_logic_vector(readlat + 1 downto 0);
 		opic : std_logic_vector(FP_ADDR_MSB - 1 downto 0);
 		opc : mm_opc_type;
+		opcq : mm_opc_type; -- same as .opc but for multiplications in .queued
 		-- for 'xypushsh' some bits will be pruned by syn. depending on shuffle
 		xypushsh : std_logic_vector(readlat - 1 downto 0);
 		-- resync registers
@@ -168,13 +170,14 @@ architecture rtl of ecc_fp is
 
 	type mm_type is record
 		busy : std_logic_vector(0 to nbmult - 1); -- 1 bit for each mm_ndsp comp.
+		queued : std_logic_vector(0 to nbmult - 1); -- (same)
 		push : mm_push_type;
 		pull : mm_pull_type;
 		mmi : mmi_type;
 		-- resynchronization registers of mmo bus input signals
 		mmo0, mmo1, mmo2, mmo3 : mmo_type;
 		irq_prev : std_logic_vector(nbmult - 1 downto 0);
-		nb_pending_redc : unsigned(log2(nbmult) - 1 downto 0);
+		nb_pending_redc : unsigned(log2(2 * nbmult) - 1 downto 0);
 		pending_redc : std_logic;
 	end record;
 
@@ -199,6 +202,10 @@ architecture rtl of ecc_fp is
 		opbmsb : std_logic;
 		zero : std_logic;
 		testz : std_logic;
+		-- FPADD/FPSUB sequencing (see (s143))
+		fpmopc : std_logic_vector(FP_ADDR_MSB - 1 downto 0);
+		fpmred : std_logic;
+		fpmlast : std_logic;
 	end record;
 
 	type xor_type is record
@@ -314,6 +321,7 @@ architecture rtl of ecc_fp is
 		par : std_logic;
 		div2 : std_logic;
 		extended : std_logic;
+		fpm : std_logic;
 		resultz : std_logic;
 		resultsn : std_logic;
 		resulterr : std_logic;
@@ -731,6 +739,25 @@ begin
 				exit; -- TODO: check the effect on synthesis of that
 			end if;
 		end loop;
+		-- (s147) in the async = TRUE case, if no Montgomery multiplier is idle
+		-- we can still transfer the operands of the next FPREDC to one that
+		-- is computing, provided it has only one multiplication booked (and
+		-- that this one is already started, which is what mmo(i).rdy = 0
+		-- means here): mm_ndsp then keeps the new one pending until the
+		-- current one is over and its result has been pulled, while the
+		-- transfer of the operands overlaps the current computation
+		-- (only if 'fpprefetch' is set, see ecc_customize)
+		if async and fpprefetch and v.mm.push.oneavail = '0' then
+			for i in 0 to nbmult - 1 loop
+				if r.mm.mmo2(i).rdy = '0' and r.mm.busy(i) = '1'
+					and r.mm.queued(i) = '0'
+				then
+					v.mm.push.oneavail := '1';
+					v.mm.push.id0 := i;
+					exit;
+				end if;
+			end loop;
+		end if;
 
 		-- -----------------------------------------------------------
 		--    Continously (at each cycle) gather information about
@@ -867,6 +894,18 @@ begin
 				v.opa := opi.a & std_logic_vector(to_unsigned(0, log2(n - 1)));
 				v.opb := opi.b & std_logic_vector(to_unsigned(0, log2(n - 1)));
 				v.mm.push.opic := opi.c; -- (s10)
+				-- (s144) a squaring (same address for opcodes A & B) only needs
+				-- X to be transferred to the Montgomery multiplier, which then
+				-- takes the y_j terms from its copy of X: this saves one complete
+				-- read burst of the operand (see (s145) & (s146)) & lets it
+				-- compute each cross-product x_i.x_j only once (see (s130) in
+				-- mm_ndsp.vhd)
+				-- (only if 'fpsqr' is set, see ecc_customize)
+				if fpsqr and opi.a = opi.b then
+					v.mm.push.sq := '1';
+				else
+					v.mm.push.sq := '0';
+				end if;
 				v.mm.push.do := '1';
 				v.ctrl.redc := '1';
 			elsif opi.sub = '1' or opi.add = '1' then
@@ -882,6 +921,12 @@ begin
 					v.ctrl.add := '1';
 				end if;
 				v.ctrl.extended := opi.extended;
+				-- FPADD/FPSUB: record the address of opcode C which the modular
+				-- correction passes chained by (s143) will need
+				v.ctrl.fpm := opi.fpm;
+				v.addsub.fpmopc := opi.c;
+				v.addsub.fpmred := '0';
+				v.addsub.fpmlast := '0';
 			elsif opi.xxor = '1' then
 				-- bitwise xor
 				v.xxor.do := '1';
@@ -987,8 +1032,17 @@ begin
 				v.mm.nb_pending_redc := r.mm.nb_pending_redc + 1; -- (s131)
 				v.mm.pending_redc := '1';
 				-- book the multiplier so that selection algo in (s0) above
-				-- does exclude it from its arbitration
+				-- does exclude it from its arbitration (or, if it was already
+				-- booked, see (s147), queue the new multiplication behind the
+				-- one it is currently computing)
+				-- Note that although .id0 was selected in the previous cycle,
+				-- r.mm.busy(r.mm.push.id0) is up-to-date here (if the multiplier
+				-- was released by (s11) in the meantime, it is simply booked
+				-- again as an idle one)
 				v.mm.busy(r.mm.push.id0) := '1';
+				if r.mm.busy(r.mm.push.id0) = '1' then
+					v.mm.queued(r.mm.push.id0) := '1';
+				end if;
 				v.mm.push.id1 := r.mm.push.id0; -- (s5) see also (s33)
 				-- we register the value of opc into 'r.mm.push.opc(r.mm.push.id0)'
 				-- (this is the address where to store the result of multiplica-
@@ -1002,7 +1056,11 @@ begin
 				-- is pushed back into ecc_fp_dram synchronously to their computation,
 				-- (i.e with no other operation being accepted coming from ecc_curve
 				-- before themselves are completely carried out)
-				v.mm.push.opc(r.mm.push.id0) := r.mm.push.opic; -- (s91)
+				if r.mm.busy(r.mm.push.id0) = '1' then
+					v.mm.push.opcq(r.mm.push.id0) := r.mm.push.opic; -- (s148)
+				else
+					v.mm.push.opc(r.mm.push.id0) := r.mm.push.opic; -- (s91)
+				end if;
 				v.mm.push.shstart(readlat + 1) := '1'; -- (s95) bypass of (s94)
 				v.mm.push.rdcnt := nndyn_wm1;
 				v.mm.push.rd := '1';
@@ -1053,7 +1111,11 @@ begin
 					std_logic_vector(unsigned(r.opb(log2(n - 1) - 1 downto 0)) + 1);
 			end if;
 			if r.mm.push.rdcnt = (r.mm.push.rdcnt'range => '0') then
-				if r.mm.push.opaorb = '1' then
+				if r.mm.push.opaorb = '1' and r.mm.push.sq = '1' then
+					-- (s145) squaring: no second operand read burst, see (s144)
+					v.mm.push.rd := '0';
+					v.mm.push.gosh(readlat + 1) := '1';
+				elsif r.mm.push.opaorb = '1' then
 					-- switch .opaorb so that to record that we're now starting the
 					-- second operand read burst
 					v.mm.push.opaorb := '0';
@@ -1077,6 +1139,7 @@ begin
 		-- assertion/deassertion of xen & yen to the selected Montgomery mult.
 		if r.mm.push.shstart(0) = '1' then
 			v.mm.mmi(r.mm.push.id1).xen := '1';
+			v.mm.mmi(r.mm.push.id1).sq := r.mm.push.sq; -- (s146)
 		end if;
 
 		-- switch between xen & yen (data strobes to the Montgomery multiplier)
@@ -1092,6 +1155,8 @@ begin
 		-- give selected multiplier a go so that Montgomery multiplication
 		-- is actually started
 		if r.mm.push.gosh(0) = '1' then
+			-- (xen is still asserted here in the case of a squaring, see (s145))
+			v.mm.mmi(r.mm.push.id1).xen := '0';
 			v.mm.mmi(r.mm.push.id1).yen := '0';
 			v.mm.mmi(r.mm.push.id1).go := '1'; -- asserted 1 cycle thx to (s6)
 		end if;
@@ -1459,6 +1524,65 @@ begin
 			v.ctrl.sub := '0';
 		end if;
 
+		-- (s143) FPADD & FPSUB instructions
+		-- Instead of signaling end of operation to ecc_curve at the end of the
+		-- first pass, chain by ourselves the addition/subtraction passes that
+		-- bring the result back into [0, 2p[, that is:
+		--   FPSUB: pass 0:   c <- a - b
+		--          pass 1:   c <- c + (c < 0 ? 2p : 0)
+		--   FPADD: pass 0:   c <- a + b
+		--          pass 1: red <- c - 2p
+		--          pass 2:   c <- red + (red < 0 ? 2p : 0)
+		-- which is exactly what the NNSUB/NNADD,p5 (resp. NNADD/NNSUB/NNADD,p5)
+		-- sequence of opcodes computes, but saves the round-trips through
+		-- ecc_curve fetch, decode & patch stages between each pass.
+		-- Sign of the pass that just ended is available in r.ctrl.resultsn
+		-- (it was latched when r.addsub.shend(1) = 1)
+		if r.addsub.shend(0) = '1' and r.ctrl.fpm = '1' then
+			if r.addsub.fpmlast = '1' then
+				-- last pass is over, let (s31) signal end of operation
+				v.ctrl.fpm := '0';
+			else
+				v.done := '0'; -- bypass of (s31)
+				v.rdy := '0';
+				-- pragma translate_off
+				v.active := '1';
+				-- pragma translate_on
+				v.addsub.do := '1';
+				if r.ctrl.add = '1' then
+					-- end of FPADD pass 0
+					v.opa := r.addsub.fpmopc
+					  & std_logic_vector(to_unsigned(0, log2(n - 1)));
+					v.opb := CST_ADDR_TWOP
+					  & std_logic_vector(to_unsigned(0, log2(n - 1)));
+					v.opc := CST_ADDR_RED
+					  & std_logic_vector(to_unsigned(0, log2(n - 1)));
+					v.ctrl.sub := '1';
+					v.addsub.fpmred := '1';
+				else
+					-- end of FPSUB pass 0 or of FPADD pass 1
+					if r.addsub.fpmred = '1' then
+						v.opa := CST_ADDR_RED
+						  & std_logic_vector(to_unsigned(0, log2(n - 1)));
+					else
+						v.opa := r.addsub.fpmopc
+						  & std_logic_vector(to_unsigned(0, log2(n - 1)));
+					end if;
+					if r.ctrl.resultsn = '1' then
+						v.opb := CST_ADDR_TWOP
+						  & std_logic_vector(to_unsigned(0, log2(n - 1)));
+					else
+						v.opb := CST_ADDR_ZERO
+						  & std_logic_vector(to_unsigned(0, log2(n - 1)));
+					end if;
+					v.opc := r.addsub.fpmopc
+					  & std_logic_vector(to_unsigned(0, log2(n - 1)));
+					v.ctrl.add := '1';
+					v.addsub.fpmlast := '1';
+				end if;
+			end if;
+		end if;
+
 		-- -------------------------------------------------------------
 		--                   bitwise xor processing
 		-- -------------------------------------------------------------
@@ -2168,11 +2292,19 @@ begin
 			v.fpram.we := '0';
 			v.done := '1'; -- (s8), stays asserted only 1 cycle thx to (s7)
 			v.mm.busy(r.mm.pull.done_id1) := '0'; -- (s11)
+			-- if another multiplication was queued on the same Montgomery
+			-- multiplier (see (s147)) it now becomes its current one
+			if r.mm.queued(r.mm.pull.done_id1) = '1' then
+				v.mm.busy(r.mm.pull.done_id1) := '1';
+				v.mm.queued(r.mm.pull.done_id1) := '0';
+				v.mm.push.opc(r.mm.pull.done_id1) :=
+					r.mm.push.opcq(r.mm.pull.done_id1); -- see (s148)
+			end if;
 			if r.mm.push.do = '0' then
 				v.rdy := '1';
 			end if;
 			v.mm.nb_pending_redc := r.mm.nb_pending_redc - 1; -- (s132)
-			if r.mm.nb_pending_redc = to_unsigned(1, log2(nbmult)) then
+			if r.mm.nb_pending_redc = to_unsigned(1, log2(2 * nbmult)) then
 				-- (means .nb_pending_redc is about to be set back to 0 by (s132))
 				v.mm.pending_redc := '0'; -- (s135)
 			end if;
@@ -2287,12 +2419,14 @@ begin
 			for i in 0 to nbmult - 1 loop
 				v.mm.mmi(i).xen := '0';
 				v.mm.mmi(i).yen := '0';
+				v.mm.mmi(i).sq := '0';
 				v.mm.mmi(i).go := '0';
 				v.mm.mmi(i).zren := '0';
 			end loop;
 			v.fpram.we := '0';
 			v.fpram.wecnten := '0';
 			v.mm.busy := (others => '0');
+			v.mm.queued := (others => '0');
 			v.mm.pull.done := (others => '0');
 			v.mm.pull.oneavail := '0';
 			v.mm.push.gosh := (others => '0'); -- mandat. alas it'll prevent SRL optim
@@ -2344,7 +2478,7 @@ begin
 			-- in logic high, it will stay so for just one cycle (thx to (s116))
 			-- during which r.fpram.we will be protected by (s117) anyway)
 			v.ctrl.redc := '0';
-			v.ctrl.add := '0'; v.ctrl.sub := '0';
+			v.ctrl.add := '0'; v.ctrl.sub := '0'; v.ctrl.fpm := '0';
 			v.ctrl.srl32 := '0'; v.ctrl.ssrl := '0'; v.ctrl.sll32 := '0';
 			v.ctrl.ssll := '0'; v.ctrl.xxor := '0';
 			v.ctrl.par := '0'; v.ctrl.rnd := '0';
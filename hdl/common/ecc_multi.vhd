@@ -0,0 +1,974 @@
+--
+--  Copyright (C) 2023 - This file is part of IPECC project
+--
+--  Authors:
+--      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+--      Ryad BENADJILA <ryadbenadjila@gmail.com>
+--
+--  Contributors:
+--      Adrian THILLARD
+--      Emmanuel PROUFF
+--
+--  This software is licensed under GPL v2 license.
+--  See LICENSE file at the root folder of the project.
+--
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+use work.ecc_customize.all;
+use work.ecc_utils.all;
+use work.ecc_log.all;
+use work.ecc_pkg.all;
+use work.ecc_trng_pkg.all;
+use work.ecc_software.all;
+
+-- pragma translate_off
+use std.textio.all;
+-- pragma translate_on
+
+-- Top-level with 'nbengines' (parameter in ecc_customize) complete [k]P
+-- engines behind one AXI-lite interface.
+--
+-- Each engine is an instance of 'ecc' (hence has its own ecc_axi, ecc_scalar,
+-- ecc_curve, ecc_fp & multipliers) and its registers are mapped in its own
+-- window of 2**AXIAW bytes: window i (bits C_S_AXI_ADDR_WIDTH - 1 downto AXIAW
+-- of the AXI address) for i < nbengines is the one of engine i, so that a
+-- software driver can be pointed at any of them as if it were alone. Besides:
+--
+--   - window MULTI_WIN_BCAST (see ecc_software.vhd) replays each access to
+--     all engines, one after the other, before answering (e.g to set the
+--     curve once for all). A read there returns the bitwise OR of the
+--     answers of all engines, so that polling R_STATUS in this window waits
+--     for all of them (mind that a read of R_READ_DATA consumes one word of
+--     each engine).
+--
+--   - windows MULTI_WIN_JOB & MULTI_WIN_RES are those of the hardware job
+--     dispatcher, through which software can submit [k]P computations to
+--     the engines & collect their results without ever choosing an engine:
+--
+--       . the first access to window JOB binds it to an idle engine (round-
+--         robin) & all accesses to window JOB are then forwarded to that
+--         engine, so that software loads the job (token, scalar, point...)
+--         exactly as with a standalone IP. The write that makes the engine
+--         start the computation ([k]P, [k]G or [k]P on a point slot, as
+--         signaled by the 'kpjob' output of the engine) launches the job:
+--         the engine is appended to the queue of jobs to collect and
+--         window JOB gets unbound, the next job going to another engine
+--         while this one computes. Accesses to window JOB while it is un-
+--         bound & all engines are in use get a SLVERR response.
+--
+--       . accesses to window RES are forwarded to the engine holding the
+--         oldest job not yet collected (head of the queue), so results come
+--         back in the order jobs were submitted. Software polls R_STATUS &
+--         reads the result there as with a standalone IP, then writes
+--         W_MULTI_NEXT (window DISP) to free the engine & bind window RES to
+--         the next job. Accesses to window RES while the queue is empty get
+--         a SLVERR response, as well as a write of W_MULTI_NEXT while the
+--         oldest job is not over (or if there is none).
+--
+--   - window MULTI_WIN_DISP holds the registers of the dispatcher:
+--     R_MULTI_QUEUE tells whether a job can be submitted, which engines are
+--     bound to windows JOB & RES, the number of jobs in the queue & whether
+--     the oldest one is over, R_MULTI_STATUS gives the busy & idle bitmaps
+--     of the engines & R_MULTI_ENGINES the number of engines.
+--
+-- The dispatcher does not track direct accesses to the window of an engine:
+-- engines should either be used through windows JOB & RES or directly, not
+-- both.
+--
+-- Accesses to different engines (e.g a read of the R_STATUS of one engine
+-- while a write is pending on another) are not serialized between the read
+-- & write channels, but one channel only has one transaction in flight.
+--
+-- One entropy source & one post-processing unit (the ones of ecc_trng) feed
+-- all engines, each of them having its own server of internal random numbers
+-- (ecc_trng_srv). Post-processed words are given round-robin to the servers
+-- that are ready. The debug controls of the TRNG (register W_DBG_TRNG_* of
+-- any engine) have no effect on the shared source, which always runs with
+-- its nominal settings.
+--
+-- Interrupt, busy & debug outputs are the OR of the ones of all engines.
+
+entity ecc_multi is
+	generic(
+		-- width of AXI data bus
+		constant C_S_AXI_DATA_WIDTH : integer := axi32or64; -- in ecc_customize
+		-- width of AXI address bus
+		constant C_S_AXI_ADDR_WIDTH : integer := AXIAW_MULTI -- in ecc_pkg
+	);
+	port(
+		-- AXI clock
+		s_axi_aclk : in std_logic;
+		-- AXI reset (expected active low, async asserted, sync deasserted) 
+		s_axi_aresetn : in std_logic;
+		-- AXI write-address channel
+		s_axi_awaddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1  downto 0);
+		s_axi_awprot : in std_logic_vector(2 downto 0); -- ignored
+		s_axi_awvalid : in std_logic;
+		s_axi_awready : out std_logic;
+		-- AXI write-data channel
+		s_axi_wdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		s_axi_wstrb : in std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+		s_axi_wvalid : in std_logic;
+		s_axi_wready : out std_logic;
+		-- AXI write-response channel
+		s_axi_bresp : out std_logic_vector(1 downto 0);
+		s_axi_bvalid : out std_logic;
+		s_axi_bready : in std_logic;
+		-- AXI read-address channel
+		s_axi_araddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+		s_axi_arprot : in std_logic_vector(2 downto 0); -- ignored
+		s_axi_arvalid : in std_logic;
+		s_axi_arready : out std_logic;
+		-- AXI read-data channel
+		s_axi_rdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+		s_axi_rresp : out std_logic_vector(1 downto 0);
+		s_axi_rvalid : out std_logic;
+		s_axi_rready : in std_logic;
+		-- clock for Montgomery multipliers in the async case
+		clkmm : in std_logic;
+		-- interrupt
+		irq : out std_logic;
+		-- busy signal for [k]P computation (any engine)
+		busy : out std_logic;
+		-- debug features
+		--   off-chip trigger
+		dbgtrigger : out std_logic;
+		dbghalted : out std_logic;
+		--   pseudo-trng port (unused, see header)
+		dbgptdata : in std_logic_vector(7 downto 0);
+		dbgptvalid : in std_logic;
+		dbgptrdy : out std_logic
+	);
+end entity ecc_multi;
+
+architecture rtl of ecc_multi is
+
+	-- following attributes are Xilinx specific but they should not do any harm
+	-- on other platforms
+	attribute X_INTERFACE_INFO : string;
+	attribute X_INTERFACE_PARAMETER : string;
+	attribute X_INTERFACE_INFO of irq : signal is
+		"xilinx.com:signal:interrupt:1.0 irq INTERRUPT";
+	attribute X_INTERFACE_PARAMETER of irq : signal is "SENSITIVITY EDGE_RISING";
+
+	-- one [k]P engine
+	component ecc is
+		generic(
+			-- width of AXI data bus
+			constant C_S_AXI_DATA_WIDTH : integer := axi32or64; -- in ecc_customize
+			-- width of AXI address bus
+			constant C_S_AXI_ADDR_WIDTH : integer := AXIAW; -- in ecc_pkg
+			-- if TRUE, entropy is received from the TRNG shared between the
+			-- engines of top-level ecc_multi (ports trng*) instead of being
+			-- produced by a TRNG of our own
+			constant C_SHARED_TRNG : boolean := FALSE
+		);
+		port(
+			-- AXI clock
+			s_axi_aclk : in std_logic;
+			-- AXI reset (expected active low, async asserted, sync deasserted) 
+			s_axi_aresetn : in std_logic;
+			-- AXI write-address channel
+			s_axi_awaddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1  downto 0);
+			s_axi_awprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_awvalid : in std_logic;
+			s_axi_awready : out std_logic;
+			-- AXI write-data channel
+			s_axi_wdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axi_wstrb : in std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+			s_axi_wvalid : in std_logic;
+			s_axi_wready : out std_logic;
+			-- AXI write-response channel
+			s_axi_bresp : out std_logic_vector(1 downto 0);
+			s_axi_bvalid : out std_logic;
+			s_axi_bready : in std_logic;
+			-- AXI read-address channel
+			s_axi_araddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+			s_axi_arprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_arvalid : in std_logic;
+			s_axi_arready : out std_logic;
+			-- AXI read-data channel
+			s_axi_rdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axi_rresp : out std_logic_vector(1 downto 0);
+			s_axi_rvalid : out std_logic;
+			s_axi_rready : in std_logic;
+			-- AXI4 master interface to system memory (only used if parameter
+			-- 'dma' is set in ecc_customize, otherwise outputs are driven low
+			-- and inputs, which default to low, can be left unconnected)
+			m_axi_awaddr : out std_logic_vector(31 downto 0);
+			m_axi_awlen : out std_logic_vector(7 downto 0);
+			m_axi_awsize : out std_logic_vector(2 downto 0);
+			m_axi_awburst : out std_logic_vector(1 downto 0);
+			m_axi_awcache : out std_logic_vector(3 downto 0);
+			m_axi_awprot : out std_logic_vector(2 downto 0);
+			m_axi_awvalid : out std_logic;
+			m_axi_awready : in std_logic := '0';
+			m_axi_wdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			m_axi_wstrb : out std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+			m_axi_wlast : out std_logic;
+			m_axi_wvalid : out std_logic;
+			m_axi_wready : in std_logic := '0';
+			m_axi_bresp : in std_logic_vector(1 downto 0)
+				:= (others => '0');
+			m_axi_bvalid : in std_logic := '0';
+			m_axi_bready : out std_logic;
+			m_axi_araddr : out std_logic_vector(31 downto 0);
+			m_axi_arlen : out std_logic_vector(7 downto 0);
+			m_axi_arsize : out std_logic_vector(2 downto 0);
+			m_axi_arburst : out std_logic_vector(1 downto 0);
+			m_axi_arcache : out std_logic_vector(3 downto 0);
+			m_axi_arprot : out std_logic_vector(2 downto 0);
+			m_axi_arvalid : out std_logic;
+			m_axi_arready : in std_logic := '0';
+			m_axi_rdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0)
+				:= (others => '0');
+			m_axi_rresp : in std_logic_vector(1 downto 0)
+				:= (others => '0');
+			m_axi_rlast : in std_logic := '0';
+			m_axi_rvalid : in std_logic := '0';
+			m_axi_rready : out std_logic;
+			-- clock for Montgomery multipliers in the async case
+			clkmm : in std_logic;
+			-- interrupt
+			irq : out std_logic;
+			-- busy signal for [k]P computation
+			busy : out std_logic;
+			-- [k]P computation requested or running
+			kpjob : out std_logic;
+			-- debug features
+			--   off-chip trigger
+			dbgtrigger : out std_logic;
+			dbghalted : out std_logic;
+			--   pseudo-trng port
+			dbgptdata : in std_logic_vector(7 downto 0);
+			dbgptvalid : in std_logic;
+			dbgptrdy : out std_logic;
+			-- post-processed entropy from the shared TRNG (only used if generic
+			-- C_SHARED_TRNG is TRUE)
+			trngdata : in std_logic_vector(pp_irn_width - 1 downto 0)
+				:= (others => '0');
+			trngvalid : in std_logic := '0';
+			trngrdy : out std_logic
+		);
+	end component ecc;
+
+	component es_trng is
+		port(
+			clk : in std_logic;
+			rstn : in std_logic;
+			swrst : in std_logic;
+			-- interface with ecc_trng_pp
+			data_t : out std_logic_vector(7 downto 0);
+			valid_t : out std_logic;
+			rdy_t : in std_logic;
+			-- following signals are for debug & statistics
+			dbgtrngta : in unsigned(15 downto 0);
+			dbgtrngrawreset : in std_logic;
+			dbgtrngrawfull : out std_logic;
+			dbgtrngrawwaddr : out std_logic_vector(log2(raw_ram_size-1) - 1 downto 0);
+			dbgtrngrawraddr : in std_logic_vector(log2(raw_ram_size-1) - 1 downto 0);
+			dbgtrngrawdata : out std_logic;
+			dbgtrngrawfiforeaddis : in std_logic;
+			dbgtrngrawduration : out unsigned(31 downto 0);
+			dbgtrngvonneuman : in std_logic;
+			dbgtrngidletime : in unsigned(3 downto 0)
+		);
+	end component es_trng;
+
+	-- pragma translate_off
+	component es_trng_sim is
+		port(
+			clk : in std_logic;
+			rstn : in std_logic;
+			swrst : in std_logic;
+			-- interface with ecc_trng_pp
+			data_t : out std_logic_vector(7 downto 0);
+			valid_t : out std_logic;
+			rdy_t : in std_logic;
+			-- following signals are for debug & statistics
+			dbgtrngta : in unsigned(15 downto 0);
+			dbgtrngrawreset : in std_logic;
+			dbgtrngrawfull : out std_logic;
+			dbgtrngrawwaddr : out std_logic_vector(log2(raw_ram_size-1) - 1 downto 0);
+			dbgtrngrawraddr : in std_logic_vector(log2(raw_ram_size-1) - 1 downto 0);
+			dbgtrngrawdata : out std_logic;
+			dbgtrngrawfiforeaddis : in std_logic;
+			dbgtrngrawduration : out unsigned(31 downto 0);
+			dbgtrngvonneuman : in std_logic;
+			dbgtrngidletime : in unsigned(3 downto 0)
+		);
+	end component es_trng_sim;
+	-- pragma translate_on
+
+	component ecc_trng_pp is
+		port(
+			clk : in std_logic;
+			rstn : in std_logic;
+			swrst : in std_logic;
+			-- interface with ecc_scalar
+			irn_reset : in std_logic;
+			-- interface with es_trng
+			data_t : in std_logic_vector(7 downto 0);
+			valid_t : in std_logic;
+			rdy_t : out std_logic;
+			-- interface with ecc_trng_srv
+			data_s : out std_logic_vector(pp_irn_width - 1 downto 0);
+			valid_s : out std_logic;
+			rdy_s : in std_logic;
+			dbgtrngusepseudosource : in std_logic;
+			dbgtrngrawpullppdis : in std_logic;
+			-- interface with the external pseudo TRNG component
+			dbgpseudotrngdata : in std_logic_vector(7 downto 0);
+			dbgpseudotrngvalid : in std_logic;
+			dbgpseudotrngrdy : out std_logic
+		);
+	end component ecc_trng_pp;
+
+	constant DW : positive := C_S_AXI_DATA_WIDTH;
+	constant NBE : positive := nbengines;
+	-- AXI response to an access to window JOB (resp. RES) while no engine
+	-- is available for a new job (resp. no job is queued)
+	constant SLVERR : std_logic_vector(1 downto 0) := "10";
+
+	subtype ebits is std_logic_vector(NBE - 1 downto 0);
+	type edata_type is array(0 to NBE - 1) of
+		std_logic_vector(DW - 1 downto 0);
+	type eresp_type is array(0 to NBE - 1) of std_logic_vector(1 downto 0);
+
+	-- AXI-lite slave side
+	type reg_s_type is record
+		awready : std_logic;
+		wready : std_logic;
+		bvalid : std_logic;
+		bresp : std_logic_vector(1 downto 0);
+		arready : std_logic;
+		rvalid : std_logic;
+		rresp : std_logic_vector(1 downto 0);
+		awpending : std_logic;
+		dwpending : std_logic;
+		arpending : std_logic;
+		waddr : std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 3);
+		wdata : std_logic_vector(DW - 1 downto 0);
+		raddr : std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 3);
+		rdata : std_logic_vector(DW - 1 downto 0);
+	end record;
+
+	-- write forwarded to engine 'eng' (then to the following ones if
+	-- 'bcast' is set), 'job' telling that it comes from window JOB
+	type reg_w_type is record
+		busy : std_logic;
+		bcast : std_logic;
+		job : std_logic;
+		eng : natural range 0 to NBE - 1;
+		awvalid : std_logic;
+		wvalid : std_logic;
+	end record;
+
+	-- read forwarded to engine 'eng' (then to the following ones if
+	-- 'bcast' is set)
+	type reg_rd_type is record
+		busy : std_logic;
+		bcast : std_logic;
+		eng : natural range 0 to NBE - 1;
+		arvalid : std_logic;
+	end record;
+
+	-- state of an engine as seen by the dispatcher
+	--   eidle: available for a new job
+	--   eload: bound to window JOB, receiving a job
+	--   erun: job launched, in the queue of jobs to collect (the job is over
+	--         once the engine lowers its 'kpjob' output)
+	type estate_type is (eidle, eload, erun);
+	type estates_type is array(0 to NBE - 1) of estate_type;
+	type equeue_type is array(0 to NBE - 1) of natural range 0 to NBE - 1;
+
+	type reg_disp_type is record
+		est : estates_type;
+		-- engine bound to window JOB (if 'bound' is set)
+		bound : std_logic;
+		jeng : natural range 0 to NBE - 1;
+		-- next engine to consider first for a new job
+		nxt : natural range 0 to NBE - 1;
+		-- queue of launched jobs (engine indexes) in launch order, the one
+		-- at the head being bound to window RES
+		q : equeue_type;
+		qhead : natural range 0 to NBE - 1;
+		qnb : natural range 0 to NBE;
+	end record;
+
+	type reg_type is record
+		s : reg_s_type;
+		w : reg_w_type;
+		rd : reg_rd_type;
+		d : reg_disp_type;
+		-- next engine to serve first with post-processed entropy
+		tptr : natural range 0 to NBE - 1;
+	end record;
+
+	signal r, rin : reg_type;
+
+	signal s_axi_aresetn_rsh : std_logic_vector(2 downto 0);
+	alias s_axi_aresetn_resync : std_logic is s_axi_aresetn_rsh(0);
+
+	-- AXI-lite interfaces of the engines (address & write data are common)
+	signal e_awaddr : std_logic_vector(AXIAW - 1 downto 0);
+	signal e_awvalid, e_awready : ebits;
+	signal e_wdata : std_logic_vector(DW - 1 downto 0);
+	signal e_wstrb : std_logic_vector((DW/8) - 1 downto 0);
+	signal e_wvalid, e_wready : ebits;
+	signal e_bresp : eresp_type;
+	signal e_bvalid : ebits;
+	signal e_araddr : std_logic_vector(AXIAW - 1 downto 0);
+	signal e_arvalid, e_arready : ebits;
+	signal e_rdata : edata_type;
+	signal e_rresp : eresp_type;
+	signal e_rvalid : ebits;
+	signal e_irq, e_busy, e_kpjob, e_dbgtrigger, e_dbghalted : ebits;
+
+	-- shared TRNG
+	signal data_t : std_logic_vector(7 downto 0);
+	signal valid_t : std_logic;
+	signal rdy_t : std_logic;
+	signal data_s : std_logic_vector(pp_irn_width - 1 downto 0);
+	signal valid_s : std_logic;
+	signal rdy_s : std_logic;
+	signal e_trngvalid, e_trngrdy : ebits;
+	signal tgrant : natural range 0 to NBE - 1;
+	signal tany : std_logic;
+	-- (outputs of the entropy source only used in debug mode, left unread)
+	signal dbgtrngrawfull : std_logic;
+	signal dbgtrngrawwaddr : std_logic_vector(log2(raw_ram_size-1) - 1 downto 0);
+	signal dbgtrngrawdata : std_logic;
+	signal dbgtrngrawduration : unsigned(31 downto 0);
+	-- (static inputs of the entropy source & of the engines)
+	signal trngta_s : unsigned(15 downto 0);
+	signal trngraddr_s : std_logic_vector(log2(raw_ram_size-1) - 1 downto 0);
+	signal trngidle_s : unsigned(3 downto 0);
+	signal zero8 : std_logic_vector(7 downto 0);
+
+	-- OR of all bits of a vector
+	function or_all(v : std_logic_vector) return std_logic is
+		variable o : std_logic;
+	begin
+		o := '0';
+		for i in v'range loop
+			o := o or v(i);
+		end loop;
+		return o;
+	end function or_all;
+
+begin
+
+	assert (NBE <= 16)
+		report "Parameter 'nbengines' in ecc_customize.vhd must not exceed 16."
+			severity FAILURE;
+	assert (not dma)
+		report "Parameter 'dma' in ecc_customize.vhd must be FALSE when using "
+		     & "top-level ecc_multi."
+			severity FAILURE;
+	assert (C_S_AXI_ADDR_WIDTH >= AXIAW_MULTI)
+		report "ecc_multi: AXI address bus too narrow to decode all windows."
+			severity FAILURE;
+
+	-- force resynchronization of input reset s_axi_aresetn in the
+	-- s_axi_aclk clock domain (engines do the same on their own)
+	process(s_axi_aclk, s_axi_aresetn)
+	begin
+		if (s_axi_aresetn = '0') then
+			s_axi_aresetn_rsh <= (others => '0');
+		elsif s_axi_aclk'event and s_axi_aclk = '1' then
+			s_axi_aresetn_rsh(s_axi_aresetn_rsh'length - 1 downto 0) <=
+				'1' & s_axi_aresetn_rsh(s_axi_aresetn_rsh'length - 1 downto 1);
+		end if;
+	end process;
+
+	comb: process(r, s_axi_aresetn_resync,
+	              s_axi_awaddr, s_axi_awvalid, s_axi_wdata, s_axi_wvalid,
+	              s_axi_bready, s_axi_araddr, s_axi_arvalid, s_axi_rready,
+	              e_awready, e_wready, e_bresp, e_bvalid, e_arready, e_rdata,
+	              e_rresp, e_rvalid, e_kpjob, valid_s, tany, tgrant)
+		variable v : reg_type;
+		variable v_win : natural;
+		variable v_free : std_logic;
+		variable v_fid : natural range 0 to NBE - 1;
+		variable v_j : natural range 0 to NBE - 1;
+		variable v_idle : ebits;
+		variable v_done : std_logic;
+	begin
+		v := r;
+
+		-- ------------------------------------------------------------
+		--                  D i s p a t c h e r   (1/2)
+		-- ------------------------------------------------------------
+		-- idle engine to bind to window JOB if a job is submitted while it
+		-- is unbound (round-robin starting from r.d.nxt)
+		v_free := '0';
+		v_fid := 0;
+		for i in NBE - 1 downto 0 loop
+			v_j := (r.d.nxt + i) mod NBE;
+			if r.d.est(v_j) = eidle then
+				v_idle(v_j) := '1';
+				v_free := '1';
+				v_fid := v_j;
+			else
+				v_idle(v_j) := '0';
+			end if;
+		end loop;
+		-- the job at the head of the queue is over
+		v_done := '0';
+		if r.d.qnb > 0 and e_kpjob(r.d.q(r.d.qhead)) = '0' then
+			v_done := '1';
+		end if;
+
+		-- ------------------------------------------------------------
+		--              A X I - l i t e   s l a v e   s i d e
+		-- ------------------------------------------------------------
+		if s_axi_awvalid = '1' and r.s.awready = '1' then
+			v.s.awpending := '1';
+			v.s.waddr := s_axi_awaddr(C_S_AXI_ADDR_WIDTH - 1 downto 3);
+			v.s.awready := '0';
+		end if;
+		if s_axi_wvalid = '1' and r.s.wready = '1' then
+			v.s.dwpending := '1';
+			v.s.wdata := s_axi_wdata;
+			v.s.wready := '0';
+		end if;
+		if r.s.bvalid = '1' and s_axi_bready = '1' then
+			v.s.bvalid := '0';
+			v.s.awready := '1';
+			v.s.wready := '1';
+		end if;
+		if s_axi_arvalid = '1' and r.s.arready = '1' then
+			v.s.arpending := '1';
+			v.s.raddr := s_axi_araddr(C_S_AXI_ADDR_WIDTH - 1 downto 3);
+			v.s.arready := '0';
+		end if;
+		if r.s.rvalid = '1' and s_axi_rready = '1' then
+			v.s.rvalid := '0';
+			v.s.arready := '1';
+		end if;
+
+		-- ------------------------------------------------------------
+		--                  W r i t e s   t o   e n g i n e s
+		-- ------------------------------------------------------------
+		if r.w.awvalid = '1' and e_awready(r.w.eng) = '1' then
+			v.w.awvalid := '0';
+		end if;
+		if r.w.wvalid = '1' and e_wready(r.w.eng) = '1' then
+			v.w.wvalid := '0';
+		end if;
+		-- (BREADY is always high)
+		if r.w.busy = '1' and e_bvalid(r.w.eng) = '1' then
+			v.s.bresp := r.s.bresp or e_bresp(r.w.eng);
+			if r.w.bcast = '1' and r.w.eng < NBE - 1 then
+				-- replay the write to the next engine
+				v.w.eng := r.w.eng + 1;
+				v.w.awvalid := '1';
+				v.w.wvalid := '1';
+			else
+				v.w.busy := '0';
+				v.s.bvalid := '1';
+			end if;
+			-- launch of a job: a write through window JOB after which the
+			-- engine has a [k]P computation requested or running (kpjob is
+			-- registered by ecc_axi in the same cycle as its write-response,
+			-- see (s68) & (s269)). The engine is queued & window JOB unbound,
+			-- so that the next job goes to another engine. Any other write
+			-- (including a [k]P command the engine refused) leaves the engine
+			-- bound to window JOB.
+			if r.w.job = '1' and e_kpjob(r.w.eng) = '1' then
+				v.d.est(r.w.eng) := erun;
+				v.d.q((r.d.qhead + r.d.qnb) mod NBE) := r.w.eng;
+				v.d.qnb := r.d.qnb + 1;
+				v.d.bound := '0';
+			end if;
+		end if;
+
+		if r.s.awpending = '1' and r.s.dwpending = '1' and r.w.busy = '0' then
+			v.s.awpending := '0';
+			v.s.dwpending := '0';
+			v.s.bresp := "00";
+			v_win := to_integer(unsigned(
+				r.s.waddr(C_S_AXI_ADDR_WIDTH - 1 downto AXIAW)));
+			v.w.bcast := '0';
+			v.w.job := '0';
+			if v_win < NBE or v_win = MULTI_WIN_BCAST then
+				v.w.busy := '1';
+				v.w.awvalid := '1';
+				v.w.wvalid := '1';
+				if v_win = MULTI_WIN_BCAST then
+					v.w.bcast := '1';
+					v.w.eng := 0;
+				else
+					v.w.eng := v_win;
+				end if;
+			elsif v_win = MULTI_WIN_JOB then
+				if r.d.bound = '0' and v_free = '1' then
+					-- (s1) bind window JOB to an idle engine
+					v.d.bound := '1';
+					v.d.jeng := v_fid;
+					v.d.est(v_fid) := eload;
+					v.d.nxt := (v_fid + 1) mod NBE;
+				end if;
+				if v.d.bound = '1' then
+					v.w.busy := '1';
+					v.w.awvalid := '1';
+					v.w.wvalid := '1';
+					v.w.job := '1';
+					v.w.eng := v.d.jeng;
+				else
+					-- no engine available for a new job
+					v.s.bresp := SLVERR;
+					v.s.bvalid := '1';
+				end if;
+			elsif v_win = MULTI_WIN_RES then
+				if r.d.qnb > 0 then
+					v.w.busy := '1';
+					v.w.awvalid := '1';
+					v.w.wvalid := '1';
+					v.w.eng := r.d.q(r.d.qhead);
+				else
+					-- no job to collect
+					v.s.bresp := SLVERR;
+					v.s.bvalid := '1';
+				end if;
+			else
+				-- dispatcher (writes to unmapped windows are ignored)
+				if v_win = MULTI_WIN_DISP
+					and r.s.waddr(AXIAW - 1 downto 3) = W_MULTI_NEXT
+				then
+					if v_done = '1' then
+						-- (s2) result of the oldest job collected, its engine gets
+						-- available again & the next job gets bound to window RES
+						v.d.est(r.d.q(r.d.qhead)) := eidle;
+						v.d.qhead := (r.d.qhead + 1) mod NBE;
+						v.d.qnb := r.d.qnb - 1;
+					else
+						-- no job or the oldest one is not over
+						v.s.bresp := SLVERR;
+					end if;
+				end if;
+				v.s.bvalid := '1';
+			end if;
+		end if;
+
+		-- ------------------------------------------------------------
+		--                 R e a d s   f r o m   e n g i n e s
+		-- ------------------------------------------------------------
+		if r.rd.arvalid = '1' and e_arready(r.rd.eng) = '1' then
+			v.rd.arvalid := '0';
+		end if;
+		-- (RREADY is always high)
+		if r.rd.busy = '1' and e_rvalid(r.rd.eng) = '1' then
+			v.s.rdata := r.s.rdata or e_rdata(r.rd.eng);
+			v.s.rresp := r.s.rresp or e_rresp(r.rd.eng);
+			if r.rd.bcast = '1' and r.rd.eng < NBE - 1 then
+				-- replay the read to the next engine
+				v.rd.eng := r.rd.eng + 1;
+				v.rd.arvalid := '1';
+			else
+				v.rd.busy := '0';
+				v.s.rvalid := '1';
+			end if;
+		end if;
+
+		if r.s.arpending = '1' and r.rd.busy = '0' then
+			v.s.arpending := '0';
+			v_win := to_integer(unsigned(
+				r.s.raddr(C_S_AXI_ADDR_WIDTH - 1 downto AXIAW)));
+			v.s.rdata := (others => '0');
+			v.s.rresp := "00";
+			v.rd.bcast := '0';
+			if v_win < NBE or v_win = MULTI_WIN_BCAST then
+				v.rd.busy := '1';
+				v.rd.arvalid := '1';
+				if v_win = MULTI_WIN_BCAST then
+					v.rd.bcast := '1';
+					v.rd.eng := 0;
+				else
+					v.rd.eng := v_win;
+				end if;
+			elsif v_win = MULTI_WIN_JOB then
+				-- (same as (s1), v.d reflecting a binding by a write of
+				-- this very cycle)
+				if v.d.bound = '0' and v_free = '1' then
+					v.d.bound := '1';
+					v.d.jeng := v_fid;
+					v.d.est(v_fid) := eload;
+					v.d.nxt := (v_fid + 1) mod NBE;
+				end if;
+				if v.d.bound = '1' then
+					v.rd.busy := '1';
+					v.rd.arvalid := '1';
+					v.rd.eng := v.d.jeng;
+				else
+					v.s.rresp := SLVERR;
+					v.s.rvalid := '1';
+				end if;
+			elsif v_win = MULTI_WIN_RES then
+				if r.d.qnb > 0 then
+					v.rd.busy := '1';
+					v.rd.arvalid := '1';
+					v.rd.eng := r.d.q(r.d.qhead);
+				else
+					v.s.rresp := SLVERR;
+					v.s.rvalid := '1';
+				end if;
+			else
+				-- dispatcher (reads of unmapped windows return 0)
+				v.s.rvalid := '1';
+				if v_win = MULTI_WIN_DISP then
+					if r.s.raddr(AXIAW - 1 downto 3) = R_MULTI_QUEUE then
+						v.s.rdata(MULTI_QUEUE_JOB_ID_MSB downto MULTI_QUEUE_JOB_ID_LSB) :=
+							std_logic_vector(to_unsigned(r.d.jeng,
+								MULTI_QUEUE_JOB_ID_MSB - MULTI_QUEUE_JOB_ID_LSB + 1));
+						v.s.rdata(MULTI_QUEUE_JOB_BOUND) := r.d.bound;
+						v.s.rdata(MULTI_QUEUE_FREE) := r.d.bound or v_free;
+						v.s.rdata(MULTI_QUEUE_RES_ID_MSB downto MULTI_QUEUE_RES_ID_LSB) :=
+							std_logic_vector(to_unsigned(r.d.q(r.d.qhead),
+								MULTI_QUEUE_RES_ID_MSB - MULTI_QUEUE_RES_ID_LSB + 1));
+						v.s.rdata(MULTI_QUEUE_NB_MSB downto MULTI_QUEUE_NB_LSB) :=
+							std_logic_vector(to_unsigned(r.d.qnb,
+								MULTI_QUEUE_NB_MSB - MULTI_QUEUE_NB_LSB + 1));
+						v.s.rdata(MULTI_QUEUE_RES_DONE) := v_done;
+					elsif r.s.raddr(AXIAW - 1 downto 3) = R_MULTI_STATUS then
+						v.s.rdata(MULTI_STATUS_BUSY_LSB + NBE - 1
+							downto MULTI_STATUS_BUSY_LSB) := e_kpjob;
+						v.s.rdata(MULTI_STATUS_IDLE_LSB + NBE - 1
+							downto MULTI_STATUS_IDLE_LSB) := v_idle;
+					elsif r.s.raddr(AXIAW - 1 downto 3) = R_MULTI_ENGINES then
+						v.s.rdata(7 downto 0) := std_logic_vector(to_unsigned(NBE, 8));
+					end if;
+				end if;
+			end if;
+		end if;
+
+		-- ------------------------------------------------------------
+		--                      S h a r e d   T R N G
+		-- ------------------------------------------------------------
+		-- the engine served last gets the lowest priority for next word
+		if valid_s = '1' and tany = '1' then
+			if tgrant = NBE - 1 then
+				v.tptr := 0;
+			else
+				v.tptr := tgrant + 1;
+			end if;
+		end if;
+
+		-- synchronous reset
+		if s_axi_aresetn_resync = '0' then
+			v.s.awready := '1';
+			v.s.wready := '1';
+			v.s.bvalid := '0';
+			v.s.arready := '1';
+			v.s.rvalid := '0';
+			v.s.awpending := '0';
+			v.s.dwpending := '0';
+			v.s.arpending := '0';
+			v.w.busy := '0';
+			v.w.awvalid := '0';
+			v.w.wvalid := '0';
+			v.w.job := '0';
+			v.rd.busy := '0';
+			v.rd.arvalid := '0';
+			v.d.est := (others => eidle);
+			v.d.bound := '0';
+			v.d.jeng := 0;
+			v.d.nxt := 0;
+			v.d.q := (others => 0);
+			v.d.qhead := 0;
+			v.d.qnb := 0;
+			v.tptr := 0;
+		end if;
+
+		rin <= v;
+	end process comb;
+
+	regs: process(s_axi_aclk)
+	begin
+		if s_axi_aclk'event and s_axi_aclk = '1' then
+			r <= rin;
+		end if;
+	end process regs;
+
+	-- round-robin choice of the server of internal random numbers that
+	-- receives the next post-processed word, among those that are ready
+	arb: process(r.tptr, e_trngrdy)
+		variable v_j : natural range 0 to NBE - 1;
+	begin
+		tgrant <= 0;
+		tany <= '0';
+		for i in NBE - 1 downto 0 loop
+			v_j := (r.tptr + i) mod NBE;
+			if e_trngrdy(v_j) = '1' then
+				tgrant <= v_j;
+				tany <= '1';
+			end if;
+		end loop;
+	end process arb;
+
+	rdy_s <= tany;
+	tv: for i in 0 to NBE - 1 generate
+		e_trngvalid(i) <= valid_s when tgrant = i else '0';
+	end generate;
+
+	s_axi_awready <= r.s.awready;
+	s_axi_wready <= r.s.wready;
+	s_axi_bresp <= r.s.bresp;
+	s_axi_bvalid <= r.s.bvalid;
+	s_axi_arready <= r.s.arready;
+	s_axi_rdata <= r.s.rdata;
+	s_axi_rresp <= r.s.rresp;
+	s_axi_rvalid <= r.s.rvalid;
+
+	e_awaddr <= r.s.waddr(AXIAW - 1 downto 3) & "000";
+	e_wdata <= r.s.wdata;
+	e_wstrb <= (others => '1');
+	e_araddr <= r.s.raddr(AXIAW - 1 downto 3) & "000";
+	ev: for i in 0 to NBE - 1 generate
+		e_awvalid(i) <= r.w.awvalid when r.w.eng = i else '0';
+		e_wvalid(i) <= r.w.wvalid when r.w.eng = i else '0';
+		e_arvalid(i) <= r.rd.arvalid when r.rd.eng = i else '0';
+	end generate;
+
+	irq <= or_all(e_irq);
+	busy <= or_all(e_busy);
+	dbgtrigger <= or_all(e_dbgtrigger);
+	dbghalted <= or_all(e_dbghalted);
+	dbgptrdy <= '0';
+
+	trngta_s <= to_unsigned(trngta, 16);
+	trngraddr_s <= (others => '0');
+	trngidle_s <= (others => '0');
+	zero8 <= (others => '0');
+
+	-- engines
+	e: for i in 0 to NBE - 1 generate
+		e0: ecc
+			generic map(
+				C_S_AXI_DATA_WIDTH => C_S_AXI_DATA_WIDTH,
+				C_S_AXI_ADDR_WIDTH => AXIAW,
+				C_SHARED_TRNG => TRUE)
+			port map(
+				s_axi_aclk => s_axi_aclk,
+				s_axi_aresetn => s_axi_aresetn,
+				s_axi_awaddr => e_awaddr,
+				s_axi_awprot => "000",
+				s_axi_awvalid => e_awvalid(i),
+				s_axi_awready => e_awready(i),
+				s_axi_wdata => e_wdata,
+				s_axi_wstrb => e_wstrb,
+				s_axi_wvalid => e_wvalid(i),
+				s_axi_wready => e_wready(i),
+				s_axi_bresp => e_bresp(i),
+				s_axi_bvalid => e_bvalid(i),
+				s_axi_bready => '1',
+				s_axi_araddr => e_araddr,
+				s_axi_arprot => "000",
+				s_axi_arvalid => e_arvalid(i),
+				s_axi_arready => e_arready(i),
+				s_axi_rdata => e_rdata(i),
+				s_axi_rresp => e_rresp(i),
+				s_axi_rvalid => e_rvalid(i),
+				s_axi_rready => '1',
+				-- (no DMA in ecc_multi, ports m_axi_* are left unconnected)
+				clkmm => clkmm,
+				irq => e_irq(i),
+				busy => e_busy(i),
+				kpjob => e_kpjob(i),
+				dbgtrigger => e_dbgtrigger(i),
+				dbghalted => e_dbghalted(i),
+				dbgptdata => zero8,
+				dbgptvalid => '0',
+				dbgptrdy => open,
+				-- entropy from the shared TRNG
+				trngdata => data_s,
+				trngvalid => e_trngvalid(i),
+				trngrdy => e_trngrdy(i)
+			);
+	end generate;
+
+	-- shared TRNG: entropy source ('ES-TRNG' or, in simulation with 'notrng'
+	-- set, 'es_trng_sim') & post-processing unit, both with the settings
+	-- that ecc_axi gives them out of reset when not in debug mode
+	t0: if notrng = FALSE generate
+		t0: es_trng
+			port map(
+				clk => s_axi_aclk,
+				rstn => s_axi_aresetn_resync,
+				swrst => '0',
+				data_t => data_t,
+				valid_t => valid_t,
+				rdy_t => rdy_t,
+				dbgtrngta => trngta_s,
+				dbgtrngrawreset => '0',
+				dbgtrngrawfull => dbgtrngrawfull,
+				dbgtrngrawwaddr => dbgtrngrawwaddr,
+				dbgtrngrawraddr => trngraddr_s,
+				dbgtrngrawdata => dbgtrngrawdata,
+				dbgtrngrawfiforeaddis => '0',
+				dbgtrngrawduration => dbgtrngrawduration,
+				dbgtrngvonneuman => '1',
+				dbgtrngidletime => trngidle_s
+			);
+	end generate;
+
+	-- pragma translate_off
+	t1: if notrng = TRUE generate
+		t0: es_trng_sim
+			port map(
+				clk => s_axi_aclk,
+				rstn => s_axi_aresetn_resync,
+				swrst => '0',
+				data_t => data_t,
+				valid_t => valid_t,
+				rdy_t => rdy_t,
+				dbgtrngta => trngta_s,
+				dbgtrngrawreset => '0',
+				dbgtrngrawfull => dbgtrngrawfull,
+				dbgtrngrawwaddr => dbgtrngrawwaddr,
+				dbgtrngrawraddr => trngraddr_s,
+				dbgtrngrawdata => dbgtrngrawdata,
+				dbgtrngrawfiforeaddis => '0',
+				dbgtrngrawduration => dbgtrngrawduration,
+				dbgtrngvonneuman => '1',
+				dbgtrngidletime => trngidle_s
+			);
+	end generate;
+	-- pragma translate_on
+
+	p0: ecc_trng_pp
+		port map(
+			clk => s_axi_aclk,
+			rstn => s_axi_aresetn_resync,
+			swrst => '0',
+			irn_reset => '0',
+			data_t => data_t,
+			valid_t => valid_t,
+			rdy_t => rdy_t,
+			data_s => data_s,
+			valid_s => valid_s,
+			rdy_s => rdy_s,
+			dbgtrngusepseudosource => '0',
+			dbgtrngrawpullppdis => '0',
+			dbgpseudotrngdata => zero8,
+			dbgpseudotrngvalid => '0',
+			dbgpseudotrngrdy => open
+		);
+
+	-- pragma translate_off
+	process
+	begin
+		echo("[  ecc_multi.vhd ]: Config: ");
+		echo(integer'image(NBE));
+		echo(" engines, AXI address bus of ");
+		echo(integer'image(C_S_AXI_ADDR_WIDTH));
+		echol("-bit");
+		wait;
+	end process;
+	-- pragma translate_on
+
+end architecture rtl;
@@ -99,15 +99,37 @@ package ecc_pkg is
 	-- parameter n is computed automatically based on nn and ww
 	constant FP_ADDR_LSB : positive := log2(n - 1);
 
+	-- PT_SLOT_SZ
+	--
+	-- this is the number of bits required to encode the index of one of the
+	-- point slots of the resident point memory in ecc_axi (there are
+	-- 2**PT_SLOT_SZ of them, each holding the two affine coordinates of one
+	-- point, slot 0 also being the base point of [k]G commands). Slots live
+	-- outside of ecc_fp_dram so this parameter has no effect on the size of
+	-- opcode words (contrary to nblargenb), only on the size of the resident
+	-- point memory (2**PT_SLOT_SZ x 2n limbs of ww bits)
+	constant PT_SLOT_SZ : positive := 3;
+
+	-- JOBQ_SZ
+	--
+	-- this is the number of bits required to encode the index of one of the
+	-- entries of the job queue in ecc_axi (there are 2**JOBQ_SZ of them, each
+	-- holding the scalar, its masks, the token & the input point of a [k]P
+	-- job, along with its result once computed). Like PT_SLOT_SZ, it has no
+	-- effect on the size of opcode words, only on the size of the two queue
+	-- memories (2**JOBQ_SZ x 8n & 2**JOBQ_SZ x 2n limbs of ww bits). Values
+	-- above 3 are not supported (see field JOBQ_STATUS_NB in ecc_software)
+	constant JOBQ_SZ : positive := 1;
+
 	-- FP_ADDR
 	--
 	-- this is the number of bits of both R/W address-bus to/from ecc_fp_dram
 	constant FP_ADDR : positive := FP_ADDR_MSB + FP_ADDR_LSB;
 
 	-- bitwidth of address bus to ecc_curve_iram
-	-- the default value is 9, matching value 512 for parameter nbopcodes
+	-- the default value is 10, matching value 1024 for parameter nbopcodes
 	-- in ecc_customize.vhd
-	constant IRAM_ADDR_SZ : positive := log2(nbopcodes - 1); -- 9
+	constant IRAM_ADDR_SZ : positive := log2(nbopcodes - 1); -- 10
 
 	subtype std_logic_ww is std_logic_vector(ww - 1 downto 0);
 
@@ -135,6 +157,9 @@ package ecc_pkg is
 		shf : std_logic;
 		-- extra flag for NNSRL instruction (NNSRLs variant)
 		ssrl_sh : std_logic;
+		-- extra flag for NNADD/NNSUB (FPADD/FPSUB variants, with modular
+		-- correction performed by ecc_fp itself)
+		fpm : std_logic;
 		-- pragma translate_off
 		parsh : std_logic;
 		oposhr : std_logic;
@@ -171,6 +196,8 @@ package ecc_pkg is
 	constant CST_ADDR_XR0BK : stdop := std_nat(LARGE_NB_XR0BK_ADDR, FP_ADDR_MSB);
 	constant CST_ADDR_YR0BK : stdop := std_nat(LARGE_NB_YR0BK_ADDR, FP_ADDR_MSB);
 	constant CST_ADDR_TOKEN : stdop := std_nat(LARGE_NB_TOKEN_ADDR, FP_ADDR_MSB);
+	constant CST_ADDR_TWOP : stdop := std_nat(LARGE_NB_TWOP_ADDR, FP_ADDR_MSB);
+	constant CST_ADDR_RED : stdop := std_nat(LARGE_NB_RED_ADDR, FP_ADDR_MSB);
 
 	constant CST_ARITH_MASK_0 : integer := 10;
 	constant CST_ARITH_MASK_1 : integer := 11;
@@ -214,7 +241,7 @@ package ecc_pkg is
 	-- for branch instructions, target address is given as an immediate value the
 	-- bit width of which depends on parameter nbopcodes (in ecc_customize.vhd)
 	-- which defines the size of microcode memory ecc_curve_iram. Nominaly
-	-- nbopcodes = 512, hence the address immediate value is 9-bit long
+	-- nbopcodes = 1024, hence the address immediate value is 10-bit long
 	constant OP_BR_IMM_SZ : positive := IRAM_ADDR_SZ;
 	--constant OP_BR_IMM_MSB : integer := OPA_MSB; --TODO
 	--constant OP_BR_IMM_LSB : integer := OP_BR_IMM_MSB - OP_BR_IMM_SZ + 1;
@@ -242,6 +269,9 @@ package ecc_pkg is
 	constant OPCODE_ARITH_RNH : std_logic_vector(OP_OP_SZ - 1 downto 0) := "1100";
 	constant OPCODE_ARITH_RNF : std_logic_vector(OP_OP_SZ - 1 downto 0) := "1101";
 	constant OPCODE_ARITH_SRH : std_logic_vector(OP_OP_SZ - 1 downto 0) := "1110";
+	-- FPADD & FPSUB share the same opcode, the X bit (which has no meaning
+	-- for them) is used to tell one from the other (X = 1 for FPADD)
+	constant OPCODE_ARITH_FPM : std_logic_vector(OP_OP_SZ - 1 downto 0) := "1111";
 
 	-- constant for the conditional test branchs (field OPCODE of the opcode word)
 	constant OPCODE_BRA_B : std_logic_vector(OP_OP_SZ - 1 downto 0) := "0001";
@@ -252,6 +282,11 @@ package ecc_pkg is
 	constant OPCODE_BRA_CALL : std_logic_vector(OP_OP_SZ - 1 downto 0) := "0110";
 	constant OPCODE_BRA_CALLSN : std_logic_vector(OP_OP_SZ - 1 downto 0) := "0111";
 	constant OPCODE_BRA_RET : std_logic_vector(OP_OP_SZ - 1 downto 0) := "1000";
+	-- branch on the shape of curve parameter 'a' (as declared by software
+	-- through W_CURVE_A register, see ecc_software.vhd): not taken for a
+	-- generic 'a', taken to the immediate if a = 0 and to the immediate + 1
+	-- if a = -3 (so that a single branch dispatches the three cases)
+	constant OPCODE_BRA_BAS : std_logic_vector(OP_OP_SZ - 1 downto 0) := "1001";
 
 	-- states of ecc_scalar
 	constant DEBUG_STATE_ANY_OR_IDLE : std_logic4 := std_nat(0, 4);
@@ -352,6 +387,7 @@ package ecc_pkg is
 		xy : std_logic_vector(ww - 1 downto 0);
 		xen : std_logic;
 		yen : std_logic;
+		sq : std_logic;
 		go : std_logic;
 		zren : std_logic;
 		irq_ack : std_logic;
@@ -374,6 +410,8 @@ package ecc_pkg is
 
 	function set_irn_width_sh return positive;
 
+	function set_cap_nnmax_width return positive;
+
 	-- the following is used between ecc_axi & ecc_scalar to encode operations
 	-- and does not need to be known by software
 	--   point based operations encoding (used between ecc_axi & ecc_scalar)
@@ -383,13 +421,28 @@ package ecc_pkg is
 	constant ECC_AXI_POINT_NEG : std_logic_vector(2 downto 0) := "011";
 	constant ECC_AXI_POINT_EQU : std_logic_vector(2 downto 0) := "100";
 	constant ECC_AXI_POINT_OPP : std_logic_vector(2 downto 0) := "101";
+	constant ECC_AXI_POINT_NRM : std_logic_vector(2 downto 0) := "110";
+	constant ECC_AXI_POINT_DEC : std_logic_vector(2 downto 0) := "111";
 
 	--   Fp arithmetic operations encoding (used between ecc_axi & ecc_scalar)
+	--   This one is also the encoding software uses in field CTRL_FP_OPID of
+	--   W_CTRL register (see ecc_software.vhd) along with bit CTRL_FP_OP.
+	--   (inversion is done by exponentiation, see .modinvL)
 	constant ECC_AXI_FP_ADD : std_logic_vector(2 downto 0) := "000";
 	constant ECC_AXI_FP_SUB : std_logic_vector(2 downto 0) := "001";
 	constant ECC_AXI_FP_MUL : std_logic_vector(2 downto 0) := "010";
 	constant ECC_AXI_FP_INV : std_logic_vector(2 downto 0) := "011";
-	constant ECC_AXI_FP_INVEXP : std_logic_vector(2 downto 0) := "100";
+	constant ECC_AXI_FP_SQR : std_logic_vector(2 downto 0) := "100";
+	constant ECC_AXI_FP_EXP : std_logic_vector(2 downto 0) := "101";
+	constant ECC_AXI_FP_MTY : std_logic_vector(2 downto 0) := "110"; -- x.R
+	constant ECC_AXI_FP_NOMTY : std_logic_vector(2 downto 0) := "111"; -- x/R
+
+	--   Double scalar multiplication steps (used between ecc_axi & ecc_scalar)
+	--   The two bits of the last three ones are the msb of k1 and k2
+	constant ECC_AXI_KP2_LOAD : std_logic_vector(1 downto 0) := "00";
+	constant ECC_AXI_KP2_P1 : std_logic_vector(1 downto 0) := "01";
+	constant ECC_AXI_KP2_P2 : std_logic_vector(1 downto 0) := "10";
+	constant ECC_AXI_KP2_P12 : std_logic_vector(1 downto 0) := "11";
 
 	-- ---------------------------------------------------------------------------
 	-- ECC_CURVE specifics
@@ -418,6 +471,12 @@ package ecc_pkg is
 	-- registers are the bits "AXIAW - 2 downto 3".
 	constant ADB : natural := AXIAW - 3;
 
+	-- AXIAW_MULTI
+	-- width of AXI address bus of top-level ecc_multi: the bits above
+	-- AXIAW - 1 give the index of the window of registers accessed (see
+	-- MULTI_WIN_* in ecc_software.vhd)
+	constant AXIAW_MULTI : integer := AXIAW + log2(nbengines + 3);
+
 	-- Note: the alignment of registers on 8-byte boundaries is effective
 	--       whatever the IP being being configured as a 32-bit AXI interface
 	--       (this is the case when axi32or64 = 32 in ecc_customize.vhd)
@@ -513,6 +572,18 @@ package body ecc_pkg is
 		return tmp;
 	end function set_irn_width_sh;
 
+	-- Field NNMAX of R_CAPABILITIES register is limited to 16 bits, as the
+	-- capability bits above it (CAP_KP2, CAP_DMA & CAP_FOP, see ecc_software)
+	-- would otherwise be overwritten by the upper bits of 'nn'.
+	function set_cap_nnmax_width return positive is
+	begin
+		assert (log2(nn) <= 16)
+			report "value of nn user parameter must be less than 2**16 " &
+			       "(field NNMAX of R_CAPABILITIES register is 16-bit wide)"
+				severity failure;
+		return log2(nn);
+	end function set_cap_nnmax_width;
+
 	function set_phys_addr_width return positive is
 		variable tmp : positive;
 	begin
@@ -73,6 +73,14 @@ entity ecc_scalar is
 		--   other point-based computations
 		dopop : in std_logic;
 		popid : in std_logic_vector(2 downto 0); -- id defined in ecc_pkg
+		popproj : in std_logic; -- result left in projective form
+		popprojin : in std_logic; -- R1 given in projective form
+		popfp : in std_logic; -- field arithmetic operation (popid ignored)
+		fpopid : in std_logic_vector(2 downto 0); -- id defined in ecc_pkg
+		fpmty : in std_logic; -- operands & result in Montgomery form
+		decodd : in std_logic; -- point decompression: odd square root
+		popkp2 : in std_logic; -- double scalar multiplication (popid ignored)
+		kp2op : in std_logic_vector(1 downto 0); -- id defined in ecc_pkg
 		popdone : out std_logic;
 		yes : out std_logic;
 		yesen : out std_logic;
@@ -209,6 +217,9 @@ architecture rtl of ecc_scalar is
 		check : std_logic;
 		equal : std_logic;
 		opp : std_logic;
+		dec : std_logic;
+		kp2 : std_logic;
+		proj : std_logic;
 		step : std_logic_vector(1 downto 0);
 		equalx : std_logic;
 		done : std_logic;
@@ -310,7 +321,36 @@ architecture rtl of ecc_scalar is
 	constant OPPOSITEY_ROUTINE : natural := 29;
 	constant IS_ON_CURVE_ROUTINE : natural := 30;
 	constant ZDBLSW_ROUTINE : natural := 31;
-	--constant NOP_ROUTINE : natural := 32;
+	-- projective point ops
+	constant ADDITION_PROJ_AFF_ROUTINE : natural := 32;
+	constant ADDITION_PROJ_ROUTINE : natural := 33;
+	constant ADDITION_PROJ_END_ROUTINE : natural := 34;
+	constant DOUBLE_PROJ_AFF_ROUTINE : natural := 35;
+	constant DOUBLE_PROJ_ROUTINE : natural := 36;
+	constant PROJ_NORM_ROUTINE : natural := 37;
+	-- field arithmetic ops
+	constant FP_ADD_ROUTINE : natural := 38;
+	constant FP_SUB_ROUTINE : natural := 39;
+	constant FP_MUL_ROUTINE : natural := 40;
+	constant FP_INV_ROUTINE : natural := 41;
+	constant FP_SQR_ROUTINE : natural := 42;
+	constant FP_EXP_ROUTINE : natural := 43;
+	constant FP_MTY_ROUTINE : natural := 44;
+	constant FP_NOMTY_ROUTINE : natural := 45;
+	-- (same, operands & result in Montgomery form)
+	constant FP_MULM_ROUTINE : natural := 46;
+	constant FP_INVM_ROUTINE : natural := 47;
+	constant FP_SQRM_ROUTINE : natural := 48;
+	constant FP_EXPM_ROUTINE : natural := 49;
+	-- point decompression
+	constant DECOMPRESS_EVEN_ROUTINE : natural := 50;
+	constant DECOMPRESS_ODD_ROUTINE : natural := 51;
+	-- double scalar multiplication
+	constant KP2_LOAD_ROUTINE : natural := 52;
+	constant KP2_P1_ROUTINE : natural := 53;
+	constant KP2_P2_ROUTINE : natural := 54;
+	constant KP2_P12_ROUTINE : natural := 55;
+	--constant NOP_ROUTINE : natural := 56;
 
 	-- Address of the routines below (all constants whose name starts with
 	-- "ECC_IRAM_" (see below definition of array constant EXEC_ADDR) are
@@ -345,7 +385,7 @@ architecture rtl of ecc_scalar is
 	-- to be synthesized as a synchronous SRAM memory (either for FPGA or
 	-- ASIC target) should not take a big effort in modifying the RTL below
 	subtype std_logic_pc is std_logic_vector(IRAM_ADDR_SZ - 1 downto 0);
-	type exec_addr_type is array(0 to 31) of std_logic_pc;
+	type exec_addr_type is array(0 to 55) of std_logic_pc;
 	constant EXEC_ADDR : exec_addr_type := ( -- (s115)  --  matching routine:
 		CONSTMTY0_ROUTINE => ECC_IRAM_CONSTMTY0_ADDR,     -- .constMTY0L[_export]
 		CONSTMTY1_ROUTINE => ECC_IRAM_CONSTMTY1_ADDR,     -- .constMTY1L[_export]
@@ -383,8 +423,37 @@ architecture rtl of ecc_scalar is
 		                                                  -- .addition_endL[_export]
 		ZDBLSW_ROUTINE => ECC_IRAM_ZDBL_SW_ADDR,          -- .zdbl_swL[_export]
 		GET_TOKEN_ROUTINE => ECC_IRAM_GET_TOKEN_ADDR,     -- .get_tokenL[_export]
-		MASK_TOKEN_ROUTINE => ECC_IRAM_TOKEN_KP_MASK_ADDR --.token_kP_maskL[_export]
-		-- NOP_ROUTINE =>         (not used here, clumsy exceeds 31, and for nothing)
+		MASK_TOKEN_ROUTINE => ECC_IRAM_TOKEN_KP_MASK_ADDR, --.token_kP_maskL[_export]
+		-- projective point-level routines
+		ADDITION_PROJ_AFF_ROUTINE => ECC_IRAM_ADDITION_PROJ_AFF_ADDR,
+		                                              -- .addition_proj_affL[_export]
+		ADDITION_PROJ_ROUTINE => ECC_IRAM_ADDITION_PROJ_ADDR,
+		                                                  -- .addition_projL[_export]
+		ADDITION_PROJ_END_ROUTINE => ECC_IRAM_ADDITION_PROJ_END_ADDR,
+		                                              -- .addition_proj_endL[_export]
+		DOUBLE_PROJ_AFF_ROUTINE => ECC_IRAM_DOUBLE_PROJ_AFF_ADDR,
+		                                                -- .double_proj_affL[_export]
+		DOUBLE_PROJ_ROUTINE => ECC_IRAM_DOUBLE_PROJ_ADDR, -- .double_projL[_export]
+		PROJ_NORM_ROUTINE => ECC_IRAM_PROJ_NORM_ADDR,     -- .proj_normL[_export]
+		FP_ADD_ROUTINE => ECC_IRAM_FP_ADD_ADDR,           -- .fp_addL[_export]
+		FP_SUB_ROUTINE => ECC_IRAM_FP_SUB_ADDR,           -- .fp_subL[_export]
+		FP_MUL_ROUTINE => ECC_IRAM_FP_MUL_ADDR,           -- .fp_mulL[_export]
+		FP_INV_ROUTINE => ECC_IRAM_FP_INV_ADDR,           -- .fp_invL[_export]
+		FP_SQR_ROUTINE => ECC_IRAM_FP_SQR_ADDR,           -- .fp_sqrL[_export]
+		FP_EXP_ROUTINE => ECC_IRAM_FP_EXP_ADDR,           -- .fp_expL[_export]
+		FP_MTY_ROUTINE => ECC_IRAM_FP_MTY_ADDR,           -- .fp_mtyL[_export]
+		FP_NOMTY_ROUTINE => ECC_IRAM_FP_NOMTY_ADDR,       -- .fp_nomtyL[_export]
+		FP_MULM_ROUTINE => ECC_IRAM_FP_MULM_ADDR,         -- .fp_mulmL[_export]
+		FP_INVM_ROUTINE => ECC_IRAM_FP_INVM_ADDR,         -- .fp_invmL[_export]
+		FP_SQRM_ROUTINE => ECC_IRAM_FP_SQRM_ADDR,         -- .fp_sqrmL[_export]
+		FP_EXPM_ROUTINE => ECC_IRAM_FP_EXPM_ADDR,         -- .fp_expmL[_export]
+		DECOMPRESS_EVEN_ROUTINE => ECC_IRAM_DECOMPRESS_EVEN_ADDR, -- .decompress_evenL[_export]
+		DECOMPRESS_ODD_ROUTINE => ECC_IRAM_DECOMPRESS_ODD_ADDR,   -- .decompress_oddL[_export]
+		KP2_LOAD_ROUTINE => ECC_IRAM_KP2_LOAD_ADDR,       -- .kp2_loadL[_export]
+		KP2_P1_ROUTINE => ECC_IRAM_KP2_P1_ADDR,           -- .kp2_p1L[_export]
+		KP2_P2_ROUTINE => ECC_IRAM_KP2_P2_ADDR,           -- .kp2_p2L[_export]
+		KP2_P12_ROUTINE => ECC_IRAM_KP2_P12_ADDR          -- .kp2_p12L[_export]
+		-- NOP_ROUTINE =>         (not used here, clumsy exceeds 37, and for nothing)
 	);
 
 	-- pragma translate_off
@@ -414,7 +483,8 @@ begin
 	comb : process(r, rstn, agokp, agocstmty, doblinding, blindbits, agomtya,
 	               frdy, ferr, zero, iterate_shuffle_rdy, permuterdy, doshuffle,
 	               k_is_null, aerr_inpt_ack, aerr_outpt_ack, nndyn_nnm3,
-	               nndyn_nnp1, dopop, popid, ar0zo, ar1zo,
+	               nndyn_nnp1, dopop, popid, popproj, popprojin, popfp, fpopid,
+	               fpmty, decodd, popkp2, kp2op, ar0zo, ar1zo,
 	               swrst, first2pz, xmxz, ymyz, torsion2, kap, kapp,
 	               phimsb, kb0end, small_k_sz_en, small_k_sz_en_en, small_k_sz,
 	               gentoken, tokenact, zremaskact, zremaskbits)
@@ -574,32 +644,126 @@ begin
 				v.pop.add := '0';
 				v.pop.dbl := '0';
 				v.pop.neg := '0';
-				case popid is
-					when ECC_AXI_POINT_ADD =>
-						v.int.faddr := EXEC_ADDR(ADDITION_BEGIN_ROUTINE); -- point addition
-						v.pop.add := '1';
-						v.pop.step := "00"; -- (s61)
-						v.int.ptadd := '1';
-					when ECC_AXI_POINT_DBL =>
-						v.int.faddr := EXEC_ADDR(DOUBLE_ROUTINE); -- point doubling
-						v.pop.dbl := '1';
-					when ECC_AXI_POINT_CHK =>
-						v.int.faddr := EXEC_ADDR(IS_ON_CURVE_ROUTINE); -- is point on curve?
-						v.pop.check := '1';
-					when ECC_AXI_POINT_NEG =>
-						v.int.faddr := EXEC_ADDR(NEGATIVE_ROUTINE); -- compute -P
-						v.pop.neg := '1';
-					when ECC_AXI_POINT_EQU =>
-						v.int.faddr := EXEC_ADDR(EQUALX_ROUTINE); -- are X-coords equal?
-						v.pop.equal := '1';       -- (equality of Y-coords tested later)
-						v.pop.step := "00"; -- (s62)
-					when ECC_AXI_POINT_OPP =>
-						v.int.faddr := EXEC_ADDR(EQUALX_ROUTINE); -- are X-coords equal?
-						v.pop.opp := '1';       -- (opposition of Y-coords tested later)
-						v.pop.step := "00"; -- (s63)
-					when others =>
-						null; -- no error, ids should be filtered by ecc_axi
-				end case;
+				v.pop.dec := '0';
+				v.pop.kp2 := '0';
+				-- projective point ops (result R1 left in Montgomery domain
+				-- w/o inversion) only concern point addition & doubling, and
+				-- then R1 may be given in affine or already projective form
+				-- (popprojin) - ecc_axi ensures R0 & R1 are not null then
+				v.pop.proj := popproj;
+				if popfp = '1' then
+					-- (s125) field arithmetic operation (XR1 <- XR0 op YR0, see
+					-- (s283) in ecc_axi.vhd): a single routine, after which
+					-- statements (s24) suffice (additions & subtractions, as well
+					-- as conversions, are the same in and out of Montgomery form)
+					v.pop.proj := '0';
+					case fpopid is
+						when ECC_AXI_FP_ADD =>
+							v.int.faddr := EXEC_ADDR(FP_ADD_ROUTINE);
+						when ECC_AXI_FP_SUB =>
+							v.int.faddr := EXEC_ADDR(FP_SUB_ROUTINE);
+						when ECC_AXI_FP_MUL =>
+							if fpmty = '0' then
+								v.int.faddr := EXEC_ADDR(FP_MUL_ROUTINE);
+							else
+								v.int.faddr := EXEC_ADDR(FP_MULM_ROUTINE);
+							end if;
+						when ECC_AXI_FP_INV =>
+							if fpmty = '0' then
+								v.int.faddr := EXEC_ADDR(FP_INV_ROUTINE);
+							else
+								v.int.faddr := EXEC_ADDR(FP_INVM_ROUTINE);
+							end if;
+						when ECC_AXI_FP_SQR =>
+							if fpmty = '0' then
+								v.int.faddr := EXEC_ADDR(FP_SQR_ROUTINE);
+							else
+								v.int.faddr := EXEC_ADDR(FP_SQRM_ROUTINE);
+							end if;
+						when ECC_AXI_FP_EXP =>
+							if fpmty = '0' then
+								v.int.faddr := EXEC_ADDR(FP_EXP_ROUTINE);
+							else
+								v.int.faddr := EXEC_ADDR(FP_EXPM_ROUTINE);
+							end if;
+						when ECC_AXI_FP_MTY =>
+							v.int.faddr := EXEC_ADDR(FP_MTY_ROUTINE);
+						when ECC_AXI_FP_NOMTY =>
+							v.int.faddr := EXEC_ADDR(FP_NOMTY_ROUTINE);
+						when others =>
+							null;
+					end case;
+				elsif popkp2 = '1' then
+					-- (s127) double scalar multiplication, see (s290) in ecc_axi.vhd:
+					-- either the load of P1 & P2, or a run of the loop the entry of
+					-- which depends on the msb of k1 & k2
+					v.pop.proj := '0';
+					case kp2op is
+						when ECC_AXI_KP2_LOAD =>
+							v.int.faddr := EXEC_ADDR(KP2_LOAD_ROUTINE);
+						when ECC_AXI_KP2_P1 =>
+							v.int.faddr := EXEC_ADDR(KP2_P1_ROUTINE);
+							v.pop.kp2 := '1';
+						when ECC_AXI_KP2_P2 =>
+							v.int.faddr := EXEC_ADDR(KP2_P2_ROUTINE);
+							v.pop.kp2 := '1';
+						when ECC_AXI_KP2_P12 =>
+							v.int.faddr := EXEC_ADDR(KP2_P12_ROUTINE);
+							v.pop.kp2 := '1';
+						when others =>
+							null;
+					end case;
+				else
+					case popid is
+						when ECC_AXI_POINT_ADD =>
+							if popproj = '0' then
+								v.int.faddr := EXEC_ADDR(ADDITION_BEGIN_ROUTINE); -- point add
+							elsif popprojin = '0' then
+								v.int.faddr := EXEC_ADDR(ADDITION_PROJ_AFF_ROUTINE);
+							else
+								v.int.faddr := EXEC_ADDR(ADDITION_PROJ_ROUTINE);
+							end if;
+							v.pop.add := '1';
+							v.pop.step := "00"; -- (s61)
+							v.int.ptadd := '1';
+						when ECC_AXI_POINT_DBL =>
+							if popproj = '0' then
+								v.int.faddr := EXEC_ADDR(DOUBLE_ROUTINE); -- point doubling
+							elsif popprojin = '0' then
+								v.int.faddr := EXEC_ADDR(DOUBLE_PROJ_AFF_ROUTINE);
+							else
+								v.int.faddr := EXEC_ADDR(DOUBLE_PROJ_ROUTINE);
+							end if;
+							v.pop.dbl := '1';
+						when ECC_AXI_POINT_NRM =>
+							v.int.faddr := EXEC_ADDR(PROJ_NORM_ROUTINE); -- proj. -> affine
+						when ECC_AXI_POINT_CHK =>
+							v.int.faddr := EXEC_ADDR(IS_ON_CURVE_ROUTINE); -- is point on curve?
+							v.pop.check := '1';
+						when ECC_AXI_POINT_NEG =>
+							v.int.faddr := EXEC_ADDR(NEGATIVE_ROUTINE); -- compute -P
+							v.pop.neg := '1';
+						when ECC_AXI_POINT_EQU =>
+							v.int.faddr := EXEC_ADDR(EQUALX_ROUTINE); -- are X-coords equal?
+							v.pop.equal := '1';       -- (equality of Y-coords tested later)
+							v.pop.step := "00"; -- (s62)
+						when ECC_AXI_POINT_OPP =>
+							v.int.faddr := EXEC_ADDR(EQUALX_ROUTINE); -- are X-coords equal?
+							v.pop.opp := '1';       -- (opposition of Y-coords tested later)
+							v.pop.step := "00"; -- (s63)
+						when ECC_AXI_POINT_DEC =>
+							-- (s126) YR1 <- sqrt(XR1^3 + a.XR1 + b), see (s285)
+							-- in ecc_axi.vhd
+							if decodd = '0' then
+								v.int.faddr := EXEC_ADDR(DECOMPRESS_EVEN_ROUTINE);
+							else
+								v.int.faddr := EXEC_ADDR(DECOMPRESS_ODD_ROUTINE);
+							end if;
+							v.pop.dec := '1';
+						when others =>
+							null; -- no error, ids should be filtered by ecc_axi
+					end case;
+				end if;
 				-- sample now the possible null-state of R0 & R1 points (from signals
 				-- ar[01]zo, which are driven by ecc_axi) so that even if SW changes
 				-- these in the current of operation (it is possible in debug mode)
@@ -800,7 +964,11 @@ begin
 							v.pop.done := '0';
 							v.pop.computing := '1';
 						elsif r.pop.step = "01" then
-							v.int.faddr := EXEC_ADDR(ADDITION_END_ROUTINE);
+							if r.pop.proj = '0' then
+								v.int.faddr := EXEC_ADDR(ADDITION_END_ROUTINE);
+							else
+								v.int.faddr := EXEC_ADDR(ADDITION_PROJ_END_ROUTINE);
+							end if;
 							v.int.fgo := '1'; -- (s78), see (s67)
 							-- (s60), following statements are bypasses of the ones
 							-- in (s24) above
@@ -868,7 +1036,31 @@ begin
 						-- since R1 <- [2]R0, R1 gets the state (regarding nullity) that
 						-- R0 was showing at the time computation was set OR it is set
 						-- to nullity if R0 was detected to be a 2-torsion point
-						v.int.ar1zi := r.ctrl.r0z or torsion2;
+						-- (in projective mode R1 <- [2]R1, R1 not being null)
+						v.int.ar1zi := (r.ctrl.r0z and not r.pop.proj) or torsion2;
+						v.int.ar01zien := '1'; -- stays asserted 1 cycle thx to (s28)
+					elsif r.pop.dec = '1' then
+						-- ----------------------------------
+						-- operation was a point DECOMPRESSION
+						-- ----------------------------------
+						-- the Z flag tells whether the square root computed in YR1
+						-- is a genuine one (i.e if XR1 is the x-coordinate of a point
+						-- on the curve), which is answered as for a CHECK operation.
+						-- Only in that case does R1 become a (non null) point.
+						v.pop.yes := zero;
+						v.pop.yesen := '1'; -- stays asserted only 1 cycle thx to (s27)
+						v.int.ar1zi := not zero;
+						v.int.ar01zien := '1'; -- stays asserted 1 cycle thx to (s28)
+					elsif r.pop.kp2 = '1' then
+						-- ----------------------------------------------
+						-- operation was a DOUBLE SCALAR MULTIPLICATION run
+						-- ----------------------------------------------
+						-- the Z flag tells whether R1 holds [k1]P1 + [k2]P2 (see
+						-- .kp2_endL & .kp2_exceptL), which is answered as for a
+						-- CHECK operation. Otherwise R1 is marked null.
+						v.pop.yes := zero;
+						v.pop.yesen := '1'; -- stays asserted only 1 cycle thx to (s27)
+						v.int.ar1zi := not zero;
 						v.int.ar01zien := '1'; -- stays asserted 1 cycle thx to (s28)
 					elsif r.pop.neg = '1' then
 						-- -------------------------
@@ -2057,7 +2249,8 @@ begin
 				v.int.permuteundo := '0';
 			end if;
 			v.pop.done := '0';
-			-- no need to reset r.pop.equal, r.pop.opp, r.pop.equalx, r.pop.step
+			-- no need to reset r.pop.equal, r.pop.opp, r.pop.equalx, r.pop.step,
+			-- r.pop.proj
 			v.pop.yes := '0';
 			v.pop.yesen := '0';
 			v.int.ar01zien := '0';
@@ -51,7 +51,17 @@ package ecc_software is
 	constant W_ERR_ACK : rat := std_nat(10, ADB);            -- 0x050
 	constant W_SMALL_SCALAR : rat := std_nat(11, ADB);       -- 0x058
 	constant W_SOFT_RESET : rat := std_nat(12, ADB);         -- 0x060
-	-- reserved                                              -- 0x060...0x0f8
+	-- reserved                                              -- 0x068
+	constant W_PT_SLOT : rat := std_nat(14, ADB);            -- 0x070
+	constant W_CURVE_A : rat := std_nat(15, ADB);            -- 0x078
+	constant W_PT_DEC : rat := std_nat(16, ADB);             -- 0x080
+	constant W_DMA_RING : rat := std_nat(17, ADB);           -- 0x088
+	constant W_DMA_CTRL : rat := std_nat(18, ADB);           -- 0x090
+	constant W_DMA_TAIL : rat := std_nat(19, ADB);           -- 0x098
+	constant W_KP2 : rat := std_nat(20, ADB);                -- 0x0a0
+	constant W_JOBQ_CTRL : rat := std_nat(21, ADB);          -- 0x0a8
+	constant W_MODULUS : rat := std_nat(22, ADB);            -- 0x0b0
+	-- reserved                                              -- 0x0b8...0x0f8
 	-- (0x100: start of write DEBUG registers)
 	constant W_DBG_HALT : rat := std_nat(32, ADB);           -- 0x100
 	constant W_DBG_BKPT : rat := std_nat(33, ADB);           -- 0x108
@@ -79,7 +89,11 @@ package ecc_software is
 	constant R_CAPABILITIES : rat := std_nat(2, ADB);        -- 0x010
 	constant R_HW_VERSION : rat := std_nat(3, ADB);          -- 0x018
 	constant R_PRIME_SIZE : rat := std_nat(4, ADB);          -- 0x020
-	-- reserved                                              -- 0x028...0x0f8
+	constant R_DMA_STATUS : rat := std_nat(5, ADB);          -- 0x028
+	constant R_DMA_HEAD : rat := std_nat(6, ADB);            -- 0x030
+	constant R_JOBQ_STATUS : rat := std_nat(7, ADB);         -- 0x038
+	constant R_JOBQ_GAP : rat := std_nat(8, ADB);            -- 0x040
+	-- reserved                                              -- 0x048...0x0f8
 	-- (0x100: start of read DEBUG registers)
 	constant R_DBG_CAPABILITIES_0 : rat := std_nat(32, ADB); -- 0x100
 	constant R_DBG_CAPABILITIES_1 : rat := std_nat(33, ADB); -- 0x108
@@ -107,6 +121,26 @@ package ecc_software is
 	constant R_DBG_TRNG_DIAG_7 : rat := std_nat(55, ADB);    -- 0x1b8
 	constant R_DBG_TRNG_DIAG_8 : rat := std_nat(56, ADB);    -- 0x1c0
 	-- reserved                                              -- 0x1c8...0x1f8
+	-- ---------------------------------------------------------------
+	-- windows of top-level ecc_multi (only if nbengines > 1) & addresses
+	-- of the registers of its dispatcher
+	-- ---------------------------------------------------------------
+	-- Window i (i.e offset i * 2**AXIAW) for i < nbengines holds all the
+	-- registers above for engine i. Accesses to window MULTI_WIN_BCAST are
+	-- replayed to all engines (reads returning the OR of their answers).
+	-- Window MULTI_WIN_DISP holds the registers of the dispatcher.
+	-- Windows MULTI_WIN_JOB & MULTI_WIN_RES hold the registers above for
+	-- the engine that the dispatcher has bound to them: resp. the engine
+	-- that receives the job being submitted & the one holding the result
+	-- of the oldest job not yet collected.
+	constant MULTI_WIN_BCAST : natural := nbengines;
+	constant MULTI_WIN_DISP : natural := nbengines + 1;
+	constant MULTI_WIN_JOB : natural := nbengines + 2;
+	constant MULTI_WIN_RES : natural := nbengines + 3;
+	constant W_MULTI_NEXT : rat := std_nat(0, ADB);          -- 0x000
+	constant R_MULTI_QUEUE : rat := std_nat(0, ADB);         -- 0x000
+	constant R_MULTI_STATUS : rat := std_nat(1, ADB);        -- 0x008
+	constant R_MULTI_ENGINES : rat := std_nat(2, ADB);       -- 0x010
 
 	-- Register bank of pseudo TRNG device (external to the IP), if any.
 	-- Write-only registers
@@ -126,13 +160,18 @@ package ecc_software is
 	constant CTRL_PT_NEG : natural := 4;
 	constant CTRL_PT_EQU : natural := 5;
 	constant CTRL_PT_OPP : natural := 6;
-	-- bits 7-9 reserved
-	-- bits 10-11 reserved
+	constant CTRL_KG : natural := 7;
+	constant CTRL_PT_PROJ : natural := 8; -- along with CTRL_PT_ADD/CTRL_PT_DBL
+	constant CTRL_PT_NORM : natural := 9;
+	constant CTRL_FP_OP : natural := 10;
+	constant CTRL_FP_MTY : natural := 11; -- along with CTRL_FP_OP
 	constant CTRL_RD_TOKEN : natural := 12;
+	constant CTRL_FP_OPID_LSB : natural := 13; -- along with CTRL_FP_OP
+	constant CTRL_FP_OPID_MSB : natural := 15;
 	constant CTRL_WRITE_NB : natural := 16;
 	constant CTRL_READ_NB : natural := 17;
 	constant CTRL_WRITE_K : natural := 18;
-	-- bit 19 reserved
+	constant CTRL_WRITE_BP : natural := 19;
 	constant CTRL_NBADDR_LSB : natural := 20;
 	constant CTRL_NBADDR_SZ : natural := 12;
 	constant CTRL_NBADDR_MSB : natural := CTRL_NBADDR_LSB + CTRL_NBADDR_SZ - 1;
@@ -157,6 +196,51 @@ package ecc_software is
 	-- bit positions in W_IRQ register
 	constant IRQ_EN : natural := 0;
 
+	-- bit positions in W_PT_SLOT register
+	constant PTSLOT_LOAD : natural := 0;
+	constant PTSLOT_SAVE : natural := 1;
+	constant PTSLOT_R0 : natural := 2;
+	constant PTSLOT_KP : natural := 3;
+	constant PTSLOT_NB_LSB : natural := 8;
+	constant PTSLOT_NB_MSB : natural := PTSLOT_NB_LSB + PT_SLOT_SZ - 1;
+
+	-- bit positions in W_CURVE_A register
+	constant CURVE_A_ZERO : natural := 0;
+	constant CURVE_A_M3 : natural := 1;
+
+	-- bit positions in W_PT_DEC register
+	constant PTDEC_ODD : natural := 0;
+
+	-- bit positions in W_KP2 register
+	constant KP2_RUN : natural := 0; -- 0: load P1 & P2, 1: compute [k1]P1 + [k2]P2
+	constant KP2_P1 : natural := 1; -- msb of k1 (only with KP2_RUN)
+	constant KP2_P2 : natural := 2; -- msb of k2 (only with KP2_RUN)
+
+	-- bit positions in W_DMA_CTRL register
+	-- (W_DMA_RING, W_DMA_TAIL, R_DMA_STATUS & R_DMA_HEAD only exist if
+	-- parameter 'dma' is set in ecc_customize, they are handled by ecc_dma)
+	constant DMA_EN : natural := 0;
+	constant DMA_IRQEN : natural := 1;
+	constant DMA_LGSZ_LSB : natural := 8; -- log2 of nb of descriptors in ring
+	constant DMA_LGSZ_MSB : natural := 11;
+	constant DMA_NBW_LSB : natural := 16; -- nb of words of large numbers
+	constant DMA_NBW_MSB : natural := 23;
+
+	-- bit positions in W_JOBQ_CTRL register
+	--   JOBQ_OPEN: open the entry at the tail of the queue & fill its token
+	--   JOBQ_PUSH: close the open entry, making it a job to be computed
+	--   JOBQ_DROP: close the open entry, discarding it
+	--   JOBQ_RES: bind R_READ_DATA to the result of the job at the head
+	--   JOBQ_POP: release the entry at the head (its result was read)
+	constant JOBQ_OPEN : natural := 0;
+	constant JOBQ_PUSH : natural := 1;
+	constant JOBQ_POP : natural := 2;
+	constant JOBQ_RES : natural := 3;
+	constant JOBQ_DROP : natural := 4;
+
+	-- bit positions in W_MODULUS register
+	constant MOD_Q : natural := 0; -- 0: modulus p, 1: modulus q
+
 	-- bit positions in W_ERR_ACK
 	-- same as the ERR_* bits in R_STATUS (see below)
 
@@ -229,6 +313,9 @@ package ecc_software is
 	-- ----------------------------------------------
 	-- bit positions in R_STATUS register (AXI interface w/ software)
 	constant STATUS_BUSY : natural := 0;
+	constant STATUS_PROJ : natural := 1;
+	constant STATUS_MODQ : natural := 2;
+	constant STATUS_QCTX : natural := 3;
 	constant STATUS_KP : natural := 4;
 	constant STATUS_MTY : natural := 5;
 	constant STATUS_POP : natural := 6;
@@ -263,11 +350,22 @@ package ecc_software is
 
 	-- bit positions in R_CAPABILITIES register
 	constant CAP_DBG_N_PROD : natural := 0;
+	constant CAP_QCTX : natural := 1;
+	constant CAP_PROJ : natural := 2;
+	constant CAP_AFAST : natural := 3;
 	constant CAP_SHF : natural := 4;
+	constant CAP_SLOTS_LSB : natural := 5;
+	constant CAP_SLOTS_MSB : natural := 7;
 	constant CAP_NNDYN : natural := 8;
 	constant CAP_W64 : natural := 9;
+	constant CAP_STRM : natural := 10;
+	constant CAP_BP : natural := 11;
 	constant CAP_NNMAX_LSB : natural := 12;
-	constant CAP_NNMAX_MSB : natural := CAP_NNMAX_LSB + log2(nn) - 1;
+	constant CAP_NNMAX_MSB : natural := CAP_NNMAX_LSB + set_cap_nnmax_width - 1;
+	constant CAP_DEC : natural := 28; -- (nn < 2**16, see set_cap_nnmax_width)
+	constant CAP_KP2 : natural := 29; -- (nn < 2**16, see set_cap_nnmax_width)
+	constant CAP_DMA : natural := 30; -- (nn < 2**16, see set_cap_nnmax_width)
+	constant CAP_FOP : natural := 31; -- (nn < 2**16, see set_cap_nnmax_width)
 
 	-- bit positions in R_PRIME_SIZE
 	--   (same definitions as for W_PRIME_SIZE register, see above)
@@ -280,6 +378,74 @@ package ecc_software is
 	constant HW_VERSION_PATCH_LSB : natural := 0;
 	constant HW_VERSION_PATCH_MSB : natural := 15;
 
+	-- bit positions in R_DMA_STATUS register
+	constant DMA_STATUS_ACTIVE : natural := 0;
+	constant DMA_STATUS_BERR : natural := 1;
+
+	-- bit positions in R_JOBQ_STATUS register
+	--   (JOBQ_STATUS_NB is the nb of entries, 0 meaning there is no queue,
+	--   JOBQ_STATUS_QUEUED counts the jobs pushed & not yet computed, the
+	--   one being computed included, JOBQ_STATUS_DONE counts the computed
+	--   ones not yet popped, JOBQ_STATUS_FILL means the hardware is still
+	--   generating the token of the open entry (or gathering the random
+	--   to mask its scalar) or ending the transfer of a large number to/from
+	--   the queue (software must wait for it to clear before writing W_CTRL
+	--   or W_JOBQ_CTRL), the JOBQ_STATUS_HEAD_* bits
+	--   describe the job at the head, when JOBQ_STATUS_HEAD_DONE is set)
+	constant JOBQ_STATUS_NB_LSB : natural := 0;
+	constant JOBQ_STATUS_NB_MSB : natural := 3;
+	constant JOBQ_STATUS_OPEN : natural := 4;
+	constant JOBQ_STATUS_FILL : natural := 5;
+	constant JOBQ_STATUS_FULL : natural := 6;
+	constant JOBQ_STATUS_RES : natural := 7;
+	constant JOBQ_STATUS_HEAD_DONE : natural := 8;
+	constant JOBQ_STATUS_HEAD_NULL : natural := 9;
+	constant JOBQ_STATUS_HEAD_ERRIN : natural := 10;
+	constant JOBQ_STATUS_HEAD_ERROUT : natural := 11;
+	constant JOBQ_STATUS_QUEUED_LSB : natural := 16;
+	constant JOBQ_STATUS_QUEUED_MSB : natural := 19;
+	constant JOBQ_STATUS_DONE_LSB : natural := 20;
+	constant JOBQ_STATUS_DONE_MSB : natural := 23;
+
+	-- bit positions in R_JOBQ_GAP register
+	--   (nb of cycles between the end of the last job computed from the
+	--   queue & the start of the one following it back-to-back, if any)
+	constant JOBQ_GAP_LSB : natural := 0;
+	constant JOBQ_GAP_MSB : natural := 15;
+	constant JOBQ_GAP_VALID : natural := 31;
+
+	-- job descriptors of the DMA ring (see ecc_dma.vhd): 8 fields of
+	-- 32 bits, field DMA_DESC_FLAGS holding the bits DMA_FLAG_*, the
+	-- fields holding addresses being byte addresses in system memory
+	constant DMA_DESC_SZ : natural := 32; -- in bytes
+	constant DMA_DESC_FLAGS : natural := 0;
+	constant DMA_DESC_CTRL : natural := 1; -- value written to W_CTRL
+	constant DMA_DESC_K : natural := 2;
+	constant DMA_DESC_X : natural := 3;
+	constant DMA_DESC_Y : natural := 4;
+	constant DMA_DESC_RES : natural := 5;
+	constant DMA_DESC_TOKEN : natural := 6;
+	constant DMA_DESC_STATUS : natural := 7; -- written back by the IP
+	constant DMA_FLAG_TOKEN : natural := 0;
+	constant DMA_FLAG_K : natural := 1;
+	constant DMA_FLAG_PT : natural := 2;
+	constant DMA_FLAG_RES : natural := 3;
+	constant DMA_FLAG_IRQ : natural := 4;
+	constant DMA_DESC_DONE : natural := 0; -- in field DMA_DESC_STATUS
+
+	-- bit positions in R_MULTI_QUEUE & R_MULTI_STATUS
+	constant MULTI_QUEUE_JOB_ID_LSB : natural := 0; -- engine in window JOB
+	constant MULTI_QUEUE_JOB_ID_MSB : natural := 3;
+	constant MULTI_QUEUE_JOB_BOUND : natural := 4;
+	constant MULTI_QUEUE_FREE : natural := 5; -- a new job can be submitted
+	constant MULTI_QUEUE_RES_ID_LSB : natural := 8; -- engine in window RES
+	constant MULTI_QUEUE_RES_ID_MSB : natural := 11;
+	constant MULTI_QUEUE_NB_LSB : natural := 16; -- nb of jobs not collected
+	constant MULTI_QUEUE_NB_MSB : natural := 20;
+	constant MULTI_QUEUE_RES_DONE : natural := 31; -- oldest job is over
+	constant MULTI_STATUS_BUSY_LSB : natural := 0; -- 1 bit per engine
+	constant MULTI_STATUS_IDLE_LSB : natural := 16; -- 1 bit per engine
+
 	-- bit positions in R_DBG_CAPABILITIES_1 & R_DBG_CAPABILITIES_2
 	constant DBG_CAP_SPLIT : natural := 16;
 
@@ -40,10 +40,17 @@ entity mm_ndsp is
 		xyin : in std_logic_vector(ww - 1 downto 0);
 		xen : in std_logic;
 		yen : in std_logic;
+		-- squaring (X = Y): only X is transferred, Y terms are read from X page
+		-- & each cross-product x_i.x_j is only computed once, see (s130)
+		-- (only used if 'fpsqr' is set in ecc_customize)
+		sq : in std_logic;
 		fpwdata : in std_logic_vector(ww - 1 downto 0);
 		fpwe : in std_logic;
 		pen : in std_logic;
 		ppen : in std_logic;
+		-- bank of P & P' pages in IRAM (the modulus in use, quasi-static, see
+		-- (s308) in ecc_axi.vhd - only used if 'qcontext' is set in ecc_customize)
+		mbank : in std_logic := '0';
 		-- signals used only when nn_dynamic = TRUE
 		nndyn_mask : in std_logic_vector(ww - 1 downto 0);
 		nndyn_shrcnt : in unsigned(log2(ww) - 1 downto 0);
@@ -232,17 +239,43 @@ architecture rtl of mm_ndsp is
 	end record;
 
 	-- registered signals to access IRAM memory (only used if async = TRUE)
+	-- IRAM holds 2 banks of X & Y pages so that operands of the next
+	-- multiplication can be written while the current one is computed
+	-- (see (s127))
 	type iram_reg_type is record
 		-- registers connected to RAM ports
 		wdata : std_logic_vector(ww - 1 downto 0);
-		waddr_msb : std_logic_vector(1 downto 0); -- 4 pages
+		waddr_msb : std_logic_vector(2 downto 0); -- 6 pages
 		waddr_lsb : std_logic_vector(OPAGEW - 1 downto 0); -- OPAGEW bits
 		we : std_logic;
-		raddr_msb : std_logic_vector(1 downto 0); -- 4 pages
+		raddr_msb : std_logic_vector(2 downto 0); -- 6 pages
 		raddr_lsb : std_logic_vector(OPAGEW - 1 downto 0); -- OPAGEW bits
 		re : std_logic;
 	end record;
 
+	-- IRAM page of X, Y, P or P' for bank 'bank' (X & Y) or for modulus bank
+	-- 'mbank' (P & P': the 2nd one holds the modulus q, see (s308) in
+	-- ecc_axi.vhd)
+	function iram_page(page : std_logic_vector(2 downto 0);
+	                   bank : std_logic; mbank : std_logic)
+		return std_logic_vector is
+	begin
+		return ((bank and not page(1)) or (mbank and page(1)))
+			& page(1 downto 0);
+	end function iram_page;
+
+	-- IRAM only needs its 2nd bank if 'fpprefetch' or 'qcontext' is set (see
+	-- ecc_customize)
+	function set_iram_depth return positive is
+	begin
+		if fpprefetch or qcontext then
+			return 2**OADDR_WIDTH;
+		else
+			return 2**(OADDR_WIDTH - 1);
+		end if;
+	end function set_iram_depth;
+	constant IRAM_DEPTH : positive := set_iram_depth;
+
 	-- registered signals to access TRAM memory (only used if async = TRUE)
 	type tram_reg_type is record
 		-- registers connected to RAM ports
@@ -273,8 +306,8 @@ architecture rtl of mm_ndsp is
 	signal r_oram_rdata : std_logic_vector(ww - 1 downto 0);
 
 	-- 3 x r_iram_ signals below are used only in async = TRUE case
-	signal r_iram_waddr : std_logic_vector(OADDR_WIDTH - 2 downto 0);
-	signal r_iram_raddr : std_logic_vector(OADDR_WIDTH - 2 downto 0);
+	signal r_iram_waddr : std_logic_vector(OADDR_WIDTH - 1 downto 0);
+	signal r_iram_raddr : std_logic_vector(OADDR_WIDTH - 1 downto 0);
 	signal r_iram_rdata : std_logic_vector(ww - 1 downto 0);
 
 	-- 3 x r_tram_ signals below are used only in async = TRUE case
@@ -360,6 +393,11 @@ architecture rtl of mm_ndsp is
 		bigslkcnten : std_logic;
 		bigslkcntdone : std_logic;
 		slkcntdone : std_logic;
+		-- signals below are only used for squarings (r.ctrl.sq = 1), see (s130)
+		sqlsb : std_logic_vector(OPAGEW - 1 downto 0);
+		ywm1 : unsigned(log2(w - 1) - 1 downto 0);
+		yblkcnt : unsigned(log2(ndsp) - 1 downto 0);
+		ydblcry : std_logic;
 	end record;
 
 	-- registered type for control of the each DSP block in the DSP block chain
@@ -437,6 +475,9 @@ architecture rtl of mm_ndsp is
 		-- forbid_ signals below are only used in the async = TRUE case
 		forbid_resync0, forbid_resync1, forbid_resync2, forbid : std_logic;
 		zrendel : std_logic;
+		-- wbank & zrdtgl below are only used in the async = TRUE case
+		wbank : std_logic; -- IRAM bank where X & Y are written
+		zrdtgl : std_logic; -- toggled at the end of each read of ZRAM
 	end record;
 
 	-- registered signals for everything related to input resynchronization
@@ -445,6 +486,7 @@ architecture rtl of mm_ndsp is
 		go0, go1, go2, go2_del : std_logic;
 		go_ack : std_logic;
 		irq_ack0, irq_ack1, irq_ack2 : std_logic;
+		zrd0, zrd1, zrd2, zrd2_del : std_logic;
 	end record;
 
 	-- registered signals for global main control
@@ -456,6 +498,12 @@ architecture rtl of mm_ndsp is
 		active : std_logic;
 		state : state_type;
 		ioforbid : std_logic;
+		sq : std_logic;
+		-- signals below are only used in the async = TRUE case
+		gopend : std_logic; -- a go was received & computation not started yet
+		sqnext : std_logic; -- value of input sq latched along with gopend
+		zfree : std_logic; -- result of the last computation was read from ZRAM
+		rbank : std_logic; -- IRAM bank where X & Y are read from
 	end record;
 
 	-- registered signals for final output (result) barrel-shifter
@@ -579,9 +627,9 @@ begin
 		-- IRAM R-&-W address bus (only in the async = TRUE case)
 		-- ----------------------
 		-- r_iram_waddr is in the clk clock domain (for WR access by ecc_fp)
-		r_iram_waddr <= riram.waddr_msb & riram.waddr_lsb; -- 2 + OPAGEW
+		r_iram_waddr <= riram.waddr_msb & riram.waddr_lsb; -- 3 + OPAGEW
 		-- r_iram_raddr is in the clk0 clock domain
-		r_iram_raddr <= r.iram.raddr_msb & r.iram.raddr_lsb; -- 2 + OPAGEW
+		r_iram_raddr <= r.iram.raddr_msb & r.iram.raddr_lsb; -- 3 + OPAGEW
 
 		-- ----------------------
 		-- TRAM R-&-W address bus (only in the async = TRUE case)
@@ -704,16 +752,16 @@ begin
 		-- -------------
 		im00: sync2ram_sdp -- (s111)
 			generic map(
-				rdlat => sramlat, datawidth => ww, datadepth => 2**(OADDR_WIDTH-1))
+				rdlat => sramlat, datawidth => ww, datadepth => IRAM_DEPTH)
 			port map(
 				-- port A (W only)
 				clka => clk,
-				addra => r_iram_waddr,
+				addra => r_iram_waddr(log2(IRAM_DEPTH - 1) - 1 downto 0),
 				wea => riram.we,
 				dia => riram.wdata,
 				-- port B (R only)
 				clkb => clk0,
-				addrb => r_iram_raddr,
+				addrb => r_iram_raddr(log2(IRAM_DEPTH - 1) - 1 downto 0),
 				reb => r.iram.re,
 				dob => r_iram_rdata -- directly latched into r.prod.rdata, see (s1)
 			);
@@ -814,6 +862,8 @@ begin
 					rio.ppien <= '0';
 					rio.xien_prev <= '0';
 					rio.yien_prev <= '0';
+					rio.wbank <= '0';
+					rio.zrdtgl <= '0';
 					rio.piencnt <= (others => '0');
 					rio.ppiencnt <= (others => '0');
 					rzram.re <= '0';
@@ -860,16 +910,28 @@ begin
 					rio.forbid <= rio.forbid_resync2;
 					rio.xien_prev <= rio.xien;
 					rio.yien_prev <= rio.yien;
+					-- each go starts using the other bank of X & Y pages in IRAM
+					-- (only if 'fpprefetch' is set, otherwise bank 0 is always used)
+					if fpprefetch and go = '1' then
+						rio.wbank <= not rio.wbank;
+					end if;
 					-- --------------------------------------------------------
 					-- transfer of X, Y, P & P' input operands into IRAM memory
 					-- --------------------------------------------------------
-					if rio.forbid = '0' then
+					-- (s127) X & Y are written in the bank which the computation
+					-- in progress (if any) is not reading from, hence ecc_fp is
+					-- allowed to transfer them (and give us a go) while we are
+					-- busy with the previous multiplication, see (s128)
+					if rio.forbid = '0'
+						or (fpprefetch and rio.pien = '0' and rio.ppien = '0')
+					then
 						-- generation of write enable into IRAM memory
 						riram.we <= rio.xien or rio.yien or rio.pien or rio.ppien;
 						-- generation of write address into IRAM memory & its increment
 						if rio.xien = '1' then
 							if rio.xien_prev = '0' then
-								riram.waddr_msb <= X_ORAM_ADDR(1 downto 0);
+								riram.waddr_msb <=
+									iram_page(X_ORAM_ADDR, rio.wbank, '0');
 								riram.waddr_lsb <= (others => '0');
 							else
 								riram.waddr_lsb <=
@@ -877,7 +939,8 @@ begin
 							end if;
 						elsif rio.yien = '1' then
 							if rio.yien_prev = '0' then
-								riram.waddr_msb <= Y_ORAM_ADDR(1 downto 0);
+								riram.waddr_msb <=
+									iram_page(Y_ORAM_ADDR, rio.wbank, '0');
 								riram.waddr_lsb <= (others => '0');
 							else
 								riram.waddr_lsb <=
@@ -888,7 +951,8 @@ begin
 								std_logic_vector(unsigned(riram.waddr_lsb) + 1);
 							rio.piencnt <= rio.piencnt + 1;
 							if rio.piencnt = (rio.piencnt'range => '0') then
-								riram.waddr_msb <= P_ORAM_ADDR(1 downto 0);
+								riram.waddr_msb <=
+									iram_page(P_ORAM_ADDR, '0', mbank);
 								riram.waddr_lsb <= (others => '0');
 							elsif rio.piencnt = nndyn_wm1 then
 								rio.piencnt <= (others => '0');
@@ -898,7 +962,8 @@ begin
 								std_logic_vector(unsigned(riram.waddr_lsb) + 1);
 							rio.ppiencnt <= rio.ppiencnt + 1;
 							if rio.ppiencnt = (rio.ppiencnt'range => '0') then
-								riram.waddr_msb <= PP_ORAM_ADDR(1 downto 0);
+								riram.waddr_msb <=
+									iram_page(PP_ORAM_ADDR, '0', mbank);
 								riram.waddr_lsb <= (others => '0');
 							elsif rio.ppiencnt = nndyn_wm1 then
 								rio.ppiencnt <= (others => '0');
@@ -920,6 +985,9 @@ begin
 					-- from ZRAM memory
 					-- --------------------------------------------------------
 					rzram.re <= zren;
+					if zren = '0' and rzram.re = '1' then
+						rio.zrdtgl <= not rio.zrdtgl; -- see (s129)
+					end if;
 					if zren = '1' then
 						if rzram.re = '0' then
 							rzram.raddr <= (others => '0');
@@ -935,8 +1003,8 @@ begin
 	-- -----------------------------------------------------------------
 	--          combinational process (clk0 clock-domain)
 	-- -----------------------------------------------------------------
-	comb : process(r, rst22, go,
-	               xyin, xen, yen, ppen, fpwdata, fpwe, pen, zren,
+	comb : process(r, rst22, go, rio,
+	               xyin, xen, yen, sq, ppen, fpwdata, fpwe, pen, mbank, zren,
 	               irq_ack, r_oram_rdata, r_tram_rdata, r_iram_rdata,
 	               r_pram_rdata, dsp_p,
 	               nndyn_mask, nndyn_shrcnt, nndyn_shlcnt, nndyn_w, nndyn_wm1,
@@ -959,6 +1027,8 @@ begin
 		variable v_acc_tobenext : std_logic;
 		variable v_prod_nextxmsbraddr : std_logic_vector(2 downto 0);
 		variable v_prod_nextymsbraddr : std_logic_vector(2 downto 0);
+		variable v_prod_ymsbraddr : std_logic_vector(2 downto 0);
+		variable v_prod_ylsbraddr : std_logic_vector(OPAGEW - 1 downto 0);
 	begin
 		-- to ensure that 'comb' process is purely combinational
 		v := r;
@@ -1006,6 +1076,10 @@ begin
 			v.resync.irq_ack0 := irq_ack;
 			v.resync.irq_ack1 := r.resync.irq_ack0;
 			v.resync.irq_ack2 := r.resync.irq_ack1;
+			v.resync.zrd0 := rio.zrdtgl;
+			v.resync.zrd1 := r.resync.zrd0;
+			v.resync.zrd2 := r.resync.zrd1;
+			v.resync.zrd2_del := r.resync.zrd2;
 		end if;
 
 		-- --------------------------------------------------------------------
@@ -1231,12 +1305,15 @@ begin
 		if r.prod.xitoshcnt(0) = '1' then
 			v.prod.xishen := '1';
 			v.prod.xishencntzero := r.prod.xishencntzerokeep;
+			v.prod.yblkcnt := (others => '0');
 		end if;
 
 		if r.prod.xishen = '1' then
 			v.prod.xishencnt := r.prod.xishencnt - 1;
 			-- shift of operand A throughout the chain of DSP blocks
 			v.prod.aa := r.prod.rdata;
+			-- number of x_i terms of the burst, for (s131)
+			v.prod.yblkcnt := r.prod.yblkcnt + 1;
 		end if;
 
 		if r.prod.xishencnt = to_unsigned(1, log2(ndsp - 1))
@@ -1249,17 +1326,33 @@ begin
 			v.prod.xishencntzero := '0';
 			v.prod.xishen := '0';
 			v.prod.yishen := '1';
-			v.prod.yishencnt := nndyn_wm1;
-			if nndyn_wm1 = (nndyn_wm1'range => '0') then -- means nndyn_w = 1
+			-- r.prod.ywm1 is nndyn_wm1 except for the bursts of a squaring,
+			-- see (s132)
+			v.prod.yishencnt := r.prod.ywm1;
+			if r.prod.ywm1 = (r.prod.ywm1'range => '0') then -- only 1 y_j term
 				v.prod.yishencntzero := '1'; -- 'll have effect on (s11) next cycle
 			end if;
+			v.prod.ydblcry := '0';
 		end if;
 
 		-- 2nd phase: shift of B input to DSP blocks (yishen = 1)
 		if r.prod.yishen = '1' then
 			v.prod.yishencnt := r.prod.yishencnt - 1;
 			-- shift of operand B throughout the chain of DSP blocks
-			v.prod.bb := r.prod.rdata; -- (s38)
+			if r.ctrl.sq = '1' and r.ctrl.state = xy
+			  and r.prod.yblkcnt = (r.prod.yblkcnt'range => '0')
+			then
+				-- (s131) squaring: the terms which follow the x_i ones of the
+				-- burst are doubled on the fly, the msb of each one being carried
+				-- into the next one (but not into the first one), see (s130)
+				v.prod.bb := r.prod.rdata(ww - 2 downto 0) & r.prod.ydblcry;
+				v.prod.ydblcry := r.prod.rdata(ww - 1);
+			else
+				v.prod.bb := r.prod.rdata; -- (s38)
+				if r.prod.yblkcnt /= (r.prod.yblkcnt'range => '0') then
+					v.prod.yblkcnt := r.prod.yblkcnt - 1;
+				end if;
+			end if;
 		end if;
 
 		if r.prod.yishencnt = to_unsigned(1, log2(w - 1))
@@ -1414,22 +1507,29 @@ begin
 		-- CHECKED OK: v_prod_nextymsbraddr always set: no LATCH should be inferred
 		v_prod_nextxmsbraddr := (others => '0'); -- TO AVOID INFERENCE
 		v_prod_nextymsbraddr := (others => '0'); -- OF ERRONOUS LATCH
+		-- (s126) in the case of a squaring only the X operand was transferred
+		-- to us (see ecc_fp.vhd) so the y_j terms are read from the X page too
+		if r.ctrl.sq = '1' then
+			v_prod_ymsbraddr := X_ORAM_ADDR;
+		else
+			v_prod_ymsbraddr := Y_ORAM_ADDR;
+		end if;
 		case r.ctrl.state is
 
 			when idle =>
 
 				v_prod_nextxmsbraddr := X_ORAM_ADDR;
-				v_prod_nextymsbraddr := Y_ORAM_ADDR;
+				v_prod_nextymsbraddr := v_prod_ymsbraddr;
 
 			when xy =>
 
 				if v_prod_tobenext = '1' then
 					v_prod_nextxmsbraddr := X_ORAM_ADDR;
-					v_prod_nextymsbraddr := Y_ORAM_ADDR;
+					v_prod_nextymsbraddr := v_prod_ymsbraddr;
 				elsif v_prod_tobenext = '0' then
 					if r.prod.nextxymsb = '0' then
 						v_prod_nextxmsbraddr := X_ORAM_ADDR;
-						v_prod_nextymsbraddr := Y_ORAM_ADDR;
+						v_prod_nextymsbraddr := v_prod_ymsbraddr;
 					elsif r.prod.nextxymsb = '1' then
 						v_prod_nextxmsbraddr := S_ORAM_ADDR;
 						v_prod_nextymsbraddr := PP_ORAM_ADDR;
@@ -1462,7 +1562,7 @@ begin
 						v_prod_nextymsbraddr := P_ORAM_ADDR;
 					elsif r.prod.nextxymsb = '1' then
 						v_prod_nextxmsbraddr := X_ORAM_ADDR;
-						v_prod_nextymsbraddr := Y_ORAM_ADDR;
+						v_prod_nextymsbraddr := v_prod_ymsbraddr;
 					end if;
 				end if;
 
@@ -1474,11 +1574,30 @@ begin
 		-- TODO: dispatch a part of init logic on registers other than
 		-- "r.ctrl.rdy and etc" to lighten its fan-out (perhaps use a delayed
 		-- version of it)
+		-- (s128) in the async = TRUE case a go may be received while we are
+		-- still busy with the previous multiplication (its operands having
+		-- been written in the other IRAM bank, see (s127)): it is then kept
+		-- pending in r.ctrl.gopend until the previous computation is over
+		-- and its result has been read back from ZRAM (see (s129)) - this only
+		-- applies if 'fpprefetch' is set, otherwise a go is taken right away
 		if r.ctrl.rdy = '1' and
 		  (( (not async) and r.ctrl.go = '0' and go = '1' )
-		  or (    async  and r.resync.go2_del = '0' and r.resync.go2 = '1')) then
+		  or (async and (not fpprefetch)
+		      and r.resync.go2_del = '0' and r.resync.go2 = '1')
+		  or (async and fpprefetch
+		      and r.ctrl.gopend = '1' and r.ctrl.zfree = '1')) then
 			v.ctrl.active := '1';
 			v.ctrl.state := xy;
+			v.ctrl.gopend := '0';
+			if async and fpprefetch then -- statically resolved by synthesizer
+				v.ctrl.sq := r.ctrl.sqnext;
+			else
+				v.ctrl.sq := sq;
+			end if;
+			-- input sq is ignored unless 'fpsqr' is set (see ecc_customize)
+			if not fpsqr then -- statically resolved by synthesizer
+				v.ctrl.sq := '0';
+			end if;
 			v.prod.state := mult;
 			v.prod.bigslkcnt := to_unsigned(NBRT - 1, NB_BIGSLK_BITS);
 			v.prod.bigslkcnten := '1';
@@ -1494,7 +1613,8 @@ begin
 				v.oram.re := '1'; -- (s114)
 			end if;
 			if async then -- statically resolved by synthesizer
-				v.iram.raddr_msb := v_prod_nextxmsbraddr(1 downto 0);
+				v.iram.raddr_msb :=
+					iram_page(v_prod_nextxmsbraddr, r.ctrl.rbank, mbank);
 				v.iram.raddr_lsb := v_prod_nextxlsbraddr;
 			else -- synchronous case
 				v.oram.raddr_msb := v_prod_nextxmsbraddr;
@@ -1515,12 +1635,27 @@ begin
 			-- the 1st nbx count used in the 1st cycle of multiply-&-accumulate
 			-- is always the flip one (that is 0)
 			v.prod.nbx := v_prod_nextnbx;
+			v.prod.sqlsb := (others => '0'); -- see (s132)
 		end if;
 
 		if r.ctrl.go = '1' then
 			v.oram.we := '0'; -- (s120), otherwise .we may stay asserted from (s119)
 		end if;
 
+		-- sq is stable since ecc_fp started transferring X (and so long
+		-- before go was asserted), hence sampling it here is safe even
+		-- though it comes from the clk clock-domain
+		if async and fpprefetch and r.resync.go2_del = '0' and r.resync.go2 = '1'
+		then
+			v.ctrl.gopend := '1';
+			v.ctrl.sqnext := sq;
+		end if;
+
+		-- (s129) end of read of the result from ZRAM by ecc_fp
+		if async and fpprefetch and r.resync.zrd2 /= r.resync.zrd2_del then
+			v.ctrl.zfree := '1';
+		end if;
+
 		-- -----------------------------------------------------------------------
 		-- last cycle of state 'slack' (for r.prod.state):
 		--   - we switch r.ctrl.state to 'sp', 'ap', or 'idle' if it's currently
@@ -1545,7 +1680,8 @@ begin
 				v.prod.nextxymsb := '0';
 				if async then -- statically resolved by synthesizer
 					if r.ctrl.state = xy then
-						v.iram.raddr_msb := v_prod_nextxmsbraddr(1 downto 0);
+						v.iram.raddr_msb :=
+							iram_page(v_prod_nextxmsbraddr, r.ctrl.rbank, mbank);
 						v.iram.raddr_lsb := v_prod_nextxlsbraddr;
 					else
 						v.tram.raddr_msb := v_prod_nextxmsbraddr(1 downto 0);
@@ -1581,6 +1717,9 @@ begin
 				-- TODO: set large multicycle on path r.prod.nextnbx -> r.prod.nbx
 				v.prod.nbx := v_prod_nextnbx;
 				v.prod.dosavexlsbraddr := '1'; -- asserted only 1 cycle thx to (s6)
+				-- index i0 of the first x_i term of the burst, see (s132)
+				v.prod.sqlsb := std_logic_vector(
+					unsigned(r.prod.sqlsb) + to_unsigned(ndsp, OPAGEW));
 			elsif v_prod_tobenext = '0' then
 				if r.prod.bigslkcntdone = '1' then
 					v.prod.nextxymsb := '0';
@@ -1653,21 +1792,48 @@ begin
 			v.prod.bigslkcntdone := '1';
 		end if;
 
+		-- (s130) squaring (r.ctrl.sq = 1): since x_i.x_j = x_j.x_i, the
+		-- cycle of multiply-&-acc xy only computes each cross-product once.
+		-- If X_b denotes the x_i terms of burst b (i = i0 to i1 - 1, with
+		-- i0 = b * ndsp, weighted as in X) and H_b the terms above them
+		-- (i = i1 to w - 1) then X.X is the sum over all bursts of
+		-- X_b.(X_b + 2.H_b). Burst b hence streams the y_j terms starting
+		-- from j = i0 instead of j = 0 (see (s132)): first the x_j terms of
+		-- the burst themselves (giving X_b.X_b) then the terms of 2.H_b
+		-- (x_j terms doubled on the fly by (s131) - there is no extra term
+		-- on top as x_{w-1} is less than 2**(ww - 3), see definition of 'w'
+		-- in ecc_pkg.vhd). Burst b hence streams w - i0 y_j terms instead of
+		-- w & the product-terms it outputs start at weight 2.i0 instead of
+		-- i0 (see (s133)) but end at the same weight
+		if r.ctrl.sq = '1' and r.ctrl.state = xy then
+			v_prod_ylsbraddr := r.prod.sqlsb;
+		else
+			v_prod_ylsbraddr := (others => '0');
+		end if;
+
 		-- TODO: set a multicycle on path:
 		-- input nndyn_wm1 -> r.prod.yicnt
 		if r.prod.xicntzero = '1' then -- (s9)
 			v.prod.xiphase := '0';
 			v.prod.yiphase := '1';
-			v.prod.yicnt := nndyn_wm1;
+			-- (s132) the y_j terms of a burst are read from j = 0 to w - 1,
+			-- or from j = i0 in the case of a squaring, see (s130)
+			v.prod.yicnt := nndyn_wm1 - unsigned(v_prod_ylsbraddr);
+			v.prod.ywm1 := nndyn_wm1 - unsigned(v_prod_ylsbraddr);
+			if nndyn_wm1 = unsigned(v_prod_ylsbraddr) then
+				-- only one y_j term (last burst of a squaring)
+				v.prod.yicntzero := '1'; -- 'll have effect upon next cycle
+			end if;
 			if async then -- statically resolved by synthesizer
-				v.iram.raddr_msb := v_prod_nextymsbraddr(1 downto 0);
-				v.iram.raddr_lsb := (others => '0');
+				v.iram.raddr_msb :=
+					iram_page(v_prod_nextymsbraddr, r.ctrl.rbank, mbank);
+				v.iram.raddr_lsb := v_prod_ylsbraddr;
 				v.iram.re := '1';
 				v.tram.re := '0';
 			else
 				-- all terms are taken from common ORAM memory
 				v.oram.raddr_msb := v_prod_nextymsbraddr;
-				v.oram.raddr_lsb := (others => '0');
+				v.oram.raddr_lsb := v_prod_ylsbraddr;
 				-- v.oram.re := '1'; -- useless thx to (s114), (s115) & (s116)
 			end if;
 			v.prod.nextxymsb := '1';
@@ -2129,6 +2295,13 @@ begin
 				v.acc.nextnbx := unsigned(vtmp_9(log2(w) - 1 downto 0));
 			end if;
 			vtmp_10 := r.acc.ppaccbaseweight + to_unsigned(ndsp, WEIGHT_BITS + 1);
+			-- (s133) the product-terms of burst b of a squaring start at weight
+			-- 2.i0 (instead of i0) & are i0 less, see (s130) & (s132)
+			if r.ctrl.sq = '1' and r.acc.state = xy then
+				vtmp_10 := vtmp_10 + to_unsigned(ndsp, WEIGHT_BITS + 1);
+				v.acc.ppaccvalcntnext := v.acc.ppaccvalcntnext
+					- resize(vtmp_10(WEIGHT_BITS - 1 downto 1), log2(w + ndsp + 1));
+			end if;
 			v.acc.ppaccweightnext := resize(vtmp_10, WEIGHT_BITS);
 		end if;
 
@@ -2502,6 +2675,12 @@ begin
 				v.ctrl.irq := '1';
 				v.ctrl.rdy := '1';
 				v.ctrl.active := '0';
+				-- next computation is to read its X & Y from the other IRAM bank
+				-- but it can't start before this result has been read from ZRAM
+				if async and fpprefetch then -- statically resolved by synthesizer
+					v.ctrl.rbank := not r.ctrl.rbank;
+					v.ctrl.zfree := '0';
+				end if;
 				v.brl.armed := '0';
 				v.brl.shexcp := (others => '0');
 				v.brl.enright := '0';
@@ -2619,6 +2798,7 @@ begin
 		-- ---------------------------------------------------------------------
 		if rst22 = '1' then
 			v.ctrl.state := idle;
+			v.ctrl.sq := '0';
 			v.prod.state := idle;
 			v.io.piencnt := (others => '0');
 			v.io.ppiencnt := (others => '0');
@@ -2627,6 +2807,13 @@ begin
 			v.ctrl.irq := '0';
 			if async then
 				v.ctrl.ioforbid := '0'; -- I/O access is allowed after reset
+				v.ctrl.gopend := '0';
+				v.ctrl.zfree := '1';
+				v.ctrl.rbank := '0';
+				v.resync.zrd0 := '0';
+				v.resync.zrd1 := '0';
+				v.resync.zrd2 := '0';
+				v.resync.zrd2_del := '0';
 			end if;
 			v.prod.xishen := '0'; -- so that (s12) detects 1st edge of r.prod.xishen
 			for i in 0 to ndsp - 1 loop
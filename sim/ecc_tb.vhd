@@ -45,6 +45,75 @@ architecture sim of ecc_tb is
 	--
 	constant CONTINUE_ON_ERROR: boolean := FALSE;
 
+	-- Parameter 'TEST_KG'
+	--
+	-- If TRUE (and if parameter 'basepoint' is set in ecc_customize) then
+	-- each [k]P test (with P not null) is run a second time, point P being
+	-- this time written as the stored base point of the IP and the computa-
+	-- tion being issued with the [k]G command.
+	--
+	constant TEST_KG: boolean := basepoint;
+
+	-- Parameter 'TEST_STAGE'
+	--
+	-- If TRUE then each [k]P test (with P not null) is run twice more: the
+	-- first time point P is staged into a slot of the IP while the [k]P runs,
+	-- the second time the computation is started from that slot (only the
+	-- scalar being written). Requires parameter 'ptslots' to be set in
+	-- ecc_customize.
+	--
+	constant TEST_STAGE: boolean := ptslots;
+
+	-- Parameter 'TEST_DMA'
+	--
+	-- If TRUE (and if parameter 'dma' is set in ecc_customize) then each
+	-- [k]P test (with P not null) is run once more as a job of the DMA ring,
+	-- operands & result being exchanged through the emulated system memory.
+	--
+	constant TEST_DMA: boolean := TRUE;
+
+	-- Parameter 'TEST_DMA_RING'
+	--
+	-- If TRUE (and if parameter 'dma' is set in ecc_customize) then the first
+	-- [k]P test (with P not null) is followed by tests of the DMA ring itself:
+	-- as many jobs as the ring can hold are queued at once across its end, the
+	-- ring being disabled (W_DMA_CTRL) while the first one runs and enabled
+	-- again once it is stopped, then a descriptor pointing beyond the emulated
+	-- memory is queued, the error response of which must stop the ring.
+	--
+	constant TEST_DMA_RING: boolean := TRUE;
+
+	-- Parameter 'TEST_MULTI'
+	--
+	-- If TRUE (and if parameter 'nbengines' in ecc_customize is greater than
+	-- 1, in which case the DuT is ecc_multi, the tests above being run on its
+	-- engine 0) then each [k]P test (with P not null) is run once more as one
+	-- job alone and then as one job per engine, submitted at once to the job
+	-- dispatcher, and the ratio of the throughputs of both runs is displayed.
+	-- Jobs of odd rank compute [k](-P) instead of [k]P & each job has a token
+	-- of its own, so that each result is checked to be the one of the job it
+	-- is handed back for.
+	--
+	constant TEST_MULTI: boolean := TRUE;
+
+	-- Parameter 'TEST_JOBQ'
+	--
+	-- If TRUE (and if parameter 'jobqueue' is set in ecc_customize) then each
+	-- [k]P test (with P not null) is run once more as one job per entry of the
+	-- job queue of the IP, each entry being filled while the jobs pushed before
+	-- it are computed. The result of each job is checked against the one given
+	-- in the input test-vectors file & against the one obtained with CTRL_KP
+	-- (single-job path), the tokens of the entries against each other & against
+	-- the one of the single job, and the number of cycles the IP stayed idle
+	-- between the last two jobs (register R_JOBQ_GAP) is displayed.
+	--
+	constant TEST_JOBQ: boolean := jobqueue;
+
+	-- Period of s_axi_aclk, the clock of the whole IP but its Montgomery
+	-- multipliers (which run on clkmm). The duration of each [k]P test is
+	-- displayed as a number of periods of this clock.
+	constant AXI_CLK_PERIOD : time := 10 ns;
+
 	-- DuT component declaration
 	component ecc is
 		generic(
@@ -81,6 +150,39 @@ architecture sim of ecc_tb is
 			s_axi_rresp : out std_logic_vector(1 downto 0);
 			s_axi_rvalid : out std_logic;
 			s_axi_rready : in std_logic;
+			-- AXI4 master interface to system memory
+			m_axi_awaddr : out std_logic_vector(31 downto 0);
+			m_axi_awlen : out std_logic_vector(7 downto 0);
+			m_axi_awsize : out std_logic_vector(2 downto 0);
+			m_axi_awburst : out std_logic_vector(1 downto 0);
+			m_axi_awcache : out std_logic_vector(3 downto 0);
+			m_axi_awprot : out std_logic_vector(2 downto 0);
+			m_axi_awvalid : out std_logic;
+			m_axi_awready : in std_logic := '0';
+			m_axi_wdata : out std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+			m_axi_wstrb : out std_logic_vector((C_S_AXI_DATA_WIDTH/8)-1 downto 0);
+			m_axi_wlast : out std_logic;
+			m_axi_wvalid : out std_logic;
+			m_axi_wready : in std_logic := '0';
+			m_axi_bresp : in std_logic_vector(1 downto 0)
+				:= (others => '0');
+			m_axi_bvalid : in std_logic := '0';
+			m_axi_bready : out std_logic;
+			m_axi_araddr : out std_logic_vector(31 downto 0);
+			m_axi_arlen : out std_logic_vector(7 downto 0);
+			m_axi_arsize : out std_logic_vector(2 downto 0);
+			m_axi_arburst : out std_logic_vector(1 downto 0);
+			m_axi_arcache : out std_logic_vector(3 downto 0);
+			m_axi_arprot : out std_logic_vector(2 downto 0);
+			m_axi_arvalid : out std_logic;
+			m_axi_arready : in std_logic := '0';
+			m_axi_rdata : in std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0)
+				:= (others => '0');
+			m_axi_rresp : in std_logic_vector(1 downto 0)
+				:= (others => '0');
+			m_axi_rlast : in std_logic := '0';
+			m_axi_rvalid : in std_logic := '0';
+			m_axi_rready : out std_logic;
 			-- clock for Montgomery multipliers in the async case
 			clkmm : in std_logic;
 			-- interrupt
@@ -97,6 +199,60 @@ architecture sim of ecc_tb is
 		);
 	end component ecc;
 
+	-- DuT component declaration (if nbengines > 1)
+	component ecc_multi is
+		generic(
+			-- width of AXI data bus
+			constant C_S_AXI_DATA_WIDTH : integer := axi32or64; -- in ecc_customize
+			-- width of AXI address bus
+			constant C_S_AXI_ADDR_WIDTH : integer := AXIAW_MULTI -- in ecc_pkg
+		);
+		port(
+			-- AXI clock
+			s_axi_aclk : in std_logic;
+			-- AXI reset (expected active low, async asserted, sync deasserted) 
+			s_axi_aresetn : in std_logic;
+			-- AXI write-address channel
+			s_axi_awaddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1  downto 0);
+			s_axi_awprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_awvalid : in std_logic;
+			s_axi_awready : out std_logic;
+			-- AXI write-data channel
+			s_axi_wdata : in std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axi_wstrb : in std_logic_vector((C_S_AXI_DATA_WIDTH/8) - 1 downto 0);
+			s_axi_wvalid : in std_logic;
+			s_axi_wready : out std_logic;
+			-- AXI write-response channel
+			s_axi_bresp : out std_logic_vector(1 downto 0);
+			s_axi_bvalid : out std_logic;
+			s_axi_bready : in std_logic;
+			-- AXI read-address channel
+			s_axi_araddr : in std_logic_vector(C_S_AXI_ADDR_WIDTH - 1 downto 0);
+			s_axi_arprot : in std_logic_vector(2 downto 0); -- ignored
+			s_axi_arvalid : in std_logic;
+			s_axi_arready : out std_logic;
+			-- AXI read-data channel
+			s_axi_rdata : out std_logic_vector(C_S_AXI_DATA_WIDTH - 1 downto 0);
+			s_axi_rresp : out std_logic_vector(1 downto 0);
+			s_axi_rvalid : out std_logic;
+			s_axi_rready : in std_logic;
+			-- clock for Montgomery multipliers in the async case
+			clkmm : in std_logic;
+			-- interrupt
+			irq : out std_logic;
+			-- busy signal for [k]P computation (any engine)
+			busy : out std_logic;
+			-- debug features
+			--   off-chip trigger
+			dbgtrigger : out std_logic;
+			dbghalted : out std_logic;
+			--   pseudo-trng port (unused, see header)
+			dbgptdata : in std_logic_vector(7 downto 0);
+			dbgptvalid : in std_logic;
+			dbgptrdy : out std_logic
+		);
+	end component ecc_multi;
+
 	-- Pseudo TRNG device
 	component pseudo_trng is
 		generic(
@@ -147,6 +303,17 @@ architecture sim of ecc_tb is
 	signal axi0 : axi_in_type;
 	signal axo0 : axi_out_type;
 
+	-- Window of registers accessed on the AXI bus of ecc_multi (the address
+	-- bits of 'axi0' selecting a register inside this window)
+	signal axwin : natural range 0 to MULTI_WIN_RES := 0;
+	signal axwaddr, axraddr : std_logic_vector(AXIAW_MULTI - 1 downto 0);
+
+	-- AXI4 signal bus (DuT to emulated system memory)
+	signal mxi0 : maxi_in_type;
+	signal mxo0 : maxi_out_type;
+	signal dmamem : dma_mem_type;
+	signal dmab : dma_backdoor_type;
+
 	type axi1_in_type is record
 		-- in
 		aclk :  std_logic;
@@ -480,9 +647,9 @@ begin
 	process
 	begin
 		s_axi_aclk <= '0';
-		wait for 5 ns;
+		wait for AXI_CLK_PERIOD / 2;
 		s_axi_aclk <= '1';
-		wait for 5 ns;
+		wait for AXI_CLK_PERIOD / 2;
 	end process;
 
 	-- Emulate clkmm clock (250 MHz).
@@ -495,52 +662,241 @@ begin
 	end process;
 
 	-- DuT instance
-	e0: ecc
-		generic map(
-			C_S_AXI_DATA_WIDTH => AXIDW,
-			C_S_AXI_ADDR_WIDTH => AXIAW)
-		port map(
-			-- AXI clock & reset
-			s_axi_aclk => s_axi_aclk,
-			s_axi_aresetn => s_axi_aresetn,
-			-- AXI write-address channel
-			s_axi_awaddr => axi0.awaddr,
-			s_axi_awprot => axi0.awprot,
-			s_axi_awvalid => axi0.awvalid,
-			s_axi_awready => axo0.awready,
-			-- AXI write-data channel
-			s_axi_wdata => axi0.wdata,
-			s_axi_wstrb => axi0.wstrb,
-			s_axi_wvalid => axi0.wvalid,
-			s_axi_wready => axo0.wready,
-			-- AXI write-response channel
-			s_axi_bresp => axo0.bresp,
-			s_axi_bvalid => axo0.bvalid,
-			s_axi_bready => axi0.bready,
-			-- AXI read-address channel
-			s_axi_araddr => axi0.araddr,
-			s_axi_arprot => axi0.arprot,
-			s_axi_arvalid => axi0.arvalid,
-			s_axi_arready => axo0.arready,
-			--  AXI read-data channel
-			s_axi_rdata => axo0.rdata,
-			s_axi_rresp => axo0.rresp,
-			s_axi_rvalid => axo0.rvalid,
-			s_axi_rready => axi0.rready,
-			-- Clock for Montgomery multipliers in the async case
-			clkmm => clkmm,
-			-- Interrupt
-			irq => open,
-			-- General busy signal
-			busy => open,
-			-- Debug feature (off-chip trigger)
-			dbgtrigger => open,
-			dbghalted => open,
-			-- Pseudo-trng port
-			dbgptdata => dbgptdata,
-			dbgptvalid => dbgptvalid,
-			dbgptrdy => dbgptrdy
-		);
+	e0: if nbengines = 1 generate
+		e0: ecc
+			generic map(
+				C_S_AXI_DATA_WIDTH => AXIDW,
+				C_S_AXI_ADDR_WIDTH => AXIAW)
+			port map(
+				-- AXI clock & reset
+				s_axi_aclk => s_axi_aclk,
+				s_axi_aresetn => s_axi_aresetn,
+				-- AXI write-address channel
+				s_axi_awaddr => axi0.awaddr,
+				s_axi_awprot => axi0.awprot,
+				s_axi_awvalid => axi0.awvalid,
+				s_axi_awready => axo0.awready,
+				-- AXI write-data channel
+				s_axi_wdata => axi0.wdata,
+				s_axi_wstrb => axi0.wstrb,
+				s_axi_wvalid => axi0.wvalid,
+				s_axi_wready => axo0.wready,
+				-- AXI write-response channel
+				s_axi_bresp => axo0.bresp,
+				s_axi_bvalid => axo0.bvalid,
+				s_axi_bready => axi0.bready,
+				-- AXI read-address channel
+				s_axi_araddr => axi0.araddr,
+				s_axi_arprot => axi0.arprot,
+				s_axi_arvalid => axi0.arvalid,
+				s_axi_arready => axo0.arready,
+				--  AXI read-data channel
+				s_axi_rdata => axo0.rdata,
+				s_axi_rresp => axo0.rresp,
+				s_axi_rvalid => axo0.rvalid,
+				s_axi_rready => axi0.rready,
+				-- AXI4 master interface to system memory
+				m_axi_awaddr => mxo0.awaddr,
+				m_axi_awlen => mxo0.awlen,
+				m_axi_awsize => mxo0.awsize,
+				m_axi_awburst => mxo0.awburst,
+				m_axi_awcache => mxo0.awcache,
+				m_axi_awprot => mxo0.awprot,
+				m_axi_awvalid => mxo0.awvalid,
+				m_axi_awready => mxi0.awready,
+				m_axi_wdata => mxo0.wdata,
+				m_axi_wstrb => mxo0.wstrb,
+				m_axi_wlast => mxo0.wlast,
+				m_axi_wvalid => mxo0.wvalid,
+				m_axi_wready => mxi0.wready,
+				m_axi_bresp => mxi0.bresp,
+				m_axi_bvalid => mxi0.bvalid,
+				m_axi_bready => mxo0.bready,
+				m_axi_araddr => mxo0.araddr,
+				m_axi_arlen => mxo0.arlen,
+				m_axi_arsize => mxo0.arsize,
+				m_axi_arburst => mxo0.arburst,
+				m_axi_arcache => mxo0.arcache,
+				m_axi_arprot => mxo0.arprot,
+				m_axi_arvalid => mxo0.arvalid,
+				m_axi_arready => mxi0.arready,
+				m_axi_rdata => mxi0.rdata,
+				m_axi_rresp => mxi0.rresp,
+				m_axi_rlast => mxi0.rlast,
+				m_axi_rvalid => mxi0.rvalid,
+				m_axi_rready => mxo0.rready,
+				-- Clock for Montgomery multipliers in the async case
+				clkmm => clkmm,
+				-- Interrupt
+				irq => open,
+				-- General busy signal
+				busy => open,
+				-- Debug feature (off-chip trigger)
+				dbgtrigger => open,
+				dbghalted => open,
+				-- Pseudo-trng port
+				dbgptdata => dbgptdata,
+				dbgptvalid => dbgptvalid,
+				dbgptrdy => dbgptrdy
+			);
+	end generate;
+
+	-- DuT instance (several engines)
+	em0: if nbengines > 1 generate
+		em0: ecc_multi
+			generic map(
+				C_S_AXI_DATA_WIDTH => AXIDW,
+				C_S_AXI_ADDR_WIDTH => AXIAW_MULTI)
+			port map(
+				-- AXI clock & reset
+				s_axi_aclk => s_axi_aclk,
+				s_axi_aresetn => s_axi_aresetn,
+				-- AXI write-address channel
+				s_axi_awaddr => axwaddr,
+				s_axi_awprot => axi0.awprot,
+				s_axi_awvalid => axi0.awvalid,
+				s_axi_awready => axo0.awready,
+				-- AXI write-data channel
+				s_axi_wdata => axi0.wdata,
+				s_axi_wstrb => axi0.wstrb,
+				s_axi_wvalid => axi0.wvalid,
+				s_axi_wready => axo0.wready,
+				-- AXI write-response channel
+				s_axi_bresp => axo0.bresp,
+				s_axi_bvalid => axo0.bvalid,
+				s_axi_bready => axi0.bready,
+				-- AXI read-address channel
+				s_axi_araddr => axraddr,
+				s_axi_arprot => axi0.arprot,
+				s_axi_arvalid => axi0.arvalid,
+				s_axi_arready => axo0.arready,
+				--  AXI read-data channel
+				s_axi_rdata => axo0.rdata,
+				s_axi_rresp => axo0.rresp,
+				s_axi_rvalid => axo0.rvalid,
+				s_axi_rready => axi0.rready,
+				-- Clock for Montgomery multipliers in the async case
+				clkmm => clkmm,
+				-- Interrupt
+				irq => open,
+				-- General busy signal
+				busy => open,
+				-- Debug feature (off-chip trigger)
+				dbgtrigger => open,
+				dbghalted => open,
+				-- Pseudo-trng port
+				dbgptdata => dbgptdata,
+				dbgptvalid => dbgptvalid,
+				dbgptrdy => dbgptrdy
+			);
+		axwaddr <= std_logic_vector(to_unsigned(axwin, AXIAW_MULTI - AXIAW))
+			& axi0.awaddr;
+		axraddr <= std_logic_vector(to_unsigned(axwin, AXIAW_MULTI - AXIAW))
+			& axi0.araddr;
+		-- (no AXI4 master port)
+		mxo0.awvalid <= '0';
+		mxo0.wvalid <= '0';
+		mxo0.arvalid <= '0';
+	end generate;
+
+	-- Emulated system memory (AXI4 slave, one burst at a time in each
+	-- direction): OKAY responses for bursts in the 4 kB of the memory, SLVERR
+	-- for bursts beyond (reads then return 0 & writes are dropped)
+	process(s_axi_aclk)
+		variable rd, wr, wb : boolean := FALSE;
+		variable rerr, werr : boolean := FALSE;
+		variable raddr, waddr : natural;
+		variable rcnt, rlen : natural;
+	begin
+		if s_axi_aclk'event and s_axi_aclk = '1' then
+			-- backdoor (software filling descriptors & buffers)
+			if dmab.we = '1' then
+				dmamem(dmab.addr) <= dmab.data;
+			end if;
+			-- read bursts
+			if not rd then
+				mxi0.arready <= '1';
+				mxi0.rvalid <= '0';
+				mxi0.rlast <= '0';
+				if mxo0.arvalid = '1' and mxi0.arready = '1' then
+					rd := TRUE;
+					rerr := mxo0.araddr(31 downto 12) /= (31 downto 12 => '0');
+					raddr := (to_integer(unsigned(mxo0.araddr(11 downto 0))) / (AXIDW / 8))
+						mod DMA_MEM_SZ;
+					rlen := to_integer(unsigned(mxo0.arlen));
+					rcnt := 0;
+					mxi0.arready <= '0';
+					if rerr then
+						mxi0.rdata <= (others => '0');
+						mxi0.rresp <= "10";
+					else
+						mxi0.rdata <= dmamem(raddr);
+						mxi0.rresp <= "00";
+					end if;
+					mxi0.rvalid <= '1';
+					if rlen = 0 then
+						mxi0.rlast <= '1';
+					end if;
+				end if;
+			elsif mxo0.rready = '1' then
+				if rcnt = rlen then
+					rd := FALSE;
+					mxi0.rvalid <= '0';
+					mxi0.rlast <= '0';
+					mxi0.arready <= '1';
+				else
+					rcnt := rcnt + 1;
+					raddr := (raddr + 1) mod DMA_MEM_SZ;
+					if not rerr then
+						mxi0.rdata <= dmamem(raddr);
+					end if;
+					if rcnt = rlen then
+						mxi0.rlast <= '1';
+					end if;
+				end if;
+			end if;
+			-- write bursts
+			if not wr then
+				mxi0.awready <= '1';
+				mxi0.wready <= '0';
+				mxi0.bvalid <= '0';
+				if mxo0.awvalid = '1' and mxi0.awready = '1' then
+					wr := TRUE;
+					wb := FALSE;
+					werr := mxo0.awaddr(31 downto 12) /= (31 downto 12 => '0');
+					waddr := (to_integer(unsigned(mxo0.awaddr(11 downto 0))) / (AXIDW / 8))
+						mod DMA_MEM_SZ;
+					mxi0.awready <= '0';
+					mxi0.wready <= '1';
+				end if;
+			elsif wb then
+				if mxo0.bready = '1' then
+					wr := FALSE;
+					wb := FALSE;
+					mxi0.bvalid <= '0';
+					mxi0.awready <= '1';
+				end if;
+			elsif mxo0.wvalid = '1' then
+				for j in 0 to (AXIDW / 8) - 1 loop
+					if mxo0.wstrb(j) = '1' and not werr then
+						dmamem(waddr)((8*j) + 7 downto 8*j) <=
+							mxo0.wdata((8*j) + 7 downto 8*j);
+					end if;
+				end loop;
+				waddr := (waddr + 1) mod DMA_MEM_SZ;
+				if mxo0.wlast = '1' then
+					wb := TRUE;
+					mxi0.wready <= '0';
+					if werr then
+						mxi0.bresp <= "10";
+					else
+						mxi0.bresp <= "00";
+					end if;
+					mxi0.bvalid <= '1';
+				end if;
+			end if;
+		end if;
+	end process;
 
 	-- Pseudo TRNG device
 	pt0: pseudo_trng
@@ -630,6 +986,30 @@ begin
 		variable hw_kp_is_null : boolean;
 		variable hw_kpx_val : std_logic512;
 		variable hw_kpy_val : std_logic512;
+		variable vidx : natural;
+		variable vstatus : std_logic_vector(31 downto 0);
+		type ring_tokens_type is array(0 to 2**DMA_TB_LGSZ - 1) of std_logic512;
+		variable vringtok : ring_tokens_type;
+		variable vdmaring : boolean := FALSE;
+		variable vn, vhead, vh0 : natural;
+		variable vactive, vberr : boolean;
+		variable vflags, vctrl : std_logic_vector(31 downto 0);
+		type engines_tokens_type is array(0 to nbengines - 1) of std_logic512;
+		type engines_ids_type is array(0 to nbengines - 1) of natural;
+		variable vengtok : engines_tokens_type;
+		variable vnegpy, vnegkpy, vkpy : std_logic512;
+		variable veng : engines_ids_type;
+		variable vok, vdone : boolean;
+		variable vt0, vdt1, vdtn : time;
+		variable vratio : natural;
+		type jobq_tokens_type is array(0 to 2**JOBQ_SZ - 1) of std_logic512;
+		variable vjobqtok : jobq_tokens_type;
+		--   Result of the same [k]P obtained with CTRL_KP (unmasked)
+		variable hw_kp1x_val : std_logic512;
+		variable hw_kp1y_val : std_logic512;
+		variable hw_kp1_ok : boolean;
+		variable vgap : natural;
+		variable vgapok : boolean;
 		--
 		-- Point addition
 		--
@@ -699,6 +1079,23 @@ begin
 			end if;
 		end procedure print_stats_and_possibly_exit;
 
+		-- (accounting of one check of the tests of the DMA ring, see
+		-- TEST_DMA_RING)
+		procedure dma_ring_check(constant ok : in boolean; constant msg : in string) is
+		begin
+			echo_test_label(test_label, test_label_sz, "[k]P rng");
+			if ok then
+				echol(" - SUCCESSFULL: " & msg & ".");
+				stats_ok := stats_ok + 1;
+				stats_total := stats_total + 1;
+			else
+				echol(" **** FAILED! **** Not true: " & msg & ".");
+				stats_nok := stats_nok + 1;
+				stats_total := stats_total + 1;
+				assert CONTINUE_ON_ERROR severity FAILURE;
+			end if;
+		end procedure dma_ring_check;
+
 	begin
 
 		--
@@ -724,6 +1121,14 @@ begin
 		-- Wait until IP has done its (possible) init stuff.
 		--
 		poll_until_ready(s_axi_aclk, axi0, axo0);
+		--
+		-- (ecc_multi: same for all engines, the configuration below being
+		-- then applied to all of them at once)
+		--
+		if nbengines > 1 then
+			axwin <= MULTI_WIN_BCAST;
+			poll_until_ready(s_axi_aclk, axi0, axo0);
+		end if;
 
 		echol("[     ecc_tb.vhd ]: Init done");
 
@@ -747,6 +1152,8 @@ begin
 		-- Enable the post-processing unit from reading raw random bytes.
 		debug_trng_pp_start_pulling_raw(s_axi_aclk, axi0, axo0);
 
+		axwin <= 0;
+
 		-- End of IP initialization & config
 
 		-- -----------------------------------------------------------------
@@ -1068,6 +1475,12 @@ begin
 							curve_param(2) := b_val;
 							curve_param(3) := q_val;
 							--
+							-- (ecc_multi: curve is set on all engines at once)
+							--
+							if nbengines > 1 then
+								axwin <= MULTI_WIN_BCAST;
+							end if;
+							--
 							-- First set 'nn', if needed.
 							--
 							if (nn_s /= valnn) then
@@ -1079,6 +1492,7 @@ begin
 							-- from the testbench input file.
 							--
 							set_curve(s_axi_aclk, axi0, axo0, valnn, curve_param);
+							axwin <= 0;
 						else
 							echol("[     ecc_tb.vhd ]: ERROR: Wrong syntax in input file "
 								& "(expecting an hexadecimal number after ""q=0x"").");
@@ -1413,12 +1827,18 @@ begin
 							-- infinity.
 							-- Hence here it is set to 'sw_p_is_null' according to what was given
 							-- in the input test-vectors file.
+							hw_kp1_ok := FALSE;
 							scalar_mult(s_axi_aclk, axi0, axo0, valnn, k_val, px_val, py_val,
 								sw_p_is_null);
+							vt0 := now;
 							--
 							-- Poll until IP has completed computation and is ready.
 							--
 							poll_until_ready(s_axi_aclk, axi0, axo0);
+							-- Duration of the computation, in cycles of s_axi_aclk (the
+							-- clock of everything but the Montgomery multipliers)
+							echol("[     ecc_tb.vhd ]: [k]P computed in "
+								& integer'image((now - vt0) / AXI_CLK_PERIOD) & " cycles");
 							-- Check & display possible errors.
 							display_errors(s_axi_aclk, axi0, axo0);
 							-- Check if R1 is null.
@@ -1436,6 +1856,10 @@ begin
 								-- Read back the [k]P result coordinates.
 								read_and_return_kp_result(s_axi_aclk, axi0, axo0, valnn, vtoken,
 									hw_kpx_val, hw_kpy_val);
+								-- (kept for the job queue tests, see TEST_JOBQ)
+								hw_kp1x_val := hw_kpx_val xor vtoken;
+								hw_kp1y_val := hw_kpy_val xor vtoken;
+								hw_kp1_ok := TRUE;
 								-- Compare coordinates
 								if compare_two_points_coords(sw_kpx_val, sw_kpy_val,
 									hw_kpx_val xor vtoken, hw_kpy_val xor vtoken, valnn)
@@ -1459,6 +1883,495 @@ begin
 							end if;
 							-- Acknowledge possible errors.
 							ack_all_errors(s_axi_aclk, axi0, axo0);
+							-- --------------------------------------------------------
+							--   Same computation on the stored base point ([k]G).
+							-- --------------------------------------------------------
+							if TEST_KG and not sw_p_is_null then
+								--
+								-- Store P as the base point of the IP.
+								--
+								write_base_point(s_axi_aclk, axi0, axo0, valnn, px_val, py_val);
+								--
+								-- Acquire a token to mask [k]G coordinates with.
+								--
+								vtoken := (others => '0');
+								get_token(s_axi_aclk, axi0, axo0, valnn, vtoken);
+								echo("[     ecc_tb.vhd ]: Acquired masking token: 0x");
+								hex_echol(vtoken(valnn - 1 downto 0));
+								--
+								-- Only the scalar is written, R1 is copied by the IP from
+								-- the stored base point.
+								--
+								scalar_mult_base(s_axi_aclk, axi0, axo0, valnn, k_val);
+								poll_until_ready(s_axi_aclk, axi0, axo0);
+								display_errors(s_axi_aclk, axi0, axo0);
+								check_if_r1_null(s_axi_aclk, axi0, axo0, hw_kp_is_null);
+								if hw_kp_is_null then
+									echo_test_label(test_label, test_label_sz, "[k]G");
+									echol(" **** FAILED! **** Mismatch between simulated RTL ([k]G = 0) "
+										& "and result expected by test-vectors file ([k]G != 0).");
+									stats_nok := stats_nok + 1;
+									stats_total := stats_total + 1;
+									assert CONTINUE_ON_ERROR severity FAILURE;
+								else
+									read_and_return_kp_result(s_axi_aclk, axi0, axo0, valnn, vtoken,
+										hw_kpx_val, hw_kpy_val);
+									if compare_two_points_coords(sw_kpx_val, sw_kpy_val,
+										hw_kpx_val xor vtoken, hw_kpy_val xor vtoken, valnn)
+									then
+										echo_test_label(test_label, test_label_sz, "[k]G");
+										echol(" - SUCCESSFULL: [k]G point coordinates match the ones given "
+											& "in the input test-vectors file.");
+										stats_ok := stats_ok + 1;
+										stats_total := stats_total + 1;
+									else
+										echo_test_label(test_label, test_label_sz, "[k]G");
+										echol(" **** FAILED! **** Mismatch on points coordinates. Simulated hardware gave:");
+										echo("[     ecc_tb.vhd ]: [k]G.x = 0x");
+										hex_echol(hw_kpx_val(valnn - 1 downto 0) xor vtoken(valnn - 1 downto 0));
+										echo("[     ecc_tb.vhd ]: [k]G.y = 0x");
+										hex_echol(hw_kpy_val(valnn - 1 downto 0) xor vtoken(valnn - 1 downto 0));
+										stats_nok := stats_nok + 1;
+										stats_total := stats_total + 1;
+										assert CONTINUE_ON_ERROR severity FAILURE;
+									end if;
+								end if;
+								ack_all_errors(s_axi_aclk, axi0, axo0);
+							end if;
+							-- --------------------------------------------------------
+							--   Same computation again, this time on a point staged into
+							--   a slot of the IP while the previous [k]P was running.
+							-- --------------------------------------------------------
+							if TEST_STAGE and not sw_p_is_null then
+								for c in 0 to 1 loop
+									vtoken := (others => '0');
+									get_token(s_axi_aclk, axi0, axo0, valnn, vtoken);
+									echo("[     ecc_tb.vhd ]: Acquired masking token: 0x");
+									hex_echol(vtoken(valnn - 1 downto 0));
+									if c = 0 then
+										--
+										-- Start [k]P on P and, while it runs, stage P into
+										-- slot 1 (this must not alter the result in R1).
+										--
+										scalar_mult(s_axi_aclk, axi0, axo0, valnn, k_val, px_val, py_val,
+											sw_p_is_null);
+										stage_point(s_axi_aclk, axi0, axo0, valnn, 1, px_val, py_val);
+									else
+										--
+										-- Only the scalar is written, R1 is copied by the IP from
+										-- slot 1, and the [k]P computation starts right after.
+										--
+										scalar_mult_slot(s_axi_aclk, axi0, axo0, valnn, k_val, 1);
+									end if;
+									poll_until_ready(s_axi_aclk, axi0, axo0);
+									display_errors(s_axi_aclk, axi0, axo0);
+									check_if_r1_null(s_axi_aclk, axi0, axo0, hw_kp_is_null);
+									if hw_kp_is_null then
+										echo_test_label(test_label, test_label_sz, "[k]P stg");
+										echol(" **** FAILED! **** Mismatch between simulated RTL ([k]P = 0) "
+											& "and result expected by test-vectors file ([k]P != 0).");
+										stats_nok := stats_nok + 1;
+										stats_total := stats_total + 1;
+										assert CONTINUE_ON_ERROR severity FAILURE;
+									else
+										read_and_return_kp_result(s_axi_aclk, axi0, axo0, valnn, vtoken,
+											hw_kpx_val, hw_kpy_val);
+										if compare_two_points_coords(sw_kpx_val, sw_kpy_val,
+											hw_kpx_val xor vtoken, hw_kpy_val xor vtoken, valnn)
+										then
+											echo_test_label(test_label, test_label_sz, "[k]P stg");
+											echol(" - SUCCESSFULL: [k]P point coordinates match the ones given "
+												& "in the input test-vectors file.");
+											stats_ok := stats_ok + 1;
+											stats_total := stats_total + 1;
+										else
+											echo_test_label(test_label, test_label_sz, "[k]P stg");
+											echol(" **** FAILED! **** Mismatch on points coordinates. Simulated hardware gave:");
+											echo("[     ecc_tb.vhd ]: [k]P.x = 0x");
+											hex_echol(hw_kpx_val(valnn - 1 downto 0) xor vtoken(valnn - 1 downto 0));
+											echo("[     ecc_tb.vhd ]: [k]P.y = 0x");
+											hex_echol(hw_kpy_val(valnn - 1 downto 0) xor vtoken(valnn - 1 downto 0));
+											stats_nok := stats_nok + 1;
+											stats_total := stats_total + 1;
+											assert CONTINUE_ON_ERROR severity FAILURE;
+										end if;
+									end if;
+									ack_all_errors(s_axi_aclk, axi0, axo0);
+								end loop;
+							end if;
+							-- --------------------------------------------------------
+							--   Same computation again, this time as a job of the DMA
+							--   ring (the token comes back in memory along with the
+							--   result it masks).
+							-- --------------------------------------------------------
+							if dma and TEST_DMA and not sw_p_is_null then
+								scalar_mult_dma(s_axi_aclk, axi0, axo0, dmab, valnn, k_val, px_val,
+									py_val, vidx);
+								read_and_return_dma_result(dmamem, valnn, vidx, vtoken, hw_kpx_val,
+									hw_kpy_val, vstatus);
+								if vstatus(DMA_DESC_DONE) /= '1' or
+									vstatus(STATUS_ERR_MSB downto STATUS_ERR_LSB) /= x"0000"
+								then
+									echo_test_label(test_label, test_label_sz, "[k]P dma");
+									echo(" **** FAILED! **** Job status in descriptor is 0x");
+									hex_echol(vstatus);
+									stats_nok := stats_nok + 1;
+									stats_total := stats_total + 1;
+									assert CONTINUE_ON_ERROR severity FAILURE;
+								elsif vstatus(STATUS_R1_IS_NULL) = '1' then
+									echo_test_label(test_label, test_label_sz, "[k]P dma");
+									echol(" **** FAILED! **** Mismatch between simulated RTL ([k]P = 0) "
+										& "and result expected by test-vectors file ([k]P != 0).");
+									stats_nok := stats_nok + 1;
+									stats_total := stats_total + 1;
+									assert CONTINUE_ON_ERROR severity FAILURE;
+								elsif compare_two_points_coords(sw_kpx_val, sw_kpy_val,
+									hw_kpx_val xor vtoken, hw_kpy_val xor vtoken, valnn)
+								then
+									echo_test_label(test_label, test_label_sz, "[k]P dma");
+									echol(" - SUCCESSFULL: [k]P point coordinates match the ones given "
+										& "in the input test-vectors file.");
+									stats_ok := stats_ok + 1;
+									stats_total := stats_total + 1;
+								else
+									echo_test_label(test_label, test_label_sz, "[k]P dma");
+									echol(" **** FAILED! **** Mismatch on points coordinates. Simulated hardware gave:");
+									echo("[     ecc_tb.vhd ]: [k]P.x = 0x");
+									hex_echol(hw_kpx_val(valnn - 1 downto 0) xor vtoken(valnn - 1 downto 0));
+									echo("[     ecc_tb.vhd ]: [k]P.y = 0x");
+									hex_echol(hw_kpy_val(valnn - 1 downto 0) xor vtoken(valnn - 1 downto 0));
+									stats_nok := stats_nok + 1;
+									stats_total := stats_total + 1;
+									assert CONTINUE_ON_ERROR severity FAILURE;
+								end if;
+							end if;
+							-- --------------------------------------------------------
+							--   (first [k]P test only) Tests of the DMA ring itself: jobs
+							--   queued at once across the end of the ring, the ring being
+							--   disabled while the first one runs, then a descriptor
+							--   pointing beyond the emulated memory.
+							-- --------------------------------------------------------
+							if dma and TEST_DMA_RING and not sw_p_is_null and not vdmaring then
+								vdmaring := TRUE;
+								vn := 2**DMA_TB_LGSZ;
+								-- Bring the head of the ring to its last descriptor with
+								-- empty jobs (no flag, no command).
+								dma_config(s_axi_aclk, axi0, axo0, valnn, TRUE);
+								dma_read_state(s_axi_aclk, axi0, axo0, vhead, vactive, vberr);
+								vok := TRUE;
+								while vhead /= vn - 1 loop
+									dma_write_desc(s_axi_aclk, dmab, vhead, x"00000000", x"00000000",
+										0, 0, 0, 0, 0);
+									dma_push(s_axi_aclk, axi0, axo0, (vhead + 1) mod vn, TRUE);
+									dma_read_status(dmamem, vhead, vstatus);
+									if vstatus(DMA_DESC_DONE) /= '1' then
+										vok := FALSE;
+									end if;
+									vhead := (vhead + 1) mod vn;
+								end loop;
+								dma_ring_check(vok, "empty jobs of the DMA ring are done");
+								-- Queue as many [k]P jobs as the ring can hold (vn - 1) from
+								-- its last descriptor on (hence wrapping around its end), each
+								-- with its own buffers RES & TOKEN, and disable the ring as
+								-- soon as the first one runs.
+								dma_write_big(s_axi_aclk, dmab, valnn, DMA_TB_K, k_val);
+								dma_write_big(s_axi_aclk, dmab, valnn, DMA_TB_X, px_val);
+								dma_write_big(s_axi_aclk, dmab, valnn, DMA_TB_Y, py_val);
+								vflags := (others => '0');
+								vflags(DMA_FLAG_TOKEN) := '1';
+								vflags(DMA_FLAG_K) := '1';
+								vflags(DMA_FLAG_PT) := '1';
+								vflags(DMA_FLAG_RES) := '1';
+								vctrl := (others => '0');
+								vctrl(CTRL_KP) := '1';
+								for i in 0 to vn - 2 loop
+									vidx := (vn - 1 + i) mod vn;
+									dma_write_desc(s_axi_aclk, dmab, vidx, vflags, vctrl, DMA_TB_K,
+										DMA_TB_X, DMA_TB_Y, DMA_TB_RES_I + (16#100# * vidx),
+										DMA_TB_TOKEN_I + (16#080# * vidx));
+								end loop;
+								dma_push(s_axi_aclk, axi0, axo0, vn - 2, FALSE);
+								loop
+									dma_read_state(s_axi_aclk, axi0, axo0, vhead, vactive, vberr);
+									exit when vactive;
+								end loop;
+								dma_config(s_axi_aclk, axi0, axo0, valnn, FALSE);
+								loop
+									dma_read_state(s_axi_aclk, axi0, axo0, vhead, vactive, vberr);
+									exit when not vactive;
+								end loop;
+								-- Only the job that was running must be done (descriptors 0
+								-- to vn - 3 being left untouched).
+								vok := (vhead = 0);
+								for i in 0 to vn - 3 loop
+									dma_read_status(dmamem, i, vstatus);
+									if vstatus(DMA_DESC_DONE) /= '0' then
+										vok := FALSE;
+									end if;
+								end loop;
+								dma_ring_check(vok, "disabling the DMA ring stops it once the "
+									& "running job is done (its head wrapping around to 0)");
+								-- Enable the ring again & wait for the remaining jobs.
+								dma_config(s_axi_aclk, axi0, axo0, valnn, TRUE);
+								dma_push(s_axi_aclk, axi0, axo0, vn - 2, TRUE);
+								for i in 0 to vn - 2 loop
+									vidx := (vn - 1 + i) mod vn;
+									dma_read_status(dmamem, vidx, vstatus);
+									-- (unless 'dmatoken' is set in ecc_customize, buffer TOKEN
+									-- is left untouched & the result is written in the clear)
+									if dmatoken then
+										dma_read_big(dmamem, valnn, DMA_TB_TOKEN_I + (16#080# * vidx),
+											vringtok(i));
+									else
+										vringtok(i) := (others => '0');
+									end if;
+									dma_read_big(dmamem, valnn, DMA_TB_RES_I + (16#100# * vidx),
+										hw_kpx_val);
+									dma_read_big(dmamem, valnn, DMA_TB_RES_I + (16#100# * vidx)
+										+ (div(valnn, AXIDW) * (AXIDW / 8)), hw_kpy_val);
+									dma_ring_check(vstatus(DMA_DESC_DONE) = '1'
+										and vstatus(STATUS_ERR_MSB downto STATUS_ERR_LSB) = x"0000"
+										and vstatus(STATUS_R1_IS_NULL) = '0'
+										and compare_two_points_coords(sw_kpx_val, sw_kpy_val,
+											hw_kpx_val xor vringtok(i), hw_kpy_val xor vringtok(i), valnn),
+										"[k]P result of job " & integer'image(i) & " of the DMA ring "
+										& "(descriptor " & integer'image(vidx) & ") matches the one "
+										& "given in the input test-vectors file");
+								end loop;
+								if dmatoken then
+									vok := TRUE;
+									for i in 0 to vn - 2 loop
+										for j in 0 to i - 1 loop
+											if vringtok(i)(valnn - 1 downto 0)
+												= vringtok(j)(valnn - 1 downto 0)
+											then
+												vok := FALSE;
+											end if;
+										end loop;
+									end loop;
+									dma_ring_check(vok, "tokens of the jobs of the DMA ring are all "
+										& "distinct");
+								end if;
+								-- A descriptor whose buffer X lies beyond the emulated memory,
+								-- followed by a job only drawing a token: the error response
+								-- must set bit BERR & stop the ring after the faulty job, until
+								-- W_DMA_CTRL is written again.
+								vh0 := vn - 2;
+								vflags := (others => '0');
+								vflags(DMA_FLAG_PT) := '1';
+								dma_write_desc(s_axi_aclk, dmab, vh0, vflags, x"00000000",
+									0, DMA_TB_BAD, DMA_TB_Y, 0, 0);
+								vflags := (others => '0');
+								vflags(DMA_FLAG_TOKEN) := '1';
+								dma_write_desc(s_axi_aclk, dmab, (vh0 + 1) mod vn, vflags,
+									x"00000000", 0, 0, 0, 0, DMA_TB_TOKEN_I);
+								dma_push(s_axi_aclk, axi0, axo0, (vh0 + 2) mod vn, FALSE);
+								loop
+									dma_read_state(s_axi_aclk, axi0, axo0, vhead, vactive, vberr);
+									exit when vberr and not vactive;
+								end loop;
+								dma_read_status(dmamem, (vh0 + 1) mod vn, vstatus);
+								dma_ring_check(vhead = (vh0 + 1) mod vn
+									and vstatus(DMA_DESC_DONE) = '0', "an error response on the "
+									& "AXI4 master port stops the DMA ring after the faulty job");
+								dma_config(s_axi_aclk, axi0, axo0, valnn, TRUE);
+								dma_push(s_axi_aclk, axi0, axo0, (vh0 + 2) mod vn, TRUE);
+								dma_read_state(s_axi_aclk, axi0, axo0, vhead, vactive, vberr);
+								dma_read_status(dmamem, (vh0 + 1) mod vn, vstatus);
+								dma_ring_check(not vberr and vstatus(DMA_DESC_DONE) = '1',
+									"the DMA ring resumes once W_DMA_CTRL is written again");
+								-- Acknowledge errors possibly raised by the faulty job.
+								ack_all_errors(s_axi_aclk, axi0, axo0);
+							end if;
+							-- --------------------------------------------------------
+							--   Same computation again as one job per entry of the job
+							--   queue, all of them pushed before the first one is over.
+							-- --------------------------------------------------------
+							if TEST_JOBQ and not sw_p_is_null then
+								for i in 0 to 2**JOBQ_SZ - 1 loop
+									jobq_submit_kp(s_axi_aclk, axi0, axo0, valnn, k_val, px_val,
+										py_val, vjobqtok(i));
+								end loop;
+								-- Each entry must have been given a token of its own (none of
+								-- them being null or equal to the one of the single job).
+								vok := TRUE;
+								for i in 0 to 2**JOBQ_SZ - 1 loop
+									if vjobqtok(i)(valnn - 1 downto 0) = (valnn - 1 downto 0 => '0')
+										or vjobqtok(i)(valnn - 1 downto 0) = vtoken(valnn - 1 downto 0)
+									then
+										vok := FALSE;
+									end if;
+									for j in 0 to i - 1 loop
+										if vjobqtok(i)(valnn - 1 downto 0)
+											= vjobqtok(j)(valnn - 1 downto 0)
+										then
+											vok := FALSE;
+										end if;
+									end loop;
+								end loop;
+								if vok then
+									echo_test_label(test_label, test_label_sz, "[k]P jbq");
+									echol(" - SUCCESSFULL: tokens of the entries of the job queue "
+										& "are all distinct.");
+									stats_ok := stats_ok + 1;
+									stats_total := stats_total + 1;
+								else
+									echo_test_label(test_label, test_label_sz, "[k]P jbq");
+									echol(" **** FAILED! **** Null or reused token in the job queue.");
+									stats_nok := stats_nok + 1;
+									stats_total := stats_total + 1;
+									assert CONTINUE_ON_ERROR severity FAILURE;
+								end if;
+								for i in 0 to 2**JOBQ_SZ - 1 loop
+									jobq_collect_kp(s_axi_aclk, axi0, axo0, valnn, hw_kpx_val,
+										hw_kpy_val, hw_kp_is_null);
+									-- (the result must be the one of the single-job path too, i.e
+									-- of the same [k]P computed above with CTRL_KP)
+									if not hw_kp_is_null and compare_two_points_coords(sw_kpx_val,
+										sw_kpy_val, hw_kpx_val xor vjobqtok(i),
+										hw_kpy_val xor vjobqtok(i), valnn)
+										and hw_kp1_ok and compare_two_points_coords(hw_kp1x_val,
+										hw_kp1y_val, hw_kpx_val xor vjobqtok(i),
+										hw_kpy_val xor vjobqtok(i), valnn)
+									then
+										echo_test_label(test_label, test_label_sz, "[k]P jbq");
+										echol(" - SUCCESSFULL: [k]P point coordinates match the ones given "
+											& "in the input test-vectors file & the ones obtained with "
+											& "CTRL_KP (job " & integer'image(i) & ").");
+										stats_ok := stats_ok + 1;
+										stats_total := stats_total + 1;
+									else
+										echo_test_label(test_label, test_label_sz, "[k]P jbq");
+										echol(" **** FAILED! **** Mismatch on [k]P result of job "
+											& integer'image(i) & " of the job queue.");
+										stats_nok := stats_nok + 1;
+										stats_total := stats_total + 1;
+										assert CONTINUE_ON_ERROR severity FAILURE;
+									end if;
+								end loop;
+								jobq_read_gap(s_axi_aclk, axi0, axo0, vgap, vgapok);
+								if vgapok then
+									echol("[     ecc_tb.vhd ]: Job queue: IP idle for "
+										& integer'image(vgap) & " cycles ("
+										& integer'image(vgap * (AXI_CLK_PERIOD / 1 ns))
+										& " ns) between the end of a [k]P and the start of the next");
+								else
+									echol("[     ecc_tb.vhd ]: Job queue: no [k]P was run back-to-back "
+										& "with the previous one");
+								end if;
+							end if;
+							-- --------------------------------------------------------
+							--   Same computation again on the engines of ecc_multi, first
+							--   as one job alone then as one job per engine submitted at
+							--   once, jobs being handed to engines by the dispatcher
+							--   (windows JOB & RES).
+							-- --------------------------------------------------------
+							if nbengines > 1 and TEST_MULTI and not sw_p_is_null then
+								-- (jobs of odd rank compute [k](-P) = -[k]P instead of [k]P,
+								-- so that a result handed back for the wrong job is caught)
+								vnegpy := (others => '0');
+								if py_val(valnn - 1 downto 0) /= (valnn - 1 downto 0 => '0') then
+									vnegpy := std_logic_vector(unsigned(p_val) - unsigned(py_val));
+								end if;
+								vnegkpy := (others => '0');
+								if sw_kpy_val(valnn - 1 downto 0) /= (valnn - 1 downto 0 => '0') then
+									vnegkpy := std_logic_vector(unsigned(p_val) - unsigned(sw_kpy_val));
+								end if;
+								for c in 0 to 1 loop
+									vt0 := now;
+									-- submit the jobs
+									for i in 0 to c * (nbengines - 1) loop
+										axwin <= MULTI_WIN_JOB;
+										vengtok(i) := (others => '0');
+										get_token(s_axi_aclk, axi0, axo0, valnn, vengtok(i));
+										if i mod 2 = 0 then
+											scalar_mult(s_axi_aclk, axi0, axo0, valnn, k_val, px_val,
+												py_val, sw_p_is_null);
+										else
+											scalar_mult(s_axi_aclk, axi0, axo0, valnn, k_val, px_val,
+												vnegpy, sw_p_is_null);
+										end if;
+									end loop;
+									-- (with one job per engine, none must be left)
+									axwin <= MULTI_WIN_DISP;
+									multi_read_queue(s_axi_aclk, axi0, axo0, vok, vidx, veng(0),
+										vdone);
+									assert vidx = c * (nbengines - 1) + 1
+										report "ecc_tb: wrong number of jobs in the queue of ecc_multi"
+											severity FAILURE;
+									assert vok = (c = 0)
+										report "ecc_tb: wrong availability of engines in ecc_multi"
+											severity FAILURE;
+									-- then collect the results in submission order
+									for i in 0 to c * (nbengines - 1) loop
+										axwin <= MULTI_WIN_DISP;
+										multi_read_queue(s_axi_aclk, axi0, axo0, vok, vidx, veng(i),
+											vdone);
+										axwin <= MULTI_WIN_RES;
+										poll_until_ready(s_axi_aclk, axi0, axo0);
+										display_errors(s_axi_aclk, axi0, axo0);
+										check_if_r1_null(s_axi_aclk, axi0, axo0, hw_kp_is_null);
+										if not hw_kp_is_null then
+											read_and_return_kp_result(s_axi_aclk, axi0, axo0, valnn,
+												vengtok(i), hw_kpx_val, hw_kpy_val);
+										end if;
+										if i mod 2 = 0 then
+											vkpy := sw_kpy_val;
+										else
+											vkpy := vnegkpy;
+										end if;
+										if not hw_kp_is_null and compare_two_points_coords(sw_kpx_val,
+											vkpy, hw_kpx_val xor vengtok(i), hw_kpy_val xor vengtok(i),
+											valnn)
+										then
+											echo_test_label(test_label, test_label_sz, "[k]P mlt");
+											echol(" - SUCCESSFULL: [k]P point coordinates match the ones given "
+												& "in the input test-vectors file (job " & integer'image(i)
+												& ", engine " & integer'image(veng(i)) & ").");
+											stats_ok := stats_ok + 1;
+											stats_total := stats_total + 1;
+										else
+											echo_test_label(test_label, test_label_sz, "[k]P mlt");
+											echol(" **** FAILED! **** Mismatch on [k]P result of job "
+												& integer'image(i) & " (engine " & integer'image(veng(i))
+												& ").");
+											stats_nok := stats_nok + 1;
+											stats_total := stats_total + 1;
+											assert CONTINUE_ON_ERROR severity FAILURE;
+										end if;
+										ack_all_errors(s_axi_aclk, axi0, axo0);
+										axwin <= MULTI_WIN_DISP;
+										multi_next_job(s_axi_aclk, axi0, axo0);
+									end loop;
+									-- (each job must have had an engine of its own)
+									for i in 1 to c * (nbengines - 1) loop
+										for j in 0 to i - 1 loop
+											assert veng(i) /= veng(j)
+												report "ecc_tb: dispatcher of ecc_multi gave two jobs "
+													& "to the same engine"
+													severity FAILURE;
+										end loop;
+									end loop;
+									if c = 0 then
+										vdt1 := now - vt0;
+									else
+										vdtn := now - vt0;
+									end if;
+								end loop;
+								axwin <= 0;
+								-- throughput of nbengines engines relative to a single one
+								-- (in hundredths, computed on durations in us to stay far from
+								-- integer overflow)
+								vratio := (nbengines * 100 * (vdt1 / 1 us)) / (vdtn / 1 us);
+								echol("[     ecc_tb.vhd ]: [k]P throughput with "
+									& integer'image(nbengines) & " engines: x"
+									& integer'image(vratio / 100) & "."
+									& integer'image((vratio mod 100) / 10)
+									& integer'image(vratio mod 10)
+									& " (1 [k]P in " & integer'image(vdt1 / 1 ns) & " ns, "
+									& integer'image(nbengines) & " [k]P in "
+									& integer'image(vdtn / 1 ns) & " ns)");
+							end if;
 						else -- not rdok
 							echol("[     ecc_tb.vhd ]: ERROR: Wrong syntax in input file "
 								& "(expecting an hexadecimal number after ""kPy=0x"").");
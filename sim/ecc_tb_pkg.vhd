@@ -60,6 +60,69 @@ package ecc_tb_pkg is
 		rvalid : std_logic;
 	end record;
 
+	-- AXI4 master interface of the DuT (only used if 'dma' is set)
+	type maxi_in_type is record
+		-- in
+		awready : std_logic;
+		wready : std_logic;
+		bresp : std_logic_vector(1 downto 0);
+		bvalid : std_logic;
+		arready : std_logic;
+		rdata : std_logic_vector(AXIDW - 1 downto 0);
+		rresp : std_logic_vector(1 downto 0);
+		rlast : std_logic;
+		rvalid : std_logic;
+	end record;
+	type maxi_out_type is record
+		-- out
+		awaddr : std_logic_vector(31 downto 0);
+		awlen : std_logic_vector(7 downto 0);
+		awsize : std_logic_vector(2 downto 0);
+		awburst : std_logic_vector(1 downto 0);
+		awcache : std_logic_vector(3 downto 0);
+		awprot : std_logic_vector(2 downto 0);
+		awvalid : std_logic;
+		wdata : std_logic_vector(AXIDW - 1 downto 0);
+		wstrb : std_logic_vector((AXIDW / 8) - 1 downto 0);
+		wlast : std_logic;
+		wvalid : std_logic;
+		bready : std_logic;
+		araddr : std_logic_vector(31 downto 0);
+		arlen : std_logic_vector(7 downto 0);
+		arsize : std_logic_vector(2 downto 0);
+		arburst : std_logic_vector(1 downto 0);
+		arcache : std_logic_vector(3 downto 0);
+		arprot : std_logic_vector(2 downto 0);
+		arvalid : std_logic;
+		rready : std_logic;
+	end record;
+
+	-- system memory emulated for the DMA ring (4 kB from address 0) and its
+	-- backdoor port (through which software fills descriptors & buffers)
+	constant DMA_MEM_SZ : positive := 4096 / (AXIDW / 8); -- in words
+	type dma_mem_type is
+		array(0 to DMA_MEM_SZ - 1) of std_logic_vector(AXIDW - 1 downto 0);
+	type dma_backdoor_type is record
+		we : std_logic;
+		addr : natural range 0 to DMA_MEM_SZ - 1; -- in words
+		data : std_logic_vector(AXIDW - 1 downto 0);
+	end record;
+	-- layout of the emulated memory (byte addresses)
+	constant DMA_TB_RING : natural := 16#000#; -- 4 descriptors (lgsz = 2)
+	constant DMA_TB_K : natural := 16#400#;
+	constant DMA_TB_X : natural := 16#500#;
+	constant DMA_TB_Y : natural := 16#600#;
+	constant DMA_TB_RES : natural := 16#700#;
+	constant DMA_TB_TOKEN : natural := 16#800#;
+	constant DMA_TB_LGSZ : natural := 2;
+	--   (buffers RES & TOKEN of the jobs queued at once by the tests of the
+	--   ring itself, see TEST_DMA_RING in ecc_tb, i being the index of the
+	--   descriptor)
+	constant DMA_TB_RES_I : natural := 16#a00#; -- + 16#100# * i
+	constant DMA_TB_TOKEN_I : natural := 16#e00#; -- + 16#080# * i
+	--   (beyond the emulated memory, accesses get a SLVERR response)
+	constant DMA_TB_BAD : natural := 16#10000#;
+
 	type curve_param_addr_type is
 		array(integer range 0 to 3) of integer;
 		constant CURVE_PARAM_ADDR : curve_param_addr_type :=
@@ -163,6 +226,214 @@ package ecc_tb_pkg is
 		constant yy : in std_logic_vector;
 		constant z : in boolean);
 
+	-- Emulate software driver writing the base point to be kept by the IP
+	-- (in its stored base point memory, R1 being left untouched)
+	procedure write_base_point(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant xx : in std_logic_vector;
+		constant yy : in std_logic_vector);
+
+	-- Emulate software driver issuing command 'do [k]G-computation'
+	procedure run_kg(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type);
+
+	-- Emulate software driver writing the scalar only and giving
+	-- [k]G computation (on the stored base point) a go
+	procedure scalar_mult_base(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant scalar : in std_logic_vector);
+
+	-- Emulate software driver writing W_PT_SLOT register, either to only
+	-- select a point slot or to start a [k]P computation on the point it
+	-- holds (kp = TRUE)
+	procedure write_pt_slot(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant slot : in natural;
+		constant kp : in boolean);
+
+	-- Emulate software driver staging a point into a slot of the IP while
+	-- a [k]P computation is running (R_STATUS is not polled between the
+	-- data words, the IP holds the AXI writes until it can absorb them)
+	procedure stage_point(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant slot : in natural;
+		constant xx : in std_logic_vector;
+		constant yy : in std_logic_vector);
+
+	-- Emulate software driver writing the scalar only and giving [k]P
+	-- computation a go on the point held in a slot
+	procedure scalar_mult_slot(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant scalar : in std_logic_vector;
+		constant slot : in natural);
+
+	-- Emulate software driver queuing a [k]P computation in the DMA ring:
+	-- buffers & descriptor are filled in memory, the job is started by
+	-- writing W_DMA_TAIL, and R_DMA_HEAD is then polled until the job is
+	-- done (index of the descriptor is returned in 'idx')
+	procedure scalar_mult_dma(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		signal dmab: out dma_backdoor_type;
+		constant valnn : in positive;
+		constant scalar : in std_logic_vector;
+		constant xx : in std_logic_vector;
+		constant yy : in std_logic_vector;
+		variable idx : out natural);
+
+	-- Emulate software driver reading in memory the result of a [k]P
+	-- computation done by the DMA ring (coordinates are returned still
+	-- masked by the token, also returned along with the STATUS field of
+	-- the descriptor)
+	procedure read_and_return_dma_result(
+		signal dmamem: in dma_mem_type;
+		constant valnn : in positive;
+		constant idx : in natural;
+		variable token : inout std_logic512;
+		variable kpx : inout std_logic512;
+		variable kpy : inout std_logic512;
+		variable status : out std_logic_vector(31 downto 0));
+
+	-- Emulate software driver (re)configuring the DMA ring: address of the
+	-- ring in the emulated memory (DMA_TB_RING), its size (2**DMA_TB_LGSZ
+	-- descriptors), the size of large numbers & whether it is enabled or not
+	-- (this also clears bit BERR of R_DMA_STATUS)
+	procedure dma_config(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant en : in boolean);
+
+	-- Emulate software driver filling a buffer of the emulated memory with
+	-- a large number ('addr' in bytes)
+	procedure dma_write_big(
+		signal clk: in std_logic;
+		signal dmab: out dma_backdoor_type;
+		constant valnn : in positive;
+		constant addr : in natural;
+		constant val : in std_logic_vector);
+
+	-- Emulate software driver reading a large number from a buffer of the
+	-- emulated memory ('addr' in bytes)
+	procedure dma_read_big(
+		signal dmamem: in dma_mem_type;
+		constant valnn : in positive;
+		constant addr : in natural;
+		variable val : inout std_logic512);
+
+	-- Emulate software driver filling descriptor # idx of the ring (buffer
+	-- addresses in bytes, field STATUS being cleared)
+	procedure dma_write_desc(
+		signal clk: in std_logic;
+		signal dmab: out dma_backdoor_type;
+		constant idx : in natural;
+		constant flags : in std_logic_vector(31 downto 0);
+		constant ctrl : in std_logic_vector(31 downto 0);
+		constant k : in natural;
+		constant x : in natural;
+		constant y : in natural;
+		constant res : in natural;
+		constant token : in natural);
+
+	-- Emulate software driver reading field STATUS of descriptor # idx
+	procedure dma_read_status(
+		signal dmamem: in dma_mem_type;
+		constant idx : in natural;
+		variable status : out std_logic_vector(31 downto 0));
+
+	-- Emulate software driver moving the tail of the DMA ring (index of the
+	-- descriptor following the last one queued) & possibly waiting for the
+	-- head to reach it
+	procedure dma_push(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant tail : in natural;
+		constant wait_done : in boolean);
+
+	-- Emulate software driver reading R_DMA_HEAD & R_DMA_STATUS
+	procedure dma_read_state(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		variable head : out natural;
+		variable active : out boolean;
+		variable berr : out boolean);
+
+	-- Emulate software driver reading the state of the job queue of the
+	-- dispatcher of ecc_multi (the window of the dispatcher must be the one
+	-- selected on the AXI bus): 'free' tells if a new job can be submitted,
+	-- 'nb' is the number of jobs not collected yet, 'resid' the engine that
+	-- holds the oldest one & 'done' tells if it is over
+	procedure multi_read_queue(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		variable free : out boolean;
+		variable nb : out natural;
+		variable resid : out natural;
+		variable done : out boolean);
+
+	-- Emulate software driver telling the dispatcher of ecc_multi that the
+	-- result of the oldest job was collected (same remark as above)
+	procedure multi_next_job(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type);
+
+	-- Emulate software driver filling the open entry of the job queue of
+	-- the IP (the token is read & the scalar & point are written while the
+	-- jobs pushed before it are computed, R_STATUS is not polled, only
+	-- R_JOBQ_STATUS) & pushing it (the token of the job is returned)
+	procedure jobq_submit_kp(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant scalar : in std_logic_vector;
+		constant xx : in std_logic_vector;
+		constant yy : in std_logic_vector;
+		variable token : inout std_logic512);
+
+	-- Emulate software driver waiting for the job at the head of the job
+	-- queue to be done, reading its result (coordinates are returned still
+	-- masked by the token) & popping it
+	procedure jobq_collect_kp(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		variable kpx : inout std_logic512;
+		variable kpy : inout std_logic512;
+		variable z : out boolean);
+
+	-- Emulate software driver reading the nb of cycles the IP stayed idle
+	-- between the last two jobs of the queue it computed back-to-back
+	procedure jobq_read_gap(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		variable gap : out natural;
+		variable valid : out boolean);
+
 	-- Emulate software driver checking if R0 is the null point
 	procedure check_if_r0_null(
 		signal clk: in std_logic;
@@ -1013,6 +1284,650 @@ package body ecc_tb_pkg is
 		run_kp(clk, axi, axo);
 	end procedure;
 
+	procedure write_base_point(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant xx : in std_logic_vector;
+		constant yy : in std_logic_vector)
+	is
+		variable dw : std_logic_vector(AXIDW - 1 downto 0);
+	begin
+		for c in 0 to 1 loop
+			wait until clk'event and clk = '1';
+			poll_until_ready(clk, axi, axo);
+			wait until clk'event and clk = '1';
+			-- write W_CTRL register
+			axi.awaddr <= W_CTRL & "000"; axi.awvalid <= '1';
+			wait until clk'event and clk = '1' and axo.awready = '1';
+			axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+			dw := (others => '0');
+			dw(CTRL_WRITE_NB) := '1';
+			dw(CTRL_WRITE_BP) := '1';
+			if c = 0 then
+				dw(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB)
+					:= CST_ADDR_XR1;
+			else
+				dw(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB)
+					:= CST_ADDR_YR1;
+			end if;
+			axi.wdata <= dw;
+			axi.wvalid <= '1';
+			wait until clk'event and clk = '1' and axo.wready = '1';
+			axi.wdata <= (others => 'X');
+			axi.wvalid <= '0';
+			-- now perform the proper nb of writes of the W_WRITE_DATA register
+			for i in 0 to div(valnn,AXIDW) - 1 loop
+				poll_until_ready(clk, axi, axo);
+				axi.awaddr <= W_WRITE_DATA & "000"; axi.awvalid <= '1';
+				wait until clk'event and clk = '1' and axo.awready = '1';
+				axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+				if c = 0 then
+					axi.wdata <= xx((AXIDW*i) + AXIDW - 1 downto AXIDW*i);
+				else
+					axi.wdata <= yy((AXIDW*i) + AXIDW - 1 downto AXIDW*i);
+				end if;
+				axi.wvalid <= '1';
+				wait until clk'event and clk = '1' and axo.wready = '1';
+				axi.wdata <= (others => 'X'); axi.wvalid <= '0';
+			end loop;
+		end loop;
+	end procedure;
+
+	procedure run_kg(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type)
+	is
+		variable dw : std_logic_vector(AXIDW - 1 downto 0);
+	begin
+		wait until clk'event and clk = '1';
+		-- write W_CTRL register
+		axi.awaddr <= W_CTRL & "000"; axi.awvalid <= '1';
+		wait until clk'event and clk = '1' and axo.awready = '1';
+		axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+		dw := (others => '0');
+		dw(CTRL_KG) := '1';
+		axi.wdata <= dw;
+		axi.wvalid <= '1';
+		wait until clk'event and clk = '1' and axo.wready = '1';
+		axi.wdata <= (others => 'X'); axi.wvalid <= '0';
+		wait until clk'event and clk = '1';
+	end procedure;
+
+	procedure scalar_mult_base(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant scalar : in std_logic_vector) is
+	begin
+		wait until clk'event and clk = '1';
+		-- write the scalar (coordinates of R1 are copied by the IP itself
+		-- from its stored base point)
+		poll_until_ready(clk, axi, axo);
+		write_scalar(clk, axi, axo, valnn, scalar);
+		-- give [k]G computation a go
+		poll_until_ready(clk, axi, axo);
+		run_kg(clk, axi, axo);
+	end procedure;
+
+	procedure write_pt_slot(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant slot : in natural;
+		constant kp : in boolean)
+	is
+		variable dw : std_logic_vector(AXIDW - 1 downto 0);
+	begin
+		wait until clk'event and clk = '1';
+		-- write W_PT_SLOT register
+		axi.awaddr <= W_PT_SLOT & "000"; axi.awvalid <= '1';
+		wait until clk'event and clk = '1' and axo.awready = '1';
+		axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+		dw := (others => '0');
+		dw(PTSLOT_NB_MSB downto PTSLOT_NB_LSB) :=
+			std_logic_vector(to_unsigned(slot, PT_SLOT_SZ));
+		if kp then
+			dw(PTSLOT_KP) := '1';
+		end if;
+		axi.wdata <= dw;
+		axi.wvalid <= '1';
+		wait until clk'event and clk = '1' and axo.wready = '1';
+		axi.wdata <= (others => 'X'); axi.wvalid <= '0';
+		wait until clk'event and clk = '1';
+	end procedure;
+
+	procedure stage_point(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant slot : in natural;
+		constant xx : in std_logic_vector;
+		constant yy : in std_logic_vector)
+	is
+		variable dw : std_logic_vector(AXIDW - 1 downto 0);
+	begin
+		-- wait for the [k]P computation to be actually running (or over)
+		loop
+			wait until clk'event and clk = '1';
+			-- read R_STATUS register
+			axi.araddr <= R_STATUS & "000";
+			axi.arvalid <= '1';
+			wait until clk'event and clk = '1' and axo.arready = '1';
+			axi.araddr <= (others => 'X');
+			axi.arvalid <= '0';
+			axi.rready <= '1';
+			wait until clk'event and clk = '1' and axo.rvalid = '1';
+			axi.rready <= '0';
+			if axo.rdata(STATUS_KP) = '1' or axo.rdata(STATUS_BUSY) = '0' then
+				exit;
+			end if;
+		end loop;
+		write_pt_slot(clk, axi, axo, slot, FALSE);
+		for c in 0 to 1 loop
+			wait until clk'event and clk = '1';
+			-- write W_CTRL register
+			axi.awaddr <= W_CTRL & "000"; axi.awvalid <= '1';
+			wait until clk'event and clk = '1' and axo.awready = '1';
+			axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+			dw := (others => '0');
+			dw(CTRL_WRITE_NB) := '1';
+			dw(CTRL_WRITE_BP) := '1';
+			if c = 0 then
+				dw(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB)
+					:= CST_ADDR_XR1;
+			else
+				dw(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB)
+					:= CST_ADDR_YR1;
+			end if;
+			axi.wdata <= dw;
+			axi.wvalid <= '1';
+			wait until clk'event and clk = '1' and axo.wready = '1';
+			axi.wdata <= (others => 'X');
+			axi.wvalid <= '0';
+			-- back-to-back writes of the W_WRITE_DATA register
+			for i in 0 to div(valnn,AXIDW) - 1 loop
+				axi.awaddr <= W_WRITE_DATA & "000"; axi.awvalid <= '1';
+				wait until clk'event and clk = '1' and axo.awready = '1';
+				axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+				if c = 0 then
+					axi.wdata <= xx((AXIDW*i) + AXIDW - 1 downto AXIDW*i);
+				else
+					axi.wdata <= yy((AXIDW*i) + AXIDW - 1 downto AXIDW*i);
+				end if;
+				axi.wvalid <= '1';
+				wait until clk'event and clk = '1' and axo.wready = '1';
+				axi.wdata <= (others => 'X'); axi.wvalid <= '0';
+			end loop;
+		end loop;
+		-- writes of the base point go to slot 0 again
+		write_pt_slot(clk, axi, axo, 0, FALSE);
+	end procedure;
+
+	procedure scalar_mult_slot(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant scalar : in std_logic_vector;
+		constant slot : in natural) is
+	begin
+		wait until clk'event and clk = '1';
+		-- write the scalar (coordinates of R1 are copied by the IP itself
+		-- from the slot)
+		poll_until_ready(clk, axi, axo);
+		write_scalar(clk, axi, axo, valnn, scalar);
+		-- give [k]P computation a go
+		poll_until_ready(clk, axi, axo);
+		write_pt_slot(clk, axi, axo, slot, TRUE);
+	end procedure;
+
+	-- (used by scalar_mult_dma, multi_* & jobq_* procedures only)
+	procedure write_reg(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant addr : in std_logic_vector;
+		constant data : in std_logic_vector(31 downto 0)) is
+	begin
+		wait until clk'event and clk = '1';
+		axi.awaddr <= addr & "000"; axi.awvalid <= '1';
+		wait until clk'event and clk = '1' and axo.awready = '1';
+		axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+		axi.wdata <= (others => '0');
+		axi.wdata(31 downto 0) <= data;
+		axi.wvalid <= '1';
+		wait until clk'event and clk = '1' and axo.wready = '1';
+		axi.wdata <= (others => 'X'); axi.wvalid <= '0';
+	end procedure;
+
+	procedure read_reg(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant addr : in std_logic_vector;
+		variable data : out std_logic_vector(31 downto 0)) is
+	begin
+		wait until clk'event and clk = '1';
+		axi.araddr <= addr & "000";
+		axi.arvalid <= '1';
+		wait until clk'event and clk = '1' and axo.arready = '1';
+		axi.araddr <= (others => 'X');
+		axi.arvalid <= '0';
+		axi.rready <= '1';
+		wait until clk'event and clk = '1' and axo.rvalid = '1';
+		axi.rready <= '0';
+		data := axo.rdata(31 downto 0);
+	end procedure;
+
+	procedure dma_config(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant en : in boolean)
+	is
+		variable dw : std_logic_vector(31 downto 0);
+	begin
+		write_reg(clk, axi, axo, W_DMA_RING,
+			std_logic_vector(to_unsigned(DMA_TB_RING, 32)));
+		dw := (others => '0');
+		if en then
+			dw(DMA_EN) := '1';
+		end if;
+		dw(DMA_LGSZ_MSB downto DMA_LGSZ_LSB) :=
+			std_logic_vector(to_unsigned(DMA_TB_LGSZ, DMA_LGSZ_MSB - DMA_LGSZ_LSB + 1));
+		dw(DMA_NBW_MSB downto DMA_NBW_LSB) := std_logic_vector(
+			to_unsigned(div(valnn, AXIDW), DMA_NBW_MSB - DMA_NBW_LSB + 1));
+		write_reg(clk, axi, axo, W_DMA_CTRL, dw);
+	end procedure;
+
+	procedure dma_write_big(
+		signal clk: in std_logic;
+		signal dmab: out dma_backdoor_type;
+		constant valnn : in positive;
+		constant addr : in natural;
+		constant val : in std_logic_vector)
+	is
+	begin
+		for i in 0 to div(valnn, AXIDW) - 1 loop
+			wait until clk'event and clk = '1';
+			dmab.we <= '1';
+			dmab.addr <= (addr / (AXIDW / 8)) + i;
+			dmab.data <= val((AXIDW*i) + AXIDW - 1 downto AXIDW*i);
+		end loop;
+		wait until clk'event and clk = '1';
+		dmab.we <= '0';
+	end procedure;
+
+	procedure dma_read_big(
+		signal dmamem: in dma_mem_type;
+		constant valnn : in positive;
+		constant addr : in natural;
+		variable val : inout std_logic512)
+	is
+	begin
+		val := (others => '0');
+		for i in 0 to div(valnn, AXIDW) - 1 loop
+			val((AXIDW*i) + AXIDW - 1 downto AXIDW*i) :=
+				dmamem((addr / (AXIDW / 8)) + i);
+		end loop;
+	end procedure;
+
+	procedure dma_write_desc(
+		signal clk: in std_logic;
+		signal dmab: out dma_backdoor_type;
+		constant idx : in natural;
+		constant flags : in std_logic_vector(31 downto 0);
+		constant ctrl : in std_logic_vector(31 downto 0);
+		constant k : in natural;
+		constant x : in natural;
+		constant y : in natural;
+		constant res : in natural;
+		constant token : in natural)
+	is
+		constant FPW : positive := AXIDW / 32;
+		type desc_type is array(0 to 7) of std_logic_vector(31 downto 0);
+		variable desc : desc_type;
+	begin
+		desc := (others => (others => '0'));
+		desc(DMA_DESC_FLAGS) := flags;
+		desc(DMA_DESC_CTRL) := ctrl;
+		desc(DMA_DESC_K) := std_logic_vector(to_unsigned(k, 32));
+		desc(DMA_DESC_X) := std_logic_vector(to_unsigned(x, 32));
+		desc(DMA_DESC_Y) := std_logic_vector(to_unsigned(y, 32));
+		desc(DMA_DESC_RES) := std_logic_vector(to_unsigned(res, 32));
+		desc(DMA_DESC_TOKEN) := std_logic_vector(to_unsigned(token, 32));
+		for i in 0 to 7 loop
+			wait until clk'event and clk = '1';
+			dmab.we <= '1';
+			dmab.addr <=
+				((DMA_TB_RING + (idx * DMA_DESC_SZ)) / (AXIDW / 8)) + (i / FPW);
+			-- (all fields sharing the word are written at once)
+			for j in 0 to FPW - 1 loop
+				dmab.data((32*j) + 31 downto 32*j) <= desc(i - (i mod FPW) + j);
+			end loop;
+		end loop;
+		wait until clk'event and clk = '1';
+		dmab.we <= '0';
+	end procedure;
+
+	procedure dma_read_status(
+		signal dmamem: in dma_mem_type;
+		constant idx : in natural;
+		variable status : out std_logic_vector(31 downto 0))
+	is
+		constant FPW : positive := AXIDW / 32;
+		constant SW : natural := DMA_DESC_STATUS mod FPW;
+	begin
+		status := dmamem(((DMA_TB_RING + (idx * DMA_DESC_SZ)) / (AXIDW / 8))
+			+ (DMA_DESC_STATUS / FPW))((32*SW) + 31 downto 32*SW);
+	end procedure;
+
+	procedure dma_push(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant tail : in natural;
+		constant wait_done : in boolean)
+	is
+		variable dw : std_logic_vector(31 downto 0);
+	begin
+		write_reg(clk, axi, axo, W_DMA_TAIL, std_logic_vector(to_unsigned(tail, 32)));
+		if wait_done then
+			loop
+				read_reg(clk, axi, axo, R_DMA_HEAD, dw);
+				exit when to_integer(unsigned(dw(15 downto 0))) = tail;
+			end loop;
+		end if;
+	end procedure;
+
+	procedure dma_read_state(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		variable head : out natural;
+		variable active : out boolean;
+		variable berr : out boolean)
+	is
+		variable dw : std_logic_vector(31 downto 0);
+	begin
+		-- (R_DMA_STATUS first: once the ring is seen inactive, its head cannot
+		-- move anymore until software writes W_DMA_CTRL or W_DMA_TAIL)
+		read_reg(clk, axi, axo, R_DMA_STATUS, dw);
+		active := (dw(DMA_STATUS_ACTIVE) = '1');
+		berr := (dw(DMA_STATUS_BERR) = '1');
+		read_reg(clk, axi, axo, R_DMA_HEAD, dw);
+		head := to_integer(unsigned(dw(15 downto 0)));
+	end procedure;
+
+	procedure scalar_mult_dma(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		signal dmab: out dma_backdoor_type;
+		constant valnn : in positive;
+		constant scalar : in std_logic_vector;
+		constant xx : in std_logic_vector;
+		constant yy : in std_logic_vector;
+		variable idx : out natural)
+	is
+		variable head, tail : natural;
+		variable dw : std_logic_vector(31 downto 0);
+		variable flags, ctrl : std_logic_vector(31 downto 0);
+	begin
+		read_reg(clk, axi, axo, R_DMA_HEAD, dw);
+		head := to_integer(unsigned(dw(15 downto 0)));
+		tail := (head + 1) mod (2**DMA_TB_LGSZ);
+		-- (re)configure the ring
+		dma_config(clk, axi, axo, valnn, TRUE);
+		-- fill buffers K, X & Y through the backdoor
+		dma_write_big(clk, dmab, valnn, DMA_TB_K, scalar);
+		dma_write_big(clk, dmab, valnn, DMA_TB_X, xx);
+		dma_write_big(clk, dmab, valnn, DMA_TB_Y, yy);
+		-- fill the descriptor
+		flags := (others => '0');
+		flags(DMA_FLAG_TOKEN) := '1';
+		flags(DMA_FLAG_K) := '1';
+		flags(DMA_FLAG_PT) := '1';
+		flags(DMA_FLAG_RES) := '1';
+		ctrl := (others => '0');
+		ctrl(CTRL_KP) := '1';
+		dma_write_desc(clk, dmab, head, flags, ctrl, DMA_TB_K, DMA_TB_X, DMA_TB_Y,
+			DMA_TB_RES, DMA_TB_TOKEN);
+		-- give the job a go & wait for it to be done
+		dma_push(clk, axi, axo, tail, TRUE);
+		idx := head;
+	end procedure;
+
+	procedure read_and_return_dma_result(
+		signal dmamem: in dma_mem_type;
+		constant valnn : in positive;
+		constant idx : in natural;
+		variable token : inout std_logic512;
+		variable kpx : inout std_logic512;
+		variable kpy : inout std_logic512;
+		variable status : out std_logic_vector(31 downto 0))
+	is
+	begin
+		-- (unless 'dmatoken' is set in ecc_customize, buffer TOKEN is left
+		-- untouched & the result is written back in the clear)
+		if dmatoken then
+			dma_read_big(dmamem, valnn, DMA_TB_TOKEN, token);
+		else
+			token := (others => '0');
+		end if;
+		dma_read_big(dmamem, valnn, DMA_TB_RES, kpx);
+		dma_read_big(dmamem, valnn, DMA_TB_RES + (div(valnn, AXIDW) * (AXIDW / 8)),
+			kpy);
+		dma_read_status(dmamem, idx, status);
+	end procedure;
+
+	procedure multi_read_queue(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		variable free : out boolean;
+		variable nb : out natural;
+		variable resid : out natural;
+		variable done : out boolean) is
+		variable dw : std_logic_vector(31 downto 0);
+	begin
+		read_reg(clk, axi, axo, R_MULTI_QUEUE, dw);
+		free := (dw(MULTI_QUEUE_FREE) = '1');
+		nb := to_integer(unsigned(dw(MULTI_QUEUE_NB_MSB downto MULTI_QUEUE_NB_LSB)));
+		resid := to_integer(unsigned(
+			dw(MULTI_QUEUE_RES_ID_MSB downto MULTI_QUEUE_RES_ID_LSB)));
+		done := (dw(MULTI_QUEUE_RES_DONE) = '1');
+	end procedure;
+
+	procedure multi_next_job(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type) is
+	begin
+		write_reg(clk, axi, axo, W_MULTI_NEXT, x"00000000");
+	end procedure;
+
+	-- (used by jobq_* procedures only)
+	procedure jobq_poll_until_filled(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type)
+	is
+		variable dw : std_logic_vector(31 downto 0);
+	begin
+		loop
+			read_reg(clk, axi, axo, R_JOBQ_STATUS, dw);
+			exit when dw(JOBQ_STATUS_FILL) = '0';
+		end loop;
+	end procedure;
+
+	-- (used by jobq_* procedures only)
+	procedure jobq_write_big(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant addr : in std_logic_vector(FP_ADDR_MSB - 1 downto 0);
+		constant bignb : in std_logic_vector)
+	is
+		variable dw : std_logic_vector(AXIDW - 1 downto 0);
+	begin
+		jobq_poll_until_filled(clk, axi, axo);
+		wait until clk'event and clk = '1';
+		-- write W_CTRL register
+		axi.awaddr <= W_CTRL & "000"; axi.awvalid <= '1';
+		wait until clk'event and clk = '1' and axo.awready = '1';
+		axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+		dw := (others => '0');
+		dw(CTRL_WRITE_NB) := '1';
+		dw(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB) := addr;
+		if addr = CST_ADDR_K then
+			dw(CTRL_WRITE_K) := '1';
+		end if;
+		axi.wdata <= dw;
+		axi.wvalid <= '1';
+		wait until clk'event and clk = '1' and axo.wready = '1';
+		axi.wdata <= (others => 'X');
+		axi.wvalid <= '0';
+		-- back-to-back writes of the W_WRITE_DATA register
+		for i in 0 to div(valnn,AXIDW) - 1 loop
+			axi.awaddr <= W_WRITE_DATA & "000"; axi.awvalid <= '1';
+			wait until clk'event and clk = '1' and axo.awready = '1';
+			axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+			axi.wdata <= bignb((AXIDW*i) + AXIDW - 1 downto AXIDW*i);
+			axi.wvalid <= '1';
+			wait until clk'event and clk = '1' and axo.wready = '1';
+			axi.wdata <= (others => 'X'); axi.wvalid <= '0';
+		end loop;
+	end procedure;
+
+	-- (used by jobq_* procedures only)
+	procedure jobq_read_big(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn: in positive;
+		constant addr : in std_logic_vector(FP_ADDR_MSB - 1 downto 0);
+		constant token : in boolean;
+		variable bignb: inout std_logic512)
+	is
+		variable dw : std_logic_vector(AXIDW - 1 downto 0);
+	begin
+		jobq_poll_until_filled(clk, axi, axo);
+		wait until clk'event and clk = '1';
+		-- write W_CTRL register
+		axi.awaddr <= W_CTRL & "000"; axi.awvalid <= '1';
+		wait until clk'event and clk = '1' and axo.awready = '1';
+		axi.awaddr <= (others => 'X'); axi.awvalid <= '0';
+		dw := (others => '0');
+		dw(CTRL_READ_NB) := '1';
+		if token then
+			dw(CTRL_RD_TOKEN) := '1';
+		else
+			dw(CTRL_NBADDR_LSB + FP_ADDR_MSB - 1 downto CTRL_NBADDR_LSB) := addr;
+		end if;
+		axi.wdata <= dw;
+		axi.wvalid <= '1';
+		wait until clk'event and clk = '1' and axo.wready = '1';
+		axi.wdata <= (others => 'X'); axi.wvalid <= '0';
+		-- back-to-back reads of the R_READ_DATA register
+		bignb := (others => '0');
+		for i in 0 to div(valnn,AXIDW) - 1 loop
+			axi.araddr <= R_READ_DATA & "000"; axi.arvalid <= '1';
+			wait until clk'event and clk = '1' and axo.arready = '1';
+			axi.araddr <= (others => 'X'); axi.arvalid <= '0'; axi.rready <= '1';
+			wait until clk'event and clk = '1' and axo.rvalid = '1';
+			bignb((AXIDW*i) + AXIDW - 1 downto AXIDW*i) := axo.rdata;
+			axi.rready <= '0';
+			wait until clk'event and clk = '1';
+		end loop;
+	end procedure;
+
+	procedure jobq_submit_kp(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		constant scalar : in std_logic_vector;
+		constant xx : in std_logic_vector;
+		constant yy : in std_logic_vector;
+		variable token : inout std_logic512)
+	is
+		variable dw : std_logic_vector(31 downto 0);
+	begin
+		-- wait for a free entry & open it
+		loop
+			read_reg(clk, axi, axo, R_JOBQ_STATUS, dw);
+			exit when dw(JOBQ_STATUS_FULL) = '0';
+		end loop;
+		dw := (others => '0');
+		dw(JOBQ_OPEN) := '1';
+		write_reg(clk, axi, axo, W_JOBQ_CTRL, dw);
+		-- fill it
+		jobq_read_big(clk, axi, axo, valnn, CST_ADDR_TOKEN, TRUE, token);
+		jobq_write_big(clk, axi, axo, valnn, CST_ADDR_K, scalar);
+		jobq_write_big(clk, axi, axo, valnn, CST_ADDR_XR1, xx);
+		jobq_write_big(clk, axi, axo, valnn, CST_ADDR_YR1, yy);
+		-- & push it
+		jobq_poll_until_filled(clk, axi, axo);
+		dw := (others => '0');
+		dw(JOBQ_PUSH) := '1';
+		write_reg(clk, axi, axo, W_JOBQ_CTRL, dw);
+	end procedure;
+
+	procedure jobq_collect_kp(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		constant valnn : in positive;
+		variable kpx : inout std_logic512;
+		variable kpy : inout std_logic512;
+		variable z : out boolean)
+	is
+		variable dw : std_logic_vector(31 downto 0);
+	begin
+		loop
+			read_reg(clk, axi, axo, R_JOBQ_STATUS, dw);
+			exit when dw(JOBQ_STATUS_HEAD_DONE) = '1';
+		end loop;
+		z := (dw(JOBQ_STATUS_HEAD_NULL) = '1');
+		assert dw(JOBQ_STATUS_HEAD_ERRIN) = '0'
+			and dw(JOBQ_STATUS_HEAD_ERROUT) = '0'
+			report "ecc_tb_pkg: job of the queue ended with an error"
+				severity WARNING;
+		-- bind R_READ_DATA to the result of the job at the head
+		dw := (others => '0');
+		dw(JOBQ_RES) := '1';
+		write_reg(clk, axi, axo, W_JOBQ_CTRL, dw);
+		jobq_read_big(clk, axi, axo, valnn, CST_ADDR_XR1, FALSE, kpx);
+		jobq_read_big(clk, axi, axo, valnn, CST_ADDR_YR1, FALSE, kpy);
+		-- & release the entry
+		jobq_poll_until_filled(clk, axi, axo);
+		dw := (others => '0');
+		dw(JOBQ_POP) := '1';
+		write_reg(clk, axi, axo, W_JOBQ_CTRL, dw);
+	end procedure;
+
+	procedure jobq_read_gap(
+		signal clk: in std_logic;
+		signal axi: out axi_in_type;
+		signal axo: in axi_out_type;
+		variable gap : out natural;
+		variable valid : out boolean)
+	is
+		variable dw : std_logic_vector(31 downto 0);
+	begin
+		read_reg(clk, axi, axo, R_JOBQ_GAP, dw);
+		gap := to_integer(unsigned(dw(JOBQ_GAP_MSB downto JOBQ_GAP_LSB)));
+		valid := (dw(JOBQ_GAP_VALID) = '1');
+	end procedure;
+
 	procedure check_if_r0_null(
 		signal clk: in std_logic;
 		signal axi: out axi_in_type;
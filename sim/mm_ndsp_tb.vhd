@@ -0,0 +1,450 @@
+--
+--  Copyright (C) 2023 - This file is part of IPECC project
+--
+--  Authors:
+--      Karim KHALFALLAH <karim.khalfallah@ssi.gouv.fr>
+--      Ryad BENADJILA <ryadbenadjila@gmail.com>
+--
+--  Contributors:
+--      Adrian THILLARD
+--      Emmanuel PROUFF
+--
+--  This software is licensed under GPL v2 license.
+--  See LICENSE file at the root folder of the project.
+--
+
+-- Standalone testbench of one Montgomery multiplier (mm_ndsp) checking the
+-- squarings (input 'sq' asserted, see parameter 'fpsqr' in ecc_customize)
+-- against:
+--
+--   - the product of the same operand by itself computed the usual way
+--     (X & Y both transferred, 'sq' deasserted): results must be identical
+--     bit for bit,
+--   - a reference model of the REDC operation: with R = 2**(nn + 2), result
+--     Z must be in [0, 2p[ & verify Z.R = X.Y mod p.
+--
+-- Moduli p (odd, nn-bit long) & operands (in [0, 2p[, including 0, 1, p - 1
+-- & 2p - 1) are drawn at random. The number of cycles from 'go' to 'irq' is
+-- reported for products & squarings.
+--
+-- Input & output of operands mimic what ecc_fp does (see (s145), (s146) &
+-- (s120) in ecc_fp.vhd). Both clocks of mm_ndsp are driven by the same clock.
+--
+-- Since nn is a constant of package ecc_customize, target 'mm_ndsp_tb' in
+-- the Makefile builds & runs this testbench once for each value of nn listed
+-- in variable MM_TB_NN (with 'fpsqr' forced to TRUE).
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+use ieee.math_real.all;
+
+use work.ecc_customize.all;
+use work.ecc_utils.all;
+use work.ecc_log.all;
+use work.ecc_pkg.all;
+use work.mm_ndsp_pkg.all; -- for 'ndsp'
+
+entity mm_ndsp_tb is
+end entity mm_ndsp_tb;
+
+architecture sim of mm_ndsp_tb is
+
+	-- Parameter 'NBMOD'
+	--
+	-- Number of random moduli p.
+	--
+	constant NBMOD : positive := 4;
+
+	-- Parameter 'NBTESTS'
+	--
+	-- Number of random operands per modulus (the 4 corner values 0, 1, p - 1
+	-- & 2p - 1 are tested in addition).
+	--
+	constant NBTESTS : positive := 32;
+
+	-- Parameter 'TIMEOUT'
+	--
+	-- Maximal number of cycles between 'go' and 'irq'.
+	--
+	constant TIMEOUT : positive := 100000;
+
+	constant CLK_PERIOD : time := 10 ns;
+
+	-- large numbers are w limbs of ww bits
+	constant NB : positive := w * ww;
+	-- Montgomery constant R = 2**(nn + 2), see (s3764) in ecc_axi.vhd
+	constant RBITS : positive := nn + 2;
+
+	subtype big is unsigned(NB - 1 downto 0);
+
+	component mm_ndsp is
+		port(
+			clkmm : in std_logic;
+			clk : in std_logic;
+			rstn : in std_logic;
+			swrst : in std_logic;
+			go : in std_logic;
+			rdy : out std_logic;
+			-- input data
+			xyin : in std_logic_vector(ww - 1 downto 0);
+			xen : in std_logic;
+			yen : in std_logic;
+			sq : in std_logic;
+			fpwdata : in std_logic_vector(ww - 1 downto 0);
+			fpwe : in std_logic;
+			pen : in std_logic;
+			ppen : in std_logic;
+			mbank : in std_logic;
+			-- signals used only when nn_dynamic = TRUE
+			nndyn_mask : in std_logic_vector(ww - 1 downto 0);
+			nndyn_shrcnt : in unsigned(log2(ww) - 1 downto 0);
+			nndyn_shlcnt : in unsigned(log2(ww) - 1 downto 0);
+			nndyn_w : in unsigned(log2(w) - 1 downto 0);
+			nndyn_wm1 : in unsigned(log2(w - 1) - 1 downto 0);
+			nndyn_wm2 : in unsigned(log2(w - 1) - 1 downto 0);
+			nndyn_2wm1 : in unsigned(log2((2*w) - 1) - 1 downto 0);
+			nndyn_wmin : in unsigned(log2((2*w) - 1) - 1 downto 0);
+			nndyn_wmin_excp_val : in unsigned(log2(2*w - 1) - 1 downto 0);
+			nndyn_wmin_excp : in std_logic;
+			nndyn_mask_wm2 : in std_logic;
+			-- output data
+			z : out std_logic_vector(ww - 1 downto 0);
+			zren : in std_logic;
+			irq : out std_logic;
+			go_ack : out std_logic;
+			irq_ack : in std_logic
+		);
+	end component mm_ndsp;
+
+	signal clk : std_logic := '0';
+	signal rstn : std_logic := '0';
+	signal simend : boolean := FALSE;
+
+	signal go : std_logic := '0';
+	signal rdy : std_logic;
+	signal xyin : std_logic_vector(ww - 1 downto 0) := (others => '0');
+	signal xen : std_logic := '0';
+	signal yen : std_logic := '0';
+	signal sq : std_logic := '0';
+	signal fpwdata : std_logic_vector(ww - 1 downto 0) := (others => '0');
+	signal fpwe : std_logic := '0';
+	signal pen : std_logic := '0';
+	signal ppen : std_logic := '0';
+	signal z : std_logic_vector(ww - 1 downto 0);
+	signal zren : std_logic := '0';
+	signal irq : std_logic;
+	signal go_ack : std_logic;
+	signal irq_ack : std_logic := '0';
+
+	-- same static values as the ones driven by ecc_axi (see nn0 generate
+	-- block in ecc_axi.vhd) for the prime size nn
+	signal nndyn_mask : std_logic_vector(ww - 1 downto 0);
+	signal nndyn_shrcnt : unsigned(log2(ww) - 1 downto 0);
+	signal nndyn_shlcnt : unsigned(log2(ww) - 1 downto 0);
+	signal nndyn_w : unsigned(log2(w) - 1 downto 0);
+	signal nndyn_wm1 : unsigned(log2(w - 1) - 1 downto 0);
+	signal nndyn_wm2 : unsigned(log2(w - 1) - 1 downto 0);
+	signal nndyn_2wm1 : unsigned(log2((2*w) - 1) - 1 downto 0);
+	signal nndyn_wmin : unsigned(log2((2*w) - 1) - 1 downto 0);
+	signal nndyn_wmin_excp_val : unsigned(log2(2*w - 1) - 1 downto 0);
+	signal nndyn_wmin_excp : std_logic;
+	signal nndyn_mask_wm2 : std_logic;
+	signal nndyn_mask_is_all1_but_msb : std_logic;
+
+begin
+
+	clk <= not clk after CLK_PERIOD / 2 when not simend;
+
+	nndyn_mask <= std_logic_vector (
+		resize(unsigned(to_signed(-1, (nn + 2) mod ww)), ww) );
+	nndyn_shrcnt <= to_unsigned((nn + 2) mod ww, log2(ww));
+	nndyn_shlcnt <= to_unsigned(ww - ((nn + 2) mod ww), log2(ww));
+	nndyn_w <= to_unsigned(w, log2(w));
+	nndyn_wm1 <= to_unsigned(w - 1, log2(w - 1));
+	nndyn_wm2 <= to_unsigned(w - 2, log2(w - 1));
+	nndyn_2wm1 <= to_unsigned(2*w - 1, log2(2*w - 1));
+	nndyn_mask_is_all1_but_msb <=
+		'1' when (nndyn_mask(ww - 1) = '0'
+		     and nndyn_mask(ww - 2 downto 0) = (ww - 2 downto 0 => '1'))
+		else '0';
+	nndyn_mask_wm2 <= nndyn_mask_is_all1_but_msb;
+	nndyn_wmin <= to_unsigned(w - 2, log2(2*w - 1))
+		when nndyn_mask_is_all1_but_msb = '1'
+		else to_unsigned(w - 1, log2(2*w - 1));
+	nndyn_wmin_excp_val <= to_unsigned((div(w,ndsp)-1) * ndsp, log2(2*w - 1));
+	nndyn_wmin_excp <= '1'
+		when ( (div(w, ndsp) - 1) * ndsp ) > ( (nn + 2) / ww )
+		else '0';
+
+	mm0: mm_ndsp
+		port map(
+			clkmm => clk,
+			clk => clk,
+			rstn => rstn,
+			swrst => '0',
+			go => go,
+			rdy => rdy,
+			xyin => xyin,
+			xen => xen,
+			yen => yen,
+			sq => sq,
+			fpwdata => fpwdata,
+			fpwe => fpwe,
+			pen => pen,
+			ppen => ppen,
+			mbank => '0',
+			nndyn_mask => nndyn_mask,
+			nndyn_shrcnt => nndyn_shrcnt,
+			nndyn_shlcnt => nndyn_shlcnt,
+			nndyn_w => nndyn_w,
+			nndyn_wm1 => nndyn_wm1,
+			nndyn_wm2 => nndyn_wm2,
+			nndyn_2wm1 => nndyn_2wm1,
+			nndyn_wmin => nndyn_wmin,
+			nndyn_wmin_excp_val => nndyn_wmin_excp_val,
+			nndyn_wmin_excp => nndyn_wmin_excp,
+			nndyn_mask_wm2 => nndyn_mask_wm2,
+			z => z,
+			zren => zren,
+			irq => irq,
+			go_ack => go_ack,
+			irq_ack => irq_ack
+		);
+
+	process
+		variable seed1 : positive := 1;
+		variable seed2 : positive := 5381;
+		variable p, pp, twop, x, y, zmul, zsq : big;
+		variable nberr, nbmul, nbsq : natural := 0;
+		variable cyc, mulmin, mulmax, sqmin, sqmax : natural;
+		variable mulsum, sqsum : natural := 0;
+
+		procedure tick is
+		begin
+			wait until clk'event and clk = '1';
+		end procedure tick;
+
+		-- random number of 'nbbits' bits (in the LSbits of the result)
+		procedure random_big(nbbits : in positive; res : out big) is
+			variable rnd : real;
+			variable tmp : big := (others => '0');
+		begin
+			for i in 0 to div(nbbits, 16) - 1 loop
+				uniform(seed1, seed2, rnd);
+				tmp := shift_left(tmp, 16) or
+					to_unsigned(integer(trunc(rnd * 65536.0)) mod 65536, NB);
+			end loop;
+			res := tmp and shift_right(not to_unsigned(0, NB), NB - nbbits);
+		end procedure random_big;
+
+		-- -p^-1 mod R (Newton iteration, each step doubles the number of
+		-- correct bits of the inverse, starting from 1 bit since p is odd)
+		function mont_pprime(p : big) return big is
+			variable pr, inv : unsigned(RBITS - 1 downto 0);
+			variable nbits : natural := 1;
+		begin
+			pr := resize(p, RBITS);
+			inv := to_unsigned(1, RBITS);
+			while nbits < RBITS loop
+				inv := resize(inv * (to_unsigned(2, RBITS) - resize(pr * inv, RBITS)),
+					RBITS);
+				nbits := 2 * nbits;
+			end loop;
+			return resize(to_unsigned(0, RBITS) - inv, NB);
+		end function mont_pprime;
+
+		-- reference model: Z in [0, 2p[ & Z.R = X.Y mod p
+		function redc_ok(x, y, z, p : big) return boolean is
+			variable zr : unsigned(NB + RBITS - 1 downto 0);
+			variable xy : unsigned(2 * NB - 1 downto 0);
+		begin
+			if z >= shift_left(p, 1) then
+				return FALSE;
+			end if;
+			zr := shift_left(resize(z, NB + RBITS), RBITS);
+			xy := x * y;
+			return (zr mod resize(p, NB + RBITS)) = (xy mod resize(p, 2 * NB));
+		end function redc_ok;
+
+		-- transfer of a large number into mm_ndsp, one limb per cycle, limb
+		-- 0 first (strobe is one of pen/ppen/xen/yen)
+		procedure push_big(a : in big; signal strb : out std_logic) is
+		begin
+			for i in 0 to w - 1 loop
+				xyin <= std_logic_vector(a((i + 1) * ww - 1 downto i * ww));
+				fpwdata <= std_logic_vector(a((i + 1) * ww - 1 downto i * ww));
+				strb <= '1';
+				tick;
+			end loop;
+			strb <= '0';
+		end procedure push_big;
+
+		-- one REDC: X.Y (doit_sq = FALSE) or X² with only X transferred
+		-- (doit_sq = TRUE), result read back the way ecc_fp does it
+		procedure redc(a, b : in big; doit_sq : in boolean; res : out big;
+		               nbcyc : out natural) is
+			variable tmp : big := (others => '0');
+			variable cnt : natural := 0;
+		begin
+			-- wait for the multiplier to be idle, and for the resynchroni-
+			-- zation of its I/O-forbid signal (see (s127) in mm_ndsp.vhd)
+			while rdy /= '1' loop
+				tick;
+			end loop;
+			for i in 0 to 7 loop
+				tick;
+			end loop;
+			if doit_sq then
+				sq <= '1';
+				push_big(a, xen);
+			else
+				sq <= '0';
+				push_big(a, xen);
+				push_big(b, yen);
+			end if;
+			go <= '1';
+			tick;
+			go <= '0';
+			-- wait for irq
+			loop
+				tick;
+				cnt := cnt + 1;
+				exit when irq = '1';
+				assert cnt < TIMEOUT
+					report "mm_ndsp_tb: no irq from mm_ndsp" severity failure;
+			end loop;
+			nbcyc := cnt;
+			irq_ack <= '1';
+			while irq = '1' loop
+				tick;
+			end loop;
+			irq_ack <= '0';
+			-- read back the result: zren is held w cycles & z holds limb i
+			-- sramlat + 2 + i cycles after zren was asserted (same as (s119)-
+			-- (s121) in ecc_fp.vhd)
+			zren <= '1';
+			for i in 0 to sramlat + 1 loop
+				tick;
+			end loop;
+			for i in 0 to w - 1 loop
+				tmp((i + 1) * ww - 1 downto i * ww) := unsigned(z);
+				if i = w - sramlat - 2 then
+					zren <= '0';
+				end if;
+				tick;
+			end loop;
+			sq <= '0';
+			res := tmp;
+		end procedure redc;
+
+		procedure one_test(a, b : in big) is
+		begin
+			-- X.X as a product
+			redc(a, a, FALSE, zmul, cyc);
+			nbmul := nbmul + 1;
+			mulsum := mulsum + cyc;
+			if cyc < mulmin then
+				mulmin := cyc;
+			end if;
+			mulmax := max(mulmax, cyc);
+			-- X² as a squaring
+			redc(a, a, TRUE, zsq, cyc);
+			nbsq := nbsq + 1;
+			sqsum := sqsum + cyc;
+			if cyc < sqmin then
+				sqmin := cyc;
+			end if;
+			sqmax := max(sqmax, cyc);
+			if zsq /= zmul then
+				nberr := nberr + 1;
+				echo("[ mm_ndsp_tb.vhd ]: ERROR square /= product for X = 0x");
+				hex_echol(std_logic_vector(a));
+				echo("[ mm_ndsp_tb.vhd ]:   product = 0x");
+				hex_echol(std_logic_vector(zmul));
+				echo("[ mm_ndsp_tb.vhd ]:   square  = 0x");
+				hex_echol(std_logic_vector(zsq));
+			end if;
+			if not redc_ok(a, a, zsq, p) then
+				nberr := nberr + 1;
+				echo("[ mm_ndsp_tb.vhd ]: ERROR square /= reference for X = 0x");
+				hex_echol(std_logic_vector(a));
+			end if;
+			-- X.Y (checks the reference model against the product itself)
+			redc(a, b, FALSE, zmul, cyc);
+			if not redc_ok(a, b, zmul, p) then
+				nberr := nberr + 1;
+				echo("[ mm_ndsp_tb.vhd ]: ERROR product /= reference for X = 0x");
+				hex_echol(std_logic_vector(a));
+				echo("[ mm_ndsp_tb.vhd ]:   and Y = 0x");
+				hex_echol(std_logic_vector(b));
+			end if;
+		end procedure one_test;
+
+	begin
+		mulmin := natural'high; mulmax := 0;
+		sqmin := natural'high; sqmax := 0;
+		echol("[ mm_ndsp_tb.vhd ]: nn = " & integer'image(nn) & ", ww = "
+			& integer'image(ww) & ", w = " & integer'image(w) & ", ndsp = "
+			& integer'image(ndsp) & ", sramlat = " & integer'image(sramlat)
+			& ", async = " & boolean'image(async));
+		assert fpsqr
+			report "mm_ndsp_tb: parameter 'fpsqr' must be set in ecc_customize"
+			severity failure;
+		rstn <= '0';
+		for i in 0 to 9 loop
+			tick;
+		end loop;
+		rstn <= '1';
+		for i in 0 to 19 loop
+			tick;
+		end loop;
+		for m in 0 to NBMOD - 1 loop
+			-- random odd modulus of exactly nn bits
+			random_big(nn, p);
+			p(nn - 1) := '1';
+			p(0) := '1';
+			twop := shift_left(p, 1);
+			pp := mont_pprime(p);
+			echo("[ mm_ndsp_tb.vhd ]: p = 0x");
+			hex_echol(std_logic_vector(p));
+			while rdy /= '1' loop
+				tick;
+			end loop;
+			for i in 0 to 7 loop
+				tick;
+			end loop;
+			-- P & P' are written the same way ecc_axi does through ecc_fp_dram
+			fpwe <= '1';
+			push_big(p, pen);
+			tick;
+			push_big(pp, ppen);
+			fpwe <= '0';
+			tick;
+			-- corner values
+			one_test(to_unsigned(0, NB), twop - 1);
+			one_test(to_unsigned(1, NB), p - 1);
+			one_test(p - 1, p - 1);
+			one_test(twop - 1, twop - 1);
+			-- random operands in [0, 2p[
+			for i in 0 to NBTESTS - 1 loop
+				random_big(nn + 1, x);
+				random_big(nn + 1, y);
+				one_test(x mod twop, y mod twop);
+			end loop;
+		end loop;
+		echol("[ mm_ndsp_tb.vhd ]: " & integer'image(nbmul) & " products, "
+			& integer'image(nbsq) & " squarings, " & integer'image(nberr)
+			& " error(s)");
+		echol("[ mm_ndsp_tb.vhd ]: cycles from go to irq: product "
+			& integer'image(mulmin) & "/" & integer'image(mulsum / nbmul) & "/"
+			& integer'image(mulmax) & ", squaring " & integer'image(sqmin) & "/"
+			& integer'image(sqsum / nbsq) & "/" & integer'image(sqmax)
+			& " (min/avg/max)");
+		assert nberr = 0
+			report "mm_ndsp_tb: mismatch(es) detected" severity failure;
+		simend <= TRUE;
+		wait;
+	end process;
+
+end architecture sim;